@@ -0,0 +1,51 @@
+#!/bin/bash
+# Use this script to check that the unit precache task pool simulates a replay
+# exactly like the faction threads do, by replaying it both ways and comparing
+# the final faction CRCs
+# usage: mg_benchmark_determinism.sh <saved game> [frames]
+# ----------------------------------------------------------------------------
+# Copyright (c) 2026 MegaGlest Team under GNU GPL v3.0+
+
+if [ "$1" = "" ]; then
+  echo "usage: $0 <saved game> [frames]"
+  exit 2
+fi
+
+SAVED_GAME="$1"
+FRAMES="$2"
+
+echo 'Replaying with the unit precache on the faction threads...'
+SERIAL_OUTPUT=$(./megaglest --benchmark-replay="$SAVED_GAME,$FRAMES,,serial")
+if [ $? -ne 0 ]; then
+  echo "$SERIAL_OUTPUT"
+  echo 'The serial replay failed'
+  exit 2
+fi
+
+echo 'Replaying with the unit precache on the task pool...'
+POOL_OUTPUT=$(./megaglest --benchmark-replay="$SAVED_GAME,$FRAMES,,pool")
+if [ $? -ne 0 ]; then
+  echo "$POOL_OUTPUT"
+  echo 'The task pool replay failed'
+  exit 2
+fi
+
+SERIAL_CRCS=$(echo "$SERIAL_OUTPUT" | grep -E '^(Faction [0-9]+|World) CRC:')
+POOL_CRCS=$(echo "$POOL_OUTPUT" | grep -E '^(Faction [0-9]+|World) CRC:')
+if [ "$SERIAL_CRCS" = "" ]; then
+  echo "$SERIAL_OUTPUT"
+  echo 'No CRCs found in the benchmark output'
+  exit 2
+fi
+
+if [ "$SERIAL_CRCS" != "$POOL_CRCS" ]; then
+  echo 'Faction threads:'
+  echo "$SERIAL_CRCS"
+  echo 'Task pool:'
+  echo "$POOL_CRCS"
+  echo '**ERROR** the task pool replay does not match the faction thread replay!'
+  exit 1
+fi
+
+echo "$POOL_CRCS"
+echo 'The task pool replay matches the faction thread replay'
@@ -663,7 +663,8 @@ bool Ai::findPosForBuilding(const UnitType* building, const Vec2i &searchPos, Ve
         for(int i=searchPos.x - currRadius; i < searchPos.x + currRadius; ++i) {
             for(int j=searchPos.y - currRadius; j < searchPos.y + currRadius; ++j) {
                 outPos= Vec2i(i, j);
-                if(aiInterface->isFreeCells(outPos - Vec2i(minBuildSpacing), building->getAiBuildSize() + minBuildSpacing * 2, fLand)) {
+                if(aiInterface->isFreeCells(outPos - Vec2i(minBuildSpacing), building->getAiBuildSize() + minBuildSpacing * 2, fLand) &&
+                	aiInterface->isReachable(searchPos, outPos, fLand) == true) {
                 	int aiBuildSizeDiff= building->getAiBuildSize()- building->getSize();
                 	if( aiBuildSizeDiff>0){
                 		int halfSize=aiBuildSizeDiff/2;
@@ -21,6 +21,7 @@
 #include "config.h"
 #include "network_manager.h"
 #include "platform_util.h"
+#include "zone_profiler.h"
 #include "leak_dumper.h"
 
 using namespace Shared::Util;
@@ -126,6 +127,10 @@ void AiInterfaceThread::execute() {
 		//bool minorDebugPerformance = false;
 		Chrono chrono;
 
+		if(this->aiIntf != NULL) {
+			ZoneProfiler::setThreadName("AI " + intToStr(this->aiIntf->getFactionIndex()));
+		}
+
 		//unsigned int idx = 0;
 		for(;this->aiIntf != NULL;) {
 			if(getQuitStatus() == true) {
@@ -153,6 +158,7 @@ void AiInterfaceThread::execute() {
 
             if(executeTask == true) {
 				ExecutingTaskSafeWrapper safeExecutingTaskMutex(this);
+				PROFILE_ZONE("AiInterfaceThread::update");
 
 				MutexSafeWrapper safeMutex(this->aiIntf->getMutex(),string(__FILE__) + "_" + intToStr(__LINE__));
 
@@ -785,25 +791,41 @@ bool AiInterface::getNearestSightedResource(const ResourceType *rt, const Vec2i
 		}
 		else {
 			const Map *map		= world->getMap();
-			for(int i = 0; i < map->getW(); ++i) {
-				for(int j = 0; j < map->getH(); ++j) {
-					Vec2i resPos = Vec2i(i, j);
-					Vec2i surfPos= Map::toSurfCoords(resPos);
-					SurfaceCell *sc = map->getSurfaceCell(surfPos);
-
-					//if explored cell
-					if(sc != NULL && sc->isExplored(teamIndex)) {
-						Resource *r= sc->getResource();
-
-						//if resource cell
-						if(r != NULL) {
-							if(r->getType() == rt) {
-								float tmpDist= pos.dist(resPos);
-								if(tmpDist < nearestDist) {
-									anyResource= true;
-									nearestDist= tmpDist;
-									resultPos= resPos;
-								}
+			// skip resources on islands our workers can't walk to
+			int homeRegion		= getRegion(pos, fLand);
+			// walk the explored plane a word at a time, unexplored words are skipped whole
+			const TeamBitPlane *exploredPlane = map->getExploredPlane();
+			for(int wordIndex = 0; wordIndex < exploredPlane->getWordCount(); ++wordIndex) {
+				uint64 word = exploredPlane->getWord(teamIndex, wordIndex);
+				for(int bit = 0; word != 0; ++bit, word >>= 1) {
+					if((word & 1) == 0) {
+						continue;
+					}
+					const int surfIndex = wordIndex * TeamBitPlane::bitsPerWord + bit;
+					const Vec2i surfPos(surfIndex % map->getSurfaceW(), surfIndex / map->getSurfaceW());
+					const Resource *r= map->getSurfaceCell(surfPos)->getResource();
+
+					//if resource cell
+					if(r == NULL || r->getType() != rt) {
+						continue;
+					}
+					for(int cellX = 0; cellX < Map::cellScale; ++cellX) {
+						for(int cellY = 0; cellY < Map::cellScale; ++cellY) {
+							Vec2i resPos = surfPos * Map::cellScale + Vec2i(cellX, cellY);
+							if(resPos.x >= map->getW() || resPos.y >= map->getH()) {
+								continue;
+							}
+
+							// ties go to the lowest x then y, as a column by column map scan would
+							float tmpDist= pos.dist(resPos);
+							bool isNearer = (tmpDist < nearestDist ||
+								(tmpDist == nearestDist && anyResource == true &&
+								 (resPos.x < resultPos.x || (resPos.x == resultPos.x && resPos.y < resultPos.y))));
+							if(isNearer == true &&
+								isNextToRegion(resPos, homeRegion, fLand) == true) {
+								anyResource= true;
+								nearestDist= tmpDist;
+								resultPos= resPos;
 							}
 						}
 					}
@@ -833,6 +855,34 @@ bool AiInterface::isFreeCells(const Vec2i &pos, int size, Field field){
     return world->getMap()->isFreeCells(pos, size, field);
 }
 
+int AiInterface::getRegion(const Vec2i &pos, Field field, int size) {
+	return world->getMap()->getClusterMap()->getRegion(field, size, pos);
+}
+
+bool AiInterface::isReachable(const Vec2i &from, const Vec2i &to, Field field, int size) {
+	return world->getMap()->getClusterMap()->isReachable(field, size, from, to);
+}
+
+// true if a unit standing in region could get adjacent to pos (region -1 means unknown)
+bool AiInterface::isNextToRegion(const Vec2i &pos, int region, Field field, int size) {
+	if(region < 0) {
+		return true;
+	}
+	ClusterMap *clusterMap = world->getMap()->getClusterMap();
+	const ClusterMap::Layer *layer = clusterMap->getReadLayer(field, size);
+	if(layer == NULL) {
+		return true;
+	}
+	for(int i = -1; i <= 1; ++i) {
+		for(int j = -1; j <= 1; ++j) {
+			if(clusterMap->getRegionLabel(layer, pos + Vec2i(i, j)) == region) {
+				return true;
+			}
+		}
+	}
+	return false;
+}
+
 void AiInterface::removeEnemyWarningPositionFromList(Vec2i &checkPos) {
 	for(int i = (int)enemyWarningPositionList.size() - 1; i >= 0; --i) {
 		Vec2i &pos = enemyWarningPositionList[i];
@@ -869,25 +919,26 @@ const Unit *AiInterface::getFirstOnSightEnemyUnit(Vec2i &pos, Field &field, int
                     // so make note of the position
                     int foundEnemies = 0;
                     std::map<int,bool> foundEnemyList;
-                	for(int aiX = pos.x-CHECK_RADIUS; aiX < pos.x + CHECK_RADIUS; ++aiX) {
-                		for(int aiY = pos.y-CHECK_RADIUS; aiY < pos.y + CHECK_RADIUS; ++aiY) {
-                			Vec2i checkPos(aiX,aiY);
-                			if(map->isInside(checkPos) && map->isInsideSurface(map->toSurfCoords(checkPos))) {
-                				Cell *cAI = map->getCell(checkPos);
-                				SurfaceCell *scAI = map->getSurfaceCell(Map::toSurfCoords(checkPos));
-                				if(scAI != NULL && cAI != NULL && cAI->getUnit(field) != NULL && sc->isVisible(teamIndex)) {
-                					const Unit *checkUnit = cAI->getUnit(field);
-                					if(foundEnemyList.find(checkUnit->getId()) == foundEnemyList.end()) {
-										bool cannotSeeUnitAI = (checkUnit->getType()->hasCellMap() == true &&
-															checkUnit->getType()->getAllowEmptyCellMap() == true &&
-															checkUnit->getType()->hasEmptyCellMap() == true);
-										if(cannotSeeUnitAI == false && isAlly(checkUnit) == false
-												&& checkUnit->isAlive() == true) {
-											foundEnemies++;
-											foundEnemyList[checkUnit->getId()] = true;
-										}
-                					}
-                				}
+                    vector<UnitCellRef> unitCells;
+                    for(int checkFactionIndex = 0; checkFactionIndex < world->getFactionCount(); ++checkFactionIndex) {
+                    	if(world->getFaction(factionIndex)->isAlly(world->getFaction(checkFactionIndex)) == true) {
+                    		continue;
+                    	}
+                    	map->findUnitCells(world->getFaction(checkFactionIndex)->getIndex(),
+                    			pos - Vec2i(CHECK_RADIUS), pos + Vec2i(CHECK_RADIUS - 1), unitCells);
+                    }
+                	for(unsigned int cellIndex = 0; cellIndex < unitCells.size(); ++cellIndex) {
+                		if(unitCells[cellIndex].field == field) {
+                			const Unit *checkUnit = unitCells[cellIndex].unit;
+                			if(foundEnemyList.find(checkUnit->getId()) == foundEnemyList.end()) {
+								bool cannotSeeUnitAI = (checkUnit->getType()->hasCellMap() == true &&
+													checkUnit->getType()->getAllowEmptyCellMap() == true &&
+													checkUnit->getType()->hasEmptyCellMap() == true);
+								if(cannotSeeUnitAI == false && isAlly(checkUnit) == false
+										&& checkUnit->isAlive() == true) {
+									foundEnemies++;
+									foundEnemyList[checkUnit->getId()] = true;
+								}
                 			}
                 		}
                 	}
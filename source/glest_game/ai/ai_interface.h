@@ -151,6 +151,9 @@ public:
 	bool reqsOk(const CommandType *ct);
     bool checkCosts(const ProducibleType *pt, const CommandType *ct);
 	bool isFreeCells(const Vec2i &pos, int size, Field field);
+	int getRegion(const Vec2i &pos, Field field, int size= 1);
+	bool isReachable(const Vec2i &from, const Vec2i &to, Field field, int size= 1);
+	bool isNextToRegion(const Vec2i &pos, int region, Field field, int size= 1);
 	const Unit *getFirstOnSightEnemyUnit(Vec2i &pos, Field &field, int radius);
 	Map * getMap();
 	World * getWorld() { return world; }
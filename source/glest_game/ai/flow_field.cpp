@@ -0,0 +1,468 @@
+// ==============================================================
+//	This file is part of MegaGlest (www.megaglest.org)
+//
+//	Copyright (C) 2026 The MegaGlest Team
+//
+//	You can redistribute this code and/or modify it under
+//	the terms of the GNU General Public License as published
+//	by the Free Software Foundation; either version 2 of the
+//	License, or (at your option) any later version
+// ==============================================================
+
+#include "flow_field.h"
+
+#include <algorithm>
+
+#include "map.h"
+#include "cluster_map.h"
+#include "astar_containers.h"
+#include "thread.h"
+#include "zone_profiler.h"
+#include "util.h"
+#include "leak_dumper.h"
+
+using namespace std;
+using namespace Shared::Util;
+using namespace Shared::Platform;
+
+namespace Glest{ namespace Game{
+
+// =====================================================
+// 	class FlowField
+// =====================================================
+
+const uint32 FlowField::unreachableCost	= 0xFFFFFFFF;
+const uint8 FlowField::noDirection		= 0xFF;
+
+// integer step costs keep the field identical on every machine
+static const uint32 straightStepCost 	= 10;
+static const uint32 diagonalStepCost 	= 14;
+
+// ordered so that the opposite of entry k is entry 7 - k
+static const int neighbourCount = 8;
+static const int neighbourX[neighbourCount] = { -1,  0,  1, -1, 1, -1, 0, 1 };
+static const int neighbourY[neighbourCount] = { -1, -1, -1,  0, 0,  1, 1, 1 };
+
+FlowField::FlowField() {
+	commandGroupId		= -1;
+	field				= fLand;
+	size				= 0;
+	staticChangeCount	= 0;
+	mapW				= 0;
+	mapH				= 0;
+}
+
+void FlowField::build(const Map *map, int commandGroupId, const Vec2i &target,
+		Field field, int size, uint32 staticChangeCount) {
+	PROFILE_ZONE("FlowField::build");
+	this->commandGroupId	= commandGroupId;
+	this->target			= target;
+	this->field				= field;
+	this->size				= size;
+	this->staticChangeCount	= staticChangeCount;
+	mapW					= map->getW();
+	mapH					= map->getH();
+
+	const int cellCount = mapW * mapH;
+	integration.assign(cellCount, unreachableCost);
+	direction.assign(cellCount, noDirection);
+	staticFree.assign(cellCount, 2);
+	if(map->isInside(target) == false) {
+		return;
+	}
+
+	const ClusterMap *clusterMap = map->getClusterMap();
+
+	// Dijkstra outwards from the target
+	AStarOpenList<int> openList;
+	openList.reserve(cellCount / 4);
+	integration[target.y * mapW + target.x] = 0;
+	openList.push(0.0f, target.y * mapW + target.x);
+	relax(clusterMap, openList, NULL, NULL);
+
+	for(int cell = 0; cell < cellCount; ++cell) {
+		if(integration[cell] != unreachableCost) {
+			updateDirection(clusterMap, cell);
+		}
+	}
+}
+
+bool FlowField::applyStaticChanges(const Map *map) {
+	const ClusterMap *clusterMap = map->getClusterMap();
+	const uint32 currentChangeCount = clusterMap->getStaticChangeCount();
+	if(staticChangeCount == currentChangeCount) {
+		return true;
+	}
+
+	vector<ClusterMap::StaticChange> changes;
+	if(clusterMap->getStaticChangesSince(staticChangeCount, changes) == false) {
+		return false;
+	}
+
+	// footprints anchored up to (size - 1) cells before a change overlap it,
+	// only those cells can have become blocked or free
+	vector<int> changedCells;
+	for(unsigned int index = 0; index < changes.size(); ++index) {
+		const ClusterMap::StaticChange &change = changes[index];
+		const int minX = max(0, change.pos.x - (size - 1));
+		const int minY = max(0, change.pos.y - (size - 1));
+		const int maxX = min(mapW - 1, change.pos.x + change.size - 1);
+		const int maxY = min(mapH - 1, change.pos.y + change.size - 1);
+		for(int y = minY; y <= maxY; ++y) {
+			for(int x = minX; x <= maxX; ++x) {
+				staticFree[y * mapW + x] = 2;
+				changedCells.push_back(y * mapW + x);
+			}
+		}
+	}
+	std::sort(changedCells.begin(), changedCells.end());
+	changedCells.erase(std::unique(changedCells.begin(), changedCells.end()), changedCells.end());
+
+	const int targetCell = target.y * mapW + target.x;
+	vector<int> blockedCells;
+	vector<int> openedCells;
+	for(unsigned int index = 0; index < changedCells.size(); ++index) {
+		const int cell = changedCells[index];
+		const bool isFree = isStaticFree(clusterMap, cell % mapW, cell / mapW);
+		if(integration[cell] != unreachableCost) {
+			if(isFree == false && cell != targetCell) {
+				blockedCells.push_back(cell);
+			}
+		}
+		else if(isFree == true) {
+			openedCells.push_back(cell);
+		}
+	}
+
+	// Blocked cells only raise costs and opened ones only lower them. The
+	// first repair already steps past opened corners though, so the cells
+	// it touched also seed the second one
+	vector<int> affectedCells;
+	if(blockedCells.empty() == false) {
+		repairBlockedCells(clusterMap, blockedCells, affectedCells);
+	}
+	if(openedCells.empty() == false) {
+		repairOpenedCells(clusterMap, openedCells, affectedCells);
+	}
+	this->staticChangeCount = currentChangeCount;
+	return true;
+}
+
+bool FlowField::isStaticFree(const ClusterMap *clusterMap, int x, int y) {
+	if(x < 0 || y < 0 || x >= mapW || y >= mapH) {
+		return false;
+	}
+	uint8 &isFree = staticFree[y * mapW + x];
+	if(isFree == 2) {
+		isFree = (clusterMap->isStaticFree(field, size, Vec2i(x, y)) ? 1 : 0);
+	}
+	return (isFree == 1);
+}
+
+bool FlowField::canStep(const ClusterMap *clusterMap, int cell, int k) {
+	const int x = cell % mapW;
+	const int y = cell / mapW;
+	const int nx = x + neighbourX[k];
+	const int ny = y + neighbourY[k];
+	if(isStaticFree(clusterMap, nx, ny) == false) {
+		return false;
+	}
+	if(neighbourX[k] != 0 && neighbourY[k] != 0) {
+		return isStaticFree(clusterMap, nx, y) == true && isStaticFree(clusterMap, x, ny) == true;
+	}
+	return true;
+}
+
+void FlowField::updateDirection(const ClusterMap *clusterMap, int cell) {
+	direction[cell] = noDirection;
+	if(cell == target.y * mapW + target.x || integration[cell] == unreachableCost) {
+		return;
+	}
+
+	const int x = cell % mapW;
+	const int y = cell / mapW;
+	uint32 bestCost = unreachableCost;
+	for(int k = 0; k < neighbourCount; ++k) {
+		const uint32 neighbourCost = getCost(Vec2i(x + neighbourX[k], y + neighbourY[k]));
+		if(neighbourCost == unreachableCost) {
+			continue;
+		}
+		const bool diagonal = (neighbourX[k] != 0 && neighbourY[k] != 0);
+		const uint32 cost = neighbourCost + (diagonal ? diagonalStepCost : straightStepCost);
+		// the step back from the neighbour, ties keep the first neighbour
+		if(cost < bestCost && canStep(clusterMap, cell + neighbourY[k] * mapW + neighbourX[k], neighbourCount - 1 - k) == true) {
+			bestCost = cost;
+			direction[cell] = (uint8)k;
+		}
+	}
+}
+
+void FlowField::relax(const ClusterMap *clusterMap, AStarOpenList<int> &openList,
+		const vector<bool> *onlyCells, vector<int> *changedCells) {
+	while(openList.empty() == false) {
+		int cell = openList.pop();
+		const int x = cell % mapW;
+		const int y = cell / mapW;
+		const uint32 cost = integration[cell];
+
+		for(int k = 0; k < neighbourCount; ++k) {
+			const int nx = x + neighbourX[k];
+			const int ny = y + neighbourY[k];
+			if(nx < 0 || ny < 0 || nx >= mapW || ny >= mapH) {
+				continue;
+			}
+
+			const int neighbour = ny * mapW + nx;
+			if(onlyCells != NULL && (*onlyCells)[neighbour] == false) {
+				continue;
+			}
+			const bool diagonal = (neighbourX[k] != 0 && neighbourY[k] != 0);
+			const uint32 newCost = cost + (diagonal ? diagonalStepCost : straightStepCost);
+			if(newCost >= integration[neighbour] || canStep(clusterMap, cell, k) == false) {
+				continue;
+			}
+
+			if(changedCells != NULL) {
+				changedCells->push_back(neighbour);
+			}
+			integration[neighbour] = newCost;
+			openList.push((float)newCost, neighbour);
+		}
+	}
+}
+
+void FlowField::repairBlockedCells(const ClusterMap *clusterMap, const vector<int> &blockedCells,
+		vector<int> &affectedCells) {
+	// Every cell whose route ran over a blocked cell, or cut a corner past
+	// one, loses its cost; only those can get more expensive
+	vector<bool> affected(integration.size(), false);
+	for(unsigned int index = 0; index < blockedCells.size(); ++index) {
+		const int cell = blockedCells[index];
+		if(affected[cell] == false) {
+			affected[cell] = true;
+			affectedCells.push_back(cell);
+		}
+
+		const int x = cell % mapW;
+		const int y = cell / mapW;
+		for(int k = 0; k < neighbourCount; ++k) {
+			const int nx = x + neighbourX[k];
+			const int ny = y + neighbourY[k];
+			const int neighbour = ny * mapW + nx;
+			Vec2i nextPos;
+			if(getNextPos(Vec2i(nx, ny), nextPos) == false || affected[neighbour] == true) {
+				continue;
+			}
+			if(nextPos.x != nx && nextPos.y != ny &&
+				((nextPos.x == x && ny == y) || (nx == x && nextPos.y == y))) {
+				affected[neighbour] = true;
+				affectedCells.push_back(neighbour);
+			}
+		}
+	}
+	for(unsigned int index = 0; index < affectedCells.size(); ++index) {
+		const int cell = affectedCells[index];
+		const int x = cell % mapW;
+		const int y = cell / mapW;
+		for(int k = 0; k < neighbourCount; ++k) {
+			const int nx = x + neighbourX[k];
+			const int ny = y + neighbourY[k];
+			Vec2i nextPos;
+			if(getNextPos(Vec2i(nx, ny), nextPos) == true && nextPos.x == x && nextPos.y == y &&
+				affected[ny * mapW + nx] == false) {
+				affected[ny * mapW + nx] = true;
+				affectedCells.push_back(ny * mapW + nx);
+			}
+		}
+	}
+	for(unsigned int index = 0; index < affectedCells.size(); ++index) {
+		integration[affectedCells[index]] = unreachableCost;
+		direction[affectedCells[index]] = noDirection;
+	}
+
+	// seed them from the cells around that kept their cost and search again
+	AStarOpenList<int> openList;
+	for(unsigned int index = 0; index < affectedCells.size(); ++index) {
+		const int cell = affectedCells[index];
+		const int x = cell % mapW;
+		const int y = cell / mapW;
+		for(int k = 0; k < neighbourCount; ++k) {
+			const int nx = x + neighbourX[k];
+			const int ny = y + neighbourY[k];
+			const int neighbour = ny * mapW + nx;
+			if(nx < 0 || ny < 0 || nx >= mapW || ny >= mapH ||
+				affected[neighbour] == true || integration[neighbour] == unreachableCost) {
+				continue;
+			}
+			const bool diagonal = (neighbourX[k] != 0 && neighbourY[k] != 0);
+			const uint32 newCost = integration[neighbour] + (diagonal ? diagonalStepCost : straightStepCost);
+			if(newCost < integration[cell] && canStep(clusterMap, neighbour, neighbourCount - 1 - k) == true) {
+				integration[cell] = newCost;
+			}
+		}
+		if(integration[cell] != unreachableCost) {
+			openList.push((float)integration[cell], cell);
+		}
+	}
+	relax(clusterMap, openList, &affected, NULL);
+	updateDirectionsAround(clusterMap, affectedCells);
+}
+
+void FlowField::repairOpenedCells(const ClusterMap *clusterMap, const vector<int> &openedCells,
+		const vector<int> &sourceCells) {
+	// Routes can only get cheaper, through an opened cell or a diagonal
+	// past one, so search on from the cells around them
+	AStarOpenList<int> openList;
+	vector<int> changedCells;
+	for(unsigned int index = 0; index < sourceCells.size(); ++index) {
+		if(integration[sourceCells[index]] != unreachableCost) {
+			openList.push((float)integration[sourceCells[index]], sourceCells[index]);
+		}
+	}
+	for(unsigned int index = 0; index < openedCells.size(); ++index) {
+		const int cell = openedCells[index];
+		const int x = cell % mapW;
+		const int y = cell / mapW;
+		changedCells.push_back(cell);
+		for(int k = 0; k < neighbourCount; ++k) {
+			const int nx = x + neighbourX[k];
+			const int ny = y + neighbourY[k];
+			if(nx >= 0 && ny >= 0 && nx < mapW && ny < mapH &&
+				integration[ny * mapW + nx] != unreachableCost) {
+				openList.push((float)integration[ny * mapW + nx], ny * mapW + nx);
+			}
+		}
+	}
+	relax(clusterMap, openList, NULL, &changedCells);
+	updateDirectionsAround(clusterMap, changedCells);
+}
+
+void FlowField::updateDirectionsAround(const ClusterMap *clusterMap, const vector<int> &changedCells) {
+	// a neighbour that got cheaper, or a diagonal past a cell that opened,
+	// can change where a cell points even when its own cost stays the same
+	vector<bool> updated(integration.size(), false);
+	for(unsigned int index = 0; index < changedCells.size(); ++index) {
+		const int x = changedCells[index] % mapW;
+		const int y = changedCells[index] / mapW;
+		for(int ny = max(0, y - 1); ny <= min(mapH - 1, y + 1); ++ny) {
+			for(int nx = max(0, x - 1); nx <= min(mapW - 1, x + 1); ++nx) {
+				if(updated[ny * mapW + nx] == false) {
+					updated[ny * mapW + nx] = true;
+					updateDirection(clusterMap, ny * mapW + nx);
+				}
+			}
+		}
+	}
+}
+
+uint32 FlowField::getCost(const Vec2i &pos) const {
+	if(pos.x < 0 || pos.y < 0 || pos.x >= mapW || pos.y >= mapH) {
+		return unreachableCost;
+	}
+	return integration[pos.y * mapW + pos.x];
+}
+
+bool FlowField::getNextPos(const Vec2i &pos, Vec2i &nextPos) const {
+	if(pos.x < 0 || pos.y < 0 || pos.x >= mapW || pos.y >= mapH) {
+		return false;
+	}
+	uint8 k = direction[pos.y * mapW + pos.x];
+	if(k == noDirection) {
+		return false;
+	}
+	nextPos = Vec2i(pos.x + neighbourX[k], pos.y + neighbourY[k]);
+	return true;
+}
+
+// =====================================================
+// 	class FlowFieldCache
+// =====================================================
+
+const int FlowFieldCache::maxFlowFields = 8;
+
+FlowFieldCache::FlowFieldCache() {
+}
+
+FlowFieldCache::~FlowFieldCache() {
+	clear();
+}
+
+void FlowFieldCache::clear() {
+	for(FlowFieldList::iterator iterList = fields.begin(); iterList != fields.end(); ++iterList) {
+		delete *iterList;
+	}
+	fields.clear();
+}
+
+int FlowFieldCache::getFieldCount() {
+	return (int)fields.size();
+}
+
+FlowField * FlowFieldCache::getField(const Map *map, int commandGroupId, Field field, int size, const Vec2i &target) {
+	uint32 staticChangeCount = map->getClusterMap()->getStaticChangeCount();
+
+	for(FlowFieldList::iterator iterList = fields.begin(); iterList != fields.end(); ++iterList) {
+		FlowField *flowField = *iterList;
+		if(flowField->matches(commandGroupId, target, field, size) == true) {
+			if(iterList != fields.begin()) {
+				fields.erase(iterList);
+				fields.push_front(flowField);
+			}
+			// buildings came or went since it was built or last repaired
+			if(flowField->applyStaticChanges(map) == false) {
+				flowField->build(map, commandGroupId, target, field, size, staticChangeCount);
+			}
+			return flowField;
+		}
+	}
+
+	FlowField *flowField = NULL;
+	if((int)fields.size() >= maxFlowFields) {
+		flowField = fields.back();
+		fields.pop_back();
+	}
+	else {
+		flowField = new FlowField();
+	}
+	flowField->build(map, commandGroupId, target, field, size, staticChangeCount);
+	fields.push_front(flowField);
+	return flowField;
+}
+
+const FlowField * FlowFieldCache::findCurrentField(const Map *map, int commandGroupId, Field field, int size, const Vec2i &target) const {
+	uint32 staticChangeCount = map->getClusterMap()->getStaticChangeCount();
+
+	for(FlowFieldList::const_iterator iterList = fields.begin(); iterList != fields.end(); ++iterList) {
+		const FlowField *flowField = *iterList;
+		if(flowField->matches(commandGroupId, target, field, size) == true) {
+			return (flowField->getStaticChangeCount() == staticChangeCount ? flowField : NULL);
+		}
+	}
+	return NULL;
+}
+
+bool FlowFieldCache::findPath(const Map *map, int commandGroupId, Field field, int size,
+		const Vec2i &from, const Vec2i &target, int maxCells, vector<Vec2i> &path) {
+	// precache threads leave building and the LRU order to the serial pass
+	const FlowField *flowField = NULL;
+	if(Thread::isCurrentThreadMainThread() == true) {
+		flowField = getField(map, commandGroupId, field, size, target);
+	}
+	else {
+		flowField = findCurrentField(map, commandGroupId, field, size, target);
+	}
+	if(flowField == NULL || flowField->getCost(from) == FlowField::unreachableCost) {
+		return false;
+	}
+
+	path.clear();
+	Vec2i pos = from;
+	Vec2i nextPos;
+	while((int)path.size() < maxCells && flowField->getNextPos(pos, nextPos) == true) {
+		path.push_back(nextPos);
+		pos = nextPos;
+	}
+	return path.empty() == false;
+}
+
+}}//end namespace
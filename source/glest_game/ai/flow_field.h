@@ -0,0 +1,151 @@
+// ==============================================================
+//	This file is part of MegaGlest (www.megaglest.org)
+//
+//	Copyright (C) 2026 The MegaGlest Team
+//
+//	You can redistribute this code and/or modify it under
+//	the terms of the GNU General Public License as published
+//	by the Free Software Foundation; either version 2 of the
+//	License, or (at your option) any later version
+// ==============================================================
+
+#ifndef _GLEST_GAME_FLOWFIELD_H_
+#define _GLEST_GAME_FLOWFIELD_H_
+
+#ifdef WIN32
+    #include <winsock2.h>
+    #include <winsock.h>
+#endif
+
+#include <vector>
+#include <list>
+#include "vec.h"
+#include "skill_type.h"
+#include "data_types.h"
+#include "astar_containers.h"
+#include "leak_dumper.h"
+
+using std::vector;
+using Shared::Graphics::Vec2i;
+using Shared::Platform::uint32;
+using Shared::Platform::uint8;
+using Shared::Util::AStarOpenList;
+
+namespace Glest{ namespace Game{
+
+class Map;
+class ClusterMap;
+
+// =====================================================
+// 	class FlowField
+//
+///	Integration field (walking cost to the target) plus a direction
+///	field (next cell towards the target) for every cell a unit of the
+///	given field and size can reach. Only static blockers are considered,
+///	so one field serves every unit of a command group.
+///
+///	Every cell points at its cheapest neighbour, the first one in
+///	neighbour order on a tie, so the field only depends on which cells
+///	are free and not on how it was computed. That lets static changes
+///	be repaired in place around the cells they touch.
+// =====================================================
+
+class FlowField {
+public:
+	static const uint32 unreachableCost;
+	static const uint8 noDirection;
+
+private:
+	int commandGroupId;
+	Vec2i target;
+	Field field;
+	int size;
+	uint32 staticChangeCount;
+
+	int mapW;
+	int mapH;
+	vector<uint32> integration;
+	// index into the neighbour table, noDirection for the target and unreached cells
+	vector<uint8> direction;
+	// static free lookups per cell: 0 blocked, 1 free, 2 not looked up yet
+	vector<uint8> staticFree;
+
+public:
+	FlowField();
+
+	void build(const Map *map, int commandGroupId, const Vec2i &target,
+			Field field, int size, uint32 staticChangeCount);
+
+	bool matches(int commandGroupId, const Vec2i &target, Field field, int size) const {
+		return this->commandGroupId == commandGroupId && this->target == target &&
+				this->field == field && this->size == size;
+	}
+	uint32 getStaticChangeCount() const	{ return staticChangeCount; }
+	const Vec2i & getTarget() const		{ return target; }
+
+	// Repairs the field around the static changes made since it was built
+	// or last repaired, returns false if they are no longer all known and
+	// the field has to be built again
+	bool applyStaticChanges(const Map *map);
+
+	uint32 getCost(const Vec2i &pos) const;
+	bool getNextPos(const Vec2i &pos, Vec2i &nextPos) const;
+
+private:
+	bool isStaticFree(const ClusterMap *clusterMap, int x, int y);
+	// moving between cell and its neighbour k, a diagonal step needs both corners free
+	bool canStep(const ClusterMap *clusterMap, int cell, int k);
+	void updateDirection(const ClusterMap *clusterMap, int cell);
+	void updateDirectionsAround(const ClusterMap *clusterMap, const vector<int> &changedCells);
+	void relax(const ClusterMap *clusterMap, AStarOpenList<int> &openList,
+			const vector<bool> *onlyCells, vector<int> *changedCells);
+	void repairBlockedCells(const ClusterMap *clusterMap, const vector<int> &blockedCells,
+			vector<int> &affectedCells);
+	void repairOpenedCells(const ClusterMap *clusterMap, const vector<int> &openedCells,
+			const vector<int> &sourceCells);
+};
+
+// =====================================================
+// 	class FlowFieldCache
+//
+///	Small LRU of flow fields keyed by command group and target cell.
+///	Fields are only built, repaired and evicted in the serial update on the
+///	main thread. The precache threads run while the main thread waits and
+///	only read fields that are already up to date, so what they see never
+///	depends on thread timing and nobody waits behind a full map build.
+// =====================================================
+
+class FlowFieldCache {
+public:
+	static const int maxFlowFields;
+
+private:
+	typedef std::list<FlowField *> FlowFieldList;
+
+	FlowFieldList fields;	// most recently used first
+
+public:
+	FlowFieldCache();
+	~FlowFieldCache();
+
+	void clear();
+
+	// Follows the group's field from 'from' for up to maxCells steps.
+	// Returns false if 'from' can't reach the target over static terrain,
+	// or off the main thread when the field isn't built and current yet.
+	bool findPath(const Map *map, int commandGroupId, Field field, int size,
+			const Vec2i &from, const Vec2i &target, int maxCells, vector<Vec2i> &path);
+
+	int getFieldCount();
+
+private:
+	FlowFieldCache(const FlowFieldCache &obj);
+	FlowFieldCache &operator=(const FlowFieldCache &obj);
+
+	FlowField * getField(const Map *map, int commandGroupId, Field field, int size, const Vec2i &target);
+	const FlowField * findCurrentField(const Map *map, int commandGroupId, Field field, int size, const Vec2i &target) const;
+};
+
+}}//end namespace
+
+#endif
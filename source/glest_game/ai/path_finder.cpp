@@ -20,6 +20,8 @@
 #include "command.h"
 #include "faction.h"
 #include "randomgen.h"
+#include "task_pool.h"
+#include "zone_profiler.h"
 #include "leak_dumper.h"
 
 using namespace std;
@@ -44,6 +46,7 @@ const int PathFinder::pathFindBailoutRadius	= 20;
 const int PathFinder::pathFindExtendRefreshForNodeCount	= 25;
 const int PathFinder::pathFindExtendRefreshNodeCountMin	= 40;
 const int PathFinder::pathFindExtendRefreshNodeCountMax	= 40;
+const int PathFinder::flowFieldMinDistance					= 8;
 
 PathFinder::PathFinder() {
 	minorDebugPathfinder = false;
@@ -64,13 +67,15 @@ PathFinder::PathFinder(const Map *map) {
 }
 
 void PathFinder::init(const Map *map) {
+	this->map= map;
 	for(int factionIndex = 0; factionIndex < GameConstants::maxPlayers; ++factionIndex) {
-		FactionState &faction = factions.getFactionState(factionIndex);
-
-		faction.nodePool.resize(pathFindNodesAbsoluteMax);
-		faction.useMaxNodeCount = PathFinder::pathFindNodesMax;
+		initSearchState(factions.getFactionState(factionIndex));
 	}
-	this->map= map;
+	for(unsigned int workerIndex = 0; workerIndex < workerSearchStates.size(); ++workerIndex) {
+		initSearchState(*workerSearchStates[workerIndex]);
+	}
+	clearWorkerPrecache();
+	flowFields.clear();
 }
 
 void PathFinder::init() {
@@ -78,6 +83,73 @@ void PathFinder::init() {
 	map=NULL;
 }
 
+void PathFinder::initWorkerSearchStates(int workerCount) {
+	deleteWorkerSearchStates();
+	for(int workerIndex = 0; workerIndex < workerCount; ++workerIndex) {
+		FactionState *worker = new FactionState(-1);
+		initSearchState(*worker);
+		workerSearchStates.push_back(worker);
+	}
+}
+
+void PathFinder::initSearchState(FactionState &faction) {
+	faction.nodePool.resize(pathFindNodesAbsoluteMax);
+	faction.openNodesList.reserve(pathFindNodesAbsoluteMax);
+	faction.useMaxNodeCount = PathFinder::pathFindNodesMax;
+	if(map != NULL) {
+		faction.openPosList.resize(map->getW(), map->getH());
+	}
+}
+
+PathFinder::FactionState & PathFinder::getSearchState(int factionIndex) {
+	// the faction threads only search their own faction while the main
+	// thread waits, so they share its state like the main thread does
+	int workerIndex = WorkStealingTaskPool::getCurrentWorkerIndex();
+	if(workerIndex < 0) {
+		return factions.getFactionState(factionIndex);
+	}
+	if(workerIndex >= (int)workerSearchStates.size()) {
+		throw megaglest_runtime_error("No path finder search state for task pool worker " + intToStr(workerIndex));
+	}
+	return *workerSearchStates[workerIndex];
+}
+
+void PathFinder::mergeWorkerPrecache() {
+	// every unit is precached by exactly one worker per frame, so the
+	// result doesn't depend on the order the states are visited in
+	for(unsigned int workerIndex = 0; workerIndex < workerSearchStates.size(); ++workerIndex) {
+		FactionState &worker = *workerSearchStates[workerIndex];
+
+		for(std::map<int,TravelState>::iterator iterState = worker.precachedTravelState.begin();
+			iterState != worker.precachedTravelState.end(); ++iterState) {
+			FactionState &faction = factions.getFactionState(worker.precachedUnitFactions[iterState->first]);
+			faction.precachedTravelState[iterState->first] = iterState->second;
+		}
+		for(std::map<int,std::vector<Vec2i> >::iterator iterPath = worker.precachedPath.begin();
+			iterPath != worker.precachedPath.end(); ++iterPath) {
+			FactionState &faction = factions.getFactionState(worker.precachedUnitFactions[iterPath->first]);
+			faction.precachedPath[iterPath->first].swap(iterPath->second);
+		}
+	}
+	clearWorkerPrecache();
+}
+
+void PathFinder::clearWorkerPrecache() {
+	for(unsigned int workerIndex = 0; workerIndex < workerSearchStates.size(); ++workerIndex) {
+		FactionState &worker = *workerSearchStates[workerIndex];
+		worker.precachedTravelState.clear();
+		worker.precachedPath.clear();
+		worker.precachedUnitFactions.clear();
+	}
+}
+
+void PathFinder::deleteWorkerSearchStates() {
+	for(unsigned int workerIndex = 0; workerIndex < workerSearchStates.size(); ++workerIndex) {
+		delete workerSearchStates[workerIndex];
+	}
+	workerSearchStates.clear();
+}
+
 PathFinder::~PathFinder() {
 	for(int factionIndex = 0; factionIndex < GameConstants::maxPlayers; ++factionIndex) {
 		FactionState &faction = factions.getFactionState(factionIndex);
@@ -85,6 +157,7 @@ PathFinder::~PathFinder() {
 		faction.nodePool.clear();
 	}
 	factions.clear();
+	deleteWorkerSearchStates();
 	map=NULL;
 }
 
@@ -97,17 +170,22 @@ void PathFinder::clearCaches() {
 		faction.precachedTravelState.clear();
 		faction.precachedPath.clear();
 	}
+	clearWorkerPrecache();
+	flowFields.clear();
 }
 
 void PathFinder::clearUnitPrecache(Unit *unit) {
 	if(unit != NULL && factions.size() > unit->getFactionIndex()) {
 		int factionIndex = unit->getFactionIndex();
 		static string mutexOwnerId = string(__FILE__) + string("_") + intToStr(__LINE__);
-		FactionState &faction = factions.getFactionState(factionIndex);
+		FactionState &faction = getSearchState(factionIndex);
 		MutexSafeWrapper safeMutex(faction.getMutexPreCache(),mutexOwnerId);
 
 		faction.precachedTravelState[unit->getId()] = tsImpossible;
 		faction.precachedPath[unit->getId()].clear();
+		if(&faction != &factions.getFactionState(factionIndex)) {
+			faction.precachedUnitFactions[unit->getId()] = factionIndex;
+		}
 	}
 }
 
@@ -127,13 +205,14 @@ void PathFinder::removeUnitPrecache(Unit *unit) {
 	}
 }
 
-TravelState PathFinder::findPath(Unit *unit, const Vec2i &finalPos, bool *wasStuck, int frameIndex) {
+TravelState PathFinder::findPath(Unit *unit, const Vec2i &finalPos, bool *wasStuck, int frameIndex, int commandGroupId) {
+	PROFILE_ZONE("PathFinder::findPath");
 	TravelState ts = tsImpossible;
 
 	try {
 
 	int factionIndex = unit->getFactionIndex();
-	FactionState &faction = factions.getFactionState(factionIndex);
+	FactionState &faction = getSearchState(factionIndex);
 	static string mutexOwnerId = string(__FILE__) + string("_") + intToStr(__LINE__);
 	MutexSafeWrapper safeMutexPrecache(faction.getMutexPreCache(),mutexOwnerId);
 
@@ -146,21 +225,30 @@ TravelState PathFinder::findPath(Unit *unit, const Vec2i &finalPos, bool *wasStu
 
 	if(frameIndex >= 0) {
 		clearUnitPrecache(unit);
+
+		// Worker searches must not depend on which thread ran which unit before
+		if(Thread::isCurrentThreadMainThread() == false) {
+			faction.random.init(getPrecacheRandomSeed(unit, frameIndex));
+		}
 	}
-	if(unit->getFaction()->canUnitsPathfind() == true) {
-		unit->getFaction()->addUnitToPathfindingList(unit->getId());
-	}
-	else {
-		if(SystemFlags::getSystemSettingType(SystemFlags::debugWorldSynch).enabled == true && frameIndex < 0) {
-			char szBuf[8096]="";
-			snprintf(szBuf,8096,"canUnitsPathfind() == false");
-			unit->logSynchData(extractFileFromDirectoryPath(__FILE__).c_str(),__LINE__,szBuf);
+	// The per frame limit is only applied in the serial main update, the
+	// precache pass runs units out of order and mustn't touch the faction's list
+	if(frameIndex < 0) {
+		if(unit->getFaction()->canUnitsPathfind() == true) {
+			unit->getFaction()->addUnitToPathfindingList(unit->getId());
 		}
+		else {
+			if(SystemFlags::isDebugEnabled(SystemFlags::debugWorldSynch) == true) {
+				char szBuf[8096]="";
+				snprintf(szBuf,8096,"canUnitsPathfind() == false");
+				unit->logSynchData(extractFileFromDirectoryPath(__FILE__).c_str(),__LINE__,szBuf);
+			}
 
-		return tsBlocked;
+			return tsBlocked;
+		}
 	}
 
-	if(SystemFlags::getSystemSettingType(SystemFlags::debugWorldSynch).enabled == true && frameIndex < 0) {
+	if(SystemFlags::isDebugEnabled(SystemFlags::debugWorldSynch) == true && frameIndex < 0) {
 		char szBuf[8096]="";
 		snprintf(szBuf,8096,"[findPath] unit->getPos() [%s] finalPos [%s]",
 				unit->getPos().getString().c_str(),finalPos.getString().c_str());
@@ -173,14 +261,14 @@ TravelState PathFinder::findPath(Unit *unit, const Vec2i &finalPos, bool *wasStu
 			//if arrived
 			unit->setCurrSkill(scStop);
 
-			if(SystemFlags::getSystemSettingType(SystemFlags::debugWorldSynch).enabled == true) {
+			if(SystemFlags::isDebugEnabled(SystemFlags::debugWorldSynch) == true) {
 				char szBuf[8096]="";
 				snprintf(szBuf,8096,"Unit finalPos [%s] == unit->getPos() [%s]",finalPos.getString().c_str(),unit->getPos().getString().c_str());
 				unit->logSynchData(extractFileFromDirectoryPath(__FILE__).c_str(),__LINE__,szBuf);
 			}
 
 		}
-		if(SystemFlags::getSystemSettingType(SystemFlags::debugPathFinder).enabled == true) {
+		if(SystemFlags::isDebugEnabled(SystemFlags::debugPathFinder) == true) {
 			string commandDesc = "none";
 			Command *command= unit->getCurrCommand();
 			if(command != NULL && command->getCommandType() != NULL) {
@@ -203,8 +291,8 @@ TravelState PathFinder::findPath(Unit *unit, const Vec2i &finalPos, bool *wasStu
 
 			if(map->canMove(unit, unit->getPos(), pos)) {
 				if(frameIndex < 0) {
-					if(SystemFlags::getSystemSettingType(SystemFlags::debugWorldSynch).enabled == true &&
-							SystemFlags::getSystemSettingType(SystemFlags::debugWorldSynchMax).enabled == true) {
+					if(SystemFlags::isDebugEnabled(SystemFlags::debugWorldSynch) == true &&
+							SystemFlags::isDebugEnabled(SystemFlags::debugWorldSynchMax) == true) {
 						char szBuf[8096]="";
 						snprintf(szBuf,8096,"#1 map->canMove to pos [%s] from [%s]",pos.getString().c_str(),unit->getPos().getString().c_str());
 						unit->logSynchData(extractFileFromDirectoryPath(__FILE__).c_str(),__LINE__,szBuf);
@@ -212,8 +300,8 @@ TravelState PathFinder::findPath(Unit *unit, const Vec2i &finalPos, bool *wasStu
 
 					unit->setTargetPos(pos,frameIndex < 0);
 
-					if(SystemFlags::getSystemSettingType(SystemFlags::debugWorldSynch).enabled == true &&
-							SystemFlags::getSystemSettingType(SystemFlags::debugWorldSynchMax).enabled == true) {
+					if(SystemFlags::isDebugEnabled(SystemFlags::debugWorldSynch) == true &&
+							SystemFlags::isDebugEnabled(SystemFlags::debugWorldSynchMax) == true) {
 						char szBuf[8096]="";
 						snprintf(szBuf,8096,"#2 map->canMove to pos [%s] from [%s]",pos.getString().c_str(),unit->getPos().getString().c_str());
 						unit->logSynchData(extractFileFromDirectoryPath(__FILE__).c_str(),__LINE__,szBuf);
@@ -245,7 +333,7 @@ TravelState PathFinder::findPath(Unit *unit, const Vec2i &finalPos, bool *wasStu
 	if(path->isStuck() == true &&
 			(unit->getLastStuckPos() == finalPos || path->getBlockCount() > 500) &&
 		unit->isLastStuckFrameWithinCurrentFrameTolerance(frameIndex >= 0) == true) {
-		if(SystemFlags::getSystemSettingType(SystemFlags::debugWorldSynch).enabled == true && frameIndex < 0) {
+		if(SystemFlags::isDebugEnabled(SystemFlags::debugWorldSynch) == true && frameIndex < 0) {
 			char szBuf[8096]="";
 			snprintf(szBuf,8096,"path->isStuck() == true unit->getLastStuckPos() [%s] finalPos [%s] path->getBlockCount() [%d]",unit->getLastStuckPos().getString().c_str(),finalPos.getString().c_str(),path->getBlockCount());
 			unit->logSynchData(extractFileFromDirectoryPath(__FILE__).c_str(),__LINE__,szBuf);
@@ -260,7 +348,7 @@ TravelState PathFinder::findPath(Unit *unit, const Vec2i &finalPos, bool *wasStu
 
 		maxNodeCount= PathFinder::pathFindNodesAbsoluteMax;
 
-		if(SystemFlags::getSystemSettingType(SystemFlags::debugWorldSynch).enabled == true && frameIndex < 0) {
+		if(SystemFlags::isDebugEnabled(SystemFlags::debugWorldSynch) == true && frameIndex < 0) {
 			char szBuf[8096]="";
 			snprintf(szBuf,8096,"maxNodeCount: %d",maxNodeCount);
 			unit->logSynchData(extractFileFromDirectoryPath(__FILE__).c_str(),__LINE__,szBuf);
@@ -275,12 +363,20 @@ TravelState PathFinder::findPath(Unit *unit, const Vec2i &finalPos, bool *wasStu
 	minorDebugPathfinder = false;
 	if(minorDebugPathfinder) printf("Legacy Pathfind Unit [%d - %s] from = %s to = %s frameIndex = %d\n",unit->getId(),unit->getType()->getName(false).c_str(),unit->getPos().getString().c_str(),finalPos.getString().c_str(),frameIndex);
 
-	if(SystemFlags::getSystemSettingType(SystemFlags::debugWorldSynch).enabled == true && frameIndex < 0) {
+	if(SystemFlags::isDebugEnabled(SystemFlags::debugWorldSynch) == true && frameIndex < 0) {
 		char szBuf[8096]="";
 		snprintf(szBuf,8096,"calling aStar()");
 		unit->logSynchData(extractFileFromDirectoryPath(__FILE__).c_str(),__LINE__,szBuf);
 	}
 
+	// units moved as a group share one flow field instead of searching each
+	if(commandGroupId >= 0 && unit->getPos().dist(finalPos) > flowFieldMinDistance) {
+		ts = flowFieldPath(unit, finalPos, commandGroupId, frameIndex);
+		if(ts == tsMoving) {
+			return ts;
+		}
+	}
+
 	ts = aStar(unit, finalPos, false, frameIndex, maxNodeCount,&searched_node_count);
 	//post actions
 	switch(ts) {
@@ -293,7 +389,7 @@ TravelState PathFinder::findPath(Unit *unit, const Vec2i &finalPos, bool *wasStu
 
 				if(minorDebugPathfinder) printf("Pathfind Unit [%d - %s] START BAILOUT ATTEMPT frameIndex = %d\n",unit->getId(),unit->getType()->getName(false).c_str(),frameIndex);
 
-				if(SystemFlags::getSystemSettingType(SystemFlags::debugWorldSynch).enabled == true && frameIndex < 0) {
+				if(SystemFlags::isDebugEnabled(SystemFlags::debugWorldSynch) == true && frameIndex < 0) {
 					char szBuf[8096]="";
 					snprintf(szBuf,8096,"[attempting to BAIL OUT] finalPos [%s] ts [%d]",
 							finalPos.getString().c_str(),ts);
@@ -328,7 +424,7 @@ TravelState PathFinder::findPath(Unit *unit, const Vec2i &finalPos, bool *wasStu
 				if(unitImmediatelyBlocked == false) {
 
 					int factionIndex = unit->getFactionIndex();
-					FactionState &faction = factions.getFactionState(factionIndex);
+					FactionState &faction = getSearchState(factionIndex);
 
 					//if(Thread::isCurrentThreadMainThread() == false) {
 					//	throw megaglest_runtime_error("#2 Invalid access to FactionState random from outside main thread current id = " +
@@ -339,7 +435,7 @@ TravelState PathFinder::findPath(Unit *unit, const Vec2i &finalPos, bool *wasStu
 					//int tryRadius = faction.random.IRandomX(1,2);
 					//int tryRadius = 1;
 
-					if(SystemFlags::getSystemSettingType(SystemFlags::debugWorldSynch).enabled == true) {
+					if(SystemFlags::isDebugEnabled(SystemFlags::debugWorldSynch) == true) {
 						char szBuf[8096]="";
 						snprintf(szBuf,8096,"In astar bailout() tryRadius %d",tryRadius);
 
@@ -358,7 +454,7 @@ TravelState PathFinder::findPath(Unit *unit, const Vec2i &finalPos, bool *wasStu
 								const Vec2i newFinalPos = finalPos + Vec2i(bailoutX,bailoutY);
 								bool canUnitMove = map->canMove(unit, unit->getPos(), newFinalPos);
 
-								if(SystemFlags::getSystemSettingType(SystemFlags::debugWorldSynch).enabled == true && frameIndex < 0) {
+								if(SystemFlags::isDebugEnabled(SystemFlags::debugWorldSynch) == true && frameIndex < 0) {
 									char szBuf[8096]="";
 									snprintf(szBuf,8096,"[attempting to BAIL OUT] finalPos [%s] newFinalPos [%s] ts [%d] canUnitMove [%d]",
 											finalPos.getString().c_str(),newFinalPos.getString().c_str(),ts,canUnitMove);
@@ -369,7 +465,7 @@ TravelState PathFinder::findPath(Unit *unit, const Vec2i &finalPos, bool *wasStu
 
 									int maxBailoutNodeCount = (PathFinder::pathFindBailoutRadius * 2);
 
-									if(SystemFlags::getSystemSettingType(SystemFlags::debugWorldSynch).enabled == true && frameIndex < 0) {
+									if(SystemFlags::isDebugEnabled(SystemFlags::debugWorldSynch) == true && frameIndex < 0) {
 										char szBuf[8096]="";
 										snprintf(szBuf,8096,"calling aStar()");
 										unit->logSynchData(extractFileFromDirectoryPath(__FILE__).c_str(),__LINE__,szBuf);
@@ -386,7 +482,7 @@ TravelState PathFinder::findPath(Unit *unit, const Vec2i &finalPos, bool *wasStu
 								const Vec2i newFinalPos = finalPos + Vec2i(bailoutX,bailoutY);
 								bool canUnitMove = map->canMove(unit, unit->getPos(), newFinalPos);
 
-								if(SystemFlags::getSystemSettingType(SystemFlags::debugWorldSynch).enabled == true && frameIndex < 0) {
+								if(SystemFlags::isDebugEnabled(SystemFlags::debugWorldSynch) == true && frameIndex < 0) {
 									char szBuf[8096]="";
 									snprintf(szBuf,8096,"[attempting to BAIL OUT] finalPos [%s] newFinalPos [%s] ts [%d] canUnitMove [%d]",
 											finalPos.getString().c_str(),newFinalPos.getString().c_str(),ts,canUnitMove);
@@ -396,7 +492,7 @@ TravelState PathFinder::findPath(Unit *unit, const Vec2i &finalPos, bool *wasStu
 								if(canUnitMove) {
 									int maxBailoutNodeCount = (PathFinder::pathFindBailoutRadius * 2);
 
-									if(SystemFlags::getSystemSettingType(SystemFlags::debugWorldSynch).enabled == true && frameIndex < 0) {
+									if(SystemFlags::isDebugEnabled(SystemFlags::debugWorldSynch) == true && frameIndex < 0) {
 										char szBuf[8096]="";
 										snprintf(szBuf,8096,"calling aStar()");
 										unit->logSynchData(extractFileFromDirectoryPath(__FILE__).c_str(),__LINE__,szBuf);
@@ -451,7 +547,7 @@ TravelState PathFinder::findPath(Unit *unit, const Vec2i &finalPos, bool *wasStu
 
 						if(minorDebugPathfinderPerformance && chrono.getMillis() >= 1) printf("Unit [%d - %s] astar #2 took [%lld] msecs, ts = %d searched_node_count = %d.\n",unit->getId(),unit->getType()->getName(false).c_str(),(long long int)chrono.getMillis(),ts,searched_node_count);
 
-						if(SystemFlags::getSystemSettingType(SystemFlags::debugWorldSynch).enabled == true && frameIndex < 0) {
+						if(SystemFlags::isDebugEnabled(SystemFlags::debugWorldSynch) == true && frameIndex < 0) {
 							char szBuf[8096]="";
 							snprintf(szBuf,8096,"tsBlocked");
 							unit->logSynchData(extractFileFromDirectoryPath(__FILE__).c_str(),__LINE__,szBuf);
@@ -496,7 +592,7 @@ TravelState PathFinder::findPath(Unit *unit, const Vec2i &finalPos, bool *wasStu
 		//setRunningStatus(false);
 
 		SystemFlags::OutputDebug(SystemFlags::debugError,"In [%s::%s Line: %d] Error [%s]\n",__FILE__,__FUNCTION__,__LINE__,ex.what());
-		if(SystemFlags::getSystemSettingType(SystemFlags::debugSystem).enabled) SystemFlags::OutputDebug(SystemFlags::debugSystem,"In [%s::%s Line: %d]\n",__FILE__,__FUNCTION__,__LINE__);
+		if(SystemFlags::isDebugEnabled(SystemFlags::debugSystem)) SystemFlags::OutputDebug(SystemFlags::debugSystem,"In [%s::%s Line: %d]\n",__FILE__,__FUNCTION__,__LINE__);
 
 		throw megaglest_runtime_error(ex.what());
 	}
@@ -512,25 +608,75 @@ TravelState PathFinder::findPath(Unit *unit, const Vec2i &finalPos, bool *wasStu
 
 // ==================== PRIVATE ==================== 
 
+// walks the group's flow field, returns tsImpossible if the caller should search instead
+TravelState PathFinder::flowFieldPath(Unit *unit, const Vec2i &finalPos, int commandGroupId, int frameIndex) {
+	vector<Vec2i> cells;
+	if(flowFields.findPath(map, commandGroupId, unit->getCurrField(), unit->getType()->getSize(),
+			unit->getPos(), finalPos, unit->getPathFindRefreshCellCount(), cells) == false) {
+		return tsImpossible;
+	}
+
+	// other units in the way are left to the regular search
+	Vec2i pos = cells[0];
+	if(map->canMove(unit, unit->getPos(), pos) == false) {
+		return tsImpossible;
+	}
+
+	if(SystemFlags::isDebugEnabled(SystemFlags::debugWorldSynch) == true && frameIndex < 0) {
+		char szBuf[8096]="";
+		snprintf(szBuf,8096,"[flowFieldPath] commandGroupId [%d] finalPos [%s] next pos [%s] cells [%d]",
+				commandGroupId,finalPos.getString().c_str(),pos.getString().c_str(),(int)cells.size());
+		unit->logSynchData(extractFileFromDirectoryPath(__FILE__).c_str(),__LINE__,szBuf);
+	}
+
+	// the serial pass walks the field itself, nothing is precached
+	if(frameIndex >= 0) {
+		return tsMoving;
+	}
+
+	UnitPathInterface *path= unit->getPath();
+	path->clear();
+	for(unsigned int index = 0; index < cells.size(); ++index) {
+		path->add(cells[index]);
+	}
+
+	if(dynamic_cast<UnitPathBasic *>(path) != NULL) {
+		UnitPathBasic *basicPath = dynamic_cast<UnitPathBasic *>(path);
+		basicPath->pop(true);
+	}
+	else if(dynamic_cast<UnitPath *>(path) != NULL) {
+		UnitPath *advPath = dynamic_cast<UnitPath *>(path);
+		advPath->pop();
+	}
+	else {
+		throw megaglest_runtime_error("unsupported or missing path finder detected!");
+	}
+
+	unit->setUsePathfinderExtendedMaxNodes(false);
+	unit->setTargetPos(pos,true);
+	return tsMoving;
+}
+
 //route a unit using A* algorithm
 TravelState PathFinder::aStar(Unit *unit, const Vec2i &targetPos, bool inBailout,
 		int frameIndex, int maxNodeCount, uint32 *searched_node_count) {
+	PROFILE_ZONE("PathFinder::aStar");
 	TravelState ts = tsImpossible;
 
 	try {
 
 	int unitFactionIndex = unit->getFactionIndex();
 	int factionIndex = unit->getFactionIndex();
-	FactionState &faction = factions.getFactionState(factionIndex);
+	FactionState &faction = getSearchState(factionIndex);
 
-	if(SystemFlags::getSystemSettingType(SystemFlags::debugWorldSynch).enabled == true && frameIndex >= 0) {
+	if(SystemFlags::isDebugEnabled(SystemFlags::debugWorldSynch) == true && frameIndex >= 0) {
 		char szBuf[8096]="";
 		snprintf(szBuf,8096,"In aStar()");
 		unit->logSynchDataThreaded(__FILE__,__LINE__,szBuf);
 	}
 
 	Chrono chrono;
-	if(SystemFlags::getSystemSettingType(SystemFlags::debugPerformance).enabled) chrono.start();
+	if(SystemFlags::isDebugEnabled(SystemFlags::debugPerformance)) chrono.start();
 
 	if(map == NULL) {
 		throw megaglest_runtime_error("map == NULL");
@@ -540,7 +686,7 @@ TravelState PathFinder::aStar(Unit *unit, const Vec2i &targetPos, bool inBailout
 	if(maxNodeCount < 0) {
 
 		int factionIndex = unit->getFactionIndex();
-		FactionState &faction = factions.getFactionState(factionIndex);
+		FactionState &faction = getSearchState(factionIndex);
 
 		maxNodeCount = faction.useMaxNodeCount;
 	}
@@ -552,9 +698,8 @@ TravelState PathFinder::aStar(Unit *unit, const Vec2i &targetPos, bool inBailout
 	UnitPathInterface *path= unit->getPath();
 
 	faction.nodePoolCount= 0;
-	faction.openNodesList.clear();
-	faction.openPosList.clear();
-	faction.closedNodesList.clear();
+	faction.openPosList.resize(map->getW(), map->getH());
+	clearSearchLists(faction);
 
 	// check the pre-cache to see if we can re-use a cached path
 	if(frameIndex < 0) {
@@ -562,7 +707,7 @@ TravelState PathFinder::aStar(Unit *unit, const Vec2i &targetPos, bool inBailout
 		bool foundPrecacheTravelState = (faction.precachedTravelState.find(unit->getId()) != faction.precachedTravelState.end());
 		if(foundPrecacheTravelState == true) {
 
-//			if(SystemFlags::getSystemSettingType(SystemFlags::debugWorldSynch).enabled == true && frameIndex < 0) {
+//			if(SystemFlags::isDebugEnabled(SystemFlags::debugWorldSynch) == true && frameIndex < 0) {
 //				char szBuf[8096]="";
 //				snprintf(szBuf,8096,"factions[unitFactionIndex].precachedTravelState[unit->getId()]: %d",faction.precachedTravelState[unit->getId()]);
 //				unit->logSynchData(extractFileFromDirectoryPath(__FILE__).c_str(),__LINE__,szBuf);
@@ -622,7 +767,7 @@ TravelState PathFinder::aStar(Unit *unit, const Vec2i &targetPos, bool inBailout
 					}
 					unit->setUsePathfinderExtendedMaxNodes(false);
 
-					if(SystemFlags::getSystemSettingType(SystemFlags::debugWorldSynch).enabled == true) {
+					if(SystemFlags::isDebugEnabled(SystemFlags::debugWorldSynch) == true) {
 						char szBuf[8096]="";
 						snprintf(szBuf,8096,"return factions[unitFactionIndex].precachedTravelState[unit->getId()];");
 						unit->logSynchData(extractFileFromDirectoryPath(__FILE__).c_str(),__LINE__,szBuf);
@@ -642,7 +787,7 @@ TravelState PathFinder::aStar(Unit *unit, const Vec2i &targetPos, bool inBailout
 					path->incBlockCount();
 					unit->setUsePathfinderExtendedMaxNodes(false);
 
-//					if(SystemFlags::getSystemSettingType(SystemFlags::debugWorldSynch).enabled == true && frameIndex < 0) {
+//					if(SystemFlags::isDebugEnabled(SystemFlags::debugWorldSynch) == true && frameIndex < 0) {
 //						char szBuf[8096]="";
 //						snprintf(szBuf,8096,"return factions[unitFactionIndex].precachedTravelState[unit->getId()];");
 //						unit->logSynchData(extractFileFromDirectoryPath(__FILE__).c_str(),__LINE__,szBuf);
@@ -656,7 +801,7 @@ TravelState PathFinder::aStar(Unit *unit, const Vec2i &targetPos, bool inBailout
 	else {
 		clearUnitPrecache(unit);
 
-		if(SystemFlags::getSystemSettingType(SystemFlags::debugWorldSynch).enabled == true && frameIndex < 0) {
+		if(SystemFlags::isDebugEnabled(SystemFlags::debugWorldSynch) == true && frameIndex < 0) {
 			char szBuf[8096]="";
 			snprintf(szBuf,8096,"[clearUnitPrecache]");
 			unit->logSynchData(extractFileFromDirectoryPath(__FILE__).c_str(),__LINE__,szBuf);
@@ -668,9 +813,20 @@ TravelState PathFinder::aStar(Unit *unit, const Vec2i &targetPos, bool inBailout
 
 	float dist = unitPos.dist(finalPos);
 
+	// long paths are routed over the cluster graph first, A* then only
+	// has to find the way to the first cell beyond the current cluster
+	Vec2i searchPos = finalPos;
+	if(dist > ClusterMap::hierarchicalSearchMinDistance) {
+		Vec2i hopPos;
+		if(map->getClusterMap()->findFirstHop(unit->getCurrField(),
+				unit->getType()->getSize(), unitPos, finalPos, hopPos, faction.hopSearch) == true) {
+			searchPos = hopPos;
+		}
+	}
+
 	faction.useMaxNodeCount = PathFinder::pathFindNodesMax;
 
-	if(SystemFlags::getSystemSettingType(SystemFlags::debugPerformance).enabled == true && chrono.getMillis() > 4) SystemFlags::OutputDebug(SystemFlags::debugPerformance,"In [%s::%s Line: %d] took msecs: %lld\n",extractFileFromDirectoryPath(__FILE__).c_str(),__FUNCTION__,__LINE__,chrono.getMillis());
+	if(SystemFlags::isDebugEnabled(SystemFlags::debugPerformance) == true && chrono.getMillis() > 4) SystemFlags::OutputDebug(SystemFlags::debugPerformance,"In [%s::%s Line: %d] took msecs: %lld\n",extractFileFromDirectoryPath(__FILE__).c_str(),__FUNCTION__,__LINE__,chrono.getMillis());
 
 	//path find algorithm
 
@@ -683,20 +839,16 @@ TravelState PathFinder::aStar(Unit *unit, const Vec2i &targetPos, bool inBailout
 	firstNode->next= NULL;
 	firstNode->prev= NULL;
 	firstNode->pos= unitPos;
-	firstNode->heuristic= heuristic(unitPos, finalPos);
+	firstNode->heuristic= heuristic(unitPos, searchPos);
 	firstNode->exploredCell= true;
-	if(faction.openNodesList.find(firstNode->heuristic) == faction.openNodesList.end()) {
-		faction.openNodesList[firstNode->heuristic].clear();
-	}
-	faction.openNodesList[firstNode->heuristic].push_back(firstNode);
-	faction.openPosList[firstNode->pos] = true;
+	openNode(faction, firstNode);
 
 	//b) loop
 	bool pathFound			= true;
 	bool nodeLimitReached	= false;
 	Node *node				= NULL;
 
-	if(SystemFlags::getSystemSettingType(SystemFlags::debugPerformance).enabled == true && chrono.getMillis() > 4) SystemFlags::OutputDebug(SystemFlags::debugPerformance,"In [%s::%s Line: %d] took msecs: %lld\n",extractFileFromDirectoryPath(__FILE__).c_str(),__FUNCTION__,__LINE__,chrono.getMillis());
+	if(SystemFlags::isDebugEnabled(SystemFlags::debugPerformance) == true && chrono.getMillis() > 4) SystemFlags::OutputDebug(SystemFlags::debugPerformance,"In [%s::%s Line: %d] took msecs: %lld\n",extractFileFromDirectoryPath(__FILE__).c_str(),__FUNCTION__,__LINE__,chrono.getMillis());
 
 	// First check if unit currently blocked all around them, if so don't try to pathfind
 	if(inBailout == false && unitPos != finalPos) {
@@ -718,13 +870,27 @@ TravelState PathFinder::aStar(Unit *unit, const Vec2i &targetPos, bool inBailout
 		nodeLimitReached = (failureCount == cellCount);
 		pathFound = !nodeLimitReached;
 
-		if(SystemFlags::getSystemSettingType(SystemFlags::debugWorldSynch).enabled == true && frameIndex < 0) {
+		if(SystemFlags::isDebugEnabled(SystemFlags::debugWorldSynch) == true && frameIndex < 0) {
 			char szBuf[8096]="";
 			snprintf(szBuf,8096,"nodeLimitReached: %d failureCount: %d cellCount: %d",nodeLimitReached,failureCount,cellCount);
 			unit->logSynchData(extractFileFromDirectoryPath(__FILE__).c_str(),__LINE__,szBuf);
 		}
 
-		if(SystemFlags::getSystemSettingType(SystemFlags::debugPerformance).enabled == true && chrono.getMillis() > 1) SystemFlags::OutputDebug(SystemFlags::debugPerformance,"In [%s::%s Line: %d] **Check if dest blocked, distance for unit [%d - %s] from [%s] to [%s] is %.2f took msecs: %lld nodeLimitReached = %d, failureCount = %d\n",extractFileFromDirectoryPath(__FILE__).c_str(),__FUNCTION__,__LINE__,unit->getId(),unit->getFullName(false).c_str(), unitPos.getString().c_str(), finalPos.getString().c_str(), dist,(long long int)chrono.getMillis(),nodeLimitReached,failureCount);
+		if(SystemFlags::isDebugEnabled(SystemFlags::debugPerformance) == true && chrono.getMillis() > 1) SystemFlags::OutputDebug(SystemFlags::debugPerformance,"In [%s::%s Line: %d] **Check if dest blocked, distance for unit [%d - %s] from [%s] to [%s] is %.2f took msecs: %lld nodeLimitReached = %d, failureCount = %d\n",extractFileFromDirectoryPath(__FILE__).c_str(),__FUNCTION__,__LINE__,unit->getId(),unit->getFullName(false).c_str(), unitPos.getString().c_str(), finalPos.getString().c_str(), dist,(long long int)chrono.getMillis(),nodeLimitReached,failureCount);
+
+		// Don't search at all if the destination lies in another connected region
+		if(nodeLimitReached == false &&
+			map->getClusterMap()->isReachable(unit->getCurrField(),
+				unit->getType()->getSize(), unitPos, finalPos) == false) {
+			nodeLimitReached = true;
+			pathFound = false;
+
+			if(SystemFlags::isDebugEnabled(SystemFlags::debugWorldSynch) == true && frameIndex < 0) {
+				char szBuf[8096]="";
+				snprintf(szBuf,8096,"destination [%s] unreachable from [%s]",finalPos.getString().c_str(),unitPos.getString().c_str());
+				unit->logSynchData(extractFileFromDirectoryPath(__FILE__).c_str(),__LINE__,szBuf);
+			}
+		}
 
 		if(nodeLimitReached == false) {
 			// First check if final destination blocked
@@ -746,17 +912,17 @@ TravelState PathFinder::aStar(Unit *unit, const Vec2i &targetPos, bool inBailout
 			nodeLimitReached = (failureCount == cellCount);
 			pathFound = !nodeLimitReached;
 
-			if(SystemFlags::getSystemSettingType(SystemFlags::debugWorldSynch).enabled == true && frameIndex < 0) {
+			if(SystemFlags::isDebugEnabled(SystemFlags::debugWorldSynch) == true && frameIndex < 0) {
 				char szBuf[8096]="";
 				snprintf(szBuf,8096,"nodeLimitReached: %d failureCount: %d cellCount: %d",nodeLimitReached,failureCount,cellCount);
 				unit->logSynchData(extractFileFromDirectoryPath(__FILE__).c_str(),__LINE__,szBuf);
 			}
 
-			if(SystemFlags::getSystemSettingType(SystemFlags::debugPerformance).enabled == true && chrono.getMillis() > 1) SystemFlags::OutputDebug(SystemFlags::debugPerformance,"In [%s::%s Line: %d] **Check if dest blocked, distance for unit [%d - %s] from [%s] to [%s] is %.2f took msecs: %lld nodeLimitReached = %d, failureCount = %d\n",extractFileFromDirectoryPath(__FILE__).c_str(),__FUNCTION__,__LINE__,unit->getId(),unit->getFullName(false).c_str(), unitPos.getString().c_str(), finalPos.getString().c_str(), dist,(long long int)chrono.getMillis(),nodeLimitReached,failureCount);
+			if(SystemFlags::isDebugEnabled(SystemFlags::debugPerformance) == true && chrono.getMillis() > 1) SystemFlags::OutputDebug(SystemFlags::debugPerformance,"In [%s::%s Line: %d] **Check if dest blocked, distance for unit [%d - %s] from [%s] to [%s] is %.2f took msecs: %lld nodeLimitReached = %d, failureCount = %d\n",extractFileFromDirectoryPath(__FILE__).c_str(),__FUNCTION__,__LINE__,unit->getId(),unit->getFullName(false).c_str(), unitPos.getString().c_str(), finalPos.getString().c_str(), dist,(long long int)chrono.getMillis(),nodeLimitReached,failureCount);
 		}
 	}
 	else {
-		if(SystemFlags::getSystemSettingType(SystemFlags::debugWorldSynch).enabled == true && frameIndex < 0) {
+		if(SystemFlags::isDebugEnabled(SystemFlags::debugWorldSynch) == true && frameIndex < 0) {
 			char szBuf[8096]="";
 			snprintf(szBuf,8096,"inBailout: %d unitPos: [%s] finalPos [%s]",inBailout,unitPos.getString().c_str(), finalPos.getString().c_str());
 			unit->logSynchData(extractFileFromDirectoryPath(__FILE__).c_str(),__LINE__,szBuf);
@@ -774,7 +940,7 @@ TravelState PathFinder::aStar(Unit *unit, const Vec2i &targetPos, bool inBailout
 	int whileLoopCount = 0;
 	if(nodeLimitReached == false) {
 
-		if(SystemFlags::getSystemSettingType(SystemFlags::debugWorldSynch).enabled == true && frameIndex < 0) {
+		if(SystemFlags::isDebugEnabled(SystemFlags::debugWorldSynch) == true && frameIndex < 0) {
 			char szBuf[8096]="";
 			snprintf(szBuf,8096,"Calling doAStarPathSearch nodeLimitReached: %d whileLoopCount: %d unitFactionIndex: %d pathFound: %d finalPos [%s] maxNodeCount: %d frameIndex: %d",nodeLimitReached, whileLoopCount, unitFactionIndex,
 					pathFound, finalPos.getString().c_str(),  maxNodeCount,frameIndex);
@@ -782,7 +948,7 @@ TravelState PathFinder::aStar(Unit *unit, const Vec2i &targetPos, bool inBailout
 		}
 
 		doAStarPathSearch(nodeLimitReached, whileLoopCount, unitFactionIndex,
-							pathFound, node, finalPos,
+							pathFound, node, searchPos,
 							closedNodes, cameFrom, canAddNode, unit, maxNodeCount,frameIndex);
 
 		if(searched_node_count != NULL) {
@@ -797,7 +963,7 @@ TravelState PathFinder::aStar(Unit *unit, const Vec2i &targetPos, bool inBailout
 			unit->resetPathfindFailedConsecutiveFrameCount();
 		}
 
-		if(SystemFlags::getSystemSettingType(SystemFlags::debugWorldSynch).enabled == true && frameIndex < 0) {
+		if(SystemFlags::isDebugEnabled(SystemFlags::debugWorldSynch) == true && frameIndex < 0) {
 			char szBuf[8096]="";
 			snprintf(szBuf,8096,"Calling doAStarPathSearch nodeLimitReached: %d whileLoopCount: %d unitFactionIndex: %d pathFound: %d finalPos [%s] maxNodeCount: %d pathFindNodesAbsoluteMax: %d frameIndex: %d",nodeLimitReached, whileLoopCount, unitFactionIndex,
 					pathFound, finalPos.getString().c_str(),  maxNodeCount,pathFindNodesAbsoluteMax,frameIndex);
@@ -811,7 +977,7 @@ TravelState PathFinder::aStar(Unit *unit, const Vec2i &targetPos, bool inBailout
 					unit->setLastPathfindFailedPos(finalPos);
 				}
 
-				if(SystemFlags::getSystemSettingType(SystemFlags::debugWorldSynch).enabled == true && frameIndex < 0) {
+				if(SystemFlags::isDebugEnabled(SystemFlags::debugWorldSynch) == true && frameIndex < 0) {
 					char szBuf[8096]="";
 					snprintf(szBuf,8096,"calling aStar()");
 					unit->logSynchData(extractFileFromDirectoryPath(__FILE__).c_str(),__LINE__,szBuf);
@@ -822,7 +988,7 @@ TravelState PathFinder::aStar(Unit *unit, const Vec2i &targetPos, bool inBailout
 		}
 	}
 	else {
-		if(SystemFlags::getSystemSettingType(SystemFlags::debugWorldSynch).enabled == true && frameIndex < 0) {
+		if(SystemFlags::isDebugEnabled(SystemFlags::debugWorldSynch) == true && frameIndex < 0) {
 			char szBuf[8096]="";
 			snprintf(szBuf,8096,"nodeLimitReached: %d",nodeLimitReached);
 			unit->logSynchData(extractFileFromDirectoryPath(__FILE__).c_str(),__LINE__,szBuf);
@@ -835,15 +1001,15 @@ TravelState PathFinder::aStar(Unit *unit, const Vec2i &targetPos, bool inBailout
 	//if consumed all nodes find best node (to avoid strange behaviour)
 	if(nodeLimitReached == true) {
 
-		if(faction.closedNodesList.empty() == false) {
-			float bestHeuristic = truncateDecimal<float>(faction.closedNodesList.begin()->first,6);
+		if(faction.bestClosedNode != NULL) {
+			float bestHeuristic = truncateDecimal<float>(faction.bestClosedNode->heuristic,6);
 			if(lastNode != NULL && bestHeuristic < lastNode->heuristic) {
-				lastNode= faction.closedNodesList.begin()->second.front();
+				lastNode= faction.bestClosedNode;
 			}
 		}
 	}
 
-	if(SystemFlags::getSystemSettingType(SystemFlags::debugPerformance).enabled == true && chrono.getMillis() > 4) SystemFlags::OutputDebug(SystemFlags::debugPerformance,"In [%s::%s Line: %d] took msecs: %lld\n",extractFileFromDirectoryPath(__FILE__).c_str(),__FUNCTION__,__LINE__,chrono.getMillis());
+	if(SystemFlags::isDebugEnabled(SystemFlags::debugPerformance) == true && chrono.getMillis() > 4) SystemFlags::OutputDebug(SystemFlags::debugPerformance,"In [%s::%s Line: %d] took msecs: %lld\n",extractFileFromDirectoryPath(__FILE__).c_str(),__FUNCTION__,__LINE__,chrono.getMillis());
 
 	//check results of path finding
 	ts = tsImpossible;
@@ -851,7 +1017,7 @@ TravelState PathFinder::aStar(Unit *unit, const Vec2i &targetPos, bool inBailout
 		if(minorDebugPathfinder) printf("Legacy Pathfind Unit [%d - %s] NOT FOUND PATH count = %d frameIndex = %d\n",unit->getId(),unit->getType()->getName().c_str(),whileLoopCount,frameIndex);
 
 		//blocked
-		if(SystemFlags::getSystemSettingType(SystemFlags::debugPathFinder).enabled == true) {
+		if(SystemFlags::isDebugEnabled(SystemFlags::debugPathFinder) == true) {
 			string commandDesc = "none";
 			Command *command= unit->getCurrCommand();
 			if(command != NULL && command->getCommandType() != NULL) {
@@ -874,7 +1040,7 @@ TravelState PathFinder::aStar(Unit *unit, const Vec2i &targetPos, bool inBailout
 			path->incBlockCount();
 		}
 
-		if(SystemFlags::getSystemSettingType(SystemFlags::debugPerformance).enabled == true && chrono.getMillis() > 4) SystemFlags::OutputDebug(SystemFlags::debugPerformance,"In [%s::%s Line: %d] took msecs: %lld\n",extractFileFromDirectoryPath(__FILE__).c_str(),__FUNCTION__,__LINE__,chrono.getMillis());
+		if(SystemFlags::isDebugEnabled(SystemFlags::debugPerformance) == true && chrono.getMillis() > 4) SystemFlags::OutputDebug(SystemFlags::debugPerformance,"In [%s::%s Line: %d] took msecs: %lld\n",extractFileFromDirectoryPath(__FILE__).c_str(),__FUNCTION__,__LINE__,chrono.getMillis());
 	}
 	else {
 		if(minorDebugPathfinder) printf("Legacy Pathfind Unit [%d - %s] FOUND PATH count = %d frameIndex = %d\n",unit->getId(),unit->getType()->getName().c_str(),whileLoopCount,frameIndex);
@@ -888,7 +1054,7 @@ TravelState PathFinder::aStar(Unit *unit, const Vec2i &targetPos, bool inBailout
 			currNode= currNode->prev;
 		}
 
-		if(SystemFlags::getSystemSettingType(SystemFlags::debugPerformance).enabled == true && chrono.getMillis() > 4) SystemFlags::OutputDebug(SystemFlags::debugPerformance,"In [%s::%s Line: %d] took msecs: %lld\n",extractFileFromDirectoryPath(__FILE__).c_str(),__FUNCTION__,__LINE__,chrono.getMillis());
+		if(SystemFlags::isDebugEnabled(SystemFlags::debugPerformance) == true && chrono.getMillis() > 4) SystemFlags::OutputDebug(SystemFlags::debugPerformance,"In [%s::%s Line: %d] took msecs: %lld\n",extractFileFromDirectoryPath(__FILE__).c_str(),__FUNCTION__,__LINE__,chrono.getMillis());
 
 		if(frameIndex < 0) {
 			if(maxNodeCount == pathFindNodesAbsoluteMax) {
@@ -928,10 +1094,10 @@ TravelState PathFinder::aStar(Unit *unit, const Vec2i &targetPos, bool inBailout
 			}
 		}
 
-		if(SystemFlags::getSystemSettingType(SystemFlags::debugPerformance).enabled == true && chrono.getMillis() > 4) SystemFlags::OutputDebug(SystemFlags::debugPerformance,"In [%s::%s Line: %d] took msecs: %lld\n",extractFileFromDirectoryPath(__FILE__).c_str(),__FUNCTION__,__LINE__,chrono.getMillis());
+		if(SystemFlags::isDebugEnabled(SystemFlags::debugPerformance) == true && chrono.getMillis() > 4) SystemFlags::OutputDebug(SystemFlags::debugPerformance,"In [%s::%s Line: %d] took msecs: %lld\n",extractFileFromDirectoryPath(__FILE__).c_str(),__FUNCTION__,__LINE__,chrono.getMillis());
 
-		if(SystemFlags::getSystemSettingType(SystemFlags::debugWorldSynch).enabled == true &&
-				SystemFlags::getSystemSettingType(SystemFlags::debugWorldSynchMax).enabled == true) {
+		if(SystemFlags::isDebugEnabled(SystemFlags::debugWorldSynch) == true &&
+				SystemFlags::isDebugEnabled(SystemFlags::debugWorldSynchMax) == true) {
 			char szBuf[8096]="";
 
 			string pathToTake = "";
@@ -963,7 +1129,7 @@ TravelState PathFinder::aStar(Unit *unit, const Vec2i &targetPos, bool inBailout
 			}
 		}
 
-		if(SystemFlags::getSystemSettingType(SystemFlags::debugPathFinder).enabled == true) {
+		if(SystemFlags::isDebugEnabled(SystemFlags::debugPathFinder) == true) {
 			string commandDesc = "none";
 			Command *command= unit->getCurrCommand();
 			if(command != NULL && command->getCommandType() != NULL) {
@@ -975,26 +1141,24 @@ TravelState PathFinder::aStar(Unit *unit, const Vec2i &targetPos, bool inBailout
 			unit->setCurrentUnitTitle(szBuf);
 		}
 
-		if(SystemFlags::getSystemSettingType(SystemFlags::debugPerformance).enabled == true && chrono.getMillis() > 4) SystemFlags::OutputDebug(SystemFlags::debugPerformance,"In [%s::%s Line: %d] took msecs: %lld\n",extractFileFromDirectoryPath(__FILE__).c_str(),__FUNCTION__,__LINE__,chrono.getMillis());
+		if(SystemFlags::isDebugEnabled(SystemFlags::debugPerformance) == true && chrono.getMillis() > 4) SystemFlags::OutputDebug(SystemFlags::debugPerformance,"In [%s::%s Line: %d] took msecs: %lld\n",extractFileFromDirectoryPath(__FILE__).c_str(),__FUNCTION__,__LINE__,chrono.getMillis());
 	}
 
 
-	faction.openNodesList.clear();
-	faction.openPosList.clear();
-	faction.closedNodesList.clear();
+	clearSearchLists(faction);
 
-	if(SystemFlags::getSystemSettingType(SystemFlags::debugPerformance).enabled == true && chrono.getMillis() > 4) SystemFlags::OutputDebug(SystemFlags::debugPerformance,"In [%s::%s] Line: %d took msecs: %lld --------------------------- [END OF METHOD] ---------------------------\n",extractFileFromDirectoryPath(__FILE__).c_str(),__FUNCTION__,__LINE__,chrono.getMillis());
+	if(SystemFlags::isDebugEnabled(SystemFlags::debugPerformance) == true && chrono.getMillis() > 4) SystemFlags::OutputDebug(SystemFlags::debugPerformance,"In [%s::%s] Line: %d took msecs: %lld --------------------------- [END OF METHOD] ---------------------------\n",extractFileFromDirectoryPath(__FILE__).c_str(),__FUNCTION__,__LINE__,chrono.getMillis());
 
 	if(frameIndex >= 0) {
 
-		FactionState &faction = factions.getFactionState(factionIndex);
+		FactionState &faction = getSearchState(factionIndex);
 		faction.precachedTravelState[unit->getId()] = ts;
 	}
 	else {
 		if(SystemFlags::VERBOSE_MODE_ENABLED && chrono.getMillis() >= 5) printf("In [%s::%s Line: %d] astar took [%lld] msecs, ts = %d.\n",extractFileFromDirectoryPath(__FILE__).c_str(),__FUNCTION__,__LINE__,(long long int)chrono.getMillis(),ts);
 	}
 
-	if(SystemFlags::getSystemSettingType(SystemFlags::debugWorldSynch).enabled == true && frameIndex < 0) {
+	if(SystemFlags::isDebugEnabled(SystemFlags::debugWorldSynch) == true && frameIndex < 0) {
 		char szBuf[8096]="";
 		snprintf(szBuf,8096,"return ts: %d",ts);
 		unit->logSynchData(extractFileFromDirectoryPath(__FILE__).c_str(),__LINE__,szBuf);
@@ -1004,7 +1168,7 @@ TravelState PathFinder::aStar(Unit *unit, const Vec2i &targetPos, bool inBailout
 	catch(const exception &ex) {
 
 		SystemFlags::OutputDebug(SystemFlags::debugError,"In [%s::%s Line: %d] Error [%s]\n",__FILE__,__FUNCTION__,__LINE__,ex.what());
-		if(SystemFlags::getSystemSettingType(SystemFlags::debugSystem).enabled) SystemFlags::OutputDebug(SystemFlags::debugSystem,"In [%s::%s Line: %d]\n",__FILE__,__FUNCTION__,__LINE__);
+		if(SystemFlags::isDebugEnabled(SystemFlags::debugSystem)) SystemFlags::OutputDebug(SystemFlags::debugSystem,"In [%s::%s Line: %d]\n",__FILE__,__FUNCTION__,__LINE__);
 
 		throw megaglest_runtime_error(ex.what());
 	}
@@ -1018,12 +1182,14 @@ TravelState PathFinder::aStar(Unit *unit, const Vec2i &targetPos, bool inBailout
 	return ts;
 }
 
-void PathFinder::processNearestFreePos(const Vec2i &finalPos, int i, int j, int size, Field field, int teamIndex,Vec2i unitPos, Vec2i &nearestPos, float &nearestDist) {
+void PathFinder::processNearestFreePos(const Vec2i &finalPos, int i, int j, int size, Field field, int teamIndex,Vec2i unitPos,
+		const ClusterMap::Layer *regionLayer, int unitRegion, Vec2i &nearestPos, float &nearestDist) {
 
 	try {
 		Vec2i currPos= finalPos + Vec2i(i, j);
 
-		if(map->isAproxFreeCells(currPos, size, field, teamIndex)) {
+		if(map->isAproxFreeCells(currPos, size, field, teamIndex) &&
+			isRegionReachable(regionLayer, unitRegion, currPos)) {
 			float dist = currPos.dist(finalPos);
 
 			//if nearer from finalPos
@@ -1042,7 +1208,7 @@ void PathFinder::processNearestFreePos(const Vec2i &finalPos, int i, int j, int
 	catch(const exception &ex) {
 
 		SystemFlags::OutputDebug(SystemFlags::debugError,"In [%s::%s Line: %d] Error [%s]\n",__FILE__,__FUNCTION__,__LINE__,ex.what());
-		if(SystemFlags::getSystemSettingType(SystemFlags::debugSystem).enabled) SystemFlags::OutputDebug(SystemFlags::debugSystem,"In [%s::%s Line: %d]\n",__FILE__,__FUNCTION__,__LINE__);
+		if(SystemFlags::isDebugEnabled(SystemFlags::debugSystem)) SystemFlags::OutputDebug(SystemFlags::debugSystem,"In [%s::%s Line: %d]\n",__FILE__,__FUNCTION__,__LINE__);
 
 		throw megaglest_runtime_error(ex.what());
 	}
@@ -1069,20 +1235,25 @@ Vec2i PathFinder::computeNearestFreePos(const Unit *unit, const Vec2i &finalPos)
 	Field field= unit->getCurrField();
 	int teamIndex= unit->getTeam();
 
-	//if finalPos is free return it
-	if(map->isAproxFreeCells(finalPos, size, field, teamIndex)) {
+	Vec2i unitPos= unit->getPosNotThreadSafe();
+	// one layer lookup for the whole search window, cells are read directly
+	const ClusterMap::Layer *regionLayer= map->getClusterMap()->getReadLayer(field, size);
+	int unitRegion= (regionLayer != NULL ? map->getClusterMap()->getRegionLabel(regionLayer, unitPos) : -1);
+
+	//if finalPos is free (and not cut off from the unit) return it
+	if(map->isAproxFreeCells(finalPos, size, field, teamIndex) &&
+		isRegionReachable(regionLayer, unitRegion, finalPos)) {
 		return finalPos;
 	}
 
 	//find nearest pos
-	Vec2i unitPos= unit->getPosNotThreadSafe();
 	nearestPos= unitPos;
 
 	float nearestDist = unitPos.dist(finalPos);
 
 	for(int i= -maxFreeSearchRadius; i <= maxFreeSearchRadius; ++i) {
 		for(int j= -maxFreeSearchRadius; j <= maxFreeSearchRadius; ++j) {
-			processNearestFreePos(finalPos, i, j, size, field, teamIndex, unitPos, nearestPos, nearestDist);
+			processNearestFreePos(finalPos, i, j, size, field, teamIndex, unitPos, regionLayer, unitRegion, nearestPos, nearestDist);
 		}
 	}
 
@@ -1090,7 +1261,7 @@ Vec2i PathFinder::computeNearestFreePos(const Unit *unit, const Vec2i &finalPos)
 	catch(const exception &ex) {
 
 		SystemFlags::OutputDebug(SystemFlags::debugError,"In [%s::%s Line: %d] Error [%s]\n",__FILE__,__FUNCTION__,__LINE__,ex.what());
-		if(SystemFlags::getSystemSettingType(SystemFlags::debugSystem).enabled) SystemFlags::OutputDebug(SystemFlags::debugSystem,"In [%s::%s Line: %d]\n",__FILE__,__FUNCTION__,__LINE__);
+		if(SystemFlags::isDebugEnabled(SystemFlags::debugSystem)) SystemFlags::OutputDebug(SystemFlags::debugSystem,"In [%s::%s Line: %d]\n",__FILE__,__FUNCTION__,__LINE__);
 
 		throw megaglest_runtime_error(ex.what());
 	}
@@ -1160,7 +1331,7 @@ int PathFinder::findNodeIndex(Node *node, std::vector<Node> &nodeList) {
 //		//setRunningStatus(false);
 //
 //		SystemFlags::OutputDebug(SystemFlags::debugError,"In [%s::%s Line: %d] Error [%s]\n",__FILE__,__FUNCTION__,__LINE__,ex.what());
-//		if(SystemFlags::getSystemSettingType(SystemFlags::debugSystem).enabled) SystemFlags::OutputDebug(SystemFlags::debugSystem,"In [%s::%s Line: %d]\n",__FILE__,__FUNCTION__,__LINE__);
+//		if(SystemFlags::isDebugEnabled(SystemFlags::debugSystem)) SystemFlags::OutputDebug(SystemFlags::debugSystem,"In [%s::%s Line: %d]\n",__FILE__,__FUNCTION__,__LINE__);
 //
 //		throw megaglest_runtime_error(ex.what());
 //	}
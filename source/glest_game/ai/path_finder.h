@@ -24,11 +24,15 @@
 #include "skill_type.h"
 #include "map.h"
 #include "unit.h"
+#include "astar_containers.h"
+#include "flow_field.h"
 //#include "randomc.h"
 #include "leak_dumper.h"
 
 using std::vector;
 using Shared::Graphics::Vec2i;
+using Shared::Util::AStarOpenList;
+using Shared::Util::GenerationMarkGrid;
 
 namespace Glest { namespace Game {
 
@@ -96,7 +100,8 @@ public:
 
 			openPosList.clear();
 			openNodesList.clear();
-			closedNodesList.clear();
+			bestClosedNode = NULL;
+			closedNodesCount = 0;
 			nodePool.clear();
 			nodePoolCount = 0;
 			this->factionIndex = factionIndex;
@@ -114,9 +119,12 @@ public:
 			return factionMutexPrecache;
 		}
 
-		std::map<Vec2i, bool> openPosList;
-		std::map<float, Nodes> openNodesList;
-		std::map<float, Nodes> closedNodesList;
+		// positions that have been opened (or closed) by the current search
+		GenerationMarkGrid openPosList;
+		AStarOpenList<Node *> openNodesList;
+		// first closed node with the lowest heuristic, used when the node limit is hit
+		Node *bestClosedNode;
+		int closedNodesCount;
 		std::vector<Node> nodePool;
 
 		int nodePoolCount;
@@ -127,6 +135,10 @@ public:
 
 		std::map<int,TravelState> precachedTravelState;
 		std::map<int,std::vector<Vec2i> > precachedPath;
+		// worker states only: faction of every unit precached this frame
+		std::map<int,int> precachedUnitFactions;
+
+		ClusterMap::HopSearchBuffers hopSearch;
 	};
 
 	class FactionStateManager {
@@ -171,6 +183,8 @@ public:
 	static const int pathFindExtendRefreshForNodeCount;
 	static const int pathFindExtendRefreshNodeCountMin;
 	static const int pathFindExtendRefreshNodeCountMax;
+	// grouped moves closer than this use a regular search to sort out crowding
+	static const int flowFieldMinDistance;
 
 private:
 
@@ -179,6 +193,10 @@ private:
 
 
 	FactionStateManager factions;
+	// search state of every task pool worker, indexed by worker and reused
+	// for whatever faction it searches next; merged by mergeWorkerPrecache()
+	vector<FactionState *> workerSearchStates;
+	FlowFieldCache flowFields;
 	const Map *map;
 	bool minorDebugPathfinder;
 
@@ -197,10 +215,14 @@ public:
 	}
 
 	void init(const Map *map);
-	TravelState findPath(Unit *unit, const Vec2i &finalPos, bool *wasStuck=NULL,int frameIndex=-1);
+	// allocates one search state per task pool worker up front
+	void initWorkerSearchStates(int workerCount);
+	TravelState findPath(Unit *unit, const Vec2i &finalPos, bool *wasStuck=NULL,int frameIndex=-1, int commandGroupId=-1);
 	void clearUnitPrecache(Unit *unit);
 	void removeUnitPrecache(Unit *unit);
 	void clearCaches();
+	// moves paths precached by worker threads into the faction state
+	void mergeWorkerPrecache();
 
 	//bool unitCannotMove(Unit *unit);
 
@@ -213,6 +235,14 @@ public:
 private:
 	void init();
 
+	FactionState & getSearchState(int factionIndex);
+	void initSearchState(FactionState &faction);
+	void clearWorkerPrecache();
+	void deleteWorkerSearchStates();
+	inline static int getPrecacheRandomSeed(const Unit *unit, int frameIndex) {
+		return (frameIndex % 10000) * 10007 + unit->getId();
+	}
+
 	TravelState aStar(Unit *unit, const Vec2i &finalPos, bool inBailout,
 			int frameIndex, int maxNodeCount=-1,uint32 *searched_node_count=NULL);
 	inline static Node *newNode(FactionState &faction, int maxNodeCount) {
@@ -226,6 +256,8 @@ private:
 		return NULL;
 	}
 
+	TravelState flowFieldPath(Unit *unit, const Vec2i &finalPos, int commandGroupId, int frameIndex);
+
 	Vec2i computeNearestFreePos(const Unit *unit, const Vec2i &targetPos);
 
 	inline static float heuristic(const Vec2i &pos, const Vec2i &finalPos) {
@@ -233,10 +265,7 @@ private:
 	}
 
 	inline static bool openPos(const Vec2i &sucPos, FactionState &faction) {
-		if(faction.openPosList.find(sucPos) == faction.openPosList.end()) {
-			return false;
-		}
-		return true;
+		return faction.openPosList.isMarked(sucPos.x, sucPos.y);
 	}
 
 	inline static Node * minHeuristicFastLookup(FactionState &faction) {
@@ -244,12 +273,28 @@ private:
 			throw megaglest_runtime_error("openNodesList.empty() == true");
 		}
 
-		Node *result = faction.openNodesList.begin()->second.front();
-		faction.openNodesList.begin()->second.erase(faction.openNodesList.begin()->second.begin());
-		if(faction.openNodesList.begin()->second.empty()) {
-			faction.openNodesList.erase(faction.openNodesList.begin());
+		return faction.openNodesList.pop();
+	}
+
+	inline static void openNode(FactionState &faction, Node *node) {
+		faction.openNodesList.push(node->heuristic, node);
+		faction.openPosList.mark(node->pos.x, node->pos.y);
+	}
+
+	inline static void closeNode(FactionState &faction, Node *node) {
+		if(faction.bestClosedNode == NULL ||
+			node->heuristic < faction.bestClosedNode->heuristic) {
+			faction.bestClosedNode = node;
 		}
-		return result;
+		faction.closedNodesCount++;
+		faction.openPosList.mark(node->pos.x, node->pos.y);
+	}
+
+	inline static void clearSearchLists(FactionState &faction) {
+		faction.openNodesList.clear();
+		faction.openPosList.clear();
+		faction.bestClosedNode = NULL;
+		faction.closedNodesCount = 0;
 	}
 
 	inline bool processNode(Unit *unit, Node *node,const Vec2i finalPos,
@@ -258,15 +303,15 @@ private:
 		Vec2i sucPos= node->pos + Vec2i(x, y);
 
 		int unitFactionIndex = unit->getFactionIndex();
-		FactionState &faction = factions.getFactionState(unitFactionIndex);
+		FactionState &faction = getSearchState(unitFactionIndex);
 
 		bool foundOpenPosForPos = openPos(sucPos, faction);
 		bool allowUnitMoveSoon = canUnitMoveSoon(unit, node->pos, sucPos);
-		if(SystemFlags::getSystemSettingType(SystemFlags::debugWorldSynch).enabled == true &&
-				SystemFlags::getSystemSettingType(SystemFlags::debugWorldSynchMax).enabled == true) {
+		if(SystemFlags::isDebugEnabled(SystemFlags::debugWorldSynch) == true &&
+				SystemFlags::isDebugEnabled(SystemFlags::debugWorldSynchMax) == true) {
 			char szBuf[8096]="";
-			snprintf(szBuf,8096,"In processNode() nodeLimitReached %d unitFactionIndex %d foundOpenPosForPos %d allowUnitMoveSoon %d maxNodeCount %d node->pos = %s finalPos = %s sucPos = %s faction.openPosList.size() %lu closedNodesList.size() %lu",
-					nodeLimitReached,unitFactionIndex,foundOpenPosForPos, allowUnitMoveSoon, maxNodeCount,node->pos.getString().c_str(),finalPos.getString().c_str(),sucPos.getString().c_str(),faction.openPosList.size(),faction.closedNodesList.size());
+			snprintf(szBuf,8096,"In processNode() nodeLimitReached %d unitFactionIndex %d foundOpenPosForPos %d allowUnitMoveSoon %d maxNodeCount %d node->pos = %s finalPos = %s sucPos = %s faction.openPosList.size() %u closedNodesList.size() %d",
+					nodeLimitReached,unitFactionIndex,foundOpenPosForPos, allowUnitMoveSoon, maxNodeCount,node->pos.getString().c_str(),finalPos.getString().c_str(),sucPos.getString().c_str(),faction.openPosList.getMarkedCount(),faction.closedNodesCount);
 
 			if(Thread::isCurrentThreadMainThread() == false) {
 				unit->logSynchDataThreaded(__FILE__,__LINE__,szBuf);
@@ -286,16 +331,12 @@ private:
 				sucNode->next= NULL;
 				sucNode->exploredCell = map->getSurfaceCell(
 						Map::toSurfCoords(sucPos))->isExplored(unit->getTeam());
-				if(faction.openNodesList.find(sucNode->heuristic) == faction.openNodesList.end()) {
-					faction.openNodesList[sucNode->heuristic].clear();
-				}
-				faction.openNodesList[sucNode->heuristic].push_back(sucNode);
-				faction.openPosList[sucNode->pos] = true;
+				openNode(faction, sucNode);
 
 				result = true;
 
-				if(SystemFlags::getSystemSettingType(SystemFlags::debugWorldSynch).enabled == true &&
-						SystemFlags::getSystemSettingType(SystemFlags::debugWorldSynchMax).enabled == true) {
+				if(SystemFlags::isDebugEnabled(SystemFlags::debugWorldSynch) == true &&
+						SystemFlags::isDebugEnabled(SystemFlags::debugWorldSynchMax) == true) {
 					char szBuf[8096]="";
 					snprintf(szBuf,8096,"In processNode() sucPos = %s",sucPos.getString().c_str());
 
@@ -317,7 +358,16 @@ private:
 	}
 
 	void processNearestFreePos(const Vec2i &finalPos, int i, int j, int size,
-			Field field, int teamIndex,Vec2i unitPos, Vec2i &nearestPos, float &nearestDist);
+			Field field, int teamIndex,Vec2i unitPos, const ClusterMap::Layer *regionLayer,
+			int unitRegion, Vec2i &nearestPos, float &nearestDist);
+
+	inline bool isRegionReachable(const ClusterMap::Layer *regionLayer, int unitRegion, const Vec2i &pos) {
+		if(unitRegion < 0) {
+			return true;
+		}
+		int region = map->getClusterMap()->getRegionLabel(regionLayer, pos);
+		return region < 0 || region == unitRegion;
+	}
 	int getPathFindExtendRefreshNodeCount(FactionState &faction);
 
 	inline bool canUnitMoveSoon(Unit *unit, const Vec2i &pos1, const Vec2i &pos2) {
@@ -331,8 +381,8 @@ private:
 			const std::map<Vec2i,Vec2i> &cameFrom, const std::map<std::pair<Vec2i,Vec2i> ,bool> &canAddNode,
 			Unit *& unit, int & maxNodeCount, int curFrameIndex)  {
 
-		if(SystemFlags::getSystemSettingType(SystemFlags::debugWorldSynch).enabled == true &&
-				SystemFlags::getSystemSettingType(SystemFlags::debugWorldSynchMax).enabled == true) {
+		if(SystemFlags::isDebugEnabled(SystemFlags::debugWorldSynch) == true &&
+				SystemFlags::isDebugEnabled(SystemFlags::debugWorldSynchMax) == true) {
 			char szBuf[8096]="";
 			snprintf(szBuf,8096,"In doAStarPathSearch() nodeLimitReached %d whileLoopCount %d unitFactionIndex %d pathFound %d maxNodeCount %d",
 					nodeLimitReached,whileLoopCount,unitFactionIndex,pathFound, maxNodeCount);
@@ -345,13 +395,13 @@ private:
 			}
 		}
 
-		FactionState &faction = factions.getFactionState(unitFactionIndex);
+		FactionState &faction = getSearchState(unitFactionIndex);
 
 		while(nodeLimitReached == false) {
 			whileLoopCount++;
 			if(faction.openNodesList.empty() == true) {
-				if(SystemFlags::getSystemSettingType(SystemFlags::debugWorldSynch).enabled == true &&
-						SystemFlags::getSystemSettingType(SystemFlags::debugWorldSynchMax).enabled == true) {
+				if(SystemFlags::isDebugEnabled(SystemFlags::debugWorldSynch) == true &&
+						SystemFlags::isDebugEnabled(SystemFlags::debugWorldSynchMax) == true) {
 					char szBuf[8096]="";
 					snprintf(szBuf,8096,"In doAStarPathSearch() nodeLimitReached %d whileLoopCount %d unitFactionIndex %d pathFound %d maxNodeCount %d",
 							nodeLimitReached,whileLoopCount,unitFactionIndex,pathFound, maxNodeCount);
@@ -369,8 +419,8 @@ private:
 			}
 			node = minHeuristicFastLookup(faction);
 
-			if(SystemFlags::getSystemSettingType(SystemFlags::debugWorldSynch).enabled == true &&
-					SystemFlags::getSystemSettingType(SystemFlags::debugWorldSynchMax).enabled == true) {
+			if(SystemFlags::isDebugEnabled(SystemFlags::debugWorldSynch) == true &&
+					SystemFlags::isDebugEnabled(SystemFlags::debugWorldSynchMax) == true) {
 				char szBuf[8096]="";
 				snprintf(szBuf,8096,"In doAStarPathSearch() nodeLimitReached %d whileLoopCount %d unitFactionIndex %d pathFound %d maxNodeCount %d node->pos = %s finalPos = %s node->exploredCell = %d",
 						nodeLimitReached,whileLoopCount,unitFactionIndex,pathFound, maxNodeCount,node->pos.getString().c_str(),finalPos.getString().c_str(),node->exploredCell);
@@ -388,11 +438,7 @@ private:
 				break;
 			}
 
-			if(faction.closedNodesList.find(node->heuristic) == faction.closedNodesList.end()) {
-				faction.closedNodesList[node->heuristic].clear();
-			}
-			faction.closedNodesList[node->heuristic].push_back(node);
-			faction.openPosList[node->pos] = true;
+			closeNode(faction, node);
 
 			int failureCount 	= 0;
 			int cellCount 		= 0;
@@ -407,8 +453,8 @@ private:
 			int tryDirection 	= faction.random.randRange(1, 4);
 			//int tryDirection 	= unit->getRandom(true)->randRange(1, 4);
 
-			if(SystemFlags::getSystemSettingType(SystemFlags::debugWorldSynch).enabled == true &&
-					SystemFlags::getSystemSettingType(SystemFlags::debugWorldSynchMax).enabled == true) {
+			if(SystemFlags::isDebugEnabled(SystemFlags::debugWorldSynch) == true &&
+					SystemFlags::isDebugEnabled(SystemFlags::debugWorldSynchMax) == true) {
 				char szBuf[8096]="";
 				snprintf(szBuf,8096,"In doAStarPathSearch() tryDirection %d",tryDirection);
 
@@ -462,8 +508,8 @@ private:
 			}
 		}
 
-		if(SystemFlags::getSystemSettingType(SystemFlags::debugWorldSynch).enabled == true &&
-				SystemFlags::getSystemSettingType(SystemFlags::debugWorldSynchMax).enabled == true) {
+		if(SystemFlags::isDebugEnabled(SystemFlags::debugWorldSynch) == true &&
+				SystemFlags::isDebugEnabled(SystemFlags::debugWorldSynchMax) == true) {
 			char szBuf[8096]="";
 			snprintf(szBuf,8096,"In doAStarPathSearch() nodeLimitReached %d whileLoopCount %d unitFactionIndex %d pathFound %d maxNodeCount %d",
 					nodeLimitReached,whileLoopCount,unitFactionIndex,pathFound, maxNodeCount);
@@ -0,0 +1,140 @@
+// ==============================================================
+//	This file is part of MegaGlest (www.megaglest.org)
+//
+//	Copyright (C) 2026 The MegaGlest Team
+//
+//	You can redistribute this code and/or modify it under
+//	the terms of the GNU General Public License as published
+//	by the Free Software Foundation; either version 2 of the
+//	License, or (at your option) any later version
+// ==============================================================
+
+#include "simulation_benchmark.h"
+
+#include <vector>
+#include "program.h"
+#include "game.h"
+#include "world.h"
+#include "faction.h"
+#include "commander.h"
+#include "checksum.h"
+#include "conversion.h"
+#include "zone_profiler.h"
+#include "util.h"
+#include "leak_dumper.h"
+
+using namespace Shared::Util;
+
+namespace Glest{ namespace Game{
+
+// =====================================================
+//	class SimulationBenchmark
+// =====================================================
+
+bool SimulationBenchmark::enabled			= false;
+bool SimulationBenchmark::finished			= false;
+string SimulationBenchmark::replayFile		= "";
+int SimulationBenchmark::maxFrames			= 0;
+bool SimulationBenchmark::hasExpectedCRC	= false;
+uint32 SimulationBenchmark::expectedCRC		= 0;
+int SimulationBenchmark::exitCode			= 0;
+
+uint32 SimulationBenchmark::getWorldCRC(World *world) {
+	Checksum crcForWorld;
+	crcForWorld.addInt(world->getFrameCount());
+	for(int i = 0; i < world->getFactionCount(); ++i) {
+		uint32 crc = world->getFaction(i)->getCRC().getSum();
+		crcForWorld.addBytes(&crc,sizeof(uint32));
+	}
+	return crcForWorld.getSum();
+}
+
+void SimulationBenchmark::run(Game *game) {
+	if(finished == true) {
+		return;
+	}
+	finished = true;
+
+	World *world = game->getWorld();
+	Commander *commander = game->getCommander();
+
+	int startFrame = world->getFrameCount();
+	int endFrame = (maxFrames > 0 ? startFrame + maxFrames : game->getLastWorldFrameCountForReplay());
+	if(endFrame <= startFrame) {
+		char szBuf[8096]="";
+		snprintf(szBuf,8096,"Nothing to benchmark in [%s], the replay ends at frame %d and the game starts at frame %d",replayFile.c_str(),endFrame,startFrame);
+		throw megaglest_runtime_error(szBuf);
+	}
+
+	printf("Benchmarking [%s] from frame %d to frame %d...\n",replayFile.c_str(),startFrame,endFrame);
+
+	// a capture the user started keeps running afterwards, but restarts
+	// here so the totals only cover the benchmark
+	bool profilerWasEnabled = ZoneProfiler::isEnabled();
+	ZoneProfiler::start();
+
+	int64 slowestFrameNanos = 0;
+	int slowestFrame = startFrame;
+	int64 startNanos = ZoneProfiler::getNanos();
+	while(world->getFrameCount() < endFrame) {
+		int64 frameStartNanos = ZoneProfiler::getNanos();
+
+		// the same steps the replay loop in Game::update takes per frame
+		world->update();
+		commander->signalNetworkUpdate(game);
+
+		int64 frameNanos = ZoneProfiler::getNanos() - frameStartNanos;
+		if(frameNanos > slowestFrameNanos) {
+			slowestFrameNanos = frameNanos;
+			slowestFrame = world->getFrameCount();
+		}
+	}
+	int64 totalNanos = ZoneProfiler::getNanos() - startNanos;
+
+	std::vector<ZoneProfiler::ZoneTotal> zoneTotals = ZoneProfiler::getZoneTotals();
+	if(profilerWasEnabled == false) {
+		ZoneProfiler::stop();
+	}
+
+	int frames = world->getFrameCount() - startFrame;
+	double totalMillis = totalNanos / 1000000.0;
+	printf("\n=============== Simulation benchmark ===============\n");
+	printf("Replay:        %s\n",replayFile.c_str());
+	printf("Frames:        %d\n",frames);
+	printf("Time:          %.3f msecs\n",totalMillis);
+	printf("Frames/sec:    %.2f\n",(totalNanos > 0 ? frames * 1000000000.0 / totalNanos : 0.0));
+	printf("Avg frame:     %.4f msecs\n",totalMillis / frames);
+	printf("Slowest frame: %.4f msecs (frame %d)\n",slowestFrameNanos / 1000000.0,slowestFrame);
+
+	printf("\n%-40s %10s %14s %12s %7s\n","Zone","Calls","Total msecs","Per frame","%");
+	for(unsigned int i = 0; i < zoneTotals.size(); ++i) {
+		const ZoneProfiler::ZoneTotal &total = zoneTotals[i];
+		double zoneMillis = total.nanos / 1000000.0;
+		printf("%-40s %10u %14.3f %12.4f %6.1f%%\n",
+				total.zone->name,total.calls,zoneMillis,zoneMillis / frames,
+				(totalNanos > 0 ? total.nanos * 100.0 / totalNanos : 0.0));
+	}
+
+	printf("\nUnit precache: %s\n",(world->getTaskPool() != NULL ? "task pool" : "faction threads"));
+	for(int i = 0; i < world->getFactionCount(); ++i) {
+		printf("Faction %d CRC: %u\n",i,world->getFaction(i)->getCRC().getSum());
+	}
+	uint32 worldCRC = getWorldCRC(world);
+	printf("World CRC:     %u\n",worldCRC);
+	if(hasExpectedCRC == true) {
+		if(worldCRC == expectedCRC) {
+			printf("World CRC matches the expected value\n");
+		}
+		else {
+			printf("**ERROR** World CRC does not match the expected value [%u], the simulation is not deterministic!\n",expectedCRC);
+			exitCode = 1;
+		}
+	}
+	printf("====================================================\n\n");
+
+	if(SystemFlags::VERBOSE_MODE_ENABLED) printf("In [%s::%s Line: %d] benchmark done, exitCode = %d\n",extractFileFromDirectoryPath(__FILE__).c_str(),__FUNCTION__,__LINE__,exitCode);
+
+	game->getProgram()->setShutdownApplicationEnabled(true);
+}
+
+}}//end namespace
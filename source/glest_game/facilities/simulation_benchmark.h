@@ -0,0 +1,72 @@
+// ==============================================================
+//	This file is part of MegaGlest (www.megaglest.org)
+//
+//	Copyright (C) 2026 The MegaGlest Team
+//
+//	You can redistribute this code and/or modify it under
+//	the terms of the GNU General Public License as published
+//	by the Free Software Foundation; either version 2 of the
+//	License, or (at your option) any later version
+// ==============================================================
+
+#ifndef _GLEST_GAME_SIMULATIONBENCHMARK_H_
+#define _GLEST_GAME_SIMULATIONBENCHMARK_H_
+
+#ifdef WIN32
+    #include <winsock2.h>
+    #include <winsock.h>
+#endif
+
+#include <string>
+#include "data_types.h"
+#include "leak_dumper.h"
+
+using namespace std;
+using Shared::Platform::uint32;
+
+namespace Glest{ namespace Game{
+
+class Game;
+class World;
+
+// =====================================================
+//	class SimulationBenchmark
+//
+/// Replays the commands saved with SaveCommandsForReplay as fast as
+/// the simulation allows, without AI, gui, particles or rendering,
+/// and reports the speed, where the time went and a checksum of the
+/// final world so runs of two builds can be compared
+// =====================================================
+
+class SimulationBenchmark {
+private:
+	static bool enabled;
+	static bool finished;
+	static string replayFile;
+	static int maxFrames;
+	static bool hasExpectedCRC;
+	static uint32 expectedCRC;
+	static int exitCode;
+
+public:
+	static bool isEnabled()								{ return enabled; }
+	static void setEnabled(bool value)					{ enabled = value; }
+	static string getReplayFile()						{ return replayFile; }
+	static void setReplayFile(const string &value)		{ replayFile = value; }
+	// 0 runs up to the last frame recorded in the replay
+	static void setMaxFrames(int value)					{ maxFrames = value; }
+	static void setExpectedCRC(uint32 value)			{ expectedCRC = value; hasExpectedCRC = true; }
+	// Non zero when the final world checksum was not the expected one
+	static int getExitCode()							{ return exitCode; }
+
+	// Checksum of every faction's resources and units plus the frame count
+	static uint32 getWorldCRC(World *world);
+
+	// Called instead of the normal game update, runs the whole benchmark
+	// once and then asks the program to shut down
+	static void run(Game *game);
+};
+
+}}//end namespace
+
+#endif
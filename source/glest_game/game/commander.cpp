@@ -24,6 +24,7 @@
 #include "game.h"
 #include "game_settings.h"
 #include "game.h"
+#include "zone_profiler.h"
 
 using namespace Shared::Graphics;
 using namespace Shared::Util;
@@ -424,6 +425,11 @@ void Commander::tryResumeGame(bool joinNetworkGame, bool clearCaches) const {
 	pushNetworkCommand(&command);
 }
 
+void Commander::tryJoinGameSnapshot(int joiningFactionMask) const {
+	NetworkCommand command(this->world,nctJoinGameSnapshot,joiningFactionMask);
+	pushNetworkCommand(&command);
+}
+
 void Commander::tryNetworkPlayerDisconnected(int factionIndex) const {
 	//printf("tryNetworkPlayerDisconnected factionIndex: %d\n",factionIndex);
 
@@ -465,7 +471,8 @@ std::pair<CommandResult,string> Commander::pushNetworkCommand(const NetworkComma
 		networkCommand->getNetworkCommandType() != nctSwitchTeamVote &&
 		networkCommand->getNetworkCommandType() != nctPauseResume &&
 		networkCommand->getNetworkCommandType() != nctPlayerStatusChange &&
-		networkCommand->getNetworkCommandType() != nctDisconnectNetworkPlayer) {
+		networkCommand->getNetworkCommandType() != nctDisconnectNetworkPlayer &&
+		networkCommand->getNetworkCommandType() != nctJoinGameSnapshot) {
 		unit= world->findUnitById(networkCommand->getUnitId());
 		if(unit == NULL) {
 			char szBuf[8096]="";
@@ -494,6 +501,7 @@ std::pair<CommandResult,string> Commander::pushNetworkCommand(const NetworkComma
 }
 
 void Commander::signalNetworkUpdate(Game *game) {
+	PROFILE_ZONE("Commander::signalNetworkUpdate");
     updateNetwork(game);
 }
 
@@ -823,6 +831,20 @@ void Commander::giveNetworkCommand(NetworkCommand* networkCommand) const {
         	}
             break;
 
+        case nctJoinGameSnapshot:
+        	{
+        	if(SystemFlags::getSystemSettingType(SystemFlags::debugSystem).enabled) SystemFlags::OutputDebug(SystemFlags::debugSystem,"In [%s::%s Line: %d] found nctJoinGameSnapshot\n",extractFileFromDirectoryPath(__FILE__).c_str(),__FUNCTION__,__LINE__);
+
+        	commandWasHandled = true;
+
+        	// Every machine reaches this at the same frame and hands the joining
+        	// factions over from the AI here, the snapshot itself is taken once
+        	// the rest of this keyframe's commands are applied
+        	Game *game = this->world->getGame();
+        	game->startJoinGameSnapshot(networkCommand->getUnitId());
+        	}
+            break;
+
         case nctPlayerStatusChange:
 			{
 			if(SystemFlags::getSystemSettingType(SystemFlags::debugSystem).enabled) SystemFlags::OutputDebug(SystemFlags::debugSystem,"In [%s::%s Line: %d] found nctPlayerStatusChange\n",extractFileFromDirectoryPath(__FILE__).c_str(),__FUNCTION__,__LINE__);
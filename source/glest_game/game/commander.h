@@ -89,6 +89,8 @@ public:
 
 	void tryPauseGame(bool joinNetworkGame, bool clearCaches) const;
 	void tryResumeGame(bool joinNetworkGame, bool clearCaches) const;
+	// bit i of joiningFactionMask is set for every faction a client joins as
+	void tryJoinGameSnapshot(int joiningFactionMask) const;
 
 	void tryNetworkPlayerDisconnected(int factionIndex) const;
 
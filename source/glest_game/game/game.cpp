@@ -23,6 +23,8 @@
 #include "network_manager.h"
 #include "checksum.h"
 #include "auto_test.h"
+#include "simulation_benchmark.h"
+#include "save_game_writer.h"
 #include "menu_state_keysetup.h"
 #include "video_player.h"
 #include "compression_utils.h"
@@ -30,6 +32,8 @@
 #include "conversion.h"
 #include "steam.h"
 #include "memory.h"
+#include "interpolation.h"
+#include "zone_profiler.h"
 
 #include "leak_dumper.h"
 
@@ -72,6 +76,7 @@ Game::Game() : ProgramState(NULL) {
 	aiInterfaces.clear();
 	videoPlayer = NULL;
 	playingStaticVideo = false;
+	saveGameWriter = NULL;
 
 	mouse2d=0;
 	mouseX=0;
@@ -125,6 +130,9 @@ Game::Game() : ProgramState(NULL) {
 	program=NULL;
 	gameStarted=false;
 	this->initialResumeSpeedLoops=false;
+	joinGameSnapshotRequested=false;
+	joinGameSnapshotRequestSent=false;
+	joinGameCatchUp=false;
 
 	highlightCellTexture=NULL;
 	lastMasterServerGameStatsDump=0;
@@ -188,6 +196,9 @@ void Game::resetMembers() {
 	Unit::setGame(this);
 	gameStarted = false;
 	this->initialResumeSpeedLoops = false;
+	joinGameSnapshotRequested = false;
+	joinGameSnapshotRequestSent = false;
+	joinGameCatchUp = false;
 
 	original_updateFps = GameConstants::updateFps;
 	original_cameraFps = GameConstants::cameraFps;
@@ -319,6 +330,7 @@ Game::Game(Program *program, const GameSettings *gameSettings,bool masterserverM
 	this->masterserverMode = masterserverMode;
 	videoPlayer = NULL;
 	playingStaticVideo = false;
+	saveGameWriter = NULL;
 	highlightCellTexture = NULL;
 	playerIndexDisconnect=0;
 	updateFpsAvgTest=0;
@@ -413,6 +425,8 @@ Game::~Game() {
 	if(SystemFlags::getSystemSettingType(SystemFlags::debugSystem).enabled) SystemFlags::OutputDebug(SystemFlags::debugSystem,"In [%s::%s Line: %d]\n",extractFileFromDirectoryPath(__FILE__).c_str(),__FUNCTION__,__LINE__);
 
 	quitGame();
+	// saves still being written must reach the disk before the game goes
+	endSaveGameWriter();
 
 	Object::setStateCallback(NULL);
 	thisGamePtr = NULL;
@@ -1779,11 +1793,19 @@ void Game::processNetworkSynchChecksIfRequired() {
 
 //update
 void Game::update() {
+	if(SimulationBenchmark::isEnabled() == true) {
+		SimulationBenchmark::run(this);
+		return;
+	}
+
+	PROFILE_ZONE("Game::update");
 	try {
 		if(currentUIState != NULL) {
 			currentUIState->update();
 		}
 
+		checkSaveGameResults();
+
 		bool showPerfStats = Config::getInstance().getBool("ShowPerfStats","false");
 		Chrono chronoPerf;
 		char perfBuf[8096]="";
@@ -1868,7 +1890,8 @@ void Game::update() {
 		chronoGamePerformanceCounts.start();
 		bool enableServerControlledAI 	= this->gameSettings.getEnableServerControlledAI();
 
-		if(role == nrClient && updateLoops == 1 && world.getFrameCount() >= (gameSettings.getNetworkFramePeriod() * 2) ) {
+		if(role == nrClient && updateLoops == 1 && joinGameCatchUp == false &&
+			world.getFrameCount() >= (gameSettings.getNetworkFramePeriod() * 2) ) {
 			ClientInterface *clientInterface = dynamic_cast<ClientInterface *>(networkManager.getClientInterface());
 			if(clientInterface != NULL) {
 				uint64 lastNetworkFrameFromServer = clientInterface->getCachedLastPendingFrameCount();
@@ -1975,6 +1998,29 @@ void Game::update() {
 			}
 		}
 
+		// A client that joined from a snapshot runs through the command lists
+		// the server held back for it as fast as it can until it catches up
+		if(joinGameCatchUp == true && updateLoops > 0) {
+			ClientInterface *clientInterface = dynamic_cast<ClientInterface *>(networkManager.getClientInterface());
+			if(clientInterface != NULL) {
+				int lastNetworkFrameFromServer = (int)clientInterface->getCachedLastPendingFrameCount();
+				int framesBehind = lastNetworkFrameFromServer - world.getFrameCount();
+				if(framesBehind > gameSettings.getNetworkFramePeriod()) {
+					int maxCatchUpLoops = Config::getInstance().getInt("JoinInProgressCatchUpFramesPerUpdate","200");
+					int catchUpLoops = (framesBehind < maxCatchUpLoops ? framesBehind : maxCatchUpLoops);
+					if(catchUpLoops > updateLoops) {
+						updateLoops = catchUpLoops;
+					}
+				}
+				else if(lastNetworkFrameFromServer > 0) {
+					joinGameCatchUp = false;
+					framesToCatchUpAsClient = 0;
+					framesToSlowDownAsClient = 0;
+					if(SystemFlags::VERBOSE_MODE_ENABLED) printf("Join game catch up finished at frame: %d\n",world.getFrameCount());
+				}
+			}
+		}
+
 		addPerformanceCount("CalculateNetworkUpdateLoops",chronoGamePerformanceCounts.getMillis());
 
 		if(SystemFlags::getSystemSettingType(SystemFlags::debugPerformance).enabled && chrono.getMillis() > 0) SystemFlags::OutputDebug(SystemFlags::debugPerformance,"In [%s::%s] Line: %d took msecs: %lld\n",extractFileFromDirectoryPath(__FILE__).c_str(),__FUNCTION__,__LINE__,chrono.getMillis());
@@ -2020,11 +2066,23 @@ void Game::update() {
 				chronoReplay.start();
 			}
 
+			// catching up after a join may not hold up rendering for long
+			Chrono chronoJoinGameCatchUp;
+			int64 joinGameCatchUpMillis = 0;
+			if(joinGameCatchUp == true) {
+				joinGameCatchUpMillis = Config::getInstance().getInt("JoinInProgressCatchUpMillis","20");
+				chronoJoinGameCatchUp.start();
+			}
+
 			do {
 				if(replayTotal > 0) {
 					replayCommandsPlayed = (replayTotal - commander.getReplayCommandListForFrameCount());
 				}
 				for(int i = 0; i < updateLoops; ++i) {
+					if(joinGameCatchUp == true && i > 0 &&
+						chronoJoinGameCatchUp.getMillis() >= joinGameCatchUpMillis) {
+						break;
+					}
 					//if(SystemFlags::getSystemSettingType(SystemFlags::debugPerformance).enabled) chrono.start();
 					if(showPerfStats) {
 						sprintf(perfBuf,"In [%s::%s] Line: %d took msecs: " MG_I64_SPECIFIER "\n",extractFileFromDirectoryPath(__FILE__).c_str(),__FUNCTION__,__LINE__,chronoPerf.getMillis());
@@ -2039,6 +2097,9 @@ void Game::update() {
 
 						addPerformanceCount("CalculateNetworkCRCSynchChecks",chronoGamePerformanceCounts.getMillis());
 
+						// AI threads read the cluster layers without locking
+						world.getMap()->getClusterMap()->refreshLayers();
+
 						const bool newThreadManager = Config::getInstance().getBool("EnableNewThreadManager","false");
 						if(newThreadManager == true) {
 							int currentFrameCount = world.getFrameCount();
@@ -2207,10 +2268,18 @@ void Game::update() {
 
 					if(pendingQuitError == false) {
 						commander.signalNetworkUpdate(this);
+						processJoinGameSnapshotRequest();
 					}
 
 					addPerformanceCount("ProcessNetworkUpdate",chronoGamePerformanceCounts.getMillis());
 
+					if(role == nrServer) {
+						ServerInterface *server = NetworkManager::getInstance().getServerInterface(false);
+						if(server != NULL) {
+							addPerformanceCount("ProcessNetworkUpdate slot thread wait",server->getSlotThreadWaitMillis());
+						}
+					}
+
 					if(showPerfStats) {
 						sprintf(perfBuf,"In [%s::%s] Line: %d took msecs: " MG_I64_SPECIFIER "\n",extractFileFromDirectoryPath(__FILE__).c_str(),__FUNCTION__,__LINE__,chronoPerf.getMillis());
 						perfList.push_back(perfBuf);
@@ -2251,7 +2320,7 @@ void Game::update() {
 
 					chronoGamePerformanceCounts.start();
 
-					renderer.updateParticleManager(rsGame,avgRenderFps);
+					renderer.updateParticleManager(rsGame,avgRenderFps,world.getTaskPool());
 
 					addPerformanceCount("ProcessParticleManager",chronoGamePerformanceCounts.getMillis());
 
@@ -2272,6 +2341,7 @@ void Game::update() {
 		else {
 			if(pendingQuitError == false) {
 				commander.signalNetworkUpdate(this);
+				processJoinGameSnapshotRequest();
 			}
 
 			if(playingStaticVideo == true) {
@@ -2418,6 +2488,10 @@ void Game::update() {
 
 				//Lang &lang= Lang::getInstance();
 				bool pauseAndSaveGameForNewClient = false;
+				// the snapshot path is off until it has been run on a real
+				// two machine join and the faction CRCs compared after catch up
+				const bool useSavedGameDownload = Config::getInstance().getBool("JoinInProgressUseSavedGameDownload","true");
+				int joiningFactionMask = 0;
 				for(int i = 0; i < world.getFactionCount(); ++i) {
 					Faction *faction = world.getFaction(i);
 
@@ -2441,14 +2515,21 @@ void Game::update() {
 							this->gameSettings.setNetworkPlayerStatuses(i,npst_None);
 						}
 
-						//printf("START Purging AI player for index: %d\n",i);
-						masterController.clearSlaves(true);
-						delete aiInterfaces[i];
-						aiInterfaces[i] = NULL;
-						//printf("END Purging AI player for index: %d\n",i);
+						// the snapshot command hands the faction over on every
+						// machine at the same frame, see startJoinGameSnapshot
+						if(useSavedGameDownload == true) {
+							//printf("START Purging AI player for index: %d\n",i);
+							masterController.clearSlaves(true);
+							delete aiInterfaces[i];
+							aiInterfaces[i] = NULL;
+							//printf("END Purging AI player for index: %d\n",i);
 
-						Faction *faction = world.getFaction(i);
-						faction->setControlType(ctNetwork);
+							Faction *faction = world.getFaction(i);
+							faction->setControlType(ctNetwork);
+						}
+						else {
+							joiningFactionMask |= (1 << i);
+						}
 						//pauseAndSaveGameForNewClient = true;
 					}
 					else if((slot == NULL || slot->isConnected() == false) &&
@@ -2465,13 +2546,22 @@ void Game::update() {
 					}
 				}
 
-				if(pauseAndSaveGameForNewClient == true && pausedForJoinGame == false &&
-						pauseRequestSent == false) {
-					//printf("Pausing game for join in progress game...\n");
+				if(pauseAndSaveGameForNewClient == true) {
+					if(useSavedGameDownload == true) {
+						if(pausedForJoinGame == false && pauseRequestSent == false) {
+							//printf("Pausing game for join in progress game...\n");
 
-					commander.tryPauseGame(true,true);
-					pauseRequestSent = true;
-					return;
+							commander.tryPauseGame(true,true);
+							pauseRequestSent = true;
+							return;
+						}
+					}
+					else if(joinGameSnapshotRequestSent == false) {
+						// the snapshot is taken when this command comes back, the
+						// game keeps running while the new client loads it
+						commander.tryJoinGameSnapshot(joiningFactionMask);
+						joinGameSnapshotRequestSent = true;
+					}
 				}
 			}
 			//else if(server->getPauseForInGameConnection() == true && paused == true &&
@@ -2522,7 +2612,8 @@ void Game::update() {
 					if(saveNetworkGame == true) {
 						//printf("Saved network game to disk\n");
 
-						string file = this->saveGame(GameConstants::saveNetworkGameFileServer,"temp/");
+						// compressed and sent right away, so it must be on disk
+						string file = this->saveGame(GameConstants::saveNetworkGameFileServer,"temp/",false);
 
 						string saveGameFilePath = "temp/";
 						string saveGameFileCompressed = saveGameFilePath + string(GameConstants::saveNetworkGameFileServerCompressed);
@@ -3205,6 +3296,7 @@ void Game::updateCamera(){
 
 //render
 void Game::render() {
+	PROFILE_ZONE("Game::render");
 	// Ensure the camera starts in the right position
 	if(isFirstRender == true) {
 		isFirstRender = false;
@@ -5174,6 +5266,14 @@ void Game::DumpCRCWorldLogIfRequired(string fileSuffix) {
 			}
 		#endif
 
+			// the binary snapshots, for comparing with the other side's offline
+			vector<const SynchSnapshotRing *> snapshotRings;
+			for(int i = 0; i < world.getFactionCount(); ++i) {
+				snapshotRings.push_back(&world.getFaction(i)->getCRC_WorldFrameSnapshots());
+			}
+			string debugCRCWorldSnapshotFile = debugCRCWorldLogFile + ".snapshot";
+			printf("Save to log debugCRCWorldSnapshotFile = %s\n",debugCRCWorldSnapshotFile.c_str());
+			SynchSnapshotFile::save(debugCRCWorldSnapshotFile,snapshotRings);
 		}
 	}
 }
@@ -5548,9 +5648,8 @@ string Game::getDebugStats(std::map<int,string> &factionDebugInfo) {
 		str+= "Log buffer count: " + intToStr(SystemFlags::getLogEntryBufferCount())+"\n";
 	}
 
-	str+= "UnitRangeCellsLookupItemCache: " + world.getUnitUpdater()->getUnitRangeCellsLookupItemCacheStats()+"\n";
-	str+= "ExploredCellsLookupItemCache: " 	+ world.getExploredCellsLookupItemCacheStats()+"\n";
-	str+= "FowAlphaCellsLookupItemCache: "  + world.getFowAlphaCellsLookupItemCacheStats()+"\n";
+	str+= "UnitGrid: " + world.getMap()->getUnitGrid()->getStats()+"\n";
+	str+= "SightStencils: " 	+ world.getSightStencilStats()+"\n";
 
 	const string selectionType = toLower(Config::getInstance().getString("SelectionType",Config::colorPicking));
 	str += "Selection type: " + toLower(selectionType) + "\n";
@@ -5570,9 +5669,11 @@ string Game::getDebugStats(std::map<int,string> &factionDebugInfo) {
 		Renderer &renderer= Renderer::getInstance();
 		str+= "Triangle count: " + intToStr(renderer.getTriangleCount())+"\n";
 		str+= "Vertex count: "   + intToStr(renderer.getPointCount())+"\n";
+		str+= "Animation frame cache: " + InterpolationData::getFrameCacheStats()+"\n";
 	}
 
 	str+= "Frame count:"     + intToStr(world.getFrameCount())+"\n";
+	str+= "Profiler: "       + ZoneProfiler::getStats()+"\n";
 
 	//visible quad
 	if(this->masterserverMode == false) {
@@ -6324,12 +6425,7 @@ void Game::setPaused(bool value,bool forceAllowPauseStateChange,bool clearCaches
 				if(SystemFlags::getSystemSettingType(SystemFlags::debugWorldSynch).enabled) SystemFlags::OutputDebug(SystemFlags::debugWorldSynch,"game.cpp line: %d Clear Caches for resume in progress game\n",__LINE__);
 				//printf("Line: %d Clear Caches for resume in progress game\n",__LINE__);
 
-				world.clearCaches();
-				for(int i = 0; i < world.getFactionCount(); ++i) {
-					Faction *faction = world.getFaction(i);
-					faction->clearCaches();
-				}
-				world.refreshAllUnitExplorations();
+				clearCachesForJoinGame();
 			}
 			setupPopupMenus(false);
 
@@ -6354,12 +6450,7 @@ void Game::setPaused(bool value,bool forceAllowPauseStateChange,bool clearCaches
 				//printf("Line: %d Clear Caches for resume in progress game\n",__LINE__);
 				if(SystemFlags::getSystemSettingType(SystemFlags::debugWorldSynch).enabled) SystemFlags::OutputDebug(SystemFlags::debugWorldSynch,"game.cpp line: %d Clear Caches for resume in progress game\n",__LINE__);
 
-				world.clearCaches();
-				for(int i = 0; i < world.getFactionCount(); ++i) {
-					Faction *faction = world.getFaction(i);
-					faction->clearCaches();
-				}
-				world.refreshAllUnitExplorations();
+				clearCachesForJoinGame();
 			}
 			pauseRequestSent=false;
 
@@ -6369,6 +6460,75 @@ void Game::setPaused(bool value,bool forceAllowPauseStateChange,bool clearCaches
 	}
 }
 
+void Game::clearCachesForJoinGame() {
+	world.clearCaches();
+	for(int i = 0; i < world.getFactionCount(); ++i) {
+		Faction *faction = world.getFaction(i);
+		faction->clearCaches();
+	}
+	world.refreshAllUnitExplorations();
+}
+
+// Run by every machine when the snapshot command is executed, so the
+// joining factions stop being AI controlled at the same frame everywhere
+void Game::startJoinGameSnapshot(int joiningFactionMask) {
+	for(int i = 0; i < world.getFactionCount() && i < GameConstants::maxPlayers; ++i) {
+		if((joiningFactionMask & (1 << i)) == 0) {
+			continue;
+		}
+		if(i < (int)aiInterfaces.size() && aiInterfaces[i] != NULL) {
+			masterController.clearSlaves(true);
+			delete aiInterfaces[i];
+			aiInterfaces[i] = NULL;
+		}
+
+		Faction *faction = world.getFaction(i);
+		faction->setControlType(ctNetwork);
+	}
+	joinGameSnapshotRequested = true;
+}
+
+void Game::processJoinGameSnapshotRequest() {
+	if(joinGameSnapshotRequested == false) {
+		return;
+	}
+	joinGameSnapshotRequested = false;
+
+	// Every machine drops its caches at this frame, so the joining client
+	// that starts out with empty ones computes what everyone else does
+	if(SystemFlags::getSystemSettingType(SystemFlags::debugWorldSynch).enabled) SystemFlags::OutputDebug(SystemFlags::debugWorldSynch,"game.cpp line: %d Clear Caches for join game snapshot frame: %d\n",__LINE__,world.getFrameCount());
+	clearCachesForJoinGame();
+
+	NetworkManager &networkManager= NetworkManager::getInstance();
+	if(networkManager.getNetworkRole() != nrServer) {
+		return;
+	}
+	joinGameSnapshotRequestSent = false;
+
+	ServerInterface *server = networkManager.getServerInterface();
+	vector<int> playerIndexes;
+	for(int i = 0; i < world.getFactionCount(); ++i) {
+		Faction *faction = world.getFaction(i);
+
+		MutexSafeWrapper safeMutex(server->getSlotMutex(faction->getStartLocationIndex()),CODE_AT_LINE);
+		ConnectionSlot *slot =  server->getSlot(faction->getStartLocationIndex(),false);
+		if(slot != NULL && slot->getJoinGameInProgress() == true &&
+			slot->getStartInGameConnectionLaunch() == true &&
+			slot->getSentSavedGameInfo() == false) {
+			slot->setStartInGameConnectionLaunch(false);
+			slot->setSentSavedGameInfo(true);
+			// command lists from here on are held back for the new client
+			slot->startJoinGameSnapshot();
+			playerIndexes.push_back(faction->getStartLocationIndex());
+		}
+	}
+
+	if(playerIndexes.empty() == false) {
+		PROFILE_ZONE("Game::buildJoinGameSnapshot");
+		server->sendJoinGameSnapshot(buildSaveGameTree(), world.getFrameCount(), playerIndexes);
+	}
+}
+
 bool Game::getPaused()
 {
 	bool speedChangesAllowed= !NetworkManager::getInstance().isNetworkGame();
@@ -6611,95 +6771,84 @@ bool Game::clientLagHandler(int slotIndex,bool networkPauseGameForLaggedClients)
 }
 
 void Game::saveGame(){
-	string file = this->saveGame(GameConstants::saveGameFilePattern);
-	char szBuf[8096]="";
-	Lang &lang= Lang::getInstance();
-	snprintf(szBuf,8096,lang.getString("GameSaved","",true).c_str(),file.c_str());
-	console.addLine(szBuf);
-
-	Config &config= Config::getInstance();
-	config.setString("LastSavedGame",file);
-	config.save();
+	// the player is told, and LastSavedGame set, once the file is written
+	this->saveGame(GameConstants::saveGameFilePattern, "saved/", true, true);
 }
 
-string Game::saveGame(string name, const string &path) {
-	Config &config= Config::getInstance();
-	// auto name file if using saved file pattern string
-	if(name == GameConstants::saveGameFilePattern) {
-		//time_t curTime = time(NULL);
-	    //struct tm *loctime = localtime (&curTime);
-		struct tm loctime = threadsafe_localtime(systemtime_now());
-	    char szBuf2[100]="";
-	    strftime(szBuf2,100,"%Y%m%d_%H%M%S",&loctime);
-
-		char szBuf[8096]="";
-		snprintf(szBuf,8096,name.c_str(),szBuf2);
-		name = szBuf;
-	}
-	else if(name == GameConstants::saveGameFileAutoTestDefault) {
-		//time_t curTime = time(NULL);
-	    //struct tm *loctime = localtime (&curTime);
-		struct tm loctime = threadsafe_localtime(systemtime_now());
-	    char szBuf2[100]="";
-	    strftime(szBuf2,100,"%Y%m%d_%H%M%S",&loctime);
-
-		char szBuf[8096]="";
-		snprintf(szBuf,8096,name.c_str(),szBuf2);
-		name = szBuf;
-	}
+void Game::reportSaveGameResult(const string &file, bool saved, const string &error) {
+	char szBuf[8096]="";
+	Lang &lang= Lang::getInstance();
+	if(saved == true) {
+		snprintf(szBuf,8096,lang.getString("GameSaved","",true).c_str(),file.c_str());
+		console.addLine(szBuf);
 
-	// Save the file now
-	string saveGameFile = path + name;
-	if(getGameReadWritePath(GameConstants::path_logs_CacheLookupKey) != "") {
-		saveGameFile = getGameReadWritePath(GameConstants::path_logs_CacheLookupKey) + saveGameFile;
+		Config &config= Config::getInstance();
+		config.setString("LastSavedGame",file);
+		config.save();
 	}
 	else {
-        string userData = config.getString("UserData_Root","");
-        if(userData != "") {
-        	endPathWithSlash(userData);
-        }
-        saveGameFile = userData + saveGameFile;
+		string msg = "Error saving game [%s]: %s";
+		if(lang.hasString("GameSaveFailed","",true)) {
+			msg = lang.getString("GameSaveFailed","",true);
+		}
+		snprintf(szBuf,8096,msg.c_str(),file.c_str(),error.c_str());
+		console.addLine(szBuf);
 	}
-	if(SystemFlags::VERBOSE_MODE_ENABLED) printf("Saving game to [%s]\n",saveGameFile.c_str());
-
-	// This condition will re-play all the commands from a replay file
-	// INSTEAD of saving from a saved game.
-	if(config.getBool("SaveCommandsForReplay","false") == true) {
-		std::map<string,string> mapTagReplacements;
-		XmlTree xmlTreeSaveGame(XML_RAPIDXML_ENGINE);
-
-		xmlTreeSaveGame.init("megaglest-saved-game");
-		XmlNode *rootNodeReplay = xmlTreeSaveGame.getRootNode();
-
-		//std::map<string,string> mapTagReplacements;
-		//time_t now = time(NULL);
-		//struct tm *loctime = localtime (&now);
-		struct tm loctime = threadsafe_localtime(systemtime_now());
-		char szBuf[4096]="";
-		strftime(szBuf,4095,"%Y-%m-%d %H:%M:%S",&loctime);
-
-		rootNodeReplay->addAttribute("version",glestVersionString, mapTagReplacements);
-		rootNodeReplay->addAttribute("timestamp",szBuf, mapTagReplacements);
+}
 
-		XmlNode *gameNodeReplay = rootNodeReplay->addChild("Game");
-		gameSettings.saveGame(gameNodeReplay);
+void Game::checkSaveGameResults() {
+	if(saveGameWriter != NULL) {
+		SaveGameWriter::Result result;
+		for(;saveGameWriter->popResult(result) == true;) {
+			reportSaveGameResult(result.path, result.saved, result.error);
+		}
+	}
+}
 
-		gameNodeReplay->addAttribute("LastWorldFrameCount",intToStr(world.getFrameCount()), mapTagReplacements);
+void Game::endSaveGameWriter() {
+	if(saveGameWriter != NULL) {
+		saveGameWriter->waitUntilIdle();
+		checkSaveGameResults();
+		saveGameWriter->signalQuit();
+		if(saveGameWriter->shutdownAndWait() == true) {
+			delete saveGameWriter;
+		}
+		saveGameWriter = NULL;
+	}
+}
 
-		for(unsigned int i = 0; i < replayCommandList.size(); ++i) {
-			std::pair<int,NetworkCommand> &cmd = replayCommandList[i];
-			XmlNode *networkCommandNode = cmd.second.saveGame(gameNodeReplay);
-			networkCommandNode->addAttribute("worldFrameCount",intToStr(cmd.first), mapTagReplacements);
+void Game::writeSaveGame(XmlTree *xmlTree, const string &path, bool binary, bool debugXml, bool writeInBackground, bool reportResult) {
+	if(writeInBackground == false) {
+		auto_ptr<XmlTree> xmlTreeOwner(xmlTree);
+		if(reportResult == false) {
+			SaveGameWriter::write(xmlTree, path, binary, debugXml);
+			return;
+		}
+		try {
+			SaveGameWriter::write(xmlTree, path, binary, debugXml);
 		}
+		catch(const exception &ex) {
+			SystemFlags::OutputDebug(SystemFlags::debugError,"In [%s::%s Line: %d] Error writing saved game [%s]: %s\n",__FILE__,__FUNCTION__,__LINE__,path.c_str(),ex.what());
+			reportSaveGameResult(path, false, ex.what());
+			return;
+		}
+		reportSaveGameResult(path, true, "");
+		return;
+	}
 
-		string replayFile = saveGameFile + ".replay";
-		if(SystemFlags::VERBOSE_MODE_ENABLED) printf("Saving game replay commands to [%s]\n",replayFile.c_str());
-		xmlTreeSaveGame.save(replayFile);
+	if(saveGameWriter == NULL) {
+		static string mutexOwnerId = string(extractFileFromDirectoryPath(__FILE__).c_str()) + string("_") + intToStr(__LINE__);
+		saveGameWriter = new SaveGameWriter();
+		saveGameWriter->setUniqueID(mutexOwnerId);
+		saveGameWriter->start();
 	}
+	saveGameWriter->queue(xmlTree, path, binary, debugXml, reportResult);
+}
 
-	XmlTree xmlTree;
-	xmlTree.init("megaglest-saved-game");
-	XmlNode *rootNode = xmlTree.getRootNode();
+XmlTree * Game::buildSaveGameTree() {
+	auto_ptr<XmlTree> xmlTree(new XmlTree());
+	xmlTree->init("megaglest-saved-game");
+	XmlNode *rootNode = xmlTree->getRootNode();
 
 	std::map<string,string> mapTagReplacements;
 	//time_t now = time(NULL);
@@ -6857,7 +7006,88 @@ string Game::saveGame(string name, const string &path) {
 
 	gameNode->addAttribute("disableSpeedChange",intToStr(disableSpeedChange), mapTagReplacements);
 
-	xmlTree.save(saveGameFile);
+	return xmlTree.release();
+}
+
+string Game::saveGame(string name, const string &path, bool writeInBackground, bool reportResult) {
+	Config &config= Config::getInstance();
+	// auto name file if using saved file pattern string
+	if(name == GameConstants::saveGameFilePattern) {
+		//time_t curTime = time(NULL);
+	    //struct tm *loctime = localtime (&curTime);
+		struct tm loctime = threadsafe_localtime(systemtime_now());
+	    char szBuf2[100]="";
+	    strftime(szBuf2,100,"%Y%m%d_%H%M%S",&loctime);
+
+		char szBuf[8096]="";
+		snprintf(szBuf,8096,name.c_str(),szBuf2);
+		name = szBuf;
+	}
+	else if(name == GameConstants::saveGameFileAutoTestDefault) {
+		//time_t curTime = time(NULL);
+	    //struct tm *loctime = localtime (&curTime);
+		struct tm loctime = threadsafe_localtime(systemtime_now());
+	    char szBuf2[100]="";
+	    strftime(szBuf2,100,"%Y%m%d_%H%M%S",&loctime);
+
+		char szBuf[8096]="";
+		snprintf(szBuf,8096,name.c_str(),szBuf2);
+		name = szBuf;
+	}
+
+	// Save the file now
+	string saveGameFile = path + name;
+	if(getGameReadWritePath(GameConstants::path_logs_CacheLookupKey) != "") {
+		saveGameFile = getGameReadWritePath(GameConstants::path_logs_CacheLookupKey) + saveGameFile;
+	}
+	else {
+        string userData = config.getString("UserData_Root","");
+        if(userData != "") {
+        	endPathWithSlash(userData);
+        }
+        saveGameFile = userData + saveGameFile;
+	}
+	if(SystemFlags::VERBOSE_MODE_ENABLED) printf("Saving game to [%s]\n",saveGameFile.c_str());
+
+	// This condition will re-play all the commands from a replay file
+	// INSTEAD of saving from a saved game.
+	if(config.getBool("SaveCommandsForReplay","false") == true) {
+		std::map<string,string> mapTagReplacements;
+		auto_ptr<XmlTree> xmlTreeSaveGame(new XmlTree(XML_RAPIDXML_ENGINE));
+
+		xmlTreeSaveGame->init("megaglest-saved-game");
+		XmlNode *rootNodeReplay = xmlTreeSaveGame->getRootNode();
+
+		//std::map<string,string> mapTagReplacements;
+		//time_t now = time(NULL);
+		//struct tm *loctime = localtime (&now);
+		struct tm loctime = threadsafe_localtime(systemtime_now());
+		char szBuf[4096]="";
+		strftime(szBuf,4095,"%Y-%m-%d %H:%M:%S",&loctime);
+
+		rootNodeReplay->addAttribute("version",glestVersionString, mapTagReplacements);
+		rootNodeReplay->addAttribute("timestamp",szBuf, mapTagReplacements);
+
+		XmlNode *gameNodeReplay = rootNodeReplay->addChild("Game");
+		gameSettings.saveGame(gameNodeReplay);
+
+		gameNodeReplay->addAttribute("LastWorldFrameCount",intToStr(world.getFrameCount()), mapTagReplacements);
+
+		for(unsigned int i = 0; i < replayCommandList.size(); ++i) {
+			std::pair<int,NetworkCommand> &cmd = replayCommandList[i];
+			XmlNode *networkCommandNode = cmd.second.saveGame(gameNodeReplay);
+			networkCommandNode->addAttribute("worldFrameCount",intToStr(cmd.first), mapTagReplacements);
+		}
+
+		// replays stay XML, they are read by tools outside the game
+		string replayFile = saveGameFile + ".replay";
+		if(SystemFlags::VERBOSE_MODE_ENABLED) printf("Saving game replay commands to [%s]\n",replayFile.c_str());
+		writeSaveGame(xmlTreeSaveGame.release(), replayFile, false, false, writeInBackground);
+	}
+
+	// everything the save needs is in the tree now, the encoding,
+	// compression and disk writes can happen while the game goes on
+	writeSaveGame(buildSaveGameTree(), saveGameFile, true, config.getBool("SaveGameDebugXml","false"), writeInBackground, reportResult);
 
 	if(masterserverMode == false) {
 		// take Screenshot
@@ -6916,7 +7146,8 @@ void Game::loadGame(string name,Program *programPtr,bool isMasterserverMode,cons
 
 		NetworkManager &networkManager= NetworkManager::getInstance();
 		networkManager.end();
-		networkManager.init(nrServer,true);
+		// a benchmark run is not announced to the masterserver
+		networkManager.init(nrServer,SimulationBenchmark::isEnabled() == false);
 
 		Game *newGame = new Game(programPtr, &newGameSettingsReplay, isMasterserverMode);
 		newGame->lastworldFrameCountForReplay = gameNode->getAttribute("LastWorldFrameCount")->getIntValue();
@@ -6942,6 +7173,23 @@ void Game::loadGame(string name,Program *programPtr,bool isMasterserverMode,cons
 	xmlTree.load(name, Properties::getTagReplacementValues(&mapExtraTagReplacementValues),true);
 	if(SystemFlags::VERBOSE_MODE_ENABLED) printf("After load of XML\n");
 
+	loadGameTree(xmlTree,programPtr,isMasterserverMode,joinGameSettings,false);
+}
+
+void Game::loadJoinGameSnapshot(const vector<unsigned char> &snapshot,Program *programPtr,const GameSettings *joinGameSettings) {
+	if(snapshot.empty() == true) {
+		throw megaglest_runtime_error("Empty join game snapshot");
+	}
+
+	XmlTree	xmlTree(XML_RAPIDXML_ENGINE);
+	std::map<string,string> mapExtraTagReplacementValues;
+	xmlTree.loadBinary((const char *)&snapshot[0], snapshot.size(), Properties::getTagReplacementValues(&mapExtraTagReplacementValues));
+
+	loadGameTree(xmlTree,programPtr,false,joinGameSettings,true);
+}
+
+// The new game keeps pointing into xmlTree until setState has loaded it
+void Game::loadGameTree(XmlTree &xmlTree,Program *programPtr,bool isMasterserverMode,const GameSettings *joinGameSettings,bool joinGameCatchUp) {
 	const XmlNode *rootNode= xmlTree.getRootNode();
 	if(rootNode->hasChild("megaglest-saved-game") == true) {
 		rootNode = rootNode->getChild("megaglest-saved-game");
@@ -7037,6 +7285,7 @@ void Game::loadGame(string name,Program *programPtr,bool isMasterserverMode,cons
 
 	newGame->loadGameNode = gameNode;
 	newGame->inJoinGameLoading = (joinGameSettings != NULL);
+	newGame->joinGameCatchUp = joinGameCatchUp;
 
 //	newGame->mouse2d = gameNode->getAttribute("mouse2d")->getIntValue();
 //    int mouseX;
@@ -43,6 +43,7 @@ namespace Glest{ namespace Game{
 
 class GraphicMessageBox;
 class ServerInterface;
+class SaveGameWriter;
 
 enum LoadGameItem {
 	lgt_FactionPreview 	= 0x01,
@@ -196,6 +197,8 @@ private:
 	XmlNode *loadGameNode;
 	int lastworldFrameCountForReplay;
 	std::vector<std::pair<int,NetworkCommand> > replayCommandList;
+	// created on the first save, writes saved games off the main thread
+	SaveGameWriter *saveGameWriter;
 
 	std::vector<string> streamingVideos;
 	::Shared::Graphics::VideoPlayer *videoPlayer;
@@ -209,6 +212,11 @@ private:
 
 	bool inJoinGameLoading;
 	bool initialResumeSpeedLoops;
+	// a join snapshot is taken once the keyframe's commands are given
+	bool joinGameSnapshotRequested;
+	bool joinGameSnapshotRequestSent;
+	// loaded from a join snapshot and still behind the server
+	bool joinGameCatchUp;
 
 	bool quitGameCalled;
 	bool disableSpeedChange;
@@ -257,6 +265,7 @@ public:
 	const World *getWorld() const			{return &world;}
 
 	Program *getProgram()					{return program;}
+	int getLastWorldFrameCountForReplay() const	{return lastworldFrameCountForReplay;}
 
 	Vec2i getMouseCellPos() const			{return mouseCellPos;}
 	bool isValidMouseCellPos() const;
@@ -332,8 +341,14 @@ public:
 	void stopStreamingVideo(const string &playVideo);
 	void stopAllVideo();
 
-	string saveGame(string name, const string &path="saved/");
+	// The file is written in the background unless the caller needs it
+	// on disk when this returns, reportResult tells the player once it is
+	string saveGame(string name, const string &path="saved/", bool writeInBackground=true, bool reportResult=false);
 	static void loadGame(string name,Program *programPtr,bool isMasterserverMode, const GameSettings *joinGameSettings=NULL);
+	// Loads the world snapshot sent by the server when joining a game in
+	// progress, the game then fast forwards until it reaches the server
+	static void loadJoinGameSnapshot(const vector<unsigned char> &snapshot,Program *programPtr,const GameSettings *joinGameSettings);
+	void startJoinGameSnapshot(int joiningFactionMask);
 
 	void addNetworkCommandToReplayList(NetworkCommand* networkCommand,int worldFrameCount);
 
@@ -410,6 +425,16 @@ private:
 	Stats getEndGameStats();
 	void checkWinnerStandardHeadlessOrObserver();
 	void checkWinnerStandardPlayer();
+	void endSaveGameWriter();
+	// Takes ownership of xmlTree
+	void writeSaveGame(XmlTree *xmlTree, const string &path, bool binary, bool debugXml, bool writeInBackground, bool reportResult=false);
+	void checkSaveGameResults();
+	void reportSaveGameResult(const string &file, bool saved, const string &error);
+	// Caller owns the returned tree
+	XmlTree * buildSaveGameTree();
+	static void loadGameTree(XmlTree &xmlTree,Program *programPtr,bool isMasterserverMode,const GameSettings *joinGameSettings,bool joinGameCatchUp);
+	void clearCachesForJoinGame();
+	void processJoinGameSnapshotRequest();
 	std::map<int, int> getTeamsAlive();
 	void initCamera(Map *map);
 
@@ -0,0 +1,188 @@
+// ==============================================================
+//	This file is part of MegaGlest (www.megaglest.org)
+//
+//	Copyright (C) 2026 The MegaGlest Team
+//
+//	You can redistribute this code and/or modify it under
+//	the terms of the GNU General Public License as published
+//	by the Free Software Foundation; either version 2 of the
+//	License, or (at your option) any later version
+// ==============================================================
+
+#include "save_game_writer.h"
+
+#include "platform_common.h"
+#include "platform_util.h"
+#include "conversion.h"
+#include "zone_profiler.h"
+#include "util.h"
+#include "leak_dumper.h"
+
+using namespace Shared::Platform;
+using namespace Shared::PlatformCommon;
+using namespace Shared::Util;
+
+namespace Glest{ namespace Game{
+
+// =====================================================
+// 	class SaveGameWriter
+// =====================================================
+
+SaveGameWriter::SaveGameWriter() : BaseThread() {
+	this->jobsMutex = new Mutex(CODE_AT_LINE);
+	this->pendingCount = 0;
+	uniqueID = "SaveGameWriter";
+}
+
+SaveGameWriter::~SaveGameWriter() {
+	for(unsigned int i = 0; i < jobs.size(); ++i) {
+		delete jobs[i].xmlTree;
+	}
+	jobs.clear();
+
+	delete this->jobsMutex;
+	this->jobsMutex = NULL;
+}
+
+void SaveGameWriter::setQuitStatus(bool value) {
+	if(SystemFlags::isDebugEnabled(SystemFlags::debugSystem)) SystemFlags::OutputDebug(SystemFlags::debugSystem,"In [%s::%s] Line: %d value = %d\n",__FILE__,__FUNCTION__,__LINE__,value);
+
+	BaseThread::setQuitStatus(value);
+	if(value == true) {
+		semTaskSignalled.signal();
+	}
+}
+
+bool SaveGameWriter::canShutdown(bool deleteSelfIfShutdownDelayed) {
+	bool ret = (getExecutingTask() == false);
+	if(ret == false && deleteSelfIfShutdownDelayed == true) {
+	    setDeleteSelfOnExecutionDone(deleteSelfIfShutdownDelayed);
+	    deleteSelfIfRequired();
+	    signalQuit();
+	}
+
+	return ret;
+}
+
+void SaveGameWriter::queue(XmlTree *xmlTree, const string &path, bool binary, bool debugXml, bool reportResult) {
+	Job job;
+	job.xmlTree = xmlTree;
+	job.path = path;
+	job.binary = binary;
+	job.debugXml = debugXml;
+	job.reportResult = reportResult;
+
+	static string mutexOwnerId = string(__FILE__) + string("_") + intToStr(__LINE__);
+	MutexSafeWrapper safeMutex(jobsMutex,mutexOwnerId);
+	jobs.push_back(job);
+	pendingCount++;
+	safeMutex.ReleaseLock();
+
+	semTaskSignalled.signal();
+}
+
+bool SaveGameWriter::popResult(Result &result) {
+	static string mutexOwnerId = string(__FILE__) + string("_") + intToStr(__LINE__);
+	MutexSafeWrapper safeMutex(jobsMutex,mutexOwnerId);
+	if(results.empty() == true) {
+		return false;
+	}
+	result = results.front();
+	results.pop_front();
+	return true;
+}
+
+bool SaveGameWriter::isIdle() {
+	static string mutexOwnerId = string(__FILE__) + string("_") + intToStr(__LINE__);
+	MutexSafeWrapper safeMutex(jobsMutex,mutexOwnerId);
+	return (pendingCount == 0);
+}
+
+void SaveGameWriter::waitUntilIdle() {
+	for(;isIdle() == false && getRunningStatus() == true;) {
+		sleep(5);
+	}
+}
+
+void SaveGameWriter::write(XmlTree *xmlTree, const string &path, bool binary, bool debugXml) {
+	PROFILE_ZONE("SaveGameWriter::write");
+
+	string tempFile = path + ".tmp";
+	if(binary == true) {
+		xmlTree->saveBinary(tempFile);
+	}
+	else {
+		xmlTree->save(tempFile);
+	}
+
+#ifdef WIN32
+	// rename does not replace an existing file here
+	removeFile(path);
+#endif
+	if(renameFile(tempFile, path) == false) {
+		removeFile(tempFile);
+		throw megaglest_runtime_error("Can not rename saved game [" + tempFile + "] to [" + path + "]");
+	}
+
+	if(debugXml == true) {
+		xmlTree->save(path + ".debug");
+	}
+}
+
+void SaveGameWriter::execute() {
+	RunningStatusSafeWrapper runningStatus(this);
+
+	if(SystemFlags::VERBOSE_MODE_ENABLED) printf("In [%s::%s Line: %d] ****************** STARTING worker thread this = %p\n",__FILE__,__FUNCTION__,__LINE__,this);
+	ZoneProfiler::setThreadName("Save game writer");
+
+	for(;;) {
+		static string mutexOwnerId = string(__FILE__) + string("_") + intToStr(__LINE__);
+		MutexSafeWrapper safeMutex(jobsMutex,mutexOwnerId);
+		bool haveJob = (jobs.empty() == false);
+		Job job;
+		if(haveJob == true) {
+			job = jobs.front();
+			jobs.pop_front();
+		}
+		safeMutex.ReleaseLock();
+
+		if(haveJob == false) {
+			// queued saves are still written when quitting, so the game
+			// can wait for them before shutting this thread down
+			if(getQuitStatus() == true) {
+				break;
+			}
+			semTaskSignalled.waitTillSignalled();
+			continue;
+		}
+
+		ExecutingTaskSafeWrapper safeExecutingTaskMutex(this);
+		Result result;
+		result.path = job.path;
+		result.saved = false;
+		try {
+			write(job.xmlTree, job.path, job.binary, job.debugXml);
+			result.saved = true;
+			if(SystemFlags::VERBOSE_MODE_ENABLED) printf("Saved game written to [%s]\n",job.path.c_str());
+		}
+		catch(const exception &ex) {
+			// the game keeps running, a failed save only loses this file
+			result.error = ex.what();
+			SystemFlags::OutputDebug(SystemFlags::debugError,"In [%s::%s Line: %d] Error writing saved game [%s]: %s\n",__FILE__,__FUNCTION__,__LINE__,job.path.c_str(),ex.what());
+			printf("**ERROR** Error writing saved game [%s]: %s\n",job.path.c_str(),ex.what());
+		}
+		delete job.xmlTree;
+
+		safeMutex.Lock();
+		if(job.reportResult == true) {
+			results.push_back(result);
+		}
+		pendingCount--;
+		safeMutex.ReleaseLock();
+	}
+
+	ZoneProfiler::releaseThreadBuffer();
+	if(SystemFlags::VERBOSE_MODE_ENABLED) printf("In [%s::%s Line: %d] ****************** ENDING worker thread this = %p\n",__FILE__,__FUNCTION__,__LINE__,this);
+}
+
+}}//end namespace
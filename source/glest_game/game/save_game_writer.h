@@ -0,0 +1,93 @@
+// ==============================================================
+//	This file is part of MegaGlest (www.megaglest.org)
+//
+//	Copyright (C) 2026 The MegaGlest Team
+//
+//	You can redistribute this code and/or modify it under
+//	the terms of the GNU General Public License as published
+//	by the Free Software Foundation; either version 2 of the
+//	License, or (at your option) any later version
+// ==============================================================
+
+#ifndef _GLEST_GAME_SAVEGAMEWRITER_H_
+#define _GLEST_GAME_SAVEGAMEWRITER_H_
+
+#ifdef WIN32
+    #include <winsock2.h>
+    #include <winsock.h>
+#endif
+
+#include <deque>
+#include <string>
+#include "base_thread.h"
+#include "xml_parser.h"
+#include "leak_dumper.h"
+
+using std::deque;
+using std::string;
+using Shared::PlatformCommon::BaseThread;
+using Shared::Platform::Mutex;
+using Shared::Platform::Semaphore;
+using Shared::Xml::XmlTree;
+
+namespace Glest{ namespace Game{
+
+// =====================================================
+// 	class SaveGameWriter
+//
+///	Encodes, compresses and writes saved game trees on its own
+///	thread. The game only builds the tree at a frame boundary and
+///	hands it over, so saving no longer stalls the frame for the
+///	time it takes to write the file
+// =====================================================
+
+class SaveGameWriter : public BaseThread {
+public:
+	struct Result {
+		string path;
+		bool saved;
+		string error;
+	};
+
+private:
+	struct Job {
+		XmlTree *xmlTree;
+		string path;
+		bool binary;
+		bool debugXml;
+		bool reportResult;
+	};
+
+	Semaphore semTaskSignalled;
+	Mutex *jobsMutex;
+	deque<Job> jobs;
+	// queued plus the one being written
+	int pendingCount;
+	deque<Result> results;
+
+	virtual void setQuitStatus(bool value);
+	virtual bool canShutdown(bool deleteSelfIfShutdownDelayed=false);
+
+public:
+	SaveGameWriter();
+	virtual ~SaveGameWriter();
+	virtual void execute();
+
+	// Takes ownership of xmlTree and writes it like write does,
+	// reportResult keeps the outcome for popResult
+	void queue(XmlTree *xmlTree, const string &path, bool binary=true, bool debugXml=false, bool reportResult=false);
+	// Oldest finished save queued with reportResult, false if none
+	bool popResult(Result &result);
+	bool isIdle();
+	// Blocks until every queued save is on disk or the thread stopped
+	void waitUntilIdle();
+
+	// Writes next to path first and renames when complete, so an older
+	// save is never left half overwritten. debugXml also exports the
+	// tree as XML to path + ".debug"
+	static void write(XmlTree *xmlTree, const string &path, bool binary=true, bool debugXml=false);
+};
+
+}}//end namespace
+
+#endif
@@ -0,0 +1,615 @@
+// ==============================================================
+//	This file is part of MegaGlest (www.megaglest.org)
+//
+//	Copyright (C) 2026 The MegaGlest Team
+//
+//	You can redistribute this code and/or modify it under
+//	the terms of the GNU General Public License as published
+//	by the Free Software Foundation; either version 2 of the
+//	License, or (at your option) any later version
+// ==============================================================
+
+#include "synch_snapshot.h"
+
+#include <cstring>
+#include <algorithm>
+#include "byte_order.h"
+#include "game_constants.h"
+#include "conversion.h"
+#include "platform_util.h"
+#include "util.h"
+#include "leak_dumper.h"
+
+using namespace Shared::Util;
+using namespace Shared::Platform;
+using namespace Shared::PlatformByteOrder;
+using std::max;
+
+namespace Glest{ namespace Game{
+
+namespace {
+	enum SynchSnapshotValueKind {
+		ssvkInt,
+		ssvkUInt,
+		ssvkInt64,
+		ssvkString,
+		ssvkName
+	};
+
+	const char *fieldNames[ssfCount] = {
+		"factionIndex",
+		"teamIndex",
+		"startLocationIndex",
+
+		"type",
+		"type",
+		"amount",
+		"pos.x",
+		"pos.y",
+		"balance",
+
+		"id",
+		"type",
+		"hp",
+		"ep",
+		"loadCount",
+		"deadCount",
+		"progress",
+		"lastAnimProgress",
+		"animProgress",
+		"progress2",
+		"kills",
+		"enemyKills",
+		"morphFieldsBlocked",
+		"targetRef",
+		"currField",
+		"targetField",
+		"level",
+		"pos.x",
+		"pos.y",
+		"lastPos.x",
+		"lastPos.y",
+		"targetPos.x",
+		"targetPos.y",
+		"meetingPos.x",
+		"meetingPos.y",
+		"preMorphType",
+		"loadType",
+		"currSkill",
+		"toBeUndertaken",
+		"alive",
+		"fireActive",
+		"totalUpgradeCRC",
+		"unitPathCRC",
+		"commandCount",
+		"commandCRC",
+		"damageParticleSystems",
+		"modelFacing",
+		"inBailOutAttempt",
+		"badHarvestPosCount",
+		"lastStuckFrame",
+		"lastStuckPos.x",
+		"lastStuckPos.y",
+		"attackBoostUnits",
+		"currentPathFinderDesiredFinalPos.x",
+		"currentPathFinderDesiredFinalPos.y",
+		"randomLastNumber",
+		"randomLastCaller",
+		"networkCRCLogInfo",
+		"networkCRCParticleLogInfo",
+		"networkCRCDecHp",
+		"particleInfo",
+		"lastHarvestedResourcePos.x",
+		"lastHarvestedResourcePos.y",
+		"attackParticleSystems"
+	};
+
+	template<typename T> void writeValue(FILE *file, T value) {
+		value = toCommonEndian(value);
+		fwrite(&value, sizeof(T), 1, file);
+	}
+
+	template<typename T> bool readValue(FILE *file, T &value) {
+		if(fread(&value, sizeof(T), 1, file) != 1) {
+			return false;
+		}
+		value = fromCommonEndian(value);
+		return true;
+	}
+
+	void writeString(FILE *file, const string &value) {
+		writeValue<uint32>(file, (uint32)value.size());
+		if(value.empty() == false) {
+			fwrite(value.c_str(), value.size(), 1, file);
+		}
+	}
+
+	// bytes between the current position and the end of the file, sizes
+	// read from a snapshot file are checked against it before allocating
+	long getRemainingSize(FILE *file) {
+		long position = ftell(file);
+		if(position < 0 || fseek(file, 0, SEEK_END) != 0) {
+			return 0;
+		}
+		long end = ftell(file);
+		if(fseek(file, position, SEEK_SET) != 0) {
+			return 0;
+		}
+		return (end > position ? end - position : 0);
+	}
+
+	bool readString(FILE *file, string &value) {
+		uint32 size = 0;
+		if(readValue<uint32>(file, size) == false || size > (unsigned long)getRemainingSize(file)) {
+			return false;
+		}
+		value.resize(size);
+		return (size == 0 || fread(&value[0], size, 1, file) == 1);
+	}
+
+	FILE * openSnapshotFile(const string &path, bool write) {
+#if defined(WIN32) && !defined(__MINGW32__)
+		return _wfopen(utf8_decode(path).c_str(), (write == true ? L"wb" : L"rb"));
+#else
+		return fopen(path.c_str(), (write == true ? "wb" : "rb"));
+#endif
+	}
+}
+
+// =====================================================
+// 	class SynchSnapshotWriter
+// =====================================================
+
+void SynchSnapshotWriter::addValue(SynchSnapshotField field, unsigned char kind, const void *value, size_t size) {
+	size_t offset = data->size();
+	data->resize(offset + 2 + size);
+	(*data)[offset]		= (unsigned char)field;
+	(*data)[offset + 1]	= kind;
+	if(size > 0) {
+		memcpy(&(*data)[offset + 2], value, size);
+	}
+}
+
+void SynchSnapshotWriter::addInt(SynchSnapshotField field, int32 value) {
+	value = toCommonEndian(value);
+	addValue(field, ssvkInt, &value, sizeof(value));
+}
+
+void SynchSnapshotWriter::addUInt(SynchSnapshotField field, uint32 value) {
+	value = toCommonEndian(value);
+	addValue(field, ssvkUInt, &value, sizeof(value));
+}
+
+void SynchSnapshotWriter::addInt64(SynchSnapshotField field, int64 value) {
+	value = toCommonEndian(value);
+	addValue(field, ssvkInt64, &value, sizeof(value));
+}
+
+void SynchSnapshotWriter::addString(SynchSnapshotField field, const string &value) {
+	uint32 size = toCommonEndian((uint32)value.size());
+	addValue(field, ssvkString, &size, sizeof(size));
+	data->insert(data->end(), value.begin(), value.end());
+}
+
+void SynchSnapshotWriter::addNameIndex(SynchSnapshotField field, int nameIndex) {
+	int32 value = toCommonEndian((int32)nameIndex);
+	addValue(field, ssvkName, &value, sizeof(value));
+}
+
+// =====================================================
+// 	class SynchSnapshotRing
+// =====================================================
+
+const char * SynchSnapshotRing::getFieldName(SynchSnapshotField field) {
+	if(field < 0 || field >= ssfCount) {
+		return "unknown";
+	}
+	return fieldNames[field];
+}
+
+const int SynchSnapshotRing::maxLoadCapacity = 100000;
+
+SynchSnapshotRing::SynchSnapshotRing() {
+	firstFrame	= 0;
+	frameCount	= 0;
+}
+
+void SynchSnapshotRing::setCapacity(int capacity) {
+	if(capacity != (int)frames.size()) {
+		frames.clear();
+		frames.resize(max(capacity, 1));
+		firstFrame	= 0;
+		frameCount	= 0;
+	}
+}
+
+void SynchSnapshotRing::clear() {
+	frames.clear();
+	firstFrame	= 0;
+	frameCount	= 0;
+	names.clear();
+	nameIndexes.clear();
+}
+
+SynchSnapshotWriter SynchSnapshotRing::beginFrame(int worldFrame) {
+	if(frames.empty() == true) {
+		setCapacity(1);
+	}
+
+	int slot = 0;
+	if(frameCount > 0 && getFrameAt(frameCount - 1).worldFrame == worldFrame) {
+		// the same frame again replaces its snapshot
+		slot = (firstFrame + frameCount - 1) % (int)frames.size();
+	}
+	else if(frameCount < (int)frames.size()) {
+		slot = (firstFrame + frameCount) % (int)frames.size();
+		frameCount++;
+	}
+	else {
+		slot = firstFrame;
+		firstFrame = (firstFrame + 1) % (int)frames.size();
+	}
+
+	// the buffer keeps its capacity so a full ring no longer allocates
+	Frame &frame = frames[slot];
+	frame.worldFrame = worldFrame;
+	frame.data.clear();
+	return SynchSnapshotWriter(this, &frame.data);
+}
+
+int SynchSnapshotRing::findName(const void *key) const {
+	std::map<const void *,int>::const_iterator iterFind = nameIndexes.find(key);
+	return (iterFind != nameIndexes.end() ? iterFind->second : -1);
+}
+
+int SynchSnapshotRing::registerName(const void *key, const string &name) {
+	int nameIndex = (int)names.size();
+	names.push_back(name);
+	nameIndexes[key] = nameIndex;
+	return nameIndex;
+}
+
+const SynchSnapshotRing::Frame & SynchSnapshotRing::getFrameAt(int index) const {
+	if(index < 0 || index >= frameCount) {
+		char szBuf[8096]="";
+		snprintf(szBuf,8096,"Invalid snapshot frame index: %d frame count: %d",index,frameCount);
+		throw megaglest_runtime_error(szBuf);
+	}
+	return frames[(firstFrame + index) % (int)frames.size()];
+}
+
+int SynchSnapshotRing::getWorldFrame(int index) const {
+	return getFrameAt(index).worldFrame;
+}
+
+int SynchSnapshotRing::findFrameIndex(int worldFrame) const {
+	for(int index = 0; index < frameCount; ++index) {
+		if(getFrameAt(index).worldFrame == worldFrame) {
+			return index;
+		}
+	}
+	return -1;
+}
+
+uint64 SynchSnapshotRing::getByteCount() const {
+	uint64 result = 0;
+	for(unsigned int index = 0; index < frames.size(); ++index) {
+		result += frames[index].data.capacity();
+	}
+	return result;
+}
+
+void SynchSnapshotRing::decodeFrame(int index, Fields &fields) const {
+	const vector<unsigned char> &data = getFrameAt(index).data;
+
+	string section = "faction";
+	std::map<int,int> fieldCounts;
+	int resourceCount = 0;
+	int storeCount = 0;
+
+	for(size_t offset = 0; offset + 2 <= data.size();) {
+		SynchSnapshotField field = (SynchSnapshotField)data[offset];
+		unsigned char kind = data[offset + 1];
+		offset += 2;
+
+		string value = "";
+		switch(kind) {
+			case ssvkInt:
+			case ssvkName: {
+				if(offset + sizeof(int32) > data.size()) {
+					return;
+				}
+				int32 number = 0;
+				memcpy(&number, &data[offset], sizeof(number));
+				number = fromCommonEndian(number);
+				offset += sizeof(number);
+				if(kind == ssvkInt) {
+					value = intToStr(number);
+				}
+				else {
+					value = (number >= 0 && number < (int)names.size() ? names[number] : "?" + intToStr(number));
+				}
+				}
+				break;
+			case ssvkUInt: {
+				if(offset + sizeof(uint32) > data.size()) {
+					return;
+				}
+				uint32 number = 0;
+				memcpy(&number, &data[offset], sizeof(number));
+				offset += sizeof(number);
+				value = uIntToStr(fromCommonEndian(number));
+				}
+				break;
+			case ssvkInt64: {
+				if(offset + sizeof(int64) > data.size()) {
+					return;
+				}
+				int64 number = 0;
+				memcpy(&number, &data[offset], sizeof(number));
+				offset += sizeof(number);
+				value = intToStr(fromCommonEndian(number));
+				}
+				break;
+			case ssvkString: {
+				if(offset + sizeof(uint32) > data.size()) {
+					return;
+				}
+				uint32 size = 0;
+				memcpy(&size, &data[offset], sizeof(size));
+				size = fromCommonEndian(size);
+				offset += sizeof(size);
+				if(offset + size > data.size()) {
+					return;
+				}
+				value.assign((const char *)&data[offset], size);
+				offset += size;
+				}
+				break;
+			default:
+				// written by a newer version, the rest can't be walked
+				return;
+		}
+
+		if(field == ssfUnitId) {
+			section = "unit[" + value + "]";
+			fieldCounts.clear();
+		}
+		else if(field == ssfResourceType) {
+			section = "resource[" + intToStr(resourceCount++) + "]";
+			fieldCounts.clear();
+		}
+		else if(field == ssfStoreType) {
+			section = "store[" + intToStr(storeCount++) + "]";
+			fieldCounts.clear();
+		}
+
+		// repeated values (commands, log lines) are numbered
+		string key = section + "." + getFieldName(field);
+		int count = fieldCounts[field]++;
+		if(count > 0 || field == ssfUnitCommandCRC || field == ssfUnitNetworkCRCDecHp ||
+			field == ssfUnitParticleInfo) {
+			key += "[" + intToStr(count) + "]";
+		}
+		fields.push_back(make_pair(key, value));
+	}
+}
+
+string SynchSnapshotRing::renderFields(const Fields &fields) {
+	string result = "";
+	for(unsigned int index = 0; index < fields.size(); ++index) {
+		result += fields[index].first + " = " + fields[index].second + "\n";
+	}
+	return result;
+}
+
+string SynchSnapshotRing::renderFrame(int index) const {
+	Fields fields;
+	decodeFrame(index, fields);
+	return renderFields(fields);
+}
+
+void SynchSnapshotRing::saveFrames(FILE *file) const {
+	writeValue<int32>(file, (int32)frames.size());
+	writeValue<int32>(file, (int32)names.size());
+	for(unsigned int index = 0; index < names.size(); ++index) {
+		writeString(file, names[index]);
+	}
+
+	writeValue<int32>(file, frameCount);
+	for(int index = 0; index < frameCount; ++index) {
+		const Frame &frame = getFrameAt(index);
+		writeValue<int32>(file, frame.worldFrame);
+		writeValue<uint32>(file, (uint32)frame.data.size());
+		if(frame.data.empty() == false) {
+			fwrite(&frame.data[0], frame.data.size(), 1, file);
+		}
+	}
+}
+
+bool SynchSnapshotRing::loadFrames(FILE *file) {
+	clear();
+
+	// every name takes at least its size, a damaged or foreign file must
+	// not make us allocate more than it could hold
+	int32 capacity = 0;
+	int32 nameCount = 0;
+	if(readValue<int32>(file, capacity) == false || capacity < 0 || capacity > maxLoadCapacity ||
+		readValue<int32>(file, nameCount) == false || nameCount < 0 ||
+		(long)nameCount > getRemainingSize(file) / (long)sizeof(uint32)) {
+		return false;
+	}
+	for(int index = 0; index < nameCount; ++index) {
+		string name = "";
+		if(readString(file, name) == false) {
+			return false;
+		}
+		names.push_back(name);
+	}
+
+	int32 count = 0;
+	if(readValue<int32>(file, count) == false || count < 0 || count > max(capacity, 1)) {
+		return false;
+	}
+	setCapacity(max(capacity, 1));
+	for(int index = 0; index < count; ++index) {
+		int32 worldFrame = 0;
+		uint32 size = 0;
+		if(readValue<int32>(file, worldFrame) == false ||
+			readValue<uint32>(file, size) == false ||
+			size > (unsigned long)getRemainingSize(file)) {
+			return false;
+		}
+		beginFrame(worldFrame);
+		Frame &frame = frames[(firstFrame + frameCount - 1) % (int)frames.size()];
+		frame.data.resize(size);
+		if(size > 0 && fread(&frame.data[0], size, 1, file) != 1) {
+			return false;
+		}
+	}
+	return true;
+}
+
+string SynchSnapshotRing::diff(const SynchSnapshotRing &ring1, const SynchSnapshotRing &ring2,
+								int maxDifferences, int *firstDifferentFrame) {
+	string result = "";
+	int differences = 0;
+	if(firstDifferentFrame != NULL) {
+		*firstDifferentFrame = -1;
+	}
+
+	for(int index1 = 0; index1 < ring1.getFrameCount() && differences < maxDifferences; ++index1) {
+		int worldFrame = ring1.getWorldFrame(index1);
+		int index2 = ring2.findFrameIndex(worldFrame);
+		if(index2 < 0) {
+			continue;
+		}
+
+		Fields fields1;
+		Fields fields2;
+		ring1.decodeFrame(index1, fields1);
+		ring2.decodeFrame(index2, fields2);
+		std::map<string,string> values2(fields2.begin(), fields2.end());
+
+		bool frameDiffers = false;
+		for(unsigned int index = 0; index < fields1.size() && differences < maxDifferences; ++index) {
+			std::map<string,string>::iterator iterFind = values2.find(fields1[index].first);
+			string line = "";
+			if(iterFind == values2.end()) {
+				line = fields1[index].first + ": [" + fields1[index].second + "] vs missing";
+			}
+			else {
+				if(iterFind->second != fields1[index].second) {
+					line = fields1[index].first + ": [" + fields1[index].second + "] vs [" + iterFind->second + "]";
+				}
+				values2.erase(iterFind);
+			}
+
+			if(line != "") {
+				if(frameDiffers == false) {
+					frameDiffers = true;
+					result += "** world frame: " + intToStr(worldFrame) + "\n";
+					if(firstDifferentFrame != NULL && *firstDifferentFrame < 0) {
+						*firstDifferentFrame = worldFrame;
+					}
+				}
+				result += line + "\n";
+				differences++;
+			}
+		}
+		for(unsigned int index = 0; index < fields2.size() && differences < maxDifferences; ++index) {
+			if(values2.find(fields2[index].first) != values2.end()) {
+				if(frameDiffers == false) {
+					frameDiffers = true;
+					result += "** world frame: " + intToStr(worldFrame) + "\n";
+					if(firstDifferentFrame != NULL && *firstDifferentFrame < 0) {
+						*firstDifferentFrame = worldFrame;
+					}
+				}
+				result += fields2[index].first + ": missing vs [" + fields2[index].second + "]\n";
+				differences++;
+			}
+		}
+	}
+	return result;
+}
+
+// =====================================================
+// 	class SynchSnapshotFile
+// =====================================================
+
+const char *SynchSnapshotFile::magic	= "MGSS";
+const int SynchSnapshotFile::version	= 1;
+
+bool SynchSnapshotFile::save(const string &path, const vector<const SynchSnapshotRing *> &rings) {
+	FILE *file = openSnapshotFile(path, true);
+	if(file == NULL) {
+		SystemFlags::OutputDebug(SystemFlags::debugError,"In [%s::%s Line: %d] could not write synch snapshot file [%s]\n",extractFileFromDirectoryPath(__FILE__).c_str(),__FUNCTION__,__LINE__,path.c_str());
+		return false;
+	}
+
+	fwrite(magic, strlen(magic), 1, file);
+	writeValue<int32>(file, version);
+	writeValue<int32>(file, (int32)rings.size());
+	for(unsigned int index = 0; index < rings.size(); ++index) {
+		rings[index]->saveFrames(file);
+	}
+	bool result = (ferror(file) == 0);
+	fclose(file);
+	return result;
+}
+
+bool SynchSnapshotFile::load(const string &path, vector<SynchSnapshotRing> &rings) {
+	rings.clear();
+	FILE *file = openSnapshotFile(path, false);
+	if(file == NULL) {
+		return false;
+	}
+
+	char fileMagic[4] = { 0 };
+	int32 fileVersion = 0;
+	int32 ringCount = 0;
+	bool result = (fread(fileMagic, sizeof(fileMagic), 1, file) == 1 &&
+				   memcmp(fileMagic, magic, sizeof(fileMagic)) == 0 &&
+				   readValue<int32>(file, fileVersion) == true && fileVersion == version &&
+				   readValue<int32>(file, ringCount) == true && ringCount >= 0 &&
+				   ringCount <= GameConstants::maxPlayers + GameConstants::specialFactions);
+	if(result == true) {
+		rings.resize(ringCount);
+		for(int index = 0; index < ringCount && result == true; ++index) {
+			result = rings[index].loadFrames(file);
+		}
+	}
+	fclose(file);
+	return result;
+}
+
+string SynchSnapshotFile::diff(const string &path1, const string &path2, int maxDifferences) {
+	vector<SynchSnapshotRing> rings1;
+	vector<SynchSnapshotRing> rings2;
+	if(load(path1, rings1) == false) {
+		return "Could not read synch snapshot file [" + path1 + "]\n";
+	}
+	if(load(path2, rings2) == false) {
+		return "Could not read synch snapshot file [" + path2 + "]\n";
+	}
+
+	string result = "";
+	if(rings1.size() != rings2.size()) {
+		result += "Faction count differs: " + intToStr(rings1.size()) + " vs " + intToStr(rings2.size()) + "\n";
+	}
+	for(unsigned int index = 0; index < rings1.size() && index < rings2.size(); ++index) {
+		int firstDifferentFrame = -1;
+		string factionDiff = SynchSnapshotRing::diff(rings1[index], rings2[index], maxDifferences, &firstDifferentFrame);
+		if(firstDifferentFrame >= 0) {
+			result += "Faction index: " + intToStr(index) + " first different world frame: " + intToStr(firstDifferentFrame) + "\n";
+			result += factionDiff;
+		}
+	}
+	if(result == "") {
+		result = "No differences in the world frames both files kept\n";
+	}
+	return result;
+}
+
+}}//end namespace
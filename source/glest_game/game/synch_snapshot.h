@@ -0,0 +1,240 @@
+// ==============================================================
+//	This file is part of MegaGlest (www.megaglest.org)
+//
+//	Copyright (C) 2026 The MegaGlest Team
+//
+//	You can redistribute this code and/or modify it under
+//	the terms of the GNU General Public License as published
+//	by the Free Software Foundation; either version 2 of the
+//	License, or (at your option) any later version
+// ==============================================================
+
+#ifndef _GLEST_GAME_SYNCHSNAPSHOT_H_
+#define _GLEST_GAME_SYNCHSNAPSHOT_H_
+
+#ifdef WIN32
+    #include <winsock2.h>
+    #include <winsock.h>
+#endif
+
+#include <vector>
+#include <map>
+#include <string>
+#include <cstdio>
+#include "data_types.h"
+#include "leak_dumper.h"
+
+using std::vector;
+using std::string;
+using Shared::Platform::int32;
+using Shared::Platform::uint32;
+using Shared::Platform::int64;
+using Shared::Platform::uint64;
+
+namespace Glest{ namespace Game{
+
+// =====================================================
+// 	enum SynchSnapshotField
+//
+///	Tags of the values a faction writes into its snapshot.
+///	Only ever append, saved snapshots are decoded by tag.
+// =====================================================
+
+enum SynchSnapshotField {
+	ssfFactionIndex,
+	ssfTeamIndex,
+	ssfStartLocationIndex,
+
+	ssfResourceType,		// starts a resource
+	ssfStoreType,			// starts a store resource
+	ssfResourceAmount,
+	ssfResourcePosX,
+	ssfResourcePosY,
+	ssfResourceBalance,
+
+	ssfUnitId,				// starts a unit
+	ssfUnitType,
+	ssfUnitHp,
+	ssfUnitEp,
+	ssfUnitLoadCount,
+	ssfUnitDeadCount,
+	ssfUnitProgress,
+	ssfUnitLastAnimProgress,
+	ssfUnitAnimProgress,
+	ssfUnitProgress2,
+	ssfUnitKills,
+	ssfUnitEnemyKills,
+	ssfUnitMorphFieldsBlocked,
+	ssfUnitTargetRef,
+	ssfUnitCurrField,
+	ssfUnitTargetField,
+	ssfUnitLevel,
+	ssfUnitPosX,
+	ssfUnitPosY,
+	ssfUnitLastPosX,
+	ssfUnitLastPosY,
+	ssfUnitTargetPosX,
+	ssfUnitTargetPosY,
+	ssfUnitMeetingPosX,
+	ssfUnitMeetingPosY,
+	ssfUnitPreMorphType,
+	ssfUnitLoadType,
+	ssfUnitSkill,
+	ssfUnitToBeUndertaken,
+	ssfUnitAlive,
+	ssfUnitFireActive,
+	ssfUnitTotalUpgradeCRC,
+	ssfUnitPathCRC,
+	ssfUnitCommandCount,
+	ssfUnitCommandCRC,
+	ssfUnitDamageParticleSystems,
+	ssfUnitModelFacing,
+	ssfUnitInBailOutAttempt,
+	ssfUnitBadHarvestPosCount,
+	ssfUnitLastStuckFrame,
+	ssfUnitLastStuckPosX,
+	ssfUnitLastStuckPosY,
+	ssfUnitAttackBoostUnits,
+	ssfUnitDesiredFinalPosX,
+	ssfUnitDesiredFinalPosY,
+	ssfUnitRandomLastNumber,
+	ssfUnitRandomLastCaller,
+	ssfUnitNetworkCRCLogInfo,
+	ssfUnitNetworkCRCParticleLogInfo,
+	ssfUnitNetworkCRCDecHp,
+	ssfUnitParticleInfo,
+	ssfUnitLastHarvestedPosX,
+	ssfUnitLastHarvestedPosY,
+	ssfUnitAttackParticleSystems,
+
+	ssfCount
+};
+
+// =====================================================
+// 	class SynchSnapshotWriter
+//
+///	Appends tagged values of one frame to a reused byte buffer
+// =====================================================
+
+class SynchSnapshotRing;
+
+class SynchSnapshotWriter {
+private:
+	SynchSnapshotRing *ring;
+	vector<unsigned char> *data;
+
+	void addValue(SynchSnapshotField field, unsigned char kind, const void *value, size_t size);
+
+public:
+	SynchSnapshotWriter(SynchSnapshotRing *ring, vector<unsigned char> *data) : ring(ring), data(data) {}
+
+	void addInt(SynchSnapshotField field, int32 value);
+	void addUInt(SynchSnapshotField field, uint32 value);
+	void addInt64(SynchSnapshotField field, int64 value);
+	void addString(SynchSnapshotField field, const string &value);
+	void addNameIndex(SynchSnapshotField field, int nameIndex);
+
+	// Type names are stored once per ring and referenced by index,
+	// keyed by the type pointer so a frame never builds the name
+	template<typename T> void addTypeName(SynchSnapshotField field, const T *type);
+};
+
+// =====================================================
+// 	class SynchSnapshotRing
+//
+///	Fixed ring of the last binary snapshots of one faction, kept
+///	so the state around an out of synch frame can be reported.
+///	Frames are only decoded to text when they are asked for.
+// =====================================================
+
+class SynchSnapshotRing {
+public:
+	// one decoded value: "unit[12].hp" -> "30"
+	typedef vector<std::pair<string,string> > Fields;
+
+	static const char *getFieldName(SynchSnapshotField field);
+
+private:
+	class Frame {
+	public:
+		Frame() : worldFrame(-1) {}
+
+		int worldFrame;
+		vector<unsigned char> data;
+	};
+
+	vector<Frame> frames;
+	int firstFrame;
+	int frameCount;
+
+	vector<string> names;
+	std::map<const void *,int> nameIndexes;
+
+	const Frame &getFrameAt(int index) const;
+
+public:
+	// largest ring a snapshot file may ask loadFrames for
+	static const int maxLoadCapacity;
+
+	SynchSnapshotRing();
+
+	void setCapacity(int capacity);
+	int getCapacity() const	{return (int)frames.size();}
+	void clear();
+
+	// Starts the snapshot of worldFrame, overwriting the oldest one once full
+	SynchSnapshotWriter beginFrame(int worldFrame);
+
+	int findName(const void *key) const;
+	int registerName(const void *key, const string &name);
+
+	int getFrameCount() const	{return frameCount;}
+	// index 0 is the oldest frame kept
+	int getWorldFrame(int index) const;
+	int findFrameIndex(int worldFrame) const;
+	uint64 getByteCount() const;
+
+	void decodeFrame(int index, Fields &fields) const;
+	string renderFrame(int index) const;
+
+	void saveFrames(FILE *file) const;
+	bool loadFrames(FILE *file);
+
+	// Lists every value that differs between the frames both rings kept
+	static string diff(const SynchSnapshotRing &ring1, const SynchSnapshotRing &ring2,
+						int maxDifferences, int *firstDifferentFrame);
+	static string renderFields(const Fields &fields);
+};
+
+template<typename T> void SynchSnapshotWriter::addTypeName(SynchSnapshotField field, const T *type) {
+	if(type != NULL) {
+		int nameIndex = ring->findName(type);
+		if(nameIndex < 0) {
+			nameIndex = ring->registerName(type, type->getName());
+		}
+		addNameIndex(field, nameIndex);
+	}
+}
+
+// =====================================================
+// 	class SynchSnapshotFile
+//
+///	The snapshot rings of every faction, as saved next to the
+///	out of synch log and compared offline
+// =====================================================
+
+class SynchSnapshotFile {
+public:
+	static const char *magic;
+	static const int version;
+
+	static bool save(const string &path, const vector<const SynchSnapshotRing *> &rings);
+	static bool load(const string &path, vector<SynchSnapshotRing> &rings);
+
+	// Returns the report of comparing two saved files
+	static string diff(const string &path1, const string &path2, int maxDifferences);
+};
+
+}}//end namespace
+
+#endif
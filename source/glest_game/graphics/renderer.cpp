@@ -230,6 +230,7 @@ Renderer::Renderer() : BaseRenderer(), saveScreenShotThreadAccessor(new Mutex(CO
 	Renderer::perspFarPlane = config.getFloat("PerspectiveFarPlane",floatToStr(Renderer::perspFarPlane).c_str());
 	this->no2DMouseRendering = config.getBool("No2DMouseRendering","false");
 	this->maxConsoleLines= config.getInt("ConsoleMaxLines");
+	ParticleManager::setParallelUpdateEnabled(config.getBool("EnableParallelParticleUpdate","true"));
 
 	if(SystemFlags::VERBOSE_MODE_ENABLED) printf("In [%s::%s Line: %d] Renderer::perspFarPlane [%f] this->no2DMouseRendering [%d] this->maxConsoleLines [%d]\n",extractFileFromDirectoryPath(__FILE__).c_str(),__FUNCTION__,__LINE__,Renderer::perspFarPlane,this->no2DMouseRendering,this->maxConsoleLines);
 
@@ -994,8 +995,8 @@ void Renderer::cleanupUnitParticleSystems(vector<UnitParticleSystem *> &particle
 	particleManager[rs]->cleanupUnitParticleSystems(particleSystems);
 }
 
-void Renderer::updateParticleManager(ResourceScope rs, int renderFps) {
-	particleManager[rs]->update(renderFps);
+void Renderer::updateParticleManager(ResourceScope rs, int renderFps, WorkStealingTaskPool *taskPool) {
+	particleManager[rs]->update(renderFps, taskPool);
 }
 
 void Renderer::renderParticleManager(ResourceScope rs){
@@ -490,7 +490,7 @@ public:
 	void cleanupUnitParticleSystems(vector<UnitParticleSystem *> &particleSystems,ResourceScope rs);
 	bool validateParticleSystemStillExists(ParticleSystem * particleSystem,ResourceScope rs) const;
 	void removeParticleSystemsForParticleOwner(ParticleOwner * particleOwner,ResourceScope rs);
-	void updateParticleManager(ResourceScope rs,int renderFps=-1);
+	void updateParticleManager(ResourceScope rs,int renderFps=-1,WorkStealingTaskPool *taskPool=NULL);
 	void renderParticleManager(ResourceScope rs);
 	void swapBuffers();
 
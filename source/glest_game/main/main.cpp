@@ -29,6 +29,7 @@
 #include "steamshim_child.h"
 #include "steam.h"
 #include "game.h"
+#include "synch_snapshot.h"
 #include "main_menu.h"
 #include "program.h"
 #include "config.h"
@@ -56,8 +57,10 @@
 #include <locale.h>
 #include "string_utils.h"
 #include "auto_test.h"
+#include "simulation_benchmark.h"
 #include "lua_script.h"
 #include "interpolation.h"
+#include "zone_profiler.h"
 #include "common_scoped_ptr.h"
 
 // To handle signal catching
@@ -205,6 +208,56 @@ void cleanupCRCThread() {
 	if(SystemFlags::VERBOSE_MODE_ENABLED) printf("In [%s::%s Line: %d]\n",__FILE__,__FUNCTION__,__LINE__);
 }
 
+// Profiler captures are written next to the other log files
+static void exportZoneProfile() {
+	struct tm loctime = threadsafe_localtime(systemtime_now());
+	char szBuf[100]="";
+	strftime(szBuf,100,"profile-%Y%m%d-%H%M%S.json",&loctime);
+
+	string profileFile = szBuf;
+	if(getGameReadWritePath(GameConstants::path_logs_CacheLookupKey) != "") {
+		profileFile = getGameReadWritePath(GameConstants::path_logs_CacheLookupKey) + profileFile;
+	}
+	else {
+		string userData = Config::getInstance().getString("UserData_Root","");
+		if(userData != "") {
+			endPathWithSlash(userData);
+		}
+		profileFile = userData + profileFile;
+	}
+
+	string msg = "Profiler capture saved to: " + profileFile;
+	if(ZoneProfiler::exportChromeTrace(profileFile) == false) {
+		msg = "Could not save profiler capture to: " + profileFile;
+		SystemFlags::OutputDebug(SystemFlags::debugError,"In [%s::%s Line: %d] %s\n",extractFileFromDirectoryPath(__FILE__).c_str(),__FUNCTION__,__LINE__,msg.c_str());
+	}
+	printf("%s\n",msg.c_str());
+	if(mainProgram != NULL && GlobalStaticFlags::getIsNonGraphicalModeEnabled() == false) {
+		mainProgram->consoleAddLine(msg);
+	}
+}
+
+// The hotkey, the headless console command and SIGUSR1 only request a
+// toggle, the main loop starts or stops the capture here
+static void updateZoneProfiler() {
+	if(ZoneProfiler::takeToggleRequest() == false) {
+		return;
+	}
+	if(ZoneProfiler::isEnabled() == true) {
+		ZoneProfiler::stop();
+		exportZoneProfile();
+	}
+	else {
+		ZoneProfiler::start();
+
+		string msg = "Profiler capture started";
+		printf("%s\n",msg.c_str());
+		if(mainProgram != NULL && GlobalStaticFlags::getIsNonGraphicalModeEnabled() == false) {
+			mainProgram->consoleAddLine(msg);
+		}
+	}
+}
+
 static void cleanupProcessObjects() {
 	if(SystemFlags::VERBOSE_MODE_ENABLED) printf("In [%s::%s Line: %d]\n",__FILE__,__FUNCTION__,__LINE__);
 
@@ -1227,6 +1280,9 @@ void MainWindow::eventKeyDown(SDL_KeyboardEvent key) {
 			Config &config = Config::getInstance();
 			config.reload();
 		}
+		else if(isKeyPressed(configKeys.getSDLKey("HotKeyToggleProfiler"),key,modifiersToCheck) == true) {
+			ZoneProfiler::requestToggle();
+		}
 		else if(isKeyPressed(configKeys.getSDLKey("Screenshot"),key,modifiersToCheck) == true) {
 			if(SystemFlags::VERBOSE_MODE_ENABLED) printf("Screenshot key pressed\n");
 
@@ -1620,16 +1676,16 @@ int setupGameItemPaths(int argc, char** argv, Config *config) {
 
 void setupLogging(Config &config, bool haveSpecialOutputCommandLineOption) {
 
-    SystemFlags::getSystemSettingType(SystemFlags::debugSystem).enabled      	= config.getBool("DebugMode","false");
-    SystemFlags::getSystemSettingType(SystemFlags::debugNetwork).enabled     	= config.getBool("DebugNetwork","false");
-    SystemFlags::getSystemSettingType(SystemFlags::debugPerformance).enabled 	= config.getBool("DebugPerformance","false");
-    SystemFlags::getSystemSettingType(SystemFlags::debugWorldSynch).enabled  	= config.getBool("DebugWorldSynch","false");
-    SystemFlags::getSystemSettingType(SystemFlags::debugUnitCommands).enabled  	= config.getBool("DebugUnitCommands","false");
-    SystemFlags::getSystemSettingType(SystemFlags::debugPathFinder).enabled  	= config.getBool("DebugPathFinder","false");
-    SystemFlags::getSystemSettingType(SystemFlags::debugLUA).enabled  			= config.getBool("DebugLUA","false");
+    SystemFlags::setDebugEnabled(SystemFlags::debugSystem, config.getBool("DebugMode","false"));
+    SystemFlags::setDebugEnabled(SystemFlags::debugNetwork, config.getBool("DebugNetwork","false"));
+    SystemFlags::setDebugEnabled(SystemFlags::debugPerformance, config.getBool("DebugPerformance","false"));
+    SystemFlags::setDebugEnabled(SystemFlags::debugWorldSynch, config.getBool("DebugWorldSynch","false"));
+    SystemFlags::setDebugEnabled(SystemFlags::debugUnitCommands, config.getBool("DebugUnitCommands","false"));
+    SystemFlags::setDebugEnabled(SystemFlags::debugPathFinder, config.getBool("DebugPathFinder","false"));
+    SystemFlags::setDebugEnabled(SystemFlags::debugLUA, config.getBool("DebugLUA","false"));
     LuaScript::setDebugModeEnabled(SystemFlags::getSystemSettingType(SystemFlags::debugLUA).enabled);
-    SystemFlags::getSystemSettingType(SystemFlags::debugSound).enabled  		= config.getBool("DebugSound","false");
-    SystemFlags::getSystemSettingType(SystemFlags::debugError).enabled  		= config.getBool("DebugError","true");
+    SystemFlags::setDebugEnabled(SystemFlags::debugSound, config.getBool("DebugSound","false"));
+    SystemFlags::setDebugEnabled(SystemFlags::debugError, config.getBool("DebugError","true"));
 
     string userData = config.getString("UserData_Root","");
     if(userData != "") {
@@ -3877,6 +3933,29 @@ int handleShowCRCValuesCommand(int argc, char** argv) {
 		}
 	}
 
+	else if(hasCommandArgument(argc, argv,GAME_ARGS[GAME_ARG_DIFF_SYNCH_SNAPSHOTS]) == true) {
+		int foundParamIndIndex = -1;
+		hasCommandArgument(argc, argv,string(GAME_ARGS[GAME_ARG_DIFF_SYNCH_SNAPSHOTS]) + string("="),&foundParamIndIndex);
+		if(foundParamIndIndex < 0) {
+			hasCommandArgument(argc, argv,string(GAME_ARGS[GAME_ARG_DIFF_SYNCH_SNAPSHOTS]),&foundParamIndIndex);
+		}
+
+		string paramValue = argv[foundParamIndIndex];
+		vector<string> paramPartTokens;
+		Tokenize(paramValue,paramPartTokens,"=");
+		if(paramPartTokens.size() >= 3 && paramPartTokens[1].length() > 0 && paramPartTokens[2].length() > 0) {
+			const int MAX_SNAPSHOT_DIFFERENCES = 500;
+			printf("%s",SynchSnapshotFile::diff(paramPartTokens[1],paramPartTokens[2],MAX_SNAPSHOT_DIFFERENCES).c_str());
+
+			return_value = 0;
+		}
+		else {
+			printf("\nInvalid missing snapshot files specified on commandline [%s]\n\n",argv[foundParamIndIndex]);
+
+			return_value = 1;
+		}
+	}
+
 	return return_value;
 }
 
@@ -4268,6 +4347,12 @@ int glestMain(int argc, char** argv) {
 		}
     }
 
+    if( hasCommandArgument(argc, argv,string(GAME_ARGS[GAME_ARG_BENCHMARK_REPLAY])) == true) {
+    	// the benchmark only simulates, there is nothing to show or type
+    	GlobalStaticFlags::setIsNonGraphicalModeEnabled(true);
+    	disableheadless_console = true;
+    }
+
 	if(hasCommandArgument(argc, argv,GAME_ARGS[GAME_ARG_SERVER_TITLE]) == true) {
 		int foundParamIndIndex = -1;
 		hasCommandArgument(argc, argv,string(GAME_ARGS[GAME_ARG_SERVER_TITLE]) + string("="),&foundParamIndIndex);
@@ -4739,7 +4824,8 @@ int glestMain(int argc, char** argv) {
         }
 
 	    if( hasCommandArgument(argc, argv,GAME_ARGS[GAME_ARG_DISABLE_SOUND]) == true ||
-	    	hasCommandArgument(argc, argv,string(GAME_ARGS[GAME_ARG_MASTERSERVER_MODE])) == true) {
+	    	hasCommandArgument(argc, argv,string(GAME_ARGS[GAME_ARG_MASTERSERVER_MODE])) == true ||
+	    	hasCommandArgument(argc, argv,string(GAME_ARGS[GAME_ARG_BENCHMARK_REPLAY])) == true) {
 	    	config.setString("FactorySound","None",true);
 	    	if(hasCommandArgument(argc, argv,string(GAME_ARGS[GAME_ARG_MASTERSERVER_MODE])) == true) {
 	    		//Logger::getInstance().setMasterserverMode(true);
@@ -4984,6 +5070,20 @@ int glestMain(int argc, char** argv) {
 		InterpolationData::setEnableInterpolation(false);
 		if(SystemFlags::VERBOSE_MODE_ENABLED) printf("**INFO** Disabling Interpolation\n");
 	}
+	if(config.getBool("DisableSimdInterpolation","false") == true) {
+		InterpolationData::setEnableSimd(false);
+		if(SystemFlags::VERBOSE_MODE_ENABLED) printf("**INFO** Disabling SIMD Interpolation\n");
+	}
+	if(config.getBool("NormalizeInterpolatedNormals","false") == true) {
+		InterpolationData::setNormalizeNormals(true);
+	}
+	InterpolationData::setFrameCacheStep(config.getFloat("AnimationFrameCacheStep","0.005"));
+	InterpolationData::setFrameCacheMemoryBudget((int64)config.getInt("AnimationFrameCacheMB","32") * 1024 * 1024);
+
+	ZoneProfiler::setThreadName("Main");
+	if(config.getBool("ProfilerEnabled","false") == true) {
+		ZoneProfiler::start();
+	}
 
 
         if(config.getBool("EnableVSynch","false") == true) {
@@ -5091,6 +5191,59 @@ int glestMain(int argc, char** argv) {
 			}
 		}
 
+		if(hasCommandArgument(argc, argv,string(GAME_ARGS[GAME_ARG_BENCHMARK_REPLAY])) == true) {
+			int foundParamIndIndex = -1;
+			hasCommandArgument(argc, argv,string(GAME_ARGS[GAME_ARG_BENCHMARK_REPLAY]) + string("="),&foundParamIndIndex);
+			if(foundParamIndIndex < 0) {
+				hasCommandArgument(argc, argv,string(GAME_ARGS[GAME_ARG_BENCHMARK_REPLAY]),&foundParamIndIndex);
+			}
+			string paramValue = argv[foundParamIndIndex];
+			vector<string> paramPartTokens;
+			Tokenize(paramValue,paramPartTokens,"=");
+			vector<string> paramPartTokens2;
+			if(paramPartTokens.size() >= 2) {
+				Tokenize(paramPartTokens[1],paramPartTokens2,",");
+			}
+			if(paramPartTokens2.empty() == true || paramPartTokens2[0].length() == 0) {
+				printf("\nInvalid replay specified on commandline [%s] replay file is missing\n\n",argv[foundParamIndIndex]);
+				printParameterHelp(argv[0],false);
+				return 1;
+			}
+
+			// the game loads the commands from <saved game>.replay
+			string replayFile = paramPartTokens2[0];
+			const string replayExtension = ".replay";
+			if(EndsWith(replayFile,replayExtension) == true) {
+				replayFile = replayFile.substr(0,replayFile.length() - replayExtension.length());
+			}
+			if(fileExists(replayFile + replayExtension) == false) {
+				char szBuf[8096]="";
+				snprintf(szBuf,8096,"File specified for the benchmark cannot be found: [%s]",(replayFile + replayExtension).c_str());
+				printf("\n\n======================================================================================\n%s\n======================================================================================\n\n\n",szBuf);
+
+				throw megaglest_runtime_error(szBuf);
+			}
+
+			SimulationBenchmark::setEnabled(true);
+			SimulationBenchmark::setReplayFile(replayFile);
+			if(paramPartTokens2.size() >= 2 && paramPartTokens2[1].length() > 0) {
+				SimulationBenchmark::setMaxFrames(strToInt(paramPartTokens2[1]));
+			}
+			if(paramPartTokens2.size() >= 3 && paramPartTokens2[2].length() > 0) {
+				SimulationBenchmark::setExpectedCRC(strToUInt(paramPartTokens2[2]));
+			}
+			if(paramPartTokens2.size() >= 4 && paramPartTokens2[3].length() > 0) {
+				if(paramPartTokens2[3] != "pool" && paramPartTokens2[3] != "serial") {
+					printf("\nInvalid unit precache mode specified on commandline [%s] use pool or serial\n\n",paramPartTokens2[3].c_str());
+					printParameterHelp(argv[0],false);
+					return 1;
+				}
+				Config::getInstance().setBool("EnableTaskPoolPreprocessing",paramPartTokens2[3] == "pool",true);
+			}
+			Config::getInstance().setBool("SaveCommandsForReplay",true,true);
+			printf("Running in simulation benchmark mode using replay [%s]\n",replayFile.c_str());
+		}
+
     	Renderer &renderer= Renderer::getInstance();
         lang.loadGameStrings(language,false, true);
 
@@ -5159,7 +5312,8 @@ int glestMain(int argc, char** argv) {
     		hasCommandArgument(argc, argv,GAME_ARGS[GAME_ARG_SHOW_TILESET_CRC]) == true ||
     		hasCommandArgument(argc, argv,GAME_ARGS[GAME_ARG_SHOW_TECHTREE_CRC]) == true ||
     		hasCommandArgument(argc, argv,GAME_ARGS[GAME_ARG_SHOW_SCENARIO_CRC]) == true ||
-    		hasCommandArgument(argc, argv,GAME_ARGS[GAME_ARG_SHOW_PATH_CRC]) == true) {
+    		hasCommandArgument(argc, argv,GAME_ARGS[GAME_ARG_SHOW_PATH_CRC]) == true ||
+    		hasCommandArgument(argc, argv,GAME_ARGS[GAME_ARG_DIFF_SYNCH_SNAPSHOTS]) == true) {
     		return handleShowCRCValuesCommand(argc, argv);
     	}
 
@@ -5214,7 +5368,11 @@ int glestMain(int argc, char** argv) {
         GameSettings startupGameSettings;
 
 		//parse command line
-		if(hasCommandArgument(argc, argv,GAME_ARGS[GAME_ARG_SERVER]) == true) {
+		if(SimulationBenchmark::isEnabled() == true) {
+			program->initSavedGame(mainWindow,true,SimulationBenchmark::getReplayFile());
+			gameInitialized = true;
+		}
+		else if(hasCommandArgument(argc, argv,GAME_ARGS[GAME_ARG_SERVER]) == true) {
 			program->initServer(mainWindow,false,true);
 			gameInitialized = true;
 		}
@@ -5655,7 +5813,8 @@ int glestMain(int argc, char** argv) {
 #endif
 		}
 
-	    if(GlobalStaticFlags::getIsNonGraphicalModeEnabled() == true) {
+	    if(GlobalStaticFlags::getIsNonGraphicalModeEnabled() == true &&
+	    	SimulationBenchmark::isEnabled() == false) {
 	    	printf("Headless server is now running...\n");
 	    	printf("To shutdown type: quit\n");
 	    	printf("All commands require you to press ENTER\n");
@@ -5728,6 +5887,9 @@ int glestMain(int argc, char** argv) {
 							if(command == "quit") {
 								break;
 							}
+							else if(command == "profile") {
+								ZoneProfiler::requestToggle();
+							}
 
 #ifndef WIN32
 							if (cinfd[0].revents & POLLNVAL) {
@@ -5753,6 +5915,7 @@ int glestMain(int argc, char** argv) {
 				//printf("looping\n");
 			}
 
+			updateZoneProfiler();
 			program->loop();
 
 			// Because OpenGL really doesn't do multi-threading well
@@ -5770,10 +5933,16 @@ int glestMain(int argc, char** argv) {
 //			}
 		}
 
-	    if(GlobalStaticFlags::getIsNonGraphicalModeEnabled() == true) {
+	    if(GlobalStaticFlags::getIsNonGraphicalModeEnabled() == true &&
+	    	SimulationBenchmark::isEnabled() == false) {
 	    	printf("\nHeadless server is about to quit...\n");
 	    }
 
+		if(ZoneProfiler::isEnabled() == true) {
+			ZoneProfiler::stop();
+			exportZoneProfile();
+		}
+
 		if(SystemFlags::VERBOSE_MODE_ENABLED) printf("In [%s::%s Line: %d] starting normal application shutdown\n",__FILE__,__FUNCTION__,__LINE__);
 
 		if(GlobalStaticFlags::getIsNonGraphicalModeEnabled() == false) {
@@ -5913,7 +6082,7 @@ int glestMain(int argc, char** argv) {
 	if(SystemFlags::VERBOSE_MODE_ENABLED) printf("In [%s::%s Line: %d]\n",__FILE__,__FUNCTION__,__LINE__);
 	SystemFlags::OutputDebug(SystemFlags::debugSystem,"In [%s::%s Line: %d]\n",__FILE__,__FUNCTION__,__LINE__);
 
-	return 0;
+	return SimulationBenchmark::getExitCode();
 }
 
 #if defined(__GNUC__)  && !defined(__FreeBSD__) && !defined(BSD)
@@ -5927,6 +6096,12 @@ void handleSIGSEGV(int sig) {
 }
 #endif
 
+#if defined(__GNUC__) && !defined(__MINGW32__) && !defined(__FreeBSD__) && !defined(BSD)
+void handleSIGUSR1(int sig) {
+	ZoneProfiler::requestToggle();
+}
+#endif
+
 #if defined(HAVE_GOOGLE_BREAKPAD)
 
 #if defined(WIN32)
@@ -6008,6 +6183,8 @@ __try {
 	if(hasCommandArgument(argc, argv,string(GAME_ARGS[GAME_ARG_DISABLE_SIGSEGV_HANDLER])) == false) {
 		signal(SIGSEGV, handleSIGSEGV);
 	}
+	// kill -USR1 starts or stops a profiler capture, handy for headless servers
+	signal(SIGUSR1, handleSIGUSR1);
 
     // http://developerweb.net/viewtopic.php?id=3013
     //signal(SIGPIPE, SIG_IGN);
@@ -28,6 +28,7 @@
 #include "menu_state_custom_game.h"
 #include "menu_state_join_game.h"
 #include "menu_state_scenario.h"
+#include "zone_profiler.h"
 #include "leak_dumper.h"
 
 using namespace Shared::Util;
@@ -394,6 +395,7 @@ void Program::loop() {
 }
 
 void Program::loopWorker() {
+	PROFILE_ZONE("Program::loopWorker");
 	if(SystemFlags::getSystemSettingType(SystemFlags::debugPerformance).enabled) SystemFlags::OutputDebug(SystemFlags::debugPerformance,"In [%s::%s Line: %d] ================================= MAIN LOOP START ================================= \n",extractFileFromDirectoryPath(__FILE__).c_str(),__FUNCTION__,__LINE__);
 
 	//Renderer &renderer= Renderer::getInstance();
@@ -3776,9 +3776,20 @@ void MenuStateConnectedGame::update() {
 			if(SystemFlags::getSystemSettingType(SystemFlags::debugPerformance).enabled && chrono.getMillis() > 0) SystemFlags::OutputDebug(SystemFlags::debugPerformance,"In [%s::%s Line: %d] took msecs: %lld\n",extractFileFromDirectoryPath(__FILE__).c_str(),__FUNCTION__,__LINE__,chrono.getMillis());
 			if(SystemFlags::getSystemSettingType(SystemFlags::debugPerformance).enabled && chrono.getMillis() > 0) chrono.start();
 
-			// check if we are joining an in progress game
+			// check if we are joining an in progress game, the server streams
+			// the game state over the game socket unless it sent a saved game
 			if( clientInterface->getJoinGameInProgress() == true &&
 				clientInterface->getJoinGameInProgressLaunch() == true &&
+				clientInterface->getJoinGameSnapshotReceived() == true) {
+
+				GameSettings gameSettings = *clientInterface->getGameSettings();
+				copyToGameSettings(&gameSettings);
+
+				Game::loadJoinGameSnapshot(clientInterface->getJoinGameSnapshot(),program,&gameSettings);
+				return;
+			}
+			else if( clientInterface->getJoinGameInProgress() == true &&
+				clientInterface->getJoinGameInProgressLaunch() == true &&
 			    clientInterface->getReadyForInGameJoin() == true &&
 			   ftpClientThread != NULL) {
 
@@ -223,6 +223,7 @@ void MenuStateLoadGame::mouseClick(int x, int y, MouseButton mouseButton){
 			string filename 	= saveGameDir + selectedButton->getText() + ".xml";
 			string jpgfilename 	= saveGameDir + selectedButton->getText() + ".xml.jpg";
 			string replayfilename 	= saveGameDir + selectedButton->getText() + ".xml.replay";
+			string debugfilename 	= saveGameDir + selectedButton->getText() + ".xml.debug";
 
 			Lang &lang= Lang::getInstance();
 			char szBuf[8096]="";
@@ -234,6 +235,7 @@ void MenuStateLoadGame::mouseClick(int x, int y, MouseButton mouseButton){
 					if(removeFile(filename) == true) {
 						removeFile(jpgfilename);
 						removeFile(replayfilename);
+						removeFile(debugfilename);
 						cleanupTexture(&previewTexture);
 
 						infoTextLabel.setText("");
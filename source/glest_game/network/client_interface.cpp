@@ -200,6 +200,10 @@ ClientInterface::ClientInterface() : GameNetworkInterface() {
 	this->joinGameInProgressLaunch 		= false;
 	this->readyForInGameJoin 			= false;
 	this->resumeInGameJoin 				= false;
+	this->joinGameSnapshotReceived 		= false;
+	this->joinGameFromSnapshot 			= false;
+	this->joinGameSnapshotFrameCount 	= -1;
+	this->joinGameSnapshotTotalSize 	= 0;
 
 	quitThreadAccessor 					= new Mutex(CODE_AT_LINE);
 	setQuitThread(false);
@@ -383,6 +387,55 @@ bool ClientInterface::getResumeInGameJoin() {
 	return resumeInGameJoin;
 }
 
+bool ClientInterface::getJoinGameSnapshotReceived() {
+	MutexSafeWrapper safeMutex(flagAccessor,CODE_AT_LINE);
+	return joinGameSnapshotReceived;
+}
+
+void ClientInterface::receiveJoinGameSnapshotChunk() {
+	NetworkMessageJoinGameSnapshot networkMessageJoinGameSnapshot;
+	if(receiveMessage(&networkMessageJoinGameSnapshot) == false) {
+		throw megaglest_runtime_error("error retrieving nmtJoinGameSnapshot returned false!");
+	}
+	this->setLastPingInfoToNow();
+
+	// the sizes come off the wire, check them before allocating anything
+	if(networkMessageJoinGameSnapshot.getOffset() == 0) {
+		if(networkMessageJoinGameSnapshot.getTotalSize() > NetworkMessageJoinGameSnapshot::maxTotalSize) {
+			char szBuf[1024]="";
+			snprintf(szBuf,1023,"Join game snapshot of %u bytes exceeds the maximum of %u",networkMessageJoinGameSnapshot.getTotalSize(),NetworkMessageJoinGameSnapshot::maxTotalSize);
+			throw megaglest_runtime_error(szBuf);
+		}
+		joinGameSnapshot.clear();
+		joinGameSnapshot.reserve(networkMessageJoinGameSnapshot.getTotalSize());
+		joinGameSnapshotFrameCount = networkMessageJoinGameSnapshot.getFrameCount();
+		joinGameSnapshotTotalSize = networkMessageJoinGameSnapshot.getTotalSize();
+	}
+	else if(networkMessageJoinGameSnapshot.getFrameCount() != joinGameSnapshotFrameCount ||
+			networkMessageJoinGameSnapshot.getTotalSize() != joinGameSnapshotTotalSize) {
+		char szBuf[1024]="";
+		snprintf(szBuf,1023,"Join game snapshot chunk for frame %d of %u bytes, expected frame %d of %u bytes",networkMessageJoinGameSnapshot.getFrameCount(),networkMessageJoinGameSnapshot.getTotalSize(),joinGameSnapshotFrameCount,joinGameSnapshotTotalSize);
+		throw megaglest_runtime_error(szBuf);
+	}
+	const vector<unsigned char> &chunk = networkMessageJoinGameSnapshot.getChunk();
+	if(networkMessageJoinGameSnapshot.getOffset() != joinGameSnapshot.size() ||
+		chunk.size() > joinGameSnapshotTotalSize - joinGameSnapshot.size()) {
+		char szBuf[1024]="";
+		snprintf(szBuf,1023,"Join game snapshot chunk at offset %u of %u bytes, expected offset %u of %u bytes",networkMessageJoinGameSnapshot.getOffset(),(uint32)chunk.size(),(uint32)joinGameSnapshot.size(),joinGameSnapshotTotalSize);
+		throw megaglest_runtime_error(szBuf);
+	}
+	joinGameSnapshot.insert(joinGameSnapshot.end(),chunk.begin(),chunk.end());
+
+	if(SystemFlags::getSystemSettingType(SystemFlags::debugNetwork).enabled) SystemFlags::OutputDebug(SystemFlags::debugNetwork,"In [%s::%s Line: %d] got nmtJoinGameSnapshot frame = %d, " MG_SIZE_T_SPECIFIER " / %u bytes\n",extractFileFromDirectoryPath(__FILE__).c_str(),__FUNCTION__,__LINE__,networkMessageJoinGameSnapshot.getFrameCount(),joinGameSnapshot.size(),networkMessageJoinGameSnapshot.getTotalSize());
+
+	if(joinGameSnapshot.size() == joinGameSnapshotTotalSize) {
+		MutexSafeWrapper safeMutexFlags(flagAccessor,CODE_AT_LINE);
+		this->joinGameSnapshotReceived 	= true;
+		this->joinGameFromSnapshot 		= true;
+		this->readyForInGameJoin 		= true;
+	}
+}
+
 void ClientInterface::connect(const Ip &ip, int port) {
 	if(SystemFlags::getSystemSettingType(SystemFlags::debugNetwork).enabled) SystemFlags::OutputDebug(SystemFlags::debugNetwork,"In [%s::%s] START\n",extractFileFromDirectoryPath(__FILE__).c_str(),__FUNCTION__);
 
@@ -1010,6 +1063,10 @@ void ClientInterface::updateLobby() {
 		}
 		break;
 
+		case nmtJoinGameSnapshot:
+			receiveJoinGameSnapshotChunk();
+			break;
+
 		case nmtCommandList:
 			{
 
@@ -1861,8 +1918,14 @@ void ClientInterface::waitUntilReady(Checksum* checksum) {
 			}
     	}
 
-		this->resumeInGameJoin = true;
+		// a game joined from a snapshot never paused, there is nothing to resume
+		this->resumeInGameJoin = (this->joinGameFromSnapshot == false);
+		this->joinGameFromSnapshot = false;
+		this->joinGameSnapshotReceived = false;
 		safeMutexFlags2.ReleaseLock();
+
+		// the game was loaded from it by now
+		vector<unsigned char>().swap(joinGameSnapshot);
 	}
 	else {
 		safeMutexFlags2.ReleaseLock();
@@ -2066,6 +2129,10 @@ void ClientInterface::close(bool lockMutex) {
 	this->joinGameInProgress 		= false;
 	this->joinGameInProgressLaunch 	= false;
 	this->readyForInGameJoin 		= false;
+	this->joinGameSnapshotReceived 	= false;
+	this->joinGameFromSnapshot 		= false;
+	this->joinGameSnapshotFrameCount = -1;
+	this->joinGameSnapshotTotalSize = 0;
 
 	if(SystemFlags::getSystemSettingType(SystemFlags::debugNetwork).enabled) SystemFlags::OutputDebug(SystemFlags::debugNetwork,"In [%s::%s Line: %d] END\n",extractFileFromDirectoryPath(__FILE__).c_str(),__FUNCTION__,__LINE__);
 }
@@ -2178,6 +2245,11 @@ bool ClientInterface::shouldDiscardNetworkMessage(NetworkMessageType networkMess
 			}
 			break;
 
+        case nmtJoinGameSnapshot:
+			discard = true;
+			receiveJoinGameSnapshotChunk();
+			break;
+
 		case nmtSynchNetworkGameData:
 			{
 			discard = true;
@@ -99,6 +99,14 @@ private:
 	bool readyForInGameJoin;
 	bool resumeInGameJoin;
 
+	// world snapshot streamed by the server when joining a game in progress
+	vector<unsigned char> joinGameSnapshot;
+	// header of the chunk at offset 0, every later chunk must match it
+	int joinGameSnapshotFrameCount;
+	uint32 joinGameSnapshotTotalSize;
+	bool joinGameSnapshotReceived;
+	bool joinGameFromSnapshot;
+
 	Mutex *quitThreadAccessor;
 	bool quitThread;
 
@@ -123,6 +131,9 @@ public:
 	bool getResumeInGameJoin();
 	void sendResumeGameMessage();
 
+	bool getJoinGameSnapshotReceived();
+	const vector<unsigned char> & getJoinGameSnapshot() const { return joinGameSnapshot; }
+
 	uint64 getCachedLastPendingFrameCount();
 	int64 getTimeClientWaitedForLastMessage();
 
@@ -193,6 +204,7 @@ protected:
 	Mutex * getServerSynchAccessor() { return NULL; }
 	NetworkMessageType waitForMessage(int waitMicroseconds=0);
 	bool shouldDiscardNetworkMessage(NetworkMessageType networkMessageType);
+	void receiveJoinGameSnapshotChunk();
 
 	void updateFrame(int *checkFrame);
 	void shutdownNetworkCommandListThread(MutexSafeWrapper &safeMutexWrapper);
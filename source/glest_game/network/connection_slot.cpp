@@ -17,6 +17,8 @@
 #include "server_interface.h"
 #include "network_message.h"
 #include "platform_util.h"
+#include "checksum_index.h"
+#include "zone_profiler.h"
 #include <stdexcept>
 
 #include "leak_dumper.h"
@@ -92,6 +94,10 @@ void ConnectionSlotThread::setTaskCompleted(int eventId) {
 		    ConnectionSlotEvent &slotEvent = eventList[index];
 		    if(slotEvent.eventId == eventId) {
                 slotEvent.eventCompleted = true;
+                if(slotEvent.completionLatch != NULL) {
+                	slotEvent.completionLatch->countDown(slotEvent.completionLatchGeneration);
+                	slotEvent.completionLatch = NULL;
+                }
                 break;
 		    }
 		}
@@ -109,6 +115,10 @@ void ConnectionSlotThread::setAllEventsCompleted() {
         ConnectionSlotEvent &slotEvent = eventList[index];
         if(slotEvent.eventCompleted == false) {
             slotEvent.eventCompleted = true;
+            if(slotEvent.completionLatch != NULL) {
+            	slotEvent.completionLatch->countDown(slotEvent.completionLatchGeneration);
+            	slotEvent.completionLatch = NULL;
+            }
         }
     }
 }
@@ -151,6 +161,7 @@ bool ConnectionSlotThread::isSignalCompleted(ConnectionSlotEvent *event) {
 
 void ConnectionSlotThread::slotUpdateTask(ConnectionSlotEvent *event) {
 	if(event != NULL && event->connectionSlot != NULL) {
+		PROFILE_ZONE("ConnectionSlotThread::slotUpdateTask");
 		if(event->eventType == eSendSocketData) {
 			event->connectionSlot->sendMessage(event->networkMessage);
 		}
@@ -186,6 +197,7 @@ void ConnectionSlotThread::execute() {
 	try {
 		if(SystemFlags::getSystemSettingType(SystemFlags::debugNetwork).enabled) SystemFlags::OutputDebug(SystemFlags::debugNetwork,"In [%s::%s Line: %d]\n",__FILE__,__FUNCTION__,__LINE__);
 		//printf("Starting client SLOT thread: %d\n",slotIndex);
+		ZoneProfiler::setThreadName("Connection slot " + intToStr(slotIndex));
 
 		for(;this->slotInterface != NULL;) {
 			if(getQuitStatus() == true) {
@@ -383,6 +395,12 @@ ConnectionSlot::ConnectionSlot(ServerInterface* serverInterface, int playerIndex
 	this->pauseForInGameConnection 			= false;
 	this->unPauseForInGameConnection 		= false;
 	this->sentSavedGameInfo 				= false;
+	this->joinGameSnapshotPending 			= false;
+	this->joinGameSnapshotStartTime 		= 0;
+	this->joinGameSnapshotMaxCommandLists 	= 0;
+	this->joinGameSnapshotMaxSeconds 		= 0;
+	this->joinGameSnapshotExpired 			= false;
+	this->joinGameCatchingUp 				= false;
 
 	this->ready								= false;
 	this->gotIntro 							= false;
@@ -816,6 +834,16 @@ void ConnectionSlot::update(bool checkForNewClients,int lockedSlotIndex) {
 									currentFrameCount = networkMessageCommandList.getFrameCount();
 									lastReceiveCommandListTime = time(NULL);
 
+									// a client joined from a snapshot is lag checked again once it
+									// has fast forwarded to within a couple of keyframes of us
+									if(joinGameCatchingUp == true) {
+										int networkFramePeriod = this->serverInterface->getGameSettings()->getNetworkFramePeriod();
+										if(currentFrameCount + networkFramePeriod * 2 >= serverInterface->getCurrentFrameCount()) {
+											joinGameCatchingUp = false;
+											skipLagCheck = false;
+										}
+									}
+
 									if(SystemFlags::getSystemSettingType(SystemFlags::debugNetwork).enabled) SystemFlags::OutputDebug(SystemFlags::debugNetwork,"In [%s::%s Line: %d] currentFrameCount = %d\n",__FILE__,__FUNCTION__,__LINE__,currentFrameCount);
 
 									MutexSafeWrapper safeMutexSlot(mutexPendingNetworkCommandList,CODE_AT_LINE);
@@ -1161,22 +1189,45 @@ void ConnectionSlot::update(bool checkForNewClients,int lockedSlotIndex) {
 												}
 											}
 											if(networkGameDataSynchCheckOkTech == false) {
+												vector<std::pair<string,uint32> > vctTechFileList;
 												if(techCRC == 0) {
-													vctFileList = getFolderTreeContentsCheckSumListRecursively(config.getPathListForType(ptTechs,scenarioDir),"/" + serverInterface->getGameSettings()->getTech() + "/*", "", &vctFileList);
+													vctTechFileList = getFolderTreeContentsCheckSumListRecursively(config.getPathListForType(ptTechs,scenarioDir),"/" + serverInterface->getGameSettings()->getTech() + "/*", "", NULL);
 												}
 												else {
-													vctFileList = getFolderTreeContentsCheckSumListRecursively(config.getPathListForType(ptTechs,scenarioDir),"/" + serverInterface->getGameSettings()->getTech() + "/*", ".xml", &vctFileList);
+													vctTechFileList = getFolderTreeContentsCheckSumListRecursively(config.getPathListForType(ptTechs,scenarioDir),"/" + serverInterface->getGameSettings()->getTech() + "/*", ".xml", NULL);
 												}
 
-												string report = networkMessageSynchNetworkGameDataStatus.getTechCRCFileMismatchReport(serverInterface->getGameSettings()->getTech(),vctFileList);
+												string report = networkMessageSynchNetworkGameDataStatus.getTechCRCFileMismatchReport(serverInterface->getGameSettings()->getTech(),vctTechFileList);
 												this->setNetworkGameDataSynchCheckTechMismatchReport(report);
+
+												// When the client sent the crc of all of its techtree files only
+												// the subtrees that differ are offered, not the whole techtree
+												if(techCRC != 0 &&
+													networkMessageSynchNetworkGameDataStatus.getTechCRCFileCount() > 0 &&
+													networkMessageSynchNetworkGameDataStatus.hasAllTechCRCFiles() == true) {
+													FileCRCTree localTree(vctTechFileList);
+													FileCRCTree remoteTree(networkMessageSynchNetworkGameDataStatus.getTechCRCFiles());
+
+													vector<string> differentFiles;
+													int foldersVisited = localTree.getDifferentFiles(remoteTree, differentFiles);
+
+													if(SystemFlags::getSystemSettingType(SystemFlags::debugNetwork).enabled) SystemFlags::OutputDebug(SystemFlags::debugNetwork,"In [%s::%s Line: %d] techtree files differing: %d of %d, folders compared: %d\n",__FILE__,__FUNCTION__,__LINE__,(int)differentFiles.size(),(int)vctTechFileList.size(),foldersVisited);
+
+													vctTechFileList.clear();
+													for(unsigned int idx = 0; idx < differentFiles.size(); ++idx) {
+														vctTechFileList.push_back(std::pair<string,uint32>(differentFiles[idx],localTree.getFileCRC(differentFiles[idx],NULL)));
+													}
+												}
+												vctFileList.insert(vctFileList.end(),vctTechFileList.begin(),vctTechFileList.end());
 											}
 											if(networkGameDataSynchCheckOkMap == false) {
 												vctFileList.push_back(std::pair<string,uint32>(Config::getMapPath(serverInterface->getGameSettings()->getMap(),scenarioDir,false),mapCRC));
 											}
 
-											NetworkMessageSynchNetworkGameDataFileCRCCheck networkMessageSynchNetworkGameDataFileCRCCheck((int)vctFileList.size(), 1, vctFileList[0].second, vctFileList[0].first);
-											sendMessage(&networkMessageSynchNetworkGameDataFileCRCCheck);
+											if(vctFileList.empty() == false) {
+												NetworkMessageSynchNetworkGameDataFileCRCCheck networkMessageSynchNetworkGameDataFileCRCCheck((int)vctFileList.size(), 1, vctFileList[0].second, vctFileList[0].first);
+												sendMessage(&networkMessageSynchNetworkGameDataFileCRCCheck);
+											}
 										}
 										else {
 											if(networkGameDataSynchCheckOkTech == false) {
@@ -1329,7 +1380,29 @@ void ConnectionSlot::update(bool checkForNewClients,int lockedSlotIndex) {
 							//printf("Got ready message from client slot joinGameInProgress = %d\n",joinGameInProgress);
 							if(joinGameInProgress == true) {
 								NetworkMessageReady networkMessageReady(0);
-								this->sendMessage(&networkMessageReady);
+								// the held back command lists must follow the reply
+								// without anything broadcast slipping in between
+								MutexSafeWrapper safeMutexSocket(socketSynchAccessor,CODE_AT_LINE);
+								bool joinedFromSnapshot = joinGameSnapshotPending;
+								if(joinedFromSnapshot == true) {
+									// the lists it needs were dropped, it can't catch up
+									if(joinGameSnapshotExpired == true) {
+										safeMutexSocket.ReleaseLock();
+										if(SystemFlags::getSystemSettingType(SystemFlags::debugNetwork).enabled) SystemFlags::OutputDebug(SystemFlags::debugNetwork,"In [%s::%s Line: %d] join game snapshot expired for slot: %d, disconnecting.\n",__FILE__,__FUNCTION__,__LINE__,this->playerIndex);
+										close();
+										return;
+									}
+									NetworkInterface::sendMessage(&networkMessageReady);
+									for(unsigned int i = 0; i < joinGameSnapshotCommandLists.size(); ++i) {
+										NetworkInterface::sendMessage(&joinGameSnapshotCommandLists[i]);
+									}
+									vector<NetworkMessageCommandList>().swap(joinGameSnapshotCommandLists);
+									joinGameSnapshotPending = false;
+								}
+								safeMutexSocket.ReleaseLock();
+								if(joinedFromSnapshot == false) {
+									this->sendMessage(&networkMessageReady);
+								}
 								this->setGameStarted(true);
 
 								this->currentFrameCount = serverInterface->getCurrentFrameCount();
@@ -1339,6 +1412,10 @@ void ConnectionSlot::update(bool checkForNewClients,int lockedSlotIndex) {
 								this->lastReceiveCommandListTime = time(NULL);
 
 								this->setReady();
+								if(joinedFromSnapshot == true) {
+									this->skipLagCheck = true;
+									this->joinGameCatchingUp = true;
+								}
 							}
 							// unpause the game
 							else {
@@ -1475,6 +1552,41 @@ void ConnectionSlot::setJoinGameInProgressFlags() {
 	this->sentSavedGameInfo 	= false;
 }
 
+void ConnectionSlot::startJoinGameSnapshot() {
+	Config &config = Config::getInstance();
+	MutexSafeWrapper safeMutex(socketSynchAccessor,CODE_AT_LINE);
+	this->joinGameSnapshotCommandLists.clear();
+	this->joinGameSnapshotPending 			= true;
+	this->joinGameSnapshotStartTime 		= time(NULL);
+	this->joinGameSnapshotMaxCommandLists 	= config.getInt("JoinInProgressSnapshotMaxCommandLists","2400");
+	this->joinGameSnapshotMaxSeconds 		= config.getInt("JoinInProgressSnapshotMaxSeconds","120");
+	this->joinGameSnapshotExpired 			= false;
+}
+
+bool ConnectionSlot::getJoinGameSnapshotPending() {
+	MutexSafeWrapper safeMutex(socketSynchAccessor,CODE_AT_LINE);
+	return joinGameSnapshotPending;
+}
+
+bool ConnectionSlot::isJoinGameSnapshotExpired() {
+	MutexSafeWrapper safeMutex(socketSynchAccessor,CODE_AT_LINE);
+	if(joinGameSnapshotPending == true && joinGameSnapshotExpired == false &&
+		joinGameSnapshotMaxSeconds > 0 &&
+		difftime((long int)time(NULL),joinGameSnapshotStartTime) > joinGameSnapshotMaxSeconds) {
+		joinGameSnapshotExpired = true;
+	}
+	return joinGameSnapshotExpired;
+}
+
+bool ConnectionSlot::sendJoinGameSnapshotChunk(NetworkMessage *networkMessage) {
+	MutexSafeWrapper safeMutex(socketSynchAccessor,CODE_AT_LINE);
+	if(joinGameSnapshotPending == false || joinGameSnapshotExpired == true) {
+		return false;
+	}
+	NetworkInterface::sendMessage(networkMessage);
+	return true;
+}
+
 void ConnectionSlot::close() {
 	if(SystemFlags::getSystemSettingType(SystemFlags::debugNetwork).enabled) SystemFlags::OutputDebug(SystemFlags::debugNetwork,"In [%s::%s LINE: %d]\n",__FILE__,__FUNCTION__,__LINE__);
 
@@ -1490,9 +1602,16 @@ void ConnectionSlot::close() {
 	this->sentSavedGameInfo 			= false;
 	this->pauseForInGameConnection 		= false;
 	this->unPauseForInGameConnection 	= false;
+	this->joinGameCatchingUp 			= false;
 	this->ready							= false;
 	this->connectedTime 				= 0;
 
+	MutexSafeWrapper safeMutexSocket(socketSynchAccessor,CODE_AT_LINE);
+	this->joinGameSnapshotPending 		= false;
+	this->joinGameSnapshotExpired 		= false;
+	this->joinGameSnapshotCommandLists.clear();
+	safeMutexSocket.ReleaseLock();
+
 	if(this->slotThreadWorker != NULL) {
 		if(SystemFlags::getSystemSettingType(SystemFlags::debugNetwork).enabled) SystemFlags::OutputDebug(SystemFlags::debugNetwork,"In [%s::%s Line: %d]\n",__FILE__,__FUNCTION__,__LINE__);
         this->slotThreadWorker->setAllEventsCompleted();
@@ -1554,6 +1673,23 @@ void ConnectionSlot::sendMessage(NetworkMessage* networkMessage) {
 		}
 	}
 
+	// Hold back lock step command lists while a joining client loads its snapshot,
+	// once too many piled up the client is dropped (see isJoinGameSnapshotExpired)
+	if(joinGameSnapshotPending == true) {
+		NetworkMessageCommandList *commandListMsg = dynamic_cast<NetworkMessageCommandList *>(networkMessage);
+		if(commandListMsg != NULL) {
+			if(joinGameSnapshotMaxCommandLists > 0 &&
+				(int)joinGameSnapshotCommandLists.size() >= joinGameSnapshotMaxCommandLists) {
+				joinGameSnapshotExpired = true;
+				vector<NetworkMessageCommandList>().swap(joinGameSnapshotCommandLists);
+			}
+			if(joinGameSnapshotExpired == false) {
+				joinGameSnapshotCommandLists.push_back(*commandListMsg);
+			}
+			return;
+		}
+	}
+
 	NetworkInterface::sendMessage(networkMessage);
 }
 
@@ -51,6 +51,8 @@ public:
 		socketTriggered = false;
 		eventCompleted = false;
 		eventId = -1;
+		completionLatch = NULL;
+		completionLatchGeneration = 0;
 	}
 
 	int64 triggerId;
@@ -60,6 +62,9 @@ public:
 	bool socketTriggered;
 	bool eventCompleted;
 	int64 eventId;
+	// counted down by the slot thread once the event is completed
+	CompletionLatch *completionLatch;
+	int completionLatchGeneration;
 };
 
 //
@@ -163,6 +168,19 @@ private:
 	bool unPauseForInGameConnection;
 	bool sentSavedGameInfo;
 
+	// command lists broadcast after a join snapshot was taken are held back
+	// until the joining client has loaded it and reports ready, guarded by
+	// socketSynchAccessor
+	bool joinGameSnapshotPending;
+	vector<NetworkMessageCommandList> joinGameSnapshotCommandLists;
+	// a client holding back more lists or taking longer is dropped
+	time_t joinGameSnapshotStartTime;
+	int joinGameSnapshotMaxCommandLists;
+	int joinGameSnapshotMaxSeconds;
+	bool joinGameSnapshotExpired;
+	// the client is fast forwarding through the held back lists
+	bool joinGameCatchingUp;
+
 	int autoPauseGameCountForLag;
 
 public:
@@ -190,6 +208,13 @@ public:
 	bool getSentSavedGameInfo() const { return sentSavedGameInfo; }
 	void setSentSavedGameInfo(bool value) { sentSavedGameInfo = value; }
 
+	void startJoinGameSnapshot();
+	bool getJoinGameSnapshotPending();
+	bool isJoinGameSnapshotExpired();
+	// Sends the chunk only while the client still waits for its snapshot
+	bool sendJoinGameSnapshotChunk(NetworkMessage *networkMessage);
+	bool getJoinGameCatchingUp() const { return joinGameCatchingUp; }
+
 	ConnectionSlotThread *getWorkerThread() { return slotThreadWorker; }
 
     void update(bool checkForNewClients,int lockedSlotIndex);
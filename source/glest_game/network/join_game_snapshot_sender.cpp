@@ -0,0 +1,161 @@
+// ==============================================================
+//	This file is part of MegaGlest (www.megaglest.org)
+//
+//	Copyright (C) 2026 The MegaGlest Team
+//
+//	You can redistribute this code and/or modify it under
+//	the terms of the GNU General Public License as published
+//	by the Free Software Foundation; either version 2 of the
+//	License, or (at your option) any later version
+// ==============================================================
+
+#include "join_game_snapshot_sender.h"
+
+#include "server_interface.h"
+#include "platform_common.h"
+#include "platform_util.h"
+#include "conversion.h"
+#include "zone_profiler.h"
+#include "util.h"
+#include "leak_dumper.h"
+
+using namespace Shared::Platform;
+using namespace Shared::PlatformCommon;
+using namespace Shared::Util;
+
+namespace Glest{ namespace Game{
+
+// =====================================================
+// 	class JoinGameSnapshotSender
+// =====================================================
+
+JoinGameSnapshotSender::JoinGameSnapshotSender(ServerInterface *server) : BaseThread() {
+	this->server = server;
+	this->jobsMutex = new Mutex(CODE_AT_LINE);
+	uniqueID = "JoinGameSnapshotSender";
+}
+
+JoinGameSnapshotSender::~JoinGameSnapshotSender() {
+	for(unsigned int i = 0; i < jobs.size(); ++i) {
+		delete jobs[i].xmlTree;
+	}
+	jobs.clear();
+
+	delete this->jobsMutex;
+	this->jobsMutex = NULL;
+}
+
+void JoinGameSnapshotSender::setQuitStatus(bool value) {
+	if(SystemFlags::isDebugEnabled(SystemFlags::debugSystem)) SystemFlags::OutputDebug(SystemFlags::debugSystem,"In [%s::%s] Line: %d value = %d\n",__FILE__,__FUNCTION__,__LINE__,value);
+
+	BaseThread::setQuitStatus(value);
+	if(value == true) {
+		semTaskSignalled.signal();
+	}
+}
+
+bool JoinGameSnapshotSender::canShutdown(bool deleteSelfIfShutdownDelayed) {
+	bool ret = (getExecutingTask() == false);
+	if(ret == false && deleteSelfIfShutdownDelayed == true) {
+	    setDeleteSelfOnExecutionDone(deleteSelfIfShutdownDelayed);
+	    deleteSelfIfRequired();
+	    signalQuit();
+	}
+
+	return ret;
+}
+
+void JoinGameSnapshotSender::queue(XmlTree *xmlTree, int frameCount, const vector<int> &playerIndexes) {
+	Job job;
+	job.xmlTree = xmlTree;
+	job.frameCount = frameCount;
+	job.playerIndexes = playerIndexes;
+
+	static string mutexOwnerId = string(__FILE__) + string("_") + intToStr(__LINE__);
+	MutexSafeWrapper safeMutex(jobsMutex,mutexOwnerId);
+	jobs.push_back(job);
+	safeMutex.ReleaseLock();
+
+	semTaskSignalled.signal();
+}
+
+void JoinGameSnapshotSender::send(Job &job) {
+	PROFILE_ZONE("JoinGameSnapshotSender::send");
+
+	vector<unsigned char> snapshot;
+	job.xmlTree->saveBinary(snapshot);
+	delete job.xmlTree;
+	job.xmlTree = NULL;
+
+	if(SystemFlags::VERBOSE_MODE_ENABLED) printf("Sending join game snapshot for frame %d, size = " MG_SIZE_T_SPECIFIER "\n",job.frameCount,snapshot.size());
+	if(snapshot.size() > NetworkMessageJoinGameSnapshot::maxTotalSize) {
+		// the waiting clients are dropped once their snapshot expires
+		throw megaglest_runtime_error("Join game snapshot of " + intToStr((int64)snapshot.size()) + " bytes is too large to send");
+	}
+
+	uint32 offset = 0;
+	do {
+		NetworkMessageJoinGameSnapshot networkMessage(job.frameCount, snapshot, offset);
+
+		bool stillWaiting = false;
+		for(unsigned int i = 0; i < job.playerIndexes.size(); ++i) {
+			int playerIndex = job.playerIndexes[i];
+
+			MutexSafeWrapper safeMutex(server->getSlotMutex(playerIndex),CODE_AT_LINE);
+			ConnectionSlot *slot = server->getSlot(playerIndex,false);
+			// a client that dropped, timed out or rejoined in the meantime gets nothing more
+			if(slot != NULL && slot->isConnected() == true &&
+				slot->sendJoinGameSnapshotChunk(&networkMessage) == true) {
+				stillWaiting = true;
+			}
+		}
+		if(stillWaiting == false) {
+			break;
+		}
+
+		offset += NetworkMessageJoinGameSnapshot::maxChunkSize;
+		// leave the sockets to the lock step traffic between chunks
+		sleep(0);
+	}
+	while(offset < snapshot.size() && getQuitStatus() == false);
+}
+
+void JoinGameSnapshotSender::execute() {
+	RunningStatusSafeWrapper runningStatus(this);
+
+	if(SystemFlags::VERBOSE_MODE_ENABLED) printf("In [%s::%s Line: %d] ****************** STARTING worker thread this = %p\n",__FILE__,__FUNCTION__,__LINE__,this);
+	ZoneProfiler::setThreadName("Join game snapshot sender");
+
+	for(;getQuitStatus() == false;) {
+		static string mutexOwnerId = string(__FILE__) + string("_") + intToStr(__LINE__);
+		MutexSafeWrapper safeMutex(jobsMutex,mutexOwnerId);
+		bool haveJob = (jobs.empty() == false);
+		Job job;
+		if(haveJob == true) {
+			job = jobs.front();
+			jobs.pop_front();
+		}
+		safeMutex.ReleaseLock();
+
+		if(haveJob == false) {
+			semTaskSignalled.waitTillSignalled();
+			continue;
+		}
+
+		ExecutingTaskSafeWrapper safeExecutingTaskMutex(this);
+		try {
+			send(job);
+		}
+		catch(const exception &ex) {
+			// the joining client times out and may try again, the game goes on
+			SystemFlags::OutputDebug(SystemFlags::debugError,"In [%s::%s Line: %d] Error sending join game snapshot: %s\n",__FILE__,__FUNCTION__,__LINE__,ex.what());
+			printf("**ERROR** Error sending join game snapshot: %s\n",ex.what());
+		}
+		delete job.xmlTree;
+	}
+
+	ZoneProfiler::releaseThreadBuffer();
+	if(SystemFlags::VERBOSE_MODE_ENABLED) printf("In [%s::%s Line: %d] ****************** ENDING worker thread this = %p\n",__FILE__,__FUNCTION__,__LINE__,this);
+}
+
+}}//end namespace
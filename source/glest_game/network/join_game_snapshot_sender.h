@@ -0,0 +1,75 @@
+// ==============================================================
+//	This file is part of MegaGlest (www.megaglest.org)
+//
+//	Copyright (C) 2026 The MegaGlest Team
+//
+//	You can redistribute this code and/or modify it under
+//	the terms of the GNU General Public License as published
+//	by the Free Software Foundation; either version 2 of the
+//	License, or (at your option) any later version
+// ==============================================================
+
+#ifndef _GLEST_GAME_JOINGAMESNAPSHOTSENDER_H_
+#define _GLEST_GAME_JOINGAMESNAPSHOTSENDER_H_
+
+#ifdef WIN32
+    #include <winsock2.h>
+    #include <winsock.h>
+#endif
+
+#include <deque>
+#include <vector>
+#include "base_thread.h"
+#include "xml_parser.h"
+#include "leak_dumper.h"
+
+using std::deque;
+using std::vector;
+using Shared::PlatformCommon::BaseThread;
+using Shared::Platform::Mutex;
+using Shared::Platform::Semaphore;
+using Shared::Xml::XmlTree;
+
+namespace Glest{ namespace Game{
+
+class ServerInterface;
+
+// =====================================================
+// 	class JoinGameSnapshotSender
+//
+///	Encodes the world snapshot for clients joining a game in
+///	progress and streams it to them in chunks over the game
+///	socket, while the server keeps simulating
+// =====================================================
+
+class JoinGameSnapshotSender : public BaseThread {
+private:
+	struct Job {
+		XmlTree *xmlTree;
+		int frameCount;
+		vector<int> playerIndexes;
+	};
+
+	ServerInterface *server;
+	Semaphore semTaskSignalled;
+	Mutex *jobsMutex;
+	deque<Job> jobs;
+
+	virtual void setQuitStatus(bool value);
+	virtual bool canShutdown(bool deleteSelfIfShutdownDelayed=false);
+
+	void send(Job &job);
+
+public:
+	explicit JoinGameSnapshotSender(ServerInterface *server);
+	virtual ~JoinGameSnapshotSender();
+	virtual void execute();
+
+	// Takes ownership of xmlTree, the snapshot taken at frameCount goes to
+	// the slots of playerIndexes that are still waiting for it
+	void queue(XmlTree *xmlTree, int frameCount, const vector<int> &playerIndexes);
+};
+
+}}//end namespace
+
+#endif
@@ -15,6 +15,7 @@
 #include "util.h"
 #include "game_settings.h"
 #include "checksum.h"
+#include "checksum_index.h"
 #include "platform_util.h"
 #include "config.h"
 #include "network_protocol.h"
@@ -2285,62 +2286,64 @@ NetworkMessageSynchNetworkGameData::NetworkMessageSynchNetworkGameData(const Gam
 	if(SystemFlags::getSystemSettingType(SystemFlags::debugNetwork).enabled) SystemFlags::OutputDebug(SystemFlags::debugNetwork,"In [%s::%s Line: %d] data.mapCRC = %d, [%s]\n",extractFileFromDirectoryPath(__FILE__).c_str(),__FUNCTION__,__LINE__, data.header.mapCRC,gameSettings->getMap().c_str());
 }
 
-string NetworkMessageSynchNetworkGameData::getTechCRCFileMismatchReport(vector<std::pair<string,uint32> > &vctFileList) {
-	string result = "Techtree: [" + data.header.tech.getString() + "] Filecount local: " + intToStr(vctFileList.size()) + " remote: " + intToStr(data.header.techCRCFileCount) + "\n";
+// Lists the techtree files that differ, only walking the folders whose
+// merkle sums differ on both sides
+static string getTechCRCFileMismatchReportForLists(const string &techtree,
+		const vector<std::pair<string,uint32> > &vctFileList,
+		const vector<std::pair<string,uint32> > &vctRemoteFileList) {
+	string result = "Techtree: [" + techtree + "] Filecount local: " + intToStr(vctFileList.size()) + " remote: " + intToStr(vctRemoteFileList.size()) + "\n";
 	if(vctFileList.size() <= 0) {
 		result = result + "Local player has no files.\n";
 	}
-	else if(data.header.techCRCFileCount <= 0) {
+	else if(vctRemoteFileList.size() <= 0) {
 		result = result + "Remote player has no files.\n";
 	}
 	else {
-		for(int idx = 0; idx < (int)vctFileList.size(); ++idx) {
-			std::pair<string,uint32> &fileInfo = vctFileList[idx];
-			bool fileFound = false;
-			uint32 remoteCRC = 0;
-			for(int j = 0; j < (int)data.header.techCRCFileCount; ++j) {
-				string networkFile = data.detail.techCRCFileList[j].getString();
-				uint32 &networkFileCRC = data.detail.techCRCFileCRCList[j];
-				if(fileInfo.first == networkFile) {
-					fileFound = true;
-					remoteCRC = networkFileCRC;
-					break;
-				}
-			}
+		FileCRCTree localTree(vctFileList);
+		FileCRCTree remoteTree(vctRemoteFileList);
 
+		vector<string> differentFiles;
+		localTree.getDifferentFiles(remoteTree, differentFiles);
+		for(unsigned int idx = 0; idx < differentFiles.size(); ++idx) {
+			bool fileFound = false;
+			remoteTree.getFileCRC(differentFiles[idx], &fileFound);
 			if(fileFound == false) {
-				result = result + "local file [" + fileInfo.first + "] missing remotely.\n";
+				result = result + "local file [" + differentFiles[idx] + "] missing remotely.\n";
 			}
-			else if(fileInfo.second != remoteCRC) {
-				result = result + "local file [" + fileInfo.first + "] CRC mismatch.\n";
+			else {
+				result = result + "local file [" + differentFiles[idx] + "] CRC mismatch.\n";
 			}
 		}
 
-		for(int i = 0; i < (int)data.header.techCRCFileCount; ++i) {
-			string networkFile = data.detail.techCRCFileList[i].getString();
-			uint32 &networkFileCRC = data.detail.techCRCFileCRCList[i];
+		differentFiles.clear();
+		remoteTree.getDifferentFiles(localTree, differentFiles);
+		for(unsigned int idx = 0; idx < differentFiles.size(); ++idx) {
 			bool fileFound = false;
-			uint32 localCRC = 0;
-			for(int idx = 0; idx < (int)vctFileList.size(); ++idx) {
-				std::pair<string,uint32> &fileInfo = vctFileList[idx];
-				if(networkFile == fileInfo.first) {
-					fileFound = true;
-					localCRC = fileInfo.second;
-					break;
-				}
-			}
-
+			localTree.getFileCRC(differentFiles[idx], &fileFound);
 			if(fileFound == false) {
-				result = result + "remote file [" + networkFile + "] missing locally.\n";
+				result = result + "remote file [" + differentFiles[idx] + "] missing locally.\n";
 			}
-			else if(networkFileCRC != localCRC) {
-				result = result + "remote file [" + networkFile + "] CRC mismatch.\n";
+			else {
+				result = result + "remote file [" + differentFiles[idx] + "] CRC mismatch.\n";
 			}
 		}
 	}
 	return result;
 }
 
+vector<std::pair<string,uint32> > NetworkMessageSynchNetworkGameData::getTechCRCFiles() const {
+	vector<std::pair<string,uint32> > result;
+	result.reserve(data.header.techCRCFileCount);
+	for(int idx = 0; idx < (int)data.header.techCRCFileCount; ++idx) {
+		result.push_back(std::pair<string,uint32>(data.detail.techCRCFileList[idx].getString(),data.detail.techCRCFileCRCList[idx]));
+	}
+	return result;
+}
+
+string NetworkMessageSynchNetworkGameData::getTechCRCFileMismatchReport(vector<std::pair<string,uint32> > &vctFileList) {
+	return getTechCRCFileMismatchReportForLists(data.header.tech.getString(), vctFileList, getTechCRCFiles());
+}
+
 const char * NetworkMessageSynchNetworkGameData::getPackedMessageFormatHeader() const {
 	return "c255s255s255sLLLL";
 }
@@ -2592,63 +2595,19 @@ NetworkMessageSynchNetworkGameDataStatus::NetworkMessageSynchNetworkGameDataStat
 	}
 }
 
-string NetworkMessageSynchNetworkGameDataStatus::getTechCRCFileMismatchReport(string techtree, vector<std::pair<string,uint32> > &vctFileList) {
-	string result = "Techtree: [" + techtree + "] Filecount local: " + intToStr(vctFileList.size()) + " remote: " + intToStr(data.header.techCRCFileCount) + "\n";
-	if(vctFileList.size() <= 0) {
-		result = result + "Local player has no files.\n";
-	}
-	else if(data.header.techCRCFileCount <= 0) {
-		result = result + "Remote player has no files.\n";
-	}
-	else {
-		for(int idx = 0; idx < (int)vctFileList.size(); ++idx) {
-			std::pair<string,uint32> &fileInfo = vctFileList[idx];
-			bool fileFound = false;
-			uint32 remoteCRC = 0;
-			for(int j = 0; j < (int)data.header.techCRCFileCount; ++j) {
-				string networkFile = data.detail.techCRCFileList[j].getString();
-				uint32 &networkFileCRC = data.detail.techCRCFileCRCList[j];
-				if(fileInfo.first == networkFile) {
-					fileFound = true;
-					remoteCRC = networkFileCRC;
-					break;
-				}
-			}
-
-			if(fileFound == false) {
-				result = result + "local file [" + fileInfo.first + "] missing remotely.\n";
-			}
-			else if(fileInfo.second != remoteCRC) {
-				result = result + "local file [" + fileInfo.first + "] CRC mismatch.\n";
-			}
-		}
-
-		for(int i = 0; i < (int)data.header.techCRCFileCount; ++i) {
-			string networkFile = data.detail.techCRCFileList[i].getString();
-			uint32 &networkFileCRC = data.detail.techCRCFileCRCList[i];
-			bool fileFound = false;
-			uint32 localCRC = 0;
-			for(int idx = 0; idx < (int)vctFileList.size(); ++idx) {
-				std::pair<string,uint32> &fileInfo = vctFileList[idx];
-
-				if(networkFile == fileInfo.first) {
-					fileFound = true;
-					localCRC = fileInfo.second;
-					break;
-				}
-			}
-
-			if(fileFound == false) {
-				result = result + "remote file [" + networkFile + "] missing locally.\n";
-			}
-			else if(networkFileCRC != localCRC) {
-				result = result + "remote file [" + networkFile + "] CRC mismatch.\n";
-			}
-		}
+vector<std::pair<string,uint32> > NetworkMessageSynchNetworkGameDataStatus::getTechCRCFiles() const {
+	vector<std::pair<string,uint32> > result;
+	result.reserve(data.header.techCRCFileCount);
+	for(int idx = 0; idx < (int)data.header.techCRCFileCount; ++idx) {
+		result.push_back(std::pair<string,uint32>(data.detail.techCRCFileList[idx].getString(),data.detail.techCRCFileCRCList[idx]));
 	}
 	return result;
 }
 
+string NetworkMessageSynchNetworkGameDataStatus::getTechCRCFileMismatchReport(string techtree, vector<std::pair<string,uint32> > &vctFileList) {
+	return getTechCRCFileMismatchReportForLists(techtree, vctFileList, getTechCRCFiles());
+}
+
 bool NetworkMessageSynchNetworkGameDataStatus::receive(Socket* socket) {
 	if(SystemFlags::getSystemSettingType(SystemFlags::debugNetwork).enabled) SystemFlags::OutputDebug(SystemFlags::debugNetwork,"In [%s::%s Line: %d] about to get nmtSynchNetworkGameDataStatus\n",extractFileFromDirectoryPath(__FILE__).c_str(),__FUNCTION__,__LINE__);
 
@@ -3697,4 +3656,149 @@ void NetworkMessageHighlightCell::fromEndian() {
 	}
 }
 
+// =====================================================
+//	class NetworkMessageJoinGameSnapshot
+// =====================================================
+
+NetworkMessageJoinGameSnapshot::NetworkMessageJoinGameSnapshot() {
+	messageType		= nmtJoinGameSnapshot;
+	data.frameCount	= 0;
+	data.totalSize	= 0;
+	data.offset		= 0;
+	data.chunkSize	= 0;
+}
+
+NetworkMessageJoinGameSnapshot::NetworkMessageJoinGameSnapshot(int32 frameCount, const std::vector<unsigned char> &snapshot, uint32 offset) {
+	messageType		= nmtJoinGameSnapshot;
+	data.frameCount	= frameCount;
+	data.totalSize	= (uint32)snapshot.size();
+	data.offset		= offset;
+
+	uint32 remaining = (offset < data.totalSize ? data.totalSize - offset : 0);
+	data.chunkSize	= (remaining < maxChunkSize ? remaining : maxChunkSize);
+	if(data.chunkSize > 0) {
+		chunk.assign(snapshot.begin() + offset, snapshot.begin() + offset + data.chunkSize);
+	}
+}
+
+const char * NetworkMessageJoinGameSnapshot::getPackedMessageFormat() const {
+	return "clLLL";
+}
+
+unsigned int NetworkMessageJoinGameSnapshot::getPackedSize() {
+	static unsigned int result = 0;
+	if(result == 0) {
+		Data packedData;
+		messageType = 0;
+		packedData.frameCount = 0;
+		packedData.totalSize = 0;
+		packedData.offset = 0;
+		packedData.chunkSize = 0;
+		unsigned char *buf = new unsigned char[sizeof(packedData)*3];
+		result = pack(buf, getPackedMessageFormat(),
+				messageType,
+				packedData.frameCount,
+				packedData.totalSize,
+				packedData.offset,
+				packedData.chunkSize);
+		delete [] buf;
+	}
+	return result;
+}
+void NetworkMessageJoinGameSnapshot::unpackMessage(unsigned char *buf) {
+	unpack(buf, getPackedMessageFormat(),
+			&messageType,
+			&data.frameCount,
+			&data.totalSize,
+			&data.offset,
+			&data.chunkSize);
+}
+
+unsigned char * NetworkMessageJoinGameSnapshot::packMessage() {
+	unsigned char *buf = new unsigned char[getPackedSize()+1];
+	pack(buf, getPackedMessageFormat(),
+			messageType,
+			data.frameCount,
+			data.totalSize,
+			data.offset,
+			data.chunkSize);
+
+	return buf;
+}
+
+bool NetworkMessageJoinGameSnapshot::receive(Socket* socket) {
+	bool result = false;
+	if(useOldProtocol == true) {
+		result = NetworkMessage::receive(socket, &data, sizeof(data), true);
+		if(result == true) {
+			messageType = nmtJoinGameSnapshot;
+		}
+	}
+	else {
+		unsigned char *buf = new unsigned char[getPackedSize()+1];
+		result = NetworkMessage::receive(socket, buf, getPackedSize(), true);
+		unpackMessage(buf);
+		delete [] buf;
+	}
+	fromEndian();
+
+	chunk.clear();
+	if(result == true) {
+		if(data.chunkSize > maxChunkSize ||
+			data.offset > data.totalSize ||
+			data.chunkSize > data.totalSize - data.offset) {
+			SystemFlags::OutputDebug(SystemFlags::debugError,"In [%s::%s Line: %d] ERROR invalid snapshot chunk, totalSize = %u offset = %u chunkSize = %u\n",extractFileFromDirectoryPath(__FILE__).c_str(),__FUNCTION__,__LINE__,data.totalSize,data.offset,data.chunkSize);
+			return false;
+		}
+		if(data.chunkSize > 0) {
+			chunk.resize(data.chunkSize);
+			result = NetworkMessage::receive(socket, &chunk[0], data.chunkSize, true);
+		}
+	}
+	return result;
+}
+
+void NetworkMessageJoinGameSnapshot::send(Socket* socket) {
+	if(SystemFlags::getSystemSettingType(SystemFlags::debugNetwork).enabled) SystemFlags::OutputDebug(SystemFlags::debugNetwork,"In [%s::%s Line: %d] nmtJoinGameSnapshot, frameCount = %d offset = %u chunkSize = %u totalSize = %u\n",extractFileFromDirectoryPath(__FILE__).c_str(),__FUNCTION__,__LINE__,data.frameCount,data.offset,data.chunkSize,data.totalSize);
+
+	assert(messageType == nmtJoinGameSnapshot);
+	uint32 chunkSize = data.chunkSize;
+	toEndian();
+
+	if(useOldProtocol == true) {
+		NetworkMessage::send(socket, &data, sizeof(data), messageType);
+	}
+	else {
+		unsigned char *buf = packMessage();
+		NetworkMessage::send(socket, buf, getPackedSize());
+		delete [] buf;
+	}
+	fromEndian();
+
+	if(chunkSize > 0) {
+		NetworkMessage::send(socket, &chunk[0], chunkSize);
+	}
+}
+
+void NetworkMessageJoinGameSnapshot::toEndian() {
+	static bool bigEndianSystem = Shared::PlatformByteOrder::isBigEndian();
+	if(bigEndianSystem == true) {
+		messageType = Shared::PlatformByteOrder::toCommonEndian(messageType);
+		data.frameCount = Shared::PlatformByteOrder::toCommonEndian(data.frameCount);
+		data.totalSize = Shared::PlatformByteOrder::toCommonEndian(data.totalSize);
+		data.offset = Shared::PlatformByteOrder::toCommonEndian(data.offset);
+		data.chunkSize = Shared::PlatformByteOrder::toCommonEndian(data.chunkSize);
+	}
+}
+void NetworkMessageJoinGameSnapshot::fromEndian() {
+	static bool bigEndianSystem = Shared::PlatformByteOrder::isBigEndian();
+	if(bigEndianSystem == true) {
+		messageType = Shared::PlatformByteOrder::fromCommonEndian(messageType);
+		data.frameCount = Shared::PlatformByteOrder::fromCommonEndian(data.frameCount);
+		data.totalSize = Shared::PlatformByteOrder::fromCommonEndian(data.totalSize);
+		data.offset = Shared::PlatformByteOrder::fromCommonEndian(data.offset);
+		data.chunkSize = Shared::PlatformByteOrder::fromCommonEndian(data.chunkSize);
+	}
+}
+
 }}//end namespace
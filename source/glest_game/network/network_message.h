@@ -49,6 +49,7 @@ enum NetworkMessageType {
 	nmtMarkCell,
 	nmtUnMarkCell,
 	nmtHighlightCell,
+	nmtJoinGameSnapshot,
 //	nmtCompressedPacket,
 
 	nmtCount
@@ -674,6 +675,7 @@ public:
 	uint32 getTechCRCFileCount() const {return data.header.techCRCFileCount;}
 	const NetworkString<maxStringSize> * getTechCRCFileList() const {return &data.detail.techCRCFileList[0];}
 	const uint32 * getTechCRCFileCRCList() const {return data.detail.techCRCFileCRCList;}
+	vector<std::pair<string,uint32> > getTechCRCFiles() const;
 
 	string getTechCRCFileMismatchReport(vector<std::pair<string,uint32> > &vctFileList);
 };
@@ -752,6 +754,9 @@ public:
 	uint32 getTechCRCFileCount() const {return data.header.techCRCFileCount;}
 	const NetworkString<maxStringSize> * getTechCRCFileList() const {return &data.detail.techCRCFileList[0];}
 	const uint32 * getTechCRCFileCRCList() const {return data.detail.techCRCFileCRCList;}
+	vector<std::pair<string,uint32> > getTechCRCFiles() const;
+	// false when the client had more files than fit in the message
+	bool hasAllTechCRCFiles() const { return data.header.techCRCFileCount < (uint32)maxFileCRCCount; }
 
 	string getTechCRCFileMismatchReport(string techtree, vector<std::pair<string,uint32> > &vctFileList);
 
@@ -1211,6 +1216,63 @@ public:
 };
 #pragma pack(pop)
 
+// =====================================================
+//	class NetworkMessageJoinGameSnapshot
+//
+//	One chunk of the in memory world snapshot that is
+//	sent to a client joining a game in progress
+// =====================================================
+
+#pragma pack(push, 1)
+class NetworkMessageJoinGameSnapshot: public NetworkMessage {
+public:
+	static const uint32 maxChunkSize= 16384;
+	// larger snapshots are neither sent nor accepted
+	static const uint32 maxTotalSize= 256 * 1024 * 1024;
+
+private:
+
+	int8 messageType;
+	struct Data{
+
+		int32 frameCount;
+		uint32 totalSize;
+		uint32 offset;
+		uint32 chunkSize;
+	};
+	void toEndian();
+	void fromEndian();
+
+private:
+	Data data;
+	std::vector<unsigned char> chunk;
+
+protected:
+	virtual const char * getPackedMessageFormat() const;
+	virtual unsigned int getPackedSize();
+	virtual void unpackMessage(unsigned char *buf);
+	virtual unsigned char * packMessage();
+
+public:
+	NetworkMessageJoinGameSnapshot();
+	NetworkMessageJoinGameSnapshot(int32 frameCount, const std::vector<unsigned char> &snapshot, uint32 offset);
+
+	virtual size_t getDataSize() const { return sizeof(Data); }
+
+	virtual NetworkMessageType getNetworkMessageType() const {
+		return nmtJoinGameSnapshot;
+	}
+
+	int getFrameCount() const							{ return data.frameCount; }
+	uint32 getTotalSize() const							{ return data.totalSize; }
+	uint32 getOffset() const							{ return data.offset; }
+	const std::vector<unsigned char> & getChunk() const	{ return chunk; }
+
+	virtual bool receive(Socket* socket);
+	virtual void send(Socket* socket);
+};
+#pragma pack(pop)
+
 }}//end namespace
 
 #endif
@@ -24,7 +24,9 @@
 #include "game_util.h"
 #include "miniftpserver.h"
 #include "map_preview.h"
+#include "zone_profiler.h"
 #include "stats.h"
+#include "join_game_snapshot_sender.h"
 #include <time.h>
 #include <set>
 #include <iostream>
@@ -51,6 +53,7 @@ double LAG_CHECK_INTERVAL_PERIOD 							= 4;
 const int MAX_CLIENT_WAIT_SECONDS_FOR_PAUSE_MILLISECONDS	= 15000;
 const int MAX_CLIENT_PAUSE_FOR_LAG_COUNT					= 3;
 const int MAX_SLOT_THREAD_WAIT_TIME_MILLISECONDS			= 1500;
+const int SLOT_THREAD_WAIT_SLICE_MILLISECONDS				= 10;
 const int MASTERSERVER_HEARTBEAT_GAME_STATUS_SECONDS 		= 30;
 
 const int MAX_EMPTY_NETWORK_COMMAND_LIST_BROADCAST_INTERVAL_MILLISECONDS = 4000;
@@ -78,6 +81,7 @@ ServerInterface::ServerInterface(bool publishEnabled, ClientLagCallbackInterface
 	serverSocketAdmin				= NULL;
 	nextEventId 					= 1;
 	gameHasBeenInitiated 			= false;
+	slotThreadWaitMillis			= 0;
 	exitServer 						= false;
 	gameSettingsUpdateCount 		= 0;
 	currentFrameCount 				= 0;
@@ -87,6 +91,7 @@ ServerInterface::ServerInterface(bool publishEnabled, ClientLagCallbackInterface
 	lastMasterserverHeartbeatTime 	= 0;
 	needToRepublishToMasterserver 	= false;
 	ftpServer 						= NULL;
+	joinGameSnapshotSender 			= NULL;
 	inBroadcastMessage				= false;
 	lastGlobalLagCheckTime			= 0;
 	masterserverAdminRequestLaunch	= false;
@@ -276,12 +281,34 @@ void ServerInterface::shutdownMasterserverPublishThread() {
 	}
 }
 
+void ServerInterface::shutdownJoinGameSnapshotSender() {
+	if(joinGameSnapshotSender != NULL) {
+		joinGameSnapshotSender->signalQuit();
+		if(joinGameSnapshotSender->shutdownAndWait() == true) {
+			delete joinGameSnapshotSender;
+		}
+		joinGameSnapshotSender = NULL;
+	}
+}
+
+void ServerInterface::sendJoinGameSnapshot(XmlTree *xmlTree, int frameCount, const vector<int> &playerIndexes) {
+	if(joinGameSnapshotSender == NULL) {
+		static string mutexOwnerId = string(extractFileFromDirectoryPath(__FILE__).c_str()) + string("_") + intToStr(__LINE__);
+		joinGameSnapshotSender = new JoinGameSnapshotSender(this);
+		joinGameSnapshotSender->setUniqueID(mutexOwnerId);
+		joinGameSnapshotSender->start();
+	}
+	joinGameSnapshotSender->queue(xmlTree, frameCount, playerIndexes);
+}
+
 ServerInterface::~ServerInterface() {
 	//printf("===> Destructor for ServerInterface\n");
 	if(SystemFlags::getSystemSettingType(SystemFlags::debugNetwork).enabled) SystemFlags::OutputDebug(SystemFlags::debugNetwork,"In [%s::%s Line: %d]\n",extractFileFromDirectoryPath(__FILE__).c_str(),__FUNCTION__,__LINE__);
 
 	masterController.clearSlaves(true);
 	exitServer = true;
+	// it sends through the slots deleted below
+	shutdownJoinGameSnapshotSender();
 	for(int index = 0; index < GameConstants::maxPlayers; ++index) {
 		if(slots[index] != NULL) {
 			MutexSafeWrapper safeMutex(slotAccessorMutexes[index],CODE_AT_LINE_X(index));
@@ -879,7 +906,8 @@ void ServerInterface::validateConnectedClients() {
 }
 
 bool ServerInterface::signalClientReceiveCommands(ConnectionSlot *connectionSlot,
-		int slotIndex, bool socketTriggered, ConnectionSlotEvent & event) {
+		int slotIndex, bool socketTriggered, ConnectionSlotEvent & event,
+		CompletionLatch *latch, int latchGeneration) {
 	bool slotSignalled 		= false;
 
 	event.eventType 		= eReceiveSocketData;
@@ -888,6 +916,8 @@ bool ServerInterface::signalClientReceiveCommands(ConnectionSlot *connectionSlot
 	event.socketTriggered 	= socketTriggered;
 	event.triggerId 		= slotIndex;
 	event.eventId 			= getNextEventId();
+	event.completionLatch 	= latch;
+	event.completionLatchGeneration = latchGeneration;
 
 	if(connectionSlot != NULL) {
 		if(socketTriggered == true || connectionSlot->isConnected() == false) {
@@ -895,6 +925,9 @@ bool ServerInterface::signalClientReceiveCommands(ConnectionSlot *connectionSlot
 			slotSignalled = true;
 		}
 	}
+	if(slotSignalled == false && latch != NULL) {
+		latch->countDown(latchGeneration);
+	}
 	return slotSignalled;
 }
 
@@ -946,6 +979,9 @@ void ServerInterface::signalClientsToRecieveData(std::map<PLATFORM_SOCKET,bool>
 		masterController.signalSlaves(&eventList);
 	}
 	else {
+		// every slot counts down once, either its thread when the event is
+		// done or right here when there is nothing to signal
+		int latchGeneration = slotThreadsCompleted.reset(GameConstants::maxPlayers);
 		for(int index = 0; exitServer == false && index < GameConstants::maxPlayers; ++index) {
 			MutexSafeWrapper safeMutexSlot(slotAccessorMutexes[index],CODE_AT_LINE_X(index));
 			ConnectionSlot *connectionSlot = slots[index];
@@ -958,11 +994,15 @@ void ServerInterface::signalClientsToRecieveData(std::map<PLATFORM_SOCKET,bool>
 				}
 
 				ConnectionSlotEvent &event = eventList[index];
-				bool socketSignalled = signalClientReceiveCommands(connectionSlot,index,socketTriggered,event);
+				bool socketSignalled = signalClientReceiveCommands(connectionSlot,index,socketTriggered,event,
+																   &slotThreadsCompleted,latchGeneration);
 				if(connectionSlot != NULL && socketTriggered == true) {
 					mapSlotSignalledList[index] = socketSignalled;
 				}
 			}
+			else {
+				slotThreadsCompleted.countDown(latchGeneration);
+			}
 		}
 	}
 }
@@ -1058,6 +1098,12 @@ void ServerInterface::checkForCompletedClientsUsingLoop(
 				}
 			}
 		}
+
+		// Sleep until the slot threads count the latch down instead of
+		// spinning, the slice bounds the wait for threads that quit early
+		if (threadsDone == false) {
+			slotThreadsCompleted.waitTillCompleted(SLOT_THREAD_WAIT_SLICE_MILLISECONDS);
+		}
 	}
 }
 
@@ -1080,6 +1126,7 @@ void ServerInterface::checkForCompletedClients(std::map<int,bool> & mapSlotSigna
 
 	if(SystemFlags::getSystemSettingType(SystemFlags::debugNetwork).enabled) SystemFlags::OutputDebug(SystemFlags::debugNetwork,"In [%s::%s Line: %d]\n",__FILE__,__FUNCTION__,__LINE__);
 
+	Chrono chronoWait(true);
 	const bool newThreadManager = Config::getInstance().getBool("EnableNewThreadManager","false");
 	if(newThreadManager == true) {
 		checkForCompletedClientsUsingThreadManager(mapSlotSignalledList, errorMsgList);
@@ -1087,6 +1134,7 @@ void ServerInterface::checkForCompletedClients(std::map<int,bool> & mapSlotSigna
 	else {
 		checkForCompletedClientsUsingLoop(mapSlotSignalledList, errorMsgList, eventList);
 	}
+	slotThreadWaitMillis = chronoWait.getMillis();
 	if(SystemFlags::getSystemSettingType(SystemFlags::debugNetwork).enabled) SystemFlags::OutputDebug(SystemFlags::debugNetwork,"In [%s::%s Line: %d]\n",__FILE__,__FUNCTION__,__LINE__);
 }
 
@@ -1479,8 +1527,32 @@ void ServerInterface::checkForAutoResumeForLaggingClients() {
 	}
 }
 
+// A joining client that takes too long to load its snapshot can't fast
+// forward through everything held back for it any more, it is dropped
+// and may join again
+void ServerInterface::checkForExpiredJoinGameSnapshots() {
+	for(int index = 0; exitServer == false && index < GameConstants::maxPlayers; ++index) {
+		MutexSafeWrapper safeMutexSlot(slotAccessorMutexes[index],CODE_AT_LINE_X(index));
+		ConnectionSlot *connectionSlot = slots[index];
+		if(connectionSlot != NULL && connectionSlot->isConnected() == true &&
+			connectionSlot->isJoinGameSnapshotExpired() == true) {
+
+			char szBuf[4096]="";
+			snprintf(szBuf,4095,"DROPPING %s, did not load the join game snapshot in time, disconnecting client.",connectionSlot->getName().c_str());
+			if(SystemFlags::getSystemSettingType(SystemFlags::debugNetwork).enabled) SystemFlags::OutputDebug(SystemFlags::debugNetwork,"In [%s::%s Line: %d] %s\n",extractFileFromDirectoryPath(__FILE__).c_str(),__FUNCTION__,__LINE__,szBuf);
+
+			connectionSlot->close();
+			safeMutexSlot.ReleaseLock();
+
+			sendTextMessage(szBuf,-1,true,"");
+		}
+	}
+}
+
 void ServerInterface::update() {
+	PROFILE_ZONE("ServerInterface::update");
 	//printf("\nServerInterface::update -- A\n");
+	slotThreadWaitMillis = 0;
 
 	std::vector <string> errorMsgList;
 	try {
@@ -1494,6 +1566,7 @@ void ServerInterface::update() {
 		processBroadCastMessageQueue();
 
 		checkForAutoResumeForLaggingClients();
+		checkForExpiredJoinGameSnapshots();
 
 		//printf("\nServerInterface::update -- C\n");
 
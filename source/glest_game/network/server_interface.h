@@ -26,12 +26,14 @@
 
 using std::vector;
 using Shared::Platform::ServerSocket;
+using Shared::Xml::XmlTree;
 
 namespace Shared {  namespace PlatformCommon {  class FTPServerThread;  }}
 
 namespace Glest{ namespace Game{
 
 class Stats;
+class JoinGameSnapshotSender;
 // =====================================================
 //	class ServerInterface
 // =====================================================
@@ -72,6 +74,8 @@ private:
 	bool needToRepublishToMasterserver;
 
     ::Shared::PlatformCommon::FTPServerThread *ftpServer;
+    // created on the first join in progress
+    JoinGameSnapshotSender *joinGameSnapshotSender;
     bool exitServer;
     int64 nextEventId;
 
@@ -95,6 +99,8 @@ private:
 
 	ServerSocket *serverSocketAdmin;
 	MasterSlaveThreadController masterController;
+	CompletionLatch slotThreadsCompleted;
+	int64 slotThreadWaitMillis;
 
 	bool gameHasBeenInitiated;
 	int gameSettingsUpdateCount;
@@ -118,6 +124,8 @@ public:
 	virtual ~ServerInterface();
 
 	bool getClientsAutoPausedDueToLag();
+	// time the last update() spent waiting on the connection slot threads
+	int64 getSlotThreadWaitMillis() const { return slotThreadWaitMillis; }
 	void setClientLagCallbackInterface(ClientLagCallbackInterface *intf);
 	void setGameStats(Stats *gameStats);
 
@@ -135,6 +143,10 @@ public:
 
 	void shutdownFTPServer();
 
+	// Takes ownership of xmlTree, it is encoded and streamed to the slots
+	// of playerIndexes on a worker thread
+	void sendJoinGameSnapshot(XmlTree *xmlTree, int frameCount, const vector<int> &playerIndexes);
+
     virtual void close();
     virtual void update();
     virtual void updateLobby()  { };
@@ -200,7 +212,8 @@ public:
     }
 
     std::pair<bool,bool> clientLagCheck(ConnectionSlot *connectionSlot, bool skipNetworkBroadCast = false);
-    bool signalClientReceiveCommands(ConnectionSlot *connectionSlot, int slotIndex, bool socketTriggered, ConnectionSlotEvent & event);
+    bool signalClientReceiveCommands(ConnectionSlot *connectionSlot, int slotIndex, bool socketTriggered, ConnectionSlotEvent & event,
+    								 CompletionLatch *latch=NULL, int latchGeneration=0);
     void updateSocketTriggeredList(std::map<PLATFORM_SOCKET,bool> & socketTriggeredList);
     bool isPortBound() const {
         return serverSocket.isPortBound();
@@ -274,6 +287,7 @@ private:
 	void checkForAutoPauseForLaggingClient(int index,
 			ConnectionSlot* connectionSlot);
 	void checkForAutoResumeForLaggingClients();
+	void checkForExpiredJoinGameSnapshots();
 
 protected:
     void signalClientsToRecieveData(std::map<PLATFORM_SOCKET,bool> & socketTriggeredList, std::map<int,ConnectionSlotEvent> & eventList, std::map<int,bool> & mapSlotSignalledList);
@@ -286,7 +300,7 @@ protected:
     void dispatchPendingHighlightCellMessages(std::vector <string> &errorMsgList);
 
     void shutdownMasterserverPublishThread();
-
+    void shutdownJoinGameSnapshotSender();
 
 };
 
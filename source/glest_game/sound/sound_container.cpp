@@ -42,4 +42,12 @@ StaticSound *SoundContainer::getRandSound() const{
 	}
 }
 
+void SoundContainer::prefetchSounds() const {
+	for(unsigned int i = 0; i < sounds.size(); ++i) {
+		if(sounds[i] != NULL) {
+			sounds[i]->prefetch();
+		}
+	}
+}
+
 }}//end namespace
@@ -53,6 +53,7 @@ public:
 	void clearSounds() {sounds.clear();}
 	Sounds *getSoundsPtr() {return &sounds;}
 	StaticSound *getRandSound() const;
+	void prefetchSounds() const;
 };
 
 }}//end namespace
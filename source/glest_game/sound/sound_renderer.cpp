@@ -14,6 +14,7 @@
 #include "config.h"
 #include "sound_interface.h"
 #include "factory_repository.h"
+#include "sound_cache.h"
 #include "util.h"
 #include "leak_dumper.h"
 
@@ -60,6 +61,9 @@ bool SoundRenderer::init(Window *window) {
 	    safeMutex.setMutex(mutex);
 	}
 
+	// decoded static sounds above this are freed, least recently played first
+	StaticSoundCache::getInstance().setMemoryBudget((int64)config.getInt("StaticSoundCacheMB","128") * 1024 * 1024);
+
 	soundPlayer= si.newSoundPlayer();
 	if(soundPlayer != NULL) {
 		SoundPlayerParams soundPlayerParams;
@@ -88,6 +92,8 @@ void SoundRenderer::cleanup() {
 	delete soundPlayer;
 	soundPlayer = NULL;
 
+	StaticSoundCache::getInstance().stopPrefetch();
+
 	if(SystemFlags::getSystemSettingType(SystemFlags::debugSystem).enabled) SystemFlags::OutputDebug(SystemFlags::debugSystem,"In [%s::%s %d]\n",__FILE__,__FUNCTION__,__LINE__);
 }
 
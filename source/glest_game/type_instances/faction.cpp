@@ -23,6 +23,7 @@
 #include "game.h"
 #include "config.h"
 #include "randomgen.h"
+#include "zone_profiler.h"
 #include "leak_dumper.h"
 
 using namespace Shared::Util;
@@ -216,6 +217,8 @@ FactionThread::FactionThread(Faction *faction) : BaseThread() {
 	this->triggerIdMutex = new Mutex(CODE_AT_LINE);
 	this->faction = faction;
 	this->masterController = NULL;
+	this->completionLatch = NULL;
+	this->completionLatchGeneration = 0;
 	uniqueID = "FactionThread";
 }
 
@@ -227,22 +230,25 @@ FactionThread::~FactionThread() {
 }
 
 void FactionThread::setQuitStatus(bool value) {
-	if(SystemFlags::getSystemSettingType(SystemFlags::debugSystem).enabled) SystemFlags::OutputDebug(SystemFlags::debugSystem,"In [%s::%s] Line: %d value = %d\n",__FILE__,__FUNCTION__,__LINE__,value);
+	if(SystemFlags::isDebugEnabled(SystemFlags::debugSystem)) SystemFlags::OutputDebug(SystemFlags::debugSystem,"In [%s::%s] Line: %d value = %d\n",__FILE__,__FUNCTION__,__LINE__,value);
 
 	BaseThread::setQuitStatus(value);
 	if(value == true) {
+		releaseCompletionLatch();
 		signalPathfinder(-1);
 	}
 
-	if(SystemFlags::getSystemSettingType(SystemFlags::debugSystem).enabled) SystemFlags::OutputDebug(SystemFlags::debugSystem,"In [%s::%s] Line: %d\n",__FILE__,__FUNCTION__,__LINE__);
+	if(SystemFlags::isDebugEnabled(SystemFlags::debugSystem)) SystemFlags::OutputDebug(SystemFlags::debugSystem,"In [%s::%s] Line: %d\n",__FILE__,__FUNCTION__,__LINE__);
 }
 
-void FactionThread::signalPathfinder(int frameIndex) {
+void FactionThread::signalPathfinder(int frameIndex, CompletionLatch *latch, int latchGeneration) {
 	if(frameIndex >= 0) {
 		static string mutexOwnerId = string(__FILE__) + string("_") + intToStr(__LINE__);
 		MutexSafeWrapper safeMutex(triggerIdMutex,mutexOwnerId);
 		this->frameIndex.first = frameIndex;
 		this->frameIndex.second = false;
+		this->completionLatch = latch;
+		this->completionLatchGeneration = latchGeneration;
 
 		safeMutex.ReleaseLock();
 	}
@@ -255,11 +261,25 @@ void FactionThread::setTaskCompleted(int frameIndex) {
 		MutexSafeWrapper safeMutex(triggerIdMutex,mutexOwnerId);
 		if(this->frameIndex.first == frameIndex) {
 			this->frameIndex.second = true;
+
+			if(this->completionLatch != NULL) {
+				this->completionLatch->countDown(this->completionLatchGeneration);
+				this->completionLatch = NULL;
+			}
 		}
 		safeMutex.ReleaseLock();
 	}
 }
 
+void FactionThread::releaseCompletionLatch() {
+	static string mutexOwnerId = string(__FILE__) + string("_") + intToStr(__LINE__);
+	MutexSafeWrapper safeMutex(triggerIdMutex,mutexOwnerId);
+	if(this->completionLatch != NULL) {
+		this->completionLatch->countDown(this->completionLatchGeneration);
+		this->completionLatch = NULL;
+	}
+}
+
 bool FactionThread::canShutdown(bool deleteSelfIfShutdownDelayed) {
 	bool ret = (getExecutingTask() == false);
 	if(ret == false && deleteSelfIfShutdownDelayed == true) {
@@ -291,17 +311,21 @@ void FactionThread::execute() {
     RunningStatusSafeWrapper runningStatus(this);
 	try {
 		//setRunningStatus(true);
-		if(SystemFlags::getSystemSettingType(SystemFlags::debugSystem).enabled) SystemFlags::OutputDebug(SystemFlags::debugSystem,"In [%s::%s Line: %d]\n",__FILE__,__FUNCTION__,__LINE__);
+		if(SystemFlags::isDebugEnabled(SystemFlags::debugSystem)) SystemFlags::OutputDebug(SystemFlags::debugSystem,"In [%s::%s Line: %d]\n",__FILE__,__FUNCTION__,__LINE__);
 		if(SystemFlags::VERBOSE_MODE_ENABLED) printf("In [%s::%s Line: %d] ****************** STARTING worker thread this = %p\n",__FILE__,__FUNCTION__,__LINE__,this);
 
 		bool minorDebugPerformance = false;
 		Chrono chrono;
 
+		if(this->faction != NULL) {
+			ZoneProfiler::setThreadName("Faction " + intToStr(this->faction->getIndex()));
+		}
+
 		codeLocation = "2";
 		//unsigned int idx = 0;
 		for(;this->faction != NULL;) {
 			if(getQuitStatus() == true) {
-				if(SystemFlags::getSystemSettingType(SystemFlags::debugSystem).enabled) SystemFlags::OutputDebug(SystemFlags::debugSystem,"In [%s::%s Line: %d]\n",__FILE__,__FUNCTION__,__LINE__);
+				if(SystemFlags::isDebugEnabled(SystemFlags::debugSystem)) SystemFlags::OutputDebug(SystemFlags::debugSystem,"In [%s::%s Line: %d]\n",__FILE__,__FUNCTION__,__LINE__);
 				break;
 			}
 
@@ -314,7 +338,7 @@ void FactionThread::execute() {
 			//printf("In [%s::%s Line: %d]\n",__FILE__,__FUNCTION__,__LINE__);
 
 			if(getQuitStatus() == true) {
-				if(SystemFlags::getSystemSettingType(SystemFlags::debugSystem).enabled) SystemFlags::OutputDebug(SystemFlags::debugSystem,"In [%s::%s Line: %d]\n",__FILE__,__FUNCTION__,__LINE__);
+				if(SystemFlags::isDebugEnabled(SystemFlags::debugSystem)) SystemFlags::OutputDebug(SystemFlags::debugSystem,"In [%s::%s Line: %d]\n",__FILE__,__FUNCTION__,__LINE__);
 				break;
 			}
 
@@ -333,6 +357,7 @@ void FactionThread::execute() {
             if(executeTask == true) {
 				codeLocation = "6";
 				ExecutingTaskSafeWrapper safeExecutingTaskMutex(this);
+				PROFILE_ZONE("FactionThread::updateUnits");
 
 				if(this->faction == NULL) {
 					throw megaglest_runtime_error("this->faction == NULL");
@@ -357,7 +382,7 @@ void FactionThread::execute() {
 				static string mutexOwnerId2 = string(__FILE__) + string("_") + intToStr(__LINE__);
 				MutexSafeWrapper safeMutex(faction->getUnitMutex(),mutexOwnerId2);
 
-				//if(SystemFlags::getSystemSettingType(SystemFlags::debugPerformance).enabled) chrono.start();
+				//if(SystemFlags::isDebugEnabled(SystemFlags::debugPerformance)) chrono.start();
 				if(minorDebugPerformance) chrono.start();
 
 				//printf("In [%s::%s Line: %d]\n",__FILE__,__FUNCTION__,__LINE__);
@@ -384,7 +409,7 @@ void FactionThread::execute() {
 					if(update == true)
 					{
 						codeLocation = "13";
-						if(SystemFlags::getSystemSettingType(SystemFlags::debugWorldSynch).enabled == true) {
+						if(SystemFlags::isDebugEnabled(SystemFlags::debugWorldSynch) == true) {
 							int64 updateProgressValue = unit->getUpdateProgress();
 							int64 speed = unit->getCurrSkill()->getTotalSpeed(unit->getTotalUpgrade());
 							int64 df = unit->getDiagonalFactor();
@@ -410,7 +435,7 @@ void FactionThread::execute() {
 					}
 					else {
 						codeLocation = "16";
-						if(SystemFlags::getSystemSettingType(SystemFlags::debugWorldSynch).enabled == true) {
+						if(SystemFlags::isDebugEnabled(SystemFlags::debugWorldSynch) == true) {
 							int64 updateProgressValue = unit->getUpdateProgress();
 							int64 speed = unit->getCurrSkill()->getTotalSpeed(unit->getTotalUpgrade());
 							int64 df = unit->getDiagonalFactor();
@@ -443,30 +468,33 @@ void FactionThread::execute() {
 
 			codeLocation = "19";
 			if(getQuitStatus() == true) {
-				if(SystemFlags::getSystemSettingType(SystemFlags::debugSystem).enabled) SystemFlags::OutputDebug(SystemFlags::debugSystem,"In [%s::%s Line: %d]\n",__FILE__,__FUNCTION__,__LINE__);
+				if(SystemFlags::isDebugEnabled(SystemFlags::debugSystem)) SystemFlags::OutputDebug(SystemFlags::debugSystem,"In [%s::%s Line: %d]\n",__FILE__,__FUNCTION__,__LINE__);
 				break;
 			}
 		}
 
-		if(SystemFlags::getSystemSettingType(SystemFlags::debugSystem).enabled) SystemFlags::OutputDebug(SystemFlags::debugSystem,"In [%s::%s Line: %d]\n",__FILE__,__FUNCTION__,__LINE__);
+		if(SystemFlags::isDebugEnabled(SystemFlags::debugSystem)) SystemFlags::OutputDebug(SystemFlags::debugSystem,"In [%s::%s Line: %d]\n",__FILE__,__FUNCTION__,__LINE__);
 		if(SystemFlags::VERBOSE_MODE_ENABLED) printf("In [%s::%s Line: %d] ****************** ENDING worker thread this = %p\n",__FILE__,__FUNCTION__,__LINE__,this);
 	}
 	catch(const exception &ex) {
 		//setRunningStatus(false);
 
 		SystemFlags::OutputDebug(SystemFlags::debugError,"In [%s::%s Line: %d] Loc [%s] Error [%s]\n",__FILE__,__FUNCTION__,__LINE__,codeLocation.c_str(),ex.what());
-		if(SystemFlags::getSystemSettingType(SystemFlags::debugSystem).enabled) SystemFlags::OutputDebug(SystemFlags::debugSystem,"In [%s::%s Line: %d]\n",__FILE__,__FUNCTION__,__LINE__);
+		if(SystemFlags::isDebugEnabled(SystemFlags::debugSystem)) SystemFlags::OutputDebug(SystemFlags::debugSystem,"In [%s::%s Line: %d]\n",__FILE__,__FUNCTION__,__LINE__);
 
+		// don't leave the world waiting for a frame this thread will never finish
+		releaseCompletionLatch();
 		throw megaglest_runtime_error(ex.what());
 	}
 	catch(...) {
 		char szBuf[8096]="";
 		snprintf(szBuf,8096,"In [%s::%s %d] UNKNOWN error Loc [%s]\n",__FILE__,__FUNCTION__,__LINE__,codeLocation.c_str());
 		SystemFlags::OutputDebug(SystemFlags::debugError,szBuf);
+		releaseCompletionLatch();
 		throw megaglest_runtime_error(szBuf);
 	}
 
-	if(SystemFlags::getSystemSettingType(SystemFlags::debugSystem).enabled) SystemFlags::OutputDebug(SystemFlags::debugSystem,"In [%s::%s] Line: %d\n",__FILE__,__FUNCTION__,__LINE__);
+	if(SystemFlags::isDebugEnabled(SystemFlags::debugSystem)) SystemFlags::OutputDebug(SystemFlags::debugSystem,"In [%s::%s] Line: %d\n",__FILE__,__FUNCTION__,__LINE__);
 }
 
 
@@ -480,6 +508,11 @@ Faction::Faction() {
 
 void Faction::init() {
 	unitsMutex = new Mutex(CODE_AT_LINE);
+	worldSynchThreadedLogListMutex = new Mutex(CODE_AT_LINE);
+	worldSynchThreadedLogRing = NULL;
+	if(SystemFlags::isDebugEnabled(SystemFlags::debugWorldSynch) == true) {
+		worldSynchThreadedLogRing = new MpscRing<string>(4096);
+	}
 	texture = NULL;
 	//lastResourceTargettListPurge = 0;
 	cachingDisabled=false;
@@ -507,15 +540,15 @@ void Faction::init() {
 }
 
 Faction::~Faction() {
-	if(SystemFlags::getSystemSettingType(SystemFlags::debugSystem).enabled) SystemFlags::OutputDebug(SystemFlags::debugSystem,"In [%s::%s Line: %d]\n",__FILE__,__FUNCTION__,__LINE__);
+	if(SystemFlags::isDebugEnabled(SystemFlags::debugSystem)) SystemFlags::OutputDebug(SystemFlags::debugSystem,"In [%s::%s Line: %d]\n",__FILE__,__FUNCTION__,__LINE__);
 
 	//Renderer &renderer= Renderer::getInstance();
 
-	if(SystemFlags::getSystemSettingType(SystemFlags::debugSystem).enabled) SystemFlags::OutputDebug(SystemFlags::debugSystem,"In [%s::%s Line: %d]\n",__FILE__,__FUNCTION__,__LINE__);
+	if(SystemFlags::isDebugEnabled(SystemFlags::debugSystem)) SystemFlags::OutputDebug(SystemFlags::debugSystem,"In [%s::%s Line: %d]\n",__FILE__,__FUNCTION__,__LINE__);
 
 	//renderer.endTexture(rsGame,texture);
 	//texture->end();
-	if(SystemFlags::getSystemSettingType(SystemFlags::debugSystem).enabled) SystemFlags::OutputDebug(SystemFlags::debugSystem,"In [%s::%s Line: %d]\n",__FILE__,__FUNCTION__,__LINE__);
+	if(SystemFlags::isDebugEnabled(SystemFlags::debugSystem)) SystemFlags::OutputDebug(SystemFlags::debugSystem,"In [%s::%s Line: %d]\n",__FILE__,__FUNCTION__,__LINE__);
 
 	if(workerThread != NULL) {
 		workerThread->signalQuit();
@@ -533,16 +566,22 @@ Faction::~Faction() {
 
 	//delete texture;
 	texture = NULL;
-	if(SystemFlags::getSystemSettingType(SystemFlags::debugSystem).enabled) SystemFlags::OutputDebug(SystemFlags::debugSystem,"In [%s::%s Line: %d]\n",__FILE__,__FUNCTION__,__LINE__);
+	if(SystemFlags::isDebugEnabled(SystemFlags::debugSystem)) SystemFlags::OutputDebug(SystemFlags::debugSystem,"In [%s::%s Line: %d]\n",__FILE__,__FUNCTION__,__LINE__);
 
 	delete unitsMutex;
 	unitsMutex = NULL;
 
-	if(SystemFlags::getSystemSettingType(SystemFlags::debugSystem).enabled) SystemFlags::OutputDebug(SystemFlags::debugSystem,"In [%s::%s Line: %d]\n",__FILE__,__FUNCTION__,__LINE__);
+	delete worldSynchThreadedLogListMutex;
+	worldSynchThreadedLogListMutex = NULL;
+
+	delete worldSynchThreadedLogRing;
+	worldSynchThreadedLogRing = NULL;
+
+	if(SystemFlags::isDebugEnabled(SystemFlags::debugSystem)) SystemFlags::OutputDebug(SystemFlags::debugSystem,"In [%s::%s Line: %d]\n",__FILE__,__FUNCTION__,__LINE__);
 }
 
 void Faction::end() {
-	if(SystemFlags::getSystemSettingType(SystemFlags::debugSystem).enabled) SystemFlags::OutputDebug(SystemFlags::debugSystem,"In [%s::%s Line: %d]\n",__FILE__,__FUNCTION__,__LINE__);
+	if(SystemFlags::isDebugEnabled(SystemFlags::debugSystem)) SystemFlags::OutputDebug(SystemFlags::debugSystem,"In [%s::%s Line: %d]\n",__FILE__,__FUNCTION__,__LINE__);
 
 	if(workerThread != NULL) {
 		workerThread->signalQuit();
@@ -558,7 +597,7 @@ void Faction::end() {
 
 	safeMutex.ReleaseLock();
 
-	if(SystemFlags::getSystemSettingType(SystemFlags::debugSystem).enabled) SystemFlags::OutputDebug(SystemFlags::debugSystem,"In [%s::%s Line: %d]\n",__FILE__,__FUNCTION__,__LINE__);
+	if(SystemFlags::isDebugEnabled(SystemFlags::debugSystem)) SystemFlags::OutputDebug(SystemFlags::debugSystem,"In [%s::%s Line: %d]\n",__FILE__,__FUNCTION__,__LINE__);
 }
 
 void Faction::notifyUnitAliveStatusChange(const Unit *unit) {
@@ -689,9 +728,12 @@ void Faction::setLockedUnitForFaction(const UnitType *ut, bool lock) {
 
 }
 
-void Faction::signalWorkerThread(int frameIndex) {
-	if(workerThread != NULL) {
-		workerThread->signalPathfinder(frameIndex);
+void Faction::signalWorkerThread(int frameIndex, CompletionLatch *latch, int latchGeneration) {
+	if(workerThread != NULL && workerThread->getRunningStatus() == true) {
+		workerThread->signalPathfinder(frameIndex,latch,latchGeneration);
+	}
+	else if(latch != NULL) {
+		latch->countDown(latchGeneration);
 	}
 }
 
@@ -708,7 +750,7 @@ void Faction::init(
 	int factionIndex, int teamIndex, int startLocationIndex, bool thisFaction, bool giveResources,
 	const XmlNode *loadWorldNode)
 {
-	if(SystemFlags::getSystemSettingType(SystemFlags::debugSystem).enabled) SystemFlags::OutputDebug(SystemFlags::debugSystem,"In [%s::%s Line: %d]\n",__FILE__,__FUNCTION__,__LINE__);
+	if(SystemFlags::isDebugEnabled(SystemFlags::debugSystem)) SystemFlags::OutputDebug(SystemFlags::debugSystem,"In [%s::%s Line: %d]\n",__FILE__,__FUNCTION__,__LINE__);
 
 	this->techTree = techTree;
 	this->loadWorldNode = loadWorldNode;
@@ -767,7 +809,7 @@ void Faction::init(
 		this->workerThread->start();
 	}
 
-	if(SystemFlags::getSystemSettingType(SystemFlags::debugSystem).enabled) SystemFlags::OutputDebug(SystemFlags::debugSystem,"In [%s::%s Line: %d]\n",__FILE__,__FUNCTION__,__LINE__);
+	if(SystemFlags::isDebugEnabled(SystemFlags::debugSystem)) SystemFlags::OutputDebug(SystemFlags::debugSystem,"In [%s::%s Line: %d]\n",__FILE__,__FUNCTION__,__LINE__);
 }
 
 // ================== get ==================
@@ -916,7 +958,7 @@ bool Faction::reqsOk(const RequirableType *rt) const {
             }
         }
 		if(found == false) {
-			if(SystemFlags::getSystemSettingType(SystemFlags::debugLUA).enabled) SystemFlags::OutputDebug(SystemFlags::debugLUA,"In [%s::%s Line: %d]\n",__FILE__,__FUNCTION__, __LINE__);
+			if(SystemFlags::isDebugEnabled(SystemFlags::debugLUA)) SystemFlags::OutputDebug(SystemFlags::debugLUA,"In [%s::%s Line: %d]\n",__FILE__,__FUNCTION__, __LINE__);
             return false;
 		}
     }
@@ -924,7 +966,7 @@ bool Faction::reqsOk(const RequirableType *rt) const {
 	//required upgrades
     for(int i = 0; i < rt->getUpgradeReqCount(); ++i) {
 		if(upgradeManager.isUpgraded(rt->getUpgradeReq(i)) == false) {
-			if(SystemFlags::getSystemSettingType(SystemFlags::debugLUA).enabled) SystemFlags::OutputDebug(SystemFlags::debugLUA,"In [%s::%s Line: %d]\n",__FILE__,__FUNCTION__, __LINE__);
+			if(SystemFlags::isDebugEnabled(SystemFlags::debugLUA)) SystemFlags::OutputDebug(SystemFlags::debugLUA,"In [%s::%s Line: %d]\n",__FILE__,__FUNCTION__, __LINE__);
 			return false;
 		}
     }
@@ -933,7 +975,7 @@ bool Faction::reqsOk(const RequirableType *rt) const {
     	const UnitType *producedUnitType= dynamic_cast<const UnitType *>(rt);
    		if(producedUnitType != NULL && producedUnitType->getMaxUnitCount() > 0) {
 			if(producedUnitType->getMaxUnitCount() <= getCountForMaxUnitCount(producedUnitType)) {
-				if(SystemFlags::getSystemSettingType(SystemFlags::debugLUA).enabled) SystemFlags::OutputDebug(SystemFlags::debugLUA,"In [%s::%s Line: %d]\n",__FILE__,__FUNCTION__, __LINE__);
+				if(SystemFlags::isDebugEnabled(SystemFlags::debugLUA)) SystemFlags::OutputDebug(SystemFlags::debugLUA,"In [%s::%s Line: %d]\n",__FILE__,__FUNCTION__, __LINE__);
 		        return false;
 			}
    		}
@@ -969,14 +1011,14 @@ bool Faction::reqsOk(const CommandType *ct) const {
 	}
 
 	if(ct->getProduced() != NULL && reqsOk(ct->getProduced()) == false) {
-		if(SystemFlags::getSystemSettingType(SystemFlags::debugLUA).enabled) SystemFlags::OutputDebug(SystemFlags::debugLUA,"In [%s::%s Line: %d] reqsOk FAILED\n",__FILE__,__FUNCTION__,__LINE__);
+		if(SystemFlags::isDebugEnabled(SystemFlags::debugLUA)) SystemFlags::OutputDebug(SystemFlags::debugLUA,"In [%s::%s Line: %d] reqsOk FAILED\n",__FILE__,__FUNCTION__,__LINE__);
 		return false;
 	}
 
 	if(ct->getClass() == ccUpgrade) {
 		const UpgradeCommandType *uct= static_cast<const UpgradeCommandType*>(ct);
 		if(upgradeManager.isUpgradingOrUpgraded(uct->getProducedUpgrade())) {
-			if(SystemFlags::getSystemSettingType(SystemFlags::debugLUA).enabled) SystemFlags::OutputDebug(SystemFlags::debugLUA,"In [%s::%s Line: %d] upgrade check FAILED\n",__FILE__,__FUNCTION__,__LINE__);
+			if(SystemFlags::isDebugEnabled(SystemFlags::debugLUA)) SystemFlags::OutputDebug(SystemFlags::debugLUA,"In [%s::%s Line: %d] upgrade check FAILED\n",__FILE__,__FUNCTION__,__LINE__);
 			return false;
 		}
 	}
@@ -1478,7 +1520,7 @@ void Faction::addResourceTargetToCache(const Vec2i &pos,bool incrementUseCounter
 		if(duplicateEntry == false) {
 			cacheResourceTargetList[pos] = 1;
 
-			if(SystemFlags::getSystemSettingType(SystemFlags::debugWorldSynch).enabled == true) {
+			if(SystemFlags::isDebugEnabled(SystemFlags::debugWorldSynch) == true) {
 				char szBuf[8096]="";
 				snprintf(szBuf,8096,"[addResourceTargetToCache] pos [%s]cacheResourceTargetList.size() [" MG_SIZE_T_SPECIFIER "]",
 								pos.getString().c_str(),cacheResourceTargetList.size());
@@ -1501,7 +1543,7 @@ void Faction::removeResourceTargetFromCache(const Vec2i &pos) {
 			if(iter != cacheResourceTargetList.end()) {
 				cacheResourceTargetList.erase(pos);
 
-				if(SystemFlags::getSystemSettingType(SystemFlags::debugWorldSynch).enabled == true) {
+				if(SystemFlags::isDebugEnabled(SystemFlags::debugWorldSynch) == true) {
 					char szBuf[8096]="";
 					snprintf(szBuf,8096,"[removeResourceTargetFromCache] pos [%s]cacheResourceTargetList.size() [" MG_SIZE_T_SPECIFIER "]",
 									pos.getString().c_str(),cacheResourceTargetList.size());
@@ -1548,7 +1590,7 @@ Vec2i Faction::getClosestResourceTypeTargetFromCache(Unit *unit, const ResourceT
 
 	if(cachingDisabled == false) {
 		if(cacheResourceTargetList.empty() == false) {
-			if(SystemFlags::getSystemSettingType(SystemFlags::debugWorldSynch).enabled == true) {
+			if(SystemFlags::isDebugEnabled(SystemFlags::debugWorldSynch) == true) {
 				char szBuf[8096]="";
 				snprintf(szBuf,8096,"cacheResourceTargetList.size() [" MG_SIZE_T_SPECIFIER "]",cacheResourceTargetList.size());
 
@@ -1664,7 +1706,7 @@ Vec2i Faction::getClosestResourceTypeTargetFromCache(Unit *unit, const ResourceT
 			}
 
 			if(deleteList.empty() == false) {
-				if(SystemFlags::getSystemSettingType(SystemFlags::debugWorldSynch).enabled == true) {
+				if(SystemFlags::isDebugEnabled(SystemFlags::debugWorldSynch) == true) {
 					char szBuf[8096]="";
 					snprintf(szBuf,8096,"[cleaning old resource targets] deleteList.size() [" MG_SIZE_T_SPECIFIER "] cacheResourceTargetList.size() [" MG_SIZE_T_SPECIFIER "] result [%s]",
 										deleteList.size(),cacheResourceTargetList.size(),result.getString().c_str());
@@ -1820,7 +1862,7 @@ void Faction::cleanupResourceTypeTargetCache(std::vector<Vec2i> *deleteListPtr,i
 				}
 
 				if(deleteList.empty() == false) {
-					if(SystemFlags::getSystemSettingType(SystemFlags::debugWorldSynch).enabled == true) {
+					if(SystemFlags::isDebugEnabled(SystemFlags::debugWorldSynch) == true) {
 						char szBuf[8095]="";
 						snprintf(szBuf,8095,"[cleaning old resource targets] deleteList.size() [" MG_SIZE_T_SPECIFIER "] cacheResourceTargetList.size() [" MG_SIZE_T_SPECIFIER "], needToCleanup [%d]",
 											deleteList.size(),cacheResourceTargetList.size(),needToCleanup);
@@ -2049,9 +2091,8 @@ void Faction::deletePixels() {
 
 int Faction::getFrameCount() {
 	int frameCount = 0;
-	const Game *game = Renderer::getInstance().getGame();
-	if(game != NULL && game->getWorld() != NULL) {
-		frameCount = game->getWorld()->getFrameCount();
+	if(world != NULL) {
+		frameCount = world->getFrameCount();
 	}
 
 	return frameCount;
@@ -2514,57 +2555,66 @@ void Faction::addCRC_DetailsForWorldFrame(int worldFrameCount,bool isNetworkServ
 	if(isNetworkServer == true) {
 		MAX_FRAME_CACHE += 250;
 	}
-	crcWorldFrameDetails[worldFrameCount] = this->toString(true);
-	//if(worldFrameCount <= 0) printf("Adding world frame: %d log entries: %lld\n",worldFrameCount,(long long int)crcWorldFrameDetails.size());
+	crcWorldFrameSnapshots.setCapacity(MAX_FRAME_CACHE);
+
+	// binary values only, the text is built when a frame is asked for
+	SynchSnapshotWriter writer = crcWorldFrameSnapshots.beginFrame(worldFrameCount);
+	writer.addInt(ssfFactionIndex,index);
+	writer.addInt(ssfTeamIndex,teamIndex);
+	writer.addInt(ssfStartLocationIndex,startLocationIndex);
+	for(unsigned int i = 0; i < resources.size(); ++i) {
+		addCRC_SnapshotResource(writer,ssfResourceType,resources[i]);
+	}
+	for(unsigned int i = 0; i < store.size(); ++i) {
+		addCRC_SnapshotResource(writer,ssfStoreType,store[i]);
+	}
+	//if(worldFrameCount <= 0) printf("Adding world frame: %d log entries: %d\n",worldFrameCount,crcWorldFrameSnapshots.getFrameCount());
 
 	for(unsigned int i = 0; i < units.size(); ++i) {
 		Unit *unit = units[i];
+		unit->addSynchSnapshot(writer);
 
 		unit->getRandom()->clearLastCaller();
 		unit->clearNetworkCRCDecHpList();
 		unit->clearParticleInfo();
 	}
+}
 
-	if((unsigned int)crcWorldFrameDetails.size() > MAX_FRAME_CACHE) {
-		//printf("===> Removing older world frame log entries: %lld\n",(long long int)crcWorldFrameDetails.size());
-
-		for(;(unsigned int)crcWorldFrameDetails.size() - MAX_FRAME_CACHE > 0;) {
-			crcWorldFrameDetails.erase(crcWorldFrameDetails.begin());
-		}
-	}
+void Faction::addCRC_SnapshotResource(SynchSnapshotWriter &writer, SynchSnapshotField typeField, const Resource &resource) const {
+	writer.addTypeName(typeField,resource.getType());
+	writer.addInt(ssfResourceAmount,resource.getAmount());
+	writer.addInt(ssfResourcePosX,resource.getPos().x);
+	writer.addInt(ssfResourcePosY,resource.getPos().y);
+	writer.addInt(ssfResourceBalance,resource.getBalance());
 }
 
 string Faction::getCRC_DetailsForWorldFrame(int worldFrameCount) {
-	if(crcWorldFrameDetails.empty()) {
+	int frameIndex = crcWorldFrameSnapshots.findFrameIndex(worldFrameCount);
+	if(frameIndex < 0) {
 		return "";
 	}
-	return crcWorldFrameDetails[worldFrameCount];
+	return crcWorldFrameSnapshots.renderFrame(frameIndex);
 }
 
 std::pair<int,string> Faction::getCRC_DetailsForWorldFrameIndex(int worldFrameIndex) const {
-	if(crcWorldFrameDetails.empty()) {
-		return make_pair<int,string>(0,"");
-	}
-	std::map<int,string>::const_iterator iterMap = crcWorldFrameDetails.begin();
-	std::advance( iterMap, worldFrameIndex );
-	if(iterMap == crcWorldFrameDetails.end()) {
+	if(worldFrameIndex < 0 || worldFrameIndex >= crcWorldFrameSnapshots.getFrameCount()) {
 		return make_pair<int,string>(0,"");
 	}
-	return std::pair<int,string>(iterMap->first,iterMap->second);
+	return std::pair<int,string>(crcWorldFrameSnapshots.getWorldFrame(worldFrameIndex),
+								 crcWorldFrameSnapshots.renderFrame(worldFrameIndex));
 }
 
 string Faction::getCRC_DetailsForWorldFrames() const {
 	string result = "";
-	for(std::map<int,string>::const_iterator iterMap = crcWorldFrameDetails.begin();
-			iterMap != crcWorldFrameDetails.end(); ++iterMap) {
+	for(int frameIndex = 0; frameIndex < crcWorldFrameSnapshots.getFrameCount(); ++frameIndex) {
 		result += string("============================================================================\n");
-		result += string("** world frame: ") + intToStr(iterMap->first) + string(" detail: ") + iterMap->second;
+		result += string("** world frame: ") + intToStr(crcWorldFrameSnapshots.getWorldFrame(frameIndex)) + string(" detail: ") + crcWorldFrameSnapshots.renderFrame(frameIndex);
 	}
 	return result;
 }
 
 uint64 Faction::getCRC_DetailsForWorldFrameCount() const {
-	return crcWorldFrameDetails.size();
+	return crcWorldFrameSnapshots.getFrameCount();
 }
 
 }}//end namespace
@@ -27,6 +27,8 @@
 #include "base_thread.h"
 #include <set>
 #include "faction_type.h"
+#include "synch_snapshot.h"
+#include "mpsc_ring.h"
 #include "leak_dumper.h"
 
 using std::map;
@@ -58,19 +60,6 @@ public:
 	std::map<Vec2i,float> surfPosAlphaList;
 };
 
-class ExploredCellsLookupItem {
-public:
-
-	ExploredCellsLookupItem() {
-		ExploredCellsLookupItemCacheTimerCountIndex = 0;
-	}
-	int ExploredCellsLookupItemCacheTimerCountIndex;
-	std::vector<SurfaceCell *> exploredCellList;
-	std::vector<SurfaceCell *> visibleCellList;
-
-	static time_t lastDebug;
-};
-
 // =====================================================
 // 	class Faction
 //
@@ -95,9 +84,12 @@ protected:
 	Mutex *triggerIdMutex;
 	std::pair<int,bool> frameIndex;
 	MasterSlaveThreadController *masterController;
+	CompletionLatch *completionLatch;
+	int completionLatchGeneration;
 
 	virtual void setQuitStatus(bool value);
 	virtual void setTaskCompleted(int frameIndex);
+	void releaseCompletionLatch();
 	virtual bool canShutdown(bool deleteSelfIfShutdownDelayed=false);
 
 public:
@@ -108,7 +100,7 @@ public:
 	virtual void setMasterController(MasterSlaveThreadController *master) { masterController = master; }
 	virtual void signalSlave(void *userdata) { signalPathfinder(*((int *)(userdata))); }
 
-    void signalPathfinder(int frameIndex);
+    void signalPathfinder(int frameIndex, CompletionLatch *latch=NULL, int latchGeneration=0);
     bool isSignalPathfinderCompleted(int frameIndex);
 };
 
@@ -179,9 +171,13 @@ private:
 	TechTree *techTree;
 	const XmlNode *loadWorldNode;
 
+	// Entries from the precache threads, pushed without a lock. The mutex
+	// only guards the overflow list used once the ring is full
+	MpscRing<string> *worldSynchThreadedLogRing;
+	Mutex *worldSynchThreadedLogListMutex;
 	std::vector<string> worldSynchThreadedLogList;
 
-	std::map<int,string> crcWorldFrameDetails;
+	SynchSnapshotRing crcWorldFrameSnapshots;
 
 	std::map<int,const Unit *> aliveUnitListCache;
 	std::map<int,const Unit *> mobileUnitListCache;
@@ -208,20 +204,35 @@ public:
 	bool hasAliveUnits(bool filterMobileUnits, bool filterBuiltUnits) const;
 
 	inline void addWorldSynchThreadedLogList(const string &data) {
-		if(SystemFlags::getSystemSettingType(SystemFlags::debugWorldSynch).enabled == true) {
-			worldSynchThreadedLogList.push_back(data);
+		if(SystemFlags::isDebugEnabled(SystemFlags::debugWorldSynch) == true) {
+			string entry = data;
+			if(worldSynchThreadedLogRing == NULL || worldSynchThreadedLogRing->tryPush(entry) == false) {
+				// units of one faction may be precached on several pool threads at once
+				MutexSafeWrapper safeMutex(worldSynchThreadedLogListMutex,string(__FILE__) + "_" + intToStr(__LINE__));
+				worldSynchThreadedLogList.push_back(entry);
+			}
 		}
 	}
 	inline void clearWorldSynchThreadedLogList() {
-		if(SystemFlags::getSystemSettingType(SystemFlags::debugWorldSynch).enabled == true) {
+		if(SystemFlags::isDebugEnabled(SystemFlags::debugWorldSynch) == true) {
+			string entry;
+			while(worldSynchThreadedLogRing != NULL && worldSynchThreadedLogRing->tryPop(entry) == true) {
+			}
 			worldSynchThreadedLogList.clear();
 		}
 	}
+	// Called by the world once the precache threads are done. Nothing is
+	// popped while they push, so once the ring filled up every later entry
+	// went to the overflow list and ring then list keeps the order
 	inline void dumpWorldSynchThreadedLogList() {
-		if(SystemFlags::getSystemSettingType(SystemFlags::debugWorldSynch).enabled == true) {
+		if(SystemFlags::isDebugEnabled(SystemFlags::debugWorldSynch) == true) {
+			string entry;
+			while(worldSynchThreadedLogRing != NULL && worldSynchThreadedLogRing->tryPop(entry) == true) {
+				SystemFlags::OutputDebug(SystemFlags::debugWorldSynch,"%s",entry.c_str());
+			}
 			if(worldSynchThreadedLogList.empty() == false) {
 				for(unsigned int index = 0; index < worldSynchThreadedLogList.size(); ++index) {
-					SystemFlags::OutputDebug(SystemFlags::debugWorldSynch,worldSynchThreadedLogList[index].c_str());
+					SystemFlags::OutputDebug(SystemFlags::debugWorldSynch,"%s",worldSynchThreadedLogList[index].c_str());
 				}
 				worldSynchThreadedLogList.clear();
 			}
@@ -357,7 +368,7 @@ public:
 	inline World * getWorld() { return world; }
 	int getFrameCount();
 
-	void signalWorkerThread(int frameIndex);
+	void signalWorkerThread(int frameIndex, CompletionLatch *latch=NULL, int latchGeneration=0);
 	bool isWorkerThreadSignalCompleted(int frameIndex);
 	FactionThread *getWorkerThread() { return workerThread; }
 
@@ -383,6 +394,7 @@ public:
 	std::pair<int,string> getCRC_DetailsForWorldFrameIndex(int worldFrameIndex) const;
 	string getCRC_DetailsForWorldFrames() const;
 	uint64 getCRC_DetailsForWorldFrameCount() const;
+	const SynchSnapshotRing &getCRC_WorldFrameSnapshots() const { return crcWorldFrameSnapshots; }
 
 	void updateUnitTypeWithResourceCostCache(const ResourceType *rt);
 	bool hasUnitTypeWithResourceCostInCache(const ResourceType *rt) const;
@@ -391,6 +403,7 @@ private:
 	void init();
 	void resetResourceAmount(const ResourceType *rt);
 	bool hasUnitTypeWithResouceCost(const ResourceType *rt);
+	void addCRC_SnapshotResource(SynchSnapshotWriter &writer, SynchSnapshotField typeField, const Resource &resource) const;
 };
 
 }}//end namespace
@@ -26,6 +26,7 @@
 #include "game.h"
 #include "socket.h"
 #include "sound_renderer.h"
+#include "synch_snapshot.h"
 
 #include "leak_dumper.h"
 
@@ -592,6 +593,8 @@ Unit::Unit(int id, UnitPathInterface *unitpath, const Vec2i &pos,
 	this->morphFieldsBlocked=false;
 	//this->lastBadHarvestListPurge = 0;
 	this->oldTotalSight = 0;
+	this->lastExploredSight = -1;
+	this->lastExploredTeam = -1;
 
 	level= NULL;
 	loadType= NULL;
@@ -655,8 +658,6 @@ Unit::Unit(int id, UnitPathInterface *unitpath, const Vec2i &pos,
 	addItemToVault(&this->hp,this->hp);
 	addItemToVault(&this->ep,this->ep);
 
-	calculateFogOfWarRadius();
-
 //	if(isUnitDeleted(this) == true) {
 //		MutexSafeWrapper safeMutex(&mutexDeletedUnits,string(__FILE__) + "_" + intToStr(__LINE__));
 //		deletedUnits.erase(this);
@@ -765,6 +766,7 @@ ParticleSystem * Unit::getFire() const	{
 void Unit::setType(const UnitType *newType) {
 	this->faction->notifyUnitTypeChange(this, newType);
 	this->type = newType;
+	this->type->prefetchSounds();
 }
 
 void Unit::setAlive(bool value) {
@@ -1439,56 +1441,6 @@ void Unit::setPos(const Vec2i &pos, bool clearPathFinder, bool threaded) {
 void Unit::refreshPos(bool forceRefresh) {
 	// Attempt to improve performance
 	this->exploreCells(forceRefresh);
-	calculateFogOfWarRadius(forceRefresh);
-}
-
-FowAlphaCellsLookupItem Unit::getFogOfWarRadius(bool useCache) const {
-	if(useCache == true) {
-		return cachedFow;
-	}
-
-	//iterate through all cells
-	int sightRange= this->getType()->getTotalSight(this->getTotalUpgrade());
-	int radius = sightRange + World::indirectSightRange;
-	PosCircularIterator pci(map, this->getPosNotThreadSafe(), radius);
-	FowAlphaCellsLookupItem result;
-	while(pci.next()){
-		const Vec2i sightpos= pci.getPos();
-		Vec2i surfPos= Map::toSurfCoords(sightpos);
-
-		//compute max alpha
-		float maxAlpha= 0.0f;
-		if(surfPos.x > 1 && surfPos.y > 1 &&
-			surfPos.x < map->getSurfaceW() -2 &&
-				surfPos.y < map->getSurfaceH() -2) {
-			maxAlpha= 1.f;
-		}
-		else if(surfPos.x > 0 && surfPos.y > 0 &&
-				surfPos.x < map->getSurfaceW() -1 &&
-				surfPos.y < map->getSurfaceH() -1) {
-			maxAlpha= 0.3f;
-		}
-
-		//compute alpha
-		float alpha = maxAlpha;
-		float dist = this->getPosNotThreadSafe().dist(sightpos);
-		if(dist > sightRange) {
-			alpha= clamp(1.f-(dist - sightRange) / (World::indirectSightRange), 0.f, maxAlpha);
-		}
-		result.surfPosAlphaList[surfPos] = alpha;
-	}
-	return result;
-}
-
-void Unit::calculateFogOfWarRadius(bool forceRefresh) {
-	if(game->getWorld()->getFogOfWar() == true) {
-		if(forceRefresh || this->pos != this->cachedFowPos) {
-			cachedFow = getFogOfWarRadius(false);
-			static string mutexOwnerId = string(__FILE__) + string("_") + intToStr(__LINE__);
-			MutexSafeWrapper safeMutex(mutexCommands,mutexOwnerId);
-			this->cachedFowPos = this->pos;
-		}
-	}
 }
 
 void Unit::setTargetPos(const Vec2i &targetPos, bool threaded) {
@@ -1822,13 +1774,13 @@ int Unit::getCountOfProducedUnitsPreExistence(const UnitType *ut) const{
 
 //give one command (clear, and push back)
 std::pair<CommandResult,string> Unit::giveCommand(Command *command, bool tryQueue) {
-	if(SystemFlags::getSystemSettingType(SystemFlags::debugUnitCommands).enabled) SystemFlags::OutputDebug(SystemFlags::debugUnitCommands,"\n======================\nUnit Command tryQueue = %d\nUnit Info:\n%s\nCommand Info:\n%s\n",tryQueue,this->toString().c_str(),command->toString(false).c_str());
+	if(SystemFlags::isDebugEnabled(SystemFlags::debugUnitCommands)) SystemFlags::OutputDebug(SystemFlags::debugUnitCommands,"\n======================\nUnit Command tryQueue = %d\nUnit Info:\n%s\nCommand Info:\n%s\n",tryQueue,this->toString().c_str(),command->toString(false).c_str());
 
 	std::pair<CommandResult,string> result(crFailUndefined,"");
 	changedActiveCommand = false;
 
 	Chrono chrono;
-	if(SystemFlags::getSystemSettingType(SystemFlags::debugPerformance).enabled) chrono.start();
+	if(SystemFlags::isDebugEnabled(SystemFlags::debugPerformance)) chrono.start();
 
     if(command == NULL) {
     	throw megaglest_runtime_error("command == NULL");
@@ -1837,22 +1789,22 @@ std::pair<CommandResult,string> Unit::giveCommand(Command *command, bool tryQueu
     	throw megaglest_runtime_error("command->getCommandType() == NULL");
     }
 
-    if(SystemFlags::getSystemSettingType(SystemFlags::debugPerformance).enabled && chrono.getMillis() > 0) SystemFlags::OutputDebug(SystemFlags::debugPerformance,"In [%s::%s] Line: %d took msecs: %lld\n",extractFileFromDirectoryPath(__FILE__).c_str(),__FUNCTION__,__LINE__,chrono.getMillis());
+    if(SystemFlags::isDebugEnabled(SystemFlags::debugPerformance) && chrono.getMillis() > 0) SystemFlags::OutputDebug(SystemFlags::debugPerformance,"In [%s::%s] Line: %d took msecs: %lld\n",extractFileFromDirectoryPath(__FILE__).c_str(),__FUNCTION__,__LINE__,chrono.getMillis());
 
     //printf("In [%s::%s] Line: %d unit [%d - %s] command [%s] tryQueue = %d command->getCommandType()->isQueuable(tryQueue) = %d\n",extractFileFromDirectoryPath(__FILE__).c_str(),__FUNCTION__,__LINE__,this->getId(),this->getType()->getName().c_str(), command->getCommandType()->getName().c_str(), tryQueue,command->getCommandType()->isQueuable(tryQueue));
 
 
 	if(command->getCommandType()->isQueuable(tryQueue)) {
-		if(SystemFlags::getSystemSettingType(SystemFlags::debugPerformance).enabled && chrono.getMillis() > 0) SystemFlags::OutputDebug(SystemFlags::debugPerformance,"In [%s::%s] Line: %d took msecs: %lld\n",extractFileFromDirectoryPath(__FILE__).c_str(),__FUNCTION__,__LINE__,chrono.getMillis());
-		if(SystemFlags::getSystemSettingType(SystemFlags::debugUnitCommands).enabled) SystemFlags::OutputDebug(SystemFlags::debugUnitCommands,"In [%s::%s Line: %d] Command is Queable\n",extractFileFromDirectoryPath(__FILE__).c_str(),__FUNCTION__,__LINE__);
+		if(SystemFlags::isDebugEnabled(SystemFlags::debugPerformance) && chrono.getMillis() > 0) SystemFlags::OutputDebug(SystemFlags::debugPerformance,"In [%s::%s] Line: %d took msecs: %lld\n",extractFileFromDirectoryPath(__FILE__).c_str(),__FUNCTION__,__LINE__,chrono.getMillis());
+		if(SystemFlags::isDebugEnabled(SystemFlags::debugUnitCommands)) SystemFlags::OutputDebug(SystemFlags::debugUnitCommands,"In [%s::%s Line: %d] Command is Queable\n",extractFileFromDirectoryPath(__FILE__).c_str(),__FUNCTION__,__LINE__);
 
-		if(SystemFlags::getSystemSettingType(SystemFlags::debugPerformance).enabled && chrono.getMillis() > 0) SystemFlags::OutputDebug(SystemFlags::debugPerformance,"In [%s::%s] Line: %d took msecs: %lld\n",extractFileFromDirectoryPath(__FILE__).c_str(),__FUNCTION__,__LINE__,chrono.getMillis());
+		if(SystemFlags::isDebugEnabled(SystemFlags::debugPerformance) && chrono.getMillis() > 0) SystemFlags::OutputDebug(SystemFlags::debugPerformance,"In [%s::%s] Line: %d took msecs: %lld\n",extractFileFromDirectoryPath(__FILE__).c_str(),__FUNCTION__,__LINE__,chrono.getMillis());
 
 		if(!commands.empty()) {
 			auto lastCt= commands.back()->getCommandType();
 			//cancel current command if it is not queuable
 			if(!lastCt->isQueueAppendable()) {
-				if(SystemFlags::getSystemSettingType(SystemFlags::debugUnitCommands).enabled) SystemFlags::OutputDebug(SystemFlags::debugUnitCommands,"In [%s::%s Line: %d] Cancel command because last one is NOT queable [%s]\n",extractFileFromDirectoryPath(__FILE__).c_str(),__FUNCTION__,__LINE__,commands.back()->toString(false).c_str());
+				if(SystemFlags::isDebugEnabled(SystemFlags::debugUnitCommands)) SystemFlags::OutputDebug(SystemFlags::debugUnitCommands,"In [%s::%s Line: %d] Cancel command because last one is NOT queable [%s]\n",extractFileFromDirectoryPath(__FILE__).c_str(),__FUNCTION__,__LINE__,commands.back()->toString(false).c_str());
 
 				cancelCommand();
 			}
@@ -1863,11 +1815,11 @@ std::pair<CommandResult,string> Unit::giveCommand(Command *command, bool tryQueu
 			}
 		}
 
-		if(SystemFlags::getSystemSettingType(SystemFlags::debugPerformance).enabled && chrono.getMillis() > 0) SystemFlags::OutputDebug(SystemFlags::debugPerformance,"In [%s::%s] Line: %d took msecs: %lld\n",extractFileFromDirectoryPath(__FILE__).c_str(),__FUNCTION__,__LINE__,chrono.getMillis());
+		if(SystemFlags::isDebugEnabled(SystemFlags::debugPerformance) && chrono.getMillis() > 0) SystemFlags::OutputDebug(SystemFlags::debugPerformance,"In [%s::%s] Line: %d took msecs: %lld\n",extractFileFromDirectoryPath(__FILE__).c_str(),__FUNCTION__,__LINE__,chrono.getMillis());
 	}
 	else {
 		//empty command queue
-		if(SystemFlags::getSystemSettingType(SystemFlags::debugUnitCommands).enabled) SystemFlags::OutputDebug(SystemFlags::debugUnitCommands,"In [%s::%s Line: %d] Clear commands because current is NOT queable.\n",extractFileFromDirectoryPath(__FILE__).c_str(),__FUNCTION__,__LINE__);
+		if(SystemFlags::isDebugEnabled(SystemFlags::debugUnitCommands)) SystemFlags::OutputDebug(SystemFlags::debugUnitCommands,"In [%s::%s Line: %d] Clear commands because current is NOT queable.\n",extractFileFromDirectoryPath(__FILE__).c_str(),__FUNCTION__,__LINE__);
 
 		bool willChangedActiveCommand = (commands.empty() == false);
 		if(willChangedActiveCommand == true) {
@@ -1903,24 +1855,24 @@ std::pair<CommandResult,string> Unit::giveCommand(Command *command, bool tryQueu
 
 		//printf("In [%s::%s] Line: %d cleared existing commands\n",extractFileFromDirectoryPath(__FILE__).c_str(),__FUNCTION__,__LINE__);
 
-		if(SystemFlags::getSystemSettingType(SystemFlags::debugPerformance).enabled && chrono.getMillis() > 0) SystemFlags::OutputDebug(SystemFlags::debugPerformance,"In [%s::%s] Line: %d took msecs: %lld\n",extractFileFromDirectoryPath(__FILE__).c_str(),__FUNCTION__,__LINE__,chrono.getMillis());
+		if(SystemFlags::isDebugEnabled(SystemFlags::debugPerformance) && chrono.getMillis() > 0) SystemFlags::OutputDebug(SystemFlags::debugPerformance,"In [%s::%s] Line: %d took msecs: %lld\n",extractFileFromDirectoryPath(__FILE__).c_str(),__FUNCTION__,__LINE__,chrono.getMillis());
 	}
 
-	if(SystemFlags::getSystemSettingType(SystemFlags::debugPerformance).enabled && chrono.getMillis() > 0) SystemFlags::OutputDebug(SystemFlags::debugPerformance,"In [%s::%s] Line: %d took msecs: %lld\n",extractFileFromDirectoryPath(__FILE__).c_str(),__FUNCTION__,__LINE__,chrono.getMillis());
+	if(SystemFlags::isDebugEnabled(SystemFlags::debugPerformance) && chrono.getMillis() > 0) SystemFlags::OutputDebug(SystemFlags::debugPerformance,"In [%s::%s] Line: %d took msecs: %lld\n",extractFileFromDirectoryPath(__FILE__).c_str(),__FUNCTION__,__LINE__,chrono.getMillis());
 
 	//check command
 	result= checkCommand(command);
-	if(SystemFlags::getSystemSettingType(SystemFlags::debugUnitCommands).enabled) SystemFlags::OutputDebug(SystemFlags::debugUnitCommands,"In [%s::%s Line: %d] checkCommand returned: [%d]\n",extractFileFromDirectoryPath(__FILE__).c_str(),__FUNCTION__,__LINE__,result.first);
+	if(SystemFlags::isDebugEnabled(SystemFlags::debugUnitCommands)) SystemFlags::OutputDebug(SystemFlags::debugUnitCommands,"In [%s::%s Line: %d] checkCommand returned: [%d]\n",extractFileFromDirectoryPath(__FILE__).c_str(),__FUNCTION__,__LINE__,result.first);
 
 	//printf("In [%s::%s] Line: %d check command returned %d, commands.size() = %d\n[%s]\n\n",extractFileFromDirectoryPath(__FILE__).c_str(),__FUNCTION__,__LINE__,result,commands.size(),command->toString().c_str());
 
-	if(SystemFlags::getSystemSettingType(SystemFlags::debugPerformance).enabled && chrono.getMillis() > 0) SystemFlags::OutputDebug(SystemFlags::debugPerformance,"In [%s::%s] Line: %d took msecs: %lld\n",extractFileFromDirectoryPath(__FILE__).c_str(),__FUNCTION__,__LINE__,chrono.getMillis());
+	if(SystemFlags::isDebugEnabled(SystemFlags::debugPerformance) && chrono.getMillis() > 0) SystemFlags::OutputDebug(SystemFlags::debugPerformance,"In [%s::%s] Line: %d took msecs: %lld\n",extractFileFromDirectoryPath(__FILE__).c_str(),__FUNCTION__,__LINE__,chrono.getMillis());
 
 	if(result.first == crSuccess) {
 		applyCommand(command);
 	}
 
-	if(SystemFlags::getSystemSettingType(SystemFlags::debugPerformance).enabled && chrono.getMillis() > 0) SystemFlags::OutputDebug(SystemFlags::debugPerformance,"In [%s::%s] Line: %d took msecs: %lld\n",extractFileFromDirectoryPath(__FILE__).c_str(),__FUNCTION__,__LINE__,chrono.getMillis());
+	if(SystemFlags::isDebugEnabled(SystemFlags::debugPerformance) && chrono.getMillis() > 0) SystemFlags::OutputDebug(SystemFlags::debugPerformance,"In [%s::%s] Line: %d took msecs: %lld\n",extractFileFromDirectoryPath(__FILE__).c_str(),__FUNCTION__,__LINE__,chrono.getMillis());
 
 	//push back command
 	if(result.first == crSuccess) {
@@ -1936,7 +1888,7 @@ std::pair<CommandResult,string> Unit::giveCommand(Command *command, bool tryQueu
 		changedActiveCommand = false;
 	}
 
-	if(SystemFlags::getSystemSettingType(SystemFlags::debugPerformance).enabled && chrono.getMillis() > 0) SystemFlags::OutputDebug(SystemFlags::debugPerformance,"In [%s::%s] Line: %d took msecs: %lld\n",extractFileFromDirectoryPath(__FILE__).c_str(),__FUNCTION__,__LINE__,chrono.getMillis());
+	if(SystemFlags::isDebugEnabled(SystemFlags::debugPerformance) && chrono.getMillis() > 0) SystemFlags::OutputDebug(SystemFlags::debugPerformance,"In [%s::%s] Line: %d took msecs: %lld\n",extractFileFromDirectoryPath(__FILE__).c_str(),__FUNCTION__,__LINE__,chrono.getMillis());
 
 	return result;
 }
@@ -1948,7 +1900,7 @@ CommandResult Unit::finishCommand() {
 	this->setCurrentUnitTitle("");
 	//is empty?
 	if(commands.empty()) {
-		if(SystemFlags::getSystemSettingType(SystemFlags::debugLUA).enabled) SystemFlags::OutputDebug(SystemFlags::debugLUA,"In [%s::%s Line: %d]\n",extractFileFromDirectoryPath(__FILE__).c_str(),__FUNCTION__, __LINE__);
+		if(SystemFlags::isDebugEnabled(SystemFlags::debugLUA)) SystemFlags::OutputDebug(SystemFlags::debugLUA,"In [%s::%s Line: %d]\n",extractFileFromDirectoryPath(__FILE__).c_str(),__FUNCTION__, __LINE__);
 		return crFailUndefined;
 	}
 
@@ -1986,7 +1938,7 @@ CommandResult Unit::cancelCommand() {
 
 	//is empty?
 	if(commands.empty()){
-		if(SystemFlags::getSystemSettingType(SystemFlags::debugLUA).enabled) SystemFlags::OutputDebug(SystemFlags::debugLUA,"In [%s::%s Line: %d]\n",extractFileFromDirectoryPath(__FILE__).c_str(),__FUNCTION__, __LINE__);
+		if(SystemFlags::isDebugEnabled(SystemFlags::debugLUA)) SystemFlags::OutputDebug(SystemFlags::debugLUA,"In [%s::%s Line: %d]\n",extractFileFromDirectoryPath(__FILE__).c_str(),__FUNCTION__, __LINE__);
 		return crFailUndefined;
 	}
 
@@ -2090,7 +2042,7 @@ void Unit::kill() {
 
 void Unit::undertake() {
 	try {
-		if(SystemFlags::getSystemSettingType(SystemFlags::debugSystem).enabled) SystemFlags::OutputDebug(SystemFlags::debugSystem,"In [%s::%s Line: %d] about to undertake unit id = %d [%s] [%s]\n",extractFileFromDirectoryPath(__FILE__).c_str(),__FUNCTION__,__LINE__,this->id, this->getFullName(false).c_str(),this->getDesc(false).c_str());
+		if(SystemFlags::isDebugEnabled(SystemFlags::debugSystem)) SystemFlags::OutputDebug(SystemFlags::debugSystem,"In [%s::%s Line: %d] about to undertake unit id = %d [%s] [%s]\n",extractFileFromDirectoryPath(__FILE__).c_str(),__FUNCTION__,__LINE__,this->id, this->getFullName(false).c_str(),this->getDesc(false).c_str());
 
 		// Remove any units that were previously in attack-boost range
 		if(currentAttackBoostOriginatorEffect.currentAttackBoostUnits.empty() == false && currentAttackBoostOriginatorEffect.skillType != NULL) {
@@ -2107,21 +2059,22 @@ void Unit::undertake() {
 			currentAttackBoostOriginatorEffect.currentAttackBoostUnits.clear();
 		}
 
-		if(SystemFlags::getSystemSettingType(SystemFlags::debugSystem).enabled) SystemFlags::OutputDebug(SystemFlags::debugSystem,"In [%s::%s Line: %d]\n",extractFileFromDirectoryPath(__FILE__).c_str(),__FUNCTION__,__LINE__);
+		if(SystemFlags::isDebugEnabled(SystemFlags::debugSystem)) SystemFlags::OutputDebug(SystemFlags::debugSystem,"In [%s::%s Line: %d]\n",extractFileFromDirectoryPath(__FILE__).c_str(),__FUNCTION__,__LINE__);
 
 		UnitUpdater *unitUpdater = game->getWorld()->getUnitUpdater();
 
-		if(SystemFlags::getSystemSettingType(SystemFlags::debugSystem).enabled) SystemFlags::OutputDebug(SystemFlags::debugSystem,"In [%s::%s Line: %d]\n",extractFileFromDirectoryPath(__FILE__).c_str(),__FUNCTION__,__LINE__);
+		if(SystemFlags::isDebugEnabled(SystemFlags::debugSystem)) SystemFlags::OutputDebug(SystemFlags::debugSystem,"In [%s::%s Line: %d]\n",extractFileFromDirectoryPath(__FILE__).c_str(),__FUNCTION__,__LINE__);
 
 		//unitUpdater->clearUnitPrecache(this);
 		unitUpdater->removeUnitPrecache(this);
+		map->removeUnitFromGrid(this);
 
-		if(SystemFlags::getSystemSettingType(SystemFlags::debugSystem).enabled) SystemFlags::OutputDebug(SystemFlags::debugSystem,"In [%s::%s Line: %d]\n",extractFileFromDirectoryPath(__FILE__).c_str(),__FUNCTION__,__LINE__);
+		if(SystemFlags::isDebugEnabled(SystemFlags::debugSystem)) SystemFlags::OutputDebug(SystemFlags::debugSystem,"In [%s::%s Line: %d]\n",extractFileFromDirectoryPath(__FILE__).c_str(),__FUNCTION__,__LINE__);
 
 		this->faction->deleteLivingUnits(id);
 		this->faction->deleteLivingUnitsp(this);
 
-		if(SystemFlags::getSystemSettingType(SystemFlags::debugSystem).enabled) SystemFlags::OutputDebug(SystemFlags::debugSystem,"In [%s::%s Line: %d]\n",extractFileFromDirectoryPath(__FILE__).c_str(),__FUNCTION__,__LINE__);
+		if(SystemFlags::isDebugEnabled(SystemFlags::debugSystem)) SystemFlags::OutputDebug(SystemFlags::debugSystem,"In [%s::%s Line: %d]\n",extractFileFromDirectoryPath(__FILE__).c_str(),__FUNCTION__,__LINE__);
 
 		faction->removeUnit(this);
 	}
@@ -2640,8 +2593,7 @@ bool Unit::update() {
 
 	//highlight
 	if(highlight > 0.f) {
-		const Game *game = Renderer::getInstance().getGame();
-		highlight -= 1.f / (Game::highlightTime * game->getWorld()->getUpdateFps(this->getFactionIndex()));
+		highlight -= 1.f / (Game::highlightTime * faction->getWorld()->getUpdateFps(this->getFactionIndex()));
 	}
 
 	if(currSkill == NULL) {
@@ -2673,7 +2625,6 @@ bool Unit::update() {
 
 	//update progresses
 	this->lastAnimProgress= this->animProgress;
-	const Game *game = Renderer::getInstance().getGame();
 
 	if(animProgress==0){
 		AnimCycleStarts();
@@ -2722,7 +2673,7 @@ bool Unit::update() {
 	else {
 		int64 heightFactor   = getHeightFactor(ANIMATION_SPEED_MULTIPLIER);
 		int64 speedDenominator = speedDivider *
-				game->getWorld()->getUpdateFps(this->getFactionIndex());
+				faction->getWorld()->getUpdateFps(this->getFactionIndex());
 		
 		// Override the animation speed for attacks that have upgraded the attack speed
 		int animSpeed = currSkill->getAnimSpeed();
@@ -3834,7 +3785,7 @@ std::pair<CommandResult,string> Unit::checkCommand(Command *command) const {
        command->getUnit() == this ||
        getType()->hasCommandType(command->getCommandType()) == false ||
        (ignoreCheckCommand == false && this->getFaction()->reqsOk(command->getCommandType()) == false)) {
-		if(SystemFlags::getSystemSettingType(SystemFlags::debugLUA).enabled) SystemFlags::OutputDebug(SystemFlags::debugLUA,"In [%s::%s Line: %d] isOperative() = %d, command->getUnit() = %p, getType()->hasCommandType(command->getCommandType()) = %d, this->getFaction()->reqsOk(command->getCommandType()) = %d\n",extractFileFromDirectoryPath(__FILE__).c_str(),__FUNCTION__, __LINE__,isOperative(),command->getUnit(),getType()->hasCommandType(command->getCommandType()),this->getFaction()->reqsOk(command->getCommandType()));
+		if(SystemFlags::isDebugEnabled(SystemFlags::debugLUA)) SystemFlags::OutputDebug(SystemFlags::debugLUA,"In [%s::%s Line: %d] isOperative() = %d, command->getUnit() = %p, getType()->hasCommandType(command->getCommandType()) = %d, this->getFaction()->reqsOk(command->getCommandType()) = %d\n",extractFileFromDirectoryPath(__FILE__).c_str(),__FUNCTION__, __LINE__,isOperative(),command->getUnit(),getType()->hasCommandType(command->getCommandType()),this->getFaction()->reqsOk(command->getCommandType()));
 
 		auto mct = getCurrMorphCt();
 		// Allow self healing if able to heal own unit type
@@ -3856,7 +3807,7 @@ std::pair<CommandResult,string> Unit::checkCommand(Command *command) const {
 
 	//if pos is not inside the world (if comand has not a pos, pos is (0, 0) and is inside world
 	if(map->isInside(command->getPos()) == false) {
-		if(SystemFlags::getSystemSettingType(SystemFlags::debugLUA).enabled) SystemFlags::OutputDebug(SystemFlags::debugLUA,"In [%s::%s Line: %d]\n",extractFileFromDirectoryPath(__FILE__).c_str(),__FUNCTION__, __LINE__);
+		if(SystemFlags::isDebugEnabled(SystemFlags::debugLUA)) SystemFlags::OutputDebug(SystemFlags::debugLUA,"In [%s::%s Line: %d]\n",extractFileFromDirectoryPath(__FILE__).c_str(),__FUNCTION__, __LINE__);
 		//printf("In [%s::%s Line: %d] command = %p\n",extractFileFromDirectoryPath(__FILE__).c_str(),__FUNCTION__,__LINE__,command);
 
 		result.first = crFailUndefined;
@@ -3931,7 +3882,7 @@ std::pair<CommandResult,string> Unit::checkCommand(Command *command) const {
 		}
 
 		if(faction->getUpgradeManager()->isUpgradingOrUpgraded(uct->getProducedUpgrade())){
-			if(SystemFlags::getSystemSettingType(SystemFlags::debugLUA).enabled) SystemFlags::OutputDebug(SystemFlags::debugLUA,"In [%s::%s Line: %d]\n",extractFileFromDirectoryPath(__FILE__).c_str(),__FUNCTION__, __LINE__);
+			if(SystemFlags::isDebugEnabled(SystemFlags::debugLUA)) SystemFlags::OutputDebug(SystemFlags::debugLUA,"In [%s::%s Line: %d]\n",extractFileFromDirectoryPath(__FILE__).c_str(),__FUNCTION__, __LINE__);
 			//printf("In [%s::%s Line: %d] command = %p\n",extractFileFromDirectoryPath(__FILE__).c_str(),__FUNCTION__,__LINE__,command);
 			result.first = crFailUndefined;
 			return result;
@@ -4390,8 +4341,7 @@ void Unit::startDamageParticles() {
 		if(type->getProperty(UnitType::pBurnable) && this->fire == NULL) {
 			FireParticleSystem *fps = new FireParticleSystem(200);
 			fps->setParticleOwner(this);
-			const Game *game = Renderer::getInstance().getGame();
-			fps->setSpeed(2.5f / game->getWorld()->getUpdateFps(this->getFactionIndex()));
+			fps->setSpeed(2.5f / faction->getWorld()->getUpdateFps(this->getFactionIndex()));
 			fps->setPos(getCurrBurnVector());
 			fps->setRadius(type->getSize()/3.f);
 			fps->setTexture(CoreData::getInstance().getFireTexture());
@@ -4415,8 +4365,7 @@ void Unit::startDamageParticles() {
 				ups->setRadius(type->getSize()/3.f);
 				ups->setShape(::Shared::Graphics::UnitParticleSystem::sLinear);
 				ups->setTexture(CoreData::getInstance().getFireTexture());
-				const Game *game = Renderer::getInstance().getGame();
-				ups->setSpeed(2.0f / game->getWorld()->getUpdateFps(this->getFactionIndex()));
+				ups->setSpeed(2.0f / faction->getWorld()->getUpdateFps(this->getFactionIndex()));
 				ups->setGravity(0.0004f);
 				ups->setEmissionRate(1);
 				ups->setMaxParticleEnergy(150);
@@ -4473,20 +4422,16 @@ void Unit::exploreCells(bool forceRefresh) {
 			throw megaglest_runtime_error("game->getWorld() == NULL");
 		}
 
-		// Try the local unit exploration cache
-		if( !forceRefresh &&
-			cacheExploredCellsKey.first == newPos &&
-			cacheExploredCellsKey.second == sightRange) {
-			game->getWorld()->exploreCells(teamIndex, cacheExploredCells);
-		}
-		else {
-			// Try the world exploration scan or possible cache
-			cacheExploredCells = game->getWorld()->exploreCells(newPos, sightRange, teamIndex, this);
-
-			// Cache the result for this unit
-			cacheExploredCellsKey.first = newPos;
-			cacheExploredCellsKey.second = sightRange;
+		// cells stay explored, so only a unit that moved, changed its sight
+		// or its team explores again
+		if(forceRefresh == true || newPos != lastExploredPos ||
+			sightRange != lastExploredSight || teamIndex != lastExploredTeam) {
+			game->getWorld()->exploreCells(newPos, sightRange, teamIndex, this);
+			lastExploredPos = newPos;
+			lastExploredSight = sightRange;
+			lastExploredTeam = teamIndex;
 		}
+		game->getWorld()->updateUnitSight(this, newPos, sightRange, teamIndex);
 	}
 }
 
@@ -4497,7 +4442,7 @@ void Unit::logSynchDataThreaded(string file,int line,string source) {
 	logSynchDataCommon(file,line,source,true);
 }
 void Unit::logSynchDataCommon(string file,int line,string source,bool threadedMode) {
-	if(SystemFlags::getSystemSettingType(SystemFlags::debugWorldSynch).enabled == true) {
+	if(SystemFlags::isDebugEnabled(SystemFlags::debugWorldSynch) == true) {
 	    char szBuf[8096]="";
 	    snprintf(szBuf,8096,
 	    		"FrameCount [%d] Unit = %d [%s][%s] pos = %s, lastPos = %s, targetPos = %s, targetVec = %s, meetingPos = %s, progress [" MG_I64_SPECIFIER "], progress2 [%d] random [%d]\nUnit Path [%s]\n",
@@ -4706,14 +4651,6 @@ Vec2i Unit::getPos() {
 }
 
 void Unit::clearCaches() {
-	cachedFow.surfPosAlphaList.clear();
-	cachedFowPos = Vec2i(0,0);
-
-	cacheExploredCells.exploredCellList.clear();
-	cacheExploredCells.visibleCellList.clear();
-	cacheExploredCellsKey.first = Vec2i(-1,-1);
-	cacheExploredCellsKey.second = -1;
-
 	if(unitPath != NULL) {
 		unitPath->clearCaches();
 	}
@@ -5909,4 +5846,84 @@ Checksum Unit::getCRC() {
 	return crcForUnit;
 }
 
+void Unit::addSynchSnapshot(SynchSnapshotWriter &writer) {
+	// the same state getCRC covers, as raw values instead of a sum
+	writer.addInt(ssfUnitId,id);
+	writer.addTypeName(ssfUnitType,type);
+	writer.addInt(ssfUnitHp,hp);
+	writer.addInt(ssfUnitEp,ep);
+	writer.addInt(ssfUnitLoadCount,loadCount);
+	writer.addInt(ssfUnitDeadCount,deadCount);
+	writer.addInt64(ssfUnitProgress,progress);
+	writer.addInt64(ssfUnitLastAnimProgress,lastAnimProgress);
+	writer.addInt64(ssfUnitAnimProgress,animProgress);
+	writer.addInt(ssfUnitProgress2,progress2);
+	writer.addInt(ssfUnitKills,kills);
+	writer.addInt(ssfUnitEnemyKills,enemyKills);
+	writer.addInt(ssfUnitMorphFieldsBlocked,morphFieldsBlocked);
+	writer.addInt(ssfUnitTargetRef,targetRef.getUnitId());
+	writer.addInt(ssfUnitCurrField,currField);
+	writer.addInt(ssfUnitTargetField,targetField);
+	writer.addTypeName(ssfUnitLevel,level);
+
+	writer.addInt(ssfUnitPosX,pos.x);
+	writer.addInt(ssfUnitPosY,pos.y);
+	writer.addInt(ssfUnitLastPosX,lastPos.x);
+	writer.addInt(ssfUnitLastPosY,lastPos.y);
+	writer.addInt(ssfUnitTargetPosX,targetPos.x);
+	writer.addInt(ssfUnitTargetPosY,targetPos.y);
+	writer.addInt(ssfUnitMeetingPosX,meetingPos.x);
+	writer.addInt(ssfUnitMeetingPosY,meetingPos.y);
+
+	writer.addTypeName(ssfUnitPreMorphType,preMorph_type);
+	writer.addTypeName(ssfUnitLoadType,loadType);
+	writer.addTypeName(ssfUnitSkill,currSkill);
+	writer.addInt(ssfUnitToBeUndertaken,toBeUndertaken);
+	writer.addInt(ssfUnitAlive,alive);
+	if(fire != NULL) {
+		writer.addInt(ssfUnitFireActive,fire->getActive());
+	}
+
+	writer.addUInt(ssfUnitTotalUpgradeCRC,totalUpgrade.getCRC().getSum());
+	if(unitPath != NULL) {
+		writer.addUInt(ssfUnitPathCRC,unitPath->getCRC().getSum());
+	}
+	writer.addInt(ssfUnitCommandCount,(int)commands.size());
+	for(Commands::const_iterator it= commands.begin(); it != commands.end(); ++it) {
+		writer.addUInt(ssfUnitCommandCRC,(*it)->getCRC().getSum());
+	}
+
+	writer.addInt(ssfUnitDamageParticleSystems,(int)damageParticleSystems.size());
+	writer.addInt(ssfUnitModelFacing,modelFacing);
+	writer.addInt(ssfUnitInBailOutAttempt,inBailOutAttempt);
+	writer.addInt(ssfUnitBadHarvestPosCount,(int)badHarvestPosList.size());
+	writer.addUInt(ssfUnitLastStuckFrame,lastStuckFrame);
+	writer.addInt(ssfUnitLastStuckPosX,lastStuckPos.x);
+	writer.addInt(ssfUnitLastStuckPosY,lastStuckPos.y);
+	writer.addInt(ssfUnitAttackBoostUnits,(int)currentAttackBoostOriginatorEffect.currentAttackBoostUnits.size());
+	writer.addInt(ssfUnitDesiredFinalPosX,currentPathFinderDesiredFinalPos.x);
+	writer.addInt(ssfUnitDesiredFinalPosY,currentPathFinderDesiredFinalPos.y);
+	writer.addInt(ssfUnitLastHarvestedPosX,lastHarvestedResourcePos.x);
+	writer.addInt(ssfUnitLastHarvestedPosY,lastHarvestedResourcePos.y);
+	writer.addInt(ssfUnitAttackParticleSystems,(int)attackParticleSystems.size());
+
+	writer.addInt(ssfUnitRandomLastNumber,random.getLastNumber());
+	string lastCaller = random.getLastCaller();
+	if(lastCaller != "") {
+		writer.addString(ssfUnitRandomLastCaller,lastCaller);
+	}
+	if(networkCRCLogInfo != "") {
+		writer.addString(ssfUnitNetworkCRCLogInfo,networkCRCLogInfo);
+	}
+	if(networkCRCParticleLogInfo != "") {
+		writer.addString(ssfUnitNetworkCRCParticleLogInfo,networkCRCParticleLogInfo);
+	}
+	for(unsigned int index = 0; index < networkCRCDecHpList.size(); ++index) {
+		writer.addString(ssfUnitNetworkCRCDecHp,networkCRCDecHpList[index]);
+	}
+	for(unsigned int index = 0; index < networkCRCParticleInfoList.size(); ++index) {
+		writer.addString(ssfUnitParticleInfo,networkCRCParticleInfoList[index]);
+	}
+}
+
 }}//end namespace
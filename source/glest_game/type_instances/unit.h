@@ -51,6 +51,7 @@ class SkillType;
 class UnitType;
 class TotalUpgrade;
 class UpgradeType;
+class SynchSnapshotWriter;
 class Level;
 class MorphCommandType;
 class Game;
@@ -485,11 +486,11 @@ private:
 	RandomGen random;
 	int32 pathFindRefreshCellCount;
 
-	FowAlphaCellsLookupItem cachedFow;
-	Vec2i cachedFowPos;
+	// what the last exploreCells explored, an unchanged unit skips it
+	Vec2i lastExploredPos;
+	int lastExploredSight;
+	int lastExploredTeam;
 
-	ExploredCellsLookupItem cacheExploredCells;
-	std::pair<Vec2i, int> cacheExploredCellsKey;
 
 	Vec2i lastHarvestedResourcePos;
 
@@ -518,10 +519,6 @@ public:
     inline void incrementPathfindFailedConsecutiveFrameCount() { pathfindFailedConsecutiveFrameCount++; }
     inline void resetPathfindFailedConsecutiveFrameCount() { pathfindFailedConsecutiveFrameCount=0; }
 
-    const FowAlphaCellsLookupItem & getCachedFow() const { return cachedFow; }
-    FowAlphaCellsLookupItem getFogOfWarRadius(bool useCache) const;
-    void calculateFogOfWarRadius(bool forceRefresh=false);
-
     //queries
     Command *getCurrrentCommandThreadSafe();
     void setIgnoreCheckCommand(bool value)      { ignoreCheckCommand=value;}
@@ -802,6 +799,7 @@ public:
 	void addAttackParticleSystem(ParticleSystem *ps);
 
 	Checksum getCRC();
+	void addSynchSnapshot(SynchSnapshotWriter &writer);
 
 	virtual void end(ParticleSystem *particleSystem);
 	virtual void logParticleInfo(string info);
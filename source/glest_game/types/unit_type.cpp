@@ -94,6 +94,7 @@ UnitType::UnitType() : ProducibleType() {
 	healthbarVisible=hbvUndefined;
     multiSelect= false;
     uniformSelect= false;
+    soundsPrefetched= false;
     commandable= true;
 	armorType= NULL;
 	rotatedBuildPos=0;
@@ -1211,6 +1212,48 @@ bool UnitType::isOfClass(UnitClass uc) const{
 	return false;
 }
 
+// ==================== other ====================
+
+// The sounds are decoded in the background when the first unit of the
+// type, or of a type that can create it, is created, the others are
+// decoded when first played
+void UnitType::prefetchSounds() const {
+	if(soundsPrefetched == true) {
+		return;
+	}
+	soundsPrefetched= true;
+
+	selectionSounds.prefetchSounds();
+	commandSounds.prefetchSounds();
+	for(int i = 0; i < getSkillTypeCount(); ++i) {
+		const SkillSoundList *skillSoundList= skillTypes[i]->getSkillSoundList();
+		for(SkillSoundList::const_iterator iterSound = skillSoundList->begin();
+			iterSound != skillSoundList->end(); ++iterSound) {
+			(*iterSound)->getSoundContainer()->prefetchSounds();
+		}
+	}
+}
+
+// The types this one builds, produces or morphs into, whose sounds play
+// right after those of the starting units
+void UnitType::prefetchProducibleSounds() const {
+	for(int i = 0; i < getCommandTypeCount(); ++i) {
+		const CommandType *commandType= getCommandType(i);
+		if(commandType->getClass() == ccBuild) {
+			const BuildCommandType *buildCommandType= static_cast<const BuildCommandType *>(commandType);
+			for(int j = 0; j < buildCommandType->getBuildingCount(); ++j) {
+				buildCommandType->getBuilding(j)->prefetchSounds();
+			}
+		}
+		else {
+			const UnitType *producedUnitType= dynamic_cast<const UnitType *>(commandType->getProduced());
+			if(producedUnitType != NULL) {
+				producedUnitType->prefetchSounds();
+			}
+		}
+	}
+}
+
 // ==================== PRIVATE ====================
 
 void UnitType::computeFirstStOfClass() {
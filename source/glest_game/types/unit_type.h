@@ -211,6 +211,7 @@ private:
 	//sounds
     SoundContainer selectionSounds;
     SoundContainer commandSounds;
+    mutable bool soundsPrefetched;
 
 	//info
     SkillTypes skillTypes;
@@ -358,6 +359,8 @@ public:
 
 	//other
     virtual string getReqDesc(bool translatedValue) const;
+    void prefetchSounds() const;
+    void prefetchProducibleSounds() const;
 
     std::string toString() const;
 
@@ -0,0 +1,722 @@
+// ==============================================================
+//	This file is part of MegaGlest (www.megaglest.org)
+//
+//	Copyright (C) 2026 The MegaGlest Team
+//
+//	You can redistribute this code and/or modify it under
+//	the terms of the GNU General Public License as published
+//	by the Free Software Foundation; either version 2 of the
+//	License, or (at your option) any later version
+// ==============================================================
+
+#include "cluster_map.h"
+
+#include <algorithm>
+#include <cstdlib>
+#include "map.h"
+#include "unit.h"
+#include "unit_type.h"
+#include "platform_common.h"
+#include "util.h"
+#include "leak_dumper.h"
+
+using namespace std;
+using namespace Shared::Util;
+using namespace Shared::PlatformCommon;
+
+namespace Glest{ namespace Game{
+
+// =====================================================
+// 	class ClusterMap
+// =====================================================
+
+const int ClusterMap::clusterSize 						= 16;
+const int ClusterMap::hierarchicalSearchMinDistance 	= 24;
+
+static const float diagonalCost 		= 1.41421356f;
+// openings at least this wide get a transition at each end instead of one in the middle
+static const int wideTransitionLength 	= 6;
+// changes remembered for getStaticChangesSince, older ones force a full rebuild
+static const int maxStaticChanges 		= 64;
+
+ClusterMap::ClusterMap() {
+	map 		= NULL;
+	clustersW 	= 0;
+	clustersH 	= 0;
+	staticChangeCount = 0;
+}
+
+ClusterMap::~ClusterMap() {
+	clear();
+	map = NULL;
+}
+
+void ClusterMap::init(const Map *map) {
+	for(LayerMap::iterator iterMap = layers.begin(); iterMap != layers.end(); ++iterMap) {
+		delete iterMap->second;
+	}
+	layers.clear();
+
+	this->map = map;
+	staticChangeCount++;
+	staticChanges.clear();
+	clustersW = (map->getW() + clusterSize - 1) / clusterSize;
+	clustersH = (map->getH() + clusterSize - 1) / clusterSize;
+}
+
+void ClusterMap::clear() {
+	for(LayerMap::iterator iterMap = layers.begin(); iterMap != layers.end(); ++iterMap) {
+		delete iterMap->second;
+	}
+	layers.clear();
+}
+
+void ClusterMap::invalidate(const Vec2i &pos, int size) {
+	for(LayerMap::iterator iterMap = layers.begin(); iterMap != layers.end(); ++iterMap) {
+		markDirty(iterMap->second, pos, size);
+	}
+	staticChangeCount++;
+
+	staticChanges.push_back(StaticChange(pos, size, staticChangeCount));
+	if((int)staticChanges.size() > maxStaticChanges) {
+		staticChanges.pop_front();
+	}
+}
+
+uint32 ClusterMap::getStaticChangeCount() const {
+	return staticChangeCount;
+}
+
+bool ClusterMap::getStaticChangesSince(uint32 changeCount, vector<StaticChange> &changes) const {
+	changes.clear();
+	if(changeCount == staticChangeCount) {
+		return true;
+	}
+	// the change right after changeCount must still be in the list
+	if(staticChanges.empty() == true || staticChanges.front().changeCount > changeCount + 1) {
+		return false;
+	}
+	for(std::deque<StaticChange>::const_iterator iterChange = staticChanges.begin();
+		iterChange != staticChanges.end(); ++iterChange) {
+		if(iterChange->changeCount > changeCount) {
+			changes.push_back(*iterChange);
+		}
+	}
+	return true;
+}
+
+void ClusterMap::refreshLayers() {
+	for(LayerMap::iterator iterMap = layers.begin(); iterMap != layers.end(); ++iterMap) {
+		refresh(iterMap->second);
+	}
+}
+
+bool ClusterMap::isStaticFree(Field field, int size, const Vec2i &pos) const {
+	for(int i = 0; i < size; ++i) {
+		for(int j = 0; j < size; ++j) {
+			Vec2i currPos = pos + Vec2i(i, j);
+			if(map->isInside(currPos) == false ||
+				map->isInsideSurface(Map::toSurfCoords(currPos)) == false) {
+				return false;
+			}
+
+			const Cell *cell = map->getCell(currPos);
+			const Unit *unit = cell->getUnit(field);
+			if(unit != NULL && unit->getType()->isMobile() == false) {
+				return false;
+			}
+			if(field == fLand) {
+				if(map->getSurfaceCell(Map::toSurfCoords(currPos))->isFree() == false ||
+					map->getDeepSubmerged(cell) == true) {
+					return false;
+				}
+			}
+		}
+	}
+	return true;
+}
+
+ClusterMap::Layer * ClusterMap::getLayer(Field field, int size) {
+	std::pair<int,int> key(field,size);
+	LayerMap::iterator iterFind = layers.find(key);
+	if(iterFind != layers.end()) {
+		return iterFind->second;
+	}
+
+	int clusterCount = clustersW * clustersH;
+	Layer *layer = new Layer(field, size);
+	layer->dirty.resize(clusterCount,true);
+	layer->dirtyCount = clusterCount;
+	layer->clusterNodes.resize(clusterCount);
+	layer->eastTransitions.resize(clusterCount);
+	layer->southTransitions.resize(clusterCount);
+	layer->cellRegion.resize(map->getW() * map->getH(), -1);
+	layer->clusterRegionCount.resize(clusterCount, 0);
+	layers[key] = layer;
+	return layer;
+}
+
+const ClusterMap::Layer * ClusterMap::getReadLayer(Field field, int size) {
+	if(Thread::isCurrentThreadMainThread() == true) {
+		Layer *layer = getLayer(field, size);
+		refresh(layer);
+		return layer;
+	}
+
+	// workers never build a layer, an unknown (field, size) just isn't labelled
+	LayerMap::const_iterator iterFind = layers.find(std::pair<int,int>(field,size));
+	return (iterFind != layers.end() ? iterFind->second : NULL);
+}
+
+int ClusterMap::getNodeCluster(const Layer *layer, int nodeId) const {
+	return (int)(std::upper_bound(layer->nodeOffsets.begin(), layer->nodeOffsets.end(), nodeId) - layer->nodeOffsets.begin()) - 1;
+}
+
+void ClusterMap::markDirty(Layer *layer, const Vec2i &pos, int size) {
+	// a footprint anchored up to (layer size - 1) cells before pos overlaps the change
+	int minX = max(0, pos.x - (layer->size - 1)) / clusterSize;
+	int minY = max(0, pos.y - (layer->size - 1)) / clusterSize;
+	int maxX = min(map->getW() - 1, pos.x + size - 1) / clusterSize;
+	int maxY = min(map->getH() - 1, pos.y + size - 1) / clusterSize;
+
+	for(int cy = minY; cy <= maxY; ++cy) {
+		for(int cx = minX; cx <= maxX; ++cx) {
+			int cluster = cy * clustersW + cx;
+			if(layer->dirty[cluster] == false) {
+				layer->dirty[cluster] = true;
+				layer->dirtyCount++;
+			}
+		}
+	}
+}
+
+void ClusterMap::refresh(Layer *layer) {
+	if(layer->dirtyCount <= 0) {
+		return;
+	}
+
+	int clusterCount = clustersW * clustersH;
+	vector<bool> rebuildNodes(clusterCount,false);
+
+	for(int cy = 0; cy < clustersH; ++cy) {
+		for(int cx = 0; cx < clustersW; ++cx) {
+			int cluster = cy * clustersW + cx;
+			if(layer->dirty[cluster] == false) {
+				continue;
+			}
+
+			buildEastTransitions(layer, cx, cy);
+			buildSouthTransitions(layer, cx, cy);
+			if(cx > 0) {
+				buildEastTransitions(layer, cx - 1, cy);
+				rebuildNodes[cluster - 1] = true;
+			}
+			if(cy > 0) {
+				buildSouthTransitions(layer, cx, cy - 1);
+				rebuildNodes[cluster - clustersW] = true;
+			}
+			if(cx + 1 < clustersW) {
+				rebuildNodes[cluster + 1] = true;
+			}
+			if(cy + 1 < clustersH) {
+				rebuildNodes[cluster + clustersW] = true;
+			}
+			rebuildNodes[cluster] = true;
+			layer->dirty[cluster] = false;
+		}
+	}
+	layer->dirtyCount = 0;
+
+	for(int cy = 0; cy < clustersH; ++cy) {
+		for(int cx = 0; cx < clustersW; ++cx) {
+			if(rebuildNodes[cy * clustersW + cx] == true) {
+				labelClusterRegions(layer, cx, cy);
+				buildClusterNodes(layer, cx, cy);
+			}
+		}
+	}
+	updateRegionLabels(layer);
+
+	layer->nodeOffsets.assign(clusterCount + 1, 0);
+	for(int cluster = 0; cluster < clusterCount; ++cluster) {
+		layer->nodeOffsets[cluster + 1] = layer->nodeOffsets[cluster] + (int)layer->clusterNodes[cluster].size();
+	}
+}
+
+void ClusterMap::labelClusterRegions(Layer *layer, int cx, int cy) {
+	const int cluster = cy * clustersW + cx;
+	const int x0 = cx * clusterSize;
+	const int y0 = cy * clusterSize;
+	const int x1 = min(x0 + clusterSize, map->getW());
+	const int y1 = min(y0 + clusterSize, map->getH());
+	const int mapW = map->getW();
+
+	// -2 marks free cells that have no region yet
+	for(int y = y0; y < y1; ++y) {
+		for(int x = x0; x < x1; ++x) {
+			layer->cellRegion[y * mapW + x] = (isStaticFree(layer->field, layer->size, Vec2i(x, y)) ? -2 : -1);
+		}
+	}
+
+	int regionCount = 0;
+	vector<Vec2i> pending;
+	for(int y = y0; y < y1; ++y) {
+		for(int x = x0; x < x1; ++x) {
+			if(layer->cellRegion[y * mapW + x] != -2) {
+				continue;
+			}
+
+			layer->cellRegion[y * mapW + x] = regionCount;
+			pending.push_back(Vec2i(x, y));
+			while(pending.empty() == false) {
+				Vec2i pos = pending.back();
+				pending.pop_back();
+
+				for(int i = -1; i <= 1; ++i) {
+					for(int j = -1; j <= 1; ++j) {
+						int nx = pos.x + i;
+						int ny = pos.y + j;
+						if((i == 0 && j == 0) || nx < x0 || ny < y0 || nx >= x1 || ny >= y1) {
+							continue;
+						}
+						if(layer->cellRegion[ny * mapW + nx] != -2) {
+							continue;
+						}
+						// diagonal steps need both side cells, same as computeClusterCosts
+						if(i != 0 && j != 0 &&
+							(layer->cellRegion[pos.y * mapW + nx] == -1 ||
+							 layer->cellRegion[ny * mapW + pos.x] == -1)) {
+							continue;
+						}
+						layer->cellRegion[ny * mapW + nx] = regionCount;
+						pending.push_back(Vec2i(nx, ny));
+					}
+				}
+			}
+			regionCount++;
+		}
+	}
+	layer->clusterRegionCount[cluster] = regionCount;
+}
+
+void ClusterMap::updateRegionLabels(Layer *layer) {
+	const int clusterCount = clustersW * clustersH;
+	const int mapW = map->getW();
+
+	layer->regionOffsets.assign(clusterCount + 1, 0);
+	for(int cluster = 0; cluster < clusterCount; ++cluster) {
+		layer->regionOffsets[cluster + 1] = layer->regionOffsets[cluster] + layer->clusterRegionCount[cluster];
+	}
+	const int localRegionCount = layer->regionOffsets[clusterCount];
+
+	// union-find over the cluster local regions, joined across every transition
+	vector<int> parent(localRegionCount);
+	for(int index = 0; index < localRegionCount; ++index) {
+		parent[index] = index;
+	}
+
+	for(int cluster = 0; cluster < clusterCount; ++cluster) {
+		for(int border = 0; border < 2; ++border) {
+			const vector<Transition> &transitions = (border == 0 ? layer->eastTransitions[cluster] : layer->southTransitions[cluster]);
+			const int otherCluster = (border == 0 ? cluster + 1 : cluster + clustersW);
+			for(unsigned int index = 0; index < transitions.size(); ++index) {
+				const Transition &transition = transitions[index];
+				int first = layer->regionOffsets[cluster] + layer->cellRegion[transition.first.y * mapW + transition.first.x];
+				int second = layer->regionOffsets[otherCluster] + layer->cellRegion[transition.second.y * mapW + transition.second.x];
+
+				while(parent[first] != first) {
+					first = parent[first] = parent[parent[first]];
+				}
+				while(parent[second] != second) {
+					second = parent[second] = parent[parent[second]];
+				}
+				if(first != second) {
+					// lower index always wins so labels don't depend on visit order
+					if(first < second) {
+						parent[second] = first;
+					}
+					else {
+						parent[first] = second;
+					}
+				}
+			}
+		}
+	}
+
+	layer->regionLabels.assign(localRegionCount, -1);
+	layer->regionCount = 0;
+	for(int index = 0; index < localRegionCount; ++index) {
+		int root = index;
+		while(parent[root] != root) {
+			root = parent[root];
+		}
+		if(layer->regionLabels[root] < 0) {
+			layer->regionLabels[root] = layer->regionCount++;
+		}
+		layer->regionLabels[index] = layer->regionLabels[root];
+	}
+}
+
+int ClusterMap::getRegionLabel(const Layer *layer, const Vec2i &pos) const {
+	if(map->isInside(pos) == false) {
+		return -1;
+	}
+	int localRegion = layer->cellRegion[pos.y * map->getW() + pos.x];
+	if(localRegion < 0) {
+		return -1;
+	}
+	return layer->regionLabels[layer->regionOffsets[getClusterIndex(pos)] + localRegion];
+}
+
+void ClusterMap::prepareLayer(Field field, int size) {
+	refresh(getLayer(field, size));
+}
+
+int ClusterMap::getRegion(Field field, int size, const Vec2i &pos) {
+	const Layer *layer = getReadLayer(field, size);
+	if(layer == NULL) {
+		return -1;
+	}
+	return getRegionLabel(layer, pos);
+}
+
+int ClusterMap::getRegionCount(Field field, int size) {
+	const Layer *layer = getReadLayer(field, size);
+	if(layer == NULL) {
+		return 0;
+	}
+	return layer->regionCount;
+}
+
+bool ClusterMap::isReachable(Field field, int size, const Vec2i &from, const Vec2i &to) {
+	const Layer *layer = getReadLayer(field, size);
+	if(layer == NULL) {
+		return true;
+	}
+
+	int fromRegion = getRegionLabel(layer, from);
+	int toRegion = getRegionLabel(layer, to);
+	if(fromRegion < 0 || toRegion < 0) {
+		return true;
+	}
+	return fromRegion == toRegion;
+}
+
+void ClusterMap::addTransitionRun(vector<Transition> &transitions, const Vec2i &runStart,
+		const Vec2i &step, const Vec2i &across, int runLength) {
+	if(runLength <= 0) {
+		return;
+	}
+	if(runLength < wideTransitionLength) {
+		Vec2i pos = runStart + step * (runLength / 2);
+		transitions.push_back(Transition(pos, pos + across));
+	}
+	else {
+		Vec2i first = runStart;
+		Vec2i last = runStart + step * (runLength - 1);
+		transitions.push_back(Transition(first, first + across));
+		transitions.push_back(Transition(last, last + across));
+	}
+}
+
+void ClusterMap::buildEastTransitions(Layer *layer, int cx, int cy) {
+	vector<Transition> &transitions = layer->eastTransitions[cy * clustersW + cx];
+	transitions.clear();
+	if(cx + 1 >= clustersW) {
+		return;
+	}
+
+	const int x = (cx + 1) * clusterSize - 1;
+	const int yStart = cy * clusterSize;
+	const int yEnd = min((cy + 1) * clusterSize, map->getH());
+	int runLength = 0;
+	for(int y = yStart; y < yEnd; ++y) {
+		if(isStaticFree(layer->field, layer->size, Vec2i(x, y)) == true &&
+			isStaticFree(layer->field, layer->size, Vec2i(x + 1, y)) == true) {
+			runLength++;
+		}
+		else {
+			addTransitionRun(transitions, Vec2i(x, y - runLength), Vec2i(0, 1), Vec2i(1, 0), runLength);
+			runLength = 0;
+		}
+	}
+	addTransitionRun(transitions, Vec2i(x, yEnd - runLength), Vec2i(0, 1), Vec2i(1, 0), runLength);
+}
+
+void ClusterMap::buildSouthTransitions(Layer *layer, int cx, int cy) {
+	vector<Transition> &transitions = layer->southTransitions[cy * clustersW + cx];
+	transitions.clear();
+	if(cy + 1 >= clustersH) {
+		return;
+	}
+
+	const int y = (cy + 1) * clusterSize - 1;
+	const int xStart = cx * clusterSize;
+	const int xEnd = min((cx + 1) * clusterSize, map->getW());
+	int runLength = 0;
+	for(int x = xStart; x < xEnd; ++x) {
+		if(isStaticFree(layer->field, layer->size, Vec2i(x, y)) == true &&
+			isStaticFree(layer->field, layer->size, Vec2i(x, y + 1)) == true) {
+			runLength++;
+		}
+		else {
+			addTransitionRun(transitions, Vec2i(x - runLength, y), Vec2i(1, 0), Vec2i(0, 1), runLength);
+			runLength = 0;
+		}
+	}
+	addTransitionRun(transitions, Vec2i(xEnd - runLength, y), Vec2i(1, 0), Vec2i(0, 1), runLength);
+}
+
+void ClusterMap::buildClusterNodes(Layer *layer, int cx, int cy) {
+	const int cluster = cy * clustersW + cx;
+	vector<Node> &nodes = layer->clusterNodes[cluster];
+	nodes.clear();
+
+	// borders are always visited east, west, south, north so node order is stable
+	if(cx + 1 < clustersW) {
+		const vector<Transition> &transitions = layer->eastTransitions[cluster];
+		for(unsigned int index = 0; index < transitions.size(); ++index) {
+			Node node;
+			node.pos = transitions[index].first;
+			node.linkPos = transitions[index].second;
+			node.linkCluster = cluster + 1;
+			nodes.push_back(node);
+		}
+	}
+	if(cx > 0) {
+		const vector<Transition> &transitions = layer->eastTransitions[cluster - 1];
+		for(unsigned int index = 0; index < transitions.size(); ++index) {
+			Node node;
+			node.pos = transitions[index].second;
+			node.linkPos = transitions[index].first;
+			node.linkCluster = cluster - 1;
+			nodes.push_back(node);
+		}
+	}
+	if(cy + 1 < clustersH) {
+		const vector<Transition> &transitions = layer->southTransitions[cluster];
+		for(unsigned int index = 0; index < transitions.size(); ++index) {
+			Node node;
+			node.pos = transitions[index].first;
+			node.linkPos = transitions[index].second;
+			node.linkCluster = cluster + clustersW;
+			nodes.push_back(node);
+		}
+	}
+	if(cy > 0) {
+		const vector<Transition> &transitions = layer->southTransitions[cluster - clustersW];
+		for(unsigned int index = 0; index < transitions.size(); ++index) {
+			Node node;
+			node.pos = transitions[index].second;
+			node.linkPos = transitions[index].first;
+			node.linkCluster = cluster - clustersW;
+			nodes.push_back(node);
+		}
+	}
+
+	vector<float> costs;
+	vector<bool> passable;
+	AStarOpenList<int> openList;
+	for(unsigned int index = 0; index < nodes.size(); ++index) {
+		computeClusterCosts(layer, cluster, nodes[index].pos, costs, passable, openList);
+		for(unsigned int target = 0; target < nodes.size(); ++target) {
+			if(target == index) {
+				continue;
+			}
+			float cost = getCostAt(costs, cluster, nodes[target].pos);
+			if(cost >= 0) {
+				nodes[index].edges.push_back(Edge(target, cost));
+			}
+		}
+	}
+}
+
+void ClusterMap::computeClusterCosts(const Layer *layer, int cluster, const Vec2i &origin,
+		vector<float> &costs, vector<bool> &passable, AStarOpenList<int> &openList) const {
+	const int x0 = (cluster % clustersW) * clusterSize;
+	const int y0 = (cluster / clustersW) * clusterSize;
+	const int x1 = min(x0 + clusterSize, map->getW());
+	const int y1 = min(y0 + clusterSize, map->getH());
+
+	costs.assign(clusterSize * clusterSize, -1.0f);
+	passable.assign(clusterSize * clusterSize, false);
+	for(int y = y0; y < y1; ++y) {
+		for(int x = x0; x < x1; ++x) {
+			passable[(y - y0) * clusterSize + (x - x0)] = isStaticFree(layer->field, layer->size, Vec2i(x, y));
+		}
+	}
+
+	// the origin is where a unit is standing, so it counts as walkable
+	int originIndex = (origin.y - y0) * clusterSize + (origin.x - x0);
+	passable[originIndex] = true;
+	costs[originIndex] = 0;
+
+	openList.clear();
+	openList.push(0, originIndex);
+	while(openList.empty() == false) {
+		int current = openList.pop();
+		int x = current % clusterSize;
+		int y = current / clusterSize;
+		float currentCost = costs[current];
+
+		for(int i = -1; i <= 1; ++i) {
+			for(int j = -1; j <= 1; ++j) {
+				if(i == 0 && j == 0) {
+					continue;
+				}
+				int nx = x + i;
+				int ny = y + j;
+				if(nx < 0 || ny < 0 || nx + x0 >= x1 || ny + y0 >= y1) {
+					continue;
+				}
+				int next = ny * clusterSize + nx;
+				if(passable[next] == false) {
+					continue;
+				}
+				float stepCost = 1.0f;
+				if(i != 0 && j != 0) {
+					// no cutting corners, same as Map::aproxCanMove
+					if(passable[y * clusterSize + nx] == false || passable[ny * clusterSize + x] == false) {
+						continue;
+					}
+					stepCost = diagonalCost;
+				}
+				float nextCost = currentCost + stepCost;
+				if(costs[next] < 0 || nextCost < costs[next]) {
+					costs[next] = nextCost;
+					openList.push(nextCost, next);
+				}
+			}
+		}
+	}
+}
+
+float ClusterMap::getCostAt(const vector<float> &costs, int cluster, const Vec2i &pos) const {
+	const int x0 = (cluster % clustersW) * clusterSize;
+	const int y0 = (cluster / clustersW) * clusterSize;
+	return costs[(pos.y - y0) * clusterSize + (pos.x - x0)];
+}
+
+bool ClusterMap::findFirstHop(Field field, int size, const Vec2i &from, const Vec2i &to,
+		Vec2i &hop, HopSearchBuffers &buffers) {
+	if(map == NULL || map->isInside(from) == false || map->isInside(to) == false) {
+		return false;
+	}
+
+	const int startCluster = getClusterIndex(from);
+	const int goalCluster = getClusterIndex(to);
+	if(abs(startCluster % clustersW - goalCluster % clustersW) <= 1 &&
+		abs(startCluster / clustersW - goalCluster / clustersW) <= 1) {
+		return false;
+	}
+
+	const Layer *layer = getReadLayer(field, size);
+	if(layer == NULL) {
+		return false;
+	}
+
+	// flattened node ids, start and goal get the two ids after the real nodes
+	const int clusterCount = clustersW * clustersH;
+	const vector<int> &offsets = layer->nodeOffsets;
+	const int startId = offsets[clusterCount];
+	const int goalId = startId + 1;
+
+	computeClusterCosts(layer, startCluster, from, buffers.startCosts, buffers.passable, buffers.clusterOpenList);
+	computeClusterCosts(layer, goalCluster, to, buffers.goalCosts, buffers.passable, buffers.clusterOpenList);
+
+	vector<float> &pathCost = buffers.pathCost;
+	vector<int> &cameFrom = buffers.cameFrom;
+	vector<bool> &closed = buffers.closed;
+	vector<std::pair<int,float> > &successors = buffers.successors;
+	AStarOpenList<int> &openList = buffers.openList;
+	pathCost.assign(goalId + 1, -1.0f);
+	cameFrom.assign(goalId + 1, -1);
+	closed.assign(goalId + 1, false);
+	openList.clear();
+
+	pathCost[startId] = 0;
+	openList.push(from.dist(to), startId);
+
+	bool found = false;
+	while(openList.empty() == false) {
+		int current = openList.pop();
+		if(closed[current] == true) {
+			continue;
+		}
+		closed[current] = true;
+		if(current == goalId) {
+			found = true;
+			break;
+		}
+
+		// collect (target, cost) pairs reachable from the current abstract node
+		successors.clear();
+		if(current == startId) {
+			const vector<Node> &nodes = layer->clusterNodes[startCluster];
+			for(unsigned int index = 0; index < nodes.size(); ++index) {
+				float cost = getCostAt(buffers.startCosts, startCluster, nodes[index].pos);
+				if(cost >= 0) {
+					successors.push_back(std::make_pair(offsets[startCluster] + (int)index, cost));
+				}
+			}
+		}
+		else {
+			int cluster = getNodeCluster(layer, current);
+			const Node &node = layer->clusterNodes[cluster][current - offsets[cluster]];
+			for(unsigned int index = 0; index < node.edges.size(); ++index) {
+				successors.push_back(std::make_pair(offsets[cluster] + node.edges[index].target, node.edges[index].cost));
+			}
+
+			const vector<Node> &linkedNodes = layer->clusterNodes[node.linkCluster];
+			for(unsigned int index = 0; index < linkedNodes.size(); ++index) {
+				if(linkedNodes[index].pos == node.linkPos && linkedNodes[index].linkPos == node.pos) {
+					successors.push_back(std::make_pair(offsets[node.linkCluster] + (int)index, 1.0f));
+					break;
+				}
+			}
+
+			if(cluster == goalCluster) {
+				float cost = getCostAt(buffers.goalCosts, goalCluster, node.pos);
+				if(cost >= 0) {
+					successors.push_back(std::make_pair(goalId, cost));
+				}
+			}
+		}
+
+		for(unsigned int index = 0; index < successors.size(); ++index) {
+			int next = successors[index].first;
+			if(closed[next] == true) {
+				continue;
+			}
+			float nextCost = pathCost[current] + successors[index].second;
+			if(pathCost[next] < 0 || nextCost < pathCost[next]) {
+				pathCost[next] = nextCost;
+				cameFrom[next] = current;
+
+				Vec2i nextPos = to;
+				if(next != goalId) {
+					int cluster = getNodeCluster(layer, next);
+					nextPos = layer->clusterNodes[cluster][next - offsets[cluster]].pos;
+				}
+				openList.push(nextCost + nextPos.dist(to), next);
+			}
+		}
+	}
+
+	if(found == false) {
+		return false;
+	}
+
+	// walk back and remember the earliest node that is outside the start cluster
+	bool hopFound = false;
+	for(int current = cameFrom[goalId]; current != startId && current >= 0; current = cameFrom[current]) {
+		int cluster = getNodeCluster(layer, current);
+		if(cluster != startCluster) {
+			hop = layer->clusterNodes[cluster][current - offsets[cluster]].pos;
+			hopFound = true;
+		}
+	}
+	return hopFound;
+}
+
+}}//end namespace
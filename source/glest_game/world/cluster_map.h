@@ -0,0 +1,209 @@
+// ==============================================================
+//	This file is part of MegaGlest (www.megaglest.org)
+//
+//	Copyright (C) 2026 The MegaGlest Team
+//
+//	You can redistribute this code and/or modify it under
+//	the terms of the GNU General Public License as published
+//	by the Free Software Foundation; either version 2 of the
+//	License, or (at your option) any later version
+// ==============================================================
+
+#ifndef _GLEST_GAME_CLUSTERMAP_H_
+#define _GLEST_GAME_CLUSTERMAP_H_
+
+#ifdef WIN32
+    #include <winsock2.h>
+    #include <winsock.h>
+#endif
+
+#include <vector>
+#include <map>
+#include <deque>
+#include "vec.h"
+#include "skill_type.h"
+#include "astar_containers.h"
+#include "data_types.h"
+#include "leak_dumper.h"
+
+using std::vector;
+using Shared::Graphics::Vec2i;
+using Shared::Util::AStarOpenList;
+using Shared::Platform::uint32;
+
+namespace Glest{ namespace Game{
+
+class Map;
+
+// =====================================================
+// 	class ClusterMap
+//
+///	Hierarchical (HPA*) abstraction of the map used to route long paths.
+///	The map is split into square clusters; for every field and unit size
+///	the passable openings between neighbouring clusters become abstract
+///	nodes, and nodes inside one cluster are linked with their walking cost.
+///	Only static blockers (terrain, tileset objects and buildings) are taken
+///	into account, mobile units are left to the regular A* search.
+///	Each layer also labels connected regions so unreachable goals can be
+///	rejected without searching.
+///
+///	Layers are only built and refreshed on the main thread. Worker threads
+///	(path precache, AI) only read them, without locking, while the main
+///	thread waits for them; refreshLayers() must run before they start.
+// =====================================================
+
+class ClusterMap {
+public:
+	static const int clusterSize;
+	// below this distance a plain A* search is used
+	static const int hierarchicalSearchMinDistance;
+
+	// scratch space for findFirstHop, each thread searching needs its own
+	class HopSearchBuffers {
+	public:
+		vector<float> startCosts;
+		vector<float> goalCosts;
+		vector<bool> passable;
+		vector<float> pathCost;
+		vector<int> cameFrom;
+		vector<bool> closed;
+		vector<std::pair<int,float> > successors;
+		AStarOpenList<int> clusterOpenList;
+		AStarOpenList<int> openList;
+	};
+
+private:
+	class Edge {
+	public:
+		Edge(int target, float cost) : target(target), cost(cost) {}
+		int target;		// node index inside the same cluster
+		float cost;
+	};
+
+	class Node {
+	public:
+		Vec2i pos;
+		Vec2i linkPos;	// position of the matching node across the border
+		int linkCluster;
+		vector<Edge> edges;
+	};
+
+	class Transition {
+	public:
+		Transition(const Vec2i &first, const Vec2i &second) : first(first), second(second) {}
+		Vec2i first;	// cell in the top / left cluster
+		Vec2i second;	// cell in the bottom / right cluster
+	};
+
+public:
+	// a rectangle of cells whose static blockers changed
+	class StaticChange {
+	public:
+		StaticChange(const Vec2i &pos, int size, uint32 changeCount) : pos(pos), size(size), changeCount(changeCount) {}
+		Vec2i pos;
+		int size;
+		uint32 changeCount;	// static change count right after the change
+	};
+
+	// one (field, unit size) abstraction, callers only hand it back to getRegionLabel
+	class Layer {
+	public:
+		Layer(Field field, int size) : field(field), size(size), dirtyCount(0), regionCount(0) {}
+
+		Field field;
+		int size;
+		int dirtyCount;
+		vector<bool> dirty;
+		vector<vector<Node> > clusterNodes;
+		// borders between horizontally (east) and vertically (south) adjacent clusters
+		vector<vector<Transition> > eastTransitions;
+		vector<vector<Transition> > southTransitions;
+
+		// connected area inside its cluster for every cell, -1 when blocked
+		vector<int> cellRegion;
+		vector<int> clusterRegionCount;
+		// map wide region id for every cluster local region
+		vector<int> regionOffsets;
+		vector<int> regionLabels;
+		int regionCount;
+		// first flattened abstract node id of every cluster, plus the total
+		vector<int> nodeOffsets;
+	};
+
+private:
+	typedef std::map<std::pair<int,int>, Layer *> LayerMap;
+
+	const Map *map;
+	int clustersW;
+	int clustersH;
+	LayerMap layers;
+	// bumped on every static change so dependent caches know when to rebuild
+	uint32 staticChangeCount;
+	// the most recent changes, oldest first, so caches can tell which ones touch them
+	std::deque<StaticChange> staticChanges;
+
+public:
+	ClusterMap();
+	~ClusterMap();
+
+	void init(const Map *map);
+	void clear();
+
+	// static blockers inside the given cell rectangle changed
+	void invalidate(const Vec2i &pos, int size);
+	// brings every dirty layer up to date, main thread only
+	void refreshLayers();
+
+	// finds a path over the cluster graph and returns the first cell beyond
+	// the cluster containing 'from'. Returns false when the hierarchy can't
+	// help (same or neighbouring cluster, or no abstract route exists).
+	bool findFirstHop(Field field, int size, const Vec2i &from, const Vec2i &to,
+			Vec2i &hop, HopSearchBuffers &buffers);
+
+	// builds the layer up front so the first path request doesn't pay for it
+	void prepareLayer(Field field, int size);
+
+	// map wide connected region of pos, -1 if a unit of that size can't stand there
+	int getRegion(Field field, int size, const Vec2i &pos);
+	// refreshed layer on the main thread, the existing one (or NULL) elsewhere;
+	// fetch it once and use getRegionLabel when looking up many cells
+	const Layer * getReadLayer(Field field, int size);
+	int getRegionLabel(const Layer *layer, const Vec2i &pos) const;
+	int getRegionCount(Field field, int size);
+	// false only when both positions are standable and in different regions
+	bool isReachable(Field field, int size, const Vec2i &from, const Vec2i &to);
+
+	bool isStaticFree(Field field, int size, const Vec2i &pos) const;
+	uint32 getStaticChangeCount() const;
+	// the changes made after changeCount, false if they are no longer all known
+	bool getStaticChangesSince(uint32 changeCount, vector<StaticChange> &changes) const;
+	int getClusterIndex(const Vec2i &pos) const {
+		return (pos.y / clusterSize) * clustersW + (pos.x / clusterSize);
+	}
+	int getClustersW() const	{ return clustersW; }
+	int getClustersH() const	{ return clustersH; }
+
+private:
+	ClusterMap(const ClusterMap &obj);
+	ClusterMap &operator=(const ClusterMap &obj);
+
+	Layer * getLayer(Field field, int size);
+	void markDirty(Layer *layer, const Vec2i &pos, int size);
+	void refresh(Layer *layer);
+
+	void buildEastTransitions(Layer *layer, int cx, int cy);
+	void buildSouthTransitions(Layer *layer, int cx, int cy);
+	void addTransitionRun(vector<Transition> &transitions, const Vec2i &runStart,
+			const Vec2i &step, const Vec2i &across, int runLength);
+	void buildClusterNodes(Layer *layer, int cx, int cy);
+	void labelClusterRegions(Layer *layer, int cx, int cy);
+	void updateRegionLabels(Layer *layer);
+	void computeClusterCosts(const Layer *layer, int cluster, const Vec2i &origin,
+			vector<float> &costs, vector<bool> &passable, AStarOpenList<int> &openList) const;
+	int getNodeCluster(const Layer *layer, int nodeId) const;
+	float getCostAt(const vector<float> &costs, int cluster, const Vec2i &pos) const;
+};
+
+}}//end namespace
+
+#endif
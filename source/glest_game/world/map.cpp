@@ -119,6 +119,93 @@ void Cell::loadGame(const XmlNode *rootNode, int index, World *world) {
 	}
 }
 
+// =====================================================
+// 	class TeamBitPlane
+// =====================================================
+
+const int TeamBitPlane::bitsPerWord	= 64;
+const int TeamBitPlane::teamCount	= GameConstants::maxPlayers + GameConstants::specialFactions;
+
+static inline uint64 getWordMask(int firstBit, int lastBit) {
+	const uint64 allBits = ~(uint64)0;
+	if(lastBit - firstBit >= TeamBitPlane::bitsPerWord) {
+		return allBits;
+	}
+	return (((uint64)1 << (lastBit - firstBit)) - 1) << firstBit;
+}
+
+TeamBitPlane::TeamBitPlane() {
+	cellCount = 0;
+	wordCount = 0;
+}
+
+void TeamBitPlane::init(int cellCount) {
+	this->cellCount = cellCount;
+	wordCount = (cellCount + bitsPerWord - 1) / bitsPerWord;
+	words.assign(teamCount * wordCount, 0);
+}
+
+void TeamBitPlane::clear() {
+	cellCount = 0;
+	wordCount = 0;
+	words.clear();
+}
+
+void TeamBitPlane::setRange(int teamIndex, int firstCellIndex, int lastCellIndex, bool value) {
+	if(firstCellIndex < 0) {
+		firstCellIndex = 0;
+	}
+	if(lastCellIndex > cellCount) {
+		lastCellIndex = cellCount;
+	}
+	for(int cellIndex = firstCellIndex; cellIndex < lastCellIndex;) {
+		const int wordIndex = cellIndex / bitsPerWord;
+		const int firstBit = cellIndex % bitsPerWord;
+		const int lastBit = min(bitsPerWord, firstBit + (lastCellIndex - cellIndex));
+		if(value == true) {
+			setWordBits(teamIndex, wordIndex, getWordMask(firstBit, lastBit));
+		}
+		else {
+			clearWordBits(teamIndex, wordIndex, getWordMask(firstBit, lastBit));
+		}
+		cellIndex += lastBit - firstBit;
+	}
+}
+
+bool TeamBitPlane::testRangeAny(int teamIndex, int firstCellIndex, int lastCellIndex) const {
+	if(firstCellIndex < 0) {
+		firstCellIndex = 0;
+	}
+	if(lastCellIndex > cellCount) {
+		lastCellIndex = cellCount;
+	}
+	for(int cellIndex = firstCellIndex; cellIndex < lastCellIndex;) {
+		const int wordIndex = cellIndex / bitsPerWord;
+		const int firstBit = cellIndex % bitsPerWord;
+		const int lastBit = min(bitsPerWord, firstBit + (lastCellIndex - cellIndex));
+		if((getWord(teamIndex, wordIndex) & getWordMask(firstBit, lastBit)) != 0) {
+			return true;
+		}
+		cellIndex += lastBit - firstBit;
+	}
+	return false;
+}
+
+void TeamBitPlane::fill(int teamIndex, bool value) {
+	if(wordCount <= 0) {
+		return;
+	}
+	const uint64 allBits = ~(uint64)0;
+	std::fill(words.begin() + teamIndex * wordCount, words.begin() + (teamIndex + 1) * wordCount,
+			  (value == true ? allBits : (uint64)0));
+
+	// keep the bits past the last cell clear so whole words can be tested
+	const int tailBits = cellCount % bitsPerWord;
+	if(value == true && tailBits != 0) {
+		words[(teamIndex + 1) * wordCount - 1] = getWordMask(0, tailBits);
+	}
+}
+
 // =====================================================
 // 	class SurfaceCell
 // =====================================================
@@ -132,10 +219,9 @@ SurfaceCell::SurfaceCell() {
 	nearSubmerged = false;
 	cellChangedFromOriginalMapLoad = false;
 
-	for(int index = 0; index < GameConstants::maxPlayers + GameConstants::specialFactions; ++index) {
-		setVisible(index,false);
-		setExplored(index,false);
-	}
+	visiblePlane= NULL;
+	exploredPlane= NULL;
+	planeIndex= -1;
 }
 
 SurfaceCell::~SurfaceCell() {
@@ -177,7 +263,9 @@ void SurfaceCell::setExplored(int teamIndex, bool explored) {
 		throw megaglest_runtime_error(szBuf);
 	}
 
-	this->explored[teamIndex]= explored;
+	if(exploredPlane != NULL) {
+		exploredPlane->set(teamIndex, planeIndex, explored);
+	}
 	//printf("Setting explored to %d for teamIndex %d\n",explored,teamIndex);
 }
 
@@ -189,10 +277,12 @@ void SurfaceCell::setVisible(int teamIndex, bool visible) {
 		throw megaglest_runtime_error(szBuf);
 	}
 
-    this->visible[teamIndex]= visible;
+	if(visiblePlane != NULL) {
+		visiblePlane->set(teamIndex, planeIndex, visible);
+	}
 
-	if(SystemFlags::getSystemSettingType(SystemFlags::debugWorldSynch).enabled == true &&
-			SystemFlags::getSystemSettingType(SystemFlags::debugWorldSynchMax).enabled == true) {
+	if(SystemFlags::isDebugEnabled(SystemFlags::debugWorldSynch) == true &&
+			SystemFlags::isDebugEnabled(SystemFlags::debugWorldSynchMax) == true) {
 		char szBuf[8096]="";
 		snprintf(szBuf,8096,"In setVisible() teamIndex %d visible %d",teamIndex,visible);
 
@@ -216,17 +306,23 @@ void SurfaceCell::setVisible(int teamIndex, bool visible) {
 
 }
 
+void SurfaceCell::setPlanes(TeamBitPlane *visiblePlane, TeamBitPlane *exploredPlane, int planeIndex) {
+	this->visiblePlane= visiblePlane;
+	this->exploredPlane= exploredPlane;
+	this->planeIndex= planeIndex;
+}
+
 string SurfaceCell::isVisibleString() const	{
 	string result = "isVisibleList = ";
 	for(int index = 0; index < GameConstants::maxPlayers + GameConstants::specialFactions; ++index) {
-		result += string(visible[index] ? "true" : "false");
+		result += string(isVisible(index) ? "true" : "false");
 	}
 	return result;
 }
 string SurfaceCell::isExploredString() const {
 	string result = "isExploredList = ";
 	for(int index = 0; index < GameConstants::maxPlayers + GameConstants::specialFactions; ++index) {
-		result += string(explored[index] ? "true" : "false");
+		result += string(isExplored(index) ? "true" : "false");
 	}
 	return result;
 }
@@ -362,14 +458,17 @@ Map::~Map() {
 
 	delete [] cells;
 	cells = NULL;
+	unitGrid.clear();
 	delete [] surfaceCells;
 	surfaceCells = NULL;
+	visiblePlane.clear();
+	exploredPlane.clear();
 	delete [] startLocations;
 	startLocations = NULL;
 }
 
 void Map::end(){
-	if(SystemFlags::getSystemSettingType(SystemFlags::debugSystem).enabled) SystemFlags::OutputDebug(SystemFlags::debugSystem,"In [%s::%s Line: %d]\n",__FILE__,__FUNCTION__,__LINE__);
+	if(SystemFlags::isDebugEnabled(SystemFlags::debugSystem)) SystemFlags::OutputDebug(SystemFlags::debugSystem,"In [%s::%s Line: %d]\n",__FILE__,__FUNCTION__,__LINE__);
     Logger::getInstance().add(Lang::getInstance().getString("LogScreenGameUnLoadingMap","",true), true);
 	//read heightmap
 	for(int j = 0; j < surfaceH; ++j) {
@@ -377,7 +476,7 @@ void Map::end(){
 			getSurfaceCell(i, j)->end();
 		}
 	}
-	if(SystemFlags::getSystemSettingType(SystemFlags::debugSystem).enabled) SystemFlags::OutputDebug(SystemFlags::debugSystem,"In [%s::%s Line: %d]\n",__FILE__,__FUNCTION__,__LINE__);
+	if(SystemFlags::isDebugEnabled(SystemFlags::debugSystem)) SystemFlags::OutputDebug(SystemFlags::debugSystem,"In [%s::%s Line: %d]\n",__FILE__,__FUNCTION__,__LINE__);
 }
 
 Vec2i Map::getStartLocation(int locationIndex) const {
@@ -481,7 +580,13 @@ Checksum Map::load(const string &path, TechTree *techTree, Tileset *tileset) {
 
 			//cells
 			cells= new Cell[getCellArraySize()];
+			unitGrid.init(w, h);
 			surfaceCells= new SurfaceCell[getSurfaceCellArraySize()];
+			visiblePlane.init(getSurfaceCellArraySize());
+			exploredPlane.init(getSurfaceCellArraySize());
+			for(int i = 0; i < getSurfaceCellArraySize(); ++i) {
+				surfaceCells[i].setPlanes(&visiblePlane, &exploredPlane, i);
+			}
 
 			//read heightmap
 			for(int j = 0; j < surfaceH; ++j) {
@@ -573,6 +678,7 @@ void Map::init(Tileset *tileset) {
 	computeInterpolatedHeights();
 	computeNearSubmerged();
 	computeCellColors();
+	clusterMap.init(this);
 }
 
 
@@ -664,7 +770,7 @@ bool Map::isResourceNear(int frameIndex,const Vec2i &pos, const ResourceType *rt
 			if(result.x >= 0) {
 				resourcePos = result;
 
-				if(SystemFlags::getSystemSettingType(SystemFlags::debugWorldSynch).enabled == true) {
+				if(SystemFlags::isDebugEnabled(SystemFlags::debugWorldSynch) == true) {
 					char szBuf[8096]="";
 					snprintf(szBuf,8096,"[found peer harvest pos] pos [%s] resourcePos [%s] unit->getFaction()->getCacheResourceTargetListSize() [%d]",
 										pos.getString().c_str(),resourcePos.getString().c_str(),unit->getFaction()->getCacheResourceTargetListSize());
@@ -1450,6 +1556,10 @@ void Map::putUnitCellsPrivate(Unit *unit, const Vec2i &pos, const UnitType *ut,
 	if(canPutInCell == true) {
         unit->setPos(pos, false, threaded);
 	}
+	unitGrid.putUnit(unit, unit->getId(), unit->getFactionIndex(), pos, ut->getSize());
+	if(ut->isMobile() == false) {
+		clusterMap.invalidate(pos, ut->getSize());
+	}
 }
 
 //removes a unit from cells
@@ -1515,6 +1625,58 @@ void Map::clearUnitCells(Unit *unit, const Vec2i &pos, bool ignoreSkill) {
 			}
 		}
 	}
+	// morph blocking can leave the unit in its other field, keep it indexed then
+	const UnitGridEntry *gridEntry = unitGrid.getEntry(unit->getId());
+	if(gridEntry != NULL) {
+		bool stillInCells = false;
+		for(int i = 0; i < gridEntry->size && stillInCells == false; ++i) {
+			for(int j = 0; j < gridEntry->size && stillInCells == false; ++j) {
+				Vec2i currPos= gridEntry->pos + Vec2i(i, j);
+				if(isInside(currPos) == true) {
+					for(int k = 0; k < fieldCount && stillInCells == false; ++k) {
+						stillInCells = (getCell(currPos)->getUnit(static_cast<Field>(k)) == unit);
+					}
+				}
+			}
+		}
+		if(stillInCells == false) {
+			unitGrid.removeUnit(unit->getId());
+		}
+	}
+
+	if(ut->isMobile() == false) {
+		clusterMap.invalidate(pos, ut->getSize());
+	}
+}
+
+void Map::removeUnitFromGrid(const Unit *unit) {
+	unitGrid.removeUnit(unit->getId());
+}
+
+void Map::findUnitCells(int factionIndex, const Vec2i &minPos, const Vec2i &maxPos, vector<UnitCellRef> &unitCells) const {
+	vector<const UnitGridEntry *> entries;
+	unitGrid.findEntries(factionIndex, minPos, maxPos, entries);
+
+	for(unsigned int index = 0; index < entries.size(); ++index) {
+		const UnitGridEntry *entry = entries[index];
+		const int firstX = max(minPos.x, max(0, entry->pos.x));
+		const int firstY = max(minPos.y, max(0, entry->pos.y));
+		const int lastX = min(maxPos.x, min(w - 1, entry->pos.x + entry->size - 1));
+		const int lastY = min(maxPos.y, min(h - 1, entry->pos.y + entry->size - 1));
+
+		// the cells are the truth, the grid only says where to look
+		for(int x = firstX; x <= lastX; ++x) {
+			for(int y = firstY; y <= lastY; ++y) {
+				const Cell *cell = getCell(x, y);
+				for(int k = 0; k < fieldCount; ++k) {
+					Field field = static_cast<Field>(k);
+					if(cell->getUnit(field) == entry->unit) {
+						unitCells.push_back(UnitCellRef(Vec2i(x, y), field, entry->unit));
+					}
+				}
+			}
+		}
+	}
 }
 
 // ==================== misc ====================
@@ -1590,19 +1752,19 @@ void Map::clampPos(Vec2i &pos) const{
 
 void Map::prepareTerrain(const Unit *unit) {
 	Chrono chrono;
-	if(SystemFlags::getSystemSettingType(SystemFlags::debugPerformance).enabled) chrono.start();
+	if(SystemFlags::isDebugEnabled(SystemFlags::debugPerformance)) chrono.start();
 
 	flatternTerrain(unit);
 
-	if(SystemFlags::getSystemSettingType(SystemFlags::debugPerformance).enabled && chrono.getMillis() > 0) SystemFlags::OutputDebug(SystemFlags::debugPerformance,"In [%s::%s Line: %d] took msecs: %lld\n",__FILE__,__FUNCTION__,__LINE__,chrono.getMillis());
+	if(SystemFlags::isDebugEnabled(SystemFlags::debugPerformance) && chrono.getMillis() > 0) SystemFlags::OutputDebug(SystemFlags::debugPerformance,"In [%s::%s Line: %d] took msecs: %lld\n",__FILE__,__FUNCTION__,__LINE__,chrono.getMillis());
 
     computeNormals();
 
-    if(SystemFlags::getSystemSettingType(SystemFlags::debugPerformance).enabled && chrono.getMillis() > 0) SystemFlags::OutputDebug(SystemFlags::debugPerformance,"In [%s::%s Line: %d] took msecs: %lld\n",__FILE__,__FUNCTION__,__LINE__,chrono.getMillis());
+    if(SystemFlags::isDebugEnabled(SystemFlags::debugPerformance) && chrono.getMillis() > 0) SystemFlags::OutputDebug(SystemFlags::debugPerformance,"In [%s::%s Line: %d] took msecs: %lld\n",__FILE__,__FUNCTION__,__LINE__,chrono.getMillis());
 
 	computeInterpolatedHeights();
 
-	if(SystemFlags::getSystemSettingType(SystemFlags::debugPerformance).enabled && chrono.getMillis() > 0) SystemFlags::OutputDebug(SystemFlags::debugPerformance,"In [%s::%s Line: %d] took msecs: %lld\n",__FILE__,__FUNCTION__,__LINE__,chrono.getMillis());
+	if(SystemFlags::isDebugEnabled(SystemFlags::debugPerformance) && chrono.getMillis() > 0) SystemFlags::OutputDebug(SystemFlags::debugPerformance,"In [%s::%s Line: %d] took msecs: %lld\n",__FILE__,__FUNCTION__,__LINE__,chrono.getMillis());
 }
 
 // ==================== PRIVATE ====================
@@ -1809,34 +1971,39 @@ void Map::saveGame(XmlNode *rootNode) const {
 //	SurfaceCell *surfaceCells;
 	//printf("getSurfaceCellArraySize() = %d\n",getSurfaceCellArraySize());
 
+	// one batch holds up to 101 cells of "0|1|..." flags, appended as
+	// characters so the strings are not rebuilt for every flag
+	const size_t batchListSize = 101 * 2 * GameConstants::maxPlayers;
 	string exploredList = "";
 	string visibleList = "";
+	exploredList.reserve(batchListSize);
+	visibleList.reserve(batchListSize);
 
 	for(unsigned int i = 0; i < (unsigned int)getSurfaceCellArraySize(); ++i) {
 		SurfaceCell &surfaceCell = surfaceCells[i];
 
-		if(exploredList != "") {
-			exploredList += ",";
+		if(exploredList.empty() == false) {
+			exploredList += ',';
 		}
 
 		for(unsigned int j = 0; j < (unsigned int)GameConstants::maxPlayers; ++j) {
 			if(j > 0) {
-				exploredList += "|";
+				exploredList += '|';
 			}
 
-			exploredList += intToStr(surfaceCell.isExplored(j));
+			exploredList += (surfaceCell.isExplored(j) == true ? '1' : '0');
 		}
 
-		if(visibleList != "") {
-			visibleList += ",";
+		if(visibleList.empty() == false) {
+			visibleList += ',';
 		}
 
 		for(unsigned int j = 0; j < (unsigned int)GameConstants::maxPlayers; ++j) {
 			if(j > 0) {
-				visibleList += "|";
+				visibleList += '|';
 			}
 
-			visibleList += intToStr(surfaceCell.isVisible(j));
+			visibleList += (surfaceCell.isVisible(j) == true ? '1' : '0');
 		}
 
 		surfaceCell.saveGame(mapNode,i);
@@ -1847,12 +2014,12 @@ void Map::saveGame(XmlNode *rootNode) const {
 			surfaceCellNode->addAttribute("exploredList",exploredList, mapTagReplacements);
 			surfaceCellNode->addAttribute("visibleList",visibleList, mapTagReplacements);
 
-			exploredList = "";
-			visibleList = "";
+			exploredList.clear();
+			visibleList.clear();
 		}
 	}
 
-	if(exploredList != "") {
+	if(exploredList.empty() == false) {
 		XmlNode *surfaceCellNode = mapNode->addChild("SurfaceCell");
 		surfaceCellNode->addAttribute("batchIndex",intToStr(getSurfaceCellArraySize()), mapTagReplacements);
 		surfaceCellNode->addAttribute("exploredList",exploredList, mapTagReplacements);
@@ -28,6 +28,8 @@
 #include "unit_type.h"
 #include "command.h"
 #include "checksum.h"
+#include "cluster_map.h"
+#include "unit_grid.h"
 #include "leak_dumper.h"
 
 
@@ -40,6 +42,7 @@ using Shared::Graphics::Vec4f;
 using Shared::Graphics::Vec2f;
 using Shared::Graphics::Vec2i;
 using Shared::Graphics::Texture2D;
+using Shared::Platform::uint64;
 
 class Tileset;
 class Unit;
@@ -106,6 +109,59 @@ public:
 	void loadGame(const XmlNode *rootNode, int index, World *world);
 };
 
+// =====================================================
+// 	class TeamBitPlane
+//
+///	One bit per surface cell for every team, packed 64 cells to a word.
+///	Cell index is y * surfaceW + x, so a row of the map is a contiguous
+///	run of bits and whole rows or maps can be set, cleared and tested a
+///	word at a time.
+// =====================================================
+
+class TeamBitPlane {
+public:
+	static const int bitsPerWord;
+	static const int teamCount;
+
+private:
+	int cellCount;
+	int wordCount;	//words per team
+	vector<uint64> words;
+
+public:
+	TeamBitPlane();
+
+	void init(int cellCount);
+	void clear();
+
+	inline int getCellCount() const	{return cellCount;}
+	inline int getWordCount() const	{return wordCount;}
+
+	inline bool test(int teamIndex, int cellIndex) const {
+		return ((words[teamIndex * wordCount + cellIndex / bitsPerWord] >> (cellIndex % bitsPerWord)) & 1) != 0;
+	}
+	inline void set(int teamIndex, int cellIndex, bool value) {
+		uint64 &word = words[teamIndex * wordCount + cellIndex / bitsPerWord];
+		const uint64 bit = (uint64)1 << (cellIndex % bitsPerWord);
+		if(value == true) {
+			word |= bit;
+		}
+		else {
+			word &= ~bit;
+		}
+	}
+
+	//word wide access, bit k of word w is cell w * bitsPerWord + k
+	inline uint64 getWord(int teamIndex, int wordIndex) const	{return words[teamIndex * wordCount + wordIndex];}
+	inline void setWordBits(int teamIndex, int wordIndex, uint64 mask)	{words[teamIndex * wordCount + wordIndex] |= mask;}
+	inline void clearWordBits(int teamIndex, int wordIndex, uint64 mask)	{words[teamIndex * wordCount + wordIndex] &= ~mask;}
+
+	//cells [firstCellIndex, lastCellIndex)
+	void setRange(int teamIndex, int firstCellIndex, int lastCellIndex, bool value);
+	bool testRangeAny(int teamIndex, int firstCellIndex, int lastCellIndex) const;
+	void fill(int teamIndex, bool value);
+};
+
 // =====================================================
 // 	class SurfaceCell
 //
@@ -130,9 +186,10 @@ private:
 	//object & resource
 	Object *object;
 
-	//visibility
-	bool visible[GameConstants::maxPlayers + GameConstants::specialFactions];
-    bool explored[GameConstants::maxPlayers + GameConstants::specialFactions];
+	//visibility, the bits live in the map's planes
+	TeamBitPlane *visiblePlane;
+	TeamBitPlane *exploredPlane;
+	int planeIndex;
 
 	//cache
 	bool nearSubmerged;
@@ -156,8 +213,9 @@ public:
 	inline const Vec2f &getSurfTexCoord() const		{return surfTexCoord;}
 	inline bool getNearSubmerged() const				{return nearSubmerged;}
 
-	inline bool isVisible(int teamIndex) const		{return visible[teamIndex];}
-	inline bool isExplored(int teamIndex) const		{return explored[teamIndex];}
+	inline bool isVisible(int teamIndex) const		{return visiblePlane != NULL && visiblePlane->test(teamIndex, planeIndex);}
+	inline bool isExplored(int teamIndex) const		{return exploredPlane != NULL && exploredPlane->test(teamIndex, planeIndex);}
+	inline int getPlaneIndex() const					{return planeIndex;}
 	string isVisibleString() const;
 	string isExploredString() const;
 
@@ -173,6 +231,7 @@ public:
 	inline void setSurfTexCoord(const Vec2f &stc)		{this->surfTexCoord= stc;}
 	void setExplored(int teamIndex, bool explored);
     void setVisible(int teamIndex, bool visible);
+	void setPlanes(TeamBitPlane *visiblePlane, TeamBitPlane *exploredPlane, int planeIndex);
     inline void setNearSubmerged(bool nearSubmerged)	{this->nearSubmerged= nearSubmerged;}
 
 	//misc
@@ -228,10 +287,14 @@ private:
 	int maxPlayers;
 	Cell *cells;
 	SurfaceCell *surfaceCells;
+	TeamBitPlane visiblePlane;
+	TeamBitPlane exploredPlane;
 	Vec2i *startLocations;
 	Checksum checksumValue;
 	float maxMapHeight;
 	string mapFile;
+	mutable ClusterMap clusterMap;
+	UnitGrid unitGrid;
 
 private:
 	Map(Map&);
@@ -242,6 +305,8 @@ public:
 	~Map();
 	void end(); //to kill particles
 	Checksum * getChecksumValue() { return &checksumValue; }
+	ClusterMap * getClusterMap() const { return &clusterMap; }
+	const UnitGrid * getUnitGrid() const { return &unitGrid; }
 
 	void init(Tileset *tileset);
 	Checksum load(const string &path, TechTree *techTree, Tileset *tileset);
@@ -292,6 +357,10 @@ public:
 	inline SurfaceCell *getSurfaceCell(const Vec2i &sPos) const {
 		return getSurfaceCell(sPos.x, sPos.y);
 	}
+	inline TeamBitPlane *getVisiblePlane()							{return &visiblePlane;}
+	inline const TeamBitPlane *getVisiblePlane() const				{return &visiblePlane;}
+	inline TeamBitPlane *getExploredPlane()							{return &exploredPlane;}
+	inline const TeamBitPlane *getExploredPlane() const				{return &exploredPlane;}
 
 	inline int getW() const											{return w;}
 	inline int getH() const											{return h;}
@@ -339,6 +408,11 @@ public:
 	bool canMove(const Unit *unit, const Vec2i &pos1, const Vec2i &pos2,std::map<Vec2i, std::map<Vec2i, std::map<int, std::map<Field,bool> > > > *lookupCache=NULL) const;
     void putUnitCells(Unit *unit, const Vec2i &pos,bool ignoreSkill = false, bool threaded = false);
 	void clearUnitCells(Unit *unit, const Vec2i &pos,bool ignoreSkill = false);
+	// drops a unit that is about to be deleted from the unit grid
+	void removeUnitFromGrid(const Unit *unit);
+	// Appends every field of every cell in [minPos, maxPos] that holds a unit of
+	// the faction; sort the result to get the order of a cell by cell scan
+	void findUnitCells(int factionIndex, const Vec2i &minPos, const Vec2i &maxPos, vector<UnitCellRef> &unitCells) const;
 
 	Vec2i computeRefPos(const Selection *selection) const;
 	Vec2i computeDestPos(	const Vec2i &refUnitPos, const Vec2i &unitPos,
@@ -399,8 +473,8 @@ public:
 		   isInside(pos2) == false || isInsideSurface(toSurfCoords(pos2)) == false) {
 
 			//printf("[%s] Line: %d returning false\n",__FUNCTION__,__LINE__);
-			if(SystemFlags::getSystemSettingType(SystemFlags::debugWorldSynch).enabled == true &&
-					SystemFlags::getSystemSettingType(SystemFlags::debugWorldSynchMax).enabled == true) {
+			if(SystemFlags::isDebugEnabled(SystemFlags::debugWorldSynch) == true &&
+					SystemFlags::isDebugEnabled(SystemFlags::debugWorldSynchMax) == true) {
 				char szBuf[8096]="";
 				snprintf(szBuf,8096,"In aproxCanMoveSoon() return false");
 				if(Thread::isCurrentThreadMainThread() == false) {
@@ -426,8 +500,8 @@ public:
 		if(size == 1) {
 			bool tryPosResult = isAproxFreeCellOrMightBeFreeSoon(unit->getPosNotThreadSafe(),pos2, field, teamIndex);
 
-			if(SystemFlags::getSystemSettingType(SystemFlags::debugWorldSynch).enabled == true &&
-					SystemFlags::getSystemSettingType(SystemFlags::debugWorldSynchMax).enabled == true) {
+			if(SystemFlags::isDebugEnabled(SystemFlags::debugWorldSynch) == true &&
+					SystemFlags::isDebugEnabled(SystemFlags::debugWorldSynchMax) == true) {
 				string extraInfo = (string("tryPosResult = ") + (tryPosResult ? string("true") : string("false")));
 				const SurfaceCell *sc= getSurfaceCell(toSurfCoords(pos2));
 				if(sc->isVisible(teamIndex)) {
@@ -456,8 +530,8 @@ public:
 				Vec2i tryPos = Vec2i(pos1.x, pos2.y);
 				bool tryPosResult = isAproxFreeCellOrMightBeFreeSoon(unit->getPosNotThreadSafe(),tryPos, field, teamIndex);
 
-				if(SystemFlags::getSystemSettingType(SystemFlags::debugWorldSynch).enabled == true &&
-						SystemFlags::getSystemSettingType(SystemFlags::debugWorldSynchMax).enabled == true) {
+				if(SystemFlags::isDebugEnabled(SystemFlags::debugWorldSynch) == true &&
+						SystemFlags::isDebugEnabled(SystemFlags::debugWorldSynchMax) == true) {
 					string extraInfo = (string("tryPosResult = ") + (tryPosResult ? string("true") : string("false")));
 					const SurfaceCell *sc= getSurfaceCell(toSurfCoords(tryPos));
 					if(sc->isVisible(teamIndex)) {
@@ -486,8 +560,8 @@ public:
 				tryPos = Vec2i(pos2.x, pos1.y);
 				tryPosResult = isAproxFreeCellOrMightBeFreeSoon(unit->getPosNotThreadSafe(),tryPos, field, teamIndex);
 
-				if(SystemFlags::getSystemSettingType(SystemFlags::debugWorldSynch).enabled == true &&
-						SystemFlags::getSystemSettingType(SystemFlags::debugWorldSynchMax).enabled == true) {
+				if(SystemFlags::isDebugEnabled(SystemFlags::debugWorldSynch) == true &&
+						SystemFlags::isDebugEnabled(SystemFlags::debugWorldSynchMax) == true) {
 					string extraInfo = (string("tryPosResult = ") + (tryPosResult ? string("true") : string("false")));
 					const SurfaceCell *sc= getSurfaceCell(toSurfCoords(tryPos));
 					if(sc->isVisible(teamIndex)) {
@@ -525,8 +599,8 @@ public:
 			}
 
 			if(unit == NULL || isBadHarvestPos == true) {
-				if(SystemFlags::getSystemSettingType(SystemFlags::debugWorldSynch).enabled == true &&
-						SystemFlags::getSystemSettingType(SystemFlags::debugWorldSynchMax).enabled == true) {
+				if(SystemFlags::isDebugEnabled(SystemFlags::debugWorldSynch) == true &&
+						SystemFlags::isDebugEnabled(SystemFlags::debugWorldSynchMax) == true) {
 					char szBuf[8096]="";
 					snprintf(szBuf,8096,"In aproxCanMoveSoon() return false");
 					if(Thread::isCurrentThreadMainThread() == false) {
@@ -551,8 +625,8 @@ public:
 					if(isInside(cellPos) && isInsideSurface(toSurfCoords(cellPos))) {
 						if(getCell(cellPos)->getUnit(unit->getCurrField()) != unit) {
 							if(isAproxFreeCellOrMightBeFreeSoon(unit->getPosNotThreadSafe(),cellPos, field, teamIndex) == false) {
-								if(SystemFlags::getSystemSettingType(SystemFlags::debugWorldSynch).enabled == true &&
-										SystemFlags::getSystemSettingType(SystemFlags::debugWorldSynchMax).enabled == true) {
+								if(SystemFlags::isDebugEnabled(SystemFlags::debugWorldSynch) == true &&
+										SystemFlags::isDebugEnabled(SystemFlags::debugWorldSynchMax) == true) {
 									char szBuf[8096]="";
 									snprintf(szBuf,8096,"In aproxCanMoveSoon() return false");
 									if(Thread::isCurrentThreadMainThread() == false) {
@@ -568,8 +642,8 @@ public:
 						}
 					}
 					else {
-						if(SystemFlags::getSystemSettingType(SystemFlags::debugWorldSynch).enabled == true &&
-								SystemFlags::getSystemSettingType(SystemFlags::debugWorldSynchMax).enabled == true) {
+						if(SystemFlags::isDebugEnabled(SystemFlags::debugWorldSynch) == true &&
+								SystemFlags::isDebugEnabled(SystemFlags::debugWorldSynchMax) == true) {
 							char szBuf[8096]="";
 							snprintf(szBuf,8096,"In aproxCanMoveSoon() return false");
 							if(Thread::isCurrentThreadMainThread() == false) {
@@ -595,8 +669,8 @@ public:
 			}
 
 			if(isBadHarvestPos == true) {
-				if(SystemFlags::getSystemSettingType(SystemFlags::debugWorldSynch).enabled == true &&
-						SystemFlags::getSystemSettingType(SystemFlags::debugWorldSynchMax).enabled == true) {
+				if(SystemFlags::isDebugEnabled(SystemFlags::debugWorldSynch) == true &&
+						SystemFlags::isDebugEnabled(SystemFlags::debugWorldSynchMax) == true) {
 					char szBuf[8096]="";
 					snprintf(szBuf,8096,"In aproxCanMoveSoon() return false");
 					if(Thread::isCurrentThreadMainThread() == false) {
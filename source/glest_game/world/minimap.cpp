@@ -34,10 +34,6 @@ const float Minimap::exploredAlpha= 0.5f;
 Minimap::Minimap() {
 	fowPixmap0= NULL;
 	fowPixmap1= NULL;
-	fowPixmap1_default=NULL;
-	fowPixmap0Copy = NULL;
-	fowPixmap1Copy = NULL;
-	fowPixmap1Copy_default = NULL;
 	fogOfWar= true;
 	gameSettings= NULL;
 	tex=NULL;
@@ -63,29 +59,16 @@ void Minimap::init(int w, int h, const World *world, bool fogOfWar) {
 
 	if(GlobalStaticFlags::getIsNonGraphicalModeEnabled() == false) {
 		fowPixmap0 = new Pixmap2D(potW, potH, 1);
-		fowPixmap0Copy = new Pixmap2D(potW, potH, 1);
 		fowPixmap1 = new Pixmap2D(potW, potH, 1);
-		fowPixmap1_default = new Pixmap2D(potW, potH, 1);
-		fowPixmap1Copy = new Pixmap2D(potW, potH, 1);
-		fowPixmap1Copy_default = new Pixmap2D(potW, potH, 1);
 
 		if(SystemFlags::getSystemSettingType(SystemFlags::debugSystem).enabled) SystemFlags::OutputDebug(SystemFlags::debugSystem,"In [%s::%s Line: %d]\n",__FILE__,__FUNCTION__,__LINE__);
 
+		// explored cells (all of them when map resources are shown) get
+		// their alpha from the world's first computeFow
 		fowPixmap0->setPixels(&f,1);
-		if((this->gameSettings->getFlagTypes1() & ft1_show_map_resources) == ft1_show_map_resources) {
-			f = 0.f;
-			fowPixmap1->setPixels(&f,1);
-			f = 0.5f;
-			for (int y=1; y < scaledH - 1; ++y) {
-				for (int x=1; x < scaledW - 1; ++x) {
-					fowPixmap1->setPixel(x, y, &f,1);
-				}
-			}
-		}
-		else {
-			fowPixmap1->setPixels(&f,1);
-		}
+		fowPixmap1->setPixels(&f,1);
 	}
+	fowChangedCells.clear();
 
 	if(SystemFlags::getSystemSettingType(SystemFlags::debugSystem).enabled) SystemFlags::OutputDebug(SystemFlags::debugSystem,"In [%s::%s Line: %d]\n",__FILE__,__FUNCTION__,__LINE__);
 
@@ -102,6 +85,10 @@ void Minimap::init(int w, int h, const World *world, bool fogOfWar) {
 		fowTex->getPixmap()->setPixels(&f,1);
 	}
 
+	if(fogOfWar == false) {
+		fillFowTex(1.f);
+	}
+
 	if(SystemFlags::getSystemSettingType(SystemFlags::debugSystem).enabled) SystemFlags::OutputDebug(SystemFlags::debugSystem,"In [%s::%s Line: %d]\n",__FILE__,__FUNCTION__,__LINE__);
 
 	//tex
@@ -120,141 +107,61 @@ Minimap::~Minimap() {
 	Logger::getInstance().add(Lang::getInstance().getString("LogScreenGameUnLoadingMiniMap","",true), true);
 	delete fowPixmap0;
 	fowPixmap0=NULL;
-	delete fowPixmap0Copy;
-	fowPixmap0Copy = NULL;
 	delete fowPixmap1;
 	fowPixmap1=NULL;
-	delete fowPixmap1_default;
-	fowPixmap1_default = NULL;
-	delete fowPixmap1Copy;
-	fowPixmap1Copy=NULL;
-	delete fowPixmap1Copy_default;
-	fowPixmap1Copy_default = NULL;
 }
 
 // ==================== set ====================
 
-void Minimap::incFowTextureAlphaSurface(const Vec2i sPos, float alpha,
-		bool isIncrementalUpdate) {
-	if(fowPixmap1) {
+// Starts fading sPos towards alpha, called by the world for the cells
+// whose visibility or exploration changed this update
+void Minimap::setFowTextureAlphaSurface(const Vec2i &sPos, float alpha) {
+	if(fogOfWar == true && fowPixmap0 && fowPixmap1) {
 		assert(sPos.x < fowPixmap1->getW() && sPos.y < fowPixmap1->getH());
 
-		if(fowPixmap1->getPixelf(sPos.x, sPos.y) < alpha){
-			fowPixmap1->setPixel(sPos.x, sPos.y, alpha);
-		}
-
-		if(fowPixmap1Copy != NULL && isIncrementalUpdate == true) {
-			if(fowPixmap1Copy->getPixelf(sPos.x, sPos.y) < alpha){
-				fowPixmap1Copy->setPixel(sPos.x, sPos.y, alpha);
+		float p1 = fowPixmap1->getPixelf(sPos.x, sPos.y);
+		if(p1 != alpha) {
+			// a cell already fading this update is listed already
+			if(fowPixmap0->getPixelf(sPos.x, sPos.y) == p1) {
+				fowChangedCells.push_back(sPos);
 			}
+			fowPixmap1->setPixel(sPos.x, sPos.y, alpha);
 		}
 	}
 }
 
-void Minimap::copyFowTexAlphaSurface() {
-	if(fowPixmap1_default != NULL && fowPixmap1 != NULL) {
-		fowPixmap1_default->copy(fowPixmap1);
-	}
-	if(fowPixmap1Copy_default != NULL && fowPixmap1Copy != NULL) {
-		fowPixmap1Copy_default->copy(fowPixmap1Copy);
-	}
-}
-void Minimap::restoreFowTexAlphaSurface() {
-	if(fowPixmap1 != NULL && fowPixmap1_default != NULL) {
-		fowPixmap1->copy(fowPixmap1_default);
-	}
-	if(fowPixmap1Copy != NULL && fowPixmap1Copy_default != NULL) {
-		fowPixmap1Copy->copy(fowPixmap1Copy_default);
-	}
-}
-
 void Minimap::setFogOfWar(bool value) {
 	fogOfWar = value;
-	resetFowTex();
-}
-
-void Minimap::copyFowTex() {
-	if(fowPixmap0Copy != NULL && fowPixmap0 != NULL) {
-		fowPixmap0Copy->copy(fowPixmap0);
-	}
-	if(fowPixmap1Copy != NULL && fowPixmap1 != NULL) {
-		fowPixmap1Copy->copy(fowPixmap1);
-	}
-}
-void Minimap::restoreFowTex() {
-	if(fowPixmap0 != NULL && fowPixmap0Copy != NULL) {
-		fowPixmap0->copy(fowPixmap0Copy);
-	}
-	if(fowPixmap1 != NULL && fowPixmap1Copy != NULL) {
-		fowPixmap1->copy(fowPixmap1Copy);
+	if(fogOfWar == false) {
+		fillFowTex(1.f);
 	}
 }
 
+// Ends the fades of the previous update, the cells that reached their
+// alpha are dropped from the changed list
 void Minimap::resetFowTex() {
-	if(fowTex && fowPixmap0 && fowPixmap1) {
-		Pixmap2D *tmpPixmap= fowPixmap0;
-		fowPixmap0= fowPixmap1;
-		fowPixmap1= tmpPixmap;
-
-		// Could turn off ONLY fog of war by setting below to false
-		bool overridefogOfWarValue = fogOfWar;
-
-		for(int indexPixelWidth = 0;
-				indexPixelWidth < fowTex->getPixmap()->getW();
-				++indexPixelWidth){
-			for(int indexPixelHeight = 0;
-					indexPixelHeight < fowTex->getPixmap()->getH();
-					++indexPixelHeight){
-				if ((fogOfWar == false && overridefogOfWarValue == false)) {
-					//(gameSettings->getFlagTypes1() & ft1_show_map_resources) != ft1_show_map_resources) {
-					//printf("Line: %d\n",__LINE__);
-
-					float p0 = fowPixmap0->getPixelf(indexPixelWidth, indexPixelHeight);
-					float p1 = fowPixmap1->getPixelf(indexPixelWidth, indexPixelHeight);
-					if (p0 > p1) {
-						fowPixmap1->setPixel(indexPixelWidth, indexPixelHeight, p0);
-					}
-					else {
-						fowPixmap1->setPixel(indexPixelWidth, indexPixelHeight, p1);
-					}
-				}
-				else if((fogOfWar && overridefogOfWarValue) ||
-					(gameSettings->getFlagTypes1() & ft1_show_map_resources) == ft1_show_map_resources) {
-					//printf("Line: %d\n",__LINE__);
-
-					float p0= fowPixmap0->getPixelf(indexPixelWidth, indexPixelHeight);
-					float p1= fowPixmap1->getPixelf(indexPixelWidth, indexPixelHeight);
-
-					if(p1 > exploredAlpha) {
-						fowPixmap1->setPixel(indexPixelWidth, indexPixelHeight, exploredAlpha);
-					}
-					if(p0 > p1) {
-						fowPixmap1->setPixel(indexPixelWidth, indexPixelHeight, p0);
-					}
-				}
-				else {
-					//printf("Line: %d\n",__LINE__);
-					fowPixmap1->setPixel(indexPixelWidth, indexPixelHeight, 1.f);
-				}
+	if(fowPixmap0 && fowPixmap1) {
+		for(unsigned int index = 0; index < fowChangedCells.size(); ++index) {
+			const Vec2i &sPos = fowChangedCells[index];
+			float p1 = fowPixmap1->getPixelf(sPos.x, sPos.y);
+			fowPixmap0->setPixel(sPos.x, sPos.y, p1);
+			if(fowTex) {
+				fowTex->getPixmap()->setPixel(sPos.x, sPos.y, p1);
 			}
 		}
 	}
+	fowChangedCells.clear();
 }
 
 void Minimap::updateFowTex(float t) {
 	if(fowTex && fowPixmap0 && fowPixmap1) {
-		for(int indexPixelWidth = 0;
-				indexPixelWidth < fowPixmap0->getW();
-				++indexPixelWidth){
-			for(int indexPixelHeight = 0;
-					indexPixelHeight < fowPixmap0->getH();
-					++indexPixelHeight){
-				float p1 = fowPixmap1->getPixelf(indexPixelWidth, indexPixelHeight);
-				float p2 = fowTex->getPixmap()->getPixelf(indexPixelWidth, indexPixelHeight);
-				if(p1 != p2) {
-					float p0 = fowPixmap0->getPixelf(indexPixelWidth, indexPixelHeight);
-					fowTex->getPixmap()->setPixel(indexPixelWidth, indexPixelHeight, p0+(t*(p1-p0)));
-				}
+		for(unsigned int index = 0; index < fowChangedCells.size(); ++index) {
+			const Vec2i &sPos = fowChangedCells[index];
+			float p1 = fowPixmap1->getPixelf(sPos.x, sPos.y);
+			float p2 = fowTex->getPixmap()->getPixelf(sPos.x, sPos.y);
+			if(p1 != p2) {
+				float p0 = fowPixmap0->getPixelf(sPos.x, sPos.y);
+				fowTex->getPixmap()->setPixel(sPos.x, sPos.y, p0+(t*(p1-p0)));
 			}
 		}
 	}
@@ -296,6 +203,17 @@ void Minimap::computeTexture(const World *world) {
 	}
 }
 
+void Minimap::fillFowTex(float alpha) {
+	if(fowPixmap0 && fowPixmap1) {
+		fowPixmap0->setPixels(&alpha,1);
+		fowPixmap1->setPixels(&alpha,1);
+	}
+	if(fowTex) {
+		fowTex->getPixmap()->setPixels(&alpha,1);
+	}
+	fowChangedCells.clear();
+}
+
 void Minimap::saveGame(XmlNode *rootNode) {
 	std::map<string,string> mapTagReplacements;
 	XmlNode *minimapNode = rootNode->addChild("Minimap");
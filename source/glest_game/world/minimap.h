@@ -17,6 +17,7 @@
     #include <winsock.h>
 #endif
 
+#include <vector>
 #include "pixmap.h"
 #include "texture.h"
 #include "xml_parser.h"
@@ -24,6 +25,7 @@
 
 namespace Glest{ namespace Game{
 
+using std::vector;
 using Shared::Graphics::Vec4f;
 using Shared::Graphics::Vec3f;
 using Shared::Graphics::Vec2i;
@@ -48,19 +50,18 @@ enum ExplorationState{
 
 class Minimap{
 private:
-	Pixmap2D *fowPixmap0;
-	Pixmap2D *fowPixmap1;
-	Pixmap2D *fowPixmap1_default;
-	Pixmap2D *fowPixmap0Copy;
-	Pixmap2D *fowPixmap1Copy;
-	Pixmap2D *fowPixmap1Copy_default;
+	Pixmap2D *fowPixmap0;	//alpha a changing cell fades from
+	Pixmap2D *fowPixmap1;	//alpha a changing cell fades to
+	// cells whose target alpha changed since the last resetFowTex, only
+	// these are interpolated by updateFowTex
+	vector<Vec2i> fowChangedCells;
 
 	Texture2D *tex;
 	Texture2D *fowTex;    //Fog Of War Texture2D
 	bool fogOfWar;
 	const GameSettings *gameSettings;
 
-private:
+public:
 	static const float exploredAlpha;
 
 public:
@@ -71,22 +72,17 @@ public:
 	const Texture2D *getFowTexture() const	{return fowTex;}
 	const Texture2D *getTexture() const		{return tex;}
 
-	void incFowTextureAlphaSurface(const Vec2i sPos, float alpha, bool isIncrementalUpdate=false);
+	void setFowTextureAlphaSurface(const Vec2i &sPos, float alpha);
 	void resetFowTex();
 	void updateFowTex(float t);
 	void setFogOfWar(bool value);
 
-	void copyFowTex();
-	void restoreFowTex();
-
-	void copyFowTexAlphaSurface();
-	void restoreFowTexAlphaSurface();
-
 	void saveGame(XmlNode *rootNode);
 	void loadGame(const XmlNode *rootNode);
 
 private:
 	void computeTexture(const World *world);
+	void fillFowTex(float alpha);
 };
 
 }}//end namespace
@@ -0,0 +1,263 @@
+// ==============================================================
+//	This file is part of MegaGlest (www.megaglest.org)
+//
+//	Copyright (C) 2026 The MegaGlest Team
+//
+//	You can redistribute this code and/or modify it under
+//	the terms of the GNU General Public License as published
+//	by the Free Software Foundation; either version 2 of the
+//	License, or (at your option) any later version
+// ==============================================================
+
+#include "sight_map.h"
+
+#include "map.h"
+#include "game_constants.h"
+#include "util.h"
+#include "leak_dumper.h"
+
+using namespace Shared::Util;
+
+namespace Glest{ namespace Game{
+
+static inline bool isInsideDisc(int dx, int dy, int surfRange) {
+	return dx * dx + dy * dy < surfRange * surfRange;
+}
+
+// =====================================================
+// 	class SightStencil
+// =====================================================
+
+SightStencil::SightStencil(int radius) {
+	this->radius = max(radius, 1);
+	halfWidths.resize(2 * this->radius - 1);
+	for(int dy = -this->radius + 1; dy < this->radius; ++dy) {
+		int halfWidth = 0;
+		while(isInsideDisc(halfWidth + 1, dy, this->radius) == true) {
+			halfWidth++;
+		}
+		halfWidths[dy + this->radius - 1] = halfWidth;
+	}
+}
+
+// =====================================================
+// 	class SightMap
+// =====================================================
+
+SightMap::SightMap() : mutex(new Mutex(CODE_AT_LINE)) {
+	map			= NULL;
+	surfaceW	= 0;
+	surfaceH	= 0;
+	sweepId		= 0;
+	watchedTeam	= -1;
+}
+
+SightMap::~SightMap() {
+	clear();
+
+	delete mutex;
+	mutex = NULL;
+}
+
+void SightMap::init(Map *map, const vector<int> &teams) {
+	MutexSafeWrapper safeMutex(mutex,string(__FILE__) + "_" + intToStr(__LINE__));
+
+	this->map	= map;
+	surfaceW	= map->getSurfaceW();
+	surfaceH	= map->getSurfaceH();
+	teamCounts.clear();
+	teamCounts.resize(GameConstants::maxPlayers + GameConstants::specialFactions);
+	unitSights.clear();
+	sweepId		= 0;
+	watchedTeamChanges.clear();
+
+	for(unsigned int index = 0; index < teams.size(); ++index) {
+		int teamIndex = teams[index];
+		if(teamIndex < 0 || teamIndex >= (int)teamCounts.size()) {
+			continue;
+		}
+		map->getVisiblePlane()->fill(teamIndex, false);
+	}
+}
+
+void SightMap::clear() {
+	MutexSafeWrapper safeMutex(mutex,string(__FILE__) + "_" + intToStr(__LINE__));
+
+	map			= NULL;
+	surfaceW	= 0;
+	surfaceH	= 0;
+	teamCounts.clear();
+	unitSights.clear();
+	watchedTeamChanges.clear();
+}
+
+void SightMap::changeCount(int teamIndex, int x, int y, int delta) {
+	vector<uint16> &counts = teamCounts[teamIndex];
+	if(counts.empty() == true) {
+		counts.resize(surfaceW * surfaceH, 0);
+	}
+
+	uint16 &count = counts[y * surfaceW + x];
+	if(delta > 0) {
+		if(count++ == 0) {
+			map->getSurfaceCell(x, y)->setVisible(teamIndex, true);
+			if(teamIndex == watchedTeam) {
+				watchedTeamChanges.push_back(Vec2i(x, y));
+			}
+		}
+	}
+	else if(count > 0) {
+		if(--count == 0) {
+			map->getSurfaceCell(x, y)->setVisible(teamIndex, false);
+			if(teamIndex == watchedTeam) {
+				watchedTeamChanges.push_back(Vec2i(x, y));
+			}
+		}
+	}
+}
+
+const SightStencil &SightMap::findStencil(int radius) {
+	SightStencilMap::iterator iterFind = stencils.find(radius);
+	if(iterFind == stencils.end()) {
+		iterFind = stencils.insert(std::make_pair(radius, SightStencil(radius))).first;
+	}
+	return iterFind->second;
+}
+
+const SightStencil &SightMap::getStencil(int radius) {
+	MutexSafeWrapper safeMutex(mutex,string(__FILE__) + "_" + intToStr(__LINE__));
+	return findStencil(radius);
+}
+
+void SightMap::changeDisc(int teamIndex, const Vec2i &surfPos, int surfRange, int delta,
+						  const UnitSight *excludeSight) {
+	const SightStencil &stencil = findStencil(surfRange);
+	for(int dy = -surfRange + 1; dy < surfRange; ++dy) {
+		const int y = surfPos.y + dy;
+		if(y < 0 || y >= surfaceH) {
+			continue;
+		}
+		const int halfWidth = stencil.getHalfWidth(dy);
+		const int firstX = max(0, surfPos.x - halfWidth);
+		const int lastX = min(surfaceW - 1, surfPos.x + halfWidth);
+		for(int x = firstX; x <= lastX; ++x) {
+			// cells covered by both the old and the new disc keep their count
+			if(excludeSight != NULL &&
+				isInsideDisc(x - excludeSight->surfPos.x, y - excludeSight->surfPos.y, excludeSight->surfRange) == true) {
+				continue;
+			}
+			changeCount(teamIndex, x, y, delta);
+		}
+	}
+}
+
+void SightMap::removeSight(const UnitSight &sight) {
+	changeDisc(sight.teamIndex, sight.surfPos, sight.surfRange, -1, NULL);
+}
+
+void SightMap::setUnitSight(int unitId, int teamIndex, const Vec2i &surfPos, int surfRange) {
+	MutexSafeWrapper safeMutex(mutex,string(__FILE__) + "_" + intToStr(__LINE__));
+	if(map == NULL || teamIndex < 0 || teamIndex >= (int)teamCounts.size()) {
+		return;
+	}
+
+	UnitSight newSight;
+	newSight.teamIndex	= teamIndex;
+	newSight.surfPos	= surfPos;
+	newSight.surfRange	= surfRange;
+	newSight.sweepId	= sweepId;
+
+	UnitSightMap::iterator iterFind = unitSights.find(unitId);
+	if(iterFind == unitSights.end()) {
+		changeDisc(teamIndex, surfPos, surfRange, 1, NULL);
+		unitSights[unitId] = newSight;
+		return;
+	}
+
+	UnitSight &oldSight = iterFind->second;
+	if(oldSight.teamIndex == teamIndex && oldSight.surfPos == surfPos &&
+		oldSight.surfRange == surfRange) {
+		oldSight.sweepId = sweepId;
+		return;
+	}
+
+	if(oldSight.teamIndex == teamIndex) {
+		changeDisc(teamIndex, oldSight.surfPos, oldSight.surfRange, -1, &newSight);
+		changeDisc(teamIndex, surfPos, surfRange, 1, &oldSight);
+	}
+	else {
+		removeSight(oldSight);
+		changeDisc(teamIndex, surfPos, surfRange, 1, NULL);
+	}
+	oldSight = newSight;
+}
+
+void SightMap::removeUnitSight(int unitId) {
+	MutexSafeWrapper safeMutex(mutex,string(__FILE__) + "_" + intToStr(__LINE__));
+
+	UnitSightMap::iterator iterFind = unitSights.find(unitId);
+	if(iterFind != unitSights.end()) {
+		removeSight(iterFind->second);
+		unitSights.erase(iterFind);
+	}
+}
+
+void SightMap::beginSweep() {
+	MutexSafeWrapper safeMutex(mutex,string(__FILE__) + "_" + intToStr(__LINE__));
+	sweepId++;
+}
+
+void SightMap::endSweep() {
+	MutexSafeWrapper safeMutex(mutex,string(__FILE__) + "_" + intToStr(__LINE__));
+
+	for(UnitSightMap::iterator iterMap = unitSights.begin(); iterMap != unitSights.end();) {
+		if(iterMap->second.sweepId != sweepId) {
+			removeSight(iterMap->second);
+			unitSights.erase(iterMap++);
+		}
+		else {
+			++iterMap;
+		}
+	}
+}
+
+void SightMap::setWatchedTeam(int teamIndex) {
+	MutexSafeWrapper safeMutex(mutex,string(__FILE__) + "_" + intToStr(__LINE__));
+	watchedTeam = teamIndex;
+	watchedTeamChanges.clear();
+}
+
+int SightMap::getWatchedTeam() {
+	MutexSafeWrapper safeMutex(mutex,string(__FILE__) + "_" + intToStr(__LINE__));
+	return watchedTeam;
+}
+
+// A cell that flipped twice since the last take is listed twice, callers
+// read the cell's current state
+void SightMap::takeWatchedTeamChanges(vector<Vec2i> &changes) {
+	MutexSafeWrapper safeMutex(mutex,string(__FILE__) + "_" + intToStr(__LINE__));
+	changes.clear();
+	changes.swap(watchedTeamChanges);
+}
+
+int SightMap::getUnitSightCount() {
+	MutexSafeWrapper safeMutex(mutex,string(__FILE__) + "_" + intToStr(__LINE__));
+	return (int)unitSights.size();
+}
+
+int SightMap::getStencilCount() {
+	MutexSafeWrapper safeMutex(mutex,string(__FILE__) + "_" + intToStr(__LINE__));
+	return (int)stencils.size();
+}
+
+int SightMap::getCount(int teamIndex, const Vec2i &surfPos) {
+	MutexSafeWrapper safeMutex(mutex,string(__FILE__) + "_" + intToStr(__LINE__));
+	if(teamIndex < 0 || teamIndex >= (int)teamCounts.size() ||
+		surfPos.x < 0 || surfPos.y < 0 || surfPos.x >= surfaceW || surfPos.y >= surfaceH ||
+		teamCounts[teamIndex].empty() == true) {
+		return 0;
+	}
+	return teamCounts[teamIndex][surfPos.y * surfaceW + surfPos.x];
+}
+
+}}//end namespace
@@ -0,0 +1,134 @@
+// ==============================================================
+//	This file is part of MegaGlest (www.megaglest.org)
+//
+//	Copyright (C) 2026 The MegaGlest Team
+//
+//	You can redistribute this code and/or modify it under
+//	the terms of the GNU General Public License as published
+//	by the Free Software Foundation; either version 2 of the
+//	License, or (at your option) any later version
+// ==============================================================
+
+#ifndef _GLEST_GAME_SIGHTMAP_H_
+#define _GLEST_GAME_SIGHTMAP_H_
+
+#ifdef WIN32
+    #include <winsock2.h>
+    #include <winsock.h>
+#endif
+
+#include <vector>
+#include <map>
+#include "vec.h"
+#include "thread.h"
+#include "data_types.h"
+#include "leak_dumper.h"
+
+using std::vector;
+using Shared::Graphics::Vec2i;
+using Shared::Platform::Mutex;
+using Shared::Platform::uint16;
+using Shared::Platform::uint32;
+
+namespace Glest{ namespace Game{
+
+class Map;
+
+// =====================================================
+// 	class SightStencil
+//
+///	Position independent shape of a disc of cells: row dy of a disc
+///	with the given radius holds the cells with dx*dx + dy*dy < radius *
+///	radius, i.e. |dx| <= getHalfWidth(dy). Built once per radius.
+// =====================================================
+
+class SightStencil {
+private:
+	int radius;
+	vector<int> halfWidths;	//index dy + radius - 1
+
+public:
+	explicit SightStencil(int radius);
+
+	inline int getRadius() const				{return radius;}
+	inline int getHalfWidth(int dy) const		{return halfWidths[dy + radius - 1];}
+};
+
+// =====================================================
+// 	class SightMap
+//
+///	Reference counted team visibility of the surface cells. Every unit
+///	owns one sight disc; moving it, changing its range or team only
+///	touches the cells entering or leaving the disc, and a cell's
+///	SurfaceCell visible flag flips when its team count crosses zero.
+// =====================================================
+
+class SightMap {
+private:
+	class UnitSight {
+	public:
+		int teamIndex;
+		Vec2i surfPos;
+		int surfRange;
+		uint32 sweepId;
+	};
+	typedef std::map<int,UnitSight> UnitSightMap;
+	typedef std::map<int,SightStencil> SightStencilMap;
+
+	Map *map;
+	int surfaceW;
+	int surfaceH;
+	// one count per surface cell, allocated the first time a team sees something
+	vector<vector<uint16> > teamCounts;
+	UnitSightMap unitSights;
+	uint32 sweepId;
+	// one per distinct radius, never dropped so references stay valid
+	SightStencilMap stencils;
+	// cells whose count for watchedTeam crossed zero since the last take
+	int watchedTeam;
+	vector<Vec2i> watchedTeamChanges;
+	Mutex *mutex;
+
+public:
+	SightMap();
+	~SightMap();
+
+	// Forgets every sight and hides all cells of the given teams
+	void init(Map *map, const vector<int> &teams);
+	void clear();
+
+	// surfRange is the visible radius in surface cells, cells with
+	// dx*dx + dy*dy < surfRange*surfRange around surfPos are seen
+	void setUnitSight(int unitId, int teamIndex, const Vec2i &surfPos, int surfRange);
+	void removeUnitSight(int unitId);
+
+	// Units not passed to setUnitSight between beginSweep and endSweep
+	// (dead, removed or no longer operative) lose their sight
+	void beginSweep();
+	void endSweep();
+
+	// Records the cells of teamIndex that become visible or hidden, the
+	// minimap only redraws those
+	void setWatchedTeam(int teamIndex);
+	int getWatchedTeam();
+	void takeWatchedTeamChanges(vector<Vec2i> &changes);
+
+	int getUnitSightCount();
+	int getStencilCount();
+	const SightStencil &getStencil(int radius);
+	int getCount(int teamIndex, const Vec2i &surfPos);
+
+private:
+	SightMap(const SightMap &obj);
+	SightMap &operator=(const SightMap &obj);
+
+	const SightStencil &findStencil(int radius);
+	void changeDisc(int teamIndex, const Vec2i &surfPos, int surfRange, int delta,
+					const UnitSight *excludeSight);
+	void changeCount(int teamIndex, int x, int y, int delta);
+	void removeSight(const UnitSight &sight);
+};
+
+}}//end namespace
+
+#endif
@@ -13,15 +13,21 @@
 
 #include <stdexcept>
 #include <algorithm>
+#include <cstdio>
+#include <cstring>
 
 #include "renderer.h"
 #include "util.h"
 #include "math_util.h"
+#include "checksum.h"
+#include "conversion.h"
+#include "platform_util.h"
 #include "leak_dumper.h"
 
 using namespace std;
 using namespace Shared::Util;
 using namespace Shared::Graphics;
+using namespace Shared::PlatformCommon;
 
 namespace Glest{ namespace Game{
 
@@ -62,8 +68,32 @@ bool SurfaceInfo::operator==(const SurfaceInfo &si) const {
 // 	class SurfaceAtlas
 // ===============================
 
+const char *SurfaceAtlas::splatCacheHeader	= "MGSPLATCACHE";
+const int SurfaceAtlas::splatCacheVersion		= 1;
+const int SurfaceAtlas::maxSplatCacheEntries	= 512;
+
+SurfaceAtlas::SplatKey::SplatKey() {
+	crc[0]= crc[1]= crc[2]= crc[3]= 0;
+}
+
+bool SurfaceAtlas::SplatKey::operator<(const SplatKey &key) const {
+	for(int i = 0; i < 4; ++i) {
+		if(crc[i] != key.crc[i]) {
+			return crc[i] < key.crc[i];
+		}
+	}
+	return false;
+}
+
+SurfaceAtlas::PendingSplat::PendingSplat(int surfaceIndex, Texture2D *texture) {
+	this->surfaceIndex= surfaceIndex;
+	this->texture= texture;
+	this->ready= false;
+}
+
 SurfaceAtlas::SurfaceAtlas() {
 	surfaceSize= -1;
+	splatWeights= NULL;
 }
 
 void SurfaceAtlas::addSurface(SurfaceInfo *si) {
@@ -107,7 +137,7 @@ void SurfaceAtlas::addSurface(SurfaceInfo *si) {
 		}
 		else {
 			if(t) {
-				t->getPixmap()->splat(si->getLeftUp(), si->getRightUp(), si->getLeftDown(), si->getRightDown());
+				pendingSplats.push_back(PendingSplat((int)surfaceInfos.size() - 1, t));
 			}
 		}
 	}
@@ -117,6 +147,71 @@ void SurfaceAtlas::addSurface(SurfaceInfo *si) {
 	}
 }
 
+void SurfaceAtlas::splatSurfaces(WorkStealingTaskPool *taskPool, const string &cacheFile) {
+	if(pendingSplats.empty() == true) {
+		return;
+	}
+
+	Chrono chrono;
+	chrono.start();
+
+	map<const Pixmap2D *,uint32> pixmapCRCs;
+	for(unsigned int i = 0; i < pendingSplats.size(); ++i) {
+		PendingSplat &splat= pendingSplats[i];
+		const SurfaceInfo &si= surfaceInfos[splat.surfaceIndex];
+		splat.key.crc[0]= getPixmapContentCRC(si.getLeftUp(), pixmapCRCs);
+		splat.key.crc[1]= getPixmapContentCRC(si.getRightUp(), pixmapCRCs);
+		splat.key.crc[2]= getPixmapContentCRC(si.getLeftDown(), pixmapCRCs);
+		splat.key.crc[3]= getPixmapContentCRC(si.getRightDown(), pixmapCRCs);
+	}
+
+	int pixelByteCount= (int)pendingSplats[0].texture->getPixmapConst()->getPixelByteCount();
+	int cacheHits= 0;
+	if(cacheFile != "") {
+		cacheHits= loadSplatCache(cacheFile, pixelByteCount);
+	}
+
+	splatsToBlend.clear();
+	for(unsigned int i = 0; i < pendingSplats.size(); ++i) {
+		if(pendingSplats[i].ready == false) {
+			splatsToBlend.push_back(i);
+		}
+	}
+
+	if(splatsToBlend.empty() == false) {
+		// The weights only depend on the size, so all splats share them
+		PixmapSplatWeights weights(surfaceSize, surfaceSize);
+		splatWeights= &weights;
+
+		if(taskPool != NULL && splatsToBlend.size() > 1) {
+			taskPool->runTasks(this, (int)splatsToBlend.size());
+		}
+		else {
+			for(unsigned int i = 0; i < splatsToBlend.size(); ++i) {
+				runPoolTask(i, 0);
+			}
+		}
+		splatWeights= NULL;
+
+		if(cacheFile != "") {
+			saveSplatCache(cacheFile, pixelByteCount);
+		}
+	}
+
+	if(SystemFlags::getSystemSettingType(SystemFlags::debugSystem).enabled) SystemFlags::OutputDebug(SystemFlags::debugSystem,"In [%s::%s Line: %d] splatted %d textures, %d from [%s], took %lld msecs\n",extractFileFromDirectoryPath(__FILE__).c_str(),__FUNCTION__,__LINE__,(int)pendingSplats.size(),cacheHits,cacheFile.c_str(),(long long int)chrono.getMillis());
+
+	pendingSplats.clear();
+	splatsToBlend.clear();
+}
+
+void SurfaceAtlas::runPoolTask(int taskIndex, int workerIndex) {
+	PendingSplat &splat= pendingSplats[splatsToBlend[taskIndex]];
+	const SurfaceInfo &si= surfaceInfos[splat.surfaceIndex];
+
+	splat.texture->getPixmap()->splat(si.getLeftUp(), si.getRightUp(), si.getLeftDown(), si.getRightDown(), *splatWeights);
+	splat.ready= true;
+}
+
 float SurfaceAtlas::getCoordStep() const {
 	return 1.f;
 }
@@ -140,4 +235,167 @@ void SurfaceAtlas::checkDimensions(const Pixmap2D *p) {
 	}
 }
 
+uint32 SurfaceAtlas::getPixmapContentCRC(const Pixmap2D *pixmap, map<const Pixmap2D *,uint32> &pixmapCRCs) const {
+	map<const Pixmap2D *,uint32>::const_iterator iterFind= pixmapCRCs.find(pixmap);
+	if(iterFind != pixmapCRCs.end()) {
+		return iterFind->second;
+	}
+
+	int32 dimensions[3]= { pixmap->getW(), pixmap->getH(), pixmap->getComponents() };
+	uint32 crc= Checksum::updateCrc(0, dimensions, sizeof(dimensions));
+	crc= Checksum::updateCrc(crc, pixmap->getPixels(), pixmap->getPixelByteCount());
+	pixmapCRCs[pixmap]= crc;
+	return crc;
+}
+
+// The cache file is a header followed by entries of a key and the pixels
+// of one splat, all in the byte order of the machine that wrote it
+
+static FILE *openSplatCacheFile(const string &path, bool write) {
+#ifdef WIN32
+	return _wfopen(utf8_decode(path).c_str(), (write == true ? L"wb" : L"rb"));
+#else
+	return fopen(path.c_str(), (write == true ? "wb" : "rb"));
+#endif
+}
+
+static bool readSplatCacheHeader(FILE *fp, const char *header, int version, int pixelByteCount, int32 &entryCount) {
+	char fileHeader[16]= "";
+	int32 values[3]= { 0, 0, 0 };
+	if(fread(fileHeader, sizeof(fileHeader), 1, fp) != 1 ||
+		fread(values, sizeof(values), 1, fp) != 1 ||
+		fread(&entryCount, sizeof(entryCount), 1, fp) != 1) {
+		return false;
+	}
+	fileHeader[sizeof(fileHeader) - 1]= '\0';
+	return strcmp(fileHeader, header) == 0 &&
+			values[0] == version &&
+			values[1] == (int32)sizeof(uint32) &&
+			values[2] == pixelByteCount &&
+			entryCount >= 0;
+}
+
+static bool writeSplatCacheHeader(FILE *fp, const char *header, int version, int pixelByteCount, int32 entryCount) {
+	char fileHeader[16];
+	memset(fileHeader, 0, sizeof(fileHeader));
+	strncpy(fileHeader, header, sizeof(fileHeader) - 1);
+	int32 values[3]= { version, (int32)sizeof(uint32), pixelByteCount };
+	return fwrite(fileHeader, sizeof(fileHeader), 1, fp) == 1 &&
+			fwrite(values, sizeof(values), 1, fp) == 1 &&
+			fwrite(&entryCount, sizeof(entryCount), 1, fp) == 1;
+}
+
+int SurfaceAtlas::loadSplatCache(const string &cacheFile, int pixelByteCount) {
+	FILE *fp= openSplatCacheFile(cacheFile, false);
+	if(fp == NULL) {
+		return 0;
+	}
+
+	int cacheHits= 0;
+	int32 entryCount= 0;
+	if(readSplatCacheHeader(fp, splatCacheHeader, splatCacheVersion, pixelByteCount, entryCount) == true) {
+		for(int entry = 0; entry < entryCount && cacheHits < (int)pendingSplats.size(); ++entry) {
+			SplatKey key;
+			if(fread(key.crc, sizeof(key.crc), 1, fp) != 1) {
+				break;
+			}
+
+			uint8 *loadedPixels= NULL;
+			bool readError= false;
+			for(unsigned int i = 0; i < pendingSplats.size(); ++i) {
+				PendingSplat &splat= pendingSplats[i];
+				if(splat.ready == true || key < splat.key || splat.key < key) {
+					continue;
+				}
+
+				uint8 *pixels= splat.texture->getPixmap()->getPixels();
+				if(loadedPixels == NULL) {
+					if(fread(pixels, pixelByteCount, 1, fp) != 1) {
+						readError= true;
+						break;
+					}
+					loadedPixels= pixels;
+				}
+				else {
+					memcpy(pixels, loadedPixels, pixelByteCount);
+				}
+				splat.ready= true;
+				cacheHits++;
+			}
+
+			if(readError == true ||
+				(loadedPixels == NULL && fseek(fp, pixelByteCount, SEEK_CUR) != 0)) {
+				break;
+			}
+		}
+	}
+	fclose(fp);
+
+	return cacheHits;
+}
+
+bool SurfaceAtlas::saveSplatCache(const string &cacheFile, int pixelByteCount) {
+	// Written aside and renamed so a crash never leaves half a cache
+	string tempFile= cacheFile + ".tmp";
+	FILE *fp= openSplatCacheFile(tempFile, true);
+	if(fp == NULL) {
+		return false;
+	}
+
+	bool result= writeSplatCacheHeader(fp, splatCacheHeader, splatCacheVersion, pixelByteCount, 0);
+
+	// This game's splats first, then what the cache had for other maps
+	set<SplatKey> savedKeys;
+	for(unsigned int i = 0; result == true && i < pendingSplats.size() &&
+		(int)savedKeys.size() < maxSplatCacheEntries; ++i) {
+		const PendingSplat &splat= pendingSplats[i];
+		if(splat.ready == false || savedKeys.insert(splat.key).second == false) {
+			continue;
+		}
+		result= fwrite(splat.key.crc, sizeof(splat.key.crc), 1, fp) == 1 &&
+				fwrite(splat.texture->getPixmapConst()->getPixels(), pixelByteCount, 1, fp) == 1;
+	}
+
+	FILE *fpOld= (result == true ? openSplatCacheFile(cacheFile, false) : NULL);
+	if(fpOld != NULL) {
+		int32 entryCount= 0;
+		if(readSplatCacheHeader(fpOld, splatCacheHeader, splatCacheVersion, pixelByteCount, entryCount) == true) {
+			vector<uint8> pixels(pixelByteCount);
+			for(int entry = 0; result == true && entry < entryCount &&
+				(int)savedKeys.size() < maxSplatCacheEntries; ++entry) {
+				SplatKey key;
+				if(fread(key.crc, sizeof(key.crc), 1, fpOld) != 1 ||
+					fread(&pixels[0], pixelByteCount, 1, fpOld) != 1) {
+					break;
+				}
+				if(savedKeys.insert(key).second == true) {
+					result= fwrite(key.crc, sizeof(key.crc), 1, fp) == 1 &&
+							fwrite(&pixels[0], pixelByteCount, 1, fp) == 1;
+				}
+			}
+		}
+		fclose(fpOld);
+	}
+
+	if(result == true) {
+		result= fseek(fp, 0, SEEK_SET) == 0 &&
+				writeSplatCacheHeader(fp, splatCacheHeader, splatCacheVersion, pixelByteCount, (int32)savedKeys.size());
+	}
+	result= (ferror(fp) == 0 && result == true);
+	fclose(fp);
+
+	if(result == true) {
+		if(fileExists(cacheFile) == true) {
+			removeFile(cacheFile);
+		}
+		result= renameFile(tempFile, cacheFile);
+	}
+	else {
+		removeFile(tempFile);
+	}
+
+	if(SystemFlags::getSystemSettingType(SystemFlags::debugSystem).enabled) SystemFlags::OutputDebug(SystemFlags::debugSystem,"In [%s::%s Line: %d] saved %d splats to [%s] result = %d\n",extractFileFromDirectoryPath(__FILE__).c_str(),__FUNCTION__,__LINE__,(int)savedKeys.size(),cacheFile.c_str(),result);
+	return result;
+}
+
 }}//end namespace
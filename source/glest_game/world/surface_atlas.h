@@ -19,16 +19,24 @@
 
 #include <vector>
 #include <set>
+#include <map>
 #include "texture.h"
 #include "vec.h"
+#include "task_pool.h"
 #include "leak_dumper.h"
 
 using std::vector;
 using std::set;
+using std::map;
+using std::string;
 using Shared::Graphics::Pixmap2D;
+using Shared::Graphics::PixmapSplatWeights;
 using Shared::Graphics::Texture2D;
 using Shared::Graphics::Vec2i;
 using Shared::Graphics::Vec2f;
+using Shared::Platform::uint32;
+using Shared::PlatformCommon::TaskPoolCallbackInterface;
+using Shared::PlatformCommon::WorkStealingTaskPool;
 
 namespace Glest{ namespace Game{
 
@@ -67,24 +75,63 @@ public:
 // 	class SurfaceAtlas
 //
 /// Holds all surface textures for a given Tileset
+///
+/// Splatted textures are only recorded by addSurface, their pixels
+/// come from splatSurfaces, which reads what it can from the splat
+/// cache file and blends the rest on the task pool
 // =====================================================
 
-class SurfaceAtlas{
+class SurfaceAtlas : public TaskPoolCallbackInterface {
 private:
 	typedef vector<SurfaceInfo> SurfaceInfos;
 
+	// The crcs of the four corner pixmaps' contents
+	class SplatKey {
+	public:
+		uint32 crc[4];
+
+		SplatKey();
+		bool operator<(const SplatKey &key) const;
+	};
+
+	class PendingSplat {
+	public:
+		int surfaceIndex;
+		Texture2D *texture;
+		SplatKey key;
+		bool ready;
+
+		PendingSplat(int surfaceIndex, Texture2D *texture);
+	};
+
+	static const char *splatCacheHeader;
+	static const int splatCacheVersion;
+	static const int maxSplatCacheEntries;
+
 private:
 	SurfaceInfos surfaceInfos;
 	int surfaceSize;
 
+	vector<PendingSplat> pendingSplats;
+	vector<int> splatsToBlend;
+	const PixmapSplatWeights *splatWeights;
+
 public:
 	SurfaceAtlas();
+	virtual ~SurfaceAtlas() {}
 
 	void addSurface(SurfaceInfo *si);
+	void splatSurfaces(WorkStealingTaskPool *taskPool, const string &cacheFile);
 	float getCoordStep() const;
 
+	virtual void runPoolTask(int taskIndex, int workerIndex);
+
 private:
 	void checkDimensions(const Pixmap2D *p);
+
+	uint32 getPixmapContentCRC(const Pixmap2D *pixmap, map<const Pixmap2D *,uint32> &pixmapCRCs) const;
+	int loadSplatCache(const string &cacheFile, int pixelByteCount);
+	bool saveSplatCache(const string &cacheFile, int pixelByteCount);
 };
 
 }}//end namespace
@@ -566,4 +566,15 @@ void Tileset::addSurfTex(int leftUp, int rightUp, int leftDown, int rightDown, V
 	}
 }
 
+void Tileset::splatSurfaces(WorkStealingTaskPool *taskPool, bool useCache) {
+	string cacheFile = "";
+	if(useCache == true) {
+		string crcCachePath = getCRCCacheFilePath();
+		if(crcCachePath != "") {
+			cacheFile = crcCachePath + "SPLAT_CACHE_" + tileset_name + "_" + uIntToStr(checksumValue.getSum());
+		}
+	}
+	surfaceAtlas.splatSurfaces(taskPool, cacheFile);
+}
+
 }}// end namespace
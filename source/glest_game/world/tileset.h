@@ -197,6 +197,7 @@ public:
 	//surface textures
 	const Pixmap2D *getSurfPixmap(int type, int var) const;
 	void addSurfTex(int leftUp, int rightUp, int leftDown, int rightDown, Vec2f &coord, const Texture2D *&texture, int mapX, int mapY);
+	void splatSurfaces(WorkStealingTaskPool *taskPool, bool useCache);
 
 	//sounds
 	AmbientSounds *getAmbientSounds() {return &ambientSounds;}
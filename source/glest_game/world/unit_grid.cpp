@@ -0,0 +1,154 @@
+// ==============================================================
+//	This file is part of MegaGlest (www.megaglest.org)
+//
+//	Copyright (C) 2026 The MegaGlest Team
+//
+//	You can redistribute this code and/or modify it under
+//	the terms of the GNU General Public License as published
+//	by the Free Software Foundation; either version 2 of the
+//	License, or (at your option) any later version
+// ==============================================================
+
+#include "unit_grid.h"
+
+#include <algorithm>
+#include "game_constants.h"
+#include "util.h"
+#include "conversion.h"
+#include "leak_dumper.h"
+
+using namespace Shared::Util;
+
+namespace Glest{ namespace Game{
+
+// =====================================================
+// 	class UnitGrid
+// =====================================================
+
+const int UnitGrid::bucketSize = 8;
+
+UnitGrid::UnitGrid() {
+	bucketsW	= 0;
+	bucketsH	= 0;
+	maxUnitSize	= 1;
+}
+
+void UnitGrid::init(int mapW, int mapH) {
+	clear();
+
+	bucketsW	= (mapW + bucketSize - 1) / bucketSize;
+	bucketsH	= (mapH + bucketSize - 1) / bucketSize;
+	factionBuckets.resize(GameConstants::maxPlayers + GameConstants::specialFactions);
+}
+
+void UnitGrid::clear() {
+	bucketsW	= 0;
+	bucketsH	= 0;
+	maxUnitSize	= 1;
+	factionBuckets.clear();
+	entries.clear();
+}
+
+int UnitGrid::getBucketIndex(const Vec2i &pos) const {
+	int bucketX = max(0, min(bucketsW - 1, pos.x / bucketSize));
+	int bucketY = max(0, min(bucketsH - 1, pos.y / bucketSize));
+	return bucketY * bucketsW + bucketX;
+}
+
+void UnitGrid::removeFromBucket(const UnitGridEntry &entry) {
+	vector<int> &bucket = factionBuckets[entry.factionIndex][entry.bucketIndex];
+	vector<int>::iterator iterFind = std::find(bucket.begin(), bucket.end(), entry.unitId);
+	if(iterFind != bucket.end()) {
+		*iterFind = bucket.back();
+		bucket.pop_back();
+	}
+}
+
+void UnitGrid::putUnit(Unit *unit, int unitId, int factionIndex, const Vec2i &pos, int size) {
+	if(bucketsW <= 0 || factionIndex < 0 || factionIndex >= (int)factionBuckets.size()) {
+		return;
+	}
+
+	UnitGridEntry &entry = entries[unitId];
+	if(entry.unit != NULL) {
+		// putting a morphing unit again at the same place only widens its footprint
+		if(entry.pos == pos && entry.factionIndex == factionIndex) {
+			entry.unit = unit;
+			entry.size = max(entry.size, size);
+			maxUnitSize = max(maxUnitSize, entry.size);
+			return;
+		}
+		removeFromBucket(entry);
+	}
+
+	vector<vector<int> > &buckets = factionBuckets[factionIndex];
+	if(buckets.empty() == true) {
+		buckets.resize(bucketsW * bucketsH);
+	}
+
+	entry.unit			= unit;
+	entry.unitId		= unitId;
+	entry.factionIndex	= factionIndex;
+	entry.pos			= pos;
+	entry.size			= size;
+	entry.bucketIndex	= getBucketIndex(pos);
+	buckets[entry.bucketIndex].push_back(unitId);
+	maxUnitSize = max(maxUnitSize, size);
+}
+
+void UnitGrid::removeUnit(int unitId) {
+	EntryMap::iterator iterFind = entries.find(unitId);
+	if(iterFind != entries.end()) {
+		removeFromBucket(iterFind->second);
+		entries.erase(iterFind);
+	}
+}
+
+const UnitGridEntry * UnitGrid::getEntry(int unitId) const {
+	EntryMap::const_iterator iterFind = entries.find(unitId);
+	return (iterFind != entries.end() ? &iterFind->second : NULL);
+}
+
+void UnitGrid::findEntries(int factionIndex, const Vec2i &minPos, const Vec2i &maxPos,
+						   vector<const UnitGridEntry *> &result) const {
+	if(bucketsW <= 0 || factionIndex < 0 || factionIndex >= (int)factionBuckets.size() ||
+		factionBuckets[factionIndex].empty() == true) {
+		return;
+	}
+
+	// a footprint starting up to maxUnitSize - 1 cells before the area still reaches into it
+	const Vec2i firstBucket(max(0, (minPos.x - maxUnitSize + 1) / bucketSize),
+							max(0, (minPos.y - maxUnitSize + 1) / bucketSize));
+	const Vec2i lastBucket(min(bucketsW - 1, maxPos.x / bucketSize),
+						   min(bucketsH - 1, maxPos.y / bucketSize));
+
+	const vector<vector<int> > &buckets = factionBuckets[factionIndex];
+	for(int bucketY = firstBucket.y; bucketY <= lastBucket.y; ++bucketY) {
+		for(int bucketX = firstBucket.x; bucketX <= lastBucket.x; ++bucketX) {
+			const vector<int> &bucket = buckets[bucketY * bucketsW + bucketX];
+			for(unsigned int index = 0; index < bucket.size(); ++index) {
+				const UnitGridEntry &entry = entries.find(bucket[index])->second;
+				if(entry.pos.x <= maxPos.x && entry.pos.y <= maxPos.y &&
+					entry.pos.x + entry.size > minPos.x && entry.pos.y + entry.size > minPos.y) {
+					result.push_back(&entry);
+				}
+			}
+		}
+	}
+}
+
+string UnitGrid::getStats() const {
+	int factionCount = 0;
+	for(unsigned int factionIndex = 0; factionIndex < factionBuckets.size(); ++factionIndex) {
+		if(factionBuckets[factionIndex].empty() == false) {
+			factionCount++;
+		}
+	}
+
+	char szBuf[8096]="";
+	snprintf(szBuf,8096,"buckets [%d x %d] factions [%d] units [%d] max size [%d]",
+			bucketsW,bucketsH,factionCount,(int)entries.size(),maxUnitSize);
+	return szBuf;
+}
+
+}}//end namespace
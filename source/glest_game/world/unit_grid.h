@@ -0,0 +1,128 @@
+// ==============================================================
+//	This file is part of MegaGlest (www.megaglest.org)
+//
+//	Copyright (C) 2026 The MegaGlest Team
+//
+//	You can redistribute this code and/or modify it under
+//	the terms of the GNU General Public License as published
+//	by the Free Software Foundation; either version 2 of the
+//	License, or (at your option) any later version
+// ==============================================================
+
+#ifndef _GLEST_GAME_UNITGRID_H_
+#define _GLEST_GAME_UNITGRID_H_
+
+#ifdef WIN32
+    #include <winsock2.h>
+    #include <winsock.h>
+#endif
+
+#include <vector>
+#include <map>
+#include <string>
+#include "vec.h"
+#include "skill_type.h"
+#include "leak_dumper.h"
+
+using std::vector;
+using std::string;
+using Shared::Graphics::Vec2i;
+
+namespace Glest{ namespace Game{
+
+class Unit;
+
+// =====================================================
+// 	class UnitCellRef
+//
+///	One field of one cell occupied by a unit
+// =====================================================
+
+class UnitCellRef {
+public:
+	UnitCellRef(const Vec2i &pos, Field field, Unit *unit) : pos(pos), field(field), unit(unit) {}
+
+	Vec2i pos;
+	Field field;
+	Unit *unit;
+
+	// the order a column by column scan of the map visits cells and fields
+	inline bool operator<(const UnitCellRef &other) const {
+		if(pos.x != other.pos.x) {
+			return pos.x < other.pos.x;
+		}
+		if(pos.y != other.pos.y) {
+			return pos.y < other.pos.y;
+		}
+		return field < other.field;
+	}
+};
+
+// =====================================================
+// 	class UnitGridEntry
+// =====================================================
+
+class UnitGridEntry {
+public:
+	UnitGridEntry() : unit(NULL), unitId(-1), factionIndex(-1), size(0), bucketIndex(-1) {}
+
+	Unit *unit;
+	int unitId;
+	int factionIndex;
+	Vec2i pos;		// first cell of the size x size footprint
+	int size;
+	int bucketIndex;
+};
+
+// =====================================================
+// 	class UnitGrid
+//
+///	Coarse per faction index of where units were put in the map.
+///	Every unit is filed under the bucket of the cell its footprint
+///	starts at, so an area query only looks at the units of the buckets
+///	it overlaps instead of probing every cell. The grid only narrows
+///	down the candidates, Map checks them against the cells, so an
+///	entry that outlived its unit in the cells is harmless. Like the
+///	cells it is only changed from the main thread.
+// =====================================================
+
+class UnitGrid {
+public:
+	static const int bucketSize;
+
+private:
+	typedef std::map<int,UnitGridEntry> EntryMap;
+
+	int bucketsW;
+	int bucketsH;
+	int maxUnitSize;
+	// [factionIndex][bucketIndex] unit ids
+	vector<vector<vector<int> > > factionBuckets;
+	EntryMap entries;
+
+public:
+	UnitGrid();
+
+	void init(int mapW, int mapH);
+	void clear();
+
+	void putUnit(Unit *unit, int unitId, int factionIndex, const Vec2i &pos, int size);
+	void removeUnit(int unitId);
+	const UnitGridEntry *getEntry(int unitId) const;
+
+	// Entries of the faction whose footprint may overlap the cells
+	// [minPos, maxPos], in no particular order
+	void findEntries(int factionIndex, const Vec2i &minPos, const Vec2i &maxPos,
+					 vector<const UnitGridEntry *> &result) const;
+
+	int getEntryCount() const	{return (int)entries.size();}
+	string getStats() const;
+
+private:
+	int getBucketIndex(const Vec2i &pos) const;
+	void removeFromBucket(const UnitGridEntry &entry);
+};
+
+}}//end namespace
+
+#endif
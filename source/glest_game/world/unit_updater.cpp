@@ -40,12 +40,9 @@ namespace Glest{ namespace Game{
 // 	class UnitUpdater
 // =====================================================
 
-time_t UnitRangeCellsLookupItem::lastDebug = 0;
-
 // ===================== PUBLIC ========================
 
-UnitUpdater::UnitUpdater() : mutexAttackWarnings(new Mutex(CODE_AT_LINE)),
-		mutexUnitRangeCellsLookupItemCache(new Mutex(CODE_AT_LINE)) {
+UnitUpdater::UnitUpdater() : mutexAttackWarnings(new Mutex(CODE_AT_LINE)) {
     this->game= NULL;
 	this->gui= NULL;
 	this->gameCamera= NULL;
@@ -54,7 +51,6 @@ UnitUpdater::UnitUpdater() : mutexAttackWarnings(new Mutex(CODE_AT_LINE)),
 	this->console= NULL;
 	this->scriptManager= NULL;
 	this->pathFinder = NULL;
-	//UnitRangeCellsLookupItemCacheTimerCount = 0;
 	attackWarnRange=0;
 }
 
@@ -69,12 +65,14 @@ void UnitUpdater::init(Game *game){
 	this->scriptManager= game->getScriptManager();
 	this->pathFinder = NULL;
 	attackWarnRange=Config::getInstance().getFloat("AttackWarnRange","50.0");
-	//UnitRangeCellsLookupItemCacheTimerCount = 0;
 
 	switch(this->game->getGameSettings()->getPathFinderType()) {
 		case pfBasic:
 			pathFinder = new PathFinder();
 			pathFinder->init(map);
+			if(world->getTaskPool() != NULL) {
+				pathFinder->initWorkerSearchStates(world->getTaskPool()->getWorkerCount());
+			}
 			break;
 		default:
 			throw megaglest_runtime_error("detected unsupported pathfinder type!");
@@ -93,9 +91,13 @@ void UnitUpdater::removeUnitPrecache(Unit *unit) {
 	}
 }
 
-UnitUpdater::~UnitUpdater() {
-	//UnitRangeCellsLookupItemCache.clear();
+void UnitUpdater::mergePathFinderPrecache() {
+	if(pathFinder != NULL) {
+		pathFinder->mergeWorkerPrecache();
+	}
+}
 
+UnitUpdater::~UnitUpdater() {
 	delete pathFinder;
 	pathFinder = NULL;
 
@@ -110,9 +112,6 @@ UnitUpdater::~UnitUpdater() {
 
 	delete mutexAttackWarnings;
 	mutexAttackWarnings = NULL;
-
-	delete mutexUnitRangeCellsLookupItemCache;
-	mutexUnitRangeCellsLookupItemCache = NULL;
 }
 
 // ==================== progress skills ====================
@@ -122,9 +121,9 @@ bool UnitUpdater::updateUnit(Unit *unit) {
 	bool processUnitCommand = false;
 
 	Chrono chrono;
-	if(SystemFlags::getSystemSettingType(SystemFlags::debugPerformance).enabled) chrono.start();
+	if(SystemFlags::isDebugEnabled(SystemFlags::debugPerformance)) chrono.start();
 
-	if(SystemFlags::getSystemSettingType(SystemFlags::debugPerformance).enabled && chrono.getMillis() > 0) SystemFlags::OutputDebug(SystemFlags::debugPerformance,"In [%s::%s] Line: %d took msecs: %lld --------------------------- [START OF METHOD] ---------------------------\n",__FILE__,__FUNCTION__,__LINE__,chrono.getMillis());
+	if(SystemFlags::isDebugEnabled(SystemFlags::debugPerformance) && chrono.getMillis() > 0) SystemFlags::OutputDebug(SystemFlags::debugPerformance,"In [%s::%s] Line: %d took msecs: %lld --------------------------- [START OF METHOD] ---------------------------\n",__FILE__,__FUNCTION__,__LINE__,chrono.getMillis());
 
 	SoundRenderer &soundRenderer= SoundRenderer::getInstance();
 
@@ -178,11 +177,11 @@ bool UnitUpdater::updateUnit(Unit *unit) {
 		}
 	}
 
-	if(SystemFlags::getSystemSettingType(SystemFlags::debugPerformance).enabled && chrono.getMillis() > 0) SystemFlags::OutputDebug(SystemFlags::debugPerformance,"In [%s::%s] Line: %d took msecs: %lld [after playsound]\n",__FILE__,__FUNCTION__,__LINE__,chrono.getMillis());
+	if(SystemFlags::isDebugEnabled(SystemFlags::debugPerformance) && chrono.getMillis() > 0) SystemFlags::OutputDebug(SystemFlags::debugPerformance,"In [%s::%s] Line: %d took msecs: %lld [after playsound]\n",__FILE__,__FUNCTION__,__LINE__,chrono.getMillis());
 
 	unit->updateTimedParticles();
 
-	if(SystemFlags::getSystemSettingType(SystemFlags::debugPerformance).enabled && chrono.getMillis() > 0) SystemFlags::OutputDebug(SystemFlags::debugPerformance,"In [%s::%s] Line: %d took msecs: %lld [after playsound]\n",__FILE__,__FUNCTION__,__LINE__,chrono.getMillis());
+	if(SystemFlags::isDebugEnabled(SystemFlags::debugPerformance) && chrono.getMillis() > 0) SystemFlags::OutputDebug(SystemFlags::debugPerformance,"In [%s::%s] Line: %d took msecs: %lld [after playsound]\n",__FILE__,__FUNCTION__,__LINE__,chrono.getMillis());
 
 
 	//start attack particle system
@@ -233,11 +232,11 @@ bool UnitUpdater::updateUnit(Unit *unit) {
 		}
 	}
 
-	if(SystemFlags::getSystemSettingType(SystemFlags::debugPerformance).enabled && chrono.getMillis() > 0) SystemFlags::OutputDebug(SystemFlags::debugPerformance,"In [%s::%s] Line: %d took msecs: %lld [after attack particle system]\n",__FILE__,__FUNCTION__,__LINE__,chrono.getMillis());
+	if(SystemFlags::isDebugEnabled(SystemFlags::debugPerformance) && chrono.getMillis() > 0) SystemFlags::OutputDebug(SystemFlags::debugPerformance,"In [%s::%s] Line: %d took msecs: %lld [after attack particle system]\n",__FILE__,__FUNCTION__,__LINE__,chrono.getMillis());
 
 	bool update = unit->update();
 
-	if(SystemFlags::getSystemSettingType(SystemFlags::debugPerformance).enabled && chrono.getMillis() > 0) SystemFlags::OutputDebug(SystemFlags::debugPerformance,"In [%s::%s] Line: %d took msecs: %lld [after unit->update()]\n",__FILE__,__FUNCTION__,__LINE__,chrono.getMillis());
+	if(SystemFlags::isDebugEnabled(SystemFlags::debugPerformance) && chrono.getMillis() > 0) SystemFlags::OutputDebug(SystemFlags::debugPerformance,"In [%s::%s] Line: %d took msecs: %lld [after unit->update()]\n",__FILE__,__FUNCTION__,__LINE__,chrono.getMillis());
 
 	//printf("Update Unit [%d - %s] = %d\n",unit->getId(),unit->getType()->getName().c_str(),update);
 
@@ -248,7 +247,7 @@ bool UnitUpdater::updateUnit(Unit *unit) {
 		processUnitCommand = true;
 		updateUnitCommand(unit,-1);
 
-		if(SystemFlags::getSystemSettingType(SystemFlags::debugPerformance).enabled && chrono.getMillis() > 0) SystemFlags::OutputDebug(SystemFlags::debugPerformance,"In [%s::%s] Line: %d took msecs: %lld [after updateUnitCommand()]\n",__FILE__,__FUNCTION__,__LINE__,chrono.getMillis());
+		if(SystemFlags::isDebugEnabled(SystemFlags::debugPerformance) && chrono.getMillis() > 0) SystemFlags::OutputDebug(SystemFlags::debugPerformance,"In [%s::%s] Line: %d took msecs: %lld [after updateUnitCommand()]\n",__FILE__,__FUNCTION__,__LINE__,chrono.getMillis());
 
 		//if unit is out of EP, it stops
 		if(unit->computeEp() == true) {
@@ -271,7 +270,7 @@ bool UnitUpdater::updateUnit(Unit *unit) {
 					if(ct != NULL && ct->getClass() == ccAttackStopped) {
 						const AttackStoppedCommandType *act= static_cast<const AttackStoppedCommandType*>(ct);
 						if(act != NULL && act->getName(false) == holdPositionName) {
-							if(SystemFlags::getSystemSettingType(SystemFlags::debugUnitCommands).enabled) SystemFlags::OutputDebug(SystemFlags::debugUnitCommands,"In [%s::%s Line: %d]\n",__FILE__,__FUNCTION__,__LINE__);
+							if(SystemFlags::isDebugEnabled(SystemFlags::debugUnitCommands)) SystemFlags::OutputDebug(SystemFlags::debugUnitCommands,"In [%s::%s Line: %d]\n",__FILE__,__FUNCTION__,__LINE__);
 
 							//printf("Re-Queing hold pos = %d, ep = %d skillep = %d skillname [%s]\n ",unit->getFaction()->reqsOk(act),unit->getEp(),act->getAttackSkillType()->getEpCost(),act->getName().c_str());
 							if(unit->getFaction()->reqsOk(act) == true &&
@@ -279,7 +278,7 @@ bool UnitUpdater::updateUnit(Unit *unit) {
 								unit->giveCommand(new Command(act),true);
 							}
 
-							if(SystemFlags::getSystemSettingType(SystemFlags::debugUnitCommands).enabled) SystemFlags::OutputDebug(SystemFlags::debugUnitCommands,"In [%s::%s Line: %d]\n",__FILE__,__FUNCTION__,__LINE__);
+							if(SystemFlags::isDebugEnabled(SystemFlags::debugUnitCommands)) SystemFlags::OutputDebug(SystemFlags::debugUnitCommands,"In [%s::%s Line: %d]\n",__FILE__,__FUNCTION__,__LINE__);
 							break;
 						}
 					}
@@ -301,7 +300,7 @@ bool UnitUpdater::updateUnit(Unit *unit) {
 		if(unit->getCurrSkill()->getClass() == scMove) {
 			world->moveUnitCells(unit, true);
 
-			if(SystemFlags::getSystemSettingType(SystemFlags::debugPerformance).enabled && chrono.getMillis() > 0) SystemFlags::OutputDebug(SystemFlags::debugPerformance,"In [%s::%s] Line: %d took msecs: %lld [after world->moveUnitCells()]\n",__FILE__,__FUNCTION__,__LINE__,chrono.getMillis());
+			if(SystemFlags::isDebugEnabled(SystemFlags::debugPerformance) && chrono.getMillis() > 0) SystemFlags::OutputDebug(SystemFlags::debugPerformance,"In [%s::%s] Line: %d took msecs: %lld [after world->moveUnitCells()]\n",__FILE__,__FUNCTION__,__LINE__,chrono.getMillis());
 
 			//play water sound
 			if(map->getCell(unit->getPos())->getHeight() < map->getWaterLevel() && unit->getCurrField() == fLand) {
@@ -312,20 +311,20 @@ bool UnitUpdater::updateUnit(Unit *unit) {
 						gameCamera->getPos()
 					);
 
-					if(SystemFlags::getSystemSettingType(SystemFlags::debugPerformance).enabled && chrono.getMillis() > 0) SystemFlags::OutputDebug(SystemFlags::debugPerformance,"In [%s::%s] Line: %d took msecs: %lld [after soundFx()]\n",__FILE__,__FUNCTION__,__LINE__,chrono.getMillis());
+					if(SystemFlags::isDebugEnabled(SystemFlags::debugPerformance) && chrono.getMillis() > 0) SystemFlags::OutputDebug(SystemFlags::debugPerformance,"In [%s::%s] Line: %d took msecs: %lld [after soundFx()]\n",__FILE__,__FUNCTION__,__LINE__,chrono.getMillis());
 				}
 			}
 		}
 	}
 
-	if(SystemFlags::getSystemSettingType(SystemFlags::debugPerformance).enabled && chrono.getMillis() > 0) SystemFlags::OutputDebug(SystemFlags::debugPerformance,"In [%s::%s] Line: %d took msecs: %lld\n",__FILE__,__FUNCTION__,__LINE__,chrono.getMillis());
+	if(SystemFlags::isDebugEnabled(SystemFlags::debugPerformance) && chrono.getMillis() > 0) SystemFlags::OutputDebug(SystemFlags::debugPerformance,"In [%s::%s] Line: %d took msecs: %lld\n",__FILE__,__FUNCTION__,__LINE__,chrono.getMillis());
 
 	//unit death
 	if(unit->isDead() && unit->getCurrSkill()->getClass() != scDie) {
 		unit->kill();
 	}
 
-	if(SystemFlags::getSystemSettingType(SystemFlags::debugPerformance).enabled && chrono.getMillis() > 0) SystemFlags::OutputDebug(SystemFlags::debugPerformance,"In [%s::%s] Line: %d took msecs: %lld --------------------------- [END OF METHOD] ---------------------------\n",__FILE__,__FUNCTION__,__LINE__,chrono.getMillis());
+	if(SystemFlags::isDebugEnabled(SystemFlags::debugPerformance) && chrono.getMillis() > 0) SystemFlags::OutputDebug(SystemFlags::debugPerformance,"In [%s::%s] Line: %d took msecs: %lld --------------------------- [END OF METHOD] ---------------------------\n",__FILE__,__FUNCTION__,__LINE__,chrono.getMillis());
 
 	return processUnitCommand;
 }
@@ -378,7 +377,7 @@ void UnitUpdater::spawnAttack(Unit *unit,string spawnUnit,int spawnUnitcount,int
 					ct= spawned->computeCommandType(targetPos,map->getCell(targetPos)->getUnit(unit->getTargetField()));
 				}
 				if(ct != NULL){
-					if(SystemFlags::getSystemSettingType(SystemFlags::debugUnitCommands).enabled) SystemFlags::OutputDebug(SystemFlags::debugUnitCommands,"In [%s::%s Line: %d]\n",__FILE__,__FUNCTION__,__LINE__);
+					if(SystemFlags::isDebugEnabled(SystemFlags::debugUnitCommands)) SystemFlags::OutputDebug(SystemFlags::debugUnitCommands,"In [%s::%s Line: %d]\n",__FILE__,__FUNCTION__,__LINE__);
 					spawned->giveCommand(new Command(ct, targetPos));
 				}
 			}
@@ -436,7 +435,7 @@ void UnitUpdater::updateUnitCommand(Unit *unit, int frameIndex) {
 	try {
 	bool minorDebugPerformance = false;
 	Chrono chrono;
-	if((minorDebugPerformance == true && frameIndex > 0) || SystemFlags::getSystemSettingType(SystemFlags::debugPerformance).enabled) chrono.start();
+	if((minorDebugPerformance == true && frameIndex > 0) || SystemFlags::isDebugEnabled(SystemFlags::debugPerformance)) chrono.start();
 
 	//if unit has command process it
     bool hasCommand = (unit->anyCommand());
@@ -447,7 +446,7 @@ void UnitUpdater::updateUnitCommand(Unit *unit, int frameIndex) {
 	if(minorDebugPerformance && frameIndex > 0) elapsed1 = chrono.getMillis();
 
     if(hasCommand == true) {
-    	if(SystemFlags::getSystemSettingType(SystemFlags::debugUnitCommands).enabled) SystemFlags::OutputDebug(SystemFlags::debugUnitCommands,"In [%s::%s Line: %d] unit [%s] has command [%s]\n",__FILE__,__FUNCTION__,__LINE__,unit->toString(false).c_str(), unit->getCurrCommand()->toString(false).c_str());
+    	if(SystemFlags::isDebugEnabled(SystemFlags::debugUnitCommands)) SystemFlags::OutputDebug(SystemFlags::debugUnitCommands,"In [%s::%s Line: %d] unit [%s] has command [%s]\n",__FILE__,__FUNCTION__,__LINE__,unit->toString(false).c_str(), unit->getCurrCommand()->toString(false).c_str());
 
     	bool commandUsesPathFinder = (frameIndex < 0);
     	if(frameIndex > 0) {
@@ -472,12 +471,12 @@ void UnitUpdater::updateUnitCommand(Unit *unit, int frameIndex) {
     	}
 	}
 
-    if(SystemFlags::getSystemSettingType(SystemFlags::debugPerformance).enabled && chrono.getMillis() > 0) SystemFlags::OutputDebug(SystemFlags::debugPerformance,"In [%s::%s Line: %d] took msecs: %lld\n",__FILE__,__FUNCTION__,__LINE__,chrono.getMillis());
+    if(SystemFlags::isDebugEnabled(SystemFlags::debugPerformance) && chrono.getMillis() > 0) SystemFlags::OutputDebug(SystemFlags::debugPerformance,"In [%s::%s Line: %d] took msecs: %lld\n",__FILE__,__FUNCTION__,__LINE__,chrono.getMillis());
 
     if(frameIndex < 0) {
 		//if no commands stop and add stop command
 		if(unit->anyCommand() == false && unit->isOperative()) {
-			if(SystemFlags::getSystemSettingType(SystemFlags::debugUnitCommands).enabled) SystemFlags::OutputDebug(SystemFlags::debugUnitCommands,"In [%s::%s Line: %d]\n",__FILE__,__FUNCTION__,__LINE__);
+			if(SystemFlags::isDebugEnabled(SystemFlags::debugUnitCommands)) SystemFlags::OutputDebug(SystemFlags::debugUnitCommands,"In [%s::%s Line: %d]\n",__FILE__,__FUNCTION__,__LINE__);
 			if(unit->getType()->hasSkillClass(scStop)) {
 				unit->setCurrSkill(scStop);
 			}
@@ -486,7 +485,7 @@ void UnitUpdater::updateUnitCommand(Unit *unit, int frameIndex) {
 			}
 		}
     }
-    if(SystemFlags::getSystemSettingType(SystemFlags::debugPerformance).enabled && chrono.getMillis() > 0) SystemFlags::OutputDebug(SystemFlags::debugPerformance,"In [%s::%s] Line: %d took msecs: %lld --------------------------- [END OF METHOD] ---------------------------\n",__FILE__,__FUNCTION__,__LINE__,chrono.getMillis());
+    if(SystemFlags::isDebugEnabled(SystemFlags::debugPerformance) && chrono.getMillis() > 0) SystemFlags::OutputDebug(SystemFlags::debugPerformance,"In [%s::%s] Line: %d took msecs: %lld --------------------------- [END OF METHOD] ---------------------------\n",__FILE__,__FUNCTION__,__LINE__,chrono.getMillis());
     if((minorDebugPerformance && frameIndex > 0) && chrono.getMillis() >= 1) printf("UnitUpdate [%d - %s] #3-unit threaded updates on frame: %d took [%lld] msecs\n",unit->getId(),unit->getType()->getName(false).c_str(),frameIndex,(long long int)chrono.getMillis());
 
 	}
@@ -494,7 +493,7 @@ void UnitUpdater::updateUnitCommand(Unit *unit, int frameIndex) {
 		//setRunningStatus(false);
 
 		SystemFlags::OutputDebug(SystemFlags::debugError,"In [%s::%s Line: %d] Error [%s]\n",__FILE__,__FUNCTION__,__LINE__,ex.what());
-		if(SystemFlags::getSystemSettingType(SystemFlags::debugSystem).enabled) SystemFlags::OutputDebug(SystemFlags::debugSystem,"In [%s::%s Line: %d]\n",__FILE__,__FUNCTION__,__LINE__);
+		if(SystemFlags::isDebugEnabled(SystemFlags::debugSystem)) SystemFlags::OutputDebug(SystemFlags::debugSystem,"In [%s::%s Line: %d]\n",__FILE__,__FUNCTION__,__LINE__);
 
 		throw megaglest_runtime_error(ex.what());
 	}
@@ -518,7 +517,7 @@ void UnitUpdater::updateStop(Unit *unit, int frameIndex) {
 	}
 
 	Chrono chrono;
-	if(SystemFlags::getSystemSettingType(SystemFlags::debugPerformance).enabled) chrono.start();
+	if(SystemFlags::isDebugEnabled(SystemFlags::debugPerformance)) chrono.start();
 
 	Command *command= unit->getCurrCommand();
 	if(command == NULL) {
@@ -530,7 +529,7 @@ void UnitUpdater::updateStop(Unit *unit, int frameIndex) {
 
     unit->setCurrSkill(sct->getStopSkillType());
 
-    if(SystemFlags::getSystemSettingType(SystemFlags::debugPerformance).enabled && chrono.getMillis() > 0) SystemFlags::OutputDebug(SystemFlags::debugPerformance,"In [%s::%s Line: %d] took msecs: %lld\n",__FILE__,__FUNCTION__,__LINE__,chrono.getMillis());
+    if(SystemFlags::isDebugEnabled(SystemFlags::debugPerformance) && chrono.getMillis() > 0) SystemFlags::OutputDebug(SystemFlags::debugPerformance,"In [%s::%s Line: %d] took msecs: %lld\n",__FILE__,__FUNCTION__,__LINE__,chrono.getMillis());
 
 
 	//we can attack any unit => attack it
@@ -561,30 +560,30 @@ void UnitUpdater::updateStop(Unit *unit, int frameIndex) {
 				}
 			}
 		}
-		if(SystemFlags::getSystemSettingType(SystemFlags::debugPerformance).enabled && chrono.getMillis() > 0) SystemFlags::OutputDebug(SystemFlags::debugPerformance,"In [%s::%s Line: %d] took msecs: %lld\n",__FILE__,__FUNCTION__,__LINE__,chrono.getMillis());
+		if(SystemFlags::isDebugEnabled(SystemFlags::debugPerformance) && chrono.getMillis() > 0) SystemFlags::OutputDebug(SystemFlags::debugPerformance,"In [%s::%s Line: %d] took msecs: %lld\n",__FILE__,__FUNCTION__,__LINE__,chrono.getMillis());
 	}
 	//see any unit and cant attack it => run
 	else if(unit->getType()->hasCommandClass(ccMove)) {
-		if(SystemFlags::getSystemSettingType(SystemFlags::debugPerformance).enabled && chrono.getMillis() > 0) SystemFlags::OutputDebug(SystemFlags::debugPerformance,"In [%s::%s Line: %d] took msecs: %lld\n",__FILE__,__FUNCTION__,__LINE__,chrono.getMillis());
+		if(SystemFlags::isDebugEnabled(SystemFlags::debugPerformance) && chrono.getMillis() > 0) SystemFlags::OutputDebug(SystemFlags::debugPerformance,"In [%s::%s Line: %d] took msecs: %lld\n",__FILE__,__FUNCTION__,__LINE__,chrono.getMillis());
 
 		if(attackerOnSight(unit, &sighted, (frameIndex >= 0))) {
-			if(SystemFlags::getSystemSettingType(SystemFlags::debugPerformance).enabled && chrono.getMillis() > 0) SystemFlags::OutputDebug(SystemFlags::debugPerformance,"In [%s::%s Line: %d] took msecs: %lld\n",__FILE__,__FUNCTION__,__LINE__,chrono.getMillis());
+			if(SystemFlags::isDebugEnabled(SystemFlags::debugPerformance) && chrono.getMillis() > 0) SystemFlags::OutputDebug(SystemFlags::debugPerformance,"In [%s::%s Line: %d] took msecs: %lld\n",__FILE__,__FUNCTION__,__LINE__,chrono.getMillis());
 			Vec2i escapePos = unit->getPos() * 2 - sighted->getPos();
 			//SystemFlags::OutputDebug(SystemFlags::debugUnitCommands,"In [%s::%s Line: %d]\n",__FILE__,__FUNCTION__,__LINE__);
 			unit->giveCommand(new Command(unit->getType()->getFirstCtOfClass(ccMove), escapePos));
 		}
 
-		if(SystemFlags::getSystemSettingType(SystemFlags::debugPerformance).enabled && chrono.getMillis() > 0) SystemFlags::OutputDebug(SystemFlags::debugPerformance,"In [%s::%s Line: %d] took msecs: %lld\n",__FILE__,__FUNCTION__,__LINE__,chrono.getMillis());
+		if(SystemFlags::isDebugEnabled(SystemFlags::debugPerformance) && chrono.getMillis() > 0) SystemFlags::OutputDebug(SystemFlags::debugPerformance,"In [%s::%s Line: %d] took msecs: %lld\n",__FILE__,__FUNCTION__,__LINE__,chrono.getMillis());
 	}
 
-   	if(SystemFlags::getSystemSettingType(SystemFlags::debugPerformance).enabled && chrono.getMillis() > 0) SystemFlags::OutputDebug(SystemFlags::debugPerformance,"In [%s::%s] Line: %d took msecs: %lld --------------------------- [END OF METHOD] ---------------------------\n",__FILE__,__FUNCTION__,__LINE__,chrono.getMillis());
+   	if(SystemFlags::isDebugEnabled(SystemFlags::debugPerformance) && chrono.getMillis() > 0) SystemFlags::OutputDebug(SystemFlags::debugPerformance,"In [%s::%s] Line: %d took msecs: %lld --------------------------- [END OF METHOD] ---------------------------\n",__FILE__,__FUNCTION__,__LINE__,chrono.getMillis());
 
 	}
 	catch(const exception &ex) {
 		//setRunningStatus(false);
 
 		SystemFlags::OutputDebug(SystemFlags::debugError,"In [%s::%s Line: %d] Error [%s]\n",__FILE__,__FUNCTION__,__LINE__,ex.what());
-		if(SystemFlags::getSystemSettingType(SystemFlags::debugSystem).enabled) SystemFlags::OutputDebug(SystemFlags::debugSystem,"In [%s::%s Line: %d]\n",__FILE__,__FUNCTION__,__LINE__);
+		if(SystemFlags::isDebugEnabled(SystemFlags::debugSystem)) SystemFlags::OutputDebug(SystemFlags::debugSystem,"In [%s::%s Line: %d]\n",__FILE__,__FUNCTION__,__LINE__);
 
 		throw megaglest_runtime_error(ex.what());
 	}
@@ -601,7 +600,7 @@ void UnitUpdater::updateStop(Unit *unit, int frameIndex) {
 void UnitUpdater::updateMove(Unit *unit, int frameIndex) {
 	try {
 	Chrono chrono;
-	if(SystemFlags::getSystemSettingType(SystemFlags::debugPerformance).enabled) chrono.start();
+	if(SystemFlags::isDebugEnabled(SystemFlags::debugPerformance)) chrono.start();
 
     Command *command= unit->getCurrCommand();
 	if(command == NULL) {
@@ -612,25 +611,26 @@ void UnitUpdater::updateMove(Unit *unit, int frameIndex) {
 
 	Vec2i pos= command->getUnit()!=NULL? command->getUnit()->getCenteredPos(): command->getPos();
 
-	if(SystemFlags::getSystemSettingType(SystemFlags::debugWorldSynch).enabled == true && frameIndex < 0) {
+	if(SystemFlags::isDebugEnabled(SystemFlags::debugWorldSynch) == true && frameIndex < 0) {
 		char szBuf[8096]="";
 		snprintf(szBuf,8096,"[updateMove] pos [%s] unit [%d - %s] cmd [%s]",pos.getString().c_str(),unit->getId(),unit->getFullName(false).c_str(),command->toString(false).c_str());
 		unit->logSynchData(__FILE__,__LINE__,szBuf);
 	}
 
-	if(SystemFlags::getSystemSettingType(SystemFlags::debugPerformance).enabled && chrono.getMillis() > 0) SystemFlags::OutputDebug(SystemFlags::debugPerformance,"In [%s::%s Line: %d] took msecs: %lld\n",__FILE__,__FUNCTION__,__LINE__,chrono.getMillis());
+	if(SystemFlags::isDebugEnabled(SystemFlags::debugPerformance) && chrono.getMillis() > 0) SystemFlags::OutputDebug(SystemFlags::debugPerformance,"In [%s::%s Line: %d] took msecs: %lld\n",__FILE__,__FUNCTION__,__LINE__,chrono.getMillis());
 
 
 	TravelState tsValue = tsImpossible;
 	switch(this->game->getGameSettings()->getPathFinderType()) {
 		case pfBasic:
-			tsValue = pathFinder->findPath(unit, pos, NULL, frameIndex);
+			tsValue = pathFinder->findPath(unit, pos, NULL, frameIndex,
+					command->getUnit() == NULL ? command->getUnitCommandGroupId() : -1);
 			break;
 		default:
 			throw megaglest_runtime_error("detected unsupported pathfinder type!");
     }
 
-	if(SystemFlags::getSystemSettingType(SystemFlags::debugPerformance).enabled && chrono.getMillis() > 0) SystemFlags::OutputDebug(SystemFlags::debugPerformance,"In [%s::%s Line: %d] took msecs: %lld\n",__FILE__,__FUNCTION__,__LINE__,chrono.getMillis());
+	if(SystemFlags::isDebugEnabled(SystemFlags::debugPerformance) && chrono.getMillis() > 0) SystemFlags::OutputDebug(SystemFlags::debugPerformance,"In [%s::%s Line: %d] took msecs: %lld\n",__FILE__,__FUNCTION__,__LINE__,chrono.getMillis());
 
 
 	if(frameIndex < 0) {
@@ -653,20 +653,20 @@ void UnitUpdater::updateMove(Unit *unit, int frameIndex) {
 	}
 
 
-	if(SystemFlags::getSystemSettingType(SystemFlags::debugWorldSynch).enabled == true && frameIndex < 0) {
+	if(SystemFlags::isDebugEnabled(SystemFlags::debugWorldSynch) == true && frameIndex < 0) {
 		char szBuf[8096]="";
 		snprintf(szBuf,8096,"[updateMove] tsValue [%d]",tsValue);
 		unit->logSynchData(extractFileFromDirectoryPath(__FILE__).c_str(),__LINE__,szBuf);
 	}
 
-	if(SystemFlags::getSystemSettingType(SystemFlags::debugPerformance).enabled && chrono.getMillis() > 0) SystemFlags::OutputDebug(SystemFlags::debugPerformance,"In [%s::%s] Line: %d took msecs: %lld --------------------------- [END OF METHOD] ---------------------------\n",__FILE__,__FUNCTION__,__LINE__,chrono.getMillis());
+	if(SystemFlags::isDebugEnabled(SystemFlags::debugPerformance) && chrono.getMillis() > 0) SystemFlags::OutputDebug(SystemFlags::debugPerformance,"In [%s::%s] Line: %d took msecs: %lld --------------------------- [END OF METHOD] ---------------------------\n",__FILE__,__FUNCTION__,__LINE__,chrono.getMillis());
 
 	}
 	catch(const exception &ex) {
 		//setRunningStatus(false);
 
 		SystemFlags::OutputDebug(SystemFlags::debugError,"In [%s::%s Line: %d] Error [%s]\n",__FILE__,__FUNCTION__,__LINE__,ex.what());
-		if(SystemFlags::getSystemSettingType(SystemFlags::debugSystem).enabled) SystemFlags::OutputDebug(SystemFlags::debugSystem,"In [%s::%s Line: %d]\n",__FILE__,__FUNCTION__,__LINE__);
+		if(SystemFlags::isDebugEnabled(SystemFlags::debugSystem)) SystemFlags::OutputDebug(SystemFlags::debugSystem,"In [%s::%s Line: %d]\n",__FILE__,__FUNCTION__,__LINE__);
 
 		throw megaglest_runtime_error(ex.what());
 	}
@@ -685,19 +685,19 @@ void UnitUpdater::updateMove(Unit *unit, int frameIndex) {
 void UnitUpdater::updateAttack(Unit *unit, int frameIndex) {
 	try {
 
-	if(SystemFlags::getSystemSettingType(SystemFlags::debugWorldSynch).enabled == true && frameIndex < 0) {
+	if(SystemFlags::isDebugEnabled(SystemFlags::debugWorldSynch) == true && frameIndex < 0) {
 		char szBuf[8096]="";
 		snprintf(szBuf,8096,"[updateAttack]");
 		unit->logSynchData(extractFileFromDirectoryPath(__FILE__).c_str(),__LINE__,szBuf);
 	}
 
 	Chrono chrono;
-	if(SystemFlags::getSystemSettingType(SystemFlags::debugPerformance).enabled) chrono.start();
+	if(SystemFlags::isDebugEnabled(SystemFlags::debugPerformance)) chrono.start();
 
 	Command *command= unit->getCurrCommand();
 	if(command == NULL) {
 
-		if(SystemFlags::getSystemSettingType(SystemFlags::debugWorldSynch).enabled == true && frameIndex < 0) {
+		if(SystemFlags::isDebugEnabled(SystemFlags::debugWorldSynch) == true && frameIndex < 0) {
 			char szBuf[8096]="";
 			snprintf(szBuf,8096,"[updateAttack]");
 			unit->logSynchData(extractFileFromDirectoryPath(__FILE__).c_str(),__LINE__,szBuf);
@@ -708,7 +708,7 @@ void UnitUpdater::updateAttack(Unit *unit, int frameIndex) {
     const AttackCommandType *act= static_cast<const AttackCommandType*>(command->getCommandType());
 	if(act == NULL) {
 
-		if(SystemFlags::getSystemSettingType(SystemFlags::debugWorldSynch).enabled == true && frameIndex < 0) {
+		if(SystemFlags::isDebugEnabled(SystemFlags::debugWorldSynch) == true && frameIndex < 0) {
 			char szBuf[8096]="";
 			snprintf(szBuf,8096,"[updateAttack]");
 			unit->logSynchData(extractFileFromDirectoryPath(__FILE__).c_str(),__LINE__,szBuf);
@@ -718,7 +718,7 @@ void UnitUpdater::updateAttack(Unit *unit, int frameIndex) {
 	}
 	Unit *target= NULL;
 
-	if(SystemFlags::getSystemSettingType(SystemFlags::debugPerformance).enabled && chrono.getMillis() > 0) SystemFlags::OutputDebug(SystemFlags::debugPerformance,"In [%s::%s Line: %d] took msecs: %lld\n",__FILE__,__FUNCTION__,__LINE__,chrono.getMillis());
+	if(SystemFlags::isDebugEnabled(SystemFlags::debugPerformance) && chrono.getMillis() > 0) SystemFlags::OutputDebug(SystemFlags::debugPerformance,"In [%s::%s Line: %d] took msecs: %lld\n",__FILE__,__FUNCTION__,__LINE__,chrono.getMillis());
 
 	
 	if(attackableOnRange(unit, &target, act->getAttackSkillType(),(frameIndex >= 0))) {
@@ -730,13 +730,13 @@ void UnitUpdater::updateAttack(Unit *unit, int frameIndex) {
 			else {
 				unit->setCurrSkill(scStop);
 			}
-			if(SystemFlags::getSystemSettingType(SystemFlags::debugWorldSynch).enabled == true && frameIndex < 0) {
+			if(SystemFlags::isDebugEnabled(SystemFlags::debugWorldSynch) == true && frameIndex < 0) {
 				char szBuf[8096]="";
 				snprintf(szBuf,8096,"[updateAttack]");
 				unit->logSynchData(extractFileFromDirectoryPath(__FILE__).c_str(),__LINE__,szBuf);
 			}
 		}
-		if(SystemFlags::getSystemSettingType(SystemFlags::debugPerformance).enabled && chrono.getMillis() > 0) SystemFlags::OutputDebug(SystemFlags::debugPerformance,"In [%s::%s Line: %d] took msecs: %lld\n",__FILE__,__FUNCTION__,__LINE__,chrono.getMillis());
+		if(SystemFlags::isDebugEnabled(SystemFlags::debugPerformance) && chrono.getMillis() > 0) SystemFlags::OutputDebug(SystemFlags::debugPerformance,"In [%s::%s Line: %d] took msecs: %lld\n",__FILE__,__FUNCTION__,__LINE__,chrono.getMillis());
 	}
 	else {
 		//compute target pos
@@ -750,12 +750,12 @@ void UnitUpdater::updateAttack(Unit *unit, int frameIndex) {
 		else {
 			pos= command->getPos();
 		}
-		if(SystemFlags::getSystemSettingType(SystemFlags::debugWorldSynch).enabled == true && frameIndex < 0) {
+		if(SystemFlags::isDebugEnabled(SystemFlags::debugWorldSynch) == true && frameIndex < 0) {
 			char szBuf[8096]="";
 			snprintf(szBuf,8096,"[updateAttack] pos [%s] unit->getPos() [%s]",pos.getString().c_str(),unit->getPos().getString().c_str());
 			unit->logSynchData(__FILE__,__LINE__,szBuf);
 		}
-		if(SystemFlags::getSystemSettingType(SystemFlags::debugPerformance).enabled && chrono.getMillis() > 0) SystemFlags::OutputDebug(SystemFlags::debugPerformance,"In [%s::%s Line: %d] took msecs: %lld\n",__FILE__,__FUNCTION__,__LINE__,chrono.getMillis());
+		if(SystemFlags::isDebugEnabled(SystemFlags::debugPerformance) && chrono.getMillis() > 0) SystemFlags::OutputDebug(SystemFlags::debugPerformance,"In [%s::%s Line: %d] took msecs: %lld\n",__FILE__,__FUNCTION__,__LINE__,chrono.getMillis());
 		TravelState tsValue = tsImpossible;
 		//if(frameIndex < 0) {
 		{
@@ -771,12 +771,12 @@ void UnitUpdater::updateAttack(Unit *unit, int frameIndex) {
 			//printf("In [%s::%s Line: %d] END pathfind for attacker [%d - %s]\n",__FILE__,__FUNCTION__,__LINE__,unit->getId(), unit->getType()->getName().c_str());
 			//fflush(stdout);
 		}
-		if(SystemFlags::getSystemSettingType(SystemFlags::debugPerformance).enabled && chrono.getMillis() > 0) SystemFlags::OutputDebug(SystemFlags::debugPerformance,"In [%s::%s Line: %d] took msecs: %lld\n",__FILE__,__FUNCTION__,__LINE__,chrono.getMillis());
+		if(SystemFlags::isDebugEnabled(SystemFlags::debugPerformance) && chrono.getMillis() > 0) SystemFlags::OutputDebug(SystemFlags::debugPerformance,"In [%s::%s Line: %d] took msecs: %lld\n",__FILE__,__FUNCTION__,__LINE__,chrono.getMillis());
 		if(frameIndex < 0) {
 			if(command->getUnit() != NULL && !command->getUnit()->isAlive() && unit->getCommandSize() > 1) {
 				// don't run over to dead body if there is still something to do in the queue
 				unit->finishCommand();
-				if(SystemFlags::getSystemSettingType(SystemFlags::debugWorldSynch).enabled == true && frameIndex < 0) {
+				if(SystemFlags::isDebugEnabled(SystemFlags::debugWorldSynch) == true && frameIndex < 0) {
 					char szBuf[8096]="";
 					snprintf(szBuf,8096,"[updateAttack]");
 					unit->logSynchData(extractFileFromDirectoryPath(__FILE__).c_str(),__LINE__,szBuf);
@@ -784,8 +784,8 @@ void UnitUpdater::updateAttack(Unit *unit, int frameIndex) {
 			}
 			else {
 				//if unit arrives destPos order has ended
-				if(SystemFlags::getSystemSettingType(SystemFlags::debugWorldSynch).enabled == true && frameIndex < 0 &&
-						SystemFlags::getSystemSettingType(SystemFlags::debugWorldSynchMax).enabled == true) {
+				if(SystemFlags::isDebugEnabled(SystemFlags::debugWorldSynch) == true && frameIndex < 0 &&
+						SystemFlags::isDebugEnabled(SystemFlags::debugWorldSynchMax) == true) {
 					char szBuf[8096]="";
 					snprintf(szBuf,8096,"#1 [updateAttack] tsValue = %d",tsValue);
 					unit->logSynchData(extractFileFromDirectoryPath(__FILE__).c_str(),__LINE__,szBuf);
@@ -840,26 +840,26 @@ void UnitUpdater::updateAttack(Unit *unit, int frameIndex) {
 						unit->finishCommand();
 				}
 	*/
-				if(SystemFlags::getSystemSettingType(SystemFlags::debugWorldSynch).enabled == true && frameIndex < 0 &&
-						SystemFlags::getSystemSettingType(SystemFlags::debugWorldSynchMax).enabled == true) {
+				if(SystemFlags::isDebugEnabled(SystemFlags::debugWorldSynch) == true && frameIndex < 0 &&
+						SystemFlags::isDebugEnabled(SystemFlags::debugWorldSynchMax) == true) {
 					char szBuf[8096]="";
 					snprintf(szBuf,8096,"#2 [updateAttack] tsValue = %d",tsValue);
 					unit->logSynchData(extractFileFromDirectoryPath(__FILE__).c_str(),__LINE__,szBuf);
 				}
 			}
 		}
-		if(SystemFlags::getSystemSettingType(SystemFlags::debugPerformance).enabled && chrono.getMillis() > 0) SystemFlags::OutputDebug(SystemFlags::debugPerformance,"In [%s::%s Line: %d] took msecs: %lld\n",__FILE__,__FUNCTION__,__LINE__,chrono.getMillis());
+		if(SystemFlags::isDebugEnabled(SystemFlags::debugPerformance) && chrono.getMillis() > 0) SystemFlags::OutputDebug(SystemFlags::debugPerformance,"In [%s::%s Line: %d] took msecs: %lld\n",__FILE__,__FUNCTION__,__LINE__,chrono.getMillis());
 	}
     
 
-    if(SystemFlags::getSystemSettingType(SystemFlags::debugPerformance).enabled && chrono.getMillis() > 0) SystemFlags::OutputDebug(SystemFlags::debugPerformance,"In [%s::%s] Line: %d took msecs: %lld --------------------------- [END OF METHOD] ---------------------------\n",__FILE__,__FUNCTION__,__LINE__,chrono.getMillis());
+    if(SystemFlags::isDebugEnabled(SystemFlags::debugPerformance) && chrono.getMillis() > 0) SystemFlags::OutputDebug(SystemFlags::debugPerformance,"In [%s::%s] Line: %d took msecs: %lld --------------------------- [END OF METHOD] ---------------------------\n",__FILE__,__FUNCTION__,__LINE__,chrono.getMillis());
 
 	}
 	catch(const exception &ex) {
 		//setRunningStatus(false);
 
 		SystemFlags::OutputDebug(SystemFlags::debugError,"In [%s::%s Line: %d] Loc [%s]\n",__FILE__,__FUNCTION__,__LINE__,ex.what());
-		if(SystemFlags::getSystemSettingType(SystemFlags::debugSystem).enabled) SystemFlags::OutputDebug(SystemFlags::debugSystem,"In [%s::%s Line: %d]\n",__FILE__,__FUNCTION__,__LINE__);
+		if(SystemFlags::isDebugEnabled(SystemFlags::debugSystem)) SystemFlags::OutputDebug(SystemFlags::debugSystem,"In [%s::%s Line: %d]\n",__FILE__,__FUNCTION__,__LINE__);
 
 		throw megaglest_runtime_error(ex.what());
 	}
@@ -880,7 +880,7 @@ void UnitUpdater::updateAttackStopped(Unit *unit, int frameIndex) {
 
 	// Nothing to do
 	if(frameIndex >= 0) {
-		if(SystemFlags::getSystemSettingType(SystemFlags::debugWorldSynch).enabled == true && frameIndex >= 0) {
+		if(SystemFlags::isDebugEnabled(SystemFlags::debugWorldSynch) == true && frameIndex >= 0) {
 			char szBuf[8096]="";
 			snprintf(szBuf,8096,"[updateAttackStopped]");
 			unit->logSynchDataThreaded(extractFileFromDirectoryPath(__FILE__).c_str(),__LINE__,szBuf);
@@ -890,7 +890,7 @@ void UnitUpdater::updateAttackStopped(Unit *unit, int frameIndex) {
 	}
 
 	Chrono chrono;
-	if(SystemFlags::getSystemSettingType(SystemFlags::debugPerformance).enabled) chrono.start();
+	if(SystemFlags::isDebugEnabled(SystemFlags::debugPerformance)) chrono.start();
 
 	Command *command= unit->getCurrCommand();
 	if(command == NULL) {
@@ -902,7 +902,7 @@ void UnitUpdater::updateAttackStopped(Unit *unit, int frameIndex) {
 
 
     if(unit->getCommandSize() > 1) {
-    	if(SystemFlags::getSystemSettingType(SystemFlags::debugWorldSynch).enabled == true && frameIndex < 0) {
+    	if(SystemFlags::isDebugEnabled(SystemFlags::debugWorldSynch) == true && frameIndex < 0) {
     		char szBuf[8096]="";
     		snprintf(szBuf,8096,"[updateAttackStopped]");
     		unit->logSynchData(extractFileFromDirectoryPath(__FILE__).c_str(),__LINE__,szBuf);
@@ -922,7 +922,7 @@ void UnitUpdater::updateAttackStopped(Unit *unit, int frameIndex) {
         unit->setCurrSkill(asct->getAttackSkillType());
 		unit->setTarget(result.second);
 
-    	if(SystemFlags::getSystemSettingType(SystemFlags::debugWorldSynch).enabled == true && frameIndex < 0) {
+    	if(SystemFlags::isDebugEnabled(SystemFlags::debugWorldSynch) == true && frameIndex < 0) {
     		char szBuf[8096]="";
     		snprintf(szBuf,8096,"[updateAttackStopped]");
     		unit->logSynchData(extractFileFromDirectoryPath(__FILE__).c_str(),__LINE__,szBuf);
@@ -932,7 +932,7 @@ void UnitUpdater::updateAttackStopped(Unit *unit, int frameIndex) {
         unit->setCurrSkill(asct->getAttackSkillType());
 		unit->setTarget(enemy);
 
-    	if(SystemFlags::getSystemSettingType(SystemFlags::debugWorldSynch).enabled == true && frameIndex < 0) {
+    	if(SystemFlags::isDebugEnabled(SystemFlags::debugWorldSynch) == true && frameIndex < 0) {
     		char szBuf[8096]="";
     		snprintf(szBuf,8096,"[updateAttackStopped]");
     		unit->logSynchData(extractFileFromDirectoryPath(__FILE__).c_str(),__LINE__,szBuf);
@@ -941,21 +941,21 @@ void UnitUpdater::updateAttackStopped(Unit *unit, int frameIndex) {
     else {
         unit->setCurrSkill(asct->getStopSkillType());
 
-    	if(SystemFlags::getSystemSettingType(SystemFlags::debugWorldSynch).enabled == true && frameIndex < 0) {
+    	if(SystemFlags::isDebugEnabled(SystemFlags::debugWorldSynch) == true && frameIndex < 0) {
     		char szBuf[8096]="";
     		snprintf(szBuf,8096,"[updateAttackStopped]");
     		unit->logSynchData(extractFileFromDirectoryPath(__FILE__).c_str(),__LINE__,szBuf);
     	}
     }
 
-    if(SystemFlags::getSystemSettingType(SystemFlags::debugPerformance).enabled && chrono.getMillis() > 0) SystemFlags::OutputDebug(SystemFlags::debugPerformance,"In [%s::%s] Line: %d took msecs: %lld --------------------------- [END OF METHOD] ---------------------------\n",__FILE__,__FUNCTION__,__LINE__,chrono.getMillis());
+    if(SystemFlags::isDebugEnabled(SystemFlags::debugPerformance) && chrono.getMillis() > 0) SystemFlags::OutputDebug(SystemFlags::debugPerformance,"In [%s::%s] Line: %d took msecs: %lld --------------------------- [END OF METHOD] ---------------------------\n",__FILE__,__FUNCTION__,__LINE__,chrono.getMillis());
 
 	}
 	catch(const exception &ex) {
 		//setRunningStatus(false);
 
 		SystemFlags::OutputDebug(SystemFlags::debugError,"In [%s::%s Line: %d] Error [%s]\n",__FILE__,__FUNCTION__,__LINE__,ex.what());
-		if(SystemFlags::getSystemSettingType(SystemFlags::debugSystem).enabled) SystemFlags::OutputDebug(SystemFlags::debugSystem,"In [%s::%s Line: %d]\n",__FILE__,__FUNCTION__,__LINE__);
+		if(SystemFlags::isDebugEnabled(SystemFlags::debugSystem)) SystemFlags::OutputDebug(SystemFlags::debugSystem,"In [%s::%s Line: %d]\n",__FILE__,__FUNCTION__,__LINE__);
 
 		throw megaglest_runtime_error(ex.what());
 	}
@@ -1024,16 +1024,16 @@ std::pair<bool,Unit *> UnitUpdater::unitBeingAttacked(const Unit *unit) {
 void UnitUpdater::updateBuild(Unit *unit, int frameIndex) {
 	try {
 
-	if(SystemFlags::getSystemSettingType(SystemFlags::debugWorldSynch).enabled == true && frameIndex < 0) {
+	if(SystemFlags::isDebugEnabled(SystemFlags::debugWorldSynch) == true && frameIndex < 0) {
 		char szBuf[8096]="";
 		snprintf(szBuf,8096,"[updateBuild]");
 		unit->logSynchData(extractFileFromDirectoryPath(__FILE__).c_str(),__LINE__,szBuf);
 	}
 
 	Chrono chrono;
-	if(SystemFlags::getSystemSettingType(SystemFlags::debugPerformance).enabled) chrono.start();
+	if(SystemFlags::isDebugEnabled(SystemFlags::debugPerformance)) chrono.start();
 
-	if(SystemFlags::getSystemSettingType(SystemFlags::debugUnitCommands).enabled) SystemFlags::OutputDebug(SystemFlags::debugUnitCommands,"In [%s::%s Line: %d] unit [%s] will build using command [%s]\n",__FILE__,__FUNCTION__,__LINE__,unit->toString(false).c_str(), unit->getCurrCommand()->toString(false).c_str());
+	if(SystemFlags::isDebugEnabled(SystemFlags::debugUnitCommands)) SystemFlags::OutputDebug(SystemFlags::debugUnitCommands,"In [%s::%s Line: %d] unit [%s] will build using command [%s]\n",__FILE__,__FUNCTION__,__LINE__,unit->toString(false).c_str(), unit->getCurrCommand()->toString(false).c_str());
 
 	Command *command= unit->getCurrCommand();
 	if(command == NULL) {
@@ -1043,12 +1043,12 @@ void UnitUpdater::updateBuild(Unit *unit, int frameIndex) {
     const BuildCommandType *bct= static_cast<const BuildCommandType*>(command->getCommandType());
 
 	if(unit->getCurrSkill() != NULL && unit->getCurrSkill()->getClass() != scBuild) {
-		if(SystemFlags::getSystemSettingType(SystemFlags::debugUnitCommands).enabled) SystemFlags::OutputDebug(SystemFlags::debugUnitCommands,"In [%s::%s Line: %d]\n",__FILE__,__FUNCTION__,__LINE__);
+		if(SystemFlags::isDebugEnabled(SystemFlags::debugUnitCommands)) SystemFlags::OutputDebug(SystemFlags::debugUnitCommands,"In [%s::%s Line: %d]\n",__FILE__,__FUNCTION__,__LINE__);
 
         //if not building
         const UnitType *ut= command->getUnitType();
 
-        if(SystemFlags::getSystemSettingType(SystemFlags::debugPerformance).enabled && chrono.getMillis() > 0) SystemFlags::OutputDebug(SystemFlags::debugPerformance,"In [%s::%s Line: %d] took msecs: %lld\n",__FILE__,__FUNCTION__,__LINE__,chrono.getMillis());
+        if(SystemFlags::isDebugEnabled(SystemFlags::debugPerformance) && chrono.getMillis() > 0) SystemFlags::OutputDebug(SystemFlags::debugPerformance,"In [%s::%s Line: %d] took msecs: %lld\n",__FILE__,__FUNCTION__,__LINE__,chrono.getMillis());
 
 		TravelState tsValue = tsImpossible;
 		switch(this->game->getGameSettings()->getPathFinderType()) {
@@ -1056,7 +1056,7 @@ void UnitUpdater::updateBuild(Unit *unit, int frameIndex) {
 				{
 				Vec2i buildPos = map->findBestBuildApproach(unit, command->getPos(), ut);
 
-				if(SystemFlags::getSystemSettingType(SystemFlags::debugWorldSynch).enabled == true && frameIndex < 0) {
+				if(SystemFlags::isDebugEnabled(SystemFlags::debugWorldSynch) == true && frameIndex < 0) {
 					char szBuf[8096]="";
 					snprintf(szBuf,8096,"[updateBuild] unit->getPos() [%s] command->getPos() [%s] buildPos [%s]",
 							unit->getPos().getString().c_str(),command->getPos().getString().c_str(),buildPos.getString().c_str());
@@ -1065,7 +1065,7 @@ void UnitUpdater::updateBuild(Unit *unit, int frameIndex) {
 
 				tsValue = pathFinder->findPath(unit, buildPos, NULL, frameIndex);
 
-				if(SystemFlags::getSystemSettingType(SystemFlags::debugWorldSynch).enabled == true && frameIndex < 0) {
+				if(SystemFlags::isDebugEnabled(SystemFlags::debugWorldSynch) == true && frameIndex < 0) {
 					char szBuf[8096]="";
 					snprintf(szBuf,8096,"[updateBuild] tsValue: %d",tsValue);
 					unit->logSynchData(__FILE__,__LINE__,szBuf);
@@ -1077,19 +1077,19 @@ void UnitUpdater::updateBuild(Unit *unit, int frameIndex) {
 				throw megaglest_runtime_error("detected unsupported pathfinder type!");
 	    }
 
-		if(SystemFlags::getSystemSettingType(SystemFlags::debugUnitCommands).enabled) SystemFlags::OutputDebug(SystemFlags::debugUnitCommands,"In [%s::%s Line: %d] tsValue = %d\n",__FILE__,__FUNCTION__,__LINE__,tsValue);
+		if(SystemFlags::isDebugEnabled(SystemFlags::debugUnitCommands)) SystemFlags::OutputDebug(SystemFlags::debugUnitCommands,"In [%s::%s Line: %d] tsValue = %d\n",__FILE__,__FUNCTION__,__LINE__,tsValue);
 
 		if(frameIndex < 0) {
 			switch (tsValue) {
 			case tsMoving:
-				if(SystemFlags::getSystemSettingType(SystemFlags::debugUnitCommands).enabled) SystemFlags::OutputDebug(SystemFlags::debugUnitCommands,"In [%s::%s Line: %d] tsMoving\n",__FILE__,__FUNCTION__,__LINE__);
+				if(SystemFlags::isDebugEnabled(SystemFlags::debugUnitCommands)) SystemFlags::OutputDebug(SystemFlags::debugUnitCommands,"In [%s::%s Line: %d] tsMoving\n",__FILE__,__FUNCTION__,__LINE__);
 
 				unit->setCurrSkill(bct->getMoveSkillType());
 				break;
 
 			case tsArrived:
 				{
-				if(SystemFlags::getSystemSettingType(SystemFlags::debugUnitCommands).enabled) SystemFlags::OutputDebug(SystemFlags::debugUnitCommands,"In [%s::%s Line: %d] tsArrived:\n",__FILE__,__FUNCTION__,__LINE__);
+				if(SystemFlags::isDebugEnabled(SystemFlags::debugUnitCommands)) SystemFlags::OutputDebug(SystemFlags::debugUnitCommands,"In [%s::%s Line: %d] tsArrived:\n",__FILE__,__FUNCTION__,__LINE__);
 
 				//if arrived destination
 				assert(ut);
@@ -1100,14 +1100,14 @@ void UnitUpdater::updateBuild(Unit *unit, int frameIndex) {
 				bool canOccupyCell = false;
 				switch(this->game->getGameSettings()->getPathFinderType()) {
 					case pfBasic:
-						if(SystemFlags::getSystemSettingType(SystemFlags::debugUnitCommands).enabled) SystemFlags::OutputDebug(SystemFlags::debugUnitCommands,"In [%s::%s Line: %d] tsArrived about to call map->isFreeCells() for command->getPos() = %s, ut->getSize() = %d\n",__FILE__,__FUNCTION__,__LINE__,command->getPos().getString().c_str(),ut->getSize());
+						if(SystemFlags::isDebugEnabled(SystemFlags::debugUnitCommands)) SystemFlags::OutputDebug(SystemFlags::debugUnitCommands,"In [%s::%s Line: %d] tsArrived about to call map->isFreeCells() for command->getPos() = %s, ut->getSize() = %d\n",__FILE__,__FUNCTION__,__LINE__,command->getPos().getString().c_str(),ut->getSize());
 						canOccupyCell = map->isFreeCells(command->getPos(), ut->getSize(), fLand);
 						break;
 					default:
 						throw megaglest_runtime_error("detected unsupported pathfinder type!");
 				}
 
-				if(SystemFlags::getSystemSettingType(SystemFlags::debugUnitCommands).enabled) SystemFlags::OutputDebug(SystemFlags::debugUnitCommands,"In [%s::%s Line: %d] canOccupyCell = %d\n",__FILE__,__FUNCTION__,__LINE__,canOccupyCell);
+				if(SystemFlags::isDebugEnabled(SystemFlags::debugUnitCommands)) SystemFlags::OutputDebug(SystemFlags::debugUnitCommands,"In [%s::%s Line: %d] canOccupyCell = %d\n",__FILE__,__FUNCTION__,__LINE__,canOccupyCell);
 
 				if (canOccupyCell == true) {
 					const UnitType *builtUnitType= command->getUnitType();
@@ -1125,7 +1125,7 @@ void UnitUpdater::updateBuild(Unit *unit, int frameIndex) {
 					Vec2i buildPos = command->getPos();
 					Unit *builtUnit= new Unit(world->getNextUnitId(unit->getFaction()), newpath, buildPos, builtUnitType, unit->getFaction(), world->getMap(), facing);
 
-					if(SystemFlags::getSystemSettingType(SystemFlags::debugUnitCommands).enabled) SystemFlags::OutputDebug(SystemFlags::debugUnitCommands,"In [%s::%s Line: %d]\n",__FILE__,__FUNCTION__,__LINE__);
+					if(SystemFlags::isDebugEnabled(SystemFlags::debugUnitCommands)) SystemFlags::OutputDebug(SystemFlags::debugUnitCommands,"In [%s::%s Line: %d]\n",__FILE__,__FUNCTION__,__LINE__);
 
 					builtUnit->create();
 
@@ -1141,7 +1141,7 @@ void UnitUpdater::updateBuild(Unit *unit, int frameIndex) {
 
 					map->prepareTerrain(builtUnit);
 
-					if(SystemFlags::getSystemSettingType(SystemFlags::debugUnitCommands).enabled) SystemFlags::OutputDebug(SystemFlags::debugUnitCommands,"In [%s::%s Line: %d]\n",__FILE__,__FUNCTION__,__LINE__);
+					if(SystemFlags::isDebugEnabled(SystemFlags::debugUnitCommands)) SystemFlags::OutputDebug(SystemFlags::debugUnitCommands,"In [%s::%s Line: %d]\n",__FILE__,__FUNCTION__,__LINE__);
 
 					switch(this->game->getGameSettings()->getPathFinderType()) {
 						case pfBasic:
@@ -1162,7 +1162,7 @@ void UnitUpdater::updateBuild(Unit *unit, int frameIndex) {
 							gameCamera->getPos());
 					}
 
-					if(SystemFlags::getSystemSettingType(SystemFlags::debugUnitCommands).enabled) SystemFlags::OutputDebug(SystemFlags::debugUnitCommands,"In [%s::%s Line: %d] unit created for unit [%s]\n",__FILE__,__FUNCTION__,__LINE__,builtUnit->toString(false).c_str());
+					if(SystemFlags::isDebugEnabled(SystemFlags::debugUnitCommands)) SystemFlags::OutputDebug(SystemFlags::debugUnitCommands,"In [%s::%s Line: %d] unit created for unit [%s]\n",__FILE__,__FUNCTION__,__LINE__,builtUnit->toString(false).c_str());
 				}
 				else {
 					//if there are no free cells
@@ -1173,7 +1173,7 @@ void UnitUpdater::updateBuild(Unit *unit, int frameIndex) {
 						 console->addStdMessage("BuildingNoPlace");
 					}
 
-					if(SystemFlags::getSystemSettingType(SystemFlags::debugUnitCommands).enabled) SystemFlags::OutputDebug(SystemFlags::debugUnitCommands,"In [%s::%s Line: %d] got BuildingNoPlace\n",__FILE__,__FUNCTION__,__LINE__);
+					if(SystemFlags::isDebugEnabled(SystemFlags::debugUnitCommands)) SystemFlags::OutputDebug(SystemFlags::debugUnitCommands,"In [%s::%s Line: %d] got BuildingNoPlace\n",__FILE__,__FUNCTION__,__LINE__);
 				}
 				}
 				break;
@@ -1182,15 +1182,15 @@ void UnitUpdater::updateBuild(Unit *unit, int frameIndex) {
 				if(unit->getPath()->isBlocked()) {
 					unit->cancelCommand();
 
-					if(SystemFlags::getSystemSettingType(SystemFlags::debugUnitCommands).enabled) SystemFlags::OutputDebug(SystemFlags::debugUnitCommands,"In [%s::%s Line: %d] got tsBlocked\n",__FILE__,__FUNCTION__,__LINE__);
+					if(SystemFlags::isDebugEnabled(SystemFlags::debugUnitCommands)) SystemFlags::OutputDebug(SystemFlags::debugUnitCommands,"In [%s::%s Line: %d] got tsBlocked\n",__FILE__,__FUNCTION__,__LINE__);
 				}
 				break;
 			}
 		}
-		if(SystemFlags::getSystemSettingType(SystemFlags::debugPerformance).enabled && chrono.getMillis() > 0) SystemFlags::OutputDebug(SystemFlags::debugPerformance,"In [%s::%s Line: %d] took msecs: %lld\n",__FILE__,__FUNCTION__,__LINE__,chrono.getMillis());
+		if(SystemFlags::isDebugEnabled(SystemFlags::debugPerformance) && chrono.getMillis() > 0) SystemFlags::OutputDebug(SystemFlags::debugPerformance,"In [%s::%s Line: %d] took msecs: %lld\n",__FILE__,__FUNCTION__,__LINE__,chrono.getMillis());
     }
     else {
-    	if(SystemFlags::getSystemSettingType(SystemFlags::debugUnitCommands).enabled) SystemFlags::OutputDebug(SystemFlags::debugUnitCommands,"In [%s::%s Line: %d] tsArrived unit = %s\n",__FILE__,__FUNCTION__,__LINE__,unit->toString(false).c_str());
+    	if(SystemFlags::isDebugEnabled(SystemFlags::debugUnitCommands)) SystemFlags::OutputDebug(SystemFlags::debugUnitCommands,"In [%s::%s Line: %d] tsArrived unit = %s\n",__FILE__,__FUNCTION__,__LINE__,unit->toString(false).c_str());
 
     	if(frameIndex < 0) {
 			//if building
@@ -1200,16 +1200,16 @@ void UnitUpdater::updateBuild(Unit *unit, int frameIndex) {
 			}
 
 			if(builtUnit != NULL) {
-				if(SystemFlags::getSystemSettingType(SystemFlags::debugUnitCommands).enabled) SystemFlags::OutputDebug(SystemFlags::debugUnitCommands,"In [%s::%s Line: %d] builtUnit = %s\n",__FILE__,__FUNCTION__,__LINE__,builtUnit->toString(false).c_str());
+				if(SystemFlags::isDebugEnabled(SystemFlags::debugUnitCommands)) SystemFlags::OutputDebug(SystemFlags::debugUnitCommands,"In [%s::%s Line: %d] builtUnit = %s\n",__FILE__,__FUNCTION__,__LINE__,builtUnit->toString(false).c_str());
 			}
 
-			if(SystemFlags::getSystemSettingType(SystemFlags::debugUnitCommands).enabled) SystemFlags::OutputDebug(SystemFlags::debugUnitCommands,"In [%s::%s Line: %d] builtUnit = [%p]\n",__FILE__,__FUNCTION__,__LINE__,builtUnit);
+			if(SystemFlags::isDebugEnabled(SystemFlags::debugUnitCommands)) SystemFlags::OutputDebug(SystemFlags::debugUnitCommands,"In [%s::%s Line: %d] builtUnit = [%p]\n",__FILE__,__FUNCTION__,__LINE__,builtUnit);
 
 			//if unit is killed while building then u==NULL;
 			if(builtUnit != NULL && builtUnit != command->getUnit()) {
-				if(SystemFlags::getSystemSettingType(SystemFlags::debugUnitCommands).enabled) SystemFlags::OutputDebug(SystemFlags::debugUnitCommands,"In [%s::%s Line: %d] builtUnit is not the command's unit!\n",__FILE__,__FUNCTION__,__LINE__);
+				if(SystemFlags::isDebugEnabled(SystemFlags::debugUnitCommands)) SystemFlags::OutputDebug(SystemFlags::debugUnitCommands,"In [%s::%s Line: %d] builtUnit is not the command's unit!\n",__FILE__,__FUNCTION__,__LINE__);
 
-				if(SystemFlags::getSystemSettingType(SystemFlags::debugWorldSynch).enabled == true && frameIndex < 0) {
+				if(SystemFlags::isDebugEnabled(SystemFlags::debugWorldSynch) == true && frameIndex < 0) {
 					char szBuf[8096]="";
 					snprintf(szBuf,8096,"[updateBuild]");
 					unit->logSynchData(__FILE__,__LINE__,szBuf);
@@ -1218,9 +1218,9 @@ void UnitUpdater::updateBuild(Unit *unit, int frameIndex) {
 				unit->setCurrSkill(scStop);
 			}
 			else if(builtUnit == NULL || builtUnit->isBuilt()) {
-				if(SystemFlags::getSystemSettingType(SystemFlags::debugUnitCommands).enabled) SystemFlags::OutputDebug(SystemFlags::debugUnitCommands,"In [%s::%s Line: %d] builtUnit is NULL or ALREADY built\n",__FILE__,__FUNCTION__,__LINE__);
+				if(SystemFlags::isDebugEnabled(SystemFlags::debugUnitCommands)) SystemFlags::OutputDebug(SystemFlags::debugUnitCommands,"In [%s::%s Line: %d] builtUnit is NULL or ALREADY built\n",__FILE__,__FUNCTION__,__LINE__);
 
-				if(SystemFlags::getSystemSettingType(SystemFlags::debugWorldSynch).enabled == true && frameIndex < 0) {
+				if(SystemFlags::isDebugEnabled(SystemFlags::debugWorldSynch) == true && frameIndex < 0) {
 					char szBuf[8096]="";
 					snprintf(szBuf,8096,"[updateBuild]");
 					unit->logSynchData(__FILE__,__LINE__,szBuf);
@@ -1231,9 +1231,9 @@ void UnitUpdater::updateBuild(Unit *unit, int frameIndex) {
 
 			}
 			else if(builtUnit == NULL || builtUnit->repair()) {
-				if(SystemFlags::getSystemSettingType(SystemFlags::debugUnitCommands).enabled) SystemFlags::OutputDebug(SystemFlags::debugUnitCommands,"In [%s::%s Line: %d]\n",__FILE__,__FUNCTION__,__LINE__);
+				if(SystemFlags::isDebugEnabled(SystemFlags::debugUnitCommands)) SystemFlags::OutputDebug(SystemFlags::debugUnitCommands,"In [%s::%s Line: %d]\n",__FILE__,__FUNCTION__,__LINE__);
 
-				if(SystemFlags::getSystemSettingType(SystemFlags::debugWorldSynch).enabled == true && frameIndex < 0) {
+				if(SystemFlags::isDebugEnabled(SystemFlags::debugWorldSynch) == true && frameIndex < 0) {
 					char szBuf[8096]="";
 					snprintf(szBuf,8096,"[updateBuild]");
 					unit->logSynchData(__FILE__,__LINE__,szBuf);
@@ -1255,17 +1255,17 @@ void UnitUpdater::updateBuild(Unit *unit, int frameIndex) {
 				}
 			}
     	}
-    	if(SystemFlags::getSystemSettingType(SystemFlags::debugPerformance).enabled && chrono.getMillis() > 0) SystemFlags::OutputDebug(SystemFlags::debugPerformance,"In [%s::%s Line: %d] took msecs: %lld\n",__FILE__,__FUNCTION__,__LINE__,chrono.getMillis());
+    	if(SystemFlags::isDebugEnabled(SystemFlags::debugPerformance) && chrono.getMillis() > 0) SystemFlags::OutputDebug(SystemFlags::debugPerformance,"In [%s::%s Line: %d] took msecs: %lld\n",__FILE__,__FUNCTION__,__LINE__,chrono.getMillis());
     }
 
-	if(SystemFlags::getSystemSettingType(SystemFlags::debugPerformance).enabled && chrono.getMillis() > 0) SystemFlags::OutputDebug(SystemFlags::debugPerformance,"In [%s::%s] Line: %d took msecs: %lld --------------------------- [END OF METHOD] ---------------------------\n",__FILE__,__FUNCTION__,__LINE__,chrono.getMillis());
+	if(SystemFlags::isDebugEnabled(SystemFlags::debugPerformance) && chrono.getMillis() > 0) SystemFlags::OutputDebug(SystemFlags::debugPerformance,"In [%s::%s] Line: %d took msecs: %lld --------------------------- [END OF METHOD] ---------------------------\n",__FILE__,__FUNCTION__,__LINE__,chrono.getMillis());
 
 	}
 	catch(const exception &ex) {
 		//setRunningStatus(false);
 
 		SystemFlags::OutputDebug(SystemFlags::debugError,"In [%s::%s Line: %d] Error [%s]\n",__FILE__,__FUNCTION__,__LINE__,ex.what());
-		if(SystemFlags::getSystemSettingType(SystemFlags::debugSystem).enabled) SystemFlags::OutputDebug(SystemFlags::debugSystem,"In [%s::%s Line: %d]\n",__FILE__,__FUNCTION__,__LINE__);
+		if(SystemFlags::isDebugEnabled(SystemFlags::debugSystem)) SystemFlags::OutputDebug(SystemFlags::debugSystem,"In [%s::%s Line: %d]\n",__FILE__,__FUNCTION__,__LINE__);
 
 		throw megaglest_runtime_error(ex.what());
 	}
@@ -1286,7 +1286,7 @@ void UnitUpdater::updateHarvestEmergencyReturn(Unit *unit, int frameIndex) {
 		return;
 	}
 
-	if(SystemFlags::getSystemSettingType(SystemFlags::debugWorldSynch).enabled == true && frameIndex < 0) {
+	if(SystemFlags::isDebugEnabled(SystemFlags::debugWorldSynch) == true && frameIndex < 0) {
 		char szBuf[8096]="";
 		snprintf(szBuf,8096,"[updateHarvestEmergencyReturn]");
 		unit->logSynchData(extractFileFromDirectoryPath(__FILE__).c_str(),__LINE__,szBuf);
@@ -1322,7 +1322,7 @@ void UnitUpdater::updateHarvestEmergencyReturn(Unit *unit, int frameIndex) {
 							NetworkCommand networkCommand(this->world,nctGiveCommand, unit->getId(), previousHarvestCmd->getId(), unit->getLastHarvestedResourcePos(),
 															-1, -1, Unit::invalidId, -1, false, cst_None, -1, -1);
 
-							if(SystemFlags::getSystemSettingType(SystemFlags::debugUnitCommands).enabled) SystemFlags::OutputDebug(SystemFlags::debugUnitCommands,"In [%s::%s Line: %d]\n",__FILE__,__FUNCTION__,__LINE__);
+							if(SystemFlags::isDebugEnabled(SystemFlags::debugUnitCommands)) SystemFlags::OutputDebug(SystemFlags::debugUnitCommands,"In [%s::%s Line: %d]\n",__FILE__,__FUNCTION__,__LINE__);
 
 							Command* new_command= this->game->getCommander()->buildCommand(&networkCommand);
 							new_command->setStateType(cst_EmergencyReturnResource);
@@ -1331,7 +1331,7 @@ void UnitUpdater::updateHarvestEmergencyReturn(Unit *unit, int frameIndex) {
 							if(cr.first == crSuccess) {
 								//printf("\n\n#1b return harvested resources\n\n");
 
-								if(SystemFlags::getSystemSettingType(SystemFlags::debugUnitCommands).enabled) SystemFlags::OutputDebug(SystemFlags::debugUnitCommands,"In [%s::%s Line: %d]\n",__FILE__,__FUNCTION__,__LINE__);
+								if(SystemFlags::isDebugEnabled(SystemFlags::debugUnitCommands)) SystemFlags::OutputDebug(SystemFlags::debugUnitCommands,"In [%s::%s Line: %d]\n",__FILE__,__FUNCTION__,__LINE__);
 								unit->replaceCurrCommand(new_command);
 
 								unit->setCurrSkill(previousHarvestCmd->getStopLoadedSkillType()); // make sure we use the right harvest animation
@@ -1339,7 +1339,7 @@ void UnitUpdater::updateHarvestEmergencyReturn(Unit *unit, int frameIndex) {
 							else {
 								//printf("\n\n#1c return harvested resources\n\n");
 
-								if(SystemFlags::getSystemSettingType(SystemFlags::debugUnitCommands).enabled) SystemFlags::OutputDebug(SystemFlags::debugUnitCommands,"In [%s::%s Line: %d]\n",__FILE__,__FUNCTION__,__LINE__);
+								if(SystemFlags::isDebugEnabled(SystemFlags::debugUnitCommands)) SystemFlags::OutputDebug(SystemFlags::debugUnitCommands,"In [%s::%s Line: %d]\n",__FILE__,__FUNCTION__,__LINE__);
 								delete new_command;
 
 								unit->setCurrSkill(scStop);
@@ -1357,7 +1357,7 @@ void UnitUpdater::updateHarvestEmergencyReturn(Unit *unit, int frameIndex) {
 		//setRunningStatus(false);
 
 		SystemFlags::OutputDebug(SystemFlags::debugError,"In [%s::%s Line: %d] Error [%s]\n",__FILE__,__FUNCTION__,__LINE__,ex.what());
-		if(SystemFlags::getSystemSettingType(SystemFlags::debugSystem).enabled) SystemFlags::OutputDebug(SystemFlags::debugSystem,"In [%s::%s Line: %d]\n",__FILE__,__FUNCTION__,__LINE__);
+		if(SystemFlags::isDebugEnabled(SystemFlags::debugSystem)) SystemFlags::OutputDebug(SystemFlags::debugSystem,"In [%s::%s Line: %d]\n",__FILE__,__FUNCTION__,__LINE__);
 
 		throw megaglest_runtime_error(ex.what());
 	}
@@ -1373,14 +1373,14 @@ void UnitUpdater::updateHarvestEmergencyReturn(Unit *unit, int frameIndex) {
 void UnitUpdater::updateHarvest(Unit *unit, int frameIndex) {
 	try {
 
-	if(SystemFlags::getSystemSettingType(SystemFlags::debugWorldSynch).enabled == true && frameIndex < 0) {
+	if(SystemFlags::isDebugEnabled(SystemFlags::debugWorldSynch) == true && frameIndex < 0) {
 		char szBuf[8096]="";
 		snprintf(szBuf,8096,"[updateHarvest]");
 		unit->logSynchData(extractFileFromDirectoryPath(__FILE__).c_str(),__LINE__,szBuf);
 	}
 
 	Chrono chrono;
-	if(SystemFlags::getSystemSettingType(SystemFlags::debugPerformance).enabled) chrono.start();
+	if(SystemFlags::isDebugEnabled(SystemFlags::debugPerformance)) chrono.start();
 
 	Command *command= unit->getCurrCommand();
 	if(command == NULL) {
@@ -1396,7 +1396,7 @@ void UnitUpdater::updateHarvest(Unit *unit, int frameIndex) {
 	//TravelState tsValue = tsImpossible;
 	//UnitPathInterface *path= unit->getPath();
 
-	if(SystemFlags::getSystemSettingType(SystemFlags::debugPerformance).enabled && chrono.getMillis() > 0) SystemFlags::OutputDebug(SystemFlags::debugPerformance,"In [%s::%s Line: %d] took msecs: %lld\n",__FILE__,__FUNCTION__,__LINE__,chrono.getMillis());
+	if(SystemFlags::isDebugEnabled(SystemFlags::debugPerformance) && chrono.getMillis() > 0) SystemFlags::OutputDebug(SystemFlags::debugPerformance,"In [%s::%s Line: %d] took msecs: %lld\n",__FILE__,__FUNCTION__,__LINE__,chrono.getMillis());
 	//printf("In UpdateHarvest [%d - %s] unit->getCurrSkill()->getClass() = %d\n",unit->getId(),unit->getType()->getName().c_str(),unit->getCurrSkill()->getClass());
 
 	Resource *harvestResource = NULL;
@@ -1422,7 +1422,7 @@ void UnitUpdater::updateHarvest(Unit *unit, int frameIndex) {
 					//if can harvest dest. pos
 					bool canHarvestDestPos = false;
 
-					if(SystemFlags::getSystemSettingType(SystemFlags::debugPerformance).enabled && chrono.getMillis() > 0) SystemFlags::OutputDebug(SystemFlags::debugPerformance,"In [%s::%s Line: %d] took msecs: %lld\n",__FILE__,__FUNCTION__,__LINE__,chrono.getMillis());
+					if(SystemFlags::isDebugEnabled(SystemFlags::debugPerformance) && chrono.getMillis() > 0) SystemFlags::OutputDebug(SystemFlags::debugPerformance,"In [%s::%s Line: %d] took msecs: %lld\n",__FILE__,__FUNCTION__,__LINE__,chrono.getMillis());
 
 	    			switch(this->game->getGameSettings()->getPathFinderType()) {
 	    				case pfBasic:
@@ -1446,7 +1446,7 @@ void UnitUpdater::updateHarvest(Unit *unit, int frameIndex) {
 	    								//printf("%%----------- unit [%s - %d] CHANGING RESOURCE POS from [%s] to [%s]\n",unit->getFullName().c_str(),unit->getId(),command->getOriginalPos().getString().c_str(),clickPos.getString().c_str());
 
 										if(frameIndex < 0) {
-											if(SystemFlags::getSystemSettingType(SystemFlags::debugWorldSynch).enabled == true && frameIndex < 0) {
+											if(SystemFlags::isDebugEnabled(SystemFlags::debugWorldSynch) == true && frameIndex < 0) {
 												char szBuf[8096]="";
 												snprintf(szBuf,8096,"[updateHarvest] clickPos [%s]",clickPos.getString().c_str());
 												unit->logSynchData(extractFileFromDirectoryPath(__FILE__).c_str(),__LINE__,szBuf);
@@ -1462,11 +1462,11 @@ void UnitUpdater::updateHarvest(Unit *unit, int frameIndex) {
 	    					throw megaglest_runtime_error("detected unsupported pathfinder type!");
 	    			}
 
-	    			if(SystemFlags::getSystemSettingType(SystemFlags::debugPerformance).enabled && chrono.getMillis() > 0) SystemFlags::OutputDebug(SystemFlags::debugPerformance,"In [%s::%s Line: %d] took msecs: %lld\n",__FILE__,__FUNCTION__,__LINE__,chrono.getMillis());
+	    			if(SystemFlags::isDebugEnabled(SystemFlags::debugPerformance) && chrono.getMillis() > 0) SystemFlags::OutputDebug(SystemFlags::debugPerformance,"In [%s::%s Line: %d] took msecs: %lld\n",__FILE__,__FUNCTION__,__LINE__,chrono.getMillis());
 
 					if (canHarvestDestPos == true ) {
 						if(frameIndex < 0) {
-							if(SystemFlags::getSystemSettingType(SystemFlags::debugWorldSynch).enabled == true && frameIndex < 0) {
+							if(SystemFlags::isDebugEnabled(SystemFlags::debugWorldSynch) == true && frameIndex < 0) {
 								char szBuf[8096]="";
 								snprintf(szBuf,8096,"[updateHarvest]");
 								unit->logSynchData(extractFileFromDirectoryPath(__FILE__).c_str(),__LINE__,szBuf);
@@ -1499,18 +1499,18 @@ void UnitUpdater::updateHarvest(Unit *unit, int frameIndex) {
 										throw megaglest_runtime_error("detected unsupported pathfinder type!");
 								}
 
-								if(SystemFlags::getSystemSettingType(SystemFlags::debugWorldSynch).enabled == true && frameIndex < 0) {
+								if(SystemFlags::isDebugEnabled(SystemFlags::debugWorldSynch) == true && frameIndex < 0) {
 									char szBuf[8096]="";
 									snprintf(szBuf,8096,"[updateHarvest] targetPos [%s]",targetPos.getString().c_str());
 									unit->logSynchData(extractFileFromDirectoryPath(__FILE__).c_str(),__LINE__,szBuf);
 								}
 							}
-							if(SystemFlags::getSystemSettingType(SystemFlags::debugPerformance).enabled && chrono.getMillis() > 0) SystemFlags::OutputDebug(SystemFlags::debugPerformance,"In [%s::%s Line: %d] took msecs: %lld\n",__FILE__,__FUNCTION__,__LINE__,chrono.getMillis());
+							if(SystemFlags::isDebugEnabled(SystemFlags::debugPerformance) && chrono.getMillis() > 0) SystemFlags::OutputDebug(SystemFlags::debugPerformance,"In [%s::%s Line: %d] took msecs: %lld\n",__FILE__,__FUNCTION__,__LINE__,chrono.getMillis());
 						}
 					}
 					if(canHarvestDestPos == false) {
 						if(frameIndex < 0) {
-							if(SystemFlags::getSystemSettingType(SystemFlags::debugWorldSynch).enabled == true && frameIndex < 0) {
+							if(SystemFlags::isDebugEnabled(SystemFlags::debugWorldSynch) == true && frameIndex < 0) {
 								char szBuf[8096]="";
 								snprintf(szBuf,8096,"[updateHarvest] targetPos [%s]",targetPos.getString().c_str());
 								unit->logSynchData(extractFileFromDirectoryPath(__FILE__).c_str(),__LINE__,szBuf);
@@ -1519,9 +1519,9 @@ void UnitUpdater::updateHarvest(Unit *unit, int frameIndex) {
 							unit->setLastHarvestResourceTarget(&targetPos);
 						}
 
-						if(SystemFlags::getSystemSettingType(SystemFlags::debugPerformance).enabled && chrono.getMillis() > 0) SystemFlags::OutputDebug(SystemFlags::debugPerformance,"In [%s::%s Line: %d] took msecs: %lld\n",__FILE__,__FUNCTION__,__LINE__,chrono.getMillis());
+						if(SystemFlags::isDebugEnabled(SystemFlags::debugPerformance) && chrono.getMillis() > 0) SystemFlags::OutputDebug(SystemFlags::debugPerformance,"In [%s::%s Line: %d] took msecs: %lld\n",__FILE__,__FUNCTION__,__LINE__,chrono.getMillis());
 
-						if(SystemFlags::getSystemSettingType(SystemFlags::debugWorldSynch).enabled == true && frameIndex < 0) {
+						if(SystemFlags::isDebugEnabled(SystemFlags::debugWorldSynch) == true && frameIndex < 0) {
 							char szBuf[8096]="";
 							snprintf(szBuf,8096,"[updateHarvest] unit->getPos() [%s] command->getPos() [%s]",
 									unit->getPos().getString().c_str(),command->getPos().getString().c_str());
@@ -1542,7 +1542,7 @@ void UnitUpdater::updateHarvest(Unit *unit, int frameIndex) {
 		    					throw megaglest_runtime_error("detected unsupported pathfinder type!");
 		    			}
 
-		    			if(SystemFlags::getSystemSettingType(SystemFlags::debugPerformance).enabled && chrono.getMillis() > 0) SystemFlags::OutputDebug(SystemFlags::debugPerformance,"In [%s::%s Line: %d] took msecs: %lld\n",__FILE__,__FUNCTION__,__LINE__,chrono.getMillis());
+		    			if(SystemFlags::isDebugEnabled(SystemFlags::debugPerformance) && chrono.getMillis() > 0) SystemFlags::OutputDebug(SystemFlags::debugPerformance,"In [%s::%s Line: %d] took msecs: %lld\n",__FILE__,__FUNCTION__,__LINE__,chrono.getMillis());
 
 		    			// If the unit is blocked or Even worse 'stuck' then try to
 		    			// find the same resource type elsewhere, but close by
@@ -1591,7 +1591,7 @@ void UnitUpdater::updateHarvest(Unit *unit, int frameIndex) {
 									}
 								}
 
-								if(SystemFlags::getSystemSettingType(SystemFlags::debugPerformance).enabled && chrono.getMillis() > 0) SystemFlags::OutputDebug(SystemFlags::debugPerformance,"In [%s::%s Line: %d] took msecs: %lld\n",__FILE__,__FUNCTION__,__LINE__,chrono.getMillis());
+								if(SystemFlags::isDebugEnabled(SystemFlags::debugPerformance) && chrono.getMillis() > 0) SystemFlags::OutputDebug(SystemFlags::debugPerformance,"In [%s::%s Line: %d] took msecs: %lld\n",__FILE__,__FUNCTION__,__LINE__,chrono.getMillis());
 							}
 
 							if(canHarvestDestPos == false) {
@@ -1602,7 +1602,7 @@ void UnitUpdater::updateHarvest(Unit *unit, int frameIndex) {
 								if(targetPos.x >= 0) {
 									//if not continue walking
 
-									if(SystemFlags::getSystemSettingType(SystemFlags::debugWorldSynch).enabled == true && frameIndex < 0) {
+									if(SystemFlags::isDebugEnabled(SystemFlags::debugWorldSynch) == true && frameIndex < 0) {
 										char szBuf[8096]="";
 										snprintf(szBuf,8096,"[updateHarvest #2] unit->getPos() [%s] command->getPos() [%s] targetPos [%s]",
 												unit->getPos().getString().c_str(),command->getPos().getString().c_str(),targetPos.getString().c_str());
@@ -1624,7 +1624,7 @@ void UnitUpdater::updateHarvest(Unit *unit, int frameIndex) {
 									}
 								}
 
-								if(SystemFlags::getSystemSettingType(SystemFlags::debugPerformance).enabled && chrono.getMillis() > 0) SystemFlags::OutputDebug(SystemFlags::debugPerformance,"In [%s::%s Line: %d] took msecs: %lld\n",__FILE__,__FUNCTION__,__LINE__,chrono.getMillis());
+								if(SystemFlags::isDebugEnabled(SystemFlags::debugPerformance) && chrono.getMillis() > 0) SystemFlags::OutputDebug(SystemFlags::debugPerformance,"In [%s::%s Line: %d] took msecs: %lld\n",__FILE__,__FUNCTION__,__LINE__,chrono.getMillis());
 
 				    			if(wasStuck == true && frameIndex < 0) {
 									//if can't harvest, search for another resource
@@ -1645,19 +1645,19 @@ void UnitUpdater::updateHarvest(Unit *unit, int frameIndex) {
 							unit->finishCommand();
 						}
 					}
-					if(SystemFlags::getSystemSettingType(SystemFlags::debugPerformance).enabled && chrono.getMillis() > 0) SystemFlags::OutputDebug(SystemFlags::debugPerformance,"In [%s::%s Line: %d] took msecs: %lld\n",__FILE__,__FUNCTION__,__LINE__,chrono.getMillis());
+					if(SystemFlags::isDebugEnabled(SystemFlags::debugPerformance) && chrono.getMillis() > 0) SystemFlags::OutputDebug(SystemFlags::debugPerformance,"In [%s::%s Line: %d] took msecs: %lld\n",__FILE__,__FUNCTION__,__LINE__,chrono.getMillis());
 				}
 			}
 
-			if(SystemFlags::getSystemSettingType(SystemFlags::debugPerformance).enabled && chrono.getMillis() > 0) SystemFlags::OutputDebug(SystemFlags::debugPerformance,"In [%s::%s Line: %d] took msecs: %lld\n",__FILE__,__FUNCTION__,__LINE__,chrono.getMillis());
+			if(SystemFlags::isDebugEnabled(SystemFlags::debugPerformance) && chrono.getMillis() > 0) SystemFlags::OutputDebug(SystemFlags::debugPerformance,"In [%s::%s Line: %d] took msecs: %lld\n",__FILE__,__FUNCTION__,__LINE__,chrono.getMillis());
 		}
 		else {
-			if(SystemFlags::getSystemSettingType(SystemFlags::debugPerformance).enabled && chrono.getMillis() > 0) SystemFlags::OutputDebug(SystemFlags::debugPerformance,"In [%s::%s Line: %d] took msecs: %lld\n",__FILE__,__FUNCTION__,__LINE__,chrono.getMillis());
+			if(SystemFlags::isDebugEnabled(SystemFlags::debugPerformance) && chrono.getMillis() > 0) SystemFlags::OutputDebug(SystemFlags::debugPerformance,"In [%s::%s Line: %d] took msecs: %lld\n",__FILE__,__FUNCTION__,__LINE__,chrono.getMillis());
 
 			//if loaded, return to store
 			Unit *store= world->nearestStore(unit->getPos(), unit->getFaction()->getIndex(), unit->getLoadType());
 			if(store != NULL) {
-				if(SystemFlags::getSystemSettingType(SystemFlags::debugWorldSynch).enabled == true && frameIndex < 0) {
+				if(SystemFlags::isDebugEnabled(SystemFlags::debugWorldSynch) == true && frameIndex < 0) {
 					char szBuf[8096]="";
 					snprintf(szBuf,8096,"[updateHarvest #3] unit->getPos() [%s] store->getCenteredPos() [%s]",
 							unit->getPos().getString().c_str(),store->getCenteredPos().getString().c_str());
@@ -1673,7 +1673,7 @@ void UnitUpdater::updateHarvest(Unit *unit, int frameIndex) {
 	    				throw megaglest_runtime_error("detected unsupported pathfinder type!");
 	    	    }
 
-	    		if(SystemFlags::getSystemSettingType(SystemFlags::debugPerformance).enabled && chrono.getMillis() > 0) SystemFlags::OutputDebug(SystemFlags::debugPerformance,"In [%s::%s Line: %d] took msecs: %lld\n",__FILE__,__FUNCTION__,__LINE__,chrono.getMillis());
+	    		if(SystemFlags::isDebugEnabled(SystemFlags::debugPerformance) && chrono.getMillis() > 0) SystemFlags::OutputDebug(SystemFlags::debugPerformance,"In [%s::%s Line: %d] took msecs: %lld\n",__FILE__,__FUNCTION__,__LINE__,chrono.getMillis());
 
 	    		if(frameIndex < 0) {
 					switch(tsValue) {
@@ -1722,7 +1722,7 @@ void UnitUpdater::updateHarvest(Unit *unit, int frameIndex) {
 						command->setPosToOriginalPos();
 					}
 	    		}
-	    		if(SystemFlags::getSystemSettingType(SystemFlags::debugPerformance).enabled && chrono.getMillis() > 0) SystemFlags::OutputDebug(SystemFlags::debugPerformance,"In [%s::%s Line: %d] took msecs: %lld\n",__FILE__,__FUNCTION__,__LINE__,chrono.getMillis());
+	    		if(SystemFlags::isDebugEnabled(SystemFlags::debugPerformance) && chrono.getMillis() > 0) SystemFlags::OutputDebug(SystemFlags::debugPerformance,"In [%s::%s Line: %d] took msecs: %lld\n",__FILE__,__FUNCTION__,__LINE__,chrono.getMillis());
 			}
 			else {
 				if(frameIndex < 0) {
@@ -1736,7 +1736,7 @@ void UnitUpdater::updateHarvest(Unit *unit, int frameIndex) {
 			//if working
 			//unit->setLastHarvestResourceTarget(NULL);
 
-			if(SystemFlags::getSystemSettingType(SystemFlags::debugPerformance).enabled && chrono.getMillis() > 0) SystemFlags::OutputDebug(SystemFlags::debugPerformance,"In [%s::%s Line: %d] took msecs: %lld\n",__FILE__,__FUNCTION__,__LINE__,chrono.getMillis());
+			if(SystemFlags::isDebugEnabled(SystemFlags::debugPerformance) && chrono.getMillis() > 0) SystemFlags::OutputDebug(SystemFlags::debugPerformance,"In [%s::%s Line: %d] took msecs: %lld\n",__FILE__,__FUNCTION__,__LINE__,chrono.getMillis());
 
 			const Vec2i unitTargetPos = unit->getTargetPos();
 			SurfaceCell *sc= map->getSurfaceCell(Map::toSurfCoords(unitTargetPos));
@@ -1774,7 +1774,7 @@ void UnitUpdater::updateHarvest(Unit *unit, int frameIndex) {
 					}
 					unit->getPath()->clear();
 
-					if(SystemFlags::getSystemSettingType(SystemFlags::debugPerformance).enabled && chrono.getMillis() > 0) SystemFlags::OutputDebug(SystemFlags::debugPerformance,"In [%s::%s Line: %d] took msecs: %lld\n",__FILE__,__FUNCTION__,__LINE__,chrono.getMillis());
+					if(SystemFlags::isDebugEnabled(SystemFlags::debugPerformance) && chrono.getMillis() > 0) SystemFlags::OutputDebug(SystemFlags::debugPerformance,"In [%s::%s Line: %d] took msecs: %lld\n",__FILE__,__FUNCTION__,__LINE__,chrono.getMillis());
 				}
 				else {
 					// if there is a resource, continue working, until loaded
@@ -1792,6 +1792,7 @@ void UnitUpdater::updateHarvest(Unit *unit, int frameIndex) {
 								//const ResourceType *rt = r->getType();
 								sc->deleteResource();
 								world->removeResourceTargetFromCache(unitTargetPos);
+								map->getClusterMap()->invalidate(Map::toUnitCoords(Map::toSurfCoords(unitTargetPos)), Map::cellScale);
 
 								switch(this->game->getGameSettings()->getPathFinderType()) {
 									case pfBasic:
@@ -1812,7 +1813,7 @@ void UnitUpdater::updateHarvest(Unit *unit, int frameIndex) {
 						}
 					}
 
-					if(SystemFlags::getSystemSettingType(SystemFlags::debugPerformance).enabled && chrono.getMillis() > 0) SystemFlags::OutputDebug(SystemFlags::debugPerformance,"In [%s::%s Line: %d] took msecs: %lld\n",__FILE__,__FUNCTION__,__LINE__,chrono.getMillis());
+					if(SystemFlags::isDebugEnabled(SystemFlags::debugPerformance) && chrono.getMillis() > 0) SystemFlags::OutputDebug(SystemFlags::debugPerformance,"In [%s::%s Line: %d] took msecs: %lld\n",__FILE__,__FUNCTION__,__LINE__,chrono.getMillis());
 				}
 			}
 			else {
@@ -1823,14 +1824,14 @@ void UnitUpdater::updateHarvest(Unit *unit, int frameIndex) {
 		}
 	}
 
-	if(SystemFlags::getSystemSettingType(SystemFlags::debugPerformance).enabled && chrono.getMillis() > 0) SystemFlags::OutputDebug(SystemFlags::debugPerformance,"In [%s::%s] Line: %d took msecs: %lld --------------------------- [END OF METHOD] ---------------------------\n",__FILE__,__FUNCTION__,__LINE__,chrono.getMillis());
+	if(SystemFlags::isDebugEnabled(SystemFlags::debugPerformance) && chrono.getMillis() > 0) SystemFlags::OutputDebug(SystemFlags::debugPerformance,"In [%s::%s] Line: %d took msecs: %lld --------------------------- [END OF METHOD] ---------------------------\n",__FILE__,__FUNCTION__,__LINE__,chrono.getMillis());
 
 	}
 	catch(const exception &ex) {
 		//setRunningStatus(false);
 
 		SystemFlags::OutputDebug(SystemFlags::debugError,"In [%s::%s Line: %d] Error [%s]\n",__FILE__,__FUNCTION__,__LINE__,ex.what());
-		if(SystemFlags::getSystemSettingType(SystemFlags::debugSystem).enabled) SystemFlags::OutputDebug(SystemFlags::debugSystem,"In [%s::%s Line: %d]\n",__FILE__,__FUNCTION__,__LINE__);
+		if(SystemFlags::isDebugEnabled(SystemFlags::debugSystem)) SystemFlags::OutputDebug(SystemFlags::debugSystem,"In [%s::%s Line: %d]\n",__FILE__,__FUNCTION__,__LINE__);
 
 		throw megaglest_runtime_error(ex.what());
 	}
@@ -1844,23 +1845,23 @@ void UnitUpdater::updateHarvest(Unit *unit, int frameIndex) {
 }
 
 void UnitUpdater::SwapActiveCommand(Unit *unitSrc, Unit *unitDest) {
-	if(SystemFlags::getSystemSettingType(SystemFlags::debugUnitCommands).enabled) SystemFlags::OutputDebug(SystemFlags::debugUnitCommands,"In [%s::%s Line: %d]\n",__FILE__,__FUNCTION__,__LINE__);
+	if(SystemFlags::isDebugEnabled(SystemFlags::debugUnitCommands)) SystemFlags::OutputDebug(SystemFlags::debugUnitCommands,"In [%s::%s Line: %d]\n",__FILE__,__FUNCTION__,__LINE__);
 
 	if(unitSrc->getCommandSize() > 0 && unitDest->getCommandSize() > 0) {
-		if(SystemFlags::getSystemSettingType(SystemFlags::debugUnitCommands).enabled) SystemFlags::OutputDebug(SystemFlags::debugUnitCommands,"In [%s::%s Line: %d]\n",__FILE__,__FUNCTION__,__LINE__);
+		if(SystemFlags::isDebugEnabled(SystemFlags::debugUnitCommands)) SystemFlags::OutputDebug(SystemFlags::debugUnitCommands,"In [%s::%s Line: %d]\n",__FILE__,__FUNCTION__,__LINE__);
 
 		Command *cmd1 = unitSrc->getCurrCommand();
 		Command *cmd2 = unitDest->getCurrCommand();
 		unitSrc->replaceCurrCommand(cmd2);
 		unitDest->replaceCurrCommand(cmd1);
 	}
-	if(SystemFlags::getSystemSettingType(SystemFlags::debugUnitCommands).enabled) SystemFlags::OutputDebug(SystemFlags::debugUnitCommands,"In [%s::%s Line: %d]\n",__FILE__,__FUNCTION__,__LINE__);
+	if(SystemFlags::isDebugEnabled(SystemFlags::debugUnitCommands)) SystemFlags::OutputDebug(SystemFlags::debugUnitCommands,"In [%s::%s Line: %d]\n",__FILE__,__FUNCTION__,__LINE__);
 }
 
 void UnitUpdater::SwapActiveCommandState(Unit *unit, CommandStateType commandStateType,
 										const CommandType *commandType,
 										int originalValue,int newValue) {
-	if(SystemFlags::getSystemSettingType(SystemFlags::debugUnitCommands).enabled) SystemFlags::OutputDebug(SystemFlags::debugUnitCommands,"In [%s::%s Line: %d]\n",__FILE__,__FUNCTION__,__LINE__);
+	if(SystemFlags::isDebugEnabled(SystemFlags::debugUnitCommands)) SystemFlags::OutputDebug(SystemFlags::debugUnitCommands,"In [%s::%s Line: %d]\n",__FILE__,__FUNCTION__,__LINE__);
 
 	if(commandStateType == cst_linkedUnit) {
 		if(dynamic_cast<const BuildCommandType *>(commandType) != NULL) {
@@ -1869,18 +1870,18 @@ void UnitUpdater::SwapActiveCommandState(Unit *unit, CommandStateType commandSta
 				Unit *peerUnit = unit->getFaction()->getUnit(i);
 				if(peerUnit != NULL) {
 					if(peerUnit->getCommandSize() > 0 ) {
-						if(SystemFlags::getSystemSettingType(SystemFlags::debugUnitCommands).enabled) SystemFlags::OutputDebug(SystemFlags::debugUnitCommands,"In [%s::%s Line: %d]\n",__FILE__,__FUNCTION__,__LINE__);
+						if(SystemFlags::isDebugEnabled(SystemFlags::debugUnitCommands)) SystemFlags::OutputDebug(SystemFlags::debugUnitCommands,"In [%s::%s Line: %d]\n",__FILE__,__FUNCTION__,__LINE__);
 
 						Command *peerCommand = peerUnit->getCurrCommand();
 						//const BuildCommandType *bct = dynamic_cast<const BuildCommandType*>(peerCommand->getCommandType());
 						//if(bct != NULL) {
 						if(peerCommand != NULL) {
-							if(SystemFlags::getSystemSettingType(SystemFlags::debugUnitCommands).enabled) SystemFlags::OutputDebug(SystemFlags::debugUnitCommands,"In [%s::%s Line: %d]\n",__FILE__,__FUNCTION__,__LINE__);
+							if(SystemFlags::isDebugEnabled(SystemFlags::debugUnitCommands)) SystemFlags::OutputDebug(SystemFlags::debugUnitCommands,"In [%s::%s Line: %d]\n",__FILE__,__FUNCTION__,__LINE__);
 
 							//if(command->getPos() == peerCommand->getPos()) {
 							if( peerCommand->getStateType() == commandStateType &&
 									peerCommand->getStateValue() == originalValue) {
-								if(SystemFlags::getSystemSettingType(SystemFlags::debugUnitCommands).enabled) SystemFlags::OutputDebug(SystemFlags::debugUnitCommands,"In [%s::%s Line: %d]\n",__FILE__,__FUNCTION__,__LINE__);
+								if(SystemFlags::isDebugEnabled(SystemFlags::debugUnitCommands)) SystemFlags::OutputDebug(SystemFlags::debugUnitCommands,"In [%s::%s Line: %d]\n",__FILE__,__FUNCTION__,__LINE__);
 
 								peerCommand->setStateValue(newValue);
 							}
@@ -1892,11 +1893,11 @@ void UnitUpdater::SwapActiveCommandState(Unit *unit, CommandStateType commandSta
 		}
 	}
 
-	if(SystemFlags::getSystemSettingType(SystemFlags::debugUnitCommands).enabled) SystemFlags::OutputDebug(SystemFlags::debugUnitCommands,"In [%s::%s Line: %d]\n",__FILE__,__FUNCTION__,__LINE__);
+	if(SystemFlags::isDebugEnabled(SystemFlags::debugUnitCommands)) SystemFlags::OutputDebug(SystemFlags::debugUnitCommands,"In [%s::%s Line: %d]\n",__FILE__,__FUNCTION__,__LINE__);
 }
 
 Unit * UnitUpdater::findPeerUnitBuilder(Unit *unit) {
-	if(SystemFlags::getSystemSettingType(SystemFlags::debugUnitCommands).enabled) SystemFlags::OutputDebug(SystemFlags::debugUnitCommands,"In [%s::%s Line: %d]\n",__FILE__,__FUNCTION__,__LINE__);
+	if(SystemFlags::isDebugEnabled(SystemFlags::debugUnitCommands)) SystemFlags::OutputDebug(SystemFlags::debugUnitCommands,"In [%s::%s Line: %d]\n",__FILE__,__FUNCTION__,__LINE__);
 
     Unit *foundUnitBuilder = NULL;
     if(unit->getCommandSize() > 0 ) {
@@ -1904,7 +1905,7 @@ Unit * UnitUpdater::findPeerUnitBuilder(Unit *unit) {
 		if(command != NULL) {
 			const RepairCommandType *rct= dynamic_cast<const RepairCommandType*>(command->getCommandType());
 			if(rct != NULL && command->getStateType() == cst_linkedUnit) {
-				if(SystemFlags::getSystemSettingType(SystemFlags::debugUnitCommands).enabled) SystemFlags::OutputDebug(SystemFlags::debugUnitCommands,"In [%s::%s Line: %d] looking for command->getStateValue() = %d\n",__FILE__,__FUNCTION__,__LINE__,command->getStateValue());
+				if(SystemFlags::isDebugEnabled(SystemFlags::debugUnitCommands)) SystemFlags::OutputDebug(SystemFlags::debugUnitCommands,"In [%s::%s Line: %d] looking for command->getStateValue() = %d\n",__FILE__,__FUNCTION__,__LINE__,command->getStateValue());
 
                 Unit *firstLinkedPeerRepairer = NULL;
 
@@ -1912,30 +1913,30 @@ Unit * UnitUpdater::findPeerUnitBuilder(Unit *unit) {
 					Unit *peerUnit = unit->getFaction()->getUnit(i);
 					if(peerUnit != NULL) {
 						if(peerUnit->getCommandSize() > 0 ) {
-							if(SystemFlags::getSystemSettingType(SystemFlags::debugUnitCommands).enabled) SystemFlags::OutputDebug(SystemFlags::debugUnitCommands,"In [%s::%s Line: %d]\n",__FILE__,__FUNCTION__,__LINE__);
+							if(SystemFlags::isDebugEnabled(SystemFlags::debugUnitCommands)) SystemFlags::OutputDebug(SystemFlags::debugUnitCommands,"In [%s::%s Line: %d]\n",__FILE__,__FUNCTION__,__LINE__);
 
 							Command *peerCommand = peerUnit->getCurrCommand();
 							const BuildCommandType *bct = dynamic_cast<const BuildCommandType*>(peerCommand->getCommandType());
 							if(bct != NULL) {
-								if(SystemFlags::getSystemSettingType(SystemFlags::debugUnitCommands).enabled) SystemFlags::OutputDebug(SystemFlags::debugUnitCommands,"In [%s::%s Line: %d]\n",__FILE__,__FUNCTION__,__LINE__);
+								if(SystemFlags::isDebugEnabled(SystemFlags::debugUnitCommands)) SystemFlags::OutputDebug(SystemFlags::debugUnitCommands,"In [%s::%s Line: %d]\n",__FILE__,__FUNCTION__,__LINE__);
 
 								if(command->getStateValue() == peerUnit->getId()) {
-									if(SystemFlags::getSystemSettingType(SystemFlags::debugUnitCommands).enabled) SystemFlags::OutputDebug(SystemFlags::debugUnitCommands,"In [%s::%s Line: %d]\n",__FILE__,__FUNCTION__,__LINE__);
+									if(SystemFlags::isDebugEnabled(SystemFlags::debugUnitCommands)) SystemFlags::OutputDebug(SystemFlags::debugUnitCommands,"In [%s::%s Line: %d]\n",__FILE__,__FUNCTION__,__LINE__);
 
 									foundUnitBuilder = peerUnit;
 									break;
 								}
 							}
 							else {
-								if(SystemFlags::getSystemSettingType(SystemFlags::debugUnitCommands).enabled) SystemFlags::OutputDebug(SystemFlags::debugUnitCommands,"In [%s::%s Line: %d] **peer NOT building**, peerUnit = [%s]\n",__FILE__,__FUNCTION__,__LINE__,peerUnit->toString(false).c_str());
+								if(SystemFlags::isDebugEnabled(SystemFlags::debugUnitCommands)) SystemFlags::OutputDebug(SystemFlags::debugUnitCommands,"In [%s::%s Line: %d] **peer NOT building**, peerUnit = [%s]\n",__FILE__,__FUNCTION__,__LINE__,peerUnit->toString(false).c_str());
 
 							    if(firstLinkedPeerRepairer == NULL) {
                                     const RepairCommandType *prct = dynamic_cast<const RepairCommandType*>(peerCommand->getCommandType());
                                     if(prct != NULL) {
-                                    	if(SystemFlags::getSystemSettingType(SystemFlags::debugUnitCommands).enabled) SystemFlags::OutputDebug(SystemFlags::debugUnitCommands,"In [%s::%s Line: %d]\n",__FILE__,__FUNCTION__,__LINE__);
+                                    	if(SystemFlags::isDebugEnabled(SystemFlags::debugUnitCommands)) SystemFlags::OutputDebug(SystemFlags::debugUnitCommands,"In [%s::%s Line: %d]\n",__FILE__,__FUNCTION__,__LINE__);
 
                                         if(unit->getId() != peerUnit->getId() && command->getStateValue() == peerUnit->getId()) {
-                                        	if(SystemFlags::getSystemSettingType(SystemFlags::debugUnitCommands).enabled) SystemFlags::OutputDebug(SystemFlags::debugUnitCommands,"In [%s::%s Line: %d]\n",__FILE__,__FUNCTION__,__LINE__);
+                                        	if(SystemFlags::isDebugEnabled(SystemFlags::debugUnitCommands)) SystemFlags::OutputDebug(SystemFlags::debugUnitCommands,"In [%s::%s Line: %d]\n",__FILE__,__FUNCTION__,__LINE__);
 
                                             firstLinkedPeerRepairer = peerUnit;
                                         }
@@ -1953,7 +1954,7 @@ Unit * UnitUpdater::findPeerUnitBuilder(Unit *unit) {
 		}
     }
 
-    if(SystemFlags::getSystemSettingType(SystemFlags::debugUnitCommands).enabled) SystemFlags::OutputDebug(SystemFlags::debugUnitCommands,"In [%s::%s Line: %d] returning foundUnitBuilder = [%s]\n",__FILE__,__FUNCTION__,__LINE__,(foundUnitBuilder != NULL ? foundUnitBuilder->toString(false).c_str() : "null"));
+    if(SystemFlags::isDebugEnabled(SystemFlags::debugUnitCommands)) SystemFlags::OutputDebug(SystemFlags::debugUnitCommands,"In [%s::%s Line: %d] returning foundUnitBuilder = [%s]\n",__FILE__,__FUNCTION__,__LINE__,(foundUnitBuilder != NULL ? foundUnitBuilder->toString(false).c_str() : "null"));
 
     return foundUnitBuilder;
 }
@@ -1968,19 +1969,19 @@ void UnitUpdater::updateRepair(Unit *unit, int frameIndex) {
 		clearUnitPrecache(unit);
 		return;
 	}
-	if(SystemFlags::getSystemSettingType(SystemFlags::debugWorldSynch).enabled == true && frameIndex < 0) {
+	if(SystemFlags::isDebugEnabled(SystemFlags::debugWorldSynch) == true && frameIndex < 0) {
 		char szBuf[8096]="";
 		snprintf(szBuf,8096,"[updateRepair]");
 		unit->logSynchData(extractFileFromDirectoryPath(__FILE__).c_str(),__LINE__,szBuf);
 	}
 
 	Chrono chrono;
-	if(SystemFlags::getSystemSettingType(SystemFlags::debugPerformance).enabled) chrono.start();
+	if(SystemFlags::isDebugEnabled(SystemFlags::debugPerformance)) chrono.start();
 
-	if(SystemFlags::getSystemSettingType(SystemFlags::debugUnitCommands).enabled) SystemFlags::OutputDebug(SystemFlags::debugUnitCommands,"In [%s::%s Line: %d] unit = %p\n",__FILE__,__FUNCTION__,__LINE__,unit);
+	if(SystemFlags::isDebugEnabled(SystemFlags::debugUnitCommands)) SystemFlags::OutputDebug(SystemFlags::debugUnitCommands,"In [%s::%s Line: %d] unit = %p\n",__FILE__,__FUNCTION__,__LINE__,unit);
 
 	//if(unit != NULL) {
-	if(SystemFlags::getSystemSettingType(SystemFlags::debugUnitCommands).enabled) SystemFlags::OutputDebug(SystemFlags::debugUnitCommands,"In [%s::%s Line: %d] unit doing the repair [%s] - %d\n",__FILE__,__FUNCTION__,__LINE__,unit->getFullName(false).c_str(),unit->getId());
+	if(SystemFlags::isDebugEnabled(SystemFlags::debugUnitCommands)) SystemFlags::OutputDebug(SystemFlags::debugUnitCommands,"In [%s::%s Line: %d] unit doing the repair [%s] - %d\n",__FILE__,__FUNCTION__,__LINE__,unit->getFullName(false).c_str(),unit->getId());
 	//}
     Command *command= unit->getCurrCommand();
     if(command == NULL) {
@@ -1990,7 +1991,7 @@ void UnitUpdater::updateRepair(Unit *unit, int frameIndex) {
     const RepairCommandType *rct= static_cast<const RepairCommandType*>(command->getCommandType());
     const CommandType *ct = (command != NULL ? command->getCommandType() : NULL);
 
-    if(SystemFlags::getSystemSettingType(SystemFlags::debugUnitCommands).enabled) SystemFlags::OutputDebug(SystemFlags::debugUnitCommands,"In [%s::%s Line: %d] rct = %p\n",__FILE__,__FUNCTION__,__LINE__,rct);
+    if(SystemFlags::isDebugEnabled(SystemFlags::debugUnitCommands)) SystemFlags::OutputDebug(SystemFlags::debugUnitCommands,"In [%s::%s Line: %d] rct = %p\n",__FILE__,__FUNCTION__,__LINE__,rct);
 
 	Unit *repaired = (command != NULL ? map->getCell(command->getPos())->getUnitWithEmptyCellMap(fLand) : NULL);
 	if(repaired == NULL && command != NULL) {
@@ -1998,7 +1999,7 @@ void UnitUpdater::updateRepair(Unit *unit, int frameIndex) {
 	}
 
 	if(repaired != NULL) {
-		if(SystemFlags::getSystemSettingType(SystemFlags::debugUnitCommands).enabled) SystemFlags::OutputDebug(SystemFlags::debugUnitCommands,"In [%s::%s Line: %d] unit to repair [%s] - %d\n",__FILE__,__FUNCTION__,__LINE__,repaired->getFullName(false).c_str(),repaired->getId());
+		if(SystemFlags::isDebugEnabled(SystemFlags::debugUnitCommands)) SystemFlags::OutputDebug(SystemFlags::debugUnitCommands,"In [%s::%s Line: %d] unit to repair [%s] - %d\n",__FILE__,__FUNCTION__,__LINE__,repaired->getFullName(false).c_str(),repaired->getId());
 	}
 
 	if(chrono.getMillis() > 0) SystemFlags::OutputDebug(SystemFlags::debugPerformance,"In [%s::%s] Line: %d took msecs: %lld\n",__FILE__,__FUNCTION__,__LINE__,chrono.getMillis());
@@ -2010,67 +2011,67 @@ void UnitUpdater::updateRepair(Unit *unit, int frameIndex) {
 		SystemFlags::OutputDebug(SystemFlags::debugUnitCommands,"In [%s::%s Line: %d] unit peer [%s] - %d\n",__FILE__,__FUNCTION__,__LINE__,peerUnitBuilder->getFullName(false).c_str(),peerUnitBuilder->getId());
 	}
 
-	if(SystemFlags::getSystemSettingType(SystemFlags::debugPerformance).enabled && chrono.getMillis() > 0) SystemFlags::OutputDebug(SystemFlags::debugPerformance,"In [%s::%s] Line: %d took msecs: %lld\n",__FILE__,__FUNCTION__,__LINE__,chrono.getMillis());
+	if(SystemFlags::isDebugEnabled(SystemFlags::debugPerformance) && chrono.getMillis() > 0) SystemFlags::OutputDebug(SystemFlags::debugPerformance,"In [%s::%s] Line: %d took msecs: %lld\n",__FILE__,__FUNCTION__,__LINE__,chrono.getMillis());
 
 	// Ensure we have the right unit to repair
 	if(peerUnitBuilder != NULL) {
-		if(SystemFlags::getSystemSettingType(SystemFlags::debugUnitCommands).enabled) SystemFlags::OutputDebug(SystemFlags::debugUnitCommands,"In [%s::%s Line: %d] peerUnitBuilder = %p\n",__FILE__,__FUNCTION__,__LINE__,peerUnitBuilder);
+		if(SystemFlags::isDebugEnabled(SystemFlags::debugUnitCommands)) SystemFlags::OutputDebug(SystemFlags::debugUnitCommands,"In [%s::%s Line: %d] peerUnitBuilder = %p\n",__FILE__,__FUNCTION__,__LINE__,peerUnitBuilder);
 
 		if(peerUnitBuilder->getCurrCommand()->getUnit() != NULL) {
-			if(SystemFlags::getSystemSettingType(SystemFlags::debugUnitCommands).enabled) SystemFlags::OutputDebug(SystemFlags::debugUnitCommands,"In [%s::%s Line: %d] peerbuilder's unitid = %d\n",__FILE__,__FUNCTION__,__LINE__,peerUnitBuilder->getCurrCommand()->getUnit()->getId());
+			if(SystemFlags::isDebugEnabled(SystemFlags::debugUnitCommands)) SystemFlags::OutputDebug(SystemFlags::debugUnitCommands,"In [%s::%s Line: %d] peerbuilder's unitid = %d\n",__FILE__,__FUNCTION__,__LINE__,peerUnitBuilder->getCurrCommand()->getUnit()->getId());
 			repaired = peerUnitBuilder->getCurrCommand()->getUnit();
 		}
 	}
 
 	bool nextToRepaired = repaired != NULL && map->isNextTo(unit, repaired);
 
-	if(SystemFlags::getSystemSettingType(SystemFlags::debugPerformance).enabled && chrono.getMillis() > 0) SystemFlags::OutputDebug(SystemFlags::debugPerformance,"In [%s::%s] Line: %d took msecs: %lld\n",__FILE__,__FUNCTION__,__LINE__,chrono.getMillis());
+	if(SystemFlags::isDebugEnabled(SystemFlags::debugPerformance) && chrono.getMillis() > 0) SystemFlags::OutputDebug(SystemFlags::debugPerformance,"In [%s::%s] Line: %d took msecs: %lld\n",__FILE__,__FUNCTION__,__LINE__,chrono.getMillis());
 
 	peerUnitBuilder = NULL;
 	if(repaired == NULL) {
 		peerUnitBuilder = findPeerUnitBuilder(unit);
 		if(peerUnitBuilder != NULL) {
-			if(SystemFlags::getSystemSettingType(SystemFlags::debugUnitCommands).enabled) SystemFlags::OutputDebug(SystemFlags::debugUnitCommands,"In [%s::%s Line: %d] peerUnitBuilder = %p\n",__FILE__,__FUNCTION__,__LINE__,peerUnitBuilder);
+			if(SystemFlags::isDebugEnabled(SystemFlags::debugUnitCommands)) SystemFlags::OutputDebug(SystemFlags::debugUnitCommands,"In [%s::%s Line: %d] peerUnitBuilder = %p\n",__FILE__,__FUNCTION__,__LINE__,peerUnitBuilder);
 
 			if(peerUnitBuilder->getCurrCommand()->getUnit() != NULL) {
-				if(SystemFlags::getSystemSettingType(SystemFlags::debugUnitCommands).enabled) SystemFlags::OutputDebug(SystemFlags::debugUnitCommands,"In [%s::%s Line: %d] peerbuilder's unitid = %d\n",__FILE__,__FUNCTION__,__LINE__,peerUnitBuilder->getCurrCommand()->getUnit()->getId());
+				if(SystemFlags::isDebugEnabled(SystemFlags::debugUnitCommands)) SystemFlags::OutputDebug(SystemFlags::debugUnitCommands,"In [%s::%s Line: %d] peerbuilder's unitid = %d\n",__FILE__,__FUNCTION__,__LINE__,peerUnitBuilder->getCurrCommand()->getUnit()->getId());
 				repaired = peerUnitBuilder->getCurrCommand()->getUnit();
 				nextToRepaired = repaired != NULL && map->isNextTo(unit, repaired);
 			}
 			else if(peerUnitBuilder->getCurrCommand()->getUnitType() != NULL) {
-				if(SystemFlags::getSystemSettingType(SystemFlags::debugUnitCommands).enabled) SystemFlags::OutputDebug(SystemFlags::debugUnitCommands,"In [%s::%s Line: %d]\n",__FILE__,__FUNCTION__,__LINE__);
+				if(SystemFlags::isDebugEnabled(SystemFlags::debugUnitCommands)) SystemFlags::OutputDebug(SystemFlags::debugUnitCommands,"In [%s::%s Line: %d]\n",__FILE__,__FUNCTION__,__LINE__);
 				Vec2i buildPos = map->findBestBuildApproach(unit, command->getPos(), peerUnitBuilder->getCurrCommand()->getUnitType());
 
 				//nextToRepaired= (unit->getPos() == (command->getPos()-Vec2i(1)));
 				nextToRepaired = (unit->getPos() == buildPos);
 
-				if(SystemFlags::getSystemSettingType(SystemFlags::debugUnitCommands).enabled) SystemFlags::OutputDebug(SystemFlags::debugUnitCommands,"In [%s::%s Line: %d] peerUnitBuilder = %p, nextToRepaired = %d\n",__FILE__,__FUNCTION__,__LINE__,peerUnitBuilder,nextToRepaired);
+				if(SystemFlags::isDebugEnabled(SystemFlags::debugUnitCommands)) SystemFlags::OutputDebug(SystemFlags::debugUnitCommands,"In [%s::%s Line: %d] peerUnitBuilder = %p, nextToRepaired = %d\n",__FILE__,__FUNCTION__,__LINE__,peerUnitBuilder,nextToRepaired);
 
 				if(nextToRepaired == true) {
-					if(SystemFlags::getSystemSettingType(SystemFlags::debugUnitCommands).enabled) SystemFlags::OutputDebug(SystemFlags::debugUnitCommands,"In [%s::%s Line: %d]\n",__FILE__,__FUNCTION__,__LINE__);
+					if(SystemFlags::isDebugEnabled(SystemFlags::debugUnitCommands)) SystemFlags::OutputDebug(SystemFlags::debugUnitCommands,"In [%s::%s Line: %d]\n",__FILE__,__FUNCTION__,__LINE__);
 					Command *peerCommand = peerUnitBuilder->getCurrCommand();
 					const RepairCommandType *rct = dynamic_cast<const RepairCommandType*>(peerCommand->getCommandType());
 					// If the peer is also scheduled to do a repair we CANNOT swap their commands or
 					// it will result in a stack overflow as each swaps the others repair command.
 					// We must convert this unit's repair into a build right now!
 					if(rct != NULL) {
-						if(SystemFlags::getSystemSettingType(SystemFlags::debugUnitCommands).enabled) SystemFlags::OutputDebug(SystemFlags::debugUnitCommands,"In [%s::%s Line: %d]\n",__FILE__,__FUNCTION__,__LINE__);
+						if(SystemFlags::isDebugEnabled(SystemFlags::debugUnitCommands)) SystemFlags::OutputDebug(SystemFlags::debugUnitCommands,"In [%s::%s Line: %d]\n",__FILE__,__FUNCTION__,__LINE__);
 
 						const CommandType *ctbuild = unit->getType()->getFirstCtOfClass(ccBuild);
 						NetworkCommand networkCommand(this->world,nctGiveCommand, unit->getId(), ctbuild->getId(), command->getPos(),
 														command->getUnitType()->getId(), -1, -1, CardinalDir(CardinalDir::NORTH), true, command->getStateType(),
 														command->getStateValue());
 
-						if(SystemFlags::getSystemSettingType(SystemFlags::debugUnitCommands).enabled) SystemFlags::OutputDebug(SystemFlags::debugUnitCommands,"In [%s::%s Line: %d]\n",__FILE__,__FUNCTION__,__LINE__);
+						if(SystemFlags::isDebugEnabled(SystemFlags::debugUnitCommands)) SystemFlags::OutputDebug(SystemFlags::debugUnitCommands,"In [%s::%s Line: %d]\n",__FILE__,__FUNCTION__,__LINE__);
 
 						Command* command= this->game->getCommander()->buildCommand(&networkCommand);
 						std::pair<CommandResult,string> cr= unit->checkCommand(command);
 						if(cr.first == crSuccess) {
-							if(SystemFlags::getSystemSettingType(SystemFlags::debugUnitCommands).enabled) SystemFlags::OutputDebug(SystemFlags::debugUnitCommands,"In [%s::%s Line: %d]\n",__FILE__,__FUNCTION__,__LINE__);
+							if(SystemFlags::isDebugEnabled(SystemFlags::debugUnitCommands)) SystemFlags::OutputDebug(SystemFlags::debugUnitCommands,"In [%s::%s Line: %d]\n",__FILE__,__FUNCTION__,__LINE__);
 							unit->replaceCurrCommand(command);
 						}
 						else {
-							if(SystemFlags::getSystemSettingType(SystemFlags::debugUnitCommands).enabled) SystemFlags::OutputDebug(SystemFlags::debugUnitCommands,"In [%s::%s Line: %d]\n",__FILE__,__FUNCTION__,__LINE__);
+							if(SystemFlags::isDebugEnabled(SystemFlags::debugUnitCommands)) SystemFlags::OutputDebug(SystemFlags::debugUnitCommands,"In [%s::%s Line: %d]\n",__FILE__,__FUNCTION__,__LINE__);
 							delete command;
 
 							unit->setCurrSkill(scStop);
@@ -2093,14 +2094,14 @@ void UnitUpdater::updateRepair(Unit *unit, int frameIndex) {
 					return;
 				}
 			}
-			if(SystemFlags::getSystemSettingType(SystemFlags::debugPerformance).enabled && chrono.getMillis() > 0) SystemFlags::OutputDebug(SystemFlags::debugPerformance,"In [%s::%s] Line: %d took msecs: %lld\n",__FILE__,__FUNCTION__,__LINE__,chrono.getMillis());
+			if(SystemFlags::isDebugEnabled(SystemFlags::debugPerformance) && chrono.getMillis() > 0) SystemFlags::OutputDebug(SystemFlags::debugPerformance,"In [%s::%s] Line: %d took msecs: %lld\n",__FILE__,__FUNCTION__,__LINE__,chrono.getMillis());
 		}
 	}
 	else {
-		if(SystemFlags::getSystemSettingType(SystemFlags::debugUnitCommands).enabled) SystemFlags::OutputDebug(SystemFlags::debugUnitCommands,"In [%s::%s Line: %d] unit to repair[%s]\n",__FILE__,__FUNCTION__,__LINE__,repaired->getFullName(false).c_str());
+		if(SystemFlags::isDebugEnabled(SystemFlags::debugUnitCommands)) SystemFlags::OutputDebug(SystemFlags::debugUnitCommands,"In [%s::%s Line: %d] unit to repair[%s]\n",__FILE__,__FUNCTION__,__LINE__,repaired->getFullName(false).c_str());
 	}
 
-	if(SystemFlags::getSystemSettingType(SystemFlags::debugUnitCommands).enabled) SystemFlags::OutputDebug(SystemFlags::debugUnitCommands,"In [%s::%s Line: %d] repaired = %p, nextToRepaired = %d, unit->getCurrSkill()->getClass() = %d\n",__FILE__,__FUNCTION__,__LINE__,repaired,nextToRepaired,unit->getCurrSkill()->getClass());
+	if(SystemFlags::isDebugEnabled(SystemFlags::debugUnitCommands)) SystemFlags::OutputDebug(SystemFlags::debugUnitCommands,"In [%s::%s Line: %d] repaired = %p, nextToRepaired = %d, unit->getCurrSkill()->getClass() = %d\n",__FILE__,__FUNCTION__,__LINE__,repaired,nextToRepaired,unit->getCurrSkill()->getClass());
 
 	//UnitPathInterface *path= unit->getPath();
 	if(unit->getCurrSkill()->getClass() != scRepair ||
@@ -2120,10 +2121,10 @@ void UnitUpdater::updateRepair(Unit *unit, int frameIndex) {
 //			}
 		}
 
-		if(SystemFlags::getSystemSettingType(SystemFlags::debugUnitCommands).enabled) SystemFlags::OutputDebug(SystemFlags::debugUnitCommands,"In [%s::%s Line: %d] repairPos = %s, startRepairing = %d\n",__FILE__,__FUNCTION__,__LINE__,repairPos.getString().c_str(),startRepairing);
+		if(SystemFlags::isDebugEnabled(SystemFlags::debugUnitCommands)) SystemFlags::OutputDebug(SystemFlags::debugUnitCommands,"In [%s::%s Line: %d] repairPos = %s, startRepairing = %d\n",__FILE__,__FUNCTION__,__LINE__,repairPos.getString().c_str(),startRepairing);
 
 		if(startRepairing == false && peerUnitBuilder != NULL) {
-			if(SystemFlags::getSystemSettingType(SystemFlags::debugUnitCommands).enabled) SystemFlags::OutputDebug(SystemFlags::debugUnitCommands,"In [%s::%s Line: %d]\n",__FILE__,__FUNCTION__,__LINE__);
+			if(SystemFlags::isDebugEnabled(SystemFlags::debugUnitCommands)) SystemFlags::OutputDebug(SystemFlags::debugUnitCommands,"In [%s::%s Line: %d]\n",__FILE__,__FUNCTION__,__LINE__);
 			startRepairing = true;
 			// Since the unit to be built is not yet existing we need to tell the
 			// other units to move to the build position or else they get in the way
@@ -2134,23 +2135,23 @@ void UnitUpdater::updateRepair(Unit *unit, int frameIndex) {
 
         //if not repairing
         if(startRepairing == true) {
-        	if(SystemFlags::getSystemSettingType(SystemFlags::debugUnitCommands).enabled) SystemFlags::OutputDebug(SystemFlags::debugUnitCommands,"In [%s::%s Line: %d]\n",__FILE__,__FUNCTION__,__LINE__);
+        	if(SystemFlags::isDebugEnabled(SystemFlags::debugUnitCommands)) SystemFlags::OutputDebug(SystemFlags::debugUnitCommands,"In [%s::%s Line: %d]\n",__FILE__,__FUNCTION__,__LINE__);
 
 			if(nextToRepaired == true) {
-				if(SystemFlags::getSystemSettingType(SystemFlags::debugUnitCommands).enabled) SystemFlags::OutputDebug(SystemFlags::debugUnitCommands,"In [%s::%s Line: %d]\n",__FILE__,__FUNCTION__,__LINE__);
+				if(SystemFlags::isDebugEnabled(SystemFlags::debugUnitCommands)) SystemFlags::OutputDebug(SystemFlags::debugUnitCommands,"In [%s::%s Line: %d]\n",__FILE__,__FUNCTION__,__LINE__);
 				unit->setTarget(repaired);
 				unit->setCurrSkill(rct->getRepairSkillType());
 			}
 			else {
-				if(SystemFlags::getSystemSettingType(SystemFlags::debugUnitCommands).enabled) SystemFlags::OutputDebug(SystemFlags::debugUnitCommands,"In [%s::%s Line: %d]\n",__FILE__,__FUNCTION__,__LINE__);
+				if(SystemFlags::isDebugEnabled(SystemFlags::debugUnitCommands)) SystemFlags::OutputDebug(SystemFlags::debugUnitCommands,"In [%s::%s Line: %d]\n",__FILE__,__FUNCTION__,__LINE__);
 
-				if(SystemFlags::getSystemSettingType(SystemFlags::debugWorldSynch).enabled == true && frameIndex < 0) {
+				if(SystemFlags::isDebugEnabled(SystemFlags::debugWorldSynch) == true && frameIndex < 0) {
 					char szBuf[8096]="";
 					snprintf(szBuf,8096,"[updateRepair] unit->getPos() [%s] command->getPos()() [%s] repairPos [%s]",unit->getPos().getString().c_str(),command->getPos().getString().c_str(),repairPos.getString().c_str());
 					unit->logSynchData(__FILE__,__LINE__,szBuf);
 				}
 
-				if(SystemFlags::getSystemSettingType(SystemFlags::debugPerformance).enabled && chrono.getMillis() > 0) SystemFlags::OutputDebug(SystemFlags::debugPerformance,"In [%s::%s] Line: %d took msecs: %lld\n",__FILE__,__FUNCTION__,__LINE__,chrono.getMillis());
+				if(SystemFlags::isDebugEnabled(SystemFlags::debugPerformance) && chrono.getMillis() > 0) SystemFlags::OutputDebug(SystemFlags::debugPerformance,"In [%s::%s] Line: %d took msecs: %lld\n",__FILE__,__FUNCTION__,__LINE__,chrono.getMillis());
 
 				// If the repair command has no move skill and we are not next to
 				// the unit we cannot repair it
@@ -2170,7 +2171,7 @@ void UnitUpdater::updateRepair(Unit *unit, int frameIndex) {
 					TravelState ts;
 					switch(this->game->getGameSettings()->getPathFinderType()) {
 						case pfBasic:
-							if(SystemFlags::getSystemSettingType(SystemFlags::debugUnitCommands).enabled) SystemFlags::OutputDebug(SystemFlags::debugUnitCommands,"In [%s::%s Line: %d]\n",__FILE__,__FUNCTION__,__LINE__);
+							if(SystemFlags::isDebugEnabled(SystemFlags::debugUnitCommands)) SystemFlags::OutputDebug(SystemFlags::debugUnitCommands,"In [%s::%s Line: %d]\n",__FILE__,__FUNCTION__,__LINE__);
 
 							ts = pathFinder->findPath(unit, repairPos, NULL, frameIndex);
 							break;
@@ -2178,22 +2179,22 @@ void UnitUpdater::updateRepair(Unit *unit, int frameIndex) {
 							throw megaglest_runtime_error("detected unsupported pathfinder type!");
 					}
 
-					if(SystemFlags::getSystemSettingType(SystemFlags::debugUnitCommands).enabled) SystemFlags::OutputDebug(SystemFlags::debugUnitCommands,"In [%s::%s Line: %d] ts = %d\n",__FILE__,__FUNCTION__,__LINE__,ts);
+					if(SystemFlags::isDebugEnabled(SystemFlags::debugUnitCommands)) SystemFlags::OutputDebug(SystemFlags::debugUnitCommands,"In [%s::%s Line: %d] ts = %d\n",__FILE__,__FUNCTION__,__LINE__,ts);
 
-					if(SystemFlags::getSystemSettingType(SystemFlags::debugPerformance).enabled && chrono.getMillis() > 0) SystemFlags::OutputDebug(SystemFlags::debugPerformance,"In [%s::%s] Line: %d took msecs: %lld\n",__FILE__,__FUNCTION__,__LINE__,chrono.getMillis());
+					if(SystemFlags::isDebugEnabled(SystemFlags::debugPerformance) && chrono.getMillis() > 0) SystemFlags::OutputDebug(SystemFlags::debugPerformance,"In [%s::%s] Line: %d took msecs: %lld\n",__FILE__,__FUNCTION__,__LINE__,chrono.getMillis());
 
 					switch(ts) {
 					case tsMoving:
-						if(SystemFlags::getSystemSettingType(SystemFlags::debugUnitCommands).enabled) SystemFlags::OutputDebug(SystemFlags::debugUnitCommands,"In [%s::%s Line: %d] tsMoving\n",__FILE__,__FUNCTION__,__LINE__);
+						if(SystemFlags::isDebugEnabled(SystemFlags::debugUnitCommands)) SystemFlags::OutputDebug(SystemFlags::debugUnitCommands,"In [%s::%s Line: %d] tsMoving\n",__FILE__,__FUNCTION__,__LINE__);
 						unit->setCurrSkill(rct->getMoveSkillType());
 						break;
 					case tsBlocked:
-						if(SystemFlags::getSystemSettingType(SystemFlags::debugUnitCommands).enabled) SystemFlags::OutputDebug(SystemFlags::debugUnitCommands,"In [%s::%s Line: %d] tsBlocked\n",__FILE__,__FUNCTION__,__LINE__);
+						if(SystemFlags::isDebugEnabled(SystemFlags::debugUnitCommands)) SystemFlags::OutputDebug(SystemFlags::debugUnitCommands,"In [%s::%s Line: %d] tsBlocked\n",__FILE__,__FUNCTION__,__LINE__);
 						if(unit->getPath()->isBlocked()) {
-							if(SystemFlags::getSystemSettingType(SystemFlags::debugUnitCommands).enabled) SystemFlags::OutputDebug(SystemFlags::debugUnitCommands,"In [%s::%s Line: %d] about to call [scStop]\n",__FILE__,__FUNCTION__,__LINE__);
+							if(SystemFlags::isDebugEnabled(SystemFlags::debugUnitCommands)) SystemFlags::OutputDebug(SystemFlags::debugUnitCommands,"In [%s::%s Line: %d] about to call [scStop]\n",__FILE__,__FUNCTION__,__LINE__);
 
 							if(unit->getRetryCurrCommandCount() > 0) {
-								if(SystemFlags::getSystemSettingType(SystemFlags::debugUnitCommands).enabled) SystemFlags::OutputDebug(SystemFlags::debugUnitCommands,"In [%s::%s Line: %d] will retry command, unit->getRetryCurrCommandCount() = %d\n",__FILE__,__FUNCTION__,__LINE__,unit->getRetryCurrCommandCount());
+								if(SystemFlags::isDebugEnabled(SystemFlags::debugUnitCommands)) SystemFlags::OutputDebug(SystemFlags::debugUnitCommands,"In [%s::%s Line: %d] will retry command, unit->getRetryCurrCommandCount() = %d\n",__FILE__,__FUNCTION__,__LINE__,unit->getRetryCurrCommandCount());
 								unit->setRetryCurrCommandCount(0);
 								unit->getPath()->clear();
 								updateUnitCommand(unit,-1);
@@ -2210,20 +2211,20 @@ void UnitUpdater::updateRepair(Unit *unit, int frameIndex) {
 			}
         }
         else {
-        	if(SystemFlags::getSystemSettingType(SystemFlags::debugUnitCommands).enabled) SystemFlags::OutputDebug(SystemFlags::debugUnitCommands,"In [%s::%s Line: %d] about to call [scStop]\n",__FILE__,__FUNCTION__,__LINE__);
+        	if(SystemFlags::isDebugEnabled(SystemFlags::debugUnitCommands)) SystemFlags::OutputDebug(SystemFlags::debugUnitCommands,"In [%s::%s Line: %d] about to call [scStop]\n",__FILE__,__FUNCTION__,__LINE__);
 
         	//console->addStdMessage("InvalidPosition");
        		unit->setCurrSkill(scStop);
        		unit->finishCommand();
-       		if(SystemFlags::getSystemSettingType(SystemFlags::debugPerformance).enabled && chrono.getMillis() > 0) SystemFlags::OutputDebug(SystemFlags::debugPerformance,"In [%s::%s] Line: %d took msecs: %lld\n",__FILE__,__FUNCTION__,__LINE__,chrono.getMillis());
+       		if(SystemFlags::isDebugEnabled(SystemFlags::debugPerformance) && chrono.getMillis() > 0) SystemFlags::OutputDebug(SystemFlags::debugPerformance,"In [%s::%s] Line: %d took msecs: %lld\n",__FILE__,__FUNCTION__,__LINE__,chrono.getMillis());
         }
     }
     else {
-    	if(SystemFlags::getSystemSettingType(SystemFlags::debugUnitCommands).enabled) SystemFlags::OutputDebug(SystemFlags::debugUnitCommands,"In [%s::%s Line: %d]\n",__FILE__,__FUNCTION__,__LINE__);
+    	if(SystemFlags::isDebugEnabled(SystemFlags::debugUnitCommands)) SystemFlags::OutputDebug(SystemFlags::debugUnitCommands,"In [%s::%s Line: %d]\n",__FILE__,__FUNCTION__,__LINE__);
 		bool cancelRepair = false;
     	//if repairing
 		if(repaired != NULL) {
-			if(SystemFlags::getSystemSettingType(SystemFlags::debugUnitCommands).enabled) SystemFlags::OutputDebug(SystemFlags::debugUnitCommands,"In [%s::%s Line: %d]\n",__FILE__,__FUNCTION__,__LINE__);
+			if(SystemFlags::isDebugEnabled(SystemFlags::debugUnitCommands)) SystemFlags::OutputDebug(SystemFlags::debugUnitCommands,"In [%s::%s Line: %d]\n",__FILE__,__FUNCTION__,__LINE__);
 			// Check if we can still repair the unit (may have morphed, etc)
 			bool canStillRepair = rct->isRepairableUnitType(repaired->getType());
 			if(canStillRepair == true) {
@@ -2242,33 +2243,33 @@ void UnitUpdater::updateRepair(Unit *unit, int frameIndex) {
 			}
 		}
 		else if(peerUnitBuilder != NULL) {
-			if(SystemFlags::getSystemSettingType(SystemFlags::debugUnitCommands).enabled) SystemFlags::OutputDebug(SystemFlags::debugUnitCommands,"In [%s::%s Line: %d]\n",__FILE__,__FUNCTION__,__LINE__);
+			if(SystemFlags::isDebugEnabled(SystemFlags::debugUnitCommands)) SystemFlags::OutputDebug(SystemFlags::debugUnitCommands,"In [%s::%s Line: %d]\n",__FILE__,__FUNCTION__,__LINE__);
 			unit->setTargetPos(command->getPos());
 		}
 
 		if(cancelRepair == false && (repaired == NULL || repaired->repair()) &&
 			peerUnitBuilder == NULL) {
-			if(SystemFlags::getSystemSettingType(SystemFlags::debugUnitCommands).enabled) SystemFlags::OutputDebug(SystemFlags::debugUnitCommands,"In [%s::%s Line: %d] about to call [scStop]\n",__FILE__,__FUNCTION__,__LINE__);
+			if(SystemFlags::isDebugEnabled(SystemFlags::debugUnitCommands)) SystemFlags::OutputDebug(SystemFlags::debugUnitCommands,"In [%s::%s Line: %d] about to call [scStop]\n",__FILE__,__FUNCTION__,__LINE__);
 
 			unit->setCurrSkill(scStop);
 			unit->finishCommand();
 
 			if(repaired != NULL && repaired->isBuilt() == false) {
-				if(SystemFlags::getSystemSettingType(SystemFlags::debugUnitCommands).enabled) SystemFlags::OutputDebug(SystemFlags::debugUnitCommands,"In [%s::%s Line: %d]\n",__FILE__,__FUNCTION__,__LINE__);
+				if(SystemFlags::isDebugEnabled(SystemFlags::debugUnitCommands)) SystemFlags::OutputDebug(SystemFlags::debugUnitCommands,"In [%s::%s Line: %d]\n",__FILE__,__FUNCTION__,__LINE__);
 				repaired->born(ct);
 				scriptManager->onUnitCreated(repaired);
 			}
-			if(SystemFlags::getSystemSettingType(SystemFlags::debugPerformance).enabled && chrono.getMillis() > 0) SystemFlags::OutputDebug(SystemFlags::debugPerformance,"In [%s::%s] Line: %d took msecs: %lld\n",__FILE__,__FUNCTION__,__LINE__,chrono.getMillis());
+			if(SystemFlags::isDebugEnabled(SystemFlags::debugPerformance) && chrono.getMillis() > 0) SystemFlags::OutputDebug(SystemFlags::debugPerformance,"In [%s::%s] Line: %d took msecs: %lld\n",__FILE__,__FUNCTION__,__LINE__,chrono.getMillis());
 		}
     }
-	if(SystemFlags::getSystemSettingType(SystemFlags::debugPerformance).enabled && chrono.getMillis() > 0) SystemFlags::OutputDebug(SystemFlags::debugPerformance,"In [%s::%s] Line: %d took msecs: %lld --------------------------- [END OF METHOD] ---------------------------\n",__FILE__,__FUNCTION__,__LINE__,chrono.getMillis());
+	if(SystemFlags::isDebugEnabled(SystemFlags::debugPerformance) && chrono.getMillis() > 0) SystemFlags::OutputDebug(SystemFlags::debugPerformance,"In [%s::%s] Line: %d took msecs: %lld --------------------------- [END OF METHOD] ---------------------------\n",__FILE__,__FUNCTION__,__LINE__,chrono.getMillis());
 
 	}
 	catch(const exception &ex) {
 		//setRunningStatus(false);
 
 		SystemFlags::OutputDebug(SystemFlags::debugError,"In [%s::%s Line: %d] Error [%s]\n",__FILE__,__FUNCTION__,__LINE__,ex.what());
-		if(SystemFlags::getSystemSettingType(SystemFlags::debugSystem).enabled) SystemFlags::OutputDebug(SystemFlags::debugSystem,"In [%s::%s Line: %d]\n",__FILE__,__FUNCTION__,__LINE__);
+		if(SystemFlags::isDebugEnabled(SystemFlags::debugSystem)) SystemFlags::OutputDebug(SystemFlags::debugSystem,"In [%s::%s Line: %d]\n",__FILE__,__FUNCTION__,__LINE__);
 
 		throw megaglest_runtime_error(ex.what());
 	}
@@ -2291,14 +2292,14 @@ void UnitUpdater::updateProduce(Unit *unit, int frameIndex) {
 		clearUnitPrecache(unit);
 		return;
 	}
-	if(SystemFlags::getSystemSettingType(SystemFlags::debugWorldSynch).enabled == true && frameIndex < 0) {
+	if(SystemFlags::isDebugEnabled(SystemFlags::debugWorldSynch) == true && frameIndex < 0) {
 		char szBuf[8096]="";
 		snprintf(szBuf,8096,"[updateProduce]");
 		unit->logSynchData(extractFileFromDirectoryPath(__FILE__).c_str(),__LINE__,szBuf);
 	}
 
 	Chrono chrono;
-	if(SystemFlags::getSystemSettingType(SystemFlags::debugPerformance).enabled) chrono.start();
+	if(SystemFlags::isDebugEnabled(SystemFlags::debugPerformance)) chrono.start();
 
     Command *command= unit->getCurrCommand();
 	if(command == NULL) {
@@ -2317,7 +2318,7 @@ void UnitUpdater::updateProduce(Unit *unit, int frameIndex) {
 
 		unit->update2();
 
-		if(SystemFlags::getSystemSettingType(SystemFlags::debugPerformance).enabled && chrono.getMillis() > 0) SystemFlags::OutputDebug(SystemFlags::debugPerformance,"In [%s::%s] Line: %d took msecs: %lld\n",__FILE__,__FUNCTION__,__LINE__,chrono.getMillis());
+		if(SystemFlags::isDebugEnabled(SystemFlags::debugPerformance) && chrono.getMillis() > 0) SystemFlags::OutputDebug(SystemFlags::debugPerformance,"In [%s::%s] Line: %d took msecs: %lld\n",__FILE__,__FUNCTION__,__LINE__,chrono.getMillis());
 
         if(unit->getProgress2() > pct->getProduced()->getProductionTime()){
             unit->finishCommand();
@@ -2334,13 +2335,13 @@ void UnitUpdater::updateProduce(Unit *unit, int frameIndex) {
 
 			produced= new Unit(world->getNextUnitId(unit->getFaction()), newpath, Vec2i(0), pct->getProducedUnit(), unit->getFaction(), world->getMap(), CardinalDir(CardinalDir::NORTH));
 
-			if(SystemFlags::getSystemSettingType(SystemFlags::debugUnitCommands).enabled) SystemFlags::OutputDebug(SystemFlags::debugUnitCommands,"In [%s::%s Line: %d] about to place unit for unit [%s]\n",__FILE__,__FUNCTION__,__LINE__,produced->toString(false).c_str());
+			if(SystemFlags::isDebugEnabled(SystemFlags::debugUnitCommands)) SystemFlags::OutputDebug(SystemFlags::debugUnitCommands,"In [%s::%s Line: %d] about to place unit for unit [%s]\n",__FILE__,__FUNCTION__,__LINE__,produced->toString(false).c_str());
 
-			if(SystemFlags::getSystemSettingType(SystemFlags::debugPerformance).enabled && chrono.getMillis() > 0) SystemFlags::OutputDebug(SystemFlags::debugPerformance,"In [%s::%s] Line: %d took msecs: %lld\n",__FILE__,__FUNCTION__,__LINE__,chrono.getMillis());
+			if(SystemFlags::isDebugEnabled(SystemFlags::debugPerformance) && chrono.getMillis() > 0) SystemFlags::OutputDebug(SystemFlags::debugPerformance,"In [%s::%s] Line: %d took msecs: %lld\n",__FILE__,__FUNCTION__,__LINE__,chrono.getMillis());
 
 			//place unit creates the unit
 			if(!world->placeUnit(unit->getCenteredPos(), 10, produced, false, frameIndex < 0)) {
-				if(SystemFlags::getSystemSettingType(SystemFlags::debugUnitCommands).enabled) SystemFlags::OutputDebug(SystemFlags::debugUnitCommands,"In [%s::%s Line: %d] COULD NOT PLACE UNIT for unitID [%d]\n",__FILE__,__FUNCTION__,__LINE__,produced->getId());
+				if(SystemFlags::isDebugEnabled(SystemFlags::debugUnitCommands)) SystemFlags::OutputDebug(SystemFlags::debugUnitCommands,"In [%s::%s Line: %d] COULD NOT PLACE UNIT for unitID [%d]\n",__FILE__,__FUNCTION__,__LINE__,produced->getId());
 				delete produced;
 			}
 			else{
@@ -2350,24 +2351,24 @@ void UnitUpdater::updateProduce(Unit *unit, int frameIndex) {
 				world->getStats()->produce(unit->getFactionIndex(),produced->getType()->getCountUnitProductionInStats());
 				const CommandType *ct= produced->computeCommandType(unit->getMeetingPos());
 				if(ct != NULL) {
-					if(SystemFlags::getSystemSettingType(SystemFlags::debugUnitCommands).enabled) SystemFlags::OutputDebug(SystemFlags::debugUnitCommands,"In [%s::%s Line: %d]\n",__FILE__,__FUNCTION__,__LINE__);
+					if(SystemFlags::isDebugEnabled(SystemFlags::debugUnitCommands)) SystemFlags::OutputDebug(SystemFlags::debugUnitCommands,"In [%s::%s Line: %d]\n",__FILE__,__FUNCTION__,__LINE__);
 					produced->giveCommand(new Command(ct, unit->getMeetingPos()));
 				}
 				scriptManager->onUnitCreated(produced);
 
-				if(SystemFlags::getSystemSettingType(SystemFlags::debugPerformance).enabled && chrono.getMillis() > 0) SystemFlags::OutputDebug(SystemFlags::debugPerformance,"In [%s::%s] Line: %d took msecs: %lld\n",__FILE__,__FUNCTION__,__LINE__,chrono.getMillis());
+				if(SystemFlags::isDebugEnabled(SystemFlags::debugPerformance) && chrono.getMillis() > 0) SystemFlags::OutputDebug(SystemFlags::debugPerformance,"In [%s::%s] Line: %d took msecs: %lld\n",__FILE__,__FUNCTION__,__LINE__,chrono.getMillis());
 			}
         }
     }
 
-    if(SystemFlags::getSystemSettingType(SystemFlags::debugPerformance).enabled && chrono.getMillis() > 0) SystemFlags::OutputDebug(SystemFlags::debugPerformance,"In [%s::%s] Line: %d took msecs: %lld --------------------------- [END OF METHOD] ---------------------------\n",__FILE__,__FUNCTION__,__LINE__,chrono.getMillis());
+    if(SystemFlags::isDebugEnabled(SystemFlags::debugPerformance) && chrono.getMillis() > 0) SystemFlags::OutputDebug(SystemFlags::debugPerformance,"In [%s::%s] Line: %d took msecs: %lld --------------------------- [END OF METHOD] ---------------------------\n",__FILE__,__FUNCTION__,__LINE__,chrono.getMillis());
 
 	}
 	catch(const exception &ex) {
 		//setRunningStatus(false);
 
 		SystemFlags::OutputDebug(SystemFlags::debugError,"In [%s::%s Line: %d] Error [%s]\n",__FILE__,__FUNCTION__,__LINE__,ex.what());
-		if(SystemFlags::getSystemSettingType(SystemFlags::debugSystem).enabled) SystemFlags::OutputDebug(SystemFlags::debugSystem,"In [%s::%s Line: %d]\n",__FILE__,__FUNCTION__,__LINE__);
+		if(SystemFlags::isDebugEnabled(SystemFlags::debugSystem)) SystemFlags::OutputDebug(SystemFlags::debugSystem,"In [%s::%s Line: %d]\n",__FILE__,__FUNCTION__,__LINE__);
 
 		throw megaglest_runtime_error(ex.what());
 	}
@@ -2391,14 +2392,14 @@ void UnitUpdater::updateUpgrade(Unit *unit, int frameIndex) {
 		clearUnitPrecache(unit);
 		return;
 	}
-	if(SystemFlags::getSystemSettingType(SystemFlags::debugWorldSynch).enabled == true && frameIndex < 0) {
+	if(SystemFlags::isDebugEnabled(SystemFlags::debugWorldSynch) == true && frameIndex < 0) {
 		char szBuf[8096]="";
 		snprintf(szBuf,8096,"[updateUpgrade]");
 		unit->logSynchData(extractFileFromDirectoryPath(__FILE__).c_str(),__LINE__,szBuf);
 	}
 
 	Chrono chrono;
-	if(SystemFlags::getSystemSettingType(SystemFlags::debugPerformance).enabled) chrono.start();
+	if(SystemFlags::isDebugEnabled(SystemFlags::debugPerformance)) chrono.start();
 
     Command *command= unit->getCurrCommand();
 	if(command == NULL) {
@@ -2421,14 +2422,14 @@ void UnitUpdater::updateUpgrade(Unit *unit, int frameIndex) {
         }
     }
 
-	if(SystemFlags::getSystemSettingType(SystemFlags::debugPerformance).enabled && chrono.getMillis() > 0) SystemFlags::OutputDebug(SystemFlags::debugPerformance,"In [%s::%s] Line: %d took msecs: %lld --------------------------- [END OF METHOD] ---------------------------\n",__FILE__,__FUNCTION__,__LINE__,chrono.getMillis());
+	if(SystemFlags::isDebugEnabled(SystemFlags::debugPerformance) && chrono.getMillis() > 0) SystemFlags::OutputDebug(SystemFlags::debugPerformance,"In [%s::%s] Line: %d took msecs: %lld --------------------------- [END OF METHOD] ---------------------------\n",__FILE__,__FUNCTION__,__LINE__,chrono.getMillis());
 
 	}
 	catch(const exception &ex) {
 		//setRunningStatus(false);
 
 		SystemFlags::OutputDebug(SystemFlags::debugError,"In [%s::%s Line: %d] Error [%s]\n",__FILE__,__FUNCTION__,__LINE__,ex.what());
-		if(SystemFlags::getSystemSettingType(SystemFlags::debugSystem).enabled) SystemFlags::OutputDebug(SystemFlags::debugSystem,"In [%s::%s Line: %d]\n",__FILE__,__FUNCTION__,__LINE__);
+		if(SystemFlags::isDebugEnabled(SystemFlags::debugSystem)) SystemFlags::OutputDebug(SystemFlags::debugSystem,"In [%s::%s Line: %d]\n",__FILE__,__FUNCTION__,__LINE__);
 
 		throw megaglest_runtime_error(ex.what());
 	}
@@ -2451,14 +2452,14 @@ void UnitUpdater::updateMorph(Unit *unit, int frameIndex) {
 		clearUnitPrecache(unit);
 		return;
 	}
-	if(SystemFlags::getSystemSettingType(SystemFlags::debugWorldSynch).enabled == true && frameIndex < 0) {
+	if(SystemFlags::isDebugEnabled(SystemFlags::debugWorldSynch) == true && frameIndex < 0) {
 		char szBuf[8096]="";
 		snprintf(szBuf,8096,"[updateMorph]");
 		unit->logSynchData(extractFileFromDirectoryPath(__FILE__).c_str(),__LINE__,szBuf);
 	}
 
 	Chrono chrono;
-	if(SystemFlags::getSystemSettingType(SystemFlags::debugPerformance).enabled) chrono.start();
+	if(SystemFlags::isDebugEnabled(SystemFlags::debugPerformance)) chrono.start();
 
 	Command *command= unit->getCurrCommand();
 	if(command == NULL) {
@@ -2520,14 +2521,14 @@ void UnitUpdater::updateMorph(Unit *unit, int frameIndex) {
         }
     }
 
-    if(SystemFlags::getSystemSettingType(SystemFlags::debugPerformance).enabled && chrono.getMillis() > 0) SystemFlags::OutputDebug(SystemFlags::debugPerformance,"In [%s::%s] Line: %d took msecs: %lld --------------------------- [END OF METHOD] ---------------------------\n",__FILE__,__FUNCTION__,__LINE__,chrono.getMillis());
+    if(SystemFlags::isDebugEnabled(SystemFlags::debugPerformance) && chrono.getMillis() > 0) SystemFlags::OutputDebug(SystemFlags::debugPerformance,"In [%s::%s] Line: %d took msecs: %lld --------------------------- [END OF METHOD] ---------------------------\n",__FILE__,__FUNCTION__,__LINE__,chrono.getMillis());
 
 	}
 	catch(const exception &ex) {
 		//setRunningStatus(false);
 
 		SystemFlags::OutputDebug(SystemFlags::debugError,"In [%s::%s Line: %d] Error [%s]\n",__FILE__,__FUNCTION__,__LINE__,ex.what());
-		if(SystemFlags::getSystemSettingType(SystemFlags::debugSystem).enabled) SystemFlags::OutputDebug(SystemFlags::debugSystem,"In [%s::%s Line: %d]\n",__FILE__,__FUNCTION__,__LINE__);
+		if(SystemFlags::isDebugEnabled(SystemFlags::debugSystem)) SystemFlags::OutputDebug(SystemFlags::debugSystem,"In [%s::%s Line: %d]\n",__FILE__,__FUNCTION__,__LINE__);
 
 		throw megaglest_runtime_error(ex.what());
 	}
@@ -2804,42 +2805,56 @@ bool UnitUpdater::attackableOnRange(Unit *unit, Unit **rangedPtr, const AttackSk
 	return unitOnRange(unit, range, rangedPtr, ast, evalMode);
 }
 
-bool UnitUpdater::findCachedCellsEnemies(Vec2i center, int range, int size, vector<Unit*> &enemies,
-										 const AttackSkillType *ast, const Unit *unit,
-										 const Unit *commandTarget) {
-	bool result = false;
-	MutexSafeWrapper safeMutex(mutexUnitRangeCellsLookupItemCache,string(__FILE__) + "_" + intToStr(__LINE__));
-	std::map<Vec2i, std::map<int, std::map<int, UnitRangeCellsLookupItem > > >::iterator iterFind = UnitRangeCellsLookupItemCache.find(center);
-
-	if(iterFind != UnitRangeCellsLookupItemCache.end()) {
-		std::map<int, std::map<int, UnitRangeCellsLookupItem > >::iterator iterFind3 = iterFind->second.find(size);
-		if(iterFind3 != iterFind->second.end()) {
-			std::map<int, UnitRangeCellsLookupItem>::iterator iterFind4 = iterFind3->second.find(range);
-			if(iterFind4 != iterFind3->second.end()) {
-				result = true;
-
-				std::vector<Cell *> &cellList = iterFind4->second.rangeCellList;
-				for(int idx = 0; idx < (int)cellList.size(); ++idx) {
-					Cell *cell = cellList[idx];
-
-					findEnemiesForCell(ast,cell,unit,commandTarget,enemies);
+// Every field of every cell in [minPos, maxPos] holding a unit, in the order
+// a column by column scan of the area visits them. Units of factions that
+// can't be picked (allies, or anyone but the command target) are skipped
+// whole through the map's unit grid.
+void UnitUpdater::findUnitCellsInArea(const Vec2i &minPos, const Vec2i &maxPos, Faction *faction,
+									  const Unit *commandTarget, vector<UnitCellRef> &unitCells) const {
+	for(int factionIndex = 0; factionIndex < world->getFactionCount(); ++factionIndex) {
+		Faction *otherFaction = world->getFaction(factionIndex);
+		if(faction != NULL) {
+			if(commandTarget != NULL) {
+				if(commandTarget->getFaction() != otherFaction) {
+					continue;
 				}
 			}
+			else if(faction->isAlly(otherFaction) == true) {
+				continue;
+			}
 		}
+		map->findUnitCells(otherFaction->getIndex(), minPos, maxPos, unitCells);
 	}
-
-	return result;
+	std::sort(unitCells.begin(), unitCells.end());
 }
 
-void UnitUpdater::findEnemiesForCell(const AttackSkillType *ast, Cell *cell, const Unit *unit,
-									 const Unit *commandTarget,vector<Unit*> &enemies) {
-	//all fields
-	for(int k = 0; k < fieldCount; k++) {
-		Field f= static_cast<Field>(k);
+void UnitUpdater::findUnitCellsInRange(const Vec2i &center, const Vec2f &floatCenter, int range, int size,
+									   Faction *faction, const Unit *commandTarget, vector<UnitCellRef> &unitCells) const {
+	vector<UnitCellRef> areaCells;
+	findUnitCellsInArea(Vec2i(center.x - range, center.y - range),
+						Vec2i(center.x + range + size - 1, center.y + range + size - 1),
+						faction, commandTarget, areaCells);
+
+	for(unsigned int index = 0; index < areaCells.size(); ++index) {
+		const Vec2i &pos = areaCells[index].pos;
+		//cells in range
+#ifdef USE_STREFLOP
+		if(streflop::floor(static_cast<streflop::Simple>(floatCenter.dist(Vec2f((float)pos.x, (float)pos.y)))) <= (range+1))
+#else
+		if(floor(floatCenter.dist(Vec2f((float)pos.x, (float)pos.y))) <= (range+1))
+#endif
+		{
+			unitCells.push_back(areaCells[index]);
+		}
+	}
+}
 
+void UnitUpdater::findEnemiesForUnitCells(const AttackSkillType *ast, const vector<UnitCellRef> &unitCells, const Unit *unit,
+										  const Unit *commandTarget, vector<Unit*> &enemies) {
+	for(unsigned int index = 0; index < unitCells.size(); ++index) {
 		//check field
-		if((ast == NULL || ast->getAttackField(f))) {
-			Unit *possibleEnemy = cell->getUnit(f);
+		if((ast == NULL || ast->getAttackField(unitCells[index].field))) {
+			Unit *possibleEnemy = unitCells[index].unit;
 
 			//check enemy
 			if(possibleEnemy != NULL && possibleEnemy->isAlive()) {
@@ -2854,32 +2869,33 @@ void UnitUpdater::findEnemiesForCell(const AttackSkillType *ast, Cell *cell, con
 }
 
 void UnitUpdater::findEnemiesForCell(const Vec2i pos, int size, int sightRange, const Faction *faction, vector<Unit*> &enemies, bool attackersOnly) const {
+	vector<UnitCellRef> unitCells;
+	findUnitCellsInArea(Vec2i(pos.x - sightRange, pos.y - sightRange),
+						Vec2i(pos.x + size + sightRange - 1, pos.y + size + sightRange - 1),
+						NULL, NULL, unitCells);
+
 	//all fields
 	for(int k = 0; k < fieldCount; k++) {
 		Field f= static_cast<Field>(k);
 
-		for(int i = pos.x - sightRange; i < pos.x + size + sightRange; ++i) {
-			for(int j = pos.y - sightRange; j < pos.y + size + sightRange; ++j) {
-				Vec2i testPos(i,j);
-				if( map->isInside(testPos) &&
-						map->isInsideSurface(map->toSurfCoords(testPos))) {
-					Cell *cell = map->getCell(testPos);
-					//check field
-					Unit *possibleEnemy = cell->getUnit(f);
-
-					//check enemy
-					if(possibleEnemy != NULL && possibleEnemy->isAlive()) {
-						if(faction->getTeam() != possibleEnemy->getTeam()) {
-							if(attackersOnly == true) {
-								if(possibleEnemy->getType()->hasCommandClass(ccAttack) || possibleEnemy->getType()->hasCommandClass(ccAttackStopped)) {
-									enemies.push_back(possibleEnemy);
-								}
-							}
-							else {
-								enemies.push_back(possibleEnemy);
-							}
+		for(unsigned int index = 0; index < unitCells.size(); ++index) {
+			//check field
+			if(unitCells[index].field != f) {
+				continue;
+			}
+			Unit *possibleEnemy = unitCells[index].unit;
+
+			//check enemy
+			if(possibleEnemy != NULL && possibleEnemy->isAlive()) {
+				if(faction->getTeam() != possibleEnemy->getTeam()) {
+					if(attackersOnly == true) {
+						if(possibleEnemy->getType()->hasCommandClass(ccAttack) || possibleEnemy->getType()->hasCommandClass(ccAttackStopped)) {
+							enemies.push_back(possibleEnemy);
 						}
 					}
+					else {
+						enemies.push_back(possibleEnemy);
+					}
 				}
 			}
 		}
@@ -2908,38 +2924,10 @@ bool UnitUpdater::unitOnRange(Unit *unit, int range, Unit **rangedPtr,
 		Vec2i center 		= unit->getPos();
 		Vec2f floatCenter	= unit->getFloatCenteredPos();
 
-		//bool foundInCache = true;
-		if(findCachedCellsEnemies(center,range,size,enemies,ast,
-								  unit,commandTarget) == false) {
-
-			//foundInCache = false;
-			//nearby cells
-			UnitRangeCellsLookupItem cacheItem;
-			for(int i = center.x - range; i < center.x + range + size; ++i) {
-				for(int j = center.y - range; j < center.y + range + size; ++j) {
-					//cells inside map and in range
-#ifdef USE_STREFLOP
-					if(map->isInside(i, j) && streflop::floor(static_cast<streflop::Simple>(floatCenter.dist(Vec2f((float)i, (float)j)))) <= (range+1))
-#else
-					if(map->isInside(i, j) && floor(floatCenter.dist(Vec2f((float)i, (float)j))) <= (range+1))
-#endif
-					{
-						Cell *cell = map->getCell(i,j);
-						findEnemiesForCell(ast,cell,unit,commandTarget,enemies);
-
-						cacheItem.rangeCellList.push_back(cell);
-					}
-				}
-			}
-
-
-			// Ok update our caches with the latest info
-			if(cacheItem.rangeCellList.empty() == false) {
-				MutexSafeWrapper safeMutex(mutexUnitRangeCellsLookupItemCache,string(__FILE__) + "_" + intToStr(__LINE__));
-
-				UnitRangeCellsLookupItemCache[center][size][range] = cacheItem;
-			}
-		}
+		//nearby cells
+		vector<UnitCellRef> unitCells;
+		findUnitCellsInRange(center, floatCenter, range, size, unit->getFaction(), commandTarget, unitCells);
+		findEnemiesForUnitCells(ast, unitCells, unit, commandTarget, enemies);
 
 		//attack enemies that can attack first
 		float distToUnit= -1;
@@ -3130,7 +3118,7 @@ bool UnitUpdater::unitOnRange(Unit *unit, int range, Unit **rangedPtr,
 		//setRunningStatus(false);
 
 		SystemFlags::OutputDebug(SystemFlags::debugError,"In [%s::%s Line: %d] Error [%s]\n",__FILE__,__FUNCTION__,__LINE__,ex.what());
-		if(SystemFlags::getSystemSettingType(SystemFlags::debugSystem).enabled) SystemFlags::OutputDebug(SystemFlags::debugSystem,"In [%s::%s Line: %d]\n",__FILE__,__FUNCTION__,__LINE__);
+		if(SystemFlags::isDebugEnabled(SystemFlags::debugSystem)) SystemFlags::OutputDebug(SystemFlags::debugSystem,"In [%s::%s Line: %d]\n",__FILE__,__FUNCTION__,__LINE__);
 
 		throw megaglest_runtime_error(ex.what());
 	}
@@ -3172,43 +3160,17 @@ vector<Unit*> UnitUpdater::enemyUnitsOnRange(const Unit *unit,const AttackSkillT
 	Vec2i center 		= unit->getPosNotThreadSafe();
 	Vec2f floatCenter	= unit->getFloatCenteredPos();
 
-	//bool foundInCache = true;
-	if(findCachedCellsEnemies(center,range,size,enemies,ast,
-							  unit,commandTarget) == false) {
-
-		//foundInCache = false;
-		//nearby cells
-		UnitRangeCellsLookupItem cacheItem;
-		for(int i = center.x - range; i < center.x + range + size; ++i) {
-			for(int j = center.y - range; j < center.y + range + size; ++j) {
-				//cells inside map and in range
-#ifdef USE_STREFLOP
-				if(map->isInside(i, j) && streflop::floor(static_cast<streflop::Simple>(floatCenter.dist(Vec2f((float)i, (float)j)))) <= (range+1)){
-#else
-				if(map->isInside(i, j) && floor(floatCenter.dist(Vec2f((float)i, (float)j))) <= (range+1)){
-#endif
-					Cell *cell = map->getCell(i,j);
-					findEnemiesForCell(ast,cell,unit,commandTarget,enemies);
-
-					cacheItem.rangeCellList.push_back(cell);
-				}
-			}
-		}
-
-		// Ok update our caches with the latest info
-		if(cacheItem.rangeCellList.empty() == false) {
-			MutexSafeWrapper safeMutex(mutexUnitRangeCellsLookupItemCache,string(__FILE__) + "_" + intToStr(__LINE__));
-
-			UnitRangeCellsLookupItemCache[center][size][range] = cacheItem;
-		}
-	}
+	//nearby cells
+	vector<UnitCellRef> unitCells;
+	findUnitCellsInRange(center, floatCenter, range, size, unit->getFaction(), commandTarget, unitCells);
+	findEnemiesForUnitCells(ast, unitCells, unit, commandTarget, enemies);
 
 	}
 	catch(const exception &ex) {
 		//setRunningStatus(false);
 
 		SystemFlags::OutputDebug(SystemFlags::debugError,"In [%s::%s Line: %d] Error [%s]\n",__FILE__,__FUNCTION__,__LINE__,ex.what());
-		if(SystemFlags::getSystemSettingType(SystemFlags::debugSystem).enabled) SystemFlags::OutputDebug(SystemFlags::debugSystem,"In [%s::%s Line: %d]\n",__FILE__,__FUNCTION__,__LINE__);
+		if(SystemFlags::isDebugEnabled(SystemFlags::debugSystem)) SystemFlags::OutputDebug(SystemFlags::debugSystem,"In [%s::%s Line: %d]\n",__FILE__,__FUNCTION__,__LINE__);
 
 		throw megaglest_runtime_error(ex.what());
 	}
@@ -3223,36 +3185,6 @@ vector<Unit*> UnitUpdater::enemyUnitsOnRange(const Unit *unit,const AttackSkillT
 }
 
 
-void UnitUpdater::findUnitsForCell(Cell *cell, vector<Unit*> &units) {
-	//all fields
-	if(cell != NULL) {
-		for(int k = 0; k < fieldCount; k++) {
-			Field f= static_cast<Field>(k);
-
-			//check field
-			Unit *cellUnit = cell->getUnit(f);
-
-			if(cellUnit != NULL && cellUnit->isAlive()) {
-				// check if unit already is in list
-				bool found = false;
-				//printf("---- search for cellUnit=%d\n",cellUnit->getId());
-				for (unsigned int i = 0; i < units.size(); ++i) {
-					Unit *unitInList = units[i];
-					//printf("compare unitInList=%d cellUnit=%d\n",unitInList->getId(),cellUnit->getId());
-					if (unitInList->getId() == cellUnit->getId()){
-						found=true;
-						break;
-					}
-				}
-				if(found==false){
-					//printf(">>> adding cellUnit=%d\n",cellUnit->getId());
-					units.push_back(cellUnit);
-				}
-			}
-		}
-	}
-}
-
 vector<Unit*> UnitUpdater::findUnitsInRange(const Unit *unit, int radius) {
 	int range = radius;
 	vector<Unit*> units;
@@ -3263,57 +3195,19 @@ vector<Unit*> UnitUpdater::findUnitsInRange(const Unit *unit, int radius) {
 	Vec2f floatCenter	= unit->getFloatCenteredPos();
 
 	//nearby cells
-	//UnitRangeCellsLookupItem cacheItem;
-	for(int i = center.x - range; i < center.x + range + size; ++i) {
-		for(int j = center.y - range; j < center.y + range + size; ++j) {
-			//cells inside map and in range
-#ifdef USE_STREFLOP
-			if(map->isInside(i, j) && streflop::floor(static_cast<streflop::Simple>(floatCenter.dist(Vec2f((float)i, (float)j)))) <= (range+1)){
-#else
-			if(map->isInside(i, j) && floor(floatCenter.dist(Vec2f((float)i, (float)j))) <= (range+1)){
-#endif
-				Cell *cell = map->getCell(i,j);
-				findUnitsForCell(cell,units);
-			}
-		}
-	}
+	vector<UnitCellRef> unitCells;
+	findUnitCellsInRange(center, floatCenter, range, size, NULL, NULL, unitCells);
 
-	return units;
-}
-
-string UnitUpdater::getUnitRangeCellsLookupItemCacheStats() {
-	string result = "";
-
-	int posCount = 0;
-	int sizeCount = 0;
-	int rangeCount = 0;
-	int rangeCountCellCount = 0;
-
-	MutexSafeWrapper safeMutex(mutexUnitRangeCellsLookupItemCache,string(__FILE__) + "_" + intToStr(__LINE__));
-	for(std::map<Vec2i, std::map<int, std::map<int, UnitRangeCellsLookupItem > > >::iterator iterMap1 = UnitRangeCellsLookupItemCache.begin();
-		iterMap1 != UnitRangeCellsLookupItemCache.end(); ++iterMap1) {
-		posCount++;
-
-		for(std::map<int, std::map<int, UnitRangeCellsLookupItem > >::iterator iterMap2 = iterMap1->second.begin();
-			iterMap2 != iterMap1->second.end(); ++iterMap2) {
-			sizeCount++;
-
-			for(std::map<int, UnitRangeCellsLookupItem>::iterator iterMap3 = iterMap2->second.begin();
-				iterMap3 != iterMap2->second.end(); ++iterMap3) {
-				rangeCount++;
-
-				rangeCountCellCount += (int)iterMap3->second.rangeCellList.size();
-			}
+	//all fields, a unit spread over several cells is added once
+	for(unsigned int index = 0; index < unitCells.size(); ++index) {
+		Unit *cellUnit = unitCells[index].unit;
+		if(cellUnit != NULL && cellUnit->isAlive() &&
+			std::find(units.begin(), units.end(), cellUnit) == units.end()) {
+			units.push_back(cellUnit);
 		}
 	}
 
-	uint64 totalBytes = rangeCountCellCount * sizeof(Cell *);
-	totalBytes /= 1000;
-
-	char szBuf[8096]="";
-	snprintf(szBuf,8096,"pos [%d] size [%d] range [%d][%d] total KB: %s",posCount,sizeCount,rangeCount,rangeCountCellCount,formatNumber(totalBytes).c_str());
-	result = szBuf;
-	return result;
+	return units;
 }
 
 void UnitUpdater::saveGame(XmlNode *rootNode) {
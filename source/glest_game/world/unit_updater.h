@@ -21,6 +21,7 @@
 #include "particle.h"
 #include "randomgen.h"
 #include "command.h"
+#include "unit_grid.h"
 #include "leak_dumper.h"
 
 using Shared::Graphics::ParticleObserver;
@@ -44,15 +45,6 @@ class PathFinder;
 class ParticleDamager;
 class Cell;
 
-class UnitRangeCellsLookupItem {
-public:
-
-	//int UnitRangeCellsLookupItemCacheTimerCountIndex;
-	std::vector<Cell *> rangeCellList;
-
-	static time_t lastDebug;
-};
-
 class AttackWarningData {
 public:
 	Vec2f attackPosition;
@@ -84,17 +76,12 @@ private:
 	float attackWarnRange;
 	AttackWarnings attackWarnings;
 
-	Mutex *mutexUnitRangeCellsLookupItemCache;
-	std::map<Vec2i, std::map<int, std::map<int, UnitRangeCellsLookupItem > > > UnitRangeCellsLookupItemCache;
-	//std::map<int,ExploredCellsLookupKey> ExploredCellsLookupItemCacheTimer;
-	//int UnitRangeCellsLookupItemCacheTimerCount;
-
-	bool findCachedCellsEnemies(Vec2i center, int range,
-								int size, vector<Unit*> &enemies,
-								const AttackSkillType *ast, const Unit *unit,
-								const Unit *commandTarget);
-	void findEnemiesForCell(const AttackSkillType *ast, Cell *cell, const Unit *unit,
-							const Unit *commandTarget,vector<Unit*> &enemies);
+	void findUnitCellsInArea(const Vec2i &minPos, const Vec2i &maxPos, Faction *faction,
+							 const Unit *commandTarget, vector<UnitCellRef> &unitCells) const;
+	void findUnitCellsInRange(const Vec2i &center, const Vec2f &floatCenter, int range, int size,
+							  Faction *faction, const Unit *commandTarget, vector<UnitCellRef> &unitCells) const;
+	void findEnemiesForUnitCells(const AttackSkillType *ast, const vector<UnitCellRef> &unitCells, const Unit *unit,
+								 const Unit *commandTarget, vector<Unit*> &enemies);
 
 public:
 	UnitUpdater();
@@ -121,6 +108,7 @@ public:
 
 	void clearUnitPrecache(Unit *unit);
 	void removeUnitPrecache(Unit *unit);
+	void mergePathFinderPrecache();
 
 	inline unsigned int getAttackWarningCount() const { return (unsigned int)attackWarnings.size(); }
 	std::pair<bool,Unit *> unitBeingAttacked(const Unit *unit);
@@ -130,8 +118,6 @@ public:
 
 	vector<Unit*> findUnitsInRange(const Unit *unit, int radius);
 
-	string getUnitRangeCellsLookupItemCacheStats();
-
 	void saveGame(XmlNode *rootNode);
 	void loadGame(const XmlNode *rootNode);
 
@@ -161,7 +147,6 @@ private:
 	void SwapActiveCommandState(Unit *unit, CommandStateType commandStateType,
 								const CommandType *commandType,
 								int originalValue,int newValue);
-	void findUnitsForCell(Cell *cell, vector<Unit*> &units);
 
 };
 
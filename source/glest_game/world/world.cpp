@@ -23,6 +23,7 @@
 #include "sound_renderer.h"
 #include "game_settings.h"
 #include "cache_manager.h"
+#include "zone_profiler.h"
 #include <iostream>
 #include "sound.h"
 #include "sound_renderer.h"
@@ -38,25 +39,16 @@ namespace Glest{ namespace Game{
 // 	class World
 // =====================================================
 
-// This limit is to keep RAM use under control while offering better performance.
-int MaxExploredCellsLookupItemCache = 9500;
-//int MaxExploredCellsLookupItemCache = 0;
-time_t ExploredCellsLookupItem::lastDebug = 0;
-
 // ===================== PUBLIC ========================
 
 World::World() : mutexFactionNextUnitId(new Mutex(CODE_AT_LINE)) {
-	if(SystemFlags::getSystemSettingType(SystemFlags::debugSystem).enabled) SystemFlags::OutputDebug(SystemFlags::debugSystem,"In [%s::%s Line: %d]\n",__FILE__,__FUNCTION__,__LINE__);
+	if(SystemFlags::isDebugEnabled(SystemFlags::debugSystem)) SystemFlags::OutputDebug(SystemFlags::debugSystem,"In [%s::%s Line: %d]\n",__FILE__,__FUNCTION__,__LINE__);
 	Config &config= Config::getInstance();
 
 	unitParticlesEnabled=config.getBool("UnitParticles","true");
 
 	animatedTilesetObjectPosListLoaded = false;
 
-	ExploredCellsLookupItemCache.clear();
-	ExploredCellsLookupItemCacheTimer.clear();
-	ExploredCellsLookupItemCacheTimerCount = 0;
-
 	nextCommandGroupId = 0;
 	techTree = NULL;
 	fogOfWarOverride = false;
@@ -80,29 +72,35 @@ World::World() : mutexFactionNextUnitId(new Mutex(CODE_AT_LINE)) {
 	disableAttackEffects = false;
 
 	loadWorldNode = NULL;
-	cacheFowAlphaTexture = false;
-	cacheFowAlphaTextureFogOfWarValue = false;
+	minimapFowRefresh = true;
+	minimapRevealWorld = false;
 
-	if(SystemFlags::getSystemSettingType(SystemFlags::debugSystem).enabled) SystemFlags::OutputDebug(SystemFlags::debugSystem,"In [%s::%s Line: %d]\n",__FILE__,__FUNCTION__,__LINE__);
+	taskPool = NULL;
+
+	if(SystemFlags::isDebugEnabled(SystemFlags::debugSystem)) SystemFlags::OutputDebug(SystemFlags::debugSystem,"In [%s::%s Line: %d]\n",__FILE__,__FUNCTION__,__LINE__);
 }
 
 void World::cleanup() {
-	if(SystemFlags::getSystemSettingType(SystemFlags::debugSystem).enabled) SystemFlags::OutputDebug(SystemFlags::debugSystem,"In [%s::%s Line: %d]\n",__FILE__,__FUNCTION__,__LINE__);
+	if(SystemFlags::isDebugEnabled(SystemFlags::debugSystem)) SystemFlags::OutputDebug(SystemFlags::debugSystem,"In [%s::%s Line: %d]\n",__FILE__,__FUNCTION__,__LINE__);
 
 	animatedTilesetObjectPosListLoaded = false;
 
-	ExploredCellsLookupItemCache.clear();
-	ExploredCellsLookupItemCacheTimer.clear();
 	//FowAlphaCellsLookupItemCache.clear();
 
-	if(SystemFlags::getSystemSettingType(SystemFlags::debugSystem).enabled) SystemFlags::OutputDebug(SystemFlags::debugSystem,"In [%s::%s Line: %d]\n",__FILE__,__FUNCTION__,__LINE__);
+	if(SystemFlags::isDebugEnabled(SystemFlags::debugSystem)) SystemFlags::OutputDebug(SystemFlags::debugSystem,"In [%s::%s Line: %d]\n",__FILE__,__FUNCTION__,__LINE__);
 
 	for(int i= 0; i < (int)factions.size(); ++i){
 		factions[i]->end();
 	}
 
 	masterController.clearSlaves(true);
-	if(SystemFlags::getSystemSettingType(SystemFlags::debugSystem).enabled) SystemFlags::OutputDebug(SystemFlags::debugSystem,"In [%s::%s Line: %d]\n",__FILE__,__FUNCTION__,__LINE__);
+
+	delete taskPool;
+	taskPool = NULL;
+	precacheUnitCount = 0;
+	sightMap.clear();
+
+	if(SystemFlags::isDebugEnabled(SystemFlags::debugSystem)) SystemFlags::OutputDebug(SystemFlags::debugSystem,"In [%s::%s Line: %d]\n",__FILE__,__FUNCTION__,__LINE__);
 	for(int i= 0; i < (int)factions.size(); ++i){
 		delete factions[i];
 	}
@@ -114,12 +112,12 @@ void World::cleanup() {
 	UnitPathBasic::dumpMemoryList();
 #endif
 
-	if(SystemFlags::getSystemSettingType(SystemFlags::debugSystem).enabled) SystemFlags::OutputDebug(SystemFlags::debugSystem,"In [%s::%s Line: %d]\n",__FILE__,__FUNCTION__,__LINE__);
+	if(SystemFlags::isDebugEnabled(SystemFlags::debugSystem)) SystemFlags::OutputDebug(SystemFlags::debugSystem,"In [%s::%s Line: %d]\n",__FILE__,__FUNCTION__,__LINE__);
 
 	delete techTree;
 	techTree = NULL;
 
-	if(SystemFlags::getSystemSettingType(SystemFlags::debugSystem).enabled) SystemFlags::OutputDebug(SystemFlags::debugSystem,"In [%s::%s Line: %d]\n",__FILE__,__FUNCTION__,__LINE__);
+	if(SystemFlags::isDebugEnabled(SystemFlags::debugSystem)) SystemFlags::OutputDebug(SystemFlags::debugSystem,"In [%s::%s Line: %d]\n",__FILE__,__FUNCTION__,__LINE__);
 
 	for(std::map<string,::Shared::Sound::StaticSound *>::iterator iterMap = staticSoundList.begin();
 		iterMap != staticSoundList.end(); ++iterMap) {
@@ -133,57 +131,57 @@ void World::cleanup() {
 	}
 	streamSoundList.clear();
 
-	if(SystemFlags::getSystemSettingType(SystemFlags::debugSystem).enabled) SystemFlags::OutputDebug(SystemFlags::debugSystem,"In [%s::%s Line: %d]\n",__FILE__,__FUNCTION__,__LINE__);
+	if(SystemFlags::isDebugEnabled(SystemFlags::debugSystem)) SystemFlags::OutputDebug(SystemFlags::debugSystem,"In [%s::%s Line: %d]\n",__FILE__,__FUNCTION__,__LINE__);
 
-	if(SystemFlags::getSystemSettingType(SystemFlags::debugSystem).enabled) SystemFlags::OutputDebug(SystemFlags::debugSystem,"In [%s::%s Line: %d]\n",__FILE__,__FUNCTION__,__LINE__);
+	if(SystemFlags::isDebugEnabled(SystemFlags::debugSystem)) SystemFlags::OutputDebug(SystemFlags::debugSystem,"In [%s::%s Line: %d]\n",__FILE__,__FUNCTION__,__LINE__);
 }
 
 World::~World() {
-	if(SystemFlags::getSystemSettingType(SystemFlags::debugSystem).enabled) SystemFlags::OutputDebug(SystemFlags::debugSystem,"In [%s::%s Line: %d]\n",__FILE__,__FUNCTION__,__LINE__);
+	if(SystemFlags::isDebugEnabled(SystemFlags::debugSystem)) SystemFlags::OutputDebug(SystemFlags::debugSystem,"In [%s::%s Line: %d]\n",__FILE__,__FUNCTION__,__LINE__);
 
 	cleanup();
 
 	delete mutexFactionNextUnitId;
 	mutexFactionNextUnitId = NULL;
 
-	if(SystemFlags::getSystemSettingType(SystemFlags::debugSystem).enabled) SystemFlags::OutputDebug(SystemFlags::debugSystem,"In [%s::%s Line: %d]\n",__FILE__,__FUNCTION__,__LINE__);
+	if(SystemFlags::isDebugEnabled(SystemFlags::debugSystem)) SystemFlags::OutputDebug(SystemFlags::debugSystem,"In [%s::%s Line: %d]\n",__FILE__,__FUNCTION__,__LINE__);
 }
 
 void World::endScenario() {
-	if(SystemFlags::getSystemSettingType(SystemFlags::debugSystem).enabled) SystemFlags::OutputDebug(SystemFlags::debugSystem,"In [%s::%s Line: %d]\n",__FILE__,__FUNCTION__,__LINE__);
+	if(SystemFlags::isDebugEnabled(SystemFlags::debugSystem)) SystemFlags::OutputDebug(SystemFlags::debugSystem,"In [%s::%s Line: %d]\n",__FILE__,__FUNCTION__,__LINE__);
     Logger::getInstance().add(Lang::getInstance().getString("LogScreenGameUnLoadingWorld","",true), true);
 
     animatedTilesetObjectPosListLoaded = false;
 
-    ExploredCellsLookupItemCache.clear();
-    ExploredCellsLookupItemCacheTimer.clear();
-
 	fogOfWarOverride = false;
 	originalGameFogOfWar = fogOfWar;
 	fogOfWarSkillTypeValue = -1;
-	cacheFowAlphaTexture = false;
-	cacheFowAlphaTextureFogOfWarValue = false;
+	minimapFowRefresh = true;
+	minimapRevealWorld = false;
 
 	map.end();
 
 	//stats will be deleted by BattleEnd
-	if(SystemFlags::getSystemSettingType(SystemFlags::debugSystem).enabled) SystemFlags::OutputDebug(SystemFlags::debugSystem,"In [%s::%s Line: %d]\n",__FILE__,__FUNCTION__,__LINE__);
+	if(SystemFlags::isDebugEnabled(SystemFlags::debugSystem)) SystemFlags::OutputDebug(SystemFlags::debugSystem,"In [%s::%s Line: %d]\n",__FILE__,__FUNCTION__,__LINE__);
 }
 
 void World::end(){
-	if(SystemFlags::getSystemSettingType(SystemFlags::debugSystem).enabled) SystemFlags::OutputDebug(SystemFlags::debugSystem,"In [%s::%s Line: %d]\n",__FILE__,__FUNCTION__,__LINE__);
+	if(SystemFlags::isDebugEnabled(SystemFlags::debugSystem)) SystemFlags::OutputDebug(SystemFlags::debugSystem,"In [%s::%s Line: %d]\n",__FILE__,__FUNCTION__,__LINE__);
     Logger::getInstance().add(Lang::getInstance().getString("LogScreenGameUnLoadingWorld","",true), true);
 
     animatedTilesetObjectPosListLoaded = false;
 
-    ExploredCellsLookupItemCache.clear();
-    ExploredCellsLookupItemCacheTimer.clear();
-
 	for(int i= 0; i < (int)factions.size(); ++i){
 		factions[i]->end();
 	}
 
 	masterController.clearSlaves(true);
+
+	delete taskPool;
+	taskPool = NULL;
+	precacheUnitCount = 0;
+	sightMap.clear();
+
 	for(int i= 0; i < (int)factions.size(); ++i){
 		delete factions[i];
 	}
@@ -200,11 +198,11 @@ void World::end(){
 	fogOfWarSkillTypeValue = -1;
 
 	map.end();
-	cacheFowAlphaTexture = false;
-	cacheFowAlphaTextureFogOfWarValue = false;
+	minimapFowRefresh = true;
+	minimapRevealWorld = false;
 
 	//stats will be deleted by BattleEnd
-	if(SystemFlags::getSystemSettingType(SystemFlags::debugSystem).enabled) SystemFlags::OutputDebug(SystemFlags::debugSystem,"In [%s::%s Line: %d]\n",__FILE__,__FUNCTION__,__LINE__);
+	if(SystemFlags::isDebugEnabled(SystemFlags::debugSystem)) SystemFlags::OutputDebug(SystemFlags::debugSystem,"In [%s::%s Line: %d]\n",__FILE__,__FUNCTION__,__LINE__);
 }
 
 // ========================== init ===============================================
@@ -244,7 +242,6 @@ void World::removeFogOfWarSkillType(const Unit *unit) {
 			//printf("In [%s::%s Line: %d] current = %d new = %d\n",__FILE__,__FUNCTION__,__LINE__,fogOfWar,originalGameFogOfWar);
 			fogOfWarSkillTypeValue = -1;
 			fogOfWarOverride = false;
-			minimap.restoreFowTex();
 		}
 		else {
 			bool fowEnabled = false;
@@ -275,10 +272,6 @@ void World::removeFogOfWarSkillType(const Unit *unit) {
 void World::setFogOfWar(bool value) {
 	//printf("In [%s::%s Line: %d] current = %d new = %d\n",__FILE__,__FUNCTION__,__LINE__,fogOfWar,value);
 
-	if(fogOfWarOverride == false) {
-		minimap.copyFowTex();
-	}
-
 	if(value == true) {
 		fogOfWarSkillTypeValue = 1;
 	}
@@ -293,42 +286,9 @@ void World::clearTileset() {
 	tileset = Tileset();
 }
 
-void World::restoreExploredFogOfWarCells() {
-	for (int i = 0; i < map.getSurfaceW(); ++i) {
-		for (int j = 0; j < map.getSurfaceH(); ++j) {
-			for (int k = 0;	k < GameConstants::maxPlayers + GameConstants::specialFactions; ++k) {
-				if (k == thisTeamIndex) {
-					if (map.getSurfaceCell(i, j)->isExplored(k) == true) {
-						const Vec2i pos(i, j);
-						Vec2i surfPos = pos;
-						//compute max alpha
-						float maxAlpha = 0.0f;
-						if (surfPos.x > 1 && surfPos.y > 1
-								&& surfPos.x < map.getSurfaceW() - 2
-								&& surfPos.y < map.getSurfaceH() - 2) {
-							maxAlpha = 1.f;
-						} else if (surfPos.x > 0 && surfPos.y > 0
-								&& surfPos.x < map.getSurfaceW() - 1
-								&& surfPos.y < map.getSurfaceH() - 1) {
-							maxAlpha = 0.3f;
-						}
-
-						//compute alpha
-						float alpha = maxAlpha;
-						minimap.incFowTextureAlphaSurface(surfPos, alpha);
-					}
-				}
-			}
-		}
-	}
-}
-
 void World::init(Game *game, bool createUnits, bool initFactions){
 
-	if(SystemFlags::getSystemSettingType(SystemFlags::debugSystem).enabled) SystemFlags::OutputDebug(SystemFlags::debugSystem,"In [%s::%s Line: %d]\n",__FILE__,__FUNCTION__,__LINE__);
-
-	ExploredCellsLookupItemCache.clear();
-	ExploredCellsLookupItemCacheTimer.clear();
+	if(SystemFlags::isDebugEnabled(SystemFlags::debugSystem)) SystemFlags::OutputDebug(SystemFlags::debugSystem,"In [%s::%s Line: %d]\n",__FILE__,__FUNCTION__,__LINE__);
 
 	this->game = game;
 	scriptManager= game->getScriptManager();
@@ -348,6 +308,11 @@ void World::init(Game *game, bool createUnits, bool initFactions){
 	}
 	initCells(fogOfWar); //must be done after knowing faction number and dimensions
 	initMap();
+
+	// the splatted textures are blended on the pool too
+	if(taskPool == NULL && Config::getInstance().getBool("EnableTaskPoolPreprocessing","true") == true) {
+		taskPool = new WorkStealingTaskPool();
+	}
 	initSplattedTextures();
 
 	unitUpdater.init(game);
@@ -392,33 +357,22 @@ void World::init(Game *game, bool createUnits, bool initFactions){
 		map.loadGame(loadWorldNode,this);
 
 		if(fogOfWar == false) {
-		    for(int i=0; i< map.getSurfaceW(); ++i) {
-		        for(int j=0; j< map.getSurfaceH(); ++j) {
-
-					SurfaceCell *sc= map.getSurfaceCell(i, j);
-					if(sc == NULL) {
-						throw megaglest_runtime_error("sc == NULL");
-					}
-
-					for (int k = 0; k < GameConstants::maxPlayers; k++) {
-						//sc->setExplored(k, (game->getGameSettings()->getFlagTypes1() & ft1_show_map_resources) == ft1_show_map_resources);
-						sc->setVisible(k, !fogOfWar);
-					}
-					for (int k = GameConstants::maxPlayers; k < GameConstants::maxPlayers + GameConstants::specialFactions; k++) {
-						sc->setExplored(k, true);
-						sc->setVisible(k, true);
-					}
-		        }
-		    }
-		}
-		else {
-			restoreExploredFogOfWarCells();
+			for (int k = 0; k < GameConstants::maxPlayers; k++) {
+				map.getVisiblePlane()->fill(k, !fogOfWar);
+			}
+			for (int k = GameConstants::maxPlayers; k < GameConstants::maxPlayers + GameConstants::specialFactions; k++) {
+				map.getExploredPlane()->fill(k, true);
+				map.getVisiblePlane()->fill(k, true);
+			}
 		}
+		// the minimap picks up the loaded explored cells when computeFow
+		// rebuilds it below
 
 		//minimap.loadGame(loadWorldNode);
 	}
 
 	//initExplorationState(); ... was only for !fog-of-war, now handled in initCells()
+	resetTeamVisibility();
 	computeFow();
 	if(getFrameCount()>1){
 		// this is needed for games that are loaded to "switch the light on".
@@ -430,7 +384,7 @@ void World::init(Game *game, bool createUnits, bool initFactions){
 		throw megaglest_runtime_error(sErrBuf,!skipStackTrace);
 	}
 
-	if(SystemFlags::getSystemSettingType(SystemFlags::debugSystem).enabled) SystemFlags::OutputDebug(SystemFlags::debugSystem,"In [%s::%s Line: %d]\n",__FILE__,__FUNCTION__,__LINE__);
+	if(SystemFlags::isDebugEnabled(SystemFlags::debugSystem)) SystemFlags::OutputDebug(SystemFlags::debugSystem,"In [%s::%s Line: %d]\n",__FILE__,__FUNCTION__,__LINE__);
 }
 
 //load tileset
@@ -438,12 +392,12 @@ Checksum World::loadTileset(const vector<string> pathList, const string &tileset
 		Checksum* checksum, std::map<string,vector<pair<string, string> > > &loadedFileList) {
     Checksum tilsetChecksum;
 
-    if(SystemFlags::getSystemSettingType(SystemFlags::debugSystem).enabled) SystemFlags::OutputDebug(SystemFlags::debugSystem,"In [%s::%s Line: %d]\n",__FILE__,__FUNCTION__,__LINE__);
+    if(SystemFlags::isDebugEnabled(SystemFlags::debugSystem)) SystemFlags::OutputDebug(SystemFlags::debugSystem,"In [%s::%s Line: %d]\n",__FILE__,__FUNCTION__,__LINE__);
 	tilsetChecksum = tileset.loadTileset(pathList, tilesetName, checksum, loadedFileList);
 
-	if(SystemFlags::getSystemSettingType(SystemFlags::debugSystem).enabled) SystemFlags::OutputDebug(SystemFlags::debugSystem,"In [%s::%s Line: %d]\n",__FILE__,__FUNCTION__,__LINE__);
+	if(SystemFlags::isDebugEnabled(SystemFlags::debugSystem)) SystemFlags::OutputDebug(SystemFlags::debugSystem,"In [%s::%s Line: %d]\n",__FILE__,__FUNCTION__,__LINE__);
 	timeFlow.init(&tileset);
-	if(SystemFlags::getSystemSettingType(SystemFlags::debugSystem).enabled) SystemFlags::OutputDebug(SystemFlags::debugSystem,"In [%s::%s Line: %d]\n",__FILE__,__FUNCTION__,__LINE__);
+	if(SystemFlags::isDebugEnabled(SystemFlags::debugSystem)) SystemFlags::OutputDebug(SystemFlags::debugSystem,"In [%s::%s Line: %d]\n",__FILE__,__FUNCTION__,__LINE__);
 
 	return tilsetChecksum;
 }
@@ -451,11 +405,11 @@ Checksum World::loadTileset(const vector<string> pathList, const string &tileset
 Checksum World::loadTileset(const string &dir, Checksum *checksum, std::map<string,vector<pair<string, string> > > &loadedFileList) {
     Checksum tilesetChecksum;
 
-    if(SystemFlags::getSystemSettingType(SystemFlags::debugSystem).enabled) SystemFlags::OutputDebug(SystemFlags::debugSystem,"In [%s::%s Line: %d]\n",__FILE__,__FUNCTION__,__LINE__);
+    if(SystemFlags::isDebugEnabled(SystemFlags::debugSystem)) SystemFlags::OutputDebug(SystemFlags::debugSystem,"In [%s::%s Line: %d]\n",__FILE__,__FUNCTION__,__LINE__);
 	tileset.load(dir, checksum, &tilesetChecksum, loadedFileList);
-	if(SystemFlags::getSystemSettingType(SystemFlags::debugSystem).enabled) SystemFlags::OutputDebug(SystemFlags::debugSystem,"In [%s::%s Line: %d]\n",__FILE__,__FUNCTION__,__LINE__);
+	if(SystemFlags::isDebugEnabled(SystemFlags::debugSystem)) SystemFlags::OutputDebug(SystemFlags::debugSystem,"In [%s::%s Line: %d]\n",__FILE__,__FUNCTION__,__LINE__);
 	timeFlow.init(&tileset);
-	if(SystemFlags::getSystemSettingType(SystemFlags::debugSystem).enabled) SystemFlags::OutputDebug(SystemFlags::debugSystem,"In [%s::%s Line: %d]\n",__FILE__,__FUNCTION__,__LINE__);
+	if(SystemFlags::isDebugEnabled(SystemFlags::debugSystem)) SystemFlags::OutputDebug(SystemFlags::debugSystem,"In [%s::%s Line: %d]\n",__FILE__,__FUNCTION__,__LINE__);
 
 	return tilesetChecksum;
 }
@@ -467,7 +421,7 @@ Checksum World::loadTech(const vector<string> pathList, const string &techName,
 		bool validationMode) {
 	Checksum techtreeChecksum;
 
-	if(SystemFlags::getSystemSettingType(SystemFlags::debugSystem).enabled) SystemFlags::OutputDebug(SystemFlags::debugSystem,"In [%s::%s Line: %d]\n",__FILE__,__FUNCTION__,__LINE__);
+	if(SystemFlags::isDebugEnabled(SystemFlags::debugSystem)) SystemFlags::OutputDebug(SystemFlags::debugSystem,"In [%s::%s Line: %d]\n",__FILE__,__FUNCTION__,__LINE__);
 
 	techTree = new TechTree(pathList);
 	techtreeChecksum = techTree->loadTech( techName, factions,
@@ -486,11 +440,11 @@ std::vector<std::string> World::validateResourceTypes() {
 //load map
 Checksum World::loadMap(const string &path, Checksum *checksum) {
     Checksum mapChecksum;
-    if(SystemFlags::getSystemSettingType(SystemFlags::debugSystem).enabled) SystemFlags::OutputDebug(SystemFlags::debugSystem,"In [%s::%s Line: %d]\n",__FILE__,__FUNCTION__,__LINE__);
+    if(SystemFlags::isDebugEnabled(SystemFlags::debugSystem)) SystemFlags::OutputDebug(SystemFlags::debugSystem,"In [%s::%s Line: %d]\n",__FILE__,__FUNCTION__,__LINE__);
 
 	checksum->addFile(path);
 	mapChecksum = map.load(path, techTree, &tileset);
-	if(SystemFlags::getSystemSettingType(SystemFlags::debugSystem).enabled) SystemFlags::OutputDebug(SystemFlags::debugSystem,"In [%s::%s Line: %d]\n",__FILE__,__FUNCTION__,__LINE__);
+	if(SystemFlags::isDebugEnabled(SystemFlags::debugSystem)) SystemFlags::OutputDebug(SystemFlags::debugSystem,"In [%s::%s Line: %d]\n",__FILE__,__FUNCTION__,__LINE__);
 	return mapChecksum;
 }
 
@@ -499,7 +453,7 @@ Checksum World::loadScenario(const string &path, Checksum *checksum, bool resetC
 	//printf("[%s:%s] Line: %d path [%s]\n",__FILE__,__FUNCTION__,__LINE__,path.c_str());
 
     Checksum scenarioChecksum;
-    if(SystemFlags::getSystemSettingType(SystemFlags::debugSystem).enabled) SystemFlags::OutputDebug(SystemFlags::debugSystem,"In [%s::%s Line: %d]\n",__FILE__,__FUNCTION__,__LINE__);
+    if(SystemFlags::isDebugEnabled(SystemFlags::debugSystem)) SystemFlags::OutputDebug(SystemFlags::debugSystem,"In [%s::%s Line: %d]\n",__FILE__,__FUNCTION__,__LINE__);
 	checksum->addFile(path);
 
 	//printf("[%s:%s] Line: %d\n",__FILE__,__FUNCTION__,__LINE__);
@@ -510,7 +464,7 @@ Checksum World::loadScenario(const string &path, Checksum *checksum, bool resetC
 	}
 
 	scenarioChecksum = scenario.load(path);
-	if(SystemFlags::getSystemSettingType(SystemFlags::debugSystem).enabled) SystemFlags::OutputDebug(SystemFlags::debugSystem,"In [%s::%s Line: %d]\n",__FILE__,__FUNCTION__,__LINE__);
+	if(SystemFlags::isDebugEnabled(SystemFlags::debugSystem)) SystemFlags::OutputDebug(SystemFlags::debugSystem,"In [%s::%s Line: %d]\n",__FILE__,__FUNCTION__,__LINE__);
 	return scenarioChecksum;
 }
 
@@ -522,6 +476,8 @@ void World::setQueuedScenario(string scenarioName,bool keepFactions) {
 }
 
 void World::updateAllTilesetObjects() {
+	PROFILE_ZONE("World::updateAllTilesetObjects");
+
 	Gui *gui = this->game->getGuiPtr();
 	if(gui != NULL) {
 		Object *selObj = gui->getHighlightedResourceObject();
@@ -573,7 +529,48 @@ void World::updateAllTilesetObjects() {
 //	}
 }
 
+bool World::precacheUnitCommandsOnTaskPool() {
+	if(taskPool == NULL) {
+		return false;
+	}
+
+	// One task per faction walking its units in order, like the faction
+	// threads do. Units of one faction share the faction's random generator
+	// and resource target cache, so they must not run at the same time
+	precacheUnitCount = 0;
+	int factionCount = getFactionCount();
+	for(int i = 0; i < factionCount; ++i) {
+		Faction *faction = getFaction(i);
+
+		int unitCount = faction->getUnitCount();
+		for(int j = 0; j < unitCount; ++j) {
+			Unit *unit = faction->getUnit(j);
+			if(unit == NULL) {
+				throw megaglest_runtime_error("unit == NULL");
+			}
+			if(unit->needToUpdate() == true) {
+				precacheUnitCount++;
+			}
+		}
+	}
+
+	taskPool->runTasks(this, factionCount);
+	return true;
+}
+
+void World::runPoolTask(int taskIndex, int workerIndex) {
+	Faction *faction = getFaction(taskIndex);
+	int unitCount = faction->getUnitCount();
+	for(int j = 0; j < unitCount; ++j) {
+		Unit *unit = faction->getUnit(j);
+		if(unit->needToUpdate() == true) {
+			unitUpdater.updateUnitCommand(unit,frameCount);
+		}
+	}
+}
+
 void World::updateAllFactionUnits() {
+	PROFILE_ZONE("World::updateAllFactionUnits");
 	bool showPerfStats = Config::getInstance().getBool("ShowPerfStats","false");
 	Chrono chronoPerf;
 	if(showPerfStats) chronoPerf.start();
@@ -608,6 +605,8 @@ void World::updateAllFactionUnits() {
 		faction->clearUnitsPathfinding();
 		faction->clearWorldSynchThreadedLogList();
 	}
+	// the precache threads below read the cluster layers without locking
+	map.getClusterMap()->refreshLayers();
 
 	if(showPerfStats) {
 		sprintf(perfBuf,"In [%s::%s] Line: %d took msecs: " MG_I64_SPECIFIER "\n",extractFileFromDirectoryPath(__FILE__).c_str(),__FUNCTION__,__LINE__,chronoPerf.getMillis());
@@ -618,7 +617,15 @@ void World::updateAllFactionUnits() {
 	chrono.start();
 
 	const bool newThreadManager = Config::getInstance().getBool("EnableNewThreadManager","false");
-	if(newThreadManager == true) {
+	if(precacheUnitCommandsOnTaskPool() == true) {
+		if(SystemFlags::VERBOSE_MODE_ENABLED && chrono.getMillis() >= 10) printf("In [%s::%s Line: %d] *** Task pool preprocessing took [%lld] msecs for %d units for frameCount = %d.\n",__FILE__,__FUNCTION__,__LINE__,(long long int)chrono.getMillis(),precacheUnitCount,frameCount);
+
+		if(showPerfStats) {
+			sprintf(perfBuf,"In [%s::%s] Line: %d took msecs: " MG_I64_SPECIFIER "\n",extractFileFromDirectoryPath(__FILE__).c_str(),__FUNCTION__,__LINE__,chronoPerf.getMillis());
+			perfList.push_back(perfBuf);
+		}
+	}
+	else if(newThreadManager == true) {
 		masterController.signalSlaves(&frameCount);
 		bool slavesCompleted = masterController.waitTillSlavesTrigger(20000);
 
@@ -631,10 +638,12 @@ void World::updateAllFactionUnits() {
 
 	}
 	else {
-		// Signal the faction threads to do any pre-processing
+		// Signal the faction threads to do any pre-processing, each one
+		// counts the latch down once its frame is done
+		int latchGeneration = factionThreadsCompleted.reset(factionCount);
 		for(int i = 0; i < factionCount; ++i) {
 			Faction *faction = getFaction(i);
-			faction->signalWorkerThread(frameCount);
+			faction->signalWorkerThread(frameCount,&factionThreadsCompleted,latchGeneration);
 		}
 
 		if(showPerfStats) {
@@ -646,22 +655,9 @@ void World::updateAllFactionUnits() {
 		chrono.start();
 
 		const int MAX_FACTION_THREAD_WAIT_MILLISECONDS = 20000;
-		for(;chrono.getMillis() < MAX_FACTION_THREAD_WAIT_MILLISECONDS;) {
-			bool workThreadsFinished = true;
-			for(int i = 0; i < factionCount; ++i) {
-				Faction *faction = getFaction(i);
-				if(faction->isWorkerThreadSignalCompleted(frameCount) == false) {
-					workThreadsFinished = false;
-					break;
-				}
-			}
-			if(workThreadsFinished == true) {
-				break;
-			}
-			// WARNING... Sleep in here causes the server to lag a bit
-			//if(chrono.getMillis() % 5 == 0) {
-			//	sleep(0);
-			//}
+		bool workThreadsFinished = factionThreadsCompleted.waitTillCompleted(MAX_FACTION_THREAD_WAIT_MILLISECONDS);
+		if(workThreadsFinished == false) {
+			SystemFlags::OutputDebug(SystemFlags::debugError,"In [%s::%s Line: %d] Faction threads did not finish frameCount = %d within %d msecs, %d still busy\n",extractFileFromDirectoryPath(__FILE__).c_str(),__FUNCTION__,__LINE__,frameCount,MAX_FACTION_THREAD_WAIT_MILLISECONDS,factionThreadsCompleted.getCount());
 		}
 
 		if(showPerfStats) {
@@ -677,6 +673,12 @@ void World::updateAllFactionUnits() {
 		perfList.push_back(perfBuf);
 	}
 
+	// Time the main thread spent blocked on the precache workers
+	if(this->game) this->game->addPerformanceCount("updateAllFactionUnits worker wait",chrono.getMillis());
+
+	// Hand the paths found by the precache threads to their factions
+	unitUpdater.mergePathFinderPrecache();
+
 	//units
 	Chrono chronoPerfUnit;
 	int totalUnitsChecked = 0;
@@ -771,17 +773,19 @@ void World::updateAllFactionUnits() {
 }
 
 void World::underTakeDeadFactionUnits() {
-	if(SystemFlags::getSystemSettingType(SystemFlags::debugSystem).enabled) SystemFlags::OutputDebug(SystemFlags::debugSystem,"In [%s::%s Line: %d]\n",extractFileFromDirectoryPath(__FILE__).c_str(),__FUNCTION__,__LINE__);
+	PROFILE_ZONE("World::underTakeDeadFactionUnits");
+
+	if(SystemFlags::isDebugEnabled(SystemFlags::debugSystem)) SystemFlags::OutputDebug(SystemFlags::debugSystem,"In [%s::%s Line: %d]\n",extractFileFromDirectoryPath(__FILE__).c_str(),__FUNCTION__,__LINE__);
 
 	int factionCount = getFactionCount();
-	if(SystemFlags::getSystemSettingType(SystemFlags::debugUnitCommands).enabled) SystemFlags::OutputDebug(SystemFlags::debugUnitCommands,"In [%s::%s Line: %d] factionCount = %d\n",__FILE__,__FUNCTION__,__LINE__,factionCount);
-	if(SystemFlags::getSystemSettingType(SystemFlags::debugSystem).enabled) SystemFlags::OutputDebug(SystemFlags::debugSystem,"In [%s::%s Line: %d]\n",extractFileFromDirectoryPath(__FILE__).c_str(),__FUNCTION__,__LINE__);
+	if(SystemFlags::isDebugEnabled(SystemFlags::debugUnitCommands)) SystemFlags::OutputDebug(SystemFlags::debugUnitCommands,"In [%s::%s Line: %d] factionCount = %d\n",__FILE__,__FUNCTION__,__LINE__,factionCount);
+	if(SystemFlags::isDebugEnabled(SystemFlags::debugSystem)) SystemFlags::OutputDebug(SystemFlags::debugSystem,"In [%s::%s Line: %d]\n",extractFileFromDirectoryPath(__FILE__).c_str(),__FUNCTION__,__LINE__);
 
 	//undertake the dead
 	for(int i = 0; i< factionCount; ++i) {
 		Faction *faction = getFaction(i);
 		int unitCount = faction->getUnitCount();
-		if(SystemFlags::getSystemSettingType(SystemFlags::debugUnitCommands).enabled) SystemFlags::OutputDebug(SystemFlags::debugUnitCommands,"In [%s::%s Line: %d] i = %d, unitCount = %d\n",__FILE__,__FUNCTION__,__LINE__,i,unitCount);
+		if(SystemFlags::isDebugEnabled(SystemFlags::debugUnitCommands)) SystemFlags::OutputDebug(SystemFlags::debugUnitCommands,"In [%s::%s Line: %d] i = %d, unitCount = %d\n",__FILE__,__FUNCTION__,__LINE__,i,unitCount);
 
 		for(int j= unitCount - 1; j >= 0; j--) {
 			Unit *unit= faction->getUnit(j);
@@ -791,20 +795,22 @@ void World::underTakeDeadFactionUnits() {
 			}
 
 			if(unit->getToBeUndertaken() == true) {
-				if(SystemFlags::getSystemSettingType(SystemFlags::debugSystem).enabled) SystemFlags::OutputDebug(SystemFlags::debugSystem,"In [%s::%s Line: %d]\n",extractFileFromDirectoryPath(__FILE__).c_str(),__FUNCTION__,__LINE__);
+				if(SystemFlags::isDebugEnabled(SystemFlags::debugSystem)) SystemFlags::OutputDebug(SystemFlags::debugSystem,"In [%s::%s Line: %d]\n",extractFileFromDirectoryPath(__FILE__).c_str(),__FUNCTION__,__LINE__);
 
 				unit->undertake();
 				delete unit;
 
-				if(SystemFlags::getSystemSettingType(SystemFlags::debugSystem).enabled) SystemFlags::OutputDebug(SystemFlags::debugSystem,"In [%s::%s Line: %d]\n",extractFileFromDirectoryPath(__FILE__).c_str(),__FUNCTION__,__LINE__);
+				if(SystemFlags::isDebugEnabled(SystemFlags::debugSystem)) SystemFlags::OutputDebug(SystemFlags::debugSystem,"In [%s::%s Line: %d]\n",extractFileFromDirectoryPath(__FILE__).c_str(),__FUNCTION__,__LINE__);
 			}
 			}
 
 	}
-	if(SystemFlags::getSystemSettingType(SystemFlags::debugSystem).enabled) SystemFlags::OutputDebug(SystemFlags::debugSystem,"In [%s::%s Line: %d]\n",extractFileFromDirectoryPath(__FILE__).c_str(),__FUNCTION__,__LINE__);
+	if(SystemFlags::isDebugEnabled(SystemFlags::debugSystem)) SystemFlags::OutputDebug(SystemFlags::debugSystem,"In [%s::%s Line: %d]\n",extractFileFromDirectoryPath(__FILE__).c_str(),__FUNCTION__,__LINE__);
 }
 
 void World::updateAllFactionConsumableCosts() {
+	PROFILE_ZONE("World::updateAllFactionConsumableCosts");
+
 	//food costs
 	bool warningSoundNeeded=false;
 	int resourceTypeCount = techTree->getResourceTypeCount();
@@ -829,8 +835,9 @@ void World::updateAllFactionConsumableCosts() {
 }
 
 void World::update() {
+	PROFILE_ZONE("World::update");
 
-	if(SystemFlags::getSystemSettingType(SystemFlags::debugSystem).enabled) SystemFlags::OutputDebug(SystemFlags::debugSystem,"In [%s::%s Line: %d]\n",extractFileFromDirectoryPath(__FILE__).c_str(),__FUNCTION__,__LINE__);
+	if(SystemFlags::isDebugEnabled(SystemFlags::debugSystem)) SystemFlags::OutputDebug(SystemFlags::debugSystem,"In [%s::%s Line: %d]\n",extractFileFromDirectoryPath(__FILE__).c_str(),__FUNCTION__,__LINE__);
 
 	bool showPerfStats = Config::getInstance().getBool("ShowPerfStats","false");
 	Chrono chronoPerf;
@@ -861,7 +868,7 @@ void World::update() {
 		perfList.push_back(perfBuf);
 	}
 
-	if(SystemFlags::getSystemSettingType(SystemFlags::debugSystem).enabled) SystemFlags::OutputDebug(SystemFlags::debugSystem,"In [%s::%s Line: %d]\n",extractFileFromDirectoryPath(__FILE__).c_str(),__FUNCTION__,__LINE__);
+	if(SystemFlags::isDebugEnabled(SystemFlags::debugSystem)) SystemFlags::OutputDebug(SystemFlags::debugSystem,"In [%s::%s Line: %d]\n",extractFileFromDirectoryPath(__FILE__).c_str(),__FUNCTION__,__LINE__);
 	// objects on the map from tilesets
 	if(this->game) chronoGamePerformanceCounts.start();
 
@@ -899,7 +906,7 @@ void World::update() {
 			perfList.push_back(perfBuf);
 		}
 
-		if(SystemFlags::getSystemSettingType(SystemFlags::debugSystem).enabled) SystemFlags::OutputDebug(SystemFlags::debugSystem,"In [%s::%s Line: %d]\n",extractFileFromDirectoryPath(__FILE__).c_str(),__FUNCTION__,__LINE__);
+		if(SystemFlags::isDebugEnabled(SystemFlags::debugSystem)) SystemFlags::OutputDebug(SystemFlags::debugSystem,"In [%s::%s Line: %d]\n",extractFileFromDirectoryPath(__FILE__).c_str(),__FUNCTION__,__LINE__);
 
 		//food costs
 		if(this->game) chronoGamePerformanceCounts.start();
@@ -913,7 +920,7 @@ void World::update() {
 			perfList.push_back(perfBuf);
 		}
 
-		if(SystemFlags::getSystemSettingType(SystemFlags::debugSystem).enabled) SystemFlags::OutputDebug(SystemFlags::debugSystem,"In [%s::%s Line: %d]\n",extractFileFromDirectoryPath(__FILE__).c_str(),__FUNCTION__,__LINE__);
+		if(SystemFlags::isDebugEnabled(SystemFlags::debugSystem)) SystemFlags::OutputDebug(SystemFlags::debugSystem,"In [%s::%s Line: %d]\n",extractFileFromDirectoryPath(__FILE__).c_str(),__FUNCTION__,__LINE__);
 		//fow smoothing
 		if(fogOfWarSmoothing && ((frameCount+1) % (fogOfWarSmoothingFrameSkip+1)) == 0) {
 			if(this->game) chronoGamePerformanceCounts.start();
@@ -929,7 +936,7 @@ void World::update() {
 			perfList.push_back(perfBuf);
 		}
 
-		if(SystemFlags::getSystemSettingType(SystemFlags::debugSystem).enabled) SystemFlags::OutputDebug(SystemFlags::debugSystem,"In [%s::%s Line: %d]\n",extractFileFromDirectoryPath(__FILE__).c_str(),__FUNCTION__,__LINE__);
+		if(SystemFlags::isDebugEnabled(SystemFlags::debugSystem)) SystemFlags::OutputDebug(SystemFlags::debugSystem,"In [%s::%s Line: %d]\n",extractFileFromDirectoryPath(__FILE__).c_str(),__FUNCTION__,__LINE__);
 		//tick
 		bool needToTick = canTickWorld();
 
@@ -940,7 +947,7 @@ void World::update() {
 
 		if(needToTick == true) {
 			//printf("=========== World is about to be updated, current frameCount = %d\n",frameCount);
-			if(SystemFlags::getSystemSettingType(SystemFlags::debugSystem).enabled) SystemFlags::OutputDebug(SystemFlags::debugSystem,"In [%s::%s Line: %d]\n",extractFileFromDirectoryPath(__FILE__).c_str(),__FUNCTION__,__LINE__);
+			if(SystemFlags::isDebugEnabled(SystemFlags::debugSystem)) SystemFlags::OutputDebug(SystemFlags::debugSystem,"In [%s::%s Line: %d]\n",extractFileFromDirectoryPath(__FILE__).c_str(),__FUNCTION__,__LINE__);
 
 			if(this->game) chronoGamePerformanceCounts.start();
 
@@ -960,7 +967,7 @@ void World::update() {
 			printf("%s",perfList[x].c_str());
 		}
 	}
-	if(SystemFlags::getSystemSettingType(SystemFlags::debugSystem).enabled) SystemFlags::OutputDebug(SystemFlags::debugSystem,"In [%s::%s Line: %d]\n",extractFileFromDirectoryPath(__FILE__).c_str(),__FUNCTION__,__LINE__);
+	if(SystemFlags::isDebugEnabled(SystemFlags::debugSystem)) SystemFlags::OutputDebug(SystemFlags::debugSystem,"In [%s::%s Line: %d]\n",extractFileFromDirectoryPath(__FILE__).c_str(),__FUNCTION__,__LINE__);
 }
 
 bool World::canTickWorld() const {
@@ -970,6 +977,8 @@ bool World::canTickWorld() const {
 }
 
 void World::tick() {
+	PROFILE_ZONE("World::tick");
+
 	bool showPerfStats = Config::getInstance().getBool("ShowPerfStats","false");
 	Chrono chronoPerf;
 	char perfBuf[8096]="";
@@ -1277,19 +1286,19 @@ bool World::toRenderUnit(const UnitBuildInfo &pendingUnit) const {
 }
 
 void World::morphToUnit(int unitId,const string &morphName,bool ignoreRequirements) {
-	if(SystemFlags::getSystemSettingType(SystemFlags::debugLUA).enabled) SystemFlags::OutputDebug(SystemFlags::debugLUA,"In [%s::%s Line: %d] unit [%d] morphName [%s] forceUpgradesIfRequired = %d\n",__FILE__,__FUNCTION__,__LINE__,unitId,morphName.c_str(),ignoreRequirements);
+	if(SystemFlags::isDebugEnabled(SystemFlags::debugLUA)) SystemFlags::OutputDebug(SystemFlags::debugLUA,"In [%s::%s Line: %d] unit [%d] morphName [%s] forceUpgradesIfRequired = %d\n",__FILE__,__FUNCTION__,__LINE__,unitId,morphName.c_str(),ignoreRequirements);
 	Unit* unit= findUnitById(unitId);
 	if(unit != NULL) {
 		for(int i = 0; i < unit->getType()->getCommandTypeCount(); ++i) {
 			const CommandType *ct = unit->getType()->getCommandType(i);
 			const MorphCommandType *mct = dynamic_cast<const MorphCommandType *>(ct);
 			if(mct != NULL && mct->getName(false) == morphName) {
-				if(SystemFlags::getSystemSettingType(SystemFlags::debugLUA).enabled) SystemFlags::OutputDebug(SystemFlags::debugLUA,"In [%s::%s Line: %d] unit [%d] morphName [%s] comparing mct [%s]\n",__FILE__,__FUNCTION__,__LINE__,unitId,morphName.c_str(),mct->getName(false).c_str());
+				if(SystemFlags::isDebugEnabled(SystemFlags::debugLUA)) SystemFlags::OutputDebug(SystemFlags::debugLUA,"In [%s::%s Line: %d] unit [%d] morphName [%s] comparing mct [%s]\n",__FILE__,__FUNCTION__,__LINE__,unitId,morphName.c_str(),mct->getName(false).c_str());
 
 				std::pair<CommandResult,string> cr(crFailUndefined,"");
 				try {
 					if(unit->getFaction()->reqsOk(mct) == false && ignoreRequirements == true) {
-						if(SystemFlags::getSystemSettingType(SystemFlags::debugLUA).enabled) SystemFlags::OutputDebug(SystemFlags::debugLUA,"In [%s::%s Line: %d] unit [%d] morphName [%s] comparing mct [%s] mct->getUpgradeReqCount() = %d\n",__FILE__,__FUNCTION__,__LINE__,unitId,morphName.c_str(),mct->getName(false).c_str(),mct->getUpgradeReqCount());
+						if(SystemFlags::isDebugEnabled(SystemFlags::debugLUA)) SystemFlags::OutputDebug(SystemFlags::debugLUA,"In [%s::%s Line: %d] unit [%d] morphName [%s] comparing mct [%s] mct->getUpgradeReqCount() = %d\n",__FILE__,__FUNCTION__,__LINE__,unitId,morphName.c_str(),mct->getName(false).c_str(),mct->getUpgradeReqCount());
 						unit->setIgnoreCheckCommand(true);
 					}
 
@@ -1297,32 +1306,32 @@ void World::morphToUnit(int unitId,const string &morphName,bool ignoreRequiremen
 					cr = this->game->getCommander()->tryGiveCommand(unit, mct,unit->getPos(), unitType,CardinalDir(CardinalDir::NORTH));
 				}
 				catch(const exception &ex) {
-					if(SystemFlags::getSystemSettingType(SystemFlags::debugLUA).enabled) SystemFlags::OutputDebug(SystemFlags::debugLUA,"In [%s::%s Line: %d]\n",__FILE__,__FUNCTION__,__LINE__);
+					if(SystemFlags::isDebugEnabled(SystemFlags::debugLUA)) SystemFlags::OutputDebug(SystemFlags::debugLUA,"In [%s::%s Line: %d]\n",__FILE__,__FUNCTION__,__LINE__);
 					unit->setIgnoreCheckCommand(false);
 
 					throw megaglest_runtime_error(ex.what());
 				}
 
 				if(cr.first == crSuccess) {
-					if(SystemFlags::getSystemSettingType(SystemFlags::debugLUA).enabled) SystemFlags::OutputDebug(SystemFlags::debugLUA,"In [%s::%s Line: %d]\n",__FILE__,__FUNCTION__,__LINE__);
+					if(SystemFlags::isDebugEnabled(SystemFlags::debugLUA)) SystemFlags::OutputDebug(SystemFlags::debugLUA,"In [%s::%s Line: %d]\n",__FILE__,__FUNCTION__,__LINE__);
 				}
 				else {
-					if(SystemFlags::getSystemSettingType(SystemFlags::debugLUA).enabled) SystemFlags::OutputDebug(SystemFlags::debugLUA,"In [%s::%s Line: %d]\n",__FILE__,__FUNCTION__,__LINE__);
+					if(SystemFlags::isDebugEnabled(SystemFlags::debugLUA)) SystemFlags::OutputDebug(SystemFlags::debugLUA,"In [%s::%s Line: %d]\n",__FILE__,__FUNCTION__,__LINE__);
 				}
 
-				if(SystemFlags::getSystemSettingType(SystemFlags::debugLUA).enabled) SystemFlags::OutputDebug(SystemFlags::debugLUA,"In [%s::%s Line: %d] unit [%d] morphName [%s] comparing mct [%s] returned = %d\n",__FILE__,__FUNCTION__,__LINE__,unitId,morphName.c_str(),mct->getName(false).c_str(),cr.first);
+				if(SystemFlags::isDebugEnabled(SystemFlags::debugLUA)) SystemFlags::OutputDebug(SystemFlags::debugLUA,"In [%s::%s Line: %d] unit [%d] morphName [%s] comparing mct [%s] returned = %d\n",__FILE__,__FUNCTION__,__LINE__,unitId,morphName.c_str(),mct->getName(false).c_str(),cr.first);
 
 				break;
 			}
 		}
 
 
-		if(SystemFlags::getSystemSettingType(SystemFlags::debugLUA).enabled) SystemFlags::OutputDebug(SystemFlags::debugLUA,"In [%s::%s Line: %d]\n",__FILE__,__FUNCTION__,__LINE__);
+		if(SystemFlags::isDebugEnabled(SystemFlags::debugLUA)) SystemFlags::OutputDebug(SystemFlags::debugLUA,"In [%s::%s Line: %d]\n",__FILE__,__FUNCTION__,__LINE__);
 	}
 }
 
 void World::createUnit(const string &unitName, int factionIndex, const Vec2i &pos, bool spaciated) {
-	if(SystemFlags::getSystemSettingType(SystemFlags::debugUnitCommands).enabled) SystemFlags::OutputDebug(SystemFlags::debugUnitCommands,"In [%s::%s Line: %d] unitName [%s] factionIndex = %d\n",__FILE__,__FUNCTION__,__LINE__,unitName.c_str(),factionIndex);
+	if(SystemFlags::isDebugEnabled(SystemFlags::debugUnitCommands)) SystemFlags::OutputDebug(SystemFlags::debugUnitCommands,"In [%s::%s Line: %d] unitName [%s] factionIndex = %d\n",__FILE__,__FUNCTION__,__LINE__,unitName.c_str(),factionIndex);
 
 	if(factionIndex < (int)factions.size()) {
 		Faction* faction= factions[factionIndex];
@@ -1345,7 +1354,7 @@ void World::createUnit(const string &unitName, int factionIndex, const Vec2i &po
 
 		Unit* unit= new Unit(getNextUnitId(faction), newpath, pos, ut, faction, &map, CardinalDir(CardinalDir::NORTH));
 
-		if(SystemFlags::getSystemSettingType(SystemFlags::debugUnitCommands).enabled) SystemFlags::OutputDebug(SystemFlags::debugUnitCommands,"In [%s::%s Line: %d] unit created for unit [%s]\n",__FILE__,__FUNCTION__,__LINE__,unit->toString().c_str());
+		if(SystemFlags::isDebugEnabled(SystemFlags::debugUnitCommands)) SystemFlags::OutputDebug(SystemFlags::debugUnitCommands,"In [%s::%s Line: %d] unit created for unit [%s]\n",__FILE__,__FUNCTION__,__LINE__,unit->toString().c_str());
 
 		if(placeUnit(pos, generationArea, unit, spaciated)) {
 			unit->create(true);
@@ -1365,13 +1374,13 @@ void World::createUnit(const string &unitName, int factionIndex, const Vec2i &po
 			throw megaglest_runtime_error("Unit cant be placed",true);
 		}
 
-		if(SystemFlags::getSystemSettingType(SystemFlags::debugUnitCommands).enabled) SystemFlags::OutputDebug(SystemFlags::debugUnitCommands,"In [%s::%s Line: %d] unit created for unit [%s]\n",__FILE__,__FUNCTION__,__LINE__,unit->toString().c_str());
+		if(SystemFlags::isDebugEnabled(SystemFlags::debugUnitCommands)) SystemFlags::OutputDebug(SystemFlags::debugUnitCommands,"In [%s::%s Line: %d] unit created for unit [%s]\n",__FILE__,__FUNCTION__,__LINE__,unit->toString().c_str());
 	}
 	else {
 		throw megaglest_runtime_error("Invalid faction index in createUnitAtPosition: " + intToStr(factionIndex),true);
 	}
 
-	if(SystemFlags::getSystemSettingType(SystemFlags::debugUnitCommands).enabled) SystemFlags::OutputDebug(SystemFlags::debugUnitCommands,"In [%s::%s Line: %d]\n",__FILE__,__FUNCTION__,__LINE__);
+	if(SystemFlags::isDebugEnabled(SystemFlags::debugUnitCommands)) SystemFlags::OutputDebug(SystemFlags::debugUnitCommands,"In [%s::%s Line: %d]\n",__FILE__,__FUNCTION__,__LINE__);
 }
 
 void World::giveResource(const string &resourceName, int factionIndex, int amount) {
@@ -1387,7 +1396,7 @@ void World::giveResource(const string &resourceName, int factionIndex, int amoun
 
 int World::getUnitCurrentField(int unitId) {
 	int field = -1;
-	if(SystemFlags::getSystemSettingType(SystemFlags::debugLUA).enabled) SystemFlags::OutputDebug(SystemFlags::debugLUA,"In [%s::%s Line: %d] unit [%d]\n",__FILE__,__FUNCTION__,__LINE__,unitId);
+	if(SystemFlags::isDebugEnabled(SystemFlags::debugLUA)) SystemFlags::OutputDebug(SystemFlags::debugLUA,"In [%s::%s Line: %d] unit [%d]\n",__FILE__,__FUNCTION__,__LINE__,unitId);
 	Unit* unit= findUnitById(unitId);
 	if(unit != NULL) {
 		field = unit->getCurrField();
@@ -1398,7 +1407,7 @@ int World::getUnitCurrentField(int unitId) {
 
 bool World::getIsUnitAlive(int unitId) {
 	bool result = false;
-	if(SystemFlags::getSystemSettingType(SystemFlags::debugLUA).enabled) SystemFlags::OutputDebug(SystemFlags::debugLUA,"In [%s::%s Line: %d] unit [%d]\n",__FILE__,__FUNCTION__,__LINE__,unitId);
+	if(SystemFlags::isDebugEnabled(SystemFlags::debugLUA)) SystemFlags::OutputDebug(SystemFlags::debugLUA,"In [%s::%s Line: %d] unit [%d]\n",__FILE__,__FUNCTION__,__LINE__,unitId);
 	Unit* unit= findUnitById(unitId);
 	if(unit != NULL) {
 		result = unit->isAlive();
@@ -1470,9 +1479,9 @@ void World::givePositionCommand(int unitId, const string &commandName, const Vec
 		if(unit->getType()->getFirstCtOfClass(cc) == NULL) {
 			throw megaglest_runtime_error("Invalid command: [" + commandName + "] for unit: [" + unit->getType()->getName(false) + "] id [" + intToStr(unit->getId()) + "]",true);
 		}
-		if(SystemFlags::getSystemSettingType(SystemFlags::debugUnitCommands).enabled) SystemFlags::OutputDebug(SystemFlags::debugUnitCommands,"In [%s::%s Line: %d] cc = %d Unit [%s]\n",__FILE__,__FUNCTION__,__LINE__,cc,unit->getFullName(false).c_str());
+		if(SystemFlags::isDebugEnabled(SystemFlags::debugUnitCommands)) SystemFlags::OutputDebug(SystemFlags::debugUnitCommands,"In [%s::%s Line: %d] cc = %d Unit [%s]\n",__FILE__,__FUNCTION__,__LINE__,cc,unit->getFullName(false).c_str());
 		unit->giveCommand(new Command( unit->getType()->getFirstCtOfClass(cc), pos ));
-		if(SystemFlags::getSystemSettingType(SystemFlags::debugUnitCommands).enabled) SystemFlags::OutputDebug(SystemFlags::debugUnitCommands,"In [%s::%s Line: %d]\n",__FILE__,__FUNCTION__,__LINE__);
+		if(SystemFlags::isDebugEnabled(SystemFlags::debugUnitCommands)) SystemFlags::OutputDebug(SystemFlags::debugUnitCommands,"In [%s::%s Line: %d]\n",__FILE__,__FUNCTION__,__LINE__);
 	}
 	else {
 		throw megaglest_runtime_error("Invalid unitId index in givePositionCommand: " + intToStr(unitId) + " commandName = " + commandName,true);
@@ -1484,10 +1493,10 @@ void World::giveStopCommand(int unitId) {
 	if(unit != NULL) {
 		const CommandType *ct = unit->getType()->getFirstCtOfClass(ccStop);
 		if(ct != NULL) {
-			if(SystemFlags::getSystemSettingType(SystemFlags::debugUnitCommands).enabled) SystemFlags::OutputDebug(SystemFlags::debugUnitCommands,"In [%s::%s Line: %d] Unit [%s] will stop\n",__FILE__,__FUNCTION__,__LINE__,unit->getFullName(false).c_str());
+			if(SystemFlags::isDebugEnabled(SystemFlags::debugUnitCommands)) SystemFlags::OutputDebug(SystemFlags::debugUnitCommands,"In [%s::%s Line: %d] Unit [%s] will stop\n",__FILE__,__FUNCTION__,__LINE__,unit->getFullName(false).c_str());
 			unit->giveCommand(new Command(ct));
 
-			if(SystemFlags::getSystemSettingType(SystemFlags::debugUnitCommands).enabled) SystemFlags::OutputDebug(SystemFlags::debugUnitCommands,"In [%s::%s Line: %d]\n",__FILE__,__FUNCTION__,__LINE__);
+			if(SystemFlags::isDebugEnabled(SystemFlags::debugUnitCommands)) SystemFlags::OutputDebug(SystemFlags::debugUnitCommands,"In [%s::%s Line: %d]\n",__FILE__,__FUNCTION__,__LINE__);
 		}
 		else {
 			throw megaglest_runtime_error("Invalid ct in giveStopCommand: " + intToStr(unitId),true);
@@ -1544,9 +1553,9 @@ void World::giveAttackCommand(int unitId, int unitToAttackId) {
 		if(targetUnit != NULL) {
 			const CommandType *ct = unit->getType()->getFirstAttackCommand(targetUnit->getCurrField());
 			if(ct != NULL) {
-				if(SystemFlags::getSystemSettingType(SystemFlags::debugUnitCommands).enabled) SystemFlags::OutputDebug(SystemFlags::debugUnitCommands,"In [%s::%s Line: %d] Unit [%s] is attacking [%s]\n",__FILE__,__FUNCTION__,__LINE__,unit->getFullName(false).c_str(),targetUnit->getFullName(false).c_str());
+				if(SystemFlags::isDebugEnabled(SystemFlags::debugUnitCommands)) SystemFlags::OutputDebug(SystemFlags::debugUnitCommands,"In [%s::%s Line: %d] Unit [%s] is attacking [%s]\n",__FILE__,__FUNCTION__,__LINE__,unit->getFullName(false).c_str(),targetUnit->getFullName(false).c_str());
 				unit->giveCommand(new Command(ct,targetUnit));
-				if(SystemFlags::getSystemSettingType(SystemFlags::debugUnitCommands).enabled) SystemFlags::OutputDebug(SystemFlags::debugUnitCommands,"In [%s::%s Line: %d]\n",__FILE__,__FUNCTION__,__LINE__);
+				if(SystemFlags::isDebugEnabled(SystemFlags::debugUnitCommands)) SystemFlags::OutputDebug(SystemFlags::debugUnitCommands,"In [%s::%s Line: %d]\n",__FILE__,__FUNCTION__,__LINE__);
 			}
 			else {
 				throw megaglest_runtime_error("Invalid ct in giveAttackCommand: " + intToStr(unitId) + " unitToAttackId = " + intToStr(unitToAttackId),true);
@@ -1580,13 +1589,13 @@ void World::giveProductionCommand(int unitId, const string &producedName) {
 				const ProduceCommandType *pct= dynamic_cast<const ProduceCommandType*>(ct);
 				if(pct != NULL && pct->getProducedUnit() != NULL &&
 					pct->getProducedUnit()->getName(false) == producedName) {
-					if(SystemFlags::getSystemSettingType(SystemFlags::debugUnitCommands).enabled) SystemFlags::OutputDebug(SystemFlags::debugUnitCommands,"In [%s::%s Line: %d]\n",__FILE__,__FUNCTION__,__LINE__);
+					if(SystemFlags::isDebugEnabled(SystemFlags::debugUnitCommands)) SystemFlags::OutputDebug(SystemFlags::debugUnitCommands,"In [%s::%s Line: %d]\n",__FILE__,__FUNCTION__,__LINE__);
 
 					//printf("File: %s line: %d\n",extractFileFromDirectoryPath(__FILE__).c_str(),__LINE__);
 					unit->giveCommand(new Command(pct));
 					//printf("File: %s line: %d\n",extractFileFromDirectoryPath(__FILE__).c_str(),__LINE__);
 
-					if(SystemFlags::getSystemSettingType(SystemFlags::debugUnitCommands).enabled) SystemFlags::OutputDebug(SystemFlags::debugUnitCommands,"In [%s::%s Line: %d]\n",__FILE__,__FUNCTION__,__LINE__);
+					if(SystemFlags::isDebugEnabled(SystemFlags::debugUnitCommands)) SystemFlags::OutputDebug(SystemFlags::debugUnitCommands,"In [%s::%s Line: %d]\n",__FILE__,__FUNCTION__,__LINE__);
 					break;
 				}
 			}
@@ -1611,26 +1620,26 @@ void World::giveAttackStoppedCommand(int unitId, const string &itemName, bool ig
 				const AttackStoppedCommandType *act= static_cast<const AttackStoppedCommandType*>(ct);
 				if(act != NULL && act->getName(false) == itemName) {
 
-					if(SystemFlags::getSystemSettingType(SystemFlags::debugUnitCommands).enabled) SystemFlags::OutputDebug(SystemFlags::debugUnitCommands,"In [%s::%s Line: %d]\n",__FILE__,__FUNCTION__,__LINE__);
+					if(SystemFlags::isDebugEnabled(SystemFlags::debugUnitCommands)) SystemFlags::OutputDebug(SystemFlags::debugUnitCommands,"In [%s::%s Line: %d]\n",__FILE__,__FUNCTION__,__LINE__);
 
 					try {
 						if(unit->getFaction()->reqsOk(act) == false && ignoreRequirements == true) {
 
-							if(SystemFlags::getSystemSettingType(SystemFlags::debugLUA).enabled) SystemFlags::OutputDebug(SystemFlags::debugLUA,"In [%s::%s Line: %d]\n",__FILE__,__FUNCTION__,__LINE__);
+							if(SystemFlags::isDebugEnabled(SystemFlags::debugLUA)) SystemFlags::OutputDebug(SystemFlags::debugLUA,"In [%s::%s Line: %d]\n",__FILE__,__FUNCTION__,__LINE__);
 							unit->setIgnoreCheckCommand(true);
 						}
 
 						unit->giveCommand(new Command(act));
 					}
 					catch(const exception &ex) {
-						if(SystemFlags::getSystemSettingType(SystemFlags::debugLUA).enabled) SystemFlags::OutputDebug(SystemFlags::debugLUA,"In [%s::%s Line: %d]\n",__FILE__,__FUNCTION__,__LINE__);
+						if(SystemFlags::isDebugEnabled(SystemFlags::debugLUA)) SystemFlags::OutputDebug(SystemFlags::debugLUA,"In [%s::%s Line: %d]\n",__FILE__,__FUNCTION__,__LINE__);
 						unit->setIgnoreCheckCommand(false);
 
 						throw megaglest_runtime_error(ex.what());
 					}
 
 
-					if(SystemFlags::getSystemSettingType(SystemFlags::debugUnitCommands).enabled) SystemFlags::OutputDebug(SystemFlags::debugUnitCommands,"In [%s::%s Line: %d]\n",__FILE__,__FUNCTION__,__LINE__);
+					if(SystemFlags::isDebugEnabled(SystemFlags::debugUnitCommands)) SystemFlags::OutputDebug(SystemFlags::debugUnitCommands,"In [%s::%s Line: %d]\n",__FILE__,__FUNCTION__,__LINE__);
 					break;
 				}
 			}
@@ -1642,7 +1651,7 @@ void World::giveAttackStoppedCommand(int unitId, const string &itemName, bool ig
 }
 
 void World::playStaticSound(const string &playSound) {
-	if(SystemFlags::getSystemSettingType(SystemFlags::debugLUA).enabled) SystemFlags::OutputDebug(SystemFlags::debugLUA,"In [%s::%s Line: %d] playSound [%s]\n",__FILE__,__FUNCTION__,__LINE__,playSound.c_str());
+	if(SystemFlags::isDebugEnabled(SystemFlags::debugLUA)) SystemFlags::OutputDebug(SystemFlags::debugLUA,"In [%s::%s Line: %d] playSound [%s]\n",__FILE__,__FUNCTION__,__LINE__,playSound.c_str());
 
 	string calculatedFilePath = playSound;
 	bool changed = Properties::applyTagsToValue(calculatedFilePath);
@@ -1660,7 +1669,7 @@ void World::playStaticSound(const string &playSound) {
 }
 
 void World::playStreamingSound(const string &playSound) {
-	if(SystemFlags::getSystemSettingType(SystemFlags::debugLUA).enabled) SystemFlags::OutputDebug(SystemFlags::debugLUA,"In [%s::%s Line: %d] playSound [%s]\n",__FILE__,__FUNCTION__,__LINE__,playSound.c_str());
+	if(SystemFlags::isDebugEnabled(SystemFlags::debugLUA)) SystemFlags::OutputDebug(SystemFlags::debugLUA,"In [%s::%s Line: %d] playSound [%s]\n",__FILE__,__FUNCTION__,__LINE__,playSound.c_str());
 
 	string calculatedFilePath = playSound;
 	bool changed = Properties::applyTagsToValue(calculatedFilePath);
@@ -1679,7 +1688,7 @@ void World::playStreamingSound(const string &playSound) {
 }
 
 void World::stopStreamingSound(const string &playSound) {
-	if(SystemFlags::getSystemSettingType(SystemFlags::debugLUA).enabled) SystemFlags::OutputDebug(SystemFlags::debugLUA,"In [%s::%s Line: %d] playSound [%s]\n",__FILE__,__FUNCTION__,__LINE__,playSound.c_str());
+	if(SystemFlags::isDebugEnabled(SystemFlags::debugLUA)) SystemFlags::OutputDebug(SystemFlags::debugLUA,"In [%s::%s Line: %d] playSound [%s]\n",__FILE__,__FUNCTION__,__LINE__,playSound.c_str());
 
 	string calculatedFilePath = playSound;
 	bool changed = Properties::applyTagsToValue(calculatedFilePath);
@@ -1693,7 +1702,7 @@ void World::stopStreamingSound(const string &playSound) {
 }
 
 void World::stopAllSound() {
-	if(SystemFlags::getSystemSettingType(SystemFlags::debugLUA).enabled) SystemFlags::OutputDebug(SystemFlags::debugLUA,"In [%s::%s Line: %d]\n",__FILE__,__FUNCTION__,__LINE__);
+	if(SystemFlags::isDebugEnabled(SystemFlags::debugLUA)) SystemFlags::OutputDebug(SystemFlags::debugLUA,"In [%s::%s Line: %d]\n",__FILE__,__FUNCTION__,__LINE__);
 	SoundRenderer &soundRenderer= SoundRenderer::getInstance();
 	soundRenderer.stopAllSounds();
 }
@@ -1702,12 +1711,12 @@ void World::moveToUnit(int unitId, int destUnitId) {
 	Unit* unit= findUnitById(unitId);
 	if(unit != NULL) {
 		CommandClass cc= ccMove;
-		if(SystemFlags::getSystemSettingType(SystemFlags::debugUnitCommands).enabled) SystemFlags::OutputDebug(SystemFlags::debugUnitCommands,"In [%s::%s Line: %d] cc = %d Unit [%s]\n",__FILE__,__FUNCTION__,__LINE__,cc,unit->getFullName(false).c_str());
+		if(SystemFlags::isDebugEnabled(SystemFlags::debugUnitCommands)) SystemFlags::OutputDebug(SystemFlags::debugUnitCommands,"In [%s::%s Line: %d] cc = %d Unit [%s]\n",__FILE__,__FUNCTION__,__LINE__,cc,unit->getFullName(false).c_str());
 		Unit* destUnit = findUnitById(destUnitId);
 		if(destUnit != NULL) {
-			if(SystemFlags::getSystemSettingType(SystemFlags::debugUnitCommands).enabled) SystemFlags::OutputDebug(SystemFlags::debugUnitCommands,"In [%s::%s Line: %d] cc = %d Unit [%s] destUnit [%s]\n",__FILE__,__FUNCTION__,__LINE__,cc,unit->getFullName(false).c_str(),destUnit->getFullName(false).c_str());
+			if(SystemFlags::isDebugEnabled(SystemFlags::debugUnitCommands)) SystemFlags::OutputDebug(SystemFlags::debugUnitCommands,"In [%s::%s Line: %d] cc = %d Unit [%s] destUnit [%s]\n",__FILE__,__FUNCTION__,__LINE__,cc,unit->getFullName(false).c_str(),destUnit->getFullName(false).c_str());
 			unit->giveCommand(new Command( unit->getType()->getFirstCtOfClass(cc), destUnit));
-			if(SystemFlags::getSystemSettingType(SystemFlags::debugUnitCommands).enabled) SystemFlags::OutputDebug(SystemFlags::debugUnitCommands,"In [%s::%s Line: %d]\n",__FILE__,__FUNCTION__,__LINE__);
+			if(SystemFlags::isDebugEnabled(SystemFlags::debugUnitCommands)) SystemFlags::OutputDebug(SystemFlags::debugUnitCommands,"In [%s::%s Line: %d]\n",__FILE__,__FUNCTION__,__LINE__);
 		}
 	}
 	else {
@@ -1716,10 +1725,6 @@ void World::moveToUnit(int unitId, int destUnitId) {
 }
 
 void World::clearCaches() {
-	ExploredCellsLookupItemCache.clear();
-	ExploredCellsLookupItemCacheTimer.clear();
-	ExploredCellsLookupItemCacheTimerCount = 0;
-
 	unitUpdater.clearCaches();
 }
 
@@ -1768,11 +1773,11 @@ void World::giveUpgradeCommand(int unitId, const string &upgradeName) {
 			if(ct != NULL && ct->getClass() == ccUpgrade) {
 				const UpgradeCommandType *uct= static_cast<const UpgradeCommandType*>(ct);
 				if(uct != NULL && uct->getProducedUpgrade()->getName() == upgradeName) {
-					if(SystemFlags::getSystemSettingType(SystemFlags::debugUnitCommands).enabled) SystemFlags::OutputDebug(SystemFlags::debugUnitCommands,"In [%s::%s Line: %d]\n",__FILE__,__FUNCTION__,__LINE__);
+					if(SystemFlags::isDebugEnabled(SystemFlags::debugUnitCommands)) SystemFlags::OutputDebug(SystemFlags::debugUnitCommands,"In [%s::%s Line: %d]\n",__FILE__,__FUNCTION__,__LINE__);
 
 					unit->giveCommand(new Command(uct));
 
-					if(SystemFlags::getSystemSettingType(SystemFlags::debugUnitCommands).enabled) SystemFlags::OutputDebug(SystemFlags::debugUnitCommands,"In [%s::%s Line: %d]\n",__FILE__,__FUNCTION__,__LINE__);
+					if(SystemFlags::isDebugEnabled(SystemFlags::debugUnitCommands)) SystemFlags::OutputDebug(SystemFlags::debugUnitCommands,"In [%s::%s Line: %d]\n",__FILE__,__FUNCTION__,__LINE__);
 					break;
 				}
 			}
@@ -1952,9 +1957,21 @@ int World::getUnitCountOfType(int factionIndex, const string &typeName) {
 
 //init basic cell state
 void World::initCells(bool fogOfWar) {
-	if(SystemFlags::getSystemSettingType(SystemFlags::debugSystem).enabled) SystemFlags::OutputDebug(SystemFlags::debugSystem,"In [%s::%s Line: %d]\n",__FILE__,__FUNCTION__,__LINE__);
+	if(SystemFlags::isDebugEnabled(SystemFlags::debugSystem)) SystemFlags::OutputDebug(SystemFlags::debugSystem,"In [%s::%s Line: %d]\n",__FILE__,__FUNCTION__,__LINE__);
 
 	Logger::getInstance().add(Lang::getInstance().getString("LogScreenGameLoadingStateCells","",true), true);
+
+	// visibility and exploration are whole map bit planes, set them a word at a time
+	const bool showMapResources = ((game->getGameSettings()->getFlagTypes1() & ft1_show_map_resources) == ft1_show_map_resources);
+	for (int k = 0; k < GameConstants::maxPlayers; k++) {
+		map.getExploredPlane()->fill(k, showMapResources);
+		map.getVisiblePlane()->fill(k, !fogOfWar);
+	}
+	for (int k = GameConstants::maxPlayers; k < GameConstants::maxPlayers + GameConstants::specialFactions; k++) {
+		map.getExploredPlane()->fill(k, true);
+		map.getVisiblePlane()->fill(k, true);
+	}
+
     for(int i=0; i< map.getSurfaceW(); ++i) {
         for(int j=0; j< map.getSurfaceH(); ++j) {
 
@@ -1969,17 +1986,7 @@ void World::initCells(bool fogOfWar) {
 				i/(next2Power(map.getSurfaceW())-1.f),
 				j/(next2Power(map.getSurfaceH())-1.f)));
 
-			for (int k = 0; k < GameConstants::maxPlayers; k++) {
-				sc->setExplored(k, (game->getGameSettings()->getFlagTypes1() & ft1_show_map_resources) == ft1_show_map_resources);
-				sc->setVisible(k, !fogOfWar);
-			}
-
-			for (int k = GameConstants::maxPlayers; k < GameConstants::maxPlayers + GameConstants::specialFactions; k++) {
-				sc->setExplored(k, true);
-				sc->setVisible(k, true);
-			}
-
-			if(SystemFlags::getSystemSettingType(SystemFlags::debugWorldSynch).enabled == true) {
+			if(SystemFlags::isDebugEnabled(SystemFlags::debugWorldSynch) == true) {
 				char szBuf[8096]="";
 				snprintf(szBuf,8096,"In initCells() x = %d y = %d %s %s",i,j,sc->isVisibleString().c_str(),sc->isExploredString().c_str());
 				if(Thread::isCurrentThreadMainThread()) {
@@ -1989,12 +1996,12 @@ void World::initCells(bool fogOfWar) {
 			}
 		}
     }
-    if(SystemFlags::getSystemSettingType(SystemFlags::debugSystem).enabled) SystemFlags::OutputDebug(SystemFlags::debugSystem,"In [%s::%s Line: %d]\n",__FILE__,__FUNCTION__,__LINE__);
+    if(SystemFlags::isDebugEnabled(SystemFlags::debugSystem)) SystemFlags::OutputDebug(SystemFlags::debugSystem,"In [%s::%s Line: %d]\n",__FILE__,__FUNCTION__,__LINE__);
 }
 
 //init surface textures
 void World::initSplattedTextures() {
-	if(SystemFlags::getSystemSettingType(SystemFlags::debugSystem).enabled) SystemFlags::OutputDebug(SystemFlags::debugSystem,"In [%s::%s Line: %d]\n",__FILE__,__FUNCTION__,__LINE__);
+	if(SystemFlags::isDebugEnabled(SystemFlags::debugSystem)) SystemFlags::OutputDebug(SystemFlags::debugSystem,"In [%s::%s Line: %d]\n",__FILE__,__FUNCTION__,__LINE__);
 	for(int i = 0; i < map.getSurfaceW() - 1; ++i) {
         for(int j = 0; j < map.getSurfaceH() - 1; ++j) {
 			Vec2f coord;
@@ -2026,12 +2033,13 @@ void World::initSplattedTextures() {
 			sc00->setSurfaceTexture(texture);
 		}
 	}
-	if(SystemFlags::getSystemSettingType(SystemFlags::debugSystem).enabled) SystemFlags::OutputDebug(SystemFlags::debugSystem,"In [%s::%s Line: %d]\n",__FILE__,__FUNCTION__,__LINE__);
+	tileset.splatSurfaces(taskPool, Config::getInstance().getBool("EnableSplatTextureCache","true"));
+	if(SystemFlags::isDebugEnabled(SystemFlags::debugSystem)) SystemFlags::OutputDebug(SystemFlags::debugSystem,"In [%s::%s Line: %d]\n",__FILE__,__FUNCTION__,__LINE__);
 }
 
 //creates each faction looking at each faction name contained in GameSettings
 void World::initFactionTypes(GameSettings *gs) {
-	if(SystemFlags::getSystemSettingType(SystemFlags::debugSystem).enabled) SystemFlags::OutputDebug(SystemFlags::debugSystem,"In [%s::%s Line: %d]\n",__FILE__,__FUNCTION__,__LINE__);
+	if(SystemFlags::isDebugEnabled(SystemFlags::debugSystem)) SystemFlags::OutputDebug(SystemFlags::debugSystem,"In [%s::%s Line: %d]\n",__FILE__,__FUNCTION__,__LINE__);
 	Logger::getInstance().add(Lang::getInstance().getString("LogScreenGameLoadingFactionTypes","",true), true);
 
 	if(gs == NULL) {
@@ -2054,7 +2062,7 @@ void World::initFactionTypes(GameSettings *gs) {
 
 	stats.init(gs->getFactionCount(), this->thisFactionIndex, gs->getDescription(),gs->getTech());
 
-	if(SystemFlags::getSystemSettingType(SystemFlags::debugSystem).enabled) SystemFlags::OutputDebug(SystemFlags::debugSystem,"In [%s::%s Line: %d]\n",__FILE__,__FUNCTION__,__LINE__);
+	if(SystemFlags::isDebugEnabled(SystemFlags::debugSystem)) SystemFlags::OutputDebug(SystemFlags::debugSystem,"In [%s::%s Line: %d]\n",__FILE__,__FUNCTION__,__LINE__);
 
 	//create factions
 	//printf("this->thisFactionIndex = %d\n",this->thisFactionIndex);
@@ -2065,7 +2073,7 @@ void World::initFactionTypes(GameSettings *gs) {
 		factions.push_back(newFaction);
 	}
 
-	if(SystemFlags::getSystemSettingType(SystemFlags::debugSystem).enabled) SystemFlags::OutputDebug(SystemFlags::debugSystem,"In [%s::%s Line: %d] factions.size() = %d\n",__FILE__,__FUNCTION__,__LINE__,factions.size());
+	if(SystemFlags::isDebugEnabled(SystemFlags::debugSystem)) SystemFlags::OutputDebug(SystemFlags::debugSystem,"In [%s::%s Line: %d] factions.size() = %d\n",__FILE__,__FUNCTION__,__LINE__,factions.size());
 
 	for(int i=0; i < (int)factions.size(); ++i) {
 		FactionType *ft= techTree->getTypeByName(gs->getFactionTypeName(i));
@@ -2158,7 +2166,7 @@ void World::initFactionTypes(GameSettings *gs) {
 		}
 	}
 
-	if(SystemFlags::getSystemSettingType(SystemFlags::debugSystem).enabled) SystemFlags::OutputDebug(SystemFlags::debugSystem,"In [%s::%s Line: %d]\n",__FILE__,__FUNCTION__,__LINE__);
+	if(SystemFlags::isDebugEnabled(SystemFlags::debugSystem)) SystemFlags::OutputDebug(SystemFlags::debugSystem,"In [%s::%s Line: %d]\n",__FILE__,__FUNCTION__,__LINE__);
 
 	if(factions.empty() == false) {
 		if(this->game->isMasterserverMode() == true) {
@@ -2168,20 +2176,21 @@ void World::initFactionTypes(GameSettings *gs) {
 			thisTeamIndex = getFaction(thisFactionIndex)->getTeam();
 		}
 	}
-	if(SystemFlags::getSystemSettingType(SystemFlags::debugSystem).enabled) SystemFlags::OutputDebug(SystemFlags::debugSystem,"In [%s::%s Line: %d]\n",__FILE__,__FUNCTION__,__LINE__);
+	if(SystemFlags::isDebugEnabled(SystemFlags::debugSystem)) SystemFlags::OutputDebug(SystemFlags::debugSystem,"In [%s::%s Line: %d]\n",__FILE__,__FUNCTION__,__LINE__);
 }
 
 void World::initMinimap() {
-	if(SystemFlags::getSystemSettingType(SystemFlags::debugSystem).enabled) SystemFlags::OutputDebug(SystemFlags::debugSystem,"In [%s::%s Line: %d]\n",__FILE__,__FUNCTION__,__LINE__);
+	if(SystemFlags::isDebugEnabled(SystemFlags::debugSystem)) SystemFlags::OutputDebug(SystemFlags::debugSystem,"In [%s::%s Line: %d]\n",__FILE__,__FUNCTION__,__LINE__);
 
 	minimap.init(map.getW(), map.getH(), this, game->getGameSettings()->getFogOfWar());
+	minimapFowRefresh = true;
 	Logger::getInstance().add(Lang::getInstance().getString("LogScreenGameLoadingMinimapSurface","",true), true);
 
-	if(SystemFlags::getSystemSettingType(SystemFlags::debugSystem).enabled) SystemFlags::OutputDebug(SystemFlags::debugSystem,"In [%s::%s Line: %d]\n",__FILE__,__FUNCTION__,__LINE__);
+	if(SystemFlags::isDebugEnabled(SystemFlags::debugSystem)) SystemFlags::OutputDebug(SystemFlags::debugSystem,"In [%s::%s Line: %d]\n",__FILE__,__FUNCTION__,__LINE__);
 }
 
 void World::initUnitsForScenario() {
-	if(SystemFlags::getSystemSettingType(SystemFlags::debugSystem).enabled) SystemFlags::OutputDebug(SystemFlags::debugSystem,"In [%s::%s Line: %d]\n",__FILE__,__FUNCTION__,__LINE__);
+	if(SystemFlags::isDebugEnabled(SystemFlags::debugSystem)) SystemFlags::OutputDebug(SystemFlags::debugSystem,"In [%s::%s Line: %d]\n",__FILE__,__FUNCTION__,__LINE__);
 	Logger::getInstance().add(Lang::getInstance().getString("LogScreenGameLoadingGenerateGameElements","",true), true);
 
 	//put starting units
@@ -2210,7 +2219,7 @@ void World::initUnitsForScenario() {
 			if (unit->getType()->hasSkillClass(scBeBuilt)) {
 				map.flatternTerrain(unit);
 			}
-			if(SystemFlags::getSystemSettingType(SystemFlags::debugSystem).enabled) SystemFlags::OutputDebug(SystemFlags::debugSystem,"In [%s::%s Line: %d] unit created for unit [%s]\n",__FILE__,__FUNCTION__,__LINE__,unit->toString().c_str());
+			if(SystemFlags::isDebugEnabled(SystemFlags::debugSystem)) SystemFlags::OutputDebug(SystemFlags::debugSystem,"In [%s::%s Line: %d] unit created for unit [%s]\n",__FILE__,__FUNCTION__,__LINE__,unit->toString().c_str());
 		}
 
 		// Ensure Starting Resource Amount are adjusted to max store levels
@@ -2218,7 +2227,7 @@ void World::initUnitsForScenario() {
 	}
 	map.computeNormals();
 	map.computeInterpolatedHeights();
-	if(SystemFlags::getSystemSettingType(SystemFlags::debugSystem).enabled) SystemFlags::OutputDebug(SystemFlags::debugSystem,"In [%s::%s Line: %d]\n",__FILE__,__FUNCTION__,__LINE__);
+	if(SystemFlags::isDebugEnabled(SystemFlags::debugSystem)) SystemFlags::OutputDebug(SystemFlags::debugSystem,"In [%s::%s Line: %d]\n",__FILE__,__FUNCTION__,__LINE__);
 }
 
 void World::placeUnitAtLocation(const Vec2i &location, int radius, Unit *unit, bool spaciated) {
@@ -2242,13 +2251,13 @@ void World::placeUnitAtLocation(const Vec2i &location, int radius, Unit *unit, b
 	if (unit->getType()->hasSkillClass(scBeBuilt)) {
 		map.flatternTerrain(unit);
 	}
-	if(SystemFlags::getSystemSettingType(SystemFlags::debugSystem).enabled) SystemFlags::OutputDebug(SystemFlags::debugSystem,"In [%s::%s Line: %d] unit created for unit [%s]\n",__FILE__,__FUNCTION__,__LINE__,unit->toString().c_str());
+	if(SystemFlags::isDebugEnabled(SystemFlags::debugSystem)) SystemFlags::OutputDebug(SystemFlags::debugSystem,"In [%s::%s Line: %d] unit created for unit [%s]\n",__FILE__,__FUNCTION__,__LINE__,unit->toString().c_str());
 
 }
 
 //place units randomly aroud start location
 void World::initUnits() {
-	if(SystemFlags::getSystemSettingType(SystemFlags::debugSystem).enabled) SystemFlags::OutputDebug(SystemFlags::debugSystem,"In [%s::%s Line: %d]\n",__FILE__,__FUNCTION__,__LINE__);
+	if(SystemFlags::isDebugEnabled(SystemFlags::debugSystem)) SystemFlags::OutputDebug(SystemFlags::debugSystem,"In [%s::%s Line: %d]\n",__FILE__,__FUNCTION__,__LINE__);
 	Logger::getInstance().add(Lang::getInstance().getString("LogScreenGameLoadingGenerateGameElements","",true), true);
 
 	bool gotError = false;
@@ -2293,6 +2302,15 @@ void World::initUnits() {
 			//printf("Load game setting unit pos\n");
 			refreshAllUnitExplorations();
 		}
+
+		// Creating the units queued their own sounds, warm up the sounds
+		// of what they create next before the game starts playing them
+		for(int i = 0; i < getFactionCount(); ++i) {
+			Faction *f= factions[i];
+			for(int j = 0; j < f->getUnitCount(); ++j) {
+				f->getUnit(j)->getType()->prefetchProducibleSounds();
+			}
+		}
 	}
 	catch(const megaglest_runtime_error &ex) {
 		gotError = true;
@@ -2321,7 +2339,7 @@ void World::initUnits() {
 	if(gotError == true) {
 		throw megaglest_runtime_error(sErrBuf,!skipStackTrace);
 	}
-	if(SystemFlags::getSystemSettingType(SystemFlags::debugSystem).enabled) SystemFlags::OutputDebug(SystemFlags::debugSystem,"In [%s::%s Line: %d]\n",__FILE__,__FUNCTION__,__LINE__);
+	if(SystemFlags::isDebugEnabled(SystemFlags::debugSystem)) SystemFlags::OutputDebug(SystemFlags::debugSystem,"In [%s::%s Line: %d]\n",__FILE__,__FUNCTION__,__LINE__);
 }
 
 void World::refreshAllUnitExplorations() {
@@ -2336,149 +2354,112 @@ void World::refreshAllUnitExplorations() {
 }
 
 void World::initMap() {
-	if(SystemFlags::getSystemSettingType(SystemFlags::debugSystem).enabled) SystemFlags::OutputDebug(SystemFlags::debugSystem,"In [%s::%s Line: %d]\n",__FILE__,__FUNCTION__,__LINE__);
+	if(SystemFlags::isDebugEnabled(SystemFlags::debugSystem)) SystemFlags::OutputDebug(SystemFlags::debugSystem,"In [%s::%s Line: %d]\n",__FILE__,__FUNCTION__,__LINE__);
 	map.init(&tileset);
-	if(SystemFlags::getSystemSettingType(SystemFlags::debugSystem).enabled) SystemFlags::OutputDebug(SystemFlags::debugSystem,"In [%s::%s Line: %d]\n",__FILE__,__FUNCTION__,__LINE__);
-}
 
-void World::exploreCells(int teamIndex, ExploredCellsLookupItem &exploredCellsCache) {
-	std::vector<SurfaceCell*> &cellList = exploredCellsCache.exploredCellList;
-	for (int idx2 = 0; idx2 < (int)cellList.size(); ++idx2) {
-		SurfaceCell* sc = cellList[idx2];
-		sc->setExplored(teamIndex, true);
-	}
-	cellList = exploredCellsCache.visibleCellList;
-	for (int idx2 = 0; idx2 < (int)cellList.size(); ++idx2) {
-		SurfaceCell* sc = cellList[idx2];
-		sc->setVisible(teamIndex, true);
+	// label connectivity for single cell units and every mobile unit type
+	// now, the precache workers only read layers that already exist
+	ClusterMap *clusterMap = map.getClusterMap();
+	for(int field = fLand; field < fieldCount; ++field) {
+		clusterMap->prepareLayer(static_cast<Field>(field), 1);
 	}
-}
-
-// ==================== exploration ====================
-
-ExploredCellsLookupItem World::exploreCells(const Vec2i &newPos, int sightRange, int teamIndex, Unit *unit) {
-	// cache lookup of previously calculated cells + sight range
-	if(MaxExploredCellsLookupItemCache > 0) {
-		if(difftime(time(NULL),ExploredCellsLookupItem::lastDebug) >= 10) {
-			ExploredCellsLookupItem::lastDebug = time(NULL);
-			if(SystemFlags::getSystemSettingType(SystemFlags::debugSystem).enabled) SystemFlags::OutputDebug(SystemFlags::debugSystem,"In [%s::%s Line: %d] ExploredCellsLookupItemCache.size() = %d\n",__FILE__,__FUNCTION__,__LINE__,ExploredCellsLookupItemCache.size());
-			if(SystemFlags::getSystemSettingType(SystemFlags::debugPerformance).enabled) SystemFlags::OutputDebug(SystemFlags::debugPerformance,"In [%s::%s Line: %d] ExploredCellsLookupItemCache.size() = %d\n",__FILE__,__FUNCTION__,__LINE__,ExploredCellsLookupItemCache.size());
+	for(int i = 0; i < getFactionCount(); ++i) {
+		const FactionType *factionType = getFaction(i)->getType();
+		if(factionType == NULL) {
+			continue;
 		}
-
-		// Ok we limit the cache size due to possible RAM constraints when
-		// the threshold is met
-		bool MaxExploredCellsLookupItemCacheTriggered = false;
-		if((int)ExploredCellsLookupItemCache.size() >= MaxExploredCellsLookupItemCache) {
-			MaxExploredCellsLookupItemCacheTriggered = true;
-			// Snag the oldest entry in the list
-			std::map<int,ExploredCellsLookupKey>::reverse_iterator purgeItem = ExploredCellsLookupItemCacheTimer.rbegin();
-
-			ExploredCellsLookupItemCache[purgeItem->second.pos].erase(purgeItem->second.sightRange);
-
-			if(ExploredCellsLookupItemCache[purgeItem->second.pos].empty() == true) {
-				ExploredCellsLookupItemCache.erase(purgeItem->second.pos);
+		for(int j = 0; j < factionType->getUnitTypeCount(); ++j) {
+			const UnitType *unitType = factionType->getUnitType(j);
+			if(unitType->isMobile() == false) {
+				continue;
+			}
+			for(int field = fLand; field < fieldCount; ++field) {
+				if(unitType->getField(static_cast<Field>(field)) == true) {
+					clusterMap->prepareLayer(static_cast<Field>(field), unitType->getSize());
+				}
 			}
-
-			ExploredCellsLookupItemCacheTimer.erase(purgeItem->first);
 		}
+	}
+	if(SystemFlags::isDebugEnabled(SystemFlags::debugSystem)) SystemFlags::OutputDebug(SystemFlags::debugSystem,"In [%s::%s Line: %d]\n",__FILE__,__FUNCTION__,__LINE__);
+}
 
-		// Check the cache for the pos, sightrange and use from
-		// cache if already found
-		std::map<Vec2i, std::map<int, ExploredCellsLookupItem> >::iterator iterFind = ExploredCellsLookupItemCache.find(newPos);
-		if(iterFind != ExploredCellsLookupItemCache.end()) {
-
-			std::map<int, ExploredCellsLookupItem>::iterator iterFind2 = iterFind->second.find(sightRange);
-			if(iterFind2 != iterFind->second.end()) {
-
-				ExploredCellsLookupItem &exploredCellsCache = iterFind2->second;
-				exploreCells(teamIndex, exploredCellsCache);
-
-				// Only start worrying about updating the cache timer if we
-				// have hit the threshold
-				if(MaxExploredCellsLookupItemCacheTriggered == true) {
-					// Remove the old timer entry since the search key id is stale
-					ExploredCellsLookupItemCacheTimer.erase(exploredCellsCache.ExploredCellsLookupItemCacheTimerCountIndex);
-					exploredCellsCache.ExploredCellsLookupItemCacheTimerCountIndex = ExploredCellsLookupItemCacheTimerCount++;
-
-					ExploredCellsLookupKey lookupKey;
-					lookupKey.pos = newPos;
-					lookupKey.sightRange = sightRange;
-					lookupKey.teamIndex = teamIndex;
+// Visibility is reference counted per team in sightMap, so a unit only
+// touches the cells that enter or leave its sight disc
+void World::updateUnitSight(const Unit *unit, const Vec2i &pos, int sightRange, int teamIndex) {
+	if(fogOfWar == false) {
+		return;
+	}
+	sightMap.setUnitSight(unit->getId(), teamIndex, Map::toSurfCoords(pos), sightRange / Map::cellScale + 1);
+}
 
-					// Add a new search key since we just used this exploredCellsCache
-					ExploredCellsLookupItemCacheTimer[exploredCellsCache.ExploredCellsLookupItemCacheTimerCountIndex] = lookupKey;
-				}
+void World::resetTeamVisibility() {
+	if(fogOfWar == false) {
+		sightMap.clear();
+		minimapFowRefresh = true;
+		return;
+	}
 
-				return exploredCellsCache;
-			}
+	// hide everything the factions' teams saw, the next computeFow adds
+	// every operative unit's sight back
+	std::vector<int> teams;
+	for(int factionIndex = 0; factionIndex < getFactionCount(); ++factionIndex) {
+		int teamIndex = getFaction(factionIndex)->getTeam();
+		if(std::find(teams.begin(), teams.end(), teamIndex) == teams.end()) {
+			teams.push_back(teamIndex);
 		}
 	}
+	sightMap.init(&map, teams);
+	minimapFowRefresh = true;
+}
+
+// ==================== exploration ====================
 
+void World::exploreCells(const Vec2i &newPos, int sightRange, int teamIndex, Unit *unit) {
 	Vec2i newSurfPos= Map::toSurfCoords(newPos);
 	int surfSightRange= sightRange / Map::cellScale+1;
 
-	// Explore, this code is quite expensive when we have lots of units
-	ExploredCellsLookupItem exploredCellsCache;
-	exploredCellsCache.exploredCellList.reserve(surfSightRange + indirectSightRange * 4);
-	exploredCellsCache.visibleCellList.reserve(surfSightRange + indirectSightRange * 4);
-
-	//int loopCount = 0;
-    for(int i = -surfSightRange - indirectSightRange -1; i <= surfSightRange + indirectSightRange +1; ++i) {
-        for(int j = -surfSightRange - indirectSightRange -1; j <= surfSightRange + indirectSightRange +1; ++j) {
-        	//loopCount++;
-        	Vec2i currRelPos= Vec2i(i, j);
-            Vec2i currPos= newSurfPos + currRelPos;
-            if(map.isInsideSurface(currPos) == true){
-				SurfaceCell *sc= map.getSurfaceCell(currPos);
-				if(sc == NULL) {
-					throw megaglest_runtime_error("sc == NULL");
-				}
+	// cells closer than exploreRange are explored, the disc's rows come from
+	// a stencil shared by every unit with this range and are set in the
+	// explored plane a word at a time
+	const int exploreRange = surfSightRange + indirectSightRange + 1;
+	const SightStencil &stencil = sightMap.getStencil(exploreRange);
+	TeamBitPlane *exploredPlane = map.getExploredPlane();
+	const int surfaceW = map.getSurfaceW();
+	for(int j = -exploreRange + 1; j < exploreRange; ++j) {
+		const int y = newSurfPos.y + j;
+		if(y < 0 || y >= map.getSurfaceH()) {
+			continue;
+		}
 
-				//explore
-				float posLength = currRelPos.length();
-				bool updateExplored = (posLength < surfSightRange + indirectSightRange + 1);
-				bool updateVisible = (posLength < surfSightRange);
-
-				if(SystemFlags::getSystemSettingType(SystemFlags::debugWorldSynch).enabled == true &&
-						SystemFlags::getSystemSettingType(SystemFlags::debugWorldSynchMax).enabled == true) {
-					char szBuf[8096]="";
-					snprintf(szBuf,8096,"In exploreCells() currRelPos = %s currPos = %s posLength = %f updateExplored = %d updateVisible = %d sightRange = %d teamIndex = %d",
-							currRelPos.getString().c_str(), currPos.getString().c_str(),posLength,updateExplored, updateVisible, sightRange, teamIndex);
-					if(Thread::isCurrentThreadMainThread() == false) {
-						unit->logSynchDataThreaded(__FILE__,__LINE__,szBuf);
-					}
-					else {
-						unit->logSynchData(__FILE__,__LINE__,szBuf);
-					}
-				}
+		const int halfWidth = stencil.getHalfWidth(j);
+		const int firstX = max(0, newSurfPos.x - halfWidth);
+		const int lastX = min(surfaceW, newSurfPos.x + halfWidth + 1);
+		if(firstX >= lastX) {
+			continue;
+		}
 
-				if(updateExplored) {
-                    sc->setExplored(teamIndex, true);
-                    exploredCellsCache.exploredCellList.push_back(sc);
+		if(teamIndex == thisTeamIndex && fogOfWar == true) {
+			for(int x = firstX; x < lastX; ++x) {
+				if(exploredPlane->test(teamIndex, y * surfaceW + x) == false) {
+					minimapExploredCells.push_back(Vec2i(x, y));
 				}
-				//visible
-				if(updateVisible) {
-					sc->setVisible(teamIndex, true);
-					exploredCellsCache.visibleCellList.push_back(sc);
-				}
-            }
-        }
-    }
-
-    // Ok update our caches with the latest info for this position, sight and team
-    if(MaxExploredCellsLookupItemCache > 0) {
-		if(exploredCellsCache.exploredCellList.empty() == false || exploredCellsCache.visibleCellList.empty() == false) {
-			exploredCellsCache.ExploredCellsLookupItemCacheTimerCountIndex = ExploredCellsLookupItemCacheTimerCount++;
-			ExploredCellsLookupItemCache[newPos][sightRange] = exploredCellsCache;
+			}
+		}
+		exploredPlane->setRange(teamIndex, y * surfaceW + firstX, y * surfaceW + lastX, true);
 
-			ExploredCellsLookupKey lookupKey;
-			lookupKey.pos 			= newPos;
-			lookupKey.sightRange 	= sightRange;
-			lookupKey.teamIndex 	= teamIndex;
-			ExploredCellsLookupItemCacheTimer[exploredCellsCache.ExploredCellsLookupItemCacheTimerCountIndex] = lookupKey;
+		if(SystemFlags::isDebugEnabled(SystemFlags::debugWorldSynch) == true &&
+				SystemFlags::isDebugEnabled(SystemFlags::debugWorldSynchMax) == true) {
+			char szBuf[8096]="";
+			snprintf(szBuf,8096,"In exploreCells() row = %d x = [%d - %d) newSurfPos = %s sightRange = %d teamIndex = %d",
+					y, firstX, lastX, newSurfPos.getString().c_str(), sightRange, teamIndex);
+			if(Thread::isCurrentThreadMainThread() == false) {
+				unit->logSynchDataThreaded(__FILE__,__LINE__,szBuf);
+			}
+			else {
+				unit->logSynchData(__FILE__,__LINE__,szBuf);
+			}
 		}
-    }
-    return exploredCellsCache;
+	}
 }
 
 bool World::showWorldForPlayer(int factionIndex, bool excludeFogOfWarCheck) const {
@@ -2536,6 +2517,32 @@ bool World::showWorldForPlayer(int factionIndex, bool excludeFogOfWarCheck) cons
     return ret;
 }
 
+// Alpha of a surface cell on the minimap for this team, edge cells are
+// never fully lit
+float World::getMinimapFowAlpha(const Vec2i &surfPos, bool revealWorld) const {
+	//compute max alpha
+	float maxAlpha= 0.0f;
+	if(surfPos.x > 1 && surfPos.y > 1 &&
+	   surfPos.x < map.getSurfaceW() - 2 &&
+	   surfPos.y < map.getSurfaceH() - 2) {
+		maxAlpha= 1.f;
+	}
+	else if(surfPos.x > 0 && surfPos.y > 0 &&
+			surfPos.x < map.getSurfaceW() - 1 &&
+			surfPos.y < map.getSurfaceH() - 1){
+		maxAlpha= 0.3f;
+	}
+
+	const SurfaceCell *sc = map.getSurfaceCell(surfPos);
+	if(revealWorld == true || sc->isVisible(thisTeamIndex) == true) {
+		return maxAlpha;
+	}
+	if(sc->isExplored(thisTeamIndex) == true) {
+		return min(maxAlpha, Minimap::exploredAlpha);
+	}
+	return 0.f;
+}
+
 //computes the fog of war texture, contained in the minimap
 void World::computeFow() {
 	if(SystemFlags::VERBOSE_MODE_ENABLED) printf("In [%s::%s] Line: %d in frame: %d\n",extractFileFromDirectoryPath(__FILE__).c_str(),__FUNCTION__,__LINE__,getFrameCount());
@@ -2552,115 +2559,29 @@ void World::computeFow() {
 
 	if(this->game) chronoGamePerformanceCounts.start();
 
-	// Once we have calculated fog of war texture alpha, they are cached so we
-	// restore the default texture in one shot for speed
-	if(fogOfWar && cacheFowAlphaTexture == true) {
-		if(cacheFowAlphaTextureFogOfWarValue != fogOfWar) {
-			cacheFowAlphaTexture = false;
-		}
-		else {
-			minimap.restoreFowTexAlphaSurface();
-		}
+	// The whole map is lit without fog of war or when any faction's
+	// player may see the world (observer, game over, fog of war skill)
+	bool revealWorld = (fogOfWar == false);
+	for(int factionIndex = 0; revealWorld == false && factionIndex < getFactionCount(); ++factionIndex) {
+		revealWorld = showWorldForPlayer(factionIndex);
 	}
-	int resetFowAlphaFactionCount = 0;
-
-	for(int factionIndex = 0; factionIndex < GameConstants::maxPlayers + GameConstants::specialFactions; ++factionIndex) {
-		if(factionIndex >= getFactionCount()) {
-			continue;
-		}
-		Faction *faction = getFaction(factionIndex);
-//	for(int indexTeamFaction = 0;
-//			indexTeamFaction < GameConstants::maxPlayers + GameConstants::specialFactions;
-//			++indexTeamFaction) {
-
-		// If fog of war enabled set cell visible to false and later set those close to units to true
-		if(fogOfWar) {
-			for(int indexSurfaceW = 0; indexSurfaceW < map.getSurfaceW(); ++indexSurfaceW) {
-				for(int indexSurfaceH = 0; indexSurfaceH < map.getSurfaceH(); ++indexSurfaceH) {
-					// set all cells to not visible
-					map.getSurfaceCell(indexSurfaceW, indexSurfaceH)->setVisible(faction->getTeam(), false);
-				}
-			}
-		}
 
-		// Remove fog of war for factions NOT on my team which i can see
-		if(!fogOfWar || (faction->getTeam() != thisTeamIndex)) {
-			bool showWorldForFaction = showWorldForPlayer(factionIndex);
-			//printf("showWorldForFaction indexFaction = %d thisTeamIndex = %d showWorldForFaction = %d\n",indexFaction,thisTeamIndex,showWorldForFaction);
-			if(showWorldForFaction == true) {
-				resetFowAlphaFactionCount++;
-			}
-			for(int indexSurfaceW = 0; indexSurfaceW < map.getSurfaceW(); ++indexSurfaceW) {
-				for(int indexSurfaceH = 0; indexSurfaceH < map.getSurfaceH(); ++indexSurfaceH) {
-					// reset fog of ware texture alpha values
-					if(!fogOfWar || (cacheFowAlphaTexture == false &&
-						showWorldForFaction == true &&
-							resetFowAlphaFactionCount <= 1)) {
-						const Vec2i surfPos(indexSurfaceW,indexSurfaceH);
-
-						//compute max alpha
-						float maxAlpha= 0.0f;
-						if(surfPos.x > 1 && surfPos.y > 1 &&
-						   surfPos.x < map.getSurfaceW() - 2 &&
-						   surfPos.y < map.getSurfaceH() - 2) {
-							maxAlpha= 1.f;
-						}
-						else if(surfPos.x > 0 && surfPos.y > 0 &&
-								surfPos.x < map.getSurfaceW() - 1 &&
-								surfPos.y < map.getSurfaceH() - 1){
-							maxAlpha= 0.3f;
-						}
+	if(sightMap.getWatchedTeam() != thisTeamIndex) {
+		sightMap.setWatchedTeam(thisTeamIndex);
+		minimapFowRefresh = true;
+	}
 
-						// compute alpha
-						float alpha = maxAlpha;
-						minimap.incFowTextureAlphaSurface(surfPos, alpha);
-					}
-				}
+	// Only switching between the lit and the fogged map touches every cell,
+	// otherwise the cells explored or changing visibility are updated below
+	if(minimapFowRefresh == true || revealWorld != minimapRevealWorld) {
+		for(int indexSurfaceW = 0; indexSurfaceW < map.getSurfaceW(); ++indexSurfaceW) {
+			for(int indexSurfaceH = 0; indexSurfaceH < map.getSurfaceH(); ++indexSurfaceH) {
+				const Vec2i surfPos(indexSurfaceW,indexSurfaceH);
+				minimap.setFowTextureAlphaSurface(surfPos, getMinimapFowAlpha(surfPos, revealWorld));
 			}
 		}
-		// Remove fog of war for factions on my team
-		else if(fogOfWar && (faction->getTeam() == thisTeamIndex)) {
-			bool showWorldForFaction = showWorldForPlayer(factionIndex);
-			//printf("#2 showWorldForFaction thisFactionIndex = %d thisTeamIndex = %d showWorldForFaction = %d\n",thisFactionIndex,thisTeamIndex,showWorldForFaction);
-			if(showWorldForFaction == true) {
-				for(int indexSurfaceW = 0; indexSurfaceW < map.getSurfaceW(); ++indexSurfaceW) {
-					for(int indexSurfaceH = 0; indexSurfaceH < map.getSurfaceH(); ++indexSurfaceH) {
-						// reset fog of ware texture alpha values
-						if(!fogOfWar || (cacheFowAlphaTexture == false &&
-							showWorldForFaction == true)) {
-							const Vec2i surfPos(indexSurfaceW,indexSurfaceH);
-
-							//compute max alpha
-							float maxAlpha= 0.0f;
-							if(surfPos.x > 1 && surfPos.y > 1 &&
-							   surfPos.x < map.getSurfaceW() - 2 &&
-							   surfPos.y < map.getSurfaceH() - 2) {
-								maxAlpha= 1.f;
-							}
-							else if(surfPos.x > 0 && surfPos.y > 0 &&
-									surfPos.x < map.getSurfaceW() - 1 &&
-									surfPos.y < map.getSurfaceH() - 1){
-								maxAlpha= 0.3f;
-							}
-
-							// compute alpha
-							float alpha = maxAlpha;
-							minimap.incFowTextureAlphaSurface(surfPos, alpha);
-						}
-					}
-				}
-			}
-		}
-
-		if(SystemFlags::VERBOSE_MODE_ENABLED) printf("In [%s::%s] Line: %d in frame: %d\n",extractFileFromDirectoryPath(__FILE__).c_str(),__FUNCTION__,__LINE__,getFrameCount());
-	}
-
-	// Once we have calculated fog of war texture alpha, will we cache it so that we
-	// can restore it later
-	if(fogOfWar && cacheFowAlphaTexture == false && resetFowAlphaFactionCount > 0) {
-		cacheFowAlphaTexture = true;
-		cacheFowAlphaTextureFogOfWarValue = fogOfWar;
-		minimap.copyFowTexAlphaSurface();
+		minimapFowRefresh = false;
+		minimapRevealWorld = revealWorld;
 	}
 
 	if(this->game) this->game->addPerformanceCount("world reset cells",chronoGamePerformanceCounts.getMillis());
@@ -2670,9 +2591,14 @@ void World::computeFow() {
 	//compute cells
 	if(this->game) chronoGamePerformanceCounts.start();
 
+	// Units that are not operative anymore (or gone) drop their sight at endSweep
+	if(fogOfWar == true) {
+		sightMap.beginSweep();
+	}
+
+	bool cellVisibleForFaction = showWorldForPlayer(thisFactionIndex);
 	for(int factionIndex = 0; factionIndex < getFactionCount(); ++factionIndex) {
 		Faction *faction = getFaction(factionIndex);
-		bool cellVisibleForFaction = showWorldForPlayer(thisFactionIndex);
 		//printf("computeFow thisFactionIndex = %d factionIndex = %d thisTeamIndex = %d faction->getTeam() = %d cellVisibleForFaction = %d\n",thisFactionIndex,factionIndex,thisTeamIndex,faction->getTeam(),cellVisibleForFaction);
 
 		int unitCount = faction->getUnitCount();
@@ -2695,25 +2621,27 @@ void World::computeFow() {
 
 				fire->setActive(cellVisible);
 			}
+		}
+	}
 
-			// compute fog of war render texture
-			if(fogOfWar == true &&
-				faction->getTeam() == thisTeamIndex &&
-					unit->isOperative() == true) {
-
-				//printf("computeFow unit->isOperative() == true\n");
-
-				const FowAlphaCellsLookupItem &cellList = unit->getCachedFow();
-				for(std::map<Vec2i,float>::const_iterator iterMap = cellList.surfPosAlphaList.begin();
-					iterMap != cellList.surfPosAlphaList.end(); ++iterMap) {
-					const Vec2i &surfPos = iterMap->first;
-					const float &alpha = iterMap->second;
+	if(fogOfWar == true) {
+		sightMap.endSweep();
+	}
 
-					minimap.incFowTextureAlphaSurface(surfPos, alpha, true);
-				}
-			}
+	// compute fog of war render texture from the cells this team newly
+	// explored and the ones whose visibility count crossed zero
+	sightMap.takeWatchedTeamChanges(minimapVisibleCells);
+	if(revealWorld == false) {
+		for(unsigned int index = 0; index < minimapExploredCells.size(); ++index) {
+			const Vec2i &surfPos = minimapExploredCells[index];
+			minimap.setFowTextureAlphaSurface(surfPos, getMinimapFowAlpha(surfPos, revealWorld));
+		}
+		for(unsigned int index = 0; index < minimapVisibleCells.size(); ++index) {
+			const Vec2i &surfPos = minimapVisibleCells[index];
+			minimap.setFowTextureAlphaSurface(surfPos, getMinimapFowAlpha(surfPos, revealWorld));
 		}
 	}
+	minimapExploredCells.clear();
 
 	if(this->game) this->game->addPerformanceCount("world compute cells",chronoGamePerformanceCounts.getMillis());
 }
@@ -2860,63 +2788,10 @@ void World::removeResourceTargetFromCache(const Vec2i &pos) {
 	}
 }
 
-string World::getExploredCellsLookupItemCacheStats() {
-	string result = "";
-
-	int posCount = 0;
-	int sightCount = 0;
-	int exploredCellCount = 0;
-	int visibleCellCount = 0;
-
-	for(std::map<Vec2i, std::map<int, ExploredCellsLookupItem > >::iterator iterMap1 = ExploredCellsLookupItemCache.begin();
-		iterMap1 != ExploredCellsLookupItemCache.end(); ++iterMap1) {
-		posCount++;
-
-		for(std::map<int, ExploredCellsLookupItem >::iterator iterMap2 = iterMap1->second.begin();
-			iterMap2 != iterMap1->second.end(); ++iterMap2) {
-			sightCount++;
-
-			exploredCellCount += (int)iterMap2->second.exploredCellList.size();
-			visibleCellCount += (int)iterMap2->second.visibleCellList.size();
-		}
-	}
-
-	uint64 totalBytes = exploredCellCount * sizeof(SurfaceCell *);
-	totalBytes += visibleCellCount * sizeof(SurfaceCell *);
-
-	totalBytes /= 1000;
-
-	char szBuf[8096]="";
-	snprintf(szBuf,8096,"pos [%d] sight [%d] [%d][%d] total KB: %s",posCount,sightCount,exploredCellCount,visibleCellCount,formatNumber(totalBytes).c_str());
-	result = szBuf;
-	return result;
-}
-
-string World::getFowAlphaCellsLookupItemCacheStats() {
-	string result = "";
-
-	int surfPosAlphaCount = 0;
-
-	for(int factionIndex = 0; factionIndex < getFactionCount(); ++factionIndex) {
-		Faction *faction= getFaction(factionIndex);
-		if(faction->getTeam() == thisTeamIndex) {
-			for(int unitIndex = 0; unitIndex < faction->getUnitCount(); ++unitIndex) {
-				const Unit *unit= faction->getUnit(unitIndex);
-				const FowAlphaCellsLookupItem &cache = unit->getCachedFow();
-
-				surfPosAlphaCount += (int)cache.surfPosAlphaList.size();
-			}
-		}
-	}
-	uint64 totalBytes = surfPosAlphaCount * sizeof(Vec2i);
-	totalBytes += surfPosAlphaCount * sizeof(float);
-
-	totalBytes /= 1000;
-
+string World::getSightStencilStats() {
 	char szBuf[8096]="";
-	snprintf(szBuf,8096,"surface count [%d] total KB: %s",surfPosAlphaCount,formatNumber(totalBytes).c_str());
-	result = szBuf;
-	return result;
+	snprintf(szBuf,8096,"stencils [%d] unit sights [%d]",sightMap.getStencilCount(),sightMap.getUnitSightCount());
+	return szBuf;
 }
 
 string World::getAllFactionsCacheStats() {
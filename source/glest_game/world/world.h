@@ -33,6 +33,8 @@
 #include "water_effects.h"
 #include "faction.h"
 #include "unit_updater.h"
+#include "sight_map.h"
+#include "task_pool.h"
 #include "randomgen.h"
 #include "game_constants.h"
 #include "leak_dumper.h"
@@ -42,6 +44,8 @@ namespace Glest{ namespace Game{
 using Shared::Graphics::Quad2i;
 using Shared::Graphics::Rect2i;
 using Shared::Util::RandomGen;
+using Shared::PlatformCommon::TaskPoolCallbackInterface;
+using Shared::PlatformCommon::WorkStealingTaskPool;
 
 class Faction;
 class Unit;
@@ -61,22 +65,10 @@ class StrSound;
 ///	The game world: Map + Tileset + TechTree
 // =====================================================
 
-class ExploredCellsLookupKey {
-public:
-
-	Vec2i pos;
-	int sightRange;
-	int teamIndex;
-};
-
-class World {
+class World : public TaskPoolCallbackInterface {
 private:
 	typedef vector<Faction *> Factions;
 
-	std::map<Vec2i, std::map<int, ExploredCellsLookupItem > > ExploredCellsLookupItemCache;
-	std::map<int,ExploredCellsLookupKey> ExploredCellsLookupItemCacheTimer;
-	int ExploredCellsLookupItemCacheTimerCount;
-
 public:
 	static const int generationArea= 100;
 	static const int indirectSightRange= 5;
@@ -84,6 +76,7 @@ public:
 private:
 
 	Map map;
+	SightMap sightMap;
 	Tileset tileset;
 	TechTree *techTree;
 	TimeFlow timeFlow;
@@ -132,6 +125,10 @@ private:
 	const XmlNode *loadWorldNode;
 
 	MasterSlaveThreadController masterController;
+	CompletionLatch factionThreadsCompleted;
+	// runs the per faction command precache on all cores, see updateAllFactionUnits
+	WorkStealingTaskPool *taskPool;
+	int precacheUnitCount;
 
 	bool originalGameFogOfWar;
 	std::map<int,std::pair<const Unit *,const FogOfWarSkillType *> > mapFogOfWarUnitList;
@@ -139,14 +136,18 @@ private:
 	bool animatedTilesetObjectPosListLoaded;
 	std::vector<Vec2i> animatedTilesetObjectPosList;
 
-	bool cacheFowAlphaTexture;
-	bool cacheFowAlphaTextureFogOfWarValue;
+	// the minimap's fog of war only follows the cells that changed, it is
+	// rebuilt when the whole map is revealed or hidden again
+	bool minimapFowRefresh;
+	bool minimapRevealWorld;
+	std::vector<Vec2i> minimapExploredCells;
+	std::vector<Vec2i> minimapVisibleCells;
 
 	std::map<int, std::map<std::string, Resource > > TeamResources;
 
 public:
 	World();
-	~World();
+	virtual ~World();
 //	World & World(World &obj) {
 //		throw runtime_error("class World is NOT safe to assign!");
 //	}
@@ -191,6 +192,7 @@ public:
 	int getNextUnitId(Faction *faction);
 	int getNextCommandGroupId();
 	inline int getFrameCount() const						{return frameCount;}
+	inline WorkStealingTaskPool *getTaskPool() const		{return taskPool;}
 
 	//init & load
 	void init(Game *game, bool createUnits, bool initFactions=true);
@@ -297,8 +299,8 @@ public:
 	}
 	bool canTickWorld() const;
 
-	ExploredCellsLookupItem exploreCells(const Vec2i &newPos, int sightRange, int teamIndex, Unit *unit);
-	void exploreCells(int teamIndex,ExploredCellsLookupItem &exploredCellsCache);
+	void exploreCells(const Vec2i &newPos, int sightRange, int teamIndex, Unit *unit);
+	void updateUnitSight(const Unit *unit, const Vec2i &pos, int sightRange, int teamIndex);
 	bool showWorldForPlayer(int factionIndex, bool excludeFogOfWarCheck=false) const;
 
 	inline UnitUpdater * getUnitUpdater() { return &unitUpdater; }
@@ -310,8 +312,7 @@ public:
 
 	void removeResourceTargetFromCache(const Vec2i &pos);
 
-	string getExploredCellsLookupItemCacheStats();
-	string getFowAlphaCellsLookupItemCacheStats();
+	string getSightStencilStats();
 	string getAllFactionsCacheStats();
 
 	void placeUnitAtLocation(const Vec2i &location, int radius, Unit *unit, bool spaciated);
@@ -329,6 +330,7 @@ public:
 	bool showResourceTypeForFaction(const ResourceType *rt, const Faction *faction) const;
 	bool showResourceTypeForTeam(const ResourceType *rt, int teamIndex) const;
 
+	virtual void runPoolTask(int taskIndex, int workerIndex);
 
 private:
 
@@ -342,12 +344,14 @@ private:
 	//misc
 	void tick();
 	void computeFow();
+	void resetTeamVisibility();
 
 	void updateAllTilesetObjects();
 	void updateAllFactionUnits();
+	bool precacheUnitCommandsOnTaskPool();
 	void underTakeDeadFactionUnits();
 	void updateAllFactionConsumableCosts();
-	void restoreExploredFogOfWarCells();
+	float getMinimapFowAlpha(const Vec2i &surfPos, bool revealWorld) const;
 
 };
 
@@ -14,7 +14,9 @@
 
 #include "vec.h"
 #include "model.h"
+#include "thread.h"
 #include <map>
+#include <list>
 #include "leak_dumper.h"
 
 namespace Shared{ namespace Graphics{
@@ -25,6 +27,19 @@ namespace Shared{ namespace Graphics{
 
 class InterpolationData{
 private:
+	// An interpolated frame shared by every unit showing the mesh at the
+	// same quantized animation progress
+	struct CachedFrame {
+		InterpolationData *owner;
+		int key;
+		Vec3f *vertices;
+		Vec3f *normals;
+		int64 bytes;
+		std::list<CachedFrame *>::iterator lruPosition;
+	};
+	typedef std::map<int, CachedFrame *> FrameCache;
+	typedef std::list<CachedFrame *> FrameCacheLru;
+
 	const Mesh *mesh;
 
 	Vec3f *vertices;
@@ -32,18 +47,47 @@ private:
 
 	int raw_frame_ofs;
 
+	FrameCache frameCache;
+	CachedFrame *vertexFrame;
+	CachedFrame *normalFrame;
+
 	static bool enableInterpolation;
+	static bool enableSimd;
+	static bool normalizeNormals;
+
+	static float frameCacheStep;
+	static int64 frameCacheMemoryBudget;
+	static int64 frameCacheBytes;
+	static int64 frameCacheHits;
+	static int64 frameCacheMisses;
+	static FrameCacheLru frameCacheLru;
+	static Shared::Platform::Mutex frameCacheMutex;
 	
-	void update(const Vec3f* src, Vec3f* &dest, float t, bool cycle);
+	void update(const Vec3f* src, Vec3f* &dest, float t, bool cycle, bool normalize);
+	bool updateFromCache(float t, bool cycle, bool forNormals);
+	static void evictFrames();
+	static void removeFrame(CachedFrame *frame);
 
 public:
 	InterpolationData(const Mesh *mesh);
 	~InterpolationData();
 
 	static void setEnableInterpolation(bool enabled) { enableInterpolation = enabled; }
+	static void setEnableSimd(bool enabled) { enableSimd = enabled; }
+	static void setNormalizeNormals(bool enabled) { normalizeNormals = enabled; }
+	static bool isSimdSupported();
+
+	// t is rounded to a multiple of step before interpolating, 0 disables the cache
+	static void setFrameCacheStep(float step) { frameCacheStep = step; }
+	static void setFrameCacheMemoryBudget(int64 bytes) { frameCacheMemoryBudget = bytes; }
+	static string getFrameCacheStats();
+
+	// dest[i] = prev[i] lerped towards next[i], SIMD and scalar give the same bits
+	static void lerpFrames(const Vec3f *prev, const Vec3f *next, Vec3f *dest,
+							uint32 count, float t, bool normalize, bool useSimd);
 
-	const Vec3f *getVertices() const	{return !vertices || !enableInterpolation? mesh->getVertices()+raw_frame_ofs: vertices;}
-	const Vec3f *getNormals() const		{return !normals || !enableInterpolation? mesh->getNormals()+raw_frame_ofs: normals;}
+	const Vec3f *getVertices() const	{return vertexFrame? vertexFrame->vertices: !vertices || !enableInterpolation? mesh->getVertices()+raw_frame_ofs: vertices;}
+	const Vec3f *getNormals() const		{return normalFrame? normalFrame->normals: !normals || !enableInterpolation? mesh->getNormals()+raw_frame_ofs: normals;}
 	
 	void update(float t, bool cycle);
 	void updateVertices(float t, bool cycle);
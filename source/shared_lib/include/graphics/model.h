@@ -28,10 +28,17 @@ using std::string;
 using std::map;
 using std::pair;
 
+namespace Shared { namespace PlatformCommon {
+	class MappedFile;
+}}
+
 namespace Shared { namespace Graphics {
 
+using Shared::PlatformCommon::MappedFile;
+
 class Model;
 class Mesh;
+class G3dFileReader;
 class ShadowVolumeData;
 class InterpolationData;
 class TextureManager;
@@ -62,6 +69,7 @@ private:
 	Vec2f *texCoords;
 	Vec3f *tangents;
 	uint32 *indices;
+	MappedFile *fileMap;	// file the vertex data points into, if any
 
 	//material data
 	Vec3f diffuseColor;
@@ -91,7 +99,6 @@ public:
 	//init & end
 	Mesh();
 	~Mesh();
-	void init();
 	void end();
 
 	void copyInto(Mesh *dest, bool ignoreInterpolationData, bool destinationOwnsTextures);
@@ -119,6 +126,7 @@ public:
 	const Vec2f *getTexCoords() const	{return texCoords;}
 	const Vec3f *getTangents() const	{return tangents;}
 	const uint32 *getIndices() const 	{return indices;}
+	bool isMappedFromFile() const		{return fileMap != NULL;}
 
 	void setVertices(Vec3f *data, uint32 count);
 	void setNormals(Vec3f *data, uint32 count);
@@ -156,11 +164,11 @@ public:
 								string sourceLoader="",string modelFile="");
 
 	//load
-	void loadV2(int meshIndex, const string &dir, FILE *f, TextureManager *textureManager,
+	void loadV2(int meshIndex, const string &dir, G3dFileReader &reader, TextureManager *textureManager,
 			bool deletePixMapAfterLoad,std::map<string,vector<pair<string, string> > > *loadedFileList=NULL,string sourceLoader="",string modelFile="");
-	void loadV3(int meshIndex, const string &dir, FILE *f, TextureManager *textureManager,
+	void loadV3(int meshIndex, const string &dir, G3dFileReader &reader, TextureManager *textureManager,
 			bool deletePixMapAfterLoad,std::map<string,vector<pair<string, string> > > *loadedFileList=NULL,string sourceLoader="",string modelFile="");
-	void load(int meshIndex, const string &dir, FILE *f, TextureManager *textureManager,bool deletePixMapAfterLoad,std::map<string,vector<pair<string, string> > > *loadedFileList=NULL,string sourceLoader="",string modelFile="");
+	void load(int meshIndex, const string &dir, G3dFileReader &reader, TextureManager *textureManager,bool deletePixMapAfterLoad,std::map<string,vector<pair<string, string> > > *loadedFileList=NULL,string sourceLoader="",string modelFile="");
 	void save(int meshIndex, const string &dir, FILE *f, TextureManager *textureManager,
 			string convertTextureToFormat, std::map<string,int> &textureDeleteList,
 			bool keepsmallest,string modelFile);
@@ -174,6 +182,10 @@ private:
 	string findAlternateTexture(vector<string> conversionList, string textureFile);
 	void computeTangents();
 
+	template<typename T> T *loadMeshData(G3dFileReader &reader, uint32 frames, uint32 count, int line);
+	template<typename T> void deleteMeshData(T *&data);
+	void releaseFileMap();
+
 };
 
 // =====================================================
@@ -242,6 +254,8 @@ protected:
 
     
 private:
+	void loadG3d(const string &path, MappedFile *file, bool deletePixMapAfterLoad,
+			std::map<string,vector<pair<string, string> > > *loadedFileList, string sourceLoader);
 	void buildInterpolationData() const;
 	void autoJoinMeshFrames();
 };
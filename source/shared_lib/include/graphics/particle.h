@@ -13,6 +13,7 @@
 #define _SHARED_GRAPHICS_PARTICLE_H_
 
 #include <list>
+#include <map>
 #include <cassert>
 #include "vec.h"
 #include "pixmap.h"
@@ -26,6 +27,10 @@ using std::list;
 using Shared::Util::RandomGen;
 using Shared::Xml::XmlNode;
 
+namespace Shared{ namespace PlatformCommon{
+class WorkStealingTaskPool;
+}}
+
 namespace Shared{ namespace Graphics{
 
 class ParticleSystem;
@@ -75,6 +80,103 @@ public:
 	void loadGame(const XmlNode *rootNode);
 };
 
+// =====================================================
+//	class ParticleKernelParams
+//
+///	Per system values the update kernels of ParticlePool read
+// =====================================================
+
+class ParticleKernelParams {
+public:
+	ParticleKernelParams();
+
+	Vec4f color;
+	Vec4f colorNoEnergy;
+	float size;
+	float sizeNoEnergy;
+	int maxEnergy;
+
+	// unit systems only
+	int alternations;
+	bool fixed;
+	Vec3f fixedAddition;
+	bool daylightAffected;
+	Vec3f lightColor;
+	bool energyCycles;		// static particles count up and down
+};
+
+// =====================================================
+//	class ParticlePool
+//
+///	The particles of one system kept as one array per attribute,
+///	so every system type is updated by a kernel that handles four
+///	particles at a time instead of a virtual call per particle.
+///	The kernels do the same float operations, in the same order,
+///	as the per particle updates of the systems.
+// =====================================================
+
+class ParticlePool {
+public:
+	enum Attribute {
+		paPosX, paPosY, paPosZ,
+		paLastPosX, paLastPosY, paLastPosZ,
+		paSpeedX, paSpeedY, paSpeedZ,
+		paSpeedUpRelative,
+		paSpeedUpConstantX, paSpeedUpConstantY, paSpeedUpConstantZ,
+		paAccelX, paAccelY, paAccelZ,
+		paColorR, paColorG, paColorB, paColorA,
+		paSize,
+
+		paCount
+	};
+
+	static const int kernelWidth = 4;
+
+private:
+	int count;
+	std::vector<float> values[paCount];
+	std::vector<int> energies;
+	std::vector<float> energyRatios;	// scratch of the unit kernel
+
+	float *getValues(Attribute attribute)				{return &values[attribute][0];}
+	const float *getValues(Attribute attribute) const	{return &values[attribute][0];}
+
+public:
+	ParticlePool();
+
+	// Storage is padded to the kernel width, the padding is never read back
+	void resize(int count);
+	void clear();
+	int size() const	{return count;}
+
+	void get(int index, Particle &particle) const;
+	void set(int index, const Particle &particle);
+	void copy(int fromIndex, int toIndex);
+
+	Vec3f getPos(int index) const;
+	Vec3f getLastPos(int index) const;
+	Vec4f getColor(int index) const;
+	float getSize(int index) const		{return values[paSize][index];}
+	int getEnergy(int index) const		{return energies[index];}
+
+	int findMinEnergy(int aliveCount) const;
+
+	// Update kernels over the first aliveCount particles, one per
+	// ParticleSystemType (rain and snow use the linear one)
+	void updateLinear(int aliveCount);
+	void updateFire(int aliveCount);
+	void updateUnit(int aliveCount, const ParticleKernelParams &params, bool &energyUp);
+	void updateProjectile(int aliveCount, const ParticleKernelParams &params);
+	void updateSplash(int aliveCount, const ParticleKernelParams &params);
+
+	// Kill compaction: the last alive particle is moved over every
+	// dead one, returns the new alive count
+	int killNoEnergy(int aliveCount);
+	int killBelowGround(int aliveCount);
+
+	static bool isSimdSupported();
+};
+
 // =====================================================
 //	class ParticleObserver
 // =====================================================
@@ -139,7 +241,7 @@ enum ParticleSystemType {
 
 protected:
 	
-	std::vector<Particle> particles;
+	ParticlePool particles;
 	RandomGen random;
 
 	BlendMode blendMode;
@@ -174,6 +276,12 @@ protected:
 	ParticleObserver *particleObserver;
 	ParticleOwner *particleOwner;
 
+	// While ParticleManager updates systems on its workers the observer
+	// and the owner log are held back and run afterwards, in order
+	bool callbacksDeferred;
+	ParticleObserver *deferredObserver;
+	vector<string> deferredParticleInfo;
+
 public:
 	//conmstructor and destructor
 	ParticleSystem(int particleCount);
@@ -189,8 +297,7 @@ public:
 	BlendMode getBlendMode() const				{return blendMode;}
 	Texture *getTexture() const					{return texture;}
 	Vec3f getPos() const						{return pos;}
-	Particle *getParticle(int i)				{return &particles[i];}
-	const Particle *getParticle(int i) const	{return &particles[i];}
+	const ParticlePool &getParticles() const	{return particles;}
 	int getAliveParticleCount() const			{return aliveParticleCount;}
 	bool getActive() const						{return active;}
 	virtual bool getVisible() const				{return visible;}
@@ -243,15 +350,40 @@ public:
 
 	virtual Checksum getCRC();
 
+	// The per particle virtual updates are kept as the reference the
+	// kernels are tested and benchmarked against
+	static void setParticleKernelsEnabled(bool value)	{particleKernelsEnabled= value;}
+	static bool getParticleKernelsEnabled()				{return particleKernelsEnabled;}
+
+	// Systems that are only updated while visible (or fading)
+	bool isUpdatedWhenVisibleOnly() const;
+
+	// Other systems this one changes while it updates, they are never
+	// updated in parallel with it
+	virtual void getLinkedParticleSystems(vector<ParticleSystem *> &linkedSystems);
+
+	void setCallbacksDeferred(bool value)		{callbacksDeferred= value;}
+	bool hasDeferredCallbacks() const;
+	void runDeferredCallbacks();
+
 protected:
+	static bool particleKernelsEnabled;
+
+	void notifyObserver();
+	void logParticleInfo(const string &info);
+
 	//protected
-	Particle *createParticle();
-	void killParticle(Particle *p);
+	int createParticle();
 
 	//virtual protected
 	virtual void initParticle(Particle *p, int particleIndex);
 	virtual void updateParticle(Particle *p);
 	virtual bool deathTest(Particle *p);
+
+	// Kernel versions of updateParticle and deathTest over all alive particles
+	virtual void updateParticles();
+	virtual void killParticles();
+	ParticleKernelParams getKernelParams() const;
 };
 
 // =====================================================
@@ -271,6 +403,7 @@ public:
 	//virtual
 	virtual void initParticle(Particle *p, int particleIndex);
 	virtual void updateParticle(Particle *p);
+	virtual void updateParticles();
 
 	//set params
 	void setRadius(float radius);
@@ -405,6 +538,7 @@ public:
 	//virtual
 	virtual void initParticle(Particle *p, int particleIndex);
 	virtual void updateParticle(Particle *p);
+	virtual void updateParticles();
 	virtual void update();
 	virtual bool getVisible() const;
 	virtual void fade();
@@ -474,6 +608,7 @@ public:
 
 	virtual void initParticle(Particle *p, int particleIndex);
 	virtual bool deathTest(Particle *p);
+	virtual void killParticles();
 
 	void setRadius(float radius);
 	void setWind(float windAngle, float windSpeed);
@@ -499,6 +634,7 @@ public:
 
 	virtual void initParticle(Particle *p, int particleIndex);
 	virtual bool deathTest(Particle *p);
+	virtual void killParticles();
 
 	void setRadius(float radius);
 	void setWind(float windAngle, float windSpeed);
@@ -577,13 +713,15 @@ public:
 	ProjectileParticleSystem(int particleCount= 1000);
 	virtual ~ProjectileParticleSystem();
 
-	virtual ParticleSystemType getParticleSystemType() const { return pst_SplashParticleSystem;}
+	virtual ParticleSystemType getParticleSystemType() const { return pst_ProjectileParticleSystem;}
 
 	void link(SplashParticleSystem *particleSystem);
+	virtual void getLinkedParticleSystems(vector<ParticleSystem *> &linkedSystems);
 	
 	virtual void update();
 	virtual void initParticle(Particle *p, int particleIndex);
 	virtual void updateParticle(Particle *p);
+	virtual void updateParticles();
 	
 	void setTrajectory(Trajectory trajectory)				{this->trajectory= trajectory;}
 	void setTrajectorySpeed(float trajectorySpeed)			{this->trajectorySpeed= trajectorySpeed;}
@@ -624,10 +762,13 @@ private:
 public:
 	SplashParticleSystem(int particleCount= 1000);
 	virtual ~SplashParticleSystem();
+
+	virtual ParticleSystemType getParticleSystemType() const { return pst_SplashParticleSystem;}
 	
 	virtual void update();
 	virtual void initParticle(Particle *p, int particleIndex);
 	virtual void updateParticle(Particle *p);
+	virtual void updateParticles();
 	
 	virtual void initParticleSystem();
 
@@ -650,13 +791,35 @@ public:
 // =====================================================
 
 class ParticleManager {
+public:
+	// Below this many systems an update is not worth waking the workers
+	static const int minParallelParticleSystemCount = 64;
+
 private:
 	vector<ParticleSystem *> particleSystems;
+	// slot of every managed system, cleaned up slots stay NULL until compacted
+	std::map<const ParticleSystem *,size_t> particleSystemIndexes;
+	size_t particleSystemHoles;
+
+	static bool parallelUpdateEnabled;
+
+	bool updating;
+	vector<ParticleSystem *> managedDuringUpdate;
+
+	void updateParticleSystems(const vector<ParticleSystem *> &updateList,
+								vector<ParticleSystem *> &cleanupParticleSystemsList,
+								Shared::PlatformCommon::WorkStealingTaskPool *taskPool);
+	void compactParticleSystems();
+	void setCallbacksDeferred(bool value);
 
 public:
 	ParticleManager();
 	~ParticleManager();
-	void update(int renderFps=-1);
+
+	static void setParallelUpdateEnabled(bool value)	{parallelUpdateEnabled= value;}
+	static bool getParallelUpdateEnabled()				{return parallelUpdateEnabled;}
+
+	void update(int renderFps=-1, Shared::PlatformCommon::WorkStealingTaskPool *taskPool=NULL);
 	void render(ParticleRenderer *pr, ModelRenderer *mr) const;	
 	void manage(ParticleSystem *ps);
 	void end();
@@ -16,6 +16,7 @@
 #include "vec.h"
 #include "data_types.h"
 #include <map>
+#include <vector>
 #include "checksum.h"
 #include "leak_dumper.h"
 
@@ -216,6 +217,32 @@ public:
 	Checksum * getCRC() { return &crc; }
 };
 
+// =====================================================
+//	class PixmapSplatWeights
+//
+///	Weights of the four corner pixmaps for every pixel of a splat.
+///	Every splat starts a new random generator, so the weights only
+///	depend on the size and one table serves all splats of a tileset.
+// =====================================================
+
+class PixmapSplatWeights {
+public:
+	// left up, right up, left down, right down and 1 / their sum
+	static const int valuesPerPixel = 5;
+
+private:
+	int w;
+	int h;
+	std::vector<float> weights;		// by pixel, row after row
+
+public:
+	PixmapSplatWeights(int w, int h);
+
+	int getW() const				{return w;}
+	int getH() const				{return h;}
+	const float *getWeights() const	{return &weights[0];}
+};
+
 // =====================================================
 //	class Pixmap2D
 // =====================================================
@@ -289,6 +316,8 @@ public:
 
 	//operations
 	void splat(const Pixmap2D *leftUp, const Pixmap2D *rightUp, const Pixmap2D *leftDown, const Pixmap2D *rightDown); 
+	void splat(const Pixmap2D *leftUp, const Pixmap2D *rightUp, const Pixmap2D *leftDown, const Pixmap2D *rightDown,
+				const PixmapSplatWeights &splatWeights);
 	void lerp(float t, const Pixmap2D *pixmap1, const Pixmap2D *pixmap2);
 	void copy(const Pixmap2D *sourcePixmap);
 	void subCopy(int x, int y, const Pixmap2D *sourcePixmap);
@@ -0,0 +1,80 @@
+// ==============================================================
+//	This file is part of MegaGlest Shared Library (www.megaglest.org)
+//
+//	Copyright (C) 2026 The MegaGlest Team
+//
+//	You can redistribute this code and/or modify it under
+//	the terms of the GNU General Public License as published
+//	by the Free Software Foundation; either version 2 of the
+//	License, or (at your option) any later version
+// ==============================================================
+
+#ifndef _SHARED_PLATFORMCOMMON_MAPPEDFILE_H_
+#define _SHARED_PLATFORMCOMMON_MAPPEDFILE_H_
+
+#include <string>
+#include "data_types.h"
+#include "leak_dumper.h"
+
+using std::string;
+using Shared::Platform::uint8;
+using Shared::Platform::int64;
+
+#ifndef WIN32
+struct stat;
+#endif
+
+namespace Shared { namespace Platform {
+	class Mutex;
+}}
+
+namespace Shared { namespace PlatformCommon {
+
+// =====================================================
+//	class MappedFile
+//
+///	Whole file mapped copy on write into memory, or read in one go
+///	where mapping is not possible or the file is writable by us, as
+///	user and mod files are. Reference counted so that data loaded
+///	from it may point straight into it; writes stay private.
+// =====================================================
+
+class MappedFile {
+private:
+	string path;
+	uint8 *data;
+	int64 size;
+	bool mapped;			// false when read into a heap buffer
+
+	Shared::Platform::Mutex *mutexRefCount;
+	int refCount;
+
+	MappedFile(const string &path);
+	~MappedFile();
+
+	bool map();
+	bool read();
+#ifndef WIN32
+	static bool isWritable(const struct stat &fileStat);
+#endif
+
+public:
+	/// Returns NULL if the file can not be opened, the caller holds one reference
+	static MappedFile *open(const string &path);
+
+	void addRef();
+	void release();
+
+	const string &getPath() const	{return path;}
+	uint8 *getData() const			{return data;}
+	int64 getSize() const			{return size;}
+	bool isMapped() const			{return mapped;}
+
+	bool contains(const void *ptr) const {
+		return data != NULL && ptr >= data && ptr < data + size;
+	}
+};
+
+}}//end namespace
+
+#endif
@@ -15,6 +15,7 @@
 #include <vector>
 #include <string>
 #include "util.h"
+#include "mpsc_ring.h"
 #include "texture.h"
 #include "leak_dumper.h"
 
@@ -144,21 +145,31 @@ public:
 
 class LogFileEntry {
 public:
+	LogFileEntry() : type(SystemFlags::debugSystem), entryDateTime(0) {}
+
     SystemFlags::DebugType type;
     string entry;
     time_t entryDateTime;
 };
 
+inline void swap(LogFileEntry &a, LogFileEntry &b) {
+	std::swap(a.type, b.type);
+	a.entry.swap(b.entry);
+	std::swap(a.entryDateTime, b.entryDateTime);
+}
+
+/// Writes log entries for every thread. Producers only push to a lock
+/// free ring, so logging from the worker threads never waits on the
+/// file or on each other unless the writer falls a full ring behind
 class LogFileThread : public BaseThread
 {
 protected:
 
-    Mutex *mutexLogList;
-	vector<LogFileEntry> logList;
-	time_t lastSaveToDisk;
+	static const uint32 LOG_RING_CAPACITY = 16384;
+
+	MpscRing<LogFileEntry> logRing;
 
-    void saveToDisk(bool forceSaveAll,bool logListAlreadyLocked);
-    bool checkSaveCurrentLogBufferToDisk();
+    void saveToDisk();
 
 public:
 	LogFileThread();
@@ -0,0 +1,114 @@
+// ==============================================================
+//	This file is part of MegaGlest Shared Library (www.megaglest.org)
+//
+//	Copyright (C) 2026 The MegaGlest Team
+//
+//	You can redistribute this code and/or modify it under
+//	the terms of the GNU General Public License as published
+//	by the Free Software Foundation; either version 2 of the
+//	License, or (at your option) any later version
+// ==============================================================
+#ifndef _SHARED_PLATFORMCOMMON_TASKPOOL_H_
+#define _SHARED_PLATFORMCOMMON_TASKPOOL_H_
+
+#include "base_thread.h"
+#include <vector>
+#include <deque>
+#include <string>
+#include "leak_dumper.h"
+
+using namespace std;
+
+namespace Shared { namespace PlatformCommon {
+
+//
+// This interface describes the methods a task pool callback object must implement
+//
+class TaskPoolCallbackInterface {
+public:
+	// called once for every task index, from any of the pool's worker threads
+	virtual void runPoolTask(int taskIndex, int workerIndex) = 0;
+
+	virtual ~TaskPoolCallbackInterface() {}
+};
+
+class WorkStealingTaskPool;
+
+// =====================================================
+//	class TaskPoolWorkerThread
+// =====================================================
+
+class TaskPoolWorkerThread : public BaseThread
+{
+protected:
+	WorkStealingTaskPool *pool;
+	int workerIndex;
+	Semaphore semTaskSignalled;
+
+	Mutex *mutexTasks;
+	std::deque<int> tasks;
+
+	virtual void setQuitStatus(bool value);
+
+public:
+	TaskPoolWorkerThread(WorkStealingTaskPool *pool, int workerIndex);
+	virtual ~TaskPoolWorkerThread();
+	virtual void execute();
+	virtual bool canShutdown(bool deleteSelfIfShutdownDelayed=false);
+
+	void signalWork();
+	void addTasks(int firstTaskIndex, int lastTaskIndex);
+	// the owner works from the back of its queue, thieves take from the front
+	bool popTask(int &taskIndex);
+	bool stealTask(int &taskIndex);
+};
+
+// =====================================================
+//	class WorkStealingTaskPool
+//
+///	Fixed set of worker threads (one per core by default) that run
+///	batches of small indexed tasks. Each worker starts on its own
+///	contiguous slice of the batch and steals from the others once it
+///	runs dry, so one big slice doesn't leave the other cores idle.
+///	Tasks may run in any order on any thread; callers that need a
+///	deterministic outcome must merge per task results themselves.
+// =====================================================
+
+class WorkStealingTaskPool {
+protected:
+	friend class TaskPoolWorkerThread;
+
+	std::vector<TaskPoolWorkerThread *> workers;
+
+	Mutex *mutexRunTasks;
+	Mutex *mutexProgress;
+	Semaphore semTasksCompleted;
+	TaskPoolCallbackInterface *callback;
+	int tasksRemaining;
+	string taskError;
+
+	bool runNextTask(int workerIndex);
+	void runTask(int taskIndex, int workerIndex);
+
+public:
+	// workerCount < 1 means one worker per cpu core
+	explicit WorkStealingTaskPool(int workerCount=-1);
+	~WorkStealingTaskPool();
+
+	static int getCoreCount();
+	int getWorkerCount() const { return (int)workers.size(); }
+	// index of the pool worker running the calling thread, -1 for any other thread
+	static int getCurrentWorkerIndex();
+
+	// Runs tasks [0, taskCount) and returns once all of them have finished.
+	// The first exception thrown by a task is rethrown here.
+	void runTasks(TaskPoolCallbackInterface *callback, int taskCount);
+
+private:
+	WorkStealingTaskPool(const WorkStealingTaskPool &obj);
+	WorkStealingTaskPool &operator=(const WorkStealingTaskPool &obj);
+};
+
+}}//end namespace
+
+#endif
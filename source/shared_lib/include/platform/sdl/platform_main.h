@@ -28,6 +28,7 @@ const char  *GAME_ARGS[] = {
 	"--autostart-lastgame",
 	"--load-saved-game",
 	"--auto-test",
+	"--benchmark-replay",
 	"--connect",
 	"--connecthost",
 	"--starthost",
@@ -72,6 +73,7 @@ const char  *GAME_ARGS[] = {
 	"--show-techtree-crc",
 	"--show-scenario-crc",
 	"--show-path-crc",
+	"--diff-synch-snapshots",
 	"--disable-backtrace",
 	"--disable-sigsegv-handler",
 	"--disable-vbo",
@@ -112,6 +114,7 @@ enum GAME_ARG_TYPE {
 	GAME_ARG_AUTOSTART_LASTGAME,
 	GAME_ARG_AUTOSTART_LAST_SAVED_GAME,
 	GAME_ARG_AUTO_TEST,
+	GAME_ARG_BENCHMARK_REPLAY,
 	GAME_ARG_CONNECT,
 	GAME_ARG_CLIENT,
 	GAME_ARG_SERVER,
@@ -157,6 +160,7 @@ enum GAME_ARG_TYPE {
 	GAME_ARG_SHOW_TECHTREE_CRC,
 	GAME_ARG_SHOW_SCENARIO_CRC,
 	GAME_ARG_SHOW_PATH_CRC,
+	GAME_ARG_DIFF_SYNCH_SNAPSHOTS,
 
 	GAME_ARG_DISABLE_BACKTRACE,
 	GAME_ARG_DISABLE_SIGSEGV_HANDLER,
@@ -222,6 +226,17 @@ void printParameterHelp(const char *argv0, bool foundInvalidArgs) {
 	printf("\n\n                     \tafter the game is finished or the time runs out. If z is");
 	printf("\n\n                     \tnot specified (or is empty) then auto test continues to cycle.");
 
+	printf("\n\n%s=x,y,z,w\tReplay the commands of a saved game as fast as possible",GAME_ARGS[GAME_ARG_BENCHMARK_REPLAY]);
+	printf("\n\n                     \twithout a window, sound or network and report frames/sec,");
+	printf("\n\n                     \ttime per subsystem and the final world CRC, then exit.");
+	printf("\n\n                     \tWhere x is a game saved with SaveCommandsForReplay enabled.");
+	printf("\n\n                     \tWhere y is an optional # of frames to simulate. If y is not");
+	printf("\n\n                     \tspecified (or is 0) the whole replay is simulated.");
+	printf("\n\n                     \tWhere z is an optional expected world CRC. If the final CRC");
+	printf("\n\n                     \tdiffers the exit code is 1.");
+	printf("\n\n                     \tWhere w is an optional unit precache mode, pool runs it on");
+	printf("\n\n                     \tthe task pool and serial on the faction threads.");
+
 	printf("\n\n%s=x:y  \t\tAuto connect to host server at IP or hostname x using",GAME_ARGS[GAME_ARG_CONNECT]);
 	printf("\n\n                     \t    port y. Shortcut version of using %s and %s.",GAME_ARGS[GAME_ARG_CLIENT],GAME_ARGS[GAME_ARG_USE_PORTS]);
 	printf("\n\n                     \t*NOTE: to automatically connect to the first LAN host you may");
@@ -410,6 +425,11 @@ void printParameterHelp(const char *argv0, bool foundInvalidArgs) {
 	printf("\n\n                     \tWhere x is a path name and y is file(s) filter.");
 	printf("\n\n                     \texample: %s %s=techs/=megapack.7z",extractFileFromDirectoryPath(argv0).c_str(),GAME_ARGS[GAME_ARG_SHOW_PATH_CRC]);
 
+	printf("\n\n%s=x=y  \tShow the differences between the out of synch",GAME_ARGS[GAME_ARG_DIFF_SYNCH_SNAPSHOTS]);
+	printf("\n\n                     \t    snapshot files x and y, saved next to the");
+	printf("\n\n                     \t    world CRC logs of two players.");
+	printf("\n\n                     \texample: %s %s=debugCRCWorld.log_server.snapshot=debugCRCWorld.log_client.snapshot",extractFileFromDirectoryPath(argv0).c_str(),GAME_ARGS[GAME_ARG_DIFF_SYNCH_SNAPSHOTS]);
+
 	printf("\n\n%s  \tDisables stack backtrace on errors.",GAME_ARGS[GAME_ARG_DISABLE_BACKTRACE]);
 
 	printf("\n\n%s  ",GAME_ARGS[GAME_ARG_DISABLE_SIGSEGV_HANDLER]);
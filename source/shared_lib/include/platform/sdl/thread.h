@@ -535,6 +535,39 @@ public:
 	}
 };
 
+// =====================================================
+//	class CompletionLatch
+//
+///	Countdown latch: the waiting thread arms it with the number of
+///	jobs it hands out, every worker counts down once when its job is
+///	done and the waiter sleeps until the count reaches zero.
+// =====================================================
+
+class CompletionLatch {
+private:
+	Mutex *mutex;
+	Trigger *trigger;
+	int count;
+	int generation;
+
+public:
+	CompletionLatch();
+	~CompletionLatch();
+
+	// Arms the latch and returns the generation workers must count down
+	// with, so a worker that finishes late for an earlier round is ignored
+	int reset(int count);
+	void countDown(int generation);
+	int getCount();
+
+	// Returns true once the count reached zero, false if it timed out first
+	bool waitTillCompleted(int waitMilliseconds=-1);
+
+private:
+	CompletionLatch(const CompletionLatch &obj);
+	CompletionLatch &operator=(const CompletionLatch &obj);
+};
+
 }}//end namespace
 
 #endif
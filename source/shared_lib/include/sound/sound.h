@@ -78,19 +78,25 @@ public:
 
 // =====================================================
 //	class StaticSound
+//
+///	A sound file played whole, its samples are shared through
+///	the StaticSoundCache and only decoded when needed
 // =====================================================
 
+class StaticSoundData;
+
 class StaticSound: public Sound{
 private:
-	int8 * samples;
+	StaticSoundData *data;
 
 public:
 	StaticSound();
 	virtual ~StaticSound();
 
-	int8 *getSamples() const		{return samples;}
+	int8 *getSamples() const;
 	
 	void load(const string &path);
+	void prefetch() const;
 	void close();
 };
 
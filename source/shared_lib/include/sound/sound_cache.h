@@ -0,0 +1,114 @@
+// ==============================================================
+//	This file is part of MegaGlest Shared Library (www.megaglest.org)
+//
+//	Copyright (C) 2026 The MegaGlest Team
+//
+//	You can redistribute this code and/or modify it under
+//	the terms of the GNU General Public License as published
+//	by the Free Software Foundation; either version 2 of the
+//	License, or (at your option) any later version
+// ==============================================================
+
+#ifndef _SHARED_SOUND_SOUNDCACHE_H_
+#define _SHARED_SOUND_SOUNDCACHE_H_
+
+#include <string>
+#include <map>
+#include <deque>
+#include "sound.h"
+#include "simple_threads.h"
+#include "leak_dumper.h"
+
+using namespace std;
+using Shared::PlatformCommon::SimpleTaskThread;
+using Shared::PlatformCommon::SimpleTaskCallbackInterface;
+
+namespace Shared{ namespace Sound{
+
+// =====================================================
+//	class StaticSoundData
+//
+///	Samples of one sound file, shared by every StaticSound loaded
+///	from it or from a copy of it elsewhere in the techtree
+// =====================================================
+
+class StaticSoundData {
+	friend class StaticSoundCache;
+
+private:
+	string path;			// canonical path of the first file loaded
+	uint32 crc;				// as the techtree crc has it, name and contents
+	SoundInfo info;
+	int8 *samples;			// NULL until decoded
+
+	int refCount;
+	uint64 lastUsed;
+	bool decoding;
+	bool prefetchQueued;
+	bool decodeFailed;		// not retried on every play
+
+	StaticSoundData(const string &path, uint32 crc, const SoundInfo &info);
+	~StaticSoundData();
+
+public:
+	const string &getPath() const		{return path;}
+	uint32 getCRC() const				{return crc;}
+	const SoundInfo *getInfo() const	{return &info;}
+	bool isDecoded() const				{return samples != NULL;}
+};
+
+// =====================================================
+//	class StaticSoundCache
+//
+///	Registry of the static sound files by canonical path and crc.
+///	Samples are decoded on first play or by a background prefetch, the
+///	least recently played ones are freed when over the memory budget.
+///	Only the thread playing sounds frees samples, the pointer getSamples
+///	returns is valid until its next call on that thread, it is NULL
+///	when the file could not be decoded.
+// =====================================================
+
+class StaticSoundCache : public SimpleTaskCallbackInterface {
+private:
+	typedef std::map<string,StaticSoundData *> PathMap;
+	typedef std::map<std::pair<uint32,uint32>,StaticSoundData *> ContentMap;
+
+	Mutex *mutex;
+	PathMap paths;
+	ContentMap contents;
+	std::deque<StaticSoundData *> prefetchQueue;
+	SimpleTaskThread *prefetchThread;
+
+	int64 memoryBudget;		// 0 keeps all decoded samples
+	int64 decodedBytes;
+	uint64 useCount;
+
+	StaticSoundCache();
+
+	static string getCanonicalPath(const string &path);
+	static int8 *decode(const string &path, uint32 size);
+
+	void evictLeastRecentlyUsed(const StaticSoundData *keep);
+	void destroy(StaticSoundData *data);
+
+public:
+	static StaticSoundCache &getInstance();
+	virtual ~StaticSoundCache();
+
+	StaticSoundData *acquire(const string &path, SoundInfo *info);
+	void release(StaticSoundData *data);
+	int8 *getSamples(StaticSoundData *data);
+	void prefetch(StaticSoundData *data);
+	void stopPrefetch();
+
+	void setMemoryBudget(int64 bytes);
+	int64 getMemoryBudget();
+	int64 getDecodedBytes();
+	int getEntryCount();
+
+	virtual void simpleTask(BaseThread *callingThread,void *userdata);
+};
+
+}}//end namespace
+
+#endif
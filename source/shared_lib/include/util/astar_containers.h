@@ -0,0 +1,197 @@
+// ==============================================================
+//	This file is part of MegaGlest Shared Library (www.megaglest.org)
+//
+//	Copyright (C) 2026 The MegaGlest Team
+//
+//	You can redistribute this code and/or modify it under
+//	the terms of the GNU General Public License as published
+//	by the Free Software Foundation; either version 2 of the
+//	License, or (at your option) any later version
+// ==============================================================
+
+#ifndef _SHARED_UTIL_ASTARCONTAINERS_H_
+#define _SHARED_UTIL_ASTARCONTAINERS_H_
+
+#include <vector>
+#include <algorithm>
+#include <stdexcept>
+#include "data_types.h"
+#include "leak_dumper.h"
+
+using namespace Shared::Platform;
+
+namespace Shared { namespace Util {
+
+// =====================================================
+//	class AStarOpenList
+//
+///	Binary min-heap of search nodes keyed on a float cost.
+///	Entries with equal cost are popped in insertion order, which is
+///	exactly how the old std::map<float, vector<T> > buckets behaved, so
+///	searches built on top of it expand nodes in the same sequence.
+// =====================================================
+
+template <typename T>
+class AStarOpenList {
+private:
+	class Entry {
+	public:
+		float cost;
+		uint32 sequence;
+		T value;
+	};
+
+	std::vector<Entry> heap;
+	uint32 nextSequence;
+
+	inline static bool before(const Entry &left, const Entry &right) {
+		if(left.cost < right.cost) {
+			return true;
+		}
+		if(right.cost < left.cost) {
+			return false;
+		}
+		return left.sequence < right.sequence;
+	}
+
+	void siftUp(size_t index) {
+		Entry entry = heap[index];
+		while(index > 0) {
+			size_t parent = (index - 1) / 2;
+			if(before(entry,heap[parent]) == false) {
+				break;
+			}
+			heap[index] = heap[parent];
+			index = parent;
+		}
+		heap[index] = entry;
+	}
+
+	void siftDown(size_t index) {
+		const size_t count = heap.size();
+		Entry entry = heap[index];
+		for(;;) {
+			size_t child = index * 2 + 1;
+			if(child >= count) {
+				break;
+			}
+			if(child + 1 < count && before(heap[child + 1],heap[child]) == true) {
+				child++;
+			}
+			if(before(heap[child],entry) == false) {
+				break;
+			}
+			heap[index] = heap[child];
+			index = child;
+		}
+		heap[index] = entry;
+	}
+
+public:
+	AStarOpenList() : nextSequence(0) {}
+
+	void reserve(size_t count) 	{ heap.reserve(count); }
+	bool empty() const 			{ return heap.empty(); }
+	size_t size() const 		{ return heap.size(); }
+
+	void clear() {
+		heap.clear();
+		nextSequence = 0;
+	}
+
+	void push(float cost, const T &value) {
+		Entry entry;
+		entry.cost 		= cost;
+		entry.sequence 	= nextSequence++;
+		entry.value 	= value;
+		heap.push_back(entry);
+		siftUp(heap.size() - 1);
+	}
+
+	const T & top() const {
+		if(heap.empty() == true) {
+			throw std::runtime_error("AStarOpenList::top() on empty list");
+		}
+		return heap.front().value;
+	}
+
+	T pop() {
+		if(heap.empty() == true) {
+			throw std::runtime_error("AStarOpenList::pop() on empty list");
+		}
+		T result = heap.front().value;
+		heap.front() = heap.back();
+		heap.pop_back();
+		if(heap.empty() == false) {
+			siftDown(0);
+		}
+		return result;
+	}
+};
+
+// =====================================================
+//	class GenerationMarkGrid
+//
+///	Flat per-cell "seen" flags for a w x h grid. Clearing is O(1): every
+///	search bumps the generation and a cell counts as marked only while
+///	its stamp equals the current generation.
+// =====================================================
+
+class GenerationMarkGrid {
+private:
+	std::vector<uint32> stamps;
+	int w;
+	int h;
+	uint32 generation;
+	uint32 markedCount;
+
+public:
+	GenerationMarkGrid() : w(0), h(0), generation(1), markedCount(0) {}
+
+	void resize(int w, int h) {
+		if(w == this->w && h == this->h) {
+			return;
+		}
+		this->w = w;
+		this->h = h;
+		stamps.assign((size_t)w * (size_t)h, 0);
+		generation = 1;
+		markedCount = 0;
+	}
+
+	void clear() {
+		markedCount = 0;
+		generation++;
+		if(generation == 0) {
+			// stamps wrapped, start over so stale cells are never seen as marked
+			std::fill(stamps.begin(),stamps.end(),0);
+			generation = 1;
+		}
+	}
+
+	inline bool isInside(int x, int y) const {
+		return x >= 0 && y >= 0 && x < w && y < h;
+	}
+
+	inline bool isMarked(int x, int y) const {
+		return isInside(x,y) == true && stamps[(size_t)y * w + x] == generation;
+	}
+
+	inline void mark(int x, int y) {
+		if(isInside(x,y) == true) {
+			uint32 &stamp = stamps[(size_t)y * w + x];
+			if(stamp != generation) {
+				stamp = generation;
+				markedCount++;
+			}
+		}
+	}
+
+	int getW() const 				{ return w; }
+	int getH() const 				{ return h; }
+	uint32 getMarkedCount() const 	{ return markedCount; }
+};
+
+}}//end namespace
+
+#endif
@@ -28,6 +28,16 @@ namespace Shared{ namespace Util{
 // =====================================================
 
 class Checksum {
+public:
+	// Ways of computing the same CRC-32 (the zip / png polynomial)
+	enum CrcBackend {
+		cbBytewise,				// one table lookup per byte
+		cbSlicingBy8,			// eight table lookups per eight bytes
+		cbCarrylessMultiply,	// PCLMULQDQ folding, x86 cpus that have it
+
+		cbCount
+	};
+
 private:
 	uint32	sum;
 	int32	r;
@@ -59,6 +69,15 @@ public:
 
 	static void removeFileFromCache(const string file);
 	static void clearFileCache();
+
+	// The fastest supported backend is picked at startup, switching
+	// is meant for tests and benchmarks and is not thread safe
+	static bool isCrcBackendSupported(CrcBackend backend);
+	static bool setCrcBackend(CrcBackend backend);
+	static CrcBackend getCrcBackend();
+	static const char * getCrcBackendName(CrcBackend backend);
+	// Continues the crc of a previous call (start with 0)
+	static uint32 updateCrc(uint32 crc, const void *data, size_t size);
 };
 
 }}//end namespace
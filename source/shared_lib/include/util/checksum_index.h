@@ -0,0 +1,129 @@
+// ==============================================================
+//	This file is part of MegaGlest Shared Library (www.megaglest.org)
+//
+//	Copyright (C) 2026 The MegaGlest Team
+//
+//	You can redistribute this code and/or modify it under
+//	the terms of the GNU General Public License as published
+//	by the Free Software Foundation; either version 2 of the
+//	License, or (at your option) any later version
+// ==============================================================
+
+#ifndef _SHARED_UTIL_CHECKSUMINDEX_H_
+#define _SHARED_UTIL_CHECKSUMINDEX_H_
+
+#include <string>
+#include <vector>
+#include <map>
+#include <set>
+#include "data_types.h"
+#include "thread.h"
+#include "leak_dumper.h"
+
+using std::string;
+using std::vector;
+using namespace Shared::Platform;
+
+namespace Shared{ namespace Util{
+
+// =====================================================
+//	class FileCRCIndex
+//
+///	Persistent index of the crc of every file hashed so far,
+///	keyed by path and validated by size and modification time,
+///	so only files that changed since the last run are read again
+// =====================================================
+
+class FileCRCIndex {
+public:
+	static const char *indexFileName;
+	static const int version;
+
+private:
+	class Entry {
+	public:
+		Entry() : size(0), modified(0), crc(0) {}
+
+		int64 size;
+		int64 modified;
+		uint32 crc;
+	};
+
+	static Mutex indexSynchAccessor;
+	static std::map<string,Entry> entries;
+	static string loadedFromFile;
+	static bool dirty;
+	static bool enabled;
+
+	static string getIndexFile();
+	static void loadIfRequired();
+
+public:
+	// Size and modification time of a file, false if it can't be read
+	static bool getFileStat(const string &path, int64 &size, int64 &modified);
+
+	static bool findCRC(const string &path, int64 size, int64 modified, uint32 &crc);
+	static void setCRC(const string &path, int64 size, int64 modified, uint32 crc);
+	static void removeCRC(const string &path);
+
+	static bool save();
+	static void clear();
+	static int getEntryCount();
+
+	// Tests and tools that must not touch the user's index turn it off
+	static void setEnabled(bool value);
+	static bool isEnabled();
+};
+
+// =====================================================
+//	class FileCRCTree
+//
+///	Merkle style directory sums of a list of file crcs. The sum
+///	of a directory is the sum of the crcs of every file below it,
+///	the same way the crc of a whole tree is combined, so two trees
+///	are compared by only descending into directories that differ.
+// =====================================================
+
+class FileCRCTree {
+public:
+	typedef vector<std::pair<string,uint32> > FileList;
+
+private:
+	class Node {
+	public:
+		Node() : sum(0), fileCount(0) {}
+
+		uint32 sum;
+		int fileCount;
+		std::map<string,uint32> files;		// path -> crc, only the ones directly inside
+		std::set<string> folders;			// child directories
+	};
+
+	std::map<string,Node> nodes;			// "" is the root
+
+	static string getParentFolder(const string &path);
+
+	const Node *findNode(const string &folder) const;
+	void compareFolder(const FileCRCTree &other, const string &folder,
+						vector<string> &differentFiles, int &foldersVisited) const;
+
+public:
+	FileCRCTree() {}
+	explicit FileCRCTree(const FileList &fileList) { build(fileList); }
+
+	void build(const FileList &fileList);
+
+	bool hasFolder(const string &folder) const;
+	uint32 getFolderSum(const string &folder) const;
+	int getFolderFileCount(const string &folder) const;
+	vector<string> getChildFolders(const string &folder) const;
+	uint32 getFileCRC(const string &path, bool *found) const;
+
+	// Files of this tree missing or with a different crc in the other
+	// one, returns the number of directories that had to be looked at
+	int getDifferentFiles(const FileCRCTree &other, vector<string> &differentFiles) const;
+};
+
+}}//end namespace
+
+#endif
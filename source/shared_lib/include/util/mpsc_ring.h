@@ -0,0 +1,133 @@
+// ==============================================================
+//	This file is part of MegaGlest Shared Library (www.megaglest.org)
+//
+//	Copyright (C) 2026 The MegaGlest Team
+//
+//	You can redistribute this code and/or modify it under
+//	the terms of the GNU General Public License as published
+//	by the Free Software Foundation; either version 2 of the
+//	License, or (at your option) any later version
+// ==============================================================
+
+#ifndef _SHARED_UTIL_MPSCRING_H_
+#define _SHARED_UTIL_MPSCRING_H_
+
+#include <SDL_atomic.h>
+#include <algorithm>
+#include "data_types.h"
+#include "leak_dumper.h"
+
+using namespace Shared::Platform;
+
+namespace Shared{ namespace Util{
+
+// =====================================================
+//	class MpscRing
+//
+/// Bounded queue that any number of threads push to and a single
+/// thread pops from, without taking a lock. Every slot carries a
+/// sequence number that tells producers and the consumer whose turn
+/// the slot is (the bounded queue described by Dmitry Vyukov).
+/// Values are moved in and out with swap so strings are not copied.
+// =====================================================
+
+template<typename T>
+class MpscRing {
+private:
+	struct Slot {
+		SDL_atomic_t sequence;
+		T value;
+	};
+
+	Slot *slots;
+	uint32 mask;
+	mutable SDL_atomic_t enqueuePos;
+	mutable SDL_atomic_t dequeuePos;
+
+	MpscRing(const MpscRing &);
+	MpscRing &operator=(const MpscRing &);
+
+	// The owner of a slot is the only writer of its sequence, so this
+	// always succeeds. CAS is a full barrier where SDL_AtomicSet may only
+	// be an acquire one, and the value must be visible before the slot is
+	static void publish(Slot &slot, uint32 sequence) {
+		SDL_AtomicCAS(&slot.sequence, SDL_AtomicGet(&slot.sequence), (int)sequence);
+	}
+
+public:
+	// capacity is rounded up to a power of two
+	explicit MpscRing(uint32 capacity) {
+		uint32 size= 2;
+		while(size < capacity) {
+			size <<= 1;
+		}
+		slots= new Slot[size];
+		mask= size - 1;
+		for(uint32 i = 0; i < size; ++i) {
+			SDL_AtomicSet(&slots[i].sequence, (int)i);
+		}
+		SDL_AtomicSet(&enqueuePos, 0);
+		SDL_AtomicSet(&dequeuePos, 0);
+	}
+
+	~MpscRing() {
+		delete [] slots;
+		slots= NULL;
+	}
+
+	uint32 getCapacity() const	{ return mask + 1; }
+
+	// Entries pushed and not popped yet, exact only while nobody pushes
+	uint32 size() const {
+		return (uint32)SDL_AtomicGet(&enqueuePos) - (uint32)SDL_AtomicGet(&dequeuePos);
+	}
+
+	// Any thread. On success value holds what the slot held before,
+	// returns false and leaves value alone when the ring is full
+	bool tryPush(T &value) {
+		uint32 pos= (uint32)SDL_AtomicGet(&enqueuePos);
+		for(;;) {
+			Slot &slot= slots[pos & mask];
+			int diff= (int)((uint32)SDL_AtomicGet(&slot.sequence) - pos);
+			if(diff == 0) {
+				// the slot is free, claim the position
+				if(SDL_AtomicCAS(&enqueuePos, (int)pos, (int)(pos + 1)) == SDL_TRUE) {
+					using std::swap;
+					swap(slot.value, value);
+					publish(slot, pos + 1);
+					return true;
+				}
+				pos= (uint32)SDL_AtomicGet(&enqueuePos);
+			}
+			else if(diff < 0) {
+				// the consumer has not freed this slot since the last lap
+				return false;
+			}
+			else {
+				// another producer claimed pos first
+				pos= (uint32)SDL_AtomicGet(&enqueuePos);
+			}
+		}
+	}
+
+	// Consumer thread only. Returns false when nothing is published yet
+	bool tryPop(T &value) {
+		uint32 pos= (uint32)SDL_AtomicGet(&dequeuePos);
+		Slot &slot= slots[pos & mask];
+		int diff= (int)((uint32)SDL_AtomicGet(&slot.sequence) - (pos + 1));
+		if(diff < 0) {
+			return false;
+		}
+		using std::swap;
+		swap(value, slot.value);
+		slot.value= T();
+		// hand the slot back to the producers one lap later
+		publish(slot, pos + mask + 1);
+		SDL_AtomicSet(&dequeuePos, (int)(pos + 1));
+		return true;
+	}
+};
+
+}}//end namespace
+
+#endif
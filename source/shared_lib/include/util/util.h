@@ -145,6 +145,9 @@ protected:
 	static int lockFileCountIndex;
 
 	static std::map<DebugType,SystemFlagsType> *debugLogFileList;
+	// One bit per DebugType mirroring SystemFlagsType::enabled, a word
+	// sized value so readers on any thread see the old or the new mask
+	static uint32 debugEnabledMask;
 	static bool haveSpecialOutputCommandLineOption;
 	static bool curl_global_init_called;
 
@@ -177,6 +180,13 @@ public:
 		return (*debugLogFileList)[type];
 	}
 
+	// A single load, for checks made per node, cell or unit
+	inline static bool isDebugEnabled(DebugType type) {
+		return (debugEnabledMask & (1u << type)) != 0;
+	}
+	// Sets SystemFlagsType::enabled and the bit isDebugEnabled reads
+	static void setDebugEnabled(DebugType type, bool enabled);
+
 	static size_t httpWriteMemoryCallback(void *ptr, size_t size, size_t nmemb, void *data);
 	static std::string getHTTP(std::string URL,CURL *handle=NULL, int timeOut=-1, CURLcode *savedResult=NULL);
 	static std::string escapeURL(std::string URL, CURL *handle=NULL);
@@ -0,0 +1,140 @@
+// ==============================================================
+//	This file is part of MegaGlest Shared Library (www.megaglest.org)
+//
+//	Copyright (C) 2026 The MegaGlest Team
+//
+//	You can redistribute this code and/or modify it under
+//	the terms of the GNU General Public License as published
+//	by the Free Software Foundation; either version 2 of the
+//	License, or (at your option) any later version
+// ==============================================================
+
+#ifndef _SHARED_UTIL_ZONEPROFILER_H_
+#define _SHARED_UTIL_ZONEPROFILER_H_
+
+#include <csignal>
+#include <string>
+#include <vector>
+#include "data_types.h"
+#include "thread.h"
+#include "leak_dumper.h"
+
+using std::string;
+using std::vector;
+using namespace Shared::Platform;
+
+namespace Shared{ namespace Util{
+
+// One instrumented scope. PROFILE_ZONE declares it as a function local
+// constant, so it is set up before any thread runs and its address
+// serves as the zone id without any registration or lookup
+struct ProfileZoneInfo {
+	const char *name;
+	const char *file;
+	int line;
+};
+
+// =====================================================
+//	class ZoneProfiler
+//
+/// Records the begin and end of PROFILE_ZONE scopes on every thread
+/// while a capture runs and writes them as Chrome trace-event JSON
+/// (chrome://tracing, ui.perfetto.dev). Each thread appends to its own
+/// buffer, nothing is shared between threads while recording
+// =====================================================
+
+class ZoneProfiler {
+public:
+	struct Event {
+		const ProfileZoneInfo *zone;
+		int64 startNanos;
+		int64 endNanos;
+	};
+
+	// Inclusive time spent in one zone during the capture
+	struct ZoneTotal {
+		const ProfileZoneInfo *zone;
+		uint32 calls;
+		int64 nanos;
+	};
+
+	class ThreadBuffer;
+
+	static const uint32 EVENTS_PER_THREAD = 1 << 17;
+	static const int ZONES_PER_THREAD = 64;
+
+private:
+	static bool enabled;
+	static int captureGeneration;
+	static int64 captureStartNanos;
+	static int64 captureEndNanos;
+	static volatile sig_atomic_t toggleRequested;
+
+	static Mutex threadBuffersMutex;
+	static vector<ThreadBuffer *> threadBuffers;
+
+	static ThreadBuffer *getThreadBuffer();
+
+public:
+	// Monotonic clock in nanoseconds
+	static int64 getNanos();
+
+	inline static bool isEnabled() { return enabled; }
+
+	// Starts a new capture, dropping the events of the last one
+	static void start();
+	// Stops recording, the events stay until the next start
+	static void stop();
+
+	// Name shown for the calling thread in the trace
+	static void setThreadName(const string &name);
+	// Called by a thread that is about to exit so its buffer can be reused
+	static void releaseThreadBuffer();
+
+	static void record(const ProfileZoneInfo *zone, int64 startNanos, int64 endNanos);
+
+	// Writes the last capture, returns false if the file can't be written
+	static bool exportChromeTrace(const string &path);
+	static string getStats();
+	// Calls and time per zone summed over all threads, slowest first. Unlike
+	// the trace these keep counting once the event buffers are full. Exact
+	// only while no thread is inside a zone
+	static vector<ZoneTotal> getZoneTotals();
+
+	// Safe to call from a signal handler, the main loop polls it
+	static void requestToggle() { toggleRequested = 1; }
+	static bool takeToggleRequest();
+};
+
+// =====================================================
+//	class ProfileZone
+// =====================================================
+
+class ProfileZone {
+private:
+	const ProfileZoneInfo *zone;
+	int64 startNanos;
+
+public:
+	explicit ProfileZone(const ProfileZoneInfo *zone) {
+		this->zone= zone;
+		this->startNanos= (ZoneProfiler::isEnabled() == true ? ZoneProfiler::getNanos() : -1);
+	}
+	~ProfileZone() {
+		if(startNanos >= 0) {
+			ZoneProfiler::record(zone, startNanos, ZoneProfiler::getNanos());
+		}
+	}
+};
+
+#define PROFILE_ZONE_JOIN2(a,b) a##b
+#define PROFILE_ZONE_JOIN(a,b) PROFILE_ZONE_JOIN2(a,b)
+
+// Times the rest of the enclosing scope, name must be a string literal
+#define PROFILE_ZONE(name) \
+	static const ::Shared::Util::ProfileZoneInfo PROFILE_ZONE_JOIN(profileZoneInfo,__LINE__) = { name, __FILE__, __LINE__ }; \
+	::Shared::Util::ProfileZone PROFILE_ZONE_JOIN(profileZone,__LINE__)(&PROFILE_ZONE_JOIN(profileZoneInfo,__LINE__))
+
+}}//end namespace
+
+#endif
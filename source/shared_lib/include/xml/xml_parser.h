@@ -128,6 +128,35 @@ public:
 	void save(const string &path, const XmlNode *node);
 };
 
+// =====================================================
+//	class XmlIoBinary
+//
+///	Compact encoding of a node tree, used for saved games. Names are
+///	written once and referred to by index afterwards, and the stream is
+///	cut into zlib compressed chunks that go to disk as they fill up, so
+///	neither the XML text nor the whole encoded tree is held in memory.
+///	XmlIoRapid::load recognizes these files, so they load through
+///	XmlTree::load like any XML file
+// =====================================================
+
+class XmlIoBinary {
+public:
+	static const Shared::Platform::uint32 FORMAT_VERSION	= 1;
+	// uncompressed bytes per chunk, small enough that zlib's worst case
+	// still fits the buffer compressMemoryToMemory allocates
+	static const Shared::Platform::uint32 CHUNK_SIZE		= 1 << 17;
+
+	// true if data starts with the header save writes
+	static bool isBinary(const char *data, size_t size);
+	// the same check on the first bytes of a file, false if unreadable
+	static bool isBinaryFile(const string &path);
+
+	static void save(const string &path, const XmlNode *node, int compressionLevel=5);
+	// the same encoding into memory, replacing the contents of buffer
+	static void save(vector<unsigned char> &buffer, const XmlNode *node, int compressionLevel=5);
+	static XmlNode *load(const char *data, size_t size, const std::map<string,string> &mapTagReplacementValues, bool skipUpdatePathClimbingParts=false);
+};
+
 // =====================================================
 //	class XmlTree
 // =====================================================
@@ -152,6 +181,9 @@ public:
 	void init(const string &name);
 	void load(const string &path, const std::map<string,string> &mapTagReplacementValues, bool noValidation=false,bool skipStackCheck=false,bool skipStackTrace=false);
 	void save(const string &path);
+	void saveBinary(const string &path);
+	void saveBinary(vector<unsigned char> &buffer);
+	void loadBinary(const char *data, size_t size, const std::map<string,string> &mapTagReplacementValues);
 
 	XmlNode *getRootNode() const	{return rootNode;}
 };
@@ -162,6 +194,8 @@ public:
 
 class XmlNode {
 private:
+	friend class XmlBinaryReader;
+
 	string name;
 	string text;
 	vector<XmlNode*> children;
@@ -21,8 +21,14 @@
 #include "platform_util.h"
 #include "leak_dumper.h"
 
+#if defined(__SSE2__) || defined(_M_X64) || defined(_M_AMD64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+  #define INTERPOLATION_SSE2
+  #include <emmintrin.h>
+#endif
+
 using namespace std;
 using namespace Shared::Util;
+using namespace Shared::Platform;
 
 namespace Shared{ namespace Graphics{
 
@@ -31,6 +37,16 @@ namespace Shared{ namespace Graphics{
 // =====================================================
 
 bool InterpolationData::enableInterpolation = true;
+bool InterpolationData::enableSimd = true;
+bool InterpolationData::normalizeNormals = false;
+
+float InterpolationData::frameCacheStep = 0.0f;
+int64 InterpolationData::frameCacheMemoryBudget = 32 * 1024 * 1024;
+int64 InterpolationData::frameCacheBytes = 0;
+int64 InterpolationData::frameCacheHits = 0;
+int64 InterpolationData::frameCacheMisses = 0;
+InterpolationData::FrameCacheLru InterpolationData::frameCacheLru;
+Mutex InterpolationData::frameCacheMutex;
 
 InterpolationData::InterpolationData(const Mesh *mesh) {
 	if(GlobalStaticFlags::getIsNonGraphicalModeEnabled() == true) {
@@ -41,11 +57,24 @@ InterpolationData::InterpolationData(const Mesh *mesh) {
 	normals= NULL;
 	
 	raw_frame_ofs = 0;
+
+	vertexFrame= NULL;
+	normalFrame= NULL;
 	
 	this->mesh= mesh;
 }
 
 InterpolationData::~InterpolationData(){
+	if(frameCache.empty() == false) {
+		static string mutexOwnerId = string(extractFileFromDirectoryPath(__FILE__).c_str()) + string("_") + intToStr(__LINE__);
+		MutexSafeWrapper safeMutex(&frameCacheMutex,mutexOwnerId);
+		while(frameCache.empty() == false) {
+			removeFrame(frameCache.begin()->second);
+		}
+	}
+	vertexFrame= NULL;
+	normalFrame= NULL;
+
 	delete [] vertices;
 	vertices=NULL;
 	delete [] normals;
@@ -58,14 +87,118 @@ void InterpolationData::update(float t, bool cycle){
 }
 
 void InterpolationData::updateVertices(float t, bool cycle) {
-	update(mesh->getVertices(), vertices, t, cycle);
+	if(updateFromCache(t, cycle, false) == false) {
+		update(mesh->getVertices(), vertices, t, cycle, false);
+	}
 }
 
 void InterpolationData::updateNormals(float t, bool cycle) {
-	update(mesh->getNormals(), normals, t, cycle);
+	if(updateFromCache(t, cycle, true) == false) {
+		update(mesh->getNormals(), normals, t, cycle, normalizeNormals);
+	}
+}
+
+bool InterpolationData::updateFromCache(float t, bool cycle, bool forNormals) {
+	CachedFrame *&current= (forNormals == true ? normalFrame : vertexFrame);
+
+	if(frameCacheStep <= 0.0f || enableInterpolation == false ||
+		mesh->getFrameCount() <= 1 || t < 0.0f || t > 1.0f) {
+		current= NULL;
+		return false;
+	}
+
+	// units at the same quantized progress ask for the same key
+	int step= static_cast<int>(t / frameCacheStep + 0.5f);
+	float quantizedT= min(1.0f, step * frameCacheStep);
+	int key= step * 2 + (cycle == true ? 1 : 0);
+
+	static string mutexOwnerId = string(extractFileFromDirectoryPath(__FILE__).c_str()) + string("_") + intToStr(__LINE__);
+	MutexSafeWrapper safeMutex(&frameCacheMutex,mutexOwnerId);
+
+	CachedFrame *frame= NULL;
+	FrameCache::iterator iterFind= frameCache.find(key);
+	if(iterFind != frameCache.end()) {
+		frame= iterFind->second;
+		frameCacheLru.splice(frameCacheLru.end(), frameCacheLru, frame->lruPosition);
+	}
+	else {
+		frame= new CachedFrame();
+		frame->owner= this;
+		frame->key= key;
+		frame->vertices= NULL;
+		frame->normals= NULL;
+		frame->bytes= 0;
+		frame->lruPosition= frameCacheLru.insert(frameCacheLru.end(), frame);
+		frameCache[key]= frame;
+	}
+
+	Vec3f *&dest= (forNormals == true ? frame->normals : frame->vertices);
+	if(dest == NULL) {
+		frameCacheMisses++;
+		if(forNormals == true) {
+			update(mesh->getNormals(), dest, quantizedT, cycle, normalizeNormals);
+		}
+		else {
+			update(mesh->getVertices(), dest, quantizedT, cycle, false);
+		}
+		int64 bytes= (int64)sizeof(Vec3f) * mesh->getVertexCount();
+		frame->bytes+= bytes;
+		frameCacheBytes+= bytes;
+	}
+	else {
+		frameCacheHits++;
+	}
+	current= frame;
+
+	if(frameCacheBytes > frameCacheMemoryBudget) {
+		evictFrames();
+	}
+	return true;
+}
+
+// Called with frameCacheMutex held. Oldest frames go first, the ones a
+// mesh is currently pointing at are kept even if that exceeds the budget
+void InterpolationData::evictFrames() {
+	FrameCacheLru::iterator iterLru= frameCacheLru.begin();
+	while(frameCacheBytes > frameCacheMemoryBudget && iterLru != frameCacheLru.end()) {
+		CachedFrame *frame= *iterLru;
+		++iterLru;
+		if(frame != frame->owner->vertexFrame && frame != frame->owner->normalFrame) {
+			removeFrame(frame);
+		}
+	}
 }
 
-void InterpolationData::update(const Vec3f* src, Vec3f* &dest, float t, bool cycle) {
+// Called with frameCacheMutex held
+void InterpolationData::removeFrame(CachedFrame *frame) {
+	InterpolationData *owner= frame->owner;
+	if(owner->vertexFrame == frame) {
+		owner->vertexFrame= NULL;
+	}
+	if(owner->normalFrame == frame) {
+		owner->normalFrame= NULL;
+	}
+	owner->frameCache.erase(frame->key);
+	frameCacheLru.erase(frame->lruPosition);
+	frameCacheBytes-= frame->bytes;
+
+	delete [] frame->vertices;
+	delete [] frame->normals;
+	delete frame;
+}
+
+string InterpolationData::getFrameCacheStats() {
+	static string mutexOwnerId = string(extractFileFromDirectoryPath(__FILE__).c_str()) + string("_") + intToStr(__LINE__);
+	MutexSafeWrapper safeMutex(&frameCacheMutex,mutexOwnerId);
+
+	char szBuf[8096]="";
+	snprintf(szBuf,8096,"frames [%d] memory [%lld KB / %lld KB] hits [%lld] misses [%lld]",
+			(int)frameCacheLru.size(),(long long)(frameCacheBytes / 1024),
+			(long long)(frameCacheMemoryBudget / 1024),(long long)frameCacheHits,(long long)frameCacheMisses);
+	return szBuf;
+}
+
+void InterpolationData::update(const Vec3f* src, Vec3f* &dest, float t, bool cycle, bool normalize) {
 
 	if(t <0.0f || t>1.0f) {
 		printf("ERROR t = [%f] for cycle [%d] f [%d] v [%d]\n",t,cycle,mesh->getFrameCount(),mesh->getVertexCount());
@@ -109,13 +242,99 @@ void InterpolationData::update(const Vec3f* src, Vec3f* &dest, float t, bool cyc
 			if(!dest) { // not previously allocated
 			      dest = new Vec3f[vertexCount];
 			}
-			for(uint32 j=0; j<vertexCount; ++j){
-				dest[j]= src[prevFrameBase+j].lerp(localT, src[nextFrameBase+j]);
-			}
+			lerpFrames(&src[prevFrameBase], &src[nextFrameBase], dest, vertexCount,
+						localT, normalize, enableSimd);
 		} else {
 			raw_frame_ofs = prevFrameBase;
 		}
 	}
 }
 
+#ifdef INTERPOLATION_SSE2
+
+// Same operations in the same order as Vec3f::lerp and Vec3f::normalize,
+// sqrt and division are exactly rounded in both, so the results match
+static inline __m128 lerp4(const float *prev, const float *next, __m128 t) {
+	__m128 a= _mm_loadu_ps(prev);
+	return _mm_add_ps(a, _mm_mul_ps(_mm_sub_ps(_mm_loadu_ps(next), a), t));
+}
+
+static void lerpFramesSse2(const Vec3f *prev, const Vec3f *next, Vec3f *dest,
+							uint32 count, float t, bool normalize) {
+	const __m128 factor= _mm_set1_ps(t);
+
+	// four vertices are twelve floats, three registers
+	uint32 j= 0;
+	for(; j + 4 <= count; j += 4) {
+		const float *a= prev[j].ptr();
+		const float *b= next[j].ptr();
+		float *d= dest[j].ptr();
+
+		__m128 r0= lerp4(a, b, factor);		// x0 y0 z0 x1
+		__m128 r1= lerp4(a + 4, b + 4, factor);	// y1 z1 x2 y2
+		__m128 r2= lerp4(a + 8, b + 8, factor);	// z2 x3 y3 z3
+
+		if(normalize == true) {
+			__m128 x= _mm_shuffle_ps(_mm_shuffle_ps(r0, r0, _MM_SHUFFLE(3,3,0,0)),
+									_mm_shuffle_ps(r1, r2, _MM_SHUFFLE(1,1,2,2)), _MM_SHUFFLE(2,0,2,0));
+			__m128 y= _mm_shuffle_ps(_mm_shuffle_ps(r0, r1, _MM_SHUFFLE(0,0,1,1)),
+									_mm_shuffle_ps(r1, r2, _MM_SHUFFLE(2,2,3,3)), _MM_SHUFFLE(2,0,2,0));
+			__m128 z= _mm_shuffle_ps(_mm_shuffle_ps(r0, r1, _MM_SHUFFLE(1,1,2,2)),
+									_mm_shuffle_ps(r2, r2, _MM_SHUFFLE(3,3,0,0)), _MM_SHUFFLE(2,0,2,0));
+			__m128 length= _mm_sqrt_ps(_mm_add_ps(_mm_add_ps(_mm_mul_ps(x, x), _mm_mul_ps(y, y)), _mm_mul_ps(z, z)));
+#ifndef USE_STREFLOP
+			// Vec3f::length truncates its result in these builds
+			float lengths[4];
+			_mm_storeu_ps(lengths, length);
+			for(int lane = 0; lane < 4; ++lane) {
+				lengths[lane]= truncateDecimal<float>(lengths[lane], 6);
+			}
+			length= _mm_loadu_ps(lengths);
+#endif
+
+			r0= _mm_div_ps(r0, _mm_shuffle_ps(length, length, _MM_SHUFFLE(1,0,0,0)));
+			r1= _mm_div_ps(r1, _mm_shuffle_ps(length, length, _MM_SHUFFLE(2,2,1,1)));
+			r2= _mm_div_ps(r2, _mm_shuffle_ps(length, length, _MM_SHUFFLE(3,3,3,2)));
+		}
+
+		_mm_storeu_ps(d, r0);
+		_mm_storeu_ps(d + 4, r1);
+		_mm_storeu_ps(d + 8, r2);
+	}
+
+	for(; j < count; ++j) {
+		dest[j]= prev[j].lerp(t, next[j]);
+		if(normalize == true) {
+			dest[j].normalize();
+		}
+	}
+}
+
+#endif
+
+void InterpolationData::lerpFrames(const Vec3f *prev, const Vec3f *next, Vec3f *dest,
+									uint32 count, float t, bool normalize, bool useSimd) {
+#ifdef INTERPOLATION_SSE2
+	if(useSimd == true) {
+		lerpFramesSse2(prev, next, dest, count, t, normalize);
+		return;
+	}
+#endif
+
+	for(uint32 j = 0; j < count; ++j) {
+		dest[j]= prev[j].lerp(t, next[j]);
+		if(normalize == true) {
+			dest[j].normalize();
+		}
+	}
+}
+
+bool InterpolationData::isSimdSupported() {
+#ifdef INTERPOLATION_SSE2
+	return true;
+#else
+	return false;
+#endif
+}
+
 }}//end namespace 
@@ -21,6 +21,7 @@
 #include "platform_common.h"
 #include "opengl.h"
 #include "platform_util.h"
+#include "mapped_file.h"
 //#include <memory>
 #include <map>
 #include <vector>
@@ -195,6 +196,51 @@ void fromEndianMeshHeaderV2(MeshHeaderV2 &header) {
 	}
 }
 
+// =====================================================
+//	class G3dFileReader
+//
+///	Cursor over a g3d file held in memory
+// =====================================================
+
+class G3dFileReader {
+private:
+	MappedFile *file;
+	int64 offset;
+
+public:
+	G3dFileReader(MappedFile *file) {
+		this->file= file;
+		this->offset= 0;
+	}
+
+	MappedFile *getFile() const	{return file;}
+	int64 getOffset() const		{return offset;}
+	int64 getRemaining() const	{return file->getSize() - offset;}
+
+	bool read(void *dest, uint64 bytes) {
+		uint8 *source= reference(bytes);
+		if(source == NULL) {
+			return false;
+		}
+		memcpy(dest, source, (size_t)bytes);
+		return true;
+	}
+
+	// Returns the data in place and moves past it, NULL if the file is too short
+	uint8 *reference(uint64 bytes) {
+		if(bytes > (uint64)getRemaining()) {
+			return NULL;
+		}
+		uint8 *result= file->getData() + offset;
+		offset += bytes;
+		return result;
+	}
+
+	bool skip(uint64 bytes) {
+		return reference(bytes) != NULL;
+	}
+};
+
 // =====================================================
 //	class Mesh
 // =====================================================
@@ -215,6 +261,7 @@ Mesh::Mesh() {
 	texCoords= NULL;
 	tangents= NULL;
 	indices= NULL;
+	fileMap= NULL;
 	interpolationData= NULL;
 
 	for(int i=0; i<meshTextureCount; ++i){
@@ -241,54 +288,16 @@ Mesh::~Mesh() {
 	end();
 }
 
-void Mesh::init() {
-	try {
-		vertices= new Vec3f[frameCount*vertexCount];
-	}
-	catch(bad_alloc& ba) {
-		char szBuf[8096]="";
-		snprintf(szBuf,8096,"Error on line: %d size: %d msg: %s\n",__LINE__,(frameCount*vertexCount),ba.what());
-		throw megaglest_runtime_error(szBuf);
-	}
-	try {
-		normals= new Vec3f[frameCount*vertexCount];
-	}
-	catch(bad_alloc& ba) {
-		char szBuf[8096]="";
-		snprintf(szBuf,8096,"Error on line: %d size: %d msg: %s\n",__LINE__,(frameCount*vertexCount),ba.what());
-		throw megaglest_runtime_error(szBuf);
-	}
-	try {
-		texCoords= new Vec2f[vertexCount];
-	}
-	catch(bad_alloc& ba) {
-		char szBuf[8096]="";
-		snprintf(szBuf,8096,"Error on line: %d size: %d msg: %s\n",__LINE__,vertexCount,ba.what());
-		throw megaglest_runtime_error(szBuf);
-	}
-	try {
-		indices= new uint32[indexCount];
-	}
-	catch(bad_alloc& ba) {
-		char szBuf[8096]="";
-		snprintf(szBuf,8096,"Error on line: %d size: %d msg: %s\n",__LINE__,indexCount,ba.what());
-		throw megaglest_runtime_error(szBuf);
-	}
-}
-
 void Mesh::end() {
 	ReleaseVBOs();
 
-	delete [] vertices;
-	vertices=NULL;
-	delete [] normals;
-	normals=NULL;
-	delete [] texCoords;
-	texCoords=NULL;
+	deleteMeshData(vertices);
+	deleteMeshData(normals);
+	deleteMeshData(texCoords);
 	delete [] tangents;
 	tangents=NULL;
-	delete [] indices;
-	indices=NULL;
+	deleteMeshData(indices);
+	releaseFileMap();
 
 	cleanupInterpolationData();
 
@@ -304,6 +313,55 @@ void Mesh::end() {
 	textureManager = NULL;
 }
 
+// Points into the mapped file when the block is suitably aligned,
+// otherwise copies it out in one go
+template<typename T>
+T *Mesh::loadMeshData(G3dFileReader &reader, uint32 frames, uint32 count, int line) {
+	uint64 elementCount= (uint64)frames * count;
+	uint8 *source= reader.reference(sizeof(T) * elementCount);
+	if(source == NULL) {
+		char szBuf[8096]="";
+		snprintf(szBuf,8096,"g3d file too short for data block [%u][%u] at offset %lld on line: %d.",frames,count,(long long)reader.getOffset(),line);
+		throw megaglest_runtime_error(szBuf);
+	}
+
+	if(elementCount > 0 && reader.getFile()->isMapped() == true &&
+		((size_t)source % sizeof(float32)) == 0) {
+		if(fileMap == NULL) {
+			fileMap= reader.getFile();
+			fileMap->addRef();
+		}
+		return reinterpret_cast<T *>(source);
+	}
+
+	T *result= NULL;
+	try {
+		result= new T[elementCount];
+	}
+	catch(bad_alloc& ba) {
+		char szBuf[8096]="";
+		snprintf(szBuf,8096,"Error on line: %d size: %u msg: %s\n",line,(uint32)elementCount,ba.what());
+		throw megaglest_runtime_error(szBuf);
+	}
+	memcpy(result, source, sizeof(T) * (size_t)elementCount);
+	return result;
+}
+
+template<typename T>
+void Mesh::deleteMeshData(T *&data) {
+	if(fileMap == NULL || fileMap->contains(data) == false) {
+		delete [] data;
+	}
+	data= NULL;
+}
+
+void Mesh::releaseFileMap() {
+	if(fileMap != NULL) {
+		fileMap->release();
+		fileMap= NULL;
+	}
+}
+
 // ========================== shadows & interpolation =========================
 
 void Mesh::buildInterpolationData(){
@@ -364,10 +422,11 @@ void Mesh::BuildVBOs() {
 			glBindBufferARB(GL_ELEMENT_ARRAY_BUFFER_ARB, 0);
 
 			// Our Copy Of The Data Is No Longer Necessary, It Is Safe In The Graphics Card
-			delete [] vertices; vertices = NULL;
-			delete [] texCoords; texCoords = NULL;
-			delete [] normals; normals = NULL;
-			delete [] indices; indices = NULL;
+			deleteMeshData(vertices);
+			deleteMeshData(texCoords);
+			deleteMeshData(normals);
+			deleteMeshData(indices);
+			releaseFileMap();
 
 			delete interpolationData;
 			interpolationData = NULL;
@@ -409,16 +468,15 @@ string Mesh::findAlternateTexture(vector<string> conversionList, string textureF
 	return result;
 }
 
-void Mesh::loadV2(int meshIndex, const string &dir, FILE *f, TextureManager *textureManager,
+void Mesh::loadV2(int meshIndex, const string &dir, G3dFileReader &reader, TextureManager *textureManager,
 		bool deletePixMapAfterLoad, std::map<string,vector<pair<string, string> > > *loadedFileList,
 		string sourceLoader,string modelFile) {
 	this->textureManager = textureManager;
 	//read header
 	MeshHeaderV2 meshHeader;
-	size_t readBytes = fread(&meshHeader, sizeof(MeshHeaderV2), 1, f);
-	if(readBytes != 1) {
+	if(reader.read(&meshHeader, sizeof(MeshHeaderV2)) == false) {
 		char szBuf[8096]="";
-		snprintf(szBuf,8096,"fread returned wrong size = " MG_SIZE_T_SPECIFIER " on line: %d.",readBytes,__LINE__);
+		snprintf(szBuf,8096,"g3d file too short for mesh header at offset %lld on line: %d.",(long long)reader.getOffset(),__LINE__);
 		throw megaglest_runtime_error(szBuf);
 	}
 	fromEndianMeshHeaderV2(meshHeader);
@@ -441,8 +499,6 @@ void Mesh::loadV2(int meshIndex, const string &dir, FILE *f, TextureManager *tex
 	indexCount= meshHeader.indexCount;
 	texCoordFrameCount = meshHeader.texCoordFrameCount;
 
-	init();
-
 	//misc
 	twoSided= false;
 	customColor= false;
@@ -498,63 +554,43 @@ void Mesh::loadV2(int meshIndex, const string &dir, FILE *f, TextureManager *tex
 	}
 
 	//read data
-	readBytes = fread(vertices, sizeof(Vec3f)*frameCount*vertexCount, 1, f);
-	if(readBytes != 1 && (frameCount * vertexCount) != 0) {
-		char szBuf[8096]="";
-		snprintf(szBuf,8096,"fread returned wrong size = " MG_SIZE_T_SPECIFIER " [%u][%u] on line: %d.",readBytes,frameCount,vertexCount,__LINE__);
-		throw megaglest_runtime_error(szBuf);
-	}
+	vertices= loadMeshData<Vec3f>(reader, frameCount, vertexCount, __LINE__);
 	fromEndianVecArray<Vec3f>(vertices, frameCount*vertexCount);
 
-	readBytes = fread(normals, sizeof(Vec3f)*frameCount*vertexCount, 1, f);
-	if(readBytes != 1 && (frameCount * vertexCount) != 0) {
-		char szBuf[8096]="";
-		snprintf(szBuf,8096,"fread returned wrong size = " MG_SIZE_T_SPECIFIER " [%u][%u] on line: %d.",readBytes,frameCount,vertexCount,__LINE__);
-		throw megaglest_runtime_error(szBuf);
-	}
+	normals= loadMeshData<Vec3f>(reader, frameCount, vertexCount, __LINE__);
 	fromEndianVecArray<Vec3f>(normals, frameCount*vertexCount);
 
 	if(textureFlags & (1<<mtDiffuse)) {
-		readBytes = fread(texCoords, sizeof(Vec2f)*vertexCount, 1, f);
-		if(readBytes != 1 && vertexCount != 0) {
-			char szBuf[8096]="";
-			snprintf(szBuf,8096,"fread returned wrong size = " MG_SIZE_T_SPECIFIER " [%u][%u] on line: %d.",readBytes,frameCount,vertexCount,__LINE__);
-			throw megaglest_runtime_error(szBuf);
-		}
+		texCoords= loadMeshData<Vec2f>(reader, 1, vertexCount, __LINE__);
 		fromEndianVecArray<Vec2f>(texCoords, vertexCount);
 	}
-	readBytes = fread(&diffuseColor, sizeof(Vec3f), 1, f);
-	if(readBytes != 1) {
+	else {
+		texCoords= new Vec2f[vertexCount];
+	}
+	if(reader.read(&diffuseColor, sizeof(Vec3f)) == false) {
 		char szBuf[8096]="";
-		snprintf(szBuf,8096,"fread returned wrong size = " MG_SIZE_T_SPECIFIER " on line: %d.",readBytes,__LINE__);
+		snprintf(szBuf,8096,"g3d file too short for diffuse color at offset %lld on line: %d.",(long long)reader.getOffset(),__LINE__);
 		throw megaglest_runtime_error(szBuf);
 	}
 	fromEndianVecArray<Vec3f>(&diffuseColor, 1);
 
-	readBytes = fread(&opacity, sizeof(float32), 1, f);
-	if(readBytes != 1) {
+	if(reader.read(&opacity, sizeof(float32)) == false) {
 		char szBuf[8096]="";
-		snprintf(szBuf,8096,"fread returned wrong size = " MG_SIZE_T_SPECIFIER " on line: %d.",readBytes,__LINE__);
+		snprintf(szBuf,8096,"g3d file too short for opacity at offset %lld on line: %d.",(long long)reader.getOffset(),__LINE__);
 		throw megaglest_runtime_error(szBuf);
 	}
 	opacity = Shared::PlatformByteOrder::fromCommonEndian(opacity);
 
-	int seek_result = fseek(f, sizeof(Vec4f)*(meshHeader.colorFrameCount-1), SEEK_CUR);
-	if(seek_result != 0) {
+	if(reader.skip(sizeof(Vec4f)*((uint64)meshHeader.colorFrameCount-1)) == false) {
 		char szBuf[8096]="";
-		snprintf(szBuf,8096,"fseek returned failure = %d [%u] on line: %d.",seek_result,indexCount,__LINE__);
-		throw megaglest_runtime_error(szBuf);
-	}
-	readBytes = fread(indices, sizeof(uint32)*indexCount, 1, f);
-	if(readBytes != 1 && indexCount != 0) {
-		char szBuf[8096]="";
-		snprintf(szBuf,8096,"fread returned wrong size = " MG_SIZE_T_SPECIFIER " [%u] on line: %d.",readBytes,indexCount,__LINE__);
+		snprintf(szBuf,8096,"g3d file too short for color frames [%u] at offset %lld on line: %d.",meshHeader.colorFrameCount,(long long)reader.getOffset(),__LINE__);
 		throw megaglest_runtime_error(szBuf);
 	}
+	indices= loadMeshData<uint32>(reader, 1, indexCount, __LINE__);
 	Shared::PlatformByteOrder::fromEndianTypeArray<uint32>(indices, indexCount);
 }
 
-void Mesh::loadV3(int meshIndex, const string &dir, FILE *f,
+void Mesh::loadV3(int meshIndex, const string &dir, G3dFileReader &reader,
 		TextureManager *textureManager,bool deletePixMapAfterLoad,
 		std::map<string,vector<pair<string, string> > > *loadedFileList,
 		string sourceLoader,string modelFile) {
@@ -562,10 +598,9 @@ void Mesh::loadV3(int meshIndex, const string &dir, FILE *f,
 
 	//read header
 	MeshHeaderV3 meshHeader;
-	size_t readBytes = fread(&meshHeader, sizeof(MeshHeaderV3), 1, f);
-	if(readBytes != 1) {
+	if(reader.read(&meshHeader, sizeof(MeshHeaderV3)) == false) {
 		char szBuf[8096]="";
-		snprintf(szBuf,8096,"fread returned wrong size = " MG_SIZE_T_SPECIFIER " on line: %d.",readBytes,__LINE__);
+		snprintf(szBuf,8096,"g3d file too short for mesh header at offset %lld on line: %d.",(long long)reader.getOffset(),__LINE__);
 		throw megaglest_runtime_error(szBuf);
 	}
 	fromEndianMeshHeaderV3(meshHeader);
@@ -582,8 +617,6 @@ void Mesh::loadV3(int meshIndex, const string &dir, FILE *f,
 	indexCount= meshHeader.indexCount;
 	texCoordFrameCount = meshHeader.texCoordFrameCount;
 
-	init();
-
 	//misc
 	twoSided= (meshHeader.properties & mp3TwoSided) != 0;
 	customColor= (meshHeader.properties & mp3CustomColor) != 0;
@@ -642,62 +675,46 @@ void Mesh::loadV3(int meshIndex, const string &dir, FILE *f,
 	}
 
 	//read data
-	readBytes = fread(vertices, sizeof(Vec3f)*frameCount*vertexCount, 1, f);
-	if(readBytes != 1 && (frameCount * vertexCount) != 0) {
-		char szBuf[8096]="";
-		snprintf(szBuf,8096,"fread returned wrong size = " MG_SIZE_T_SPECIFIER " [%u][%u] on line: %d.",readBytes,frameCount,vertexCount,__LINE__);
-		throw megaglest_runtime_error(szBuf);
-	}
+	vertices= loadMeshData<Vec3f>(reader, frameCount, vertexCount, __LINE__);
 	fromEndianVecArray<Vec3f>(vertices, frameCount*vertexCount);
 
-	readBytes = fread(normals, sizeof(Vec3f)*frameCount*vertexCount, 1, f);
-	if(readBytes != 1 && (frameCount * vertexCount) != 0) {
-		char szBuf[8096]="";
-		snprintf(szBuf,8096,"fread returned wrong size = " MG_SIZE_T_SPECIFIER " [%u][%u] on line: %d.",readBytes,frameCount,vertexCount,__LINE__);
-		throw megaglest_runtime_error(szBuf);
-	}
+	normals= loadMeshData<Vec3f>(reader, frameCount, vertexCount, __LINE__);
 	fromEndianVecArray<Vec3f>(normals, frameCount*vertexCount);
 
-	if(textureFlags & (1<<mtDiffuse)) {
-		for(unsigned int i=0; i<meshHeader.texCoordFrameCount; ++i){
-			readBytes = fread(texCoords, sizeof(Vec2f)*vertexCount, 1, f);
-			if(readBytes != 1 && vertexCount != 0) {
-				char szBuf[8096]="";
-				snprintf(szBuf,8096,"fread returned wrong size = " MG_SIZE_T_SPECIFIER " [%u][%u] on line: %d.",readBytes,frameCount,vertexCount,__LINE__);
-				throw megaglest_runtime_error(szBuf);
-			}
-			fromEndianVecArray<Vec2f>(texCoords, vertexCount);
+	if((textureFlags & (1<<mtDiffuse)) && meshHeader.texCoordFrameCount > 0) {
+		// only the last texture coordinate frame is used
+		if(reader.skip(sizeof(Vec2f)*(uint64)vertexCount*(meshHeader.texCoordFrameCount-1)) == false) {
+			char szBuf[8096]="";
+			snprintf(szBuf,8096,"g3d file too short for texture coord frames [%u][%u] at offset %lld on line: %d.",meshHeader.texCoordFrameCount,vertexCount,(long long)reader.getOffset(),__LINE__);
+			throw megaglest_runtime_error(szBuf);
 		}
+		texCoords= loadMeshData<Vec2f>(reader, 1, vertexCount, __LINE__);
+		fromEndianVecArray<Vec2f>(texCoords, vertexCount);
+	}
+	else {
+		texCoords= new Vec2f[vertexCount];
 	}
-	readBytes = fread(&diffuseColor, sizeof(Vec3f), 1, f);
-	if(readBytes != 1) {
+	if(reader.read(&diffuseColor, sizeof(Vec3f)) == false) {
 		char szBuf[8096]="";
-		snprintf(szBuf,8096,"fread returned wrong size = " MG_SIZE_T_SPECIFIER " on line: %d.",readBytes,__LINE__);
+		snprintf(szBuf,8096,"g3d file too short for diffuse color at offset %lld on line: %d.",(long long)reader.getOffset(),__LINE__);
 		throw megaglest_runtime_error(szBuf);
 	}
 	fromEndianVecArray<Vec3f>(&diffuseColor, 1);
 
-	readBytes = fread(&opacity, sizeof(float32), 1, f);
-	if(readBytes != 1) {
+	if(reader.read(&opacity, sizeof(float32)) == false) {
 		char szBuf[8096]="";
-		snprintf(szBuf,8096,"fread returned wrong size = " MG_SIZE_T_SPECIFIER " on line: %d.",readBytes,__LINE__);
+		snprintf(szBuf,8096,"g3d file too short for opacity at offset %lld on line: %d.",(long long)reader.getOffset(),__LINE__);
 		throw megaglest_runtime_error(szBuf);
 	}
 	opacity = Shared::PlatformByteOrder::fromCommonEndian(opacity);
 
-	int seek_result = fseek(f, sizeof(Vec4f)*(meshHeader.colorFrameCount-1), SEEK_CUR);
-	if(seek_result != 0) {
+	if(reader.skip(sizeof(Vec4f)*((uint64)meshHeader.colorFrameCount-1)) == false) {
 		char szBuf[8096]="";
-		snprintf(szBuf,8096,"fseek returned failure = %d [%u] on line: %d.",seek_result,indexCount,__LINE__);
+		snprintf(szBuf,8096,"g3d file too short for color frames [%u] at offset %lld on line: %d.",meshHeader.colorFrameCount,(long long)reader.getOffset(),__LINE__);
 		throw megaglest_runtime_error(szBuf);
 	}
 
-	readBytes = fread(indices, sizeof(uint32)*indexCount, 1, f);
-	if(readBytes != 1 && indexCount != 0) {
-		char szBuf[8096]="";
-		snprintf(szBuf,8096,"fread returned wrong size = " MG_SIZE_T_SPECIFIER " [%u] on line: %d.",readBytes,indexCount,__LINE__);
-		throw megaglest_runtime_error(szBuf);
-	}
+	indices= loadMeshData<uint32>(reader, 1, indexCount, __LINE__);
 	Shared::PlatformByteOrder::fromEndianTypeArray<uint32>(indices, indexCount);
 }
 
@@ -754,17 +771,16 @@ Texture2D* Mesh::loadMeshTexture(int meshIndex, int textureIndex,
 	return texture;
 }
 
-void Mesh::load(int meshIndex, const string &dir, FILE *f, TextureManager *textureManager,
+void Mesh::load(int meshIndex, const string &dir, G3dFileReader &reader, TextureManager *textureManager,
 				bool deletePixMapAfterLoad,std::map<string,vector<pair<string, string> > > *loadedFileList,
 				string sourceLoader,string modelFile) {
 	this->textureManager = textureManager;
 	
 	//read header
 	MeshHeader meshHeader;
-	size_t readBytes = fread(&meshHeader, sizeof(MeshHeader), 1, f);
-	if(readBytes != 1) {
+	if(reader.read(&meshHeader, sizeof(MeshHeader)) == false) {
 		char szBuf[8096]="";
-		snprintf(szBuf,8096,"fread returned wrong size = " MG_SIZE_T_SPECIFIER " on line: %d.",readBytes,__LINE__);
+		snprintf(szBuf,8096,"g3d file too short for mesh header at offset %lld on line: %d.",(long long)reader.getOffset(),__LINE__);
 		throw megaglest_runtime_error(szBuf);
 	}
 	fromEndianMeshHeader(meshHeader);
@@ -778,8 +794,6 @@ void Mesh::load(int meshIndex, const string &dir, FILE *f, TextureManager *textu
 	vertexCount= meshHeader.vertexCount;
 	indexCount= meshHeader.indexCount;
 
-	init();
-
 	//properties
 	customColor= (meshHeader.properties & mpfCustomColor) != 0;
 	twoSided= (meshHeader.properties & mpfTwoSided) != 0;
@@ -806,13 +820,12 @@ void Mesh::load(int meshIndex, const string &dir, FILE *f, TextureManager *textu
 		if(meshHeader.textures & flag) {
 			uint8 cMapPath[mapPathSize+1];
 			memset(&cMapPath[0],0,mapPathSize+1);
-			readBytes = fread(cMapPath, mapPathSize, 1, f);
-			cMapPath[mapPathSize] = 0;
-			if(readBytes != 1 && mapPathSize != 0) {
+			if(reader.read(cMapPath, mapPathSize) == false) {
 				char szBuf[8096]="";
-				snprintf(szBuf,8096,"fread returned wrong size = " MG_SIZE_T_SPECIFIER " [%u] on line: %d.",readBytes,mapPathSize,__LINE__);
+				snprintf(szBuf,8096,"g3d file too short for texture path [%u] at offset %lld on line: %d.",mapPathSize,(long long)reader.getOffset(),__LINE__);
 				throw megaglest_runtime_error(szBuf);
 			}
+			cMapPath[mapPathSize] = 0;
 			Shared::PlatformByteOrder::fromEndianTypeArray<uint8>(cMapPath, mapPathSize);
 
 			char mapPathString[mapPathSize+1]="";
@@ -846,37 +859,20 @@ void Mesh::load(int meshIndex, const string &dir, FILE *f, TextureManager *textu
 	}
 
 	//read data
-	readBytes = fread(vertices, sizeof(Vec3f)*frameCount*vertexCount, 1, f);
-	if(readBytes != 1 && (frameCount * vertexCount) != 0) {
-		char szBuf[8096]="";
-		snprintf(szBuf,8096,"fread returned wrong size = " MG_SIZE_T_SPECIFIER " [%u][%u] on line: %d.",readBytes,frameCount,vertexCount,__LINE__);
-		throw megaglest_runtime_error(szBuf);
-	}
+	vertices= loadMeshData<Vec3f>(reader, frameCount, vertexCount, __LINE__);
 	fromEndianVecArray<Vec3f>(vertices, frameCount*vertexCount);
 
-	readBytes = fread(normals, sizeof(Vec3f)*frameCount*vertexCount, 1, f);
-	if(readBytes != 1 && (frameCount * vertexCount) != 0) {
-		char szBuf[8096]="";
-		snprintf(szBuf,8096,"fread returned wrong size = " MG_SIZE_T_SPECIFIER " [%u][%u] on line: %d.",readBytes,frameCount,vertexCount,__LINE__);
-		throw megaglest_runtime_error(szBuf);
-	}
+	normals= loadMeshData<Vec3f>(reader, frameCount, vertexCount, __LINE__);
 	fromEndianVecArray<Vec3f>(normals, frameCount*vertexCount);
 
 	if(meshHeader.textures!=0){
-		readBytes = fread(texCoords, sizeof(Vec2f)*vertexCount, 1, f);
-		if(readBytes != 1 && vertexCount != 0) {
-			char szBuf[8096]="";
-			snprintf(szBuf,8096,"fread returned wrong size = " MG_SIZE_T_SPECIFIER " [%u][%u] on line: %d.",readBytes,frameCount,vertexCount,__LINE__);
-			throw megaglest_runtime_error(szBuf);
-		}
+		texCoords= loadMeshData<Vec2f>(reader, 1, vertexCount, __LINE__);
 		fromEndianVecArray<Vec2f>(texCoords, vertexCount);
 	}
-	readBytes = fread(indices, sizeof(uint32)*indexCount, 1, f);
-	if(readBytes != 1 && indexCount != 0) {
-		char szBuf[8096]="";
-		snprintf(szBuf,8096,"fread returned wrong size = " MG_SIZE_T_SPECIFIER " [%u] on line: %d.",readBytes,indexCount,__LINE__);
-		throw megaglest_runtime_error(szBuf);
+	else {
+		texCoords= new Vec2f[vertexCount];
 	}
+	indices= loadMeshData<uint32>(reader, 1, indexCount, __LINE__);
 	Shared::PlatformByteOrder::fromEndianTypeArray<uint32>(indices, indexCount);
 
 	//tangents
@@ -1203,156 +1199,139 @@ void Model::loadG3d(const string &path, bool deletePixMapAfterLoad,
 		string sourceLoader) {
 
     try{
-#ifdef WIN32
-		FILE *f= _wfopen(utf8_decode(path).c_str(), L"rb");
-#else
-		FILE *f=fopen(path.c_str(),"rb");
-#endif
-		if (f == NULL) {
+		// Mapped rather than read, meshes may keep pointing into it
+		MappedFile *file= MappedFile::open(path);
+		if (file == NULL) {
 		    printf("In [%s::%s] cannot load file = [%s]\n",extractFileFromDirectoryPath(__FILE__).c_str(),__FUNCTION__,path.c_str());
 			throw megaglest_runtime_error("Error opening g3d model file [" + path + "]",true);
 		}
 
-		if(loadedFileList) {
-			(*loadedFileList)[path].push_back(make_pair(sourceLoader,sourceLoader));
+		try {
+			loadG3d(path, file, deletePixMapAfterLoad, loadedFileList, sourceLoader);
 		}
-
-		string dir= extractDirectoryPathFromFile(path);
-
-		//file header
-		FileHeader fileHeader;
-		size_t readBytes = fread(&fileHeader, sizeof(FileHeader), 1, f);
-		if(readBytes != 1) {
-			fclose(f);
-			char szBuf[8096]="";
-			snprintf(szBuf,8096,"fread returned wrong size = " MG_SIZE_T_SPECIFIER " on line: %d.",readBytes,__LINE__);
-			throw megaglest_runtime_error(szBuf);
+		catch(...) {
+			file->release();
+			throw;
 		}
-		fromEndianFileHeader(fileHeader);
+		file->release();
 
-		char fileId[4] = "";
-		memset(&fileId[0],0,4);
-		memcpy(&fileId[0],reinterpret_cast<char*>(fileHeader.id),3);
+		autoJoinMeshFrames();
+    }
+    catch(megaglest_runtime_error& ex) {
+    	//printf("1111111 ex.wantStackTrace() = %d\n",ex.wantStackTrace());
+		SystemFlags::OutputDebug(SystemFlags::debugError,"In [%s::%s Line: %d] Error [%s]\n",extractFileFromDirectoryPath(__FILE__).c_str(),__FUNCTION__,__LINE__,ex.what());
+		//printf("2222222\n");
+		throw megaglest_runtime_error("Exception caught loading 3d file: " + path +"\n"+ ex.what(),!ex.wantStackTrace());
+    }
+	catch(exception &e){
+		//abort();
+		SystemFlags::OutputDebug(SystemFlags::debugError,"In [%s::%s Line: %d] Error [%s]\n",extractFileFromDirectoryPath(__FILE__).c_str(),__FUNCTION__,__LINE__,e.what());
+		throw megaglest_runtime_error("Exception caught loading 3d file: " + path +"\n"+ e.what());
+	}
+}
 
-		if(strncmp(fileId, "G3D", 3) != 0) {
-			fclose(f);
-			f = NULL;
-		    printf("In [%s::%s] file = [%s] fileheader.id = [%s]\n",extractFileFromDirectoryPath(__FILE__).c_str(),__FUNCTION__,path.c_str(),fileId);
-			throw megaglest_runtime_error("Not a valid G3D model",true);
-		}
-		fileVersion= fileHeader.version;
+void Model::loadG3d(const string &path, MappedFile *file, bool deletePixMapAfterLoad,
+		std::map<string,vector<pair<string, string> > > *loadedFileList,
+		string sourceLoader) {
 
-		if(SystemFlags::VERBOSE_MODE_ENABLED) printf("Load model, fileVersion = %d\n",fileVersion);
+	if(loadedFileList) {
+		(*loadedFileList)[path].push_back(make_pair(sourceLoader,sourceLoader));
+	}
 
-		//version 4
-		if(fileHeader.version == 4) {
-			//model header
-			ModelHeader modelHeader;
-			readBytes = fread(&modelHeader, sizeof(ModelHeader), 1, f);
-			if(readBytes != 1) {
-				char szBuf[8096]="";
-				snprintf(szBuf,8096,"fread returned wrong size = " MG_SIZE_T_SPECIFIER " on line: %d.",readBytes,__LINE__);
-				throw megaglest_runtime_error(szBuf);
-			}
-			fromEndianModelHeader(modelHeader);
+	string dir= extractDirectoryPathFromFile(path);
+	G3dFileReader reader(file);
 
-			meshCount= modelHeader.meshCount;
+	//file header
+	FileHeader fileHeader;
+	if(reader.read(&fileHeader, sizeof(FileHeader)) == false) {
+		char szBuf[8096]="";
+		snprintf(szBuf,8096,"g3d file too short for file header [%lld] on line: %d.",(long long)file->getSize(),__LINE__);
+		throw megaglest_runtime_error(szBuf);
+	}
+	fromEndianFileHeader(fileHeader);
 
-			if(SystemFlags::VERBOSE_MODE_ENABLED) printf("meshCount = %d\n",meshCount);
+	char fileId[4] = "";
+	memset(&fileId[0],0,4);
+	memcpy(&fileId[0],reinterpret_cast<char*>(fileHeader.id),3);
 
-			if(modelHeader.type != mtMorphMesh) {
-				throw megaglest_runtime_error("Invalid model type");
-			}
+	if(strncmp(fileId, "G3D", 3) != 0) {
+	    printf("In [%s::%s] file = [%s] fileheader.id = [%s]\n",extractFileFromDirectoryPath(__FILE__).c_str(),__FUNCTION__,path.c_str(),fileId);
+		throw megaglest_runtime_error("Not a valid G3D model",true);
+	}
+	fileVersion= fileHeader.version;
 
-			//load meshes
-			try {
-				meshes= new Mesh[meshCount];
-			}
-			catch(bad_alloc& ba) {
-				char szBuf[8096]="";
-				snprintf(szBuf,8096,"Error on line: %d size: %d msg: %s\n",__LINE__,meshCount,ba.what());
-				throw megaglest_runtime_error(szBuf);
-			}
+	if(SystemFlags::VERBOSE_MODE_ENABLED) printf("Load model, fileVersion = %d\n",fileVersion);
 
-			for(uint32 i = 0; i < meshCount; ++i) {
-				meshes[i].load(i, dir, f, textureManager,deletePixMapAfterLoad,
-						loadedFileList,sourceLoader,path);
-				meshes[i].buildInterpolationData();
-			}
+	uint64 meshHeaderSize= 0;
+	//version 4
+	if(fileHeader.version == 4) {
+		//model header
+		ModelHeader modelHeader;
+		if(reader.read(&modelHeader, sizeof(ModelHeader)) == false) {
+			char szBuf[8096]="";
+			snprintf(szBuf,8096,"g3d file too short for model header [%lld] on line: %d.",(long long)file->getSize(),__LINE__);
+			throw megaglest_runtime_error(szBuf);
 		}
-		//version 3
-		else if(fileHeader.version == 3) {
-			readBytes = fread(&meshCount, sizeof(meshCount), 1, f);
-			if(readBytes != 1 && meshCount != 0) {
-				char szBuf[8096]="";
-				snprintf(szBuf,8096,"fread returned wrong size = " MG_SIZE_T_SPECIFIER " [%u] on line: %d.",readBytes,meshCount,__LINE__);
-				throw megaglest_runtime_error(szBuf);
-			}
-			meshCount = Shared::PlatformByteOrder::fromCommonEndian(meshCount);
+		fromEndianModelHeader(modelHeader);
 
-			if(SystemFlags::VERBOSE_MODE_ENABLED) printf("meshCount = %u\n",meshCount);
+		meshCount= modelHeader.meshCount;
 
-			try {
-				meshes= new Mesh[meshCount];
-			}
-			catch(bad_alloc& ba) {
-				char szBuf[8096]="";
-				snprintf(szBuf,8096,"Error on line: %d size: %d msg: %s\n",__LINE__,meshCount,ba.what());
-				throw megaglest_runtime_error(szBuf);
-			}
+		if(SystemFlags::VERBOSE_MODE_ENABLED) printf("meshCount = %d\n",meshCount);
 
-			for(uint32 i = 0; i < meshCount; ++i) {
-				meshes[i].loadV3(i, dir, f, textureManager,deletePixMapAfterLoad,
-						loadedFileList,sourceLoader,path);
-				meshes[i].buildInterpolationData();
-			}
+		if(modelHeader.type != mtMorphMesh) {
+			throw megaglest_runtime_error("Invalid model type");
 		}
-		//version 2
-		else if(fileHeader.version == 2) {
-			readBytes = fread(&meshCount, sizeof(meshCount), 1, f);
-			if(readBytes != 1 && meshCount != 0) {
-				char szBuf[8096]="";
-				snprintf(szBuf,8096,"fread returned wrong size = " MG_SIZE_T_SPECIFIER " [%u] on line: %d.",readBytes,meshCount,__LINE__);
-				throw megaglest_runtime_error(szBuf);
-			}
-			meshCount = Shared::PlatformByteOrder::fromCommonEndian(meshCount);
+		meshHeaderSize= sizeof(MeshHeader);
+	}
+	//version 3 and 2
+	else if(fileHeader.version == 3 || fileHeader.version == 2) {
+		if(reader.read(&meshCount, sizeof(meshCount)) == false) {
+			char szBuf[8096]="";
+			snprintf(szBuf,8096,"g3d file too short for mesh count [%lld] on line: %d.",(long long)file->getSize(),__LINE__);
+			throw megaglest_runtime_error(szBuf);
+		}
+		meshCount = Shared::PlatformByteOrder::fromCommonEndian(meshCount);
 
+		if(SystemFlags::VERBOSE_MODE_ENABLED) printf("meshCount = %u\n",meshCount);
 
-			if(SystemFlags::VERBOSE_MODE_ENABLED) printf("meshCount = %d\n",meshCount);
+		meshHeaderSize= (fileHeader.version == 3 ? sizeof(MeshHeaderV3) : sizeof(MeshHeaderV2));
+	}
+	else {
+		throw megaglest_runtime_error("Invalid model version: "+ intToStr(fileHeader.version));
+	}
 
-			try {
-				meshes= new Mesh[meshCount];
-			}
-			catch(bad_alloc& ba) {
-				char szBuf[8096]="";
-				snprintf(szBuf,8096,"Error on line: %d size: %d msg: %s\n",__LINE__,meshCount,ba.what());
-				throw megaglest_runtime_error(szBuf);
-			}
+	// every mesh starts with a header, so a broken count fails here
+	// instead of allocating the meshes
+	if(meshHeaderSize * meshCount > (uint64)reader.getRemaining()) {
+		char szBuf[8096]="";
+		snprintf(szBuf,8096,"g3d file too short for %u meshes [%lld] on line: %d.",meshCount,(long long)file->getSize(),__LINE__);
+		throw megaglest_runtime_error(szBuf);
+	}
 
-			for(uint32 i = 0; i < meshCount; ++i){
-				meshes[i].loadV2(i,dir, f, textureManager,deletePixMapAfterLoad,
-						loadedFileList,sourceLoader,path);
-				meshes[i].buildInterpolationData();
-			}
+	//load meshes
+	try {
+		meshes= new Mesh[meshCount];
+	}
+	catch(bad_alloc& ba) {
+		char szBuf[8096]="";
+		snprintf(szBuf,8096,"Error on line: %d size: %d msg: %s\n",__LINE__,meshCount,ba.what());
+		throw megaglest_runtime_error(szBuf);
+	}
+
+	for(uint32 i = 0; i < meshCount; ++i) {
+		if(fileHeader.version == 4) {
+			meshes[i].load(i, dir, reader, textureManager,deletePixMapAfterLoad,
+					loadedFileList,sourceLoader,path);
+		}
+		else if(fileHeader.version == 3) {
+			meshes[i].loadV3(i, dir, reader, textureManager,deletePixMapAfterLoad,
+					loadedFileList,sourceLoader,path);
 		}
 		else {
-			throw megaglest_runtime_error("Invalid model version: "+ intToStr(fileHeader.version));
+			meshes[i].loadV2(i,dir, reader, textureManager,deletePixMapAfterLoad,
+					loadedFileList,sourceLoader,path);
 		}
-
-		fclose(f);
-
-		autoJoinMeshFrames();
-    }
-    catch(megaglest_runtime_error& ex) {
-    	//printf("1111111 ex.wantStackTrace() = %d\n",ex.wantStackTrace());
-		SystemFlags::OutputDebug(SystemFlags::debugError,"In [%s::%s Line: %d] Error [%s]\n",extractFileFromDirectoryPath(__FILE__).c_str(),__FUNCTION__,__LINE__,ex.what());
-		//printf("2222222\n");
-		throw megaglest_runtime_error("Exception caught loading 3d file: " + path +"\n"+ ex.what(),!ex.wantStackTrace());
-    }
-	catch(exception &e){
-		//abort();
-		SystemFlags::OutputDebug(SystemFlags::debugError,"In [%s::%s Line: %d] Error [%s]\n",extractFileFromDirectoryPath(__FILE__).c_str(),__FUNCTION__,__LINE__,e.what());
-		throw megaglest_runtime_error("Exception caught loading 3d file: " + path +"\n"+ e.what());
+		meshes[i].buildInterpolationData();
 	}
 }
 
@@ -1447,27 +1426,27 @@ public:
 };
 
 void Mesh::setVertices(Vec3f *data, uint32 count) {
-	delete [] this->vertices;
+	deleteMeshData(this->vertices);
 	this->vertices = data;
 
 	this->vertexCount = count;
 }
 void Mesh::setNormals(Vec3f *data, uint32 count) {
-	delete [] this->normals;
+	deleteMeshData(this->normals);
 	this->normals = data;
 
 	this->vertexCount = count;
 }
 
 void Mesh::setTexCoords(Vec2f *data, uint32 count) {
-	delete [] this->texCoords;
+	deleteMeshData(this->texCoords);
 	this->texCoords = data;
 
 	this->vertexCount = count;
 }
 
 void Mesh::setIndices(uint32 *data, uint32 count) {
-	delete [] this->indices;
+	deleteMeshData(this->indices);
 	this->indices = data;
 
 	this->indexCount = count;
@@ -1495,8 +1474,7 @@ void Mesh::copyInto(Mesh *dest, bool ignoreInterpolationData,
 
 	//vertex data
 	if(dest->vertices != NULL) {
-		delete [] dest->vertices;
-		dest->vertices = NULL;
+		dest->deleteMeshData(dest->vertices);
 	}
 	if(this->vertices != NULL) {
 		dest->vertices = new Vec3f[this->frameCount * this->vertexCount];
@@ -1504,8 +1482,7 @@ void Mesh::copyInto(Mesh *dest, bool ignoreInterpolationData,
 	}
 
 	if(dest->normals != NULL) {
-		delete [] dest->normals;
-		dest->normals = NULL;
+		dest->deleteMeshData(dest->normals);
 	}
 	if(this->normals != NULL) {
 		dest->normals = new Vec3f[this->frameCount * this->vertexCount];
@@ -1513,8 +1490,7 @@ void Mesh::copyInto(Mesh *dest, bool ignoreInterpolationData,
 	}
 
 	if(dest->texCoords != NULL) {
-		delete [] dest->texCoords;
-		dest->texCoords = NULL;
+		dest->deleteMeshData(dest->texCoords);
 	}
 	if(this->texCoords != NULL) {
 		dest->texCoords = new Vec2f[this->vertexCount];
@@ -1531,8 +1507,7 @@ void Mesh::copyInto(Mesh *dest, bool ignoreInterpolationData,
 	}
 
 	if(dest->indices != NULL) {
-		delete [] dest->indices;
-		dest->indices = NULL;
+		dest->deleteMeshData(dest->indices);
 	}
 	if(this->indices != NULL) {
 		dest->indices = new uint32[this->indexCount];
@@ -24,6 +24,7 @@
 #include "model.h"
 #include "texture.h"
 #include "platform_util.h"
+#include "task_pool.h"
 #include "leak_dumper.h"
 
 using namespace std;
@@ -38,6 +39,10 @@ namespace Graphics {
 // =====================================================
 
 const bool checkMemory = false;
+
+bool ParticleSystem::particleKernelsEnabled= true;
+bool ParticleManager::parallelUpdateEnabled= true;
+
 static map<void *,int> memoryObjectList;
 
 void Particle::saveGame(XmlNode *rootNode) {
@@ -136,6 +141,9 @@ ParticleSystem::ParticleSystem(int particleCount) {
 
 	this->particleOwner = NULL;
 	this->particleSize = 0.0f;
+
+	callbacksDeferred= false;
+	deferredObserver= NULL;
 }
 
 ParticleSystem::~ParticleSystem() {
@@ -150,6 +158,9 @@ ParticleSystem::~ParticleSystem() {
 
 	delete particleObserver;
 	particleObserver = NULL;
+
+	delete deferredObserver;
+	deferredObserver = NULL;
 }
 
 void ParticleSystem::callParticleOwnerEnd(ParticleSystem *particleSystem) {
@@ -206,17 +217,30 @@ void ParticleSystem::update() {
     	particleSystemStartDelay--;
     }
     else if(state != sPause) {
-		for(int i= 0; i < aliveParticleCount; ++i) {
-			updateParticle(&particles[i]);
-
-			if(deathTest(&particles[i])) {
-
-				//kill the particle
-				killParticle(&particles[i]);
+		if(particleKernelsEnabled == true) {
+			updateParticles();
+			killParticles();
+		}
+		else {
+			for(int i= 0; i < aliveParticleCount; ++i) {
+				Particle particle;
+				particles.get(i, particle);
+				updateParticle(&particle);
+				particles.set(i, particle);
+			}
 
-				//maintain alive particles at front of the array
-				if(aliveParticleCount > 0) {
-					particles[i]= particles[aliveParticleCount];
+			//maintain alive particles at front of the array
+			for(int i= 0; i < aliveParticleCount;) {
+				Particle particle;
+				particles.get(i, particle);
+				if(deathTest(&particle)) {
+					aliveParticleCount--;
+					if(i < aliveParticleCount) {
+						particles.copy(aliveParticleCount, i);
+					}
+				}
+				else {
+					++i;
 				}
 			}
 		}
@@ -225,8 +249,11 @@ void ParticleSystem::update() {
 			emissionState= emissionState + emissionRate;
 			int emissionIntValue= (int) emissionState;
 			for(int i= 0; i < emissionIntValue; i++){
-				Particle *p= createParticle();
-				initParticle(p, i);
+				Particle particle;
+				int particleIndex= createParticle();
+				particles.get(particleIndex, particle);
+				initParticle(&particle, i);
+				particles.set(particleIndex, particle);
 			}
 			emissionState = emissionState - (float) emissionIntValue;
 			emissionState = truncateDecimal<float>(emissionState,6);
@@ -564,16 +591,61 @@ void ParticleSystem::fade(){
 
 	state= sFade;
 	if(alreadyFading == false) {
-		if(particleObserver != NULL){
-			particleObserver->update(this);
-			particleObserver=NULL;
-		}
+		notifyObserver();
 		for(int i=getChildCount()-1; i>=0; i--) {
 			getChild(i)->fade();
 		}
 	}
 }
 
+void ParticleSystem::notifyObserver() {
+	if(particleObserver != NULL){
+		if(callbacksDeferred == true) {
+			deferredObserver= particleObserver;
+		}
+		else {
+			particleObserver->update(this);
+		}
+		particleObserver=NULL;
+	}
+}
+
+void ParticleSystem::logParticleInfo(const string &info) {
+	if(this->particleOwner != NULL) {
+		if(callbacksDeferred == true) {
+			deferredParticleInfo.push_back(info);
+		}
+		else {
+			this->particleOwner->logParticleInfo(info);
+		}
+	}
+}
+
+bool ParticleSystem::hasDeferredCallbacks() const {
+	return deferredObserver != NULL || deferredParticleInfo.empty() == false;
+}
+
+void ParticleSystem::runDeferredCallbacks() {
+	if(this->particleOwner != NULL) {
+		for(unsigned int i = 0; i < deferredParticleInfo.size(); ++i) {
+			this->particleOwner->logParticleInfo(deferredParticleInfo[i]);
+		}
+	}
+	deferredParticleInfo.clear();
+
+	if(deferredObserver != NULL) {
+		ParticleObserver *observer= deferredObserver;
+		deferredObserver= NULL;
+		observer->update(this);
+	}
+}
+
+void ParticleSystem::getLinkedParticleSystems(vector<ParticleSystem *> &linkedSystems) {
+	for(int i = getChildCount() - 1; i >= 0; i--) {
+		linkedSystems.push_back(getChild(i));
+	}
+}
+
 int ParticleSystem::isEmpty() const {
 	//assert(aliveParticleCount>=0);
 	return aliveParticleCount == 0 && state != sPause;
@@ -583,25 +655,16 @@ int ParticleSystem::isEmpty() const {
 
 // if there is one dead particle it returns it else, return the particle with 
 // less energy
-Particle * ParticleSystem::createParticle() {
+int ParticleSystem::createParticle() {
 
 	//if any dead particles
 	if(aliveParticleCount < particleCount) {
 		++aliveParticleCount;
-		return &particles[aliveParticleCount - 1];
+		return aliveParticleCount - 1;
 	}
 
 	//if not
-	int minEnergy= particles[0].energy;
-	int minEnergyParticle= 0;
-
-	for(int i= 0; i < particleCount; ++i){
-		if(particles[i].energy < minEnergy){
-			minEnergy= particles[i].energy;
-			minEnergyParticle= i;
-		}
-	}
-	return &particles[minEnergyParticle];
+	return particles.findMinEnergy(particleCount);
 }
 
 void ParticleSystem::initParticle(Particle *p, int particleIndex) {
@@ -626,8 +689,27 @@ bool ParticleSystem::deathTest(Particle *p) {
 	return p->energy <= 0;
 }
 
-void ParticleSystem::killParticle(Particle *p) {
-	aliveParticleCount--;
+void ParticleSystem::updateParticles() {
+	particles.updateLinear(aliveParticleCount);
+}
+
+void ParticleSystem::killParticles() {
+	aliveParticleCount= particles.killNoEnergy(aliveParticleCount);
+}
+
+ParticleKernelParams ParticleSystem::getKernelParams() const {
+	ParticleKernelParams params;
+	params.color= color;
+	params.colorNoEnergy= colorNoEnergy;
+	params.size= particleSize;
+	params.maxEnergy= maxParticleEnergy;
+	params.alternations= alternations;
+	return params;
+}
+
+bool ParticleSystem::isUpdatedWhenVisibleOnly() const {
+	ParticleSystemType type= getParticleSystemType();
+	return type == pst_UnitParticleSystem || type == pst_FireParticleSystem;
 }
 
 void ParticleSystem::setFactionColor(Vec3f factionColor){
@@ -716,6 +798,10 @@ void FireParticleSystem::updateParticle(Particle *p){
 
 }
 
+void FireParticleSystem::updateParticles() {
+	particles.updateFire(aliveParticleCount);
+}
+
 string FireParticleSystem::toString() const {
 	string result = ParticleSystem::toString();
 
@@ -1345,6 +1431,18 @@ void UnitParticleSystem::updateParticle(Particle *p){
 	}
 }
 
+void UnitParticleSystem::updateParticles() {
+	ParticleKernelParams params= getKernelParams();
+	params.sizeNoEnergy= sizeNoEnergy;
+	params.fixed= fixed;
+	params.fixedAddition= fixedAddition;
+	params.daylightAffected= isDaylightAffected;
+	params.lightColor= lightColor;
+	params.energyCycles= (state != ParticleSystem::sFade && staticParticleCount >= 1);
+
+	particles.updateUnit(aliveParticleCount, params, energyUp);
+}
+
 // ================= SET PARAMS ====================
 
 void UnitParticleSystem::setWind(float windAngle, float windSpeed){
@@ -1592,6 +1690,10 @@ bool RainParticleSystem::deathTest(Particle *p){
 	return p->pos.y < 0;
 }
 
+void RainParticleSystem::killParticles() {
+	aliveParticleCount= particles.killBelowGround(aliveParticleCount);
+}
+
 void RainParticleSystem::setRadius(float radius) {
 	this->radius= radius;
 }
@@ -1671,6 +1773,10 @@ bool SnowParticleSystem::deathTest(Particle *p){
 	return p->pos.y < 0;
 }
 
+void SnowParticleSystem::killParticles() {
+	aliveParticleCount= particles.killBelowGround(aliveParticleCount);
+}
+
 void SnowParticleSystem::setRadius(float radius){
 	this->radius= radius;
 }
@@ -1796,6 +1902,13 @@ void ProjectileParticleSystem::link(SplashParticleSystem *particleSystem){
 	nextParticleSystem->prevParticleSystem= this;
 }
 
+void ProjectileParticleSystem::getLinkedParticleSystems(vector<ParticleSystem *> &linkedSystems) {
+	GameParticleSystem::getLinkedParticleSystems(linkedSystems);
+	if(nextParticleSystem != NULL) {
+		linkedSystems.push_back(nextParticleSystem);
+	}
+}
+
 void ProjectileParticleSystem::update(){
 	//printf("Projectile particle system updating...\n");
 	if(state == sPlay){
@@ -1888,17 +2001,14 @@ void ProjectileParticleSystem::update(){
 		if(this->particleOwner != NULL) {
 			char szBuf[8096]="";
 			snprintf(szBuf,8095,"LINE: %d arriveDestinationDistance = %f",__LINE__,arriveDestinationDistance);
-			this->particleOwner->logParticleInfo(szBuf);
+			logParticleInfo(szBuf);
 		}
 
 		if(arriveDestinationDistance < 0.5f) {
 			fade();
 			model= NULL;
 
-			if(particleObserver != NULL){
-				particleObserver->update(this);
-				particleObserver=NULL;
-			}
+			notifyObserver();
 
 			if(nextParticleSystem != NULL){
 				nextParticleSystem->setVisible(getVisible());
@@ -1975,6 +2085,12 @@ void ProjectileParticleSystem::updateParticle(Particle *p){
 	p->energy--;
 }
 
+void ProjectileParticleSystem::updateParticles() {
+	ParticleKernelParams params= getKernelParams();
+	params.sizeNoEnergy= sizeNoEnergy;
+	particles.updateProjectile(aliveParticleCount, params);
+}
+
 void ProjectileParticleSystem::setPath(Vec3f startPos, Vec3f endPos) {
 	startPos.x = truncateDecimal<float>(startPos.x,6);
 	startPos.y = truncateDecimal<float>(startPos.y,6);
@@ -2228,7 +2344,7 @@ void SplashParticleSystem::update() {
 		if(this->particleOwner != NULL) {
 			char szBuf[8096]="";
 			snprintf(szBuf,8095,"LINE: %d emissionRate = %f",__LINE__,emissionRate);
-			this->particleOwner->logParticleInfo(szBuf);
+			logParticleInfo(szBuf);
 		}
 
 		if(emissionRate < 0.0f) {//otherwise this system lives forever!
@@ -2292,6 +2408,12 @@ void SplashParticleSystem::updateParticle(Particle *p){
 	p->size = truncateDecimal<float>(p->size,6);
 }
 
+void SplashParticleSystem::updateParticles() {
+	ParticleKernelParams params= getKernelParams();
+	params.sizeNoEnergy= sizeNoEnergy;
+	particles.updateSplash(aliveParticleCount, params);
+}
+
 void SplashParticleSystem::saveGame(XmlNode *rootNode) {
 	std::map<string,string> mapTagReplacements;
 	XmlNode *splashParticleSystemNode = rootNode->addChild("SplashParticleSystem");
@@ -2373,11 +2495,107 @@ string SplashParticleSystem::toString() const {
 	return result;
 }
 
+// ===========================================================================
+//  ParticleUpdateTasks
+//
+//	Systems linked to each other (children, the splash of a projectile)
+//	form a group that one task updates in list order. Groups never touch
+//	each other while updating, so which worker runs them doesn't matter.
+// ===========================================================================
+
+class ParticleUpdateTasks : public TaskPoolCallbackInterface {
+private:
+	const vector<ParticleSystem *> &updateList;
+	vector<int> taskStart;
+	vector<int> taskSystems;
+
+	static int findGroup(vector<int> &groups, int index) {
+		while(groups[index] != index) {
+			groups[index]= groups[groups[index]];
+			index= groups[index];
+		}
+		return index;
+	}
+
+public:
+	vector<char> cleanup;
+
+	ParticleUpdateTasks(const vector<ParticleSystem *> &updateList, int targetTaskCount) : updateList(updateList) {
+		int systemCount= (int)updateList.size();
+		cleanup.resize(systemCount,false);
+
+		std::map<ParticleSystem *,int> systemIndex;
+		vector<int> groups(systemCount);
+		for(int i = 0; i < systemCount; ++i) {
+			systemIndex[updateList[i]]= i;
+			groups[i]= i;
+		}
+
+		vector<ParticleSystem *> linkedSystems;
+		for(int i = 0; i < systemCount; ++i) {
+			linkedSystems.clear();
+			updateList[i]->getLinkedParticleSystems(linkedSystems);
+			for(unsigned int j = 0; j < linkedSystems.size(); ++j) {
+				std::map<ParticleSystem *,int>::iterator iterFind= systemIndex.find(linkedSystems[j]);
+				if(iterFind != systemIndex.end()) {
+					int group= findGroup(groups, i);
+					int linkedGroup= findGroup(groups, iterFind->second);
+					groups[max(group,linkedGroup)]= min(group,linkedGroup);
+				}
+			}
+		}
+
+		// groups in the order of their first system, each one whole in a task
+		vector<vector<int> > groupSystems;
+		vector<int> groupOfRoot(systemCount,-1);
+		for(int i = 0; i < systemCount; ++i) {
+			int root= findGroup(groups, i);
+			if(groupOfRoot[root] < 0) {
+				groupOfRoot[root]= (int)groupSystems.size();
+				groupSystems.push_back(vector<int>());
+			}
+			groupSystems[groupOfRoot[root]].push_back(i);
+		}
+
+		int systemsPerTask= max(1,(systemCount + targetTaskCount - 1) / max(1,targetTaskCount));
+		for(unsigned int group = 0; group < groupSystems.size(); ++group) {
+			if(taskStart.empty() == true ||
+				(int)taskSystems.size() - taskStart.back() >= systemsPerTask) {
+				taskStart.push_back((int)taskSystems.size());
+			}
+			taskSystems.insert(taskSystems.end(),groupSystems[group].begin(),groupSystems[group].end());
+		}
+		taskStart.push_back((int)taskSystems.size());
+	}
+
+	int getTaskCount() const { return (int)taskStart.size() - 1; }
+
+	virtual void runPoolTask(int taskIndex, int workerIndex) {
+		for(int i = taskStart[taskIndex]; i < taskStart[taskIndex + 1]; ++i) {
+			int index= taskSystems[i];
+			ParticleSystem *ps= updateList[index];
+
+			bool showParticle= true;
+			if(ps->isUpdatedWhenVisibleOnly() == true) {
+				showParticle = ps->getVisible() || (ps->getState() == ParticleSystem::sFade);
+			}
+			if(showParticle == true){
+				ps->update();
+				if(ps->isEmpty() && ps->getState() == ParticleSystem::sFade) {
+					cleanup[index]= true;
+				}
+			}
+		}
+	}
+};
+
 // ===========================================================================
 //  ParticleManager
 // ===========================================================================
 
 ParticleManager::ParticleManager() {
+	particleSystemHoles= 0;
+	updating= false;
 }
 
 ParticleManager::~ParticleManager() {
@@ -2406,8 +2624,7 @@ bool ParticleManager::hasActiveParticleSystem(ParticleSystem::ParticleSystemType
 			//currentParticleCount+= ps->getAliveParticleCount();
 
 			bool showParticle= true;
-			if(dynamic_cast<UnitParticleSystem *> (ps) != NULL ||
-			   dynamic_cast<FireParticleSystem *> (ps) != NULL) {
+			if(ps->isUpdatedWhenVisibleOnly() == true) {
 				showParticle= ps->getVisible() || (ps->getState() == ParticleSystem::sFade);
 			}
 			if(showParticle == true){
@@ -2425,32 +2642,47 @@ bool ParticleManager::hasActiveParticleSystem(ParticleSystem::ParticleSystemType
 	return result;
 }
 
-void ParticleManager::update(int renderFps){
+void ParticleManager::update(int renderFps, WorkStealingTaskPool *taskPool){
 	Chrono chrono;
 	if(SystemFlags::getSystemSettingType(SystemFlags::debugPerformance).enabled) chrono.start();
 
 	size_t particleSystemCount= particleSystems.size();
 	int currentParticleCount= 0;
 
-	vector<ParticleSystem *> cleanupParticleSystemsList;
+	vector<ParticleSystem *> updateList;
 	for(unsigned int i= 0; i < particleSystems.size(); i++){
 		ParticleSystem *ps= particleSystems[i];
 		if(ps != NULL) {
-			currentParticleCount+= ps->getAliveParticleCount();
+			updateList.push_back(ps);
+		}
+	}
 
-			bool showParticle= true;
-			if( dynamic_cast<UnitParticleSystem *> (ps) != NULL ||
-				dynamic_cast<FireParticleSystem *> (ps) != NULL) {
-				showParticle = ps->getVisible() || (ps->getState() == ParticleSystem::sFade);
+	// observers may start new systems, those are updated in this frame too
+	vector<ParticleSystem *> cleanupParticleSystemsList;
+	updating= true;
+	managedDuringUpdate.clear();
+	try {
+		while(updateList.empty() == false) {
+			for(unsigned int i= 0; i < updateList.size(); i++){
+				currentParticleCount+= updateList[i]->getAliveParticleCount();
 			}
-			if(showParticle == true){
-				ps->update();
-				if(ps->isEmpty() && ps->getState() == ParticleSystem::sFade) {
-					cleanupParticleSystemsList.push_back(ps);
+			updateParticleSystems(updateList, cleanupParticleSystemsList, taskPool);
+
+			updateList.clear();
+			for(unsigned int i= 0; i < managedDuringUpdate.size(); i++){
+				if(validateParticleSystemStillExists(managedDuringUpdate[i]) == true) {
+					updateList.push_back(managedDuringUpdate[i]);
 				}
 			}
+			managedDuringUpdate.clear();
 		}
 	}
+	catch(...) {
+		updating= false;
+		throw;
+	}
+	updating= false;
+
 	//particleSystems.remove(NULL);
 	cleanupParticleSystems(cleanupParticleSystemsList);
 
@@ -2459,8 +2691,8 @@ void ParticleManager::update(int renderFps){
 }
 
 bool ParticleManager::validateParticleSystemStillExists(ParticleSystem * particleSystem) const{
-	int index= findParticleSystems(particleSystem, this->particleSystems);
-	return (index >= 0);
+	return (particleSystem != NULL &&
+			particleSystemIndexes.find(particleSystem) != particleSystemIndexes.end());
 }
 
 void ParticleManager::removeParticleSystemsForParticleOwner(ParticleOwner *particleOwner) {
@@ -2479,6 +2711,68 @@ void ParticleManager::removeParticleSystemsForParticleOwner(ParticleOwner *parti
 	}
 }
 
+// Updates the systems, on the workers of the borrowed pool when there are
+// enough of them, then runs their observers and owner logs in list order.
+// The outcome is the same with or without workers, so every client of a
+// game agrees on it.
+void ParticleManager::updateParticleSystems(const vector<ParticleSystem *> &updateList,
+											vector<ParticleSystem *> &cleanupParticleSystemsList,
+											WorkStealingTaskPool *taskPool) {
+	bool useTaskPool= (parallelUpdateEnabled == true && taskPool != NULL &&
+						taskPool->getWorkerCount() > 1 &&
+						(int)updateList.size() >= minParallelParticleSystemCount);
+
+	ParticleUpdateTasks tasks(updateList, (useTaskPool == true ? taskPool->getWorkerCount() * 4 : 1));
+
+	// systems can fade the ones they are linked to, so every system holds back
+	setCallbacksDeferred(true);
+	try {
+		if(useTaskPool == true && tasks.getTaskCount() > 1) {
+			taskPool->runTasks(&tasks, tasks.getTaskCount());
+		}
+		else {
+			for(int task= 0; task < tasks.getTaskCount(); task++){
+				tasks.runPoolTask(task, 0);
+			}
+		}
+	}
+	catch(...) {
+		setCallbacksDeferred(false);
+		throw;
+	}
+	setCallbacksDeferred(false);
+
+	for(unsigned int i= 0; i < updateList.size(); i++){
+		if(tasks.cleanup[i] == true) {
+			cleanupParticleSystemsList.push_back(updateList[i]);
+		}
+	}
+
+	vector<ParticleSystem *> deferredList;
+	for(unsigned int i= 0; i < particleSystems.size(); i++){
+		ParticleSystem *ps= particleSystems[i];
+		if(ps != NULL && ps->hasDeferredCallbacks() == true) {
+			deferredList.push_back(ps);
+		}
+	}
+
+	// an observer may end other systems of this list
+	for(unsigned int i= 0; i < deferredList.size(); i++){
+		ParticleSystem *ps= deferredList[i];
+		if(validateParticleSystemStillExists(ps) == true) {
+			ps->runDeferredCallbacks();
+		}
+	}
+}
+
+void ParticleManager::setCallbacksDeferred(bool value) {
+	for(unsigned int i= 0; i < particleSystems.size(); i++){
+		if(particleSystems[i] != NULL) {
+			particleSystems[i]->setCallbacksDeferred(value);
+		}
+	}
+}
+
 int ParticleManager::findParticleSystems(ParticleSystem *psFind, const vector<ParticleSystem *> &particleSystems) const{
 	int result= -1;
 	for(unsigned int i= 0; i < particleSystems.size(); i++){
@@ -2493,8 +2787,7 @@ int ParticleManager::findParticleSystems(ParticleSystem *psFind, const vector<Pa
 
 void ParticleManager::cleanupParticleSystems(ParticleSystem *ps) {
 
-	int index= findParticleSystems(ps, this->particleSystems);
-	if(ps != NULL && index >= 0) {
+	if(validateParticleSystemStillExists(ps) == true) {
 //		printf("-- Delete cleanupParticleSystems [%p]\n",ps);
 //		static map<void *,int> deleteList;
 //		if(deleteList.find(ps) != deleteList.end()) {
@@ -2507,13 +2800,35 @@ void ParticleManager::cleanupParticleSystems(ParticleSystem *ps) {
 		//	ps->fade();
 		//}
 
-		if(ps != NULL) {
-			ps->callParticleOwnerEnd(ps);
+		ps->callParticleOwnerEnd(ps);
+
+		// the owner may already have cleaned it up
+		std::map<const ParticleSystem *,size_t>::iterator iterFind= particleSystemIndexes.find(ps);
+		if(iterFind != particleSystemIndexes.end()) {
+			particleSystems[iterFind->second]= NULL;
+			particleSystemIndexes.erase(iterFind);
+			particleSystemHoles++;
+			delete ps;
+
+			if(particleSystemHoles * 2 > particleSystems.size()) {
+				compactParticleSystems();
+			}
 		}
+	}
+}
 
-		delete ps;
-		this->particleSystems.erase(this->particleSystems.begin() + index);
+void ParticleManager::compactParticleSystems() {
+	size_t count= 0;
+	for(unsigned int i= 0; i < particleSystems.size(); i++){
+		ParticleSystem *ps= particleSystems[i];
+		if(ps != NULL) {
+			particleSystems[count]= ps;
+			particleSystemIndexes[ps]= count;
+			count++;
+		}
 	}
+	particleSystems.resize(count);
+	particleSystemHoles= 0;
 }
 
 void ParticleManager::cleanupParticleSystems(vector<ParticleSystem *> &cleanupParticleSystemsList){
@@ -2538,8 +2853,12 @@ void ParticleManager::cleanupUnitParticleSystems(vector<UnitParticleSystem *> &c
 }
 
 void ParticleManager::manage(ParticleSystem *ps){
-	assert((std::find(particleSystems.begin(),particleSystems.end(),ps) == particleSystems.end()) && "particle cannot be added twice");
+	assert(validateParticleSystemStillExists(ps) == false && "particle cannot be added twice");
+	particleSystemIndexes[ps]= particleSystems.size();
 	particleSystems.push_back(ps);
+	if(updating == true) {
+		managedDuringUpdate.push_back(ps);
+	}
 	for(int i = ps->getChildCount() - 1; i >= 0; i--) {
 		manage(ps->getChild(i));
 	}
@@ -2556,12 +2875,16 @@ void ParticleManager::end(){
 //		}
 //		deleteList[ps]++;
 
+		// taken off the list first, the owner may clean up other systems
+		particleSystems.pop_back();
 		if(ps != NULL) {
+			particleSystemIndexes.erase(ps);
 			ps->callParticleOwnerEnd(ps);
 		}
 		delete ps;
-		particleSystems.pop_back();
 	}
+	particleSystemIndexes.clear();
+	particleSystemHoles= 0;
 }
 
 }
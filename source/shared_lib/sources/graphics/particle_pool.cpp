@@ -0,0 +1,614 @@
+// ==============================================================
+//	This file is part of MegaGlest Shared Library (www.megaglest.org)
+//
+//	Copyright (C) 2026 The MegaGlest Team
+//
+//	You can redistribute this code and/or modify it under
+//	the terms of the GNU General Public License as published
+//	by the Free Software Foundation; either version 2 of the
+//	License, or (at your option) any later version
+// ==============================================================
+
+#include "math_wrapper.h"
+#include "particle.h"
+
+#if defined(__SSE2__) || defined(_M_X64) || defined(_M_AMD64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+  #define PARTICLE_POOL_SSE2
+  #include <emmintrin.h>
+#endif
+
+#include "util.h"
+#include "leak_dumper.h"
+
+using namespace std;
+using namespace Shared::Util;
+
+namespace Shared{ namespace Graphics{
+
+// =====================================================
+//	class Float4 / Mask4
+//
+//	Four particles worth of one attribute. The kernels are written
+//	once against these and use SSE2 when the build targets it.
+// =====================================================
+
+#ifdef PARTICLE_POOL_SSE2
+
+class Mask4 {
+public:
+	__m128 v;
+	explicit Mask4(__m128 v) : v(v) {}
+};
+
+class Float4 {
+public:
+	__m128 v;
+
+	Float4() {}
+	explicit Float4(__m128 v) : v(v) {}
+	explicit Float4(float value) : v(_mm_set1_ps(value)) {}
+
+	static Float4 load(const float *values)	{return Float4(_mm_loadu_ps(values));}
+	static Float4 loadInts(const int *values) {
+		return Float4(_mm_cvtepi32_ps(_mm_loadu_si128(reinterpret_cast<const __m128i *>(values))));
+	}
+	void store(float *values) const			{_mm_storeu_ps(values, v);}
+
+	Float4 operator+(const Float4 &other) const	{return Float4(_mm_add_ps(v, other.v));}
+	Float4 operator-(const Float4 &other) const	{return Float4(_mm_sub_ps(v, other.v));}
+	Float4 operator*(const Float4 &other) const	{return Float4(_mm_mul_ps(v, other.v));}
+	Float4 operator/(const Float4 &other) const	{return Float4(_mm_div_ps(v, other.v));}
+
+	Mask4 operator<(const Float4 &other) const	{return Mask4(_mm_cmplt_ps(v, other.v));}
+	Mask4 operator>(const Float4 &other) const	{return Mask4(_mm_cmpgt_ps(v, other.v));}
+
+	static Float4 select(const Mask4 &mask, const Float4 &ifTrue, const Float4 &ifFalse) {
+		return Float4(_mm_or_ps(_mm_and_ps(mask.v, ifTrue.v), _mm_andnot_ps(mask.v, ifFalse.v)));
+	}
+
+	// Same as truncateDecimal<float>(value,6): the product is cut to a
+	// whole number (floats from 2^23 up already are) and divided in double
+	Float4 truncateDecimal6() const {
+		const __m128 scaled = _mm_mul_ps(v, _mm_set1_ps(1000000.0f));
+		const __m128 absScaled = _mm_andnot_ps(_mm_set1_ps(-0.0f), scaled);
+		const __m128 hasFraction = _mm_cmplt_ps(absScaled, _mm_set1_ps(8388608.0f));
+		const __m128 whole = _mm_cvtepi32_ps(_mm_cvttps_epi32(scaled));
+		const __m128 truncated = _mm_or_ps(_mm_and_ps(hasFraction, whole), _mm_andnot_ps(hasFraction, scaled));
+
+		const __m128d divisor = _mm_set1_pd(1000000.0);
+		const __m128d low = _mm_div_pd(_mm_cvtps_pd(truncated), divisor);
+		const __m128d high = _mm_div_pd(_mm_cvtps_pd(_mm_movehl_ps(truncated, truncated)), divisor);
+		return Float4(_mm_movelh_ps(_mm_cvtpd_ps(low), _mm_cvtpd_ps(high)));
+	}
+};
+
+static inline bool anyNoEnergy(const int *energies) {
+	const __m128i values = _mm_loadu_si128(reinterpret_cast<const __m128i *>(energies));
+	return _mm_movemask_epi8(_mm_cmplt_epi32(values, _mm_set1_epi32(1))) != 0;
+}
+
+static inline bool anyBelowGround(const float *posY) {
+	return _mm_movemask_ps(_mm_cmplt_ps(_mm_loadu_ps(posY), _mm_setzero_ps())) != 0;
+}
+
+#else
+
+class Mask4 {
+public:
+	bool v[4];
+};
+
+class Float4 {
+public:
+	float v[4];
+
+	Float4() {}
+	explicit Float4(float value) {
+		v[0]= v[1]= v[2]= v[3]= value;
+	}
+
+	static Float4 load(const float *values) {
+		Float4 result;
+		for(int i = 0; i < 4; ++i) result.v[i]= values[i];
+		return result;
+	}
+	static Float4 loadInts(const int *values) {
+		Float4 result;
+		for(int i = 0; i < 4; ++i) result.v[i]= static_cast<float>(values[i]);
+		return result;
+	}
+	void store(float *values) const {
+		for(int i = 0; i < 4; ++i) values[i]= v[i];
+	}
+
+	Float4 operator+(const Float4 &other) const {
+		Float4 result;
+		for(int i = 0; i < 4; ++i) result.v[i]= v[i] + other.v[i];
+		return result;
+	}
+	Float4 operator-(const Float4 &other) const {
+		Float4 result;
+		for(int i = 0; i < 4; ++i) result.v[i]= v[i] - other.v[i];
+		return result;
+	}
+	Float4 operator*(const Float4 &other) const {
+		Float4 result;
+		for(int i = 0; i < 4; ++i) result.v[i]= v[i] * other.v[i];
+		return result;
+	}
+	Float4 operator/(const Float4 &other) const {
+		Float4 result;
+		for(int i = 0; i < 4; ++i) result.v[i]= v[i] / other.v[i];
+		return result;
+	}
+
+	Mask4 operator<(const Float4 &other) const {
+		Mask4 result;
+		for(int i = 0; i < 4; ++i) result.v[i]= v[i] < other.v[i];
+		return result;
+	}
+	Mask4 operator>(const Float4 &other) const {
+		Mask4 result;
+		for(int i = 0; i < 4; ++i) result.v[i]= v[i] > other.v[i];
+		return result;
+	}
+
+	static Float4 select(const Mask4 &mask, const Float4 &ifTrue, const Float4 &ifFalse) {
+		Float4 result;
+		for(int i = 0; i < 4; ++i) result.v[i]= (mask.v[i] ? ifTrue.v[i] : ifFalse.v[i]);
+		return result;
+	}
+
+	Float4 truncateDecimal6() const {
+		Float4 result;
+		for(int i = 0; i < 4; ++i) result.v[i]= truncateDecimal<float>(v[i],6);
+		return result;
+	}
+};
+
+static inline bool anyNoEnergy(const int *energies) {
+	return energies[0] <= 0 || energies[1] <= 0 || energies[2] <= 0 || energies[3] <= 0;
+}
+
+static inline bool anyBelowGround(const float *posY) {
+	return posY[0] < 0 || posY[1] < 0 || posY[2] < 0 || posY[3] < 0;
+}
+
+#endif
+
+// clamp(value, 0, 1) of util.h, comparison for comparison
+static inline Float4 clampUnit(const Float4 &value) {
+	const Float4 zero(0.0f);
+	const Float4 one(1.0f);
+	Float4 result= Float4::select(value < zero, zero, value);
+	return Float4::select(result > one, one, result);
+}
+
+// =====================================================
+//	class ParticleKernelParams
+// =====================================================
+
+ParticleKernelParams::ParticleKernelParams() {
+	size= 0;
+	sizeNoEnergy= 0;
+	maxEnergy= 0;
+	alternations= 0;
+	fixed= false;
+	daylightAffected= false;
+	lightColor= Vec3f(1.0f);
+	energyCycles= false;
+}
+
+// =====================================================
+//	class ParticlePool
+// =====================================================
+
+ParticlePool::ParticlePool() {
+	count= 0;
+}
+
+void ParticlePool::resize(int count) {
+	this->count= count;
+	int paddedCount= ((count + kernelWidth - 1) / kernelWidth) * kernelWidth;
+	for(int attribute = 0; attribute < paCount; ++attribute) {
+		values[attribute].assign(paddedCount, 0.0f);
+	}
+	energies.assign(paddedCount, 0);
+	energyRatios.assign(paddedCount, 0.0f);
+}
+
+void ParticlePool::clear() {
+	count= 0;
+	for(int attribute = 0; attribute < paCount; ++attribute) {
+		values[attribute].clear();
+	}
+	energies.clear();
+	energyRatios.clear();
+}
+
+void ParticlePool::get(int index, Particle &particle) const {
+	particle.pos= getPos(index);
+	particle.lastPos= getLastPos(index);
+	particle.speed= Vec3f(values[paSpeedX][index], values[paSpeedY][index], values[paSpeedZ][index]);
+	particle.speedUpRelative= values[paSpeedUpRelative][index];
+	particle.speedUpConstant= Vec3f(values[paSpeedUpConstantX][index], values[paSpeedUpConstantY][index], values[paSpeedUpConstantZ][index]);
+	particle.accel= Vec3f(values[paAccelX][index], values[paAccelY][index], values[paAccelZ][index]);
+	particle.color= getColor(index);
+	particle.size= values[paSize][index];
+	particle.energy= energies[index];
+}
+
+void ParticlePool::set(int index, const Particle &particle) {
+	values[paPosX][index]= particle.pos.x;
+	values[paPosY][index]= particle.pos.y;
+	values[paPosZ][index]= particle.pos.z;
+	values[paLastPosX][index]= particle.lastPos.x;
+	values[paLastPosY][index]= particle.lastPos.y;
+	values[paLastPosZ][index]= particle.lastPos.z;
+	values[paSpeedX][index]= particle.speed.x;
+	values[paSpeedY][index]= particle.speed.y;
+	values[paSpeedZ][index]= particle.speed.z;
+	values[paSpeedUpRelative][index]= particle.speedUpRelative;
+	values[paSpeedUpConstantX][index]= particle.speedUpConstant.x;
+	values[paSpeedUpConstantY][index]= particle.speedUpConstant.y;
+	values[paSpeedUpConstantZ][index]= particle.speedUpConstant.z;
+	values[paAccelX][index]= particle.accel.x;
+	values[paAccelY][index]= particle.accel.y;
+	values[paAccelZ][index]= particle.accel.z;
+	values[paColorR][index]= particle.color.x;
+	values[paColorG][index]= particle.color.y;
+	values[paColorB][index]= particle.color.z;
+	values[paColorA][index]= particle.color.w;
+	values[paSize][index]= particle.size;
+	energies[index]= particle.energy;
+}
+
+void ParticlePool::copy(int fromIndex, int toIndex) {
+	for(int attribute = 0; attribute < paCount; ++attribute) {
+		values[attribute][toIndex]= values[attribute][fromIndex];
+	}
+	energies[toIndex]= energies[fromIndex];
+}
+
+Vec3f ParticlePool::getPos(int index) const {
+	return Vec3f(values[paPosX][index], values[paPosY][index], values[paPosZ][index]);
+}
+
+Vec3f ParticlePool::getLastPos(int index) const {
+	return Vec3f(values[paLastPosX][index], values[paLastPosY][index], values[paLastPosZ][index]);
+}
+
+Vec4f ParticlePool::getColor(int index) const {
+	return Vec4f(values[paColorR][index], values[paColorG][index], values[paColorB][index], values[paColorA][index]);
+}
+
+int ParticlePool::findMinEnergy(int aliveCount) const {
+	int minEnergy= energies[0];
+	int minEnergyParticle= 0;
+
+	for(int i= 0; i < aliveCount; ++i){
+		if(energies[i] < minEnergy){
+			minEnergy= energies[i];
+			minEnergyParticle= i;
+		}
+	}
+	return minEnergyParticle;
+}
+
+// ParticleSystem::updateParticle, also rain and snow
+void ParticlePool::updateLinear(int aliveCount) {
+	if(aliveCount <= 0) {
+		return;
+	}
+	for(int axis = 0; axis < 3; ++axis) {
+		float *pos= getValues(Attribute(paPosX + axis));
+		float *lastPos= getValues(Attribute(paLastPosX + axis));
+		float *speed= getValues(Attribute(paSpeedX + axis));
+		const float *accel= getValues(Attribute(paAccelX + axis));
+
+		for(int i = 0; i < aliveCount; i += kernelWidth) {
+			Float4 particlePos= Float4::load(pos + i);
+			Float4 particleSpeed= Float4::load(speed + i);
+
+			particlePos.store(lastPos + i);
+			(particlePos + particleSpeed).store(pos + i);
+			(particleSpeed + Float4::load(accel + i)).store(speed + i);
+		}
+	}
+	for(int i = 0; i < aliveCount; ++i) {
+		energies[i]--;
+	}
+}
+
+// FireParticleSystem::updateParticle
+void ParticlePool::updateFire(int aliveCount) {
+	if(aliveCount <= 0) {
+		return;
+	}
+	for(int axis = 0; axis < 3; ++axis) {
+		float *pos= getValues(Attribute(paPosX + axis));
+		float *lastPos= getValues(Attribute(paLastPosX + axis));
+		const float *speed= getValues(Attribute(paSpeedX + axis));
+
+		for(int i = 0; i < aliveCount; i += kernelWidth) {
+			Float4 particlePos= Float4::load(pos + i);
+			particlePos.store(lastPos + i);
+			(particlePos + Float4::load(speed + i)).store(pos + i);
+		}
+	}
+
+	const Float4 zero(0.0f);
+	const Float4 fade(0.98f);
+	const Attribute fadedColors[] = { paColorR, paColorG, paColorA };
+	for(int component = 0; component < 3; ++component) {
+		float *color= getValues(fadedColors[component]);
+		for(int i = 0; i < aliveCount; i += kernelWidth) {
+			Float4 particleColor= Float4::load(color + i);
+			Float4::select(particleColor > zero, particleColor * fade, particleColor).store(color + i);
+		}
+	}
+
+	const Float4 accelerationX(1.001f);
+	float *speedX= getValues(paSpeedX);
+	float *speedY= getValues(paSpeedY);
+	float *speedZ= getValues(paSpeedZ);
+	for(int i = 0; i < aliveCount; i += kernelWidth) {
+		(Float4::load(speedX + i) * accelerationX).truncateDecimal6().store(speedX + i);
+		Float4::load(speedY + i).truncateDecimal6().store(speedY + i);
+		Float4::load(speedZ + i).truncateDecimal6().store(speedZ + i);
+	}
+
+	for(int i = 0; i < aliveCount; ++i) {
+		energies[i]--;
+	}
+}
+
+// UnitParticleSystem::updateParticle
+void ParticlePool::updateUnit(int aliveCount, const ParticleKernelParams &params, bool &energyUp) {
+	if(aliveCount <= 0) {
+		return;
+	}
+	// the ratio needs an integer modulo, the rest of the update is vectorized
+	float *ratios= &energyRatios[0];
+	for(int i = 0; i < aliveCount; ++i) {
+		float energyRatio;
+		if(params.alternations > 0){
+			int interval= (params.maxEnergy / params.alternations);
+			float moduloValue= (float)((int)(static_cast<float> (energies[i])) % interval);
+			float floatInterval=static_cast<float> (interval);
+
+			if(moduloValue < floatInterval / 2.0f){
+				energyRatio= (floatInterval - moduloValue) / floatInterval;
+			}
+			else{
+				energyRatio= moduloValue / floatInterval;
+			}
+			energyRatio= clamp(energyRatio, 0.f, 1.f);
+		}
+		else{
+			energyRatio= clamp(static_cast<float> (energies[i]) / static_cast<float> (params.maxEnergy), 0.f, 1.f);
+		}
+		ratios[i]= truncateDecimal<float>(energyRatio,6);
+	}
+
+	const float *speedUpRelative= getValues(paSpeedUpRelative);
+	const Float4 one(1.0f);
+	for(int axis = 0; axis < 3; ++axis) {
+		float *pos= getValues(Attribute(paPosX + axis));
+		float *lastPos= getValues(Attribute(paLastPosX + axis));
+		float *speed= getValues(Attribute(paSpeedX + axis));
+		const float *accel= getValues(Attribute(paAccelX + axis));
+		const float *speedUpConstant= getValues(Attribute(paSpeedUpConstantX + axis));
+		const Float4 fixedAddition(params.fixedAddition.ptr()[axis]);
+
+		for(int i = 0; i < aliveCount; i += kernelWidth) {
+			Float4 particleSpeed= Float4::load(speed + i);
+			Float4 particleLastPos= (Float4::load(lastPos + i) + particleSpeed).truncateDecimal6();
+			Float4 particlePos= (Float4::load(pos + i) + particleSpeed).truncateDecimal6();
+			if(params.fixed) {
+				particleLastPos= (particleLastPos + fixedAddition).truncateDecimal6();
+				particlePos= (particlePos + fixedAddition).truncateDecimal6();
+			}
+			particleLastPos.store(lastPos + i);
+			particlePos.store(pos + i);
+
+			particleSpeed= particleSpeed + Float4::load(accel + i);
+			particleSpeed= particleSpeed + Float4::load(speedUpConstant + i);
+			particleSpeed= particleSpeed * (one + Float4::load(speedUpRelative + i));
+			particleSpeed.truncateDecimal6().store(speed + i);
+		}
+	}
+
+	for(int component = 0; component < 4; ++component) {
+		float *color= getValues(Attribute(paColorR + component));
+		const Float4 energyColor(params.color.ptr()[component]);
+		const Float4 noEnergyColor(params.colorNoEnergy.ptr()[component]);
+		const bool applyLight= (params.daylightAffected == true && component < 3);
+		const Float4 light(applyLight ? params.lightColor.ptr()[component] : 1.0f);
+
+		for(int i = 0; i < aliveCount; i += kernelWidth) {
+			Float4 ratio= Float4::load(ratios + i);
+			Float4 particleColor= energyColor * ratio + noEnergyColor * (one - ratio);
+			if(applyLight) {
+				particleColor= particleColor * light;
+			}
+			particleColor.store(color + i);
+		}
+	}
+
+	float *size= getValues(paSize);
+	const Float4 energySize(params.size);
+	const Float4 noEnergySize(params.sizeNoEnergy);
+	for(int i = 0; i < aliveCount; i += kernelWidth) {
+		Float4 ratio= Float4::load(ratios + i);
+		(energySize * ratio + noEnergySize * (one - ratio)).truncateDecimal6().store(size + i);
+	}
+
+	// the direction static particles count in is shared by the system
+	if(params.energyCycles == false) {
+		for(int i = 0; i < aliveCount; ++i) {
+			energies[i]--;
+		}
+	}
+	else if(params.maxEnergy > 2) {
+		for(int i = 0; i < aliveCount; ++i) {
+			if(energyUp){
+				energies[i]++;
+			}
+			else{
+				energies[i]--;
+			}
+
+			if(energies[i] == 1){
+				energyUp= true;
+			}
+			if(energies[i] == params.maxEnergy){
+				energyUp= false;
+			}
+		}
+	}
+}
+
+// Color and size of projectiles and splashes fade with the energy
+static void updateEnergyBlend(float *const colors[4], float *size, const float *ratios,
+							int aliveCount, const ParticleKernelParams &params) {
+	const Float4 one(1.0f);
+	for(int component = 0; component < 4; ++component) {
+		float *color= colors[component];
+		const Float4 energyColor(params.color.ptr()[component]);
+		const Float4 noEnergyColor(params.colorNoEnergy.ptr()[component]);
+		for(int i = 0; i < aliveCount; i += ParticlePool::kernelWidth) {
+			Float4 ratio= Float4::load(ratios + i);
+			(energyColor * ratio + noEnergyColor * (one - ratio)).store(color + i);
+		}
+	}
+
+	const Float4 energySize(params.size);
+	const Float4 noEnergySize(params.sizeNoEnergy);
+	for(int i = 0; i < aliveCount; i += ParticlePool::kernelWidth) {
+		Float4 ratio= Float4::load(ratios + i);
+		(energySize * ratio + noEnergySize * (one - ratio)).truncateDecimal6().store(size + i);
+	}
+}
+
+// ProjectileParticleSystem::updateParticle
+void ParticlePool::updateProjectile(int aliveCount, const ParticleKernelParams &params) {
+	if(aliveCount <= 0) {
+		return;
+	}
+	float *ratios= &energyRatios[0];
+	const Float4 maxEnergy(static_cast<float>(params.maxEnergy));
+	for(int i = 0; i < aliveCount; i += kernelWidth) {
+		clampUnit(Float4::loadInts(&energies[i]) / maxEnergy).truncateDecimal6().store(ratios + i);
+	}
+
+	for(int axis = 0; axis < 3; ++axis) {
+		float *pos= getValues(Attribute(paPosX + axis));
+		float *lastPos= getValues(Attribute(paLastPosX + axis));
+		float *speed= getValues(Attribute(paSpeedX + axis));
+		const float *accel= getValues(Attribute(paAccelX + axis));
+
+		for(int i = 0; i < aliveCount; i += kernelWidth) {
+			Float4 particleSpeed= Float4::load(speed + i);
+			(Float4::load(lastPos + i) + particleSpeed).truncateDecimal6().store(lastPos + i);
+			(Float4::load(pos + i) + particleSpeed).truncateDecimal6().store(pos + i);
+			(particleSpeed + Float4::load(accel + i)).truncateDecimal6().store(speed + i);
+		}
+	}
+
+	float *colors[4] = { getValues(paColorR), getValues(paColorG), getValues(paColorB), getValues(paColorA) };
+	updateEnergyBlend(colors, getValues(paSize), ratios, aliveCount, params);
+
+	for(int i = 0; i < aliveCount; ++i) {
+		energies[i]--;
+	}
+}
+
+// SplashParticleSystem::updateParticle
+void ParticlePool::updateSplash(int aliveCount, const ParticleKernelParams &params) {
+	if(aliveCount <= 0) {
+		return;
+	}
+	float *ratios= &energyRatios[0];
+	const Float4 maxEnergy(static_cast<float>(params.maxEnergy));
+	for(int i = 0; i < aliveCount; i += kernelWidth) {
+		clampUnit(Float4::loadInts(&energies[i]) / maxEnergy).store(ratios + i);
+	}
+
+	const float *speedUpRelative= getValues(paSpeedUpRelative);
+	const Float4 one(1.0f);
+	for(int axis = 0; axis < 3; ++axis) {
+		float *pos= getValues(Attribute(paPosX + axis));
+		float *lastPos= getValues(Attribute(paLastPosX + axis));
+		float *speed= getValues(Attribute(paSpeedX + axis));
+		const float *accel= getValues(Attribute(paAccelX + axis));
+		const float *speedUpConstant= getValues(Attribute(paSpeedUpConstantX + axis));
+
+		for(int i = 0; i < aliveCount; i += kernelWidth) {
+			Float4 particlePos= Float4::load(pos + i);
+			Float4 particleSpeed= Float4::load(speed + i);
+			particlePos.store(lastPos + i);
+			(particlePos + particleSpeed).truncateDecimal6().store(pos + i);
+
+			particleSpeed= particleSpeed + Float4::load(speedUpConstant + i);
+			particleSpeed= particleSpeed * (one + Float4::load(speedUpRelative + i));
+			particleSpeed= particleSpeed + Float4::load(accel + i);
+			particleSpeed.truncateDecimal6().store(speed + i);
+		}
+	}
+
+	for(int i = 0; i < aliveCount; ++i) {
+		energies[i]--;
+	}
+
+	float *colors[4] = { getValues(paColorR), getValues(paColorG), getValues(paColorB), getValues(paColorA) };
+	updateEnergyBlend(colors, getValues(paSize), ratios, aliveCount, params);
+}
+
+int ParticlePool::killNoEnergy(int aliveCount) {
+	for(int i = 0; i < aliveCount;) {
+		// whole blocks of living particles are skipped at once
+		if(i + kernelWidth <= aliveCount && anyNoEnergy(&energies[i]) == false) {
+			i += kernelWidth;
+		}
+		else if(energies[i] <= 0) {
+			aliveCount--;
+			if(i < aliveCount) {
+				copy(aliveCount, i);
+			}
+		}
+		else {
+			++i;
+		}
+	}
+	return aliveCount;
+}
+
+int ParticlePool::killBelowGround(int aliveCount) {
+	const float *posY= getValues(paPosY);
+	for(int i = 0; i < aliveCount;) {
+		if(i + kernelWidth <= aliveCount && anyBelowGround(posY + i) == false) {
+			i += kernelWidth;
+		}
+		else if(posY[i] < 0) {
+			aliveCount--;
+			if(i < aliveCount) {
+				copy(aliveCount, i);
+			}
+		}
+		else {
+			++i;
+		}
+	}
+	return aliveCount;
+}
+
+bool ParticlePool::isSimdSupported() {
+#ifdef PARTICLE_POOL_SSE2
+	return true;
+#else
+	return false;
+#endif
+}
+
+}}//end namespace
@@ -26,6 +26,12 @@
 #include <setjmp.h>
 //#include <memory>
 #include "opengl.h"
+
+#if defined(__SSE2__) || defined(_M_X64) || defined(_M_AMD64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+  #define PIXMAP_SPLAT_SSE2
+  #include <emmintrin.h>
+#endif
+
 #include "leak_dumper.h"
 
 using namespace Shared::Util;
@@ -1298,20 +1304,16 @@ float splatDist(Vec2i a, Vec2i b){
 	return (max(abs(a.x-b.x),abs(a.y- b.y)) + 3.f*a.dist(b))/4.f;
 }
 
-void Pixmap2D::splat(const Pixmap2D *leftUp, const Pixmap2D *rightUp, const Pixmap2D *leftDown, const Pixmap2D *rightDown){
-
-	RandomGen random;
+// =====================================================
+//	class PixmapSplatWeights
+// =====================================================
 
-	assert(components==3 || components==4);
+PixmapSplatWeights::PixmapSplatWeights(int w, int h) {
+	this->w= w;
+	this->h= h;
+	weights.resize(max(1, w * h * valuesPerPixel));
 
-	if(
-		!doDimensionsAgree(leftUp) ||
-		!doDimensionsAgree(rightUp) ||
-		!doDimensionsAgree(leftDown) ||
-		!doDimensionsAgree(rightDown))
-	{
-		throw megaglest_runtime_error("Pixmap2D::splat: pixmap dimensions don't agree");
-	}
+	RandomGen random;
 
 	for(int i=0; i<w; ++i){
 		for(int j=0; j<h; ++j){
@@ -1338,14 +1340,85 @@ void Pixmap2D::splat(const Pixmap2D *leftUp, const Pixmap2D *rightUp, const Pixm
 
 			float total= lu+ru+ld+rd;
 
-			Vec4f pix= (leftUp->getPixel4f(i, j)*lu+
-				rightUp->getPixel4f(i, j)*ru+
-				leftDown->getPixel4f(i, j)*ld+
-				rightDown->getPixel4f(i, j)*rd)*(1.0f/total);
+			float *weight= &weights[(w * j + i) * valuesPerPixel];
+			weight[0]= lu;
+			weight[1]= ru;
+			weight[2]= ld;
+			weight[3]= rd;
+			weight[4]= 1.0f/total;
+		}
+	}
+}
+
+void Pixmap2D::splat(const Pixmap2D *leftUp, const Pixmap2D *rightUp, const Pixmap2D *leftDown, const Pixmap2D *rightDown){
+	PixmapSplatWeights splatWeights(w, h);
+	splat(leftUp, rightUp, leftDown, rightDown, splatWeights);
+}
 
-			setPixel(i, j, pix);
+// Corner pixel as four floats, components a pixmap doesn't have are 0
+static inline void getSplatPixel(const uint8 *pixel, int components, int32 *value) {
+	value[0]= value[1]= value[2]= value[3]= 0;
+	for(int i = 0; i < components && i < 4; ++i) {
+		value[i]= pixel[i];
+	}
+}
+
+void Pixmap2D::splat(const Pixmap2D *leftUp, const Pixmap2D *rightUp, const Pixmap2D *leftDown, const Pixmap2D *rightDown,
+					const PixmapSplatWeights &splatWeights){
+
+	assert(components==3 || components==4);
+
+	if(
+		!doDimensionsAgree(leftUp) ||
+		!doDimensionsAgree(rightUp) ||
+		!doDimensionsAgree(leftDown) ||
+		!doDimensionsAgree(rightDown) ||
+		splatWeights.getW() != w ||
+		splatWeights.getH() != h)
+	{
+		throw megaglest_runtime_error("Pixmap2D::splat: pixmap dimensions don't agree");
+	}
+
+	const Pixmap2D *corners[4]= { leftUp, rightUp, leftDown, rightDown };
+	const float *weights= splatWeights.getWeights();
+
+	// Same operations as blending getPixel4f values with Vec4f, with
+	// the four components in the lanes of one register
+	for(int pixel = 0; pixel < w * h; ++pixel) {
+		const float *weight= &weights[pixel * PixmapSplatWeights::valuesPerPixel];
+		int32 values[4][4];
+		for(int corner = 0; corner < 4; ++corner) {
+			int cornerComponents= corners[corner]->getComponents();
+			getSplatPixel(&corners[corner]->getPixels()[pixel * cornerComponents], cornerComponents, values[corner]);
+		}
+
+		int32 result[4];
+#ifdef PIXMAP_SPLAT_SSE2
+		const __m128 maxValue= _mm_set1_ps(255.f);
+		__m128 sum= _mm_setzero_ps();
+		for(int corner = 0; corner < 4; ++corner) {
+			__m128 value= _mm_div_ps(_mm_cvtepi32_ps(_mm_loadu_si128(reinterpret_cast<const __m128i *>(values[corner]))), maxValue);
+			value= _mm_mul_ps(value, _mm_set1_ps(weight[corner]));
+			sum= (corner == 0 ? value : _mm_add_ps(sum, value));
+		}
+		sum= _mm_mul_ps(_mm_mul_ps(sum, _mm_set1_ps(weight[4])), maxValue);
+		_mm_storeu_si128(reinterpret_cast<__m128i *>(result), _mm_cvttps_epi32(sum));
+#else
+		for(int i = 0; i < 4; ++i) {
+			float sum= 0;
+			for(int corner = 0; corner < 4; ++corner) {
+				float value= (values[corner][i] / 255.f) * weight[corner];
+				sum= (corner == 0 ? value : sum + value);
+			}
+			result[i]= static_cast<int32>((sum * weight[4]) * 255.f);
+		}
+#endif
+		uint8 *target= &pixels[pixel * components];
+		for(int i = 0; i < components && i < 4; ++i) {
+			target[i]= static_cast<uint8>(result[i]);
 		}
 	}
+	CalculatePixelsCRC(pixels,getPixelByteCount(), crc);
 }
 
 void Pixmap2D::lerp(float t, const Pixmap2D *pixmap1, const Pixmap2D *pixmap2){
@@ -0,0 +1,198 @@
+// ==============================================================
+//	This file is part of MegaGlest Shared Library (www.megaglest.org)
+//
+//	Copyright (C) 2026 The MegaGlest Team
+//
+//	You can redistribute this code and/or modify it under
+//	the terms of the GNU General Public License as published
+//	by the Free Software Foundation; either version 2 of the
+//	License, or (at your option) any later version
+// ==============================================================
+
+#ifdef WIN32
+  #include <windows.h>
+#else
+  #include <sys/types.h>
+  #include <sys/stat.h>
+  #include <sys/mman.h>
+  #include <fcntl.h>
+  #include <unistd.h>
+#endif
+
+#include "mapped_file.h"
+
+#include <cstdio>
+#include "thread.h"
+#include "platform_util.h"
+#include "conversion.h"
+#include "util.h"
+#include "leak_dumper.h"
+
+using namespace Shared::Platform;
+using namespace Shared::Util;
+
+namespace Shared { namespace PlatformCommon {
+
+// =====================================================
+//	class MappedFile
+// =====================================================
+
+MappedFile::MappedFile(const string &path) {
+	this->path= path;
+	data= NULL;
+	size= 0;
+	mapped= false;
+	mutexRefCount= new Mutex(CODE_AT_LINE);
+	refCount= 1;
+}
+
+MappedFile::~MappedFile() {
+	if(mapped == true) {
+#ifdef WIN32
+		UnmapViewOfFile(data);
+#else
+		munmap(data, (size_t)size);
+#endif
+	}
+	else {
+		delete [] data;
+	}
+	data= NULL;
+
+	delete mutexRefCount;
+	mutexRefCount= NULL;
+}
+
+MappedFile *MappedFile::open(const string &path) {
+	MappedFile *file= new MappedFile(path);
+	if(file->map() == false && file->read() == false) {
+		delete file;
+		return NULL;
+	}
+
+	if(SystemFlags::VERBOSE_MODE_ENABLED) printf("In [%s::%s Line: %d] [%s] size = %lld mapped = %d\n",extractFileFromDirectoryPath(__FILE__).c_str(),__FUNCTION__,__LINE__,path.c_str(),(long long)file->size,file->mapped);
+	return file;
+}
+
+// Files we may write to are read instead: the game or the mod downloader
+// could truncate one while it is mapped, which raises SIGBUS, and on
+// windows a mapped file can not be replaced at all. Installed data files
+// are only ever replaced by a new file, the mapping keeps the old one.
+bool MappedFile::map() {
+#ifdef WIN32
+	HANDLE writeCheck= CreateFileW(utf8_decode(path).c_str(), GENERIC_WRITE,
+							FILE_SHARE_READ | FILE_SHARE_WRITE | FILE_SHARE_DELETE,
+							NULL, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, NULL);
+	if(writeCheck != INVALID_HANDLE_VALUE) {
+		CloseHandle(writeCheck);
+		return false;
+	}
+	else if(GetLastError() != ERROR_ACCESS_DENIED) {
+		return false;
+	}
+
+	HANDLE file= CreateFileW(utf8_decode(path).c_str(), GENERIC_READ, FILE_SHARE_READ,
+							NULL, OPEN_EXISTING, FILE_FLAG_SEQUENTIAL_SCAN, NULL);
+	if(file == INVALID_HANDLE_VALUE) {
+		return false;
+	}
+	LARGE_INTEGER fileSize;
+	if(GetFileSizeEx(file, &fileSize) == FALSE || fileSize.QuadPart <= 0) {
+		CloseHandle(file);
+		return false;
+	}
+	HANDLE mapping= CreateFileMappingW(file, NULL, PAGE_WRITECOPY, 0, 0, NULL);
+	CloseHandle(file);
+	if(mapping == NULL) {
+		return false;
+	}
+	// the view keeps the mapping and the file open
+	void *view= MapViewOfFile(mapping, FILE_MAP_COPY, 0, 0, 0);
+	CloseHandle(mapping);
+	if(view == NULL) {
+		return false;
+	}
+	data= (uint8 *)view;
+	size= fileSize.QuadPart;
+#else
+	int fd= ::open(path.c_str(), O_RDONLY);
+	if(fd < 0) {
+		return false;
+	}
+	struct stat fileStat;
+	if(fstat(fd, &fileStat) != 0 || fileStat.st_size <= 0 || isWritable(fileStat) == true) {
+		::close(fd);
+		return false;
+	}
+	// private and writable so loaders can fix byte order in place,
+	// pages nobody writes to stay shared with the file cache
+	void *view= mmap(NULL, (size_t)fileStat.st_size, PROT_READ | PROT_WRITE, MAP_PRIVATE, fd, 0);
+	::close(fd);
+	if(view == MAP_FAILED) {
+		return false;
+	}
+	data= (uint8 *)view;
+	size= fileStat.st_size;
+#endif
+	mapped= true;
+	return true;
+}
+
+#ifndef WIN32
+bool MappedFile::isWritable(const struct stat &fileStat) {
+	if(fileStat.st_uid == geteuid()) {
+		return (fileStat.st_mode & S_IWUSR) != 0;
+	}
+	if(fileStat.st_gid == getegid()) {
+		return (fileStat.st_mode & S_IWGRP) != 0;
+	}
+	return (fileStat.st_mode & S_IWOTH) != 0;
+}
+#endif
+
+bool MappedFile::read() {
+#ifdef WIN32
+	FILE *f= _wfopen(utf8_decode(path).c_str(), L"rb");
+#else
+	FILE *f= fopen(path.c_str(), "rb");
+#endif
+	if(f == NULL) {
+		return false;
+	}
+
+	bool result= false;
+	if(fseek(f, 0, SEEK_END) == 0) {
+		long fileSize= ftell(f);
+		if(fileSize >= 0 && fseek(f, 0, SEEK_SET) == 0) {
+			size= fileSize;
+			data= new uint8[fileSize > 0 ? fileSize : 1];
+			result= (fileSize == 0 || fread(data, (size_t)fileSize, 1, f) == 1);
+		}
+	}
+	fclose(f);
+
+	if(result == false) {
+		delete [] data;
+		data= NULL;
+		size= 0;
+	}
+	return result;
+}
+
+void MappedFile::addRef() {
+	MutexSafeWrapper safeMutex(mutexRefCount,string(__FILE__) + "_" + intToStr(__LINE__));
+	refCount++;
+}
+
+void MappedFile::release() {
+	MutexSafeWrapper safeMutex(mutexRefCount,string(__FILE__) + "_" + intToStr(__LINE__));
+	refCount--;
+	bool lastReference= (refCount <= 0);
+	safeMutex.ReleaseLock();
+
+	if(lastReference == true) {
+		delete this;
+	}
+}
+
+}}//end namespace
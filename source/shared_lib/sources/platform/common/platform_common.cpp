@@ -63,6 +63,7 @@
 #include "noimpl.h"
 
 #include "checksum.h"
+#include "checksum_index.h"
 #include "socket.h"
 #include <algorithm>
 #include <map>
@@ -996,6 +997,9 @@ uint32 getFolderTreeContentsCheckSumRecursively(vector<string> paths, string pat
 	crcTreeCache[cacheKey] = result;
 	writeCachedFileCRCValue(crcCacheFile, crcTreeCache[cacheKey],getCRCCacheFileName(cacheKeys));
 	//}
+	if(recursiveChecksum == NULL) {
+		FileCRCIndex::save();
+	}
 	return result;
 }
 
@@ -1155,6 +1159,7 @@ uint32 getFolderTreeContentsCheckSumRecursively(const string &path, const string
 		if(SystemFlags::getSystemSettingType(SystemFlags::debugSystem).enabled) SystemFlags::OutputDebug(SystemFlags::debugSystem,"In [%s::%s] scanning [%s] ending checksum = %d for cacheKey [%s] fileMatchCount = %d, fileLoopCount = %d\n",__FILE__,__FUNCTION__,path.c_str(),crcTreeCache[cacheKey],cacheKey.c_str(),fileMatchCount,fileLoopCount);
 		writeCachedFileCRCValue(crcCacheFile, crcTreeCache[cacheKey],getCRCCacheFileName(cacheKeys));
 		//}
+		FileCRCIndex::save();
 
 		return result;
 	}
@@ -1220,6 +1225,7 @@ vector<std::pair<string,uint32> > getFolderTreeContentsCheckSumListRecursively(v
 
 	if(topLevelCaller == true) {
 		if(SystemFlags::getSystemSettingType(SystemFlags::debugSystem).enabled) SystemFlags::OutputDebug(SystemFlags::debugSystem,"In [%s::%s Line: %d] EXITING TOP LEVEL RECURSION, checksumFiles.size() = %d\n",__FILE__,__FUNCTION__,__LINE__,checksumFiles.size());
+		FileCRCIndex::save();
 	}
 
 	crcTreeCache[cacheKey] = checksumFiles;
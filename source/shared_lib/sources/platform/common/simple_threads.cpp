@@ -17,6 +17,7 @@
 #include "conversion.h"
 #include "platform_util.h"
 #include "cache_manager.h"
+#include "zone_profiler.h"
 #include "leak_dumper.h"
 
 using namespace std;
@@ -105,6 +106,7 @@ void FileCRCPreCacheThread::execute() {
         }
 
         bool threadControllerMode = (workerThreadTechPaths.size() == 0);
+        ZoneProfiler::setThreadName(threadControllerMode == true ? "CRC controller" : "CRC worker");
 
         if(SystemFlags::VERBOSE_MODE_ENABLED) printf("FILE CRC PreCache thread is running threadControllerMode = %d\n",threadControllerMode);
         if(SystemFlags::getSystemSettingType(SystemFlags::debugSystem).enabled) SystemFlags::OutputDebug(SystemFlags::debugSystem,"FILE CRC PreCache thread is running threadControllerMode = %d\n",threadControllerMode);
@@ -306,6 +308,7 @@ void FileCRCPreCacheThread::execute() {
 							}
 							if(SystemFlags::VERBOSE_MODE_ENABLED) printf("\t\tStart Processing CRC for techName [%s]\n",techName.c_str());
 
+							PROFILE_ZONE("FileCRCPreCacheThread::techCRC");
 							uint32 techCRC = getFolderTreeContentsCheckSumRecursively(techDataPaths, string("/") + techName + string("/*"), ".xml", NULL, true);
 
 							//if(SystemFlags::VERBOSE_MODE_ENABLED) printf("In [%s::%s Line: %d] cached CRC value for Tech [%s] is [%d] took %.3f seconds.\n",extractFileFromDirectoryPath(__FILE__).c_str(),__FUNCTION__,__LINE__,techName.c_str(),techCRC,difftime(time(NULL),elapsedTime));
@@ -631,46 +634,29 @@ bool SimpleTaskThread::getTaskSignalled() {
 
 // -------------------------------------------------
 
-LogFileThread::LogFileThread() : BaseThread(), mutexLogList(new Mutex(CODE_AT_LINE)) {
+LogFileThread::LogFileThread() : BaseThread(), logRing(LOG_RING_CAPACITY) {
 	uniqueID = "LogFileThread";
-    logList.clear();
-    lastSaveToDisk = time(NULL);
-    static string mutexOwnerId = CODE_AT_LINE;
-    mutexLogList->setOwnerId(mutexOwnerId);
 }
 
 LogFileThread::~LogFileThread() {
-
-	delete mutexLogList;
-	mutexLogList = NULL;
-
 	if(SystemFlags::VERBOSE_MODE_ENABLED) printf("#1 In [%s::%s Line: %d] LogFile thread is deleting\n",extractFileFromDirectoryPath(__FILE__).c_str(),__FUNCTION__,__LINE__);
 }
 
 void LogFileThread::addLogEntry(SystemFlags::DebugType type, string logEntry) {
-	static string mutexOwnerId = CODE_AT_LINE;
-    MutexSafeWrapper safeMutex(mutexLogList,mutexOwnerId);
-    mutexLogList->setOwnerId(mutexOwnerId);
 	LogFileEntry entry;
 	entry.type = type;
-	entry.entry = logEntry;
+	entry.entry.swap(logEntry);
 	entry.entryDateTime = time(NULL);
-	logList.push_back(entry);
 
-    //if(logList.size() >= 750000) {
-    //    saveToDisk(false,true);
-    //}
-}
-
-bool LogFileThread::checkSaveCurrentLogBufferToDisk() {
-    bool ret = false;
-    if(difftime(time(NULL),lastSaveToDisk) >= 5.0 ||
-		(difftime(time(NULL), lastSaveToDisk) >= 2.0 &&
-         LogFileThread::getLogEntryBufferCount() >= 1000000)) {
-        lastSaveToDisk = time(NULL);
-        ret = true;
-    }
-    return ret;
+	// A full ring means the writer is behind, wait for it rather than
+	// dropping entries. Once it has stopped write the entry ourselves
+	for(;logRing.tryPush(entry) == false;) {
+		if(getRunningStatus() == false || getQuitStatus() == true) {
+			SystemFlags::logDebugEntry(entry.type, entry.entry, entry.entryDateTime);
+			return;
+		}
+		sleep(1);
+	}
 }
 
 void LogFileThread::execute() {
@@ -692,10 +678,7 @@ void LogFileThread::execute() {
         try	{
         	ExecutingTaskSafeWrapper safeExecutingTaskMutex(this);
             for(;this->getQuitStatus() == false;) {
-                while(this->getQuitStatus() == false &&
-                	  checkSaveCurrentLogBufferToDisk() == true) {
-                    saveToDisk(false,false);
-                }
+                saveToDisk();
                 if(this->getQuitStatus() == false) {
                     sleep(25);
                 }
@@ -703,7 +686,7 @@ void LogFileThread::execute() {
 
             // Ensure remaining entryies are logged to disk on shutdown
             if(SystemFlags::VERBOSE_MODE_ENABLED) printf("In [%s::%s Line: %d]\n",extractFileFromDirectoryPath(__FILE__).c_str(),__FUNCTION__,__LINE__);
-            saveToDisk(true,false);
+            saveToDisk();
             if(SystemFlags::VERBOSE_MODE_ENABLED) printf("In [%s::%s Line: %d]\n",extractFileFromDirectoryPath(__FILE__).c_str(),__FUNCTION__,__LINE__);
         }
         catch(const exception &ex) {
@@ -728,12 +711,7 @@ void LogFileThread::execute() {
 }
 
 std::size_t LogFileThread::getLogEntryBufferCount() {
-	static string mutexOwnerId = CODE_AT_LINE;
-    MutexSafeWrapper safeMutex(mutexLogList,mutexOwnerId);
-    mutexLogList->setOwnerId(mutexOwnerId);
-    std::size_t logCount = logList.size();
-    safeMutex.ReleaseLock();
-    return logCount;
+	return logRing.size();
 }
 
 bool LogFileThread::canShutdown(bool deleteSelfIfShutdownDelayed) {
@@ -747,45 +725,12 @@ bool LogFileThread::canShutdown(bool deleteSelfIfShutdownDelayed) {
 	return ret;
 }
 
-void LogFileThread::saveToDisk(bool forceSaveAll,bool logListAlreadyLocked) {
-	static string mutexOwnerId = CODE_AT_LINE;
-    MutexSafeWrapper safeMutex(NULL,mutexOwnerId);
-    if(logListAlreadyLocked == false) {
-        safeMutex.setMutex(mutexLogList);
-        mutexLogList->setOwnerId(mutexOwnerId);
-    }
-
-    std::size_t logCount = logList.size();
-    if(logCount > 0) {
-        vector<LogFileEntry> tempLogList = logList;
-        safeMutex.ReleaseLock(true);
-
-        logCount = tempLogList.size();
-        //if(forceSaveAll == false) {
-        //    logCount = min(logCount,(std::size_t)2000000);
-        //}
-
-        if(logCount > 0) {
-            for(unsigned int i = 0; i < logCount; ++i) {
-                LogFileEntry &entry = tempLogList[i];
-                SystemFlags::logDebugEntry(entry.type, entry.entry, entry.entryDateTime);
-            }
-
-            safeMutex.Lock();
-            if(logList.size() > 0) {
-				if(logList.size() < logCount) {
-					char szBuf[8096]="";
-					snprintf(szBuf,8096,"logList.size() <= logCount [%lld][%lld]",(long long int)logList.size(),(long long int)logCount);
-					throw megaglest_runtime_error(szBuf);
-				}
-				logList.erase(logList.begin(),logList.begin() + logCount);
-            }
-            safeMutex.ReleaseLock();
-        }
-    }
-    else {
-        safeMutex.ReleaseLock();
-    }
+// Only ever called on the logger thread, the single consumer of logRing
+void LogFileThread::saveToDisk() {
+	LogFileEntry entry;
+	while(logRing.tryPop(entry) == true) {
+		SystemFlags::logDebugEntry(entry.type, entry.entry, entry.entryDateTime);
+	}
 }
 
 }}//end namespace
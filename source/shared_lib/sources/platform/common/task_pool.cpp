@@ -0,0 +1,252 @@
+// ==============================================================
+//	This file is part of MegaGlest Shared Library (www.megaglest.org)
+//
+//	Copyright (C) 2026 The MegaGlest Team
+//
+//	You can redistribute this code and/or modify it under
+//	the terms of the GNU General Public License as published
+//	by the Free Software Foundation; either version 2 of the
+//	License, or (at your option) any later version
+// ==============================================================
+
+#include "task_pool.h"
+#include "platform_common.h"
+#include "util.h"
+#include "conversion.h"
+#include "platform_util.h"
+#include "zone_profiler.h"
+#include <SDL.h>
+
+#if defined(_MSC_VER)
+  #define TASK_POOL_THREAD_LOCAL __declspec(thread)
+#else
+  #define TASK_POOL_THREAD_LOCAL __thread
+#endif
+
+using namespace Shared::Util;
+
+namespace Shared { namespace PlatformCommon {
+
+static TASK_POOL_THREAD_LOCAL int currentWorkerIndex = -1;
+
+// =====================================================
+//	class TaskPoolWorkerThread
+// =====================================================
+
+TaskPoolWorkerThread::TaskPoolWorkerThread(WorkStealingTaskPool *pool, int workerIndex) : BaseThread() {
+	this->pool = pool;
+	this->workerIndex = workerIndex;
+	this->mutexTasks = new Mutex(CODE_AT_LINE);
+	uniqueID = "TaskPoolWorkerThread";
+}
+
+TaskPoolWorkerThread::~TaskPoolWorkerThread() {
+	this->pool = NULL;
+	delete mutexTasks;
+	mutexTasks = NULL;
+}
+
+void TaskPoolWorkerThread::setQuitStatus(bool value) {
+	BaseThread::setQuitStatus(value);
+	if(value == true) {
+		signalWork();
+	}
+}
+
+bool TaskPoolWorkerThread::canShutdown(bool deleteSelfIfShutdownDelayed) {
+	bool ret = (getExecutingTask() == false);
+	if(ret == false && deleteSelfIfShutdownDelayed == true) {
+		setDeleteSelfOnExecutionDone(deleteSelfIfShutdownDelayed);
+		deleteSelfIfRequired();
+		signalQuit();
+	}
+
+	return ret;
+}
+
+void TaskPoolWorkerThread::signalWork() {
+	semTaskSignalled.signal();
+}
+
+void TaskPoolWorkerThread::addTasks(int firstTaskIndex, int lastTaskIndex) {
+	static string mutexOwnerId = CODE_AT_LINE;
+	MutexSafeWrapper safeMutex(mutexTasks,mutexOwnerId);
+	for(int taskIndex = firstTaskIndex; taskIndex < lastTaskIndex; ++taskIndex) {
+		tasks.push_back(taskIndex);
+	}
+}
+
+bool TaskPoolWorkerThread::popTask(int &taskIndex) {
+	static string mutexOwnerId = CODE_AT_LINE;
+	MutexSafeWrapper safeMutex(mutexTasks,mutexOwnerId);
+	if(tasks.empty() == true) {
+		return false;
+	}
+	taskIndex = tasks.back();
+	tasks.pop_back();
+	return true;
+}
+
+bool TaskPoolWorkerThread::stealTask(int &taskIndex) {
+	static string mutexOwnerId = CODE_AT_LINE;
+	MutexSafeWrapper safeMutex(mutexTasks,mutexOwnerId);
+	if(tasks.empty() == true) {
+		return false;
+	}
+	taskIndex = tasks.front();
+	tasks.pop_front();
+	return true;
+}
+
+void TaskPoolWorkerThread::execute() {
+	RunningStatusSafeWrapper runningStatus(this);
+	try {
+		if(SystemFlags::VERBOSE_MODE_ENABLED) printf("In [%s::%s Line: %d] ****************** STARTING worker thread this = %p\n",extractFileFromDirectoryPath(__FILE__).c_str(),__FUNCTION__,__LINE__,this);
+		ZoneProfiler::setThreadName("Task pool worker " + intToStr(workerIndex));
+		currentWorkerIndex = workerIndex;
+
+		for(;this->pool != NULL;) {
+			semTaskSignalled.waitTillSignalled();
+
+			if(getQuitStatus() == true) {
+				break;
+			}
+
+			ExecutingTaskSafeWrapper safeExecutingTaskMutex(this);
+			PROFILE_ZONE("TaskPoolWorkerThread::runTasks");
+			for(;pool->runNextTask(workerIndex) == true;) {
+			}
+		}
+
+		if(SystemFlags::VERBOSE_MODE_ENABLED) printf("In [%s::%s Line: %d] ****************** ENDING worker thread this = %p\n",extractFileFromDirectoryPath(__FILE__).c_str(),__FUNCTION__,__LINE__,this);
+	}
+	catch(const exception &ex) {
+		SystemFlags::OutputDebug(SystemFlags::debugError,"In [%s::%s Line: %d] Error [%s]\n",extractFileFromDirectoryPath(__FILE__).c_str(),__FUNCTION__,__LINE__,ex.what());
+		throw megaglest_runtime_error(ex.what());
+	}
+}
+
+// =====================================================
+//	class WorkStealingTaskPool
+// =====================================================
+
+WorkStealingTaskPool::WorkStealingTaskPool(int workerCount) {
+	mutexRunTasks = new Mutex(CODE_AT_LINE);
+	mutexProgress = new Mutex(CODE_AT_LINE);
+	callback = NULL;
+	tasksRemaining = 0;
+
+	if(workerCount < 1) {
+		workerCount = getCoreCount();
+	}
+	for(int workerIndex = 0; workerIndex < workerCount; ++workerIndex) {
+		TaskPoolWorkerThread *worker = new TaskPoolWorkerThread(this, workerIndex);
+		worker->setUniqueID(string(extractFileFromDirectoryPath(__FILE__).c_str()) + string("_") + intToStr(workerIndex));
+		workers.push_back(worker);
+	}
+	for(unsigned int workerIndex = 0; workerIndex < workers.size(); ++workerIndex) {
+		workers[workerIndex]->start();
+	}
+}
+
+WorkStealingTaskPool::~WorkStealingTaskPool() {
+	for(unsigned int workerIndex = 0; workerIndex < workers.size(); ++workerIndex) {
+		TaskPoolWorkerThread *worker = workers[workerIndex];
+		worker->signalQuit();
+		if(worker->shutdownAndWait() == true) {
+			delete worker;
+		}
+	}
+	workers.clear();
+
+	delete mutexProgress;
+	mutexProgress = NULL;
+	delete mutexRunTasks;
+	mutexRunTasks = NULL;
+}
+
+int WorkStealingTaskPool::getCurrentWorkerIndex() {
+	return currentWorkerIndex;
+}
+
+int WorkStealingTaskPool::getCoreCount() {
+	int coreCount = SDL_GetCPUCount();
+	return (coreCount > 0 ? coreCount : 1);
+}
+
+void WorkStealingTaskPool::runTask(int taskIndex, int workerIndex) {
+	try {
+		callback->runPoolTask(taskIndex, workerIndex);
+	}
+	catch(const exception &ex) {
+		SystemFlags::OutputDebug(SystemFlags::debugError,"In [%s::%s Line: %d] Error [%s]\n",extractFileFromDirectoryPath(__FILE__).c_str(),__FUNCTION__,__LINE__,ex.what());
+
+		static string mutexOwnerId = CODE_AT_LINE;
+		MutexSafeWrapper safeMutex(mutexProgress,mutexOwnerId);
+		if(taskError == "") {
+			taskError = ex.what();
+		}
+	}
+
+	static string mutexOwnerId = CODE_AT_LINE;
+	MutexSafeWrapper safeMutex(mutexProgress,mutexOwnerId);
+	tasksRemaining--;
+	if(tasksRemaining == 0) {
+		semTasksCompleted.signal();
+	}
+}
+
+bool WorkStealingTaskPool::runNextTask(int workerIndex) {
+	int taskIndex = -1;
+	bool foundTask = workers[workerIndex]->popTask(taskIndex);
+
+	const int workerCount = (int)workers.size();
+	for(int offset = 1; offset < workerCount && foundTask == false; ++offset) {
+		foundTask = workers[(workerIndex + offset) % workerCount]->stealTask(taskIndex);
+	}
+
+	if(foundTask == true) {
+		runTask(taskIndex, workerIndex);
+	}
+	return foundTask;
+}
+
+void WorkStealingTaskPool::runTasks(TaskPoolCallbackInterface *callback, int taskCount) {
+	if(callback == NULL || taskCount <= 0) {
+		return;
+	}
+
+	static string mutexOwnerId = CODE_AT_LINE;
+	MutexSafeWrapper safeMutexRun(mutexRunTasks,mutexOwnerId);
+
+	this->callback = callback;
+	this->tasksRemaining = taskCount;
+	this->taskError = "";
+
+	if(workers.empty() == true) {
+		for(int taskIndex = 0; taskIndex < taskCount; ++taskIndex) {
+			runTask(taskIndex, 0);
+		}
+	}
+	else {
+		// hand every worker a contiguous slice, stealing evens out the rest
+		const int workerCount = (int)workers.size();
+		for(int workerIndex = 0; workerIndex < workerCount; ++workerIndex) {
+			int firstTaskIndex = (int)((int64)taskCount * workerIndex / workerCount);
+			int lastTaskIndex = (int)((int64)taskCount * (workerIndex + 1) / workerCount);
+			workers[workerIndex]->addTasks(firstTaskIndex, lastTaskIndex);
+		}
+		for(int workerIndex = 0; workerIndex < workerCount; ++workerIndex) {
+			workers[workerIndex]->signalWork();
+		}
+
+		semTasksCompleted.waitTillSignalled();
+	}
+
+	this->callback = NULL;
+	if(taskError != "") {
+		throw megaglest_runtime_error(taskError);
+	}
+}
+
+}}//end namespace
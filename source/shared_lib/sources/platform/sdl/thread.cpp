@@ -17,6 +17,7 @@
 #include "platform_util.h"
 #include "platform_common.h"
 #include "base_thread.h"
+#include "zone_profiler.h"
 #include "time.h"
 
 using namespace std;
@@ -323,7 +324,11 @@ int Thread::beginExecution(void* data) {
 		thread->currentState = thrsExecuting;
 		safeMutex.ReleaseLock(true);
 
+		if(base_thread != NULL) {
+			Shared::Util::ZoneProfiler::setThreadName(base_thread->getUniqueID());
+		}
 		thread->execute();
+		Shared::Util::ZoneProfiler::releaseThreadBuffer();
 
 		safeMutex.Lock();
 		thread->currentState = thrsExecuted;
@@ -948,4 +953,64 @@ bool MasterSlaveThreadController::waitTillSlavesTrigger(int waitMilliseconds) {
 	return result;
 }
 
+// =====================================================
+//	class CompletionLatch
+// =====================================================
+
+CompletionLatch::CompletionLatch() {
+	mutex = new Mutex(CODE_AT_LINE);
+	trigger = new Trigger(mutex);
+	count = 0;
+	generation = 0;
+}
+
+CompletionLatch::~CompletionLatch() {
+	delete trigger;
+	trigger = NULL;
+	delete mutex;
+	mutex = NULL;
+}
+
+int CompletionLatch::reset(int count) {
+	MutexSafeWrapper safeMutex(mutex,CODE_AT_LINE);
+	this->count = (count > 0 ? count : 0);
+	this->generation = (this->generation + 1) & 0x7FFFFFFF;
+	return this->generation;
+}
+
+void CompletionLatch::countDown(int generation) {
+	MutexSafeWrapper safeMutex(mutex,CODE_AT_LINE);
+	if(generation != this->generation || this->count <= 0) {
+		return;
+	}
+	this->count--;
+	if(this->count == 0) {
+		trigger->signal(true);
+	}
+}
+
+int CompletionLatch::getCount() {
+	MutexSafeWrapper safeMutex(mutex,CODE_AT_LINE);
+	return this->count;
+}
+
+bool CompletionLatch::waitTillCompleted(int waitMilliseconds) {
+	Chrono chrono(true);
+
+	MutexSafeWrapper safeMutex(mutex,CODE_AT_LINE);
+	for(;this->count > 0;) {
+		if(waitMilliseconds < 0) {
+			trigger->waitTillSignalled(mutex);
+		}
+		else {
+			int64 remainingMilliseconds = waitMilliseconds - chrono.getMillis();
+			if(remainingMilliseconds <= 0) {
+				return false;
+			}
+			trigger->waitTillSignalled(mutex,(int)remainingMilliseconds);
+		}
+	}
+	return true;
+}
+
 }}//end namespace
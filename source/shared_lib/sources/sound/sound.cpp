@@ -13,6 +13,7 @@
 
 #include <fstream>
 #include <stdexcept>
+#include "sound_cache.h"
 #include "util.h"
 #include "leak_dumper.h"
 
@@ -48,7 +49,7 @@ Sound::Sound() {
 // =====================================================
 
 StaticSound::StaticSound() {
-	samples= NULL;
+	data= NULL;
 	soundFileLoader = NULL;
 	fileName = "";
 }
@@ -58,9 +59,9 @@ StaticSound::~StaticSound() {
 }
 
 void StaticSound::close() {
-	if(samples != NULL) {
-		delete [] samples;
-		samples = NULL;
+	if(data != NULL) {
+		StaticSoundCache::getInstance().release(data);
+		data = NULL;
 	}
 
 	if(soundFileLoader!=NULL){
@@ -78,19 +79,20 @@ void StaticSound::load(const string &path) {
 	if(GlobalStaticFlags::getIsNonGraphicalModeEnabled() == true) {
 		return;
 	}
-	string ext = (path.empty() == false ? path.substr(path.find_last_of('.')+1) : "");
-	soundFileLoader= SoundFileLoaderFactory::getInstance()->newInstance(ext);
+	data= StaticSoundCache::getInstance().acquire(path, &info);
+}
 
-	if(soundFileLoader == NULL) {
-		throw megaglest_runtime_error("soundFileLoader == NULL");
+int8 *StaticSound::getSamples() const {
+	if(data == NULL) {
+		return NULL;
 	}
-	soundFileLoader->open(path, &info);
-	samples= new int8[info.getSize()];
-	soundFileLoader->read(samples, info.getSize());
-	soundFileLoader->close();
+	return StaticSoundCache::getInstance().getSamples(data);
+}
 
-	delete soundFileLoader;
-	soundFileLoader= NULL;
+void StaticSound::prefetch() const {
+	if(data != NULL) {
+		StaticSoundCache::getInstance().prefetch(data);
+	}
 }
 
 // =====================================================
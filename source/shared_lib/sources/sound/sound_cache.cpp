@@ -0,0 +1,383 @@
+// ==============================================================
+//	This file is part of MegaGlest Shared Library (www.megaglest.org)
+//
+//	Copyright (C) 2026 The MegaGlest Team
+//
+//	You can redistribute this code and/or modify it under
+//	the terms of the GNU General Public License as published
+//	by the Free Software Foundation; either version 2 of the
+//	License, or (at your option) any later version
+// ==============================================================
+
+#include "sound_cache.h"
+
+#include <algorithm>
+#include <stdexcept>
+#include "sound_file_loader.h"
+#include "checksum.h"
+#include "platform_common.h"
+#include "conversion.h"
+#include "util.h"
+#include "leak_dumper.h"
+
+using namespace Shared::Util;
+using namespace Shared::PlatformCommon;
+
+namespace Shared { namespace Sound {
+
+// =====================================================
+//	class StaticSoundData
+// =====================================================
+
+StaticSoundData::StaticSoundData(const string &path, uint32 crc, const SoundInfo &info) {
+	this->path= path;
+	this->crc= crc;
+	this->info= info;
+	samples= NULL;
+	refCount= 0;
+	lastUsed= 0;
+	decoding= false;
+	prefetchQueued= false;
+	decodeFailed= false;
+}
+
+StaticSoundData::~StaticSoundData() {
+	delete [] samples;
+	samples= NULL;
+}
+
+// =====================================================
+//	class StaticSoundCache
+// =====================================================
+
+StaticSoundCache::StaticSoundCache() {
+	mutex= new Mutex(CODE_AT_LINE);
+	prefetchThread= NULL;
+	memoryBudget= 0;
+	decodedBytes= 0;
+	useCount= 0;
+}
+
+StaticSoundCache::~StaticSoundCache() {
+	stopPrefetch();
+
+	for(ContentMap::iterator iterMap = contents.begin(); iterMap != contents.end(); ++iterMap) {
+		delete iterMap->second;
+	}
+	contents.clear();
+	paths.clear();
+
+	delete mutex;
+	mutex= NULL;
+}
+
+StaticSoundCache &StaticSoundCache::getInstance() {
+	// Never destroyed, sounds held by other singletons are released
+	// during static destruction
+	static StaticSoundCache *soundCache= new StaticSoundCache();
+	return *soundCache;
+}
+
+string StaticSoundCache::getCanonicalPath(const string &path) {
+	string result= path;
+	replaceAll(result, "\\", "/");
+	result= formatPath(result);
+	updatePathClimbingParts(result);
+	return result;
+}
+
+int8 *StaticSoundCache::decode(const string &path, uint32 size) {
+	string ext= (path.empty() == false ? path.substr(path.find_last_of('.')+1) : "");
+	SoundFileLoader *soundFileLoader= SoundFileLoaderFactory::getInstance()->newInstance(ext);
+	if(soundFileLoader == NULL) {
+		throw megaglest_runtime_error("soundFileLoader == NULL");
+	}
+
+	SoundInfo info;
+	int8 *samples= NULL;
+	try {
+		soundFileLoader->open(path, &info);
+		samples= new int8[size];
+		soundFileLoader->read(samples, size);
+		soundFileLoader->close();
+	}
+	catch(...) {
+		delete [] samples;
+		delete soundFileLoader;
+		throw;
+	}
+	delete soundFileLoader;
+
+	return samples;
+}
+
+StaticSoundData *StaticSoundCache::acquire(const string &path, SoundInfo *info) {
+	string canonicalPath= getCanonicalPath(path);
+
+	MutexSafeWrapper safeMutex(mutex,string(__FILE__) + "_" + intToStr(__LINE__));
+	PathMap::iterator iterFind= paths.find(canonicalPath);
+	if(iterFind != paths.end()) {
+		StaticSoundData *data= iterFind->second;
+		data->refCount++;
+		*info= data->info;
+		return data;
+	}
+	safeMutex.ReleaseLock();
+
+	// Only the header is read here, the samples when first played
+	string ext= (path.empty() == false ? path.substr(path.find_last_of('.')+1) : "");
+	SoundFileLoader *soundFileLoader= SoundFileLoaderFactory::getInstance()->newInstance(ext);
+	if(soundFileLoader == NULL) {
+		throw megaglest_runtime_error("soundFileLoader == NULL");
+	}
+	SoundInfo fileInfo;
+	try {
+		soundFileLoader->open(path, &fileInfo);
+		soundFileLoader->close();
+	}
+	catch(...) {
+		delete soundFileLoader;
+		throw;
+	}
+	delete soundFileLoader;
+
+	// Usually already known from the techtree crc
+	Checksum checksum;
+	checksum.addFile(path);
+	uint32 crc= checksum.getSum();
+
+	safeMutex.Lock();
+	StaticSoundData *data= NULL;
+	iterFind= paths.find(canonicalPath);
+	if(iterFind != paths.end()) {
+		data= iterFind->second;
+	}
+	else {
+		std::pair<uint32,uint32> contentKey(crc, fileInfo.getSize());
+		ContentMap::iterator iterContent= contents.find(contentKey);
+		if(iterContent != contents.end()) {
+			data= iterContent->second;
+		}
+		else {
+			data= new StaticSoundData(canonicalPath, crc, fileInfo);
+			contents[contentKey]= data;
+		}
+		paths[canonicalPath]= data;
+	}
+	data->refCount++;
+	*info= data->info;
+
+	if(SystemFlags::getSystemSettingType(SystemFlags::debugSound).enabled) SystemFlags::OutputDebug(SystemFlags::debugSound,"In [%s::%s Line: %d] path [%s] shares [%s] refCount = %d\n",extractFileFromDirectoryPath(__FILE__).c_str(),__FUNCTION__,__LINE__,canonicalPath.c_str(),data->path.c_str(),data->refCount);
+	return data;
+}
+
+void StaticSoundCache::release(StaticSoundData *data) {
+	if(data == NULL) {
+		return;
+	}
+
+	MutexSafeWrapper safeMutex(mutex,string(__FILE__) + "_" + intToStr(__LINE__));
+	data->refCount--;
+	if(data->refCount > 0) {
+		return;
+	}
+
+	for(PathMap::iterator iterMap = paths.begin(); iterMap != paths.end();) {
+		if(iterMap->second == data) {
+			paths.erase(iterMap++);
+		}
+		else {
+			++iterMap;
+		}
+	}
+	contents.erase(std::make_pair(data->crc, data->info.getSize()));
+	prefetchQueue.erase(std::remove(prefetchQueue.begin(), prefetchQueue.end(), data), prefetchQueue.end());
+
+	// a sound being prefetched is deleted by the prefetch thread
+	if(data->decoding == false) {
+		destroy(data);
+	}
+}
+
+// Called with mutex locked
+void StaticSoundCache::destroy(StaticSoundData *data) {
+	if(data->samples != NULL) {
+		decodedBytes -= data->info.getSize();
+	}
+	delete data;
+}
+
+int8 *StaticSoundCache::getSamples(StaticSoundData *data) {
+	if(data == NULL) {
+		return NULL;
+	}
+
+	MutexSafeWrapper safeMutex(mutex,string(__FILE__) + "_" + intToStr(__LINE__));
+	data->lastUsed= ++useCount;
+	if(data->samples != NULL || data->decodeFailed == true) {
+		return data->samples;
+	}
+	string path= data->path;
+	uint32 size= data->info.getSize();
+	safeMutex.ReleaseLock();
+
+	// The file may have changed since its header was read, a sound that
+	// can not be decoded is not played rather than aborting the game
+	int8 *samples= NULL;
+	try {
+		samples= decode(path, size);
+	}
+	catch(const exception &ex) {
+		SystemFlags::OutputDebug(SystemFlags::debugError,"In [%s::%s Line: %d] Error [%s]\n",extractFileFromDirectoryPath(__FILE__).c_str(),__FUNCTION__,__LINE__,ex.what());
+	}
+
+	safeMutex.Lock();
+	if(samples == NULL) {
+		data->decodeFailed= true;
+	}
+	else if(data->samples == NULL) {
+		data->samples= samples;
+		decodedBytes += size;
+	}
+	else {
+		delete [] samples;
+	}
+	evictLeastRecentlyUsed(data);
+
+	return data->samples;
+}
+
+// Called with mutex locked
+void StaticSoundCache::evictLeastRecentlyUsed(const StaticSoundData *keep) {
+	if(memoryBudget <= 0) {
+		return;
+	}
+
+	while(decodedBytes > memoryBudget) {
+		StaticSoundData *leastRecentlyUsed= NULL;
+		for(ContentMap::iterator iterMap = contents.begin(); iterMap != contents.end(); ++iterMap) {
+			StaticSoundData *data= iterMap->second;
+			if(data != keep && data->samples != NULL &&
+				(leastRecentlyUsed == NULL || data->lastUsed < leastRecentlyUsed->lastUsed)) {
+				leastRecentlyUsed= data;
+			}
+		}
+		if(leastRecentlyUsed == NULL) {
+			break;
+		}
+
+		delete [] leastRecentlyUsed->samples;
+		leastRecentlyUsed->samples= NULL;
+		decodedBytes -= leastRecentlyUsed->info.getSize();
+	}
+}
+
+void StaticSoundCache::prefetch(StaticSoundData *data) {
+	if(data == NULL) {
+		return;
+	}
+
+	static string mutexOwnerId = string(extractFileFromDirectoryPath(__FILE__).c_str()) + string("_") + intToStr(__LINE__);
+	MutexSafeWrapper safeMutex(mutex,mutexOwnerId);
+	if(data->samples != NULL || data->decoding == true ||
+		data->prefetchQueued == true || data->decodeFailed == true) {
+		return;
+	}
+	data->prefetchQueued= true;
+	prefetchQueue.push_back(data);
+
+	if(prefetchThread == NULL) {
+		prefetchThread= new SimpleTaskThread(this,0,50,true);
+		prefetchThread->setUniqueID(mutexOwnerId);
+		prefetchThread->start();
+	}
+	prefetchThread->setTaskSignalled(true);
+}
+
+void StaticSoundCache::simpleTask(BaseThread *callingThread,void *userdata) {
+	for(;callingThread->getQuitStatus() == false;) {
+		MutexSafeWrapper safeMutex(mutex,string(__FILE__) + "_" + intToStr(__LINE__));
+		if(prefetchQueue.empty() == true) {
+			break;
+		}
+		StaticSoundData *data= prefetchQueue.front();
+		prefetchQueue.pop_front();
+		data->prefetchQueued= false;
+
+		// Prefetching never evicts, what does not fit waits to be played
+		uint32 size= data->info.getSize();
+		if(data->samples != NULL || data->decodeFailed == true ||
+			(memoryBudget > 0 && decodedBytes + size > memoryBudget)) {
+			continue;
+		}
+		data->decoding= true;
+		string path= data->path;
+		safeMutex.ReleaseLock();
+
+		int8 *samples= NULL;
+		try {
+			samples= decode(path, size);
+		}
+		catch(const exception &ex) {
+			SystemFlags::OutputDebug(SystemFlags::debugError,"In [%s::%s Line: %d] Error [%s]\n",extractFileFromDirectoryPath(__FILE__).c_str(),__FUNCTION__,__LINE__,ex.what());
+		}
+
+		safeMutex.Lock();
+		data->decoding= false;
+		if(data->refCount <= 0) {
+			delete [] samples;
+			destroy(data);
+		}
+		else if(samples == NULL) {
+			data->decodeFailed= true;
+		}
+		else if(data->samples == NULL) {
+			data->samples= samples;
+			decodedBytes += size;
+		}
+		else {
+			delete [] samples;
+		}
+	}
+}
+
+void StaticSoundCache::stopPrefetch() {
+	MutexSafeWrapper safeMutex(mutex,string(__FILE__) + "_" + intToStr(__LINE__));
+	SimpleTaskThread *thread= prefetchThread;
+	prefetchThread= NULL;
+	for(unsigned int i = 0; i < prefetchQueue.size(); ++i) {
+		prefetchQueue[i]->prefetchQueued= false;
+	}
+	prefetchQueue.clear();
+	safeMutex.ReleaseLock();
+
+	if(thread != NULL) {
+		thread->signalQuit();
+		if(thread->shutdownAndWait() == true) {
+			delete thread;
+		}
+	}
+}
+
+void StaticSoundCache::setMemoryBudget(int64 bytes) {
+	MutexSafeWrapper safeMutex(mutex,string(__FILE__) + "_" + intToStr(__LINE__));
+	memoryBudget= bytes;
+	evictLeastRecentlyUsed(NULL);
+}
+
+int64 StaticSoundCache::getMemoryBudget() {
+	MutexSafeWrapper safeMutex(mutex,string(__FILE__) + "_" + intToStr(__LINE__));
+	return memoryBudget;
+}
+
+int64 StaticSoundCache::getDecodedBytes() {
+	MutexSafeWrapper safeMutex(mutex,string(__FILE__) + "_" + intToStr(__LINE__));
+	return decodedBytes;
+}
+
+int StaticSoundCache::getEntryCount() {
+	MutexSafeWrapper safeMutex(mutex,string(__FILE__) + "_" + intToStr(__LINE__));
+	return (int)contents.size();
+}
+
+}}//end namespace
@@ -10,6 +10,7 @@
 // ==============================================================
 
 #include "checksum.h"
+#include "checksum_index.h"
 
 #include <cassert>
 #include <stdexcept>
@@ -21,6 +22,25 @@
 
 #include <sys/stat.h> // for open()
 
+#if defined(__x86_64__) || defined(__i386__) || defined(_M_X64) || defined(_M_IX86)
+  #if defined(_MSC_VER) || defined(__clang__) || \
+	  (defined(__GNUC__) && (__GNUC__ > 4 || (__GNUC__ == 4 && __GNUC_MINOR__ >= 9)))
+	#define CHECKSUM_HAVE_CLMUL
+  #endif
+#endif
+
+#ifdef CHECKSUM_HAVE_CLMUL
+  #include <emmintrin.h>
+  #include <wmmintrin.h>
+  #ifdef _MSC_VER
+	#include <intrin.h>
+	#define CHECKSUM_TARGET_CLMUL
+  #else
+	#include <cpuid.h>
+	#define CHECKSUM_TARGET_CLMUL __attribute__((target("pclmul,sse2")))
+  #endif
+#endif
+
 #include "util.h"
 #include "platform_common.h"
 #include "conversion.h"
@@ -76,6 +96,231 @@ unsigned int crc_table[256] =
 	0xb3667a2e, 0xc4614ab8, 0x5d681b02, 0x2a6f2b94, 0xb40bbe37, 0xc30c8ea1, 0x5a05df1b, 0x2d02ef8d
 };
 
+// The crc functions below work on the inverted running value, the
+// callers invert it once before and after instead of for every byte
+
+static inline uint32 crcStateBytewise(uint32 state, const unsigned char *data, size_t size) {
+	while(size--) {
+		state = (state >> 8) ^ crc_table[*data++ ^ (state & 0xff)];
+	}
+	return state;
+}
+
+// crc_slicing_table[n][i] is crc_table[i] followed by n zero bytes
+static uint32 crc_slicing_table[8][256];
+
+static uint32 crcStateSlicingBy8(uint32 state, const unsigned char *data, size_t size) {
+	for(; size >= 8; size -= 8, data += 8) {
+		// bytes are assembled one by one so big endian cpus agree
+		uint32 one = state ^ ((uint32)data[0] | ((uint32)data[1] << 8) |
+							  ((uint32)data[2] << 16) | ((uint32)data[3] << 24));
+		uint32 two = (uint32)data[4] | ((uint32)data[5] << 8) |
+					 ((uint32)data[6] << 16) | ((uint32)data[7] << 24);
+		state = crc_slicing_table[7][one & 0xff] ^
+				crc_slicing_table[6][(one >> 8) & 0xff] ^
+				crc_slicing_table[5][(one >> 16) & 0xff] ^
+				crc_slicing_table[4][one >> 24] ^
+				crc_slicing_table[3][two & 0xff] ^
+				crc_slicing_table[2][(two >> 8) & 0xff] ^
+				crc_slicing_table[1][(two >> 16) & 0xff] ^
+				crc_slicing_table[0][two >> 24];
+	}
+	return crcStateBytewise(state, data, size);
+}
+
+#ifdef CHECKSUM_HAVE_CLMUL
+
+// Folds 64 bytes per step with carry-less multiplies, then reduces with
+// Barrett's method, as described in Intel's "Fast CRC Computation for
+// Generic Polynomials Using PCLMULQDQ Instruction". size must be a
+// multiple of 16 and at least 64.
+CHECKSUM_TARGET_CLMUL
+static uint32 crcStateFoldClmul(uint32 state, const unsigned char *data, size_t size) {
+	// bit reflected constants of the crc-32 polynomial, 64 bit values
+	// written as 32 bit halves so 32 bit compilers take them too
+	const __m128i k1k2	= _mm_setr_epi32((int)0x54442bd4, 0x01, (int)0xc6e41596, 0x01);
+	const __m128i k3k4	= _mm_setr_epi32((int)0x751997d0, 0x01, (int)0xccaa009e, 0x00);
+	const __m128i k5k0	= _mm_setr_epi32((int)0x63cd6124, 0x01, 0x00, 0x00);
+	const __m128i poly	= _mm_setr_epi32((int)0xdb710641, 0x01, (int)0xf7011641, 0x01);
+	const __m128i mask32	= _mm_setr_epi32(~0, 0, ~0, 0);
+
+	__m128i x1 = _mm_loadu_si128((const __m128i *)(data + 0x00));
+	__m128i x2 = _mm_loadu_si128((const __m128i *)(data + 0x10));
+	__m128i x3 = _mm_loadu_si128((const __m128i *)(data + 0x20));
+	__m128i x4 = _mm_loadu_si128((const __m128i *)(data + 0x30));
+	x1 = _mm_xor_si128(x1, _mm_cvtsi32_si128((int)state));
+	data += 64;
+	size -= 64;
+
+	for(; size >= 64; size -= 64, data += 64) {
+		__m128i x5 = _mm_clmulepi64_si128(x1, k1k2, 0x00);
+		__m128i x6 = _mm_clmulepi64_si128(x2, k1k2, 0x00);
+		__m128i x7 = _mm_clmulepi64_si128(x3, k1k2, 0x00);
+		__m128i x8 = _mm_clmulepi64_si128(x4, k1k2, 0x00);
+
+		x1 = _mm_clmulepi64_si128(x1, k1k2, 0x11);
+		x2 = _mm_clmulepi64_si128(x2, k1k2, 0x11);
+		x3 = _mm_clmulepi64_si128(x3, k1k2, 0x11);
+		x4 = _mm_clmulepi64_si128(x4, k1k2, 0x11);
+
+		x1 = _mm_xor_si128(_mm_xor_si128(x1, x5), _mm_loadu_si128((const __m128i *)(data + 0x00)));
+		x2 = _mm_xor_si128(_mm_xor_si128(x2, x6), _mm_loadu_si128((const __m128i *)(data + 0x10)));
+		x3 = _mm_xor_si128(_mm_xor_si128(x3, x7), _mm_loadu_si128((const __m128i *)(data + 0x20)));
+		x4 = _mm_xor_si128(_mm_xor_si128(x4, x8), _mm_loadu_si128((const __m128i *)(data + 0x30)));
+	}
+
+	// fold the four lanes into one
+	__m128i x5 = _mm_clmulepi64_si128(x1, k3k4, 0x00);
+	x1 = _mm_clmulepi64_si128(x1, k3k4, 0x11);
+	x1 = _mm_xor_si128(_mm_xor_si128(x1, x2), x5);
+
+	x5 = _mm_clmulepi64_si128(x1, k3k4, 0x00);
+	x1 = _mm_clmulepi64_si128(x1, k3k4, 0x11);
+	x1 = _mm_xor_si128(_mm_xor_si128(x1, x3), x5);
+
+	x5 = _mm_clmulepi64_si128(x1, k3k4, 0x00);
+	x1 = _mm_clmulepi64_si128(x1, k3k4, 0x11);
+	x1 = _mm_xor_si128(_mm_xor_si128(x1, x4), x5);
+
+	for(; size >= 16; size -= 16, data += 16) {
+		x5 = _mm_clmulepi64_si128(x1, k3k4, 0x00);
+		x1 = _mm_clmulepi64_si128(x1, k3k4, 0x11);
+		x1 = _mm_xor_si128(_mm_xor_si128(x1, _mm_loadu_si128((const __m128i *)data)), x5);
+	}
+
+	// 128 bits down to 64
+	x2 = _mm_clmulepi64_si128(x1, k3k4, 0x10);
+	x1 = _mm_xor_si128(_mm_srli_si128(x1, 8), x2);
+
+	x2 = _mm_srli_si128(x1, 4);
+	x1 = _mm_and_si128(x1, mask32);
+	x1 = _mm_clmulepi64_si128(x1, k5k0, 0x00);
+	x1 = _mm_xor_si128(x1, x2);
+
+	// Barrett reduction to 32 bits
+	x2 = _mm_and_si128(x1, mask32);
+	x2 = _mm_clmulepi64_si128(x2, poly, 0x10);
+	x2 = _mm_and_si128(x2, mask32);
+	x2 = _mm_clmulepi64_si128(x2, poly, 0x00);
+	x1 = _mm_xor_si128(x1, x2);
+
+	return (uint32)_mm_cvtsi128_si32(_mm_srli_si128(x1, 4));
+}
+
+static uint32 crcStateClmul(uint32 state, const unsigned char *data, size_t size) {
+	if(size >= 64) {
+		size_t foldSize = size & ~(size_t)15;
+		state = crcStateFoldClmul(state, data, foldSize);
+		data += foldSize;
+		size -= foldSize;
+	}
+	return crcStateSlicingBy8(state, data, size);
+}
+
+static bool cpuHasClmul() {
+#ifdef _MSC_VER
+	int cpuInfo[4] = { 0 };
+	__cpuid(cpuInfo, 1);
+	return (cpuInfo[2] & (1 << 1)) != 0;
+#else
+	unsigned int eax = 0, ebx = 0, ecx = 0, edx = 0;
+	if(__get_cpuid(1, &eax, &ebx, &ecx, &edx) == 0) {
+		return false;
+	}
+	return (ecx & bit_PCLMUL) != 0;
+#endif
+}
+
+#endif
+
+typedef uint32 (*CrcStateFunction)(uint32 state, const unsigned char *data, size_t size);
+
+static uint32 crcStateBytewiseCall(uint32 state, const unsigned char *data, size_t size) {
+	return crcStateBytewise(state, data, size);
+}
+
+static Checksum::CrcBackend crcBackend = Checksum::cbBytewise;
+static CrcStateFunction crcStateFunction = crcStateBytewiseCall;
+
+// Builds the slicing tables and picks the fastest backend before main
+class CrcBackendInitializer {
+public:
+	CrcBackendInitializer() {
+		for(int index = 0; index < 256; ++index) {
+			crc_slicing_table[0][index] = crc_table[index];
+		}
+		for(int slice = 1; slice < 8; ++slice) {
+			for(int index = 0; index < 256; ++index) {
+				uint32 previous = crc_slicing_table[slice - 1][index];
+				crc_slicing_table[slice][index] = (previous >> 8) ^ crc_table[previous & 0xff];
+			}
+		}
+
+		if(Checksum::setCrcBackend(Checksum::cbCarrylessMultiply) == false) {
+			Checksum::setCrcBackend(Checksum::cbSlicingBy8);
+		}
+	}
+};
+static CrcBackendInitializer crcBackendInitializer;
+
+bool Checksum::isCrcBackendSupported(CrcBackend backend) {
+	switch(backend) {
+		case cbBytewise:
+		case cbSlicingBy8:
+			return true;
+		case cbCarrylessMultiply:
+#ifdef CHECKSUM_HAVE_CLMUL
+			return cpuHasClmul();
+#else
+			return false;
+#endif
+		default:
+			return false;
+	}
+}
+
+bool Checksum::setCrcBackend(CrcBackend backend) {
+	if(isCrcBackendSupported(backend) == false) {
+		return false;
+	}
+	switch(backend) {
+		case cbSlicingBy8:
+			crcStateFunction = crcStateSlicingBy8;
+			break;
+#ifdef CHECKSUM_HAVE_CLMUL
+		case cbCarrylessMultiply:
+			crcStateFunction = crcStateClmul;
+			break;
+#endif
+		default:
+			crcStateFunction = crcStateBytewiseCall;
+			break;
+	}
+	crcBackend = backend;
+	return true;
+}
+
+Checksum::CrcBackend Checksum::getCrcBackend() {
+	return crcBackend;
+}
+
+const char * Checksum::getCrcBackendName(CrcBackend backend) {
+	switch(backend) {
+		case cbBytewise:
+			return "bytewise";
+		case cbSlicingBy8:
+			return "slicing-by-8";
+		case cbCarrylessMultiply:
+			return "pclmulqdq";
+		default:
+			return "unknown";
+	}
+}
+
+uint32 Checksum::updateCrc(uint32 crc, const void *data, size_t size) {
+	return ~crcStateFunction(~crc, reinterpret_cast<const unsigned char *>(data), size);
+}
+
 Checksum::Checksum() {
 	sum= 0;
 	r= 55665;
@@ -101,11 +346,13 @@ uint32 Checksum::addByte(const char value) {
 
 uint32 Checksum::addBytes(const void *_data, size_t _size) {
 	const unsigned char *rVal = reinterpret_cast<const unsigned char *>(_data);
-	sum = ~sum;
-	while (_size--) {
-		sum = (sum >> 8) ^ crc_table[*rVal++ ^ (sum & 0xff)];
+	// the many short values of the per frame crcs aren't worth a call
+	if(_size < 16) {
+		sum = ~crcStateBytewise(~sum, rVal, _size);
+	}
+	else {
+		sum = ~crcStateFunction(~sum, rVal, _size);
 	}
-	sum = ~sum;
 
 	return sum;
 }
@@ -116,55 +363,31 @@ void Checksum::addSum(uint32 value) {
 }
 
 uint32 Checksum::addInt(const int32 &value) {
-	int8 byte 	= (value >>  0) & 0xFF;
-	addByte(byte);
-	byte  		= (value >>  8) & 0xFF;
-	addByte(byte);
-	byte 		= (value >> 16) & 0xFF;
-	addByte(byte);
-	byte 		= (value >> 24) & 0xFF;
-	addByte(byte);
-
-	return sum;
+	const unsigned char bytes[4] = {
+		(unsigned char)(value >>  0), (unsigned char)(value >>  8),
+		(unsigned char)(value >> 16), (unsigned char)(value >> 24) };
+	return addBytes(bytes, sizeof(bytes));
 }
 
 uint32 Checksum::addUInt(const uint32 &value) {
-	int8 byte 	= (value >>  0) & 0xFF;
-	addByte(byte);
-	byte  		= (value >>  8) & 0xFF;
-	addByte(byte);
-	byte 		= (value >> 16) & 0xFF;
-	addByte(byte);
-	byte 		= (value >> 24) & 0xFF;
-	addByte(byte);
-
-	return sum;
+	const unsigned char bytes[4] = {
+		(unsigned char)(value >>  0), (unsigned char)(value >>  8),
+		(unsigned char)(value >> 16), (unsigned char)(value >> 24) };
+	return addBytes(bytes, sizeof(bytes));
 }
 
 uint32 Checksum::addInt64(const int64 &value) {
-	int8 byte 	= (value >>  0) & 0xFF;
-	addByte(byte);
-	byte  		= (value >>  8) & 0xFF;
-	addByte(byte);
-	byte 		= (value >> 16) & 0xFF;
-	addByte(byte);
-	byte 		= (value >> 24) & 0xFF;
-	addByte(byte);
-	byte 		= (value >> 32) & 0xFF;
-	addByte(byte);
-	byte 		= (value >> 40) & 0xFF;
-	addByte(byte);
-	byte 		= (value >> 48) & 0xFF;
-	addByte(byte);
-	byte 		= (value >> 56) & 0xFF;
-	addByte(byte);
-
-	return sum;
+	const unsigned char bytes[8] = {
+		(unsigned char)(value >>  0), (unsigned char)(value >>  8),
+		(unsigned char)(value >> 16), (unsigned char)(value >> 24),
+		(unsigned char)(value >> 32), (unsigned char)(value >> 40),
+		(unsigned char)(value >> 48), (unsigned char)(value >> 56) };
+	return addBytes(bytes, sizeof(bytes));
 }
 
 void Checksum::addString(const string &value) {
-	for(unsigned int i = 0; i < value.size(); ++i) {
-		addByte(value[i]);
+	if(value.empty() == false) {
+		addBytes(value.data(), value.size());
 	}
 }
 
@@ -310,6 +533,10 @@ bool Checksum::addFileToSum(const string &path) {
 		if(SystemFlags::getSystemSettingType(SystemFlags::debugSystem).enabled) SystemFlags::OutputDebug(SystemFlags::debugSystem,"In [%s::%s Line: %d] buf.size() = %d, path [%s], isXMLFile = %d\n",__FILE__,__FUNCTION__,__LINE__,buf.size(), path.c_str(),isXMLFile);
 
 		if(isXMLFile == true) {
+			// the kept characters are summed in one go, which gives the
+			// same crc as adding them one by one
+			std::vector<char> kept;
+			kept.reserve(buf.size());
 			bool inCommentTag=false;
 			for(std::size_t i = 0; i < buf.size(); ++i) {
 				// Ignore Spaces in XML files as they are
@@ -340,9 +567,11 @@ bool Checksum::addFileToSum(const string &path) {
 						continue;
 					}
 				//}
-				uint32 cipher = addByte(buf[i]);
-
-				if(SystemFlags::getSystemSettingType(SystemFlags::debugSystem).enabled) SystemFlags::OutputDebug(SystemFlags::debugSystem,"In [%s::%s Line: %d] %d / %d, cipher = %u\n",__FILE__,__FUNCTION__,__LINE__,i,buf.size(), cipher);
+				kept.push_back(buf[i]);
+			}
+			if(kept.empty() == false) {
+				uint32 cipher = addBytes(&kept[0],kept.size());
+				if(SystemFlags::getSystemSettingType(SystemFlags::debugSystem).enabled) SystemFlags::OutputDebug(SystemFlags::debugSystem,"In [%s::%s Line: %d] %d / %d, cipher = %u\n",__FILE__,__FUNCTION__,__LINE__,kept.size(),buf.size(), cipher);
 			}
 		}
 		else {
@@ -376,10 +605,22 @@ uint32 Checksum::getSum() {
 
 			MutexSafeWrapper safeMutexSocketDestructorFlag(&Checksum::fileListCacheSynchAccessor,string(__FILE__) + "_" + intToStr(__LINE__));
 			if(Checksum::fileListCache.find(iterMap->first) == Checksum::fileListCache.end()) {
-				Checksum fileResult;
-				//bool fileAddedOk = fileResult.addFileToSum(iterMap->first);
-				fileResult.addFileToSum(iterMap->first);
-				Checksum::fileListCache[iterMap->first] = fileResult.getSum();
+				// only files changed since they were last indexed are read again
+				int64 fileSize = 0;
+				int64 fileModified = 0;
+				uint32 fileCRC = 0;
+				bool haveFileStat = FileCRCIndex::getFileStat(iterMap->first, fileSize, fileModified);
+				if(haveFileStat == false ||
+					FileCRCIndex::findCRC(iterMap->first, fileSize, fileModified, fileCRC) == false) {
+					Checksum fileResult;
+					//bool fileAddedOk = fileResult.addFileToSum(iterMap->first);
+					fileResult.addFileToSum(iterMap->first);
+					fileCRC = fileResult.getSum();
+					if(haveFileStat == true) {
+						FileCRCIndex::setCRC(iterMap->first, fileSize, fileModified, fileCRC);
+					}
+				}
+				Checksum::fileListCache[iterMap->first] = fileCRC;
 				//printf("fileAddedOk = %d for file [%s] CRC [%d]\n",fileAddedOk,iterMap->first.c_str(),Checksum::fileListCache[iterMap->first]);
 			}
 			else {
@@ -422,6 +663,7 @@ void Checksum::removeFileFromCache(const string file) {
     if(Checksum::fileListCache.find(file) != Checksum::fileListCache.end()) {
         Checksum::fileListCache.erase(file);
     }
+	FileCRCIndex::removeCRC(file);
 }
 
 void Checksum::clearFileCache() {
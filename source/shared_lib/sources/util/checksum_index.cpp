@@ -0,0 +1,375 @@
+// ==============================================================
+//	This file is part of MegaGlest Shared Library (www.megaglest.org)
+//
+//	Copyright (C) 2026 The MegaGlest Team
+//
+//	You can redistribute this code and/or modify it under
+//	the terms of the GNU General Public License as published
+//	by the Free Software Foundation; either version 2 of the
+//	License, or (at your option) any later version
+// ==============================================================
+
+#include "checksum_index.h"
+
+#include <cstdio>
+#include <cstring>
+#include <ctime>
+#include <sys/types.h>
+#include <sys/stat.h>
+
+#include "util.h"
+#include "platform_common.h"
+#include "conversion.h"
+#include "platform_util.h"
+#include "leak_dumper.h"
+
+using namespace std;
+using namespace Shared::PlatformCommon;
+using namespace Shared::Util;
+
+namespace Shared{ namespace Util{
+
+// =====================================================
+//	class FileCRCIndex
+// =====================================================
+
+const char *FileCRCIndex::indexFileName	= "CRC_INDEX";
+const int FileCRCIndex::version			= 1;
+
+Mutex FileCRCIndex::indexSynchAccessor;
+std::map<string,FileCRCIndex::Entry> FileCRCIndex::entries;
+string FileCRCIndex::loadedFromFile		= "";
+bool FileCRCIndex::dirty				= false;
+bool FileCRCIndex::enabled				= true;
+
+string FileCRCIndex::getIndexFile() {
+	string crcCachePath = getCRCCacheFilePath();
+	if(crcCachePath == "") {
+		return "";
+	}
+	return crcCachePath + indexFileName;
+}
+
+bool FileCRCIndex::getFileStat(const string &path, int64 &size, int64 &modified) {
+#ifdef WIN32
+  #if defined(__MINGW32__)
+	struct _stat stbuf;
+  #else
+	struct _stat64i32 stbuf;
+  #endif
+	if(_wstat(utf8_decode(path).c_str(), &stbuf) == -1) {
+		return false;
+	}
+#else
+	struct stat stbuf;
+	if(stat(path.c_str(), &stbuf) == -1) {
+		return false;
+	}
+#endif
+	size = stbuf.st_size;
+	modified = stbuf.st_mtime;
+	return true;
+}
+
+// Called with indexSynchAccessor locked
+void FileCRCIndex::loadIfRequired() {
+	if(enabled == false) {
+		return;
+	}
+	string indexFile = getIndexFile();
+	if(indexFile == "" || indexFile == loadedFromFile) {
+		return;
+	}
+	loadedFromFile = indexFile;
+
+#ifdef WIN32
+	FILE *fp = _wfopen(utf8_decode(indexFile).c_str(), L"r");
+#else
+	FILE *fp = fopen(indexFile.c_str(),"r");
+#endif
+	if(fp == NULL) {
+		return;
+	}
+
+	int loadedCount = 0;
+	char line[8096 + 100]="";
+	int fileVersion = 0;
+	if(fgets(line, sizeof(line), fp) != NULL &&
+		sscanf(line, "MGCRCINDEX %d", &fileVersion) == 1 &&
+		fileVersion == version) {
+
+		while(fgets(line, sizeof(line), fp) != NULL) {
+			unsigned int crc = 0;
+			long long size = 0;
+			long long modified = 0;
+			int pathOffset = 0;
+			if(sscanf(line, "%u %lld %lld %n", &crc, &size, &modified, &pathOffset) < 3 ||
+				pathOffset <= 0) {
+				continue;
+			}
+
+			string path = &line[pathOffset];
+			while(path.empty() == false && (path[path.size()-1] == '\n' || path[path.size()-1] == '\r')) {
+				path.erase(path.size()-1);
+			}
+			if(path == "" || entries.find(path) != entries.end()) {
+				continue;
+			}
+
+			Entry &entry = entries[path];
+			entry.crc = crc;
+			entry.size = size;
+			entry.modified = modified;
+			loadedCount++;
+		}
+	}
+	fclose(fp);
+
+	if(SystemFlags::getSystemSettingType(SystemFlags::debugSystem).enabled) SystemFlags::OutputDebug(SystemFlags::debugSystem,"In [%s::%s Line: %d] loaded %d file crcs from [%s]\n",extractFileFromDirectoryPath(__FILE__).c_str(),__FUNCTION__,__LINE__,loadedCount,indexFile.c_str());
+}
+
+bool FileCRCIndex::findCRC(const string &path, int64 size, int64 modified, uint32 &crc) {
+	MutexSafeWrapper safeMutex(&indexSynchAccessor,string(__FILE__) + "_" + intToStr(__LINE__));
+	if(enabled == false) {
+		return false;
+	}
+	loadIfRequired();
+
+	std::map<string,Entry>::const_iterator iterFind = entries.find(path);
+	if(iterFind == entries.end() ||
+		iterFind->second.size != size ||
+		iterFind->second.modified != modified) {
+		return false;
+	}
+	crc = iterFind->second.crc;
+	return true;
+}
+
+void FileCRCIndex::setCRC(const string &path, int64 size, int64 modified, uint32 crc) {
+	MutexSafeWrapper safeMutex(&indexSynchAccessor,string(__FILE__) + "_" + intToStr(__LINE__));
+	if(enabled == false) {
+		return;
+	}
+	loadIfRequired();
+
+	// A file changed again within the same second keeps its size and
+	// time, so anything that recent is hashed again next time
+	if(modified >= (int64)time(NULL) - 1) {
+		if(entries.erase(path) > 0) {
+			dirty = true;
+		}
+		return;
+	}
+
+	Entry &entry = entries[path];
+	if(entry.crc != crc || entry.size != size || entry.modified != modified) {
+		entry.crc = crc;
+		entry.size = size;
+		entry.modified = modified;
+		dirty = true;
+	}
+}
+
+void FileCRCIndex::removeCRC(const string &path) {
+	MutexSafeWrapper safeMutex(&indexSynchAccessor,string(__FILE__) + "_" + intToStr(__LINE__));
+	if(entries.erase(path) > 0) {
+		dirty = true;
+	}
+}
+
+bool FileCRCIndex::save() {
+	MutexSafeWrapper safeMutex(&indexSynchAccessor,string(__FILE__) + "_" + intToStr(__LINE__));
+	string indexFile = getIndexFile();
+	if(enabled == false || dirty == false || indexFile == "") {
+		return false;
+	}
+	loadIfRequired();
+
+	// Written aside and renamed so a crash never leaves half an index
+	string tempFile = indexFile + ".tmp";
+#ifdef WIN32
+	FILE *fp = _wfopen(utf8_decode(tempFile).c_str(), L"w");
+#else
+	FILE *fp = fopen(tempFile.c_str(),"w");
+#endif
+	if(fp == NULL) {
+		return false;
+	}
+
+	fprintf(fp,"MGCRCINDEX %d\n",version);
+	for(std::map<string,Entry>::const_iterator iterMap = entries.begin();
+		iterMap != entries.end(); ++iterMap) {
+		fprintf(fp,"%u %lld %lld %s\n",
+				iterMap->second.crc,
+				(long long)iterMap->second.size,
+				(long long)iterMap->second.modified,
+				iterMap->first.c_str());
+	}
+	bool result = (ferror(fp) == 0);
+	fclose(fp);
+
+	if(result == true) {
+		if(fileExists(indexFile) == true) {
+			removeFile(indexFile);
+		}
+		result = renameFile(tempFile, indexFile);
+	}
+	if(result == true) {
+		dirty = false;
+	}
+
+	if(SystemFlags::getSystemSettingType(SystemFlags::debugSystem).enabled) SystemFlags::OutputDebug(SystemFlags::debugSystem,"In [%s::%s Line: %d] saved %d file crcs to [%s] result = %d\n",extractFileFromDirectoryPath(__FILE__).c_str(),__FUNCTION__,__LINE__,(int)entries.size(),indexFile.c_str(),result);
+	return result;
+}
+
+void FileCRCIndex::clear() {
+	MutexSafeWrapper safeMutex(&indexSynchAccessor,string(__FILE__) + "_" + intToStr(__LINE__));
+	entries.clear();
+	dirty = (loadedFromFile != "");
+}
+
+int FileCRCIndex::getEntryCount() {
+	MutexSafeWrapper safeMutex(&indexSynchAccessor,string(__FILE__) + "_" + intToStr(__LINE__));
+	return (int)entries.size();
+}
+
+void FileCRCIndex::setEnabled(bool value) {
+	MutexSafeWrapper safeMutex(&indexSynchAccessor,string(__FILE__) + "_" + intToStr(__LINE__));
+	enabled = value;
+}
+
+bool FileCRCIndex::isEnabled() {
+	MutexSafeWrapper safeMutex(&indexSynchAccessor,string(__FILE__) + "_" + intToStr(__LINE__));
+	return enabled;
+}
+
+// =====================================================
+//	class FileCRCTree
+// =====================================================
+
+string FileCRCTree::getParentFolder(const string &path) {
+	size_t lastDirectory = path.find_last_of("/\\");
+	if(lastDirectory == string::npos) {
+		return "";
+	}
+	return path.substr(0, lastDirectory);
+}
+
+void FileCRCTree::build(const FileList &fileList) {
+	nodes.clear();
+	nodes[""];
+
+	for(unsigned int index = 0; index < fileList.size(); ++index) {
+		const string &path = fileList[index].first;
+		uint32 crc = fileList[index].second;
+
+		string folder = getParentFolder(path);
+		Node &node = nodes[folder];
+		if(node.files.find(path) != node.files.end()) {
+			continue;
+		}
+		node.files[path] = crc;
+
+		// every folder up to the root includes the file in its sum
+		for(;;) {
+			Node &parentNode = nodes[folder];
+			parentNode.sum += crc;
+			parentNode.fileCount++;
+			if(folder == "") {
+				break;
+			}
+			string parentFolder = getParentFolder(folder);
+			nodes[parentFolder].folders.insert(folder);
+			folder = parentFolder;
+		}
+	}
+}
+
+const FileCRCTree::Node *FileCRCTree::findNode(const string &folder) const {
+	std::map<string,Node>::const_iterator iterFind = nodes.find(folder);
+	if(iterFind == nodes.end()) {
+		return NULL;
+	}
+	return &iterFind->second;
+}
+
+bool FileCRCTree::hasFolder(const string &folder) const {
+	return findNode(folder) != NULL;
+}
+
+uint32 FileCRCTree::getFolderSum(const string &folder) const {
+	const Node *node = findNode(folder);
+	return (node != NULL ? node->sum : 0);
+}
+
+int FileCRCTree::getFolderFileCount(const string &folder) const {
+	const Node *node = findNode(folder);
+	return (node != NULL ? node->fileCount : 0);
+}
+
+vector<string> FileCRCTree::getChildFolders(const string &folder) const {
+	vector<string> result;
+	const Node *node = findNode(folder);
+	if(node != NULL) {
+		result.assign(node->folders.begin(), node->folders.end());
+	}
+	return result;
+}
+
+uint32 FileCRCTree::getFileCRC(const string &path, bool *found) const {
+	const Node *node = findNode(getParentFolder(path));
+	if(node != NULL) {
+		std::map<string,uint32>::const_iterator iterFind = node->files.find(path);
+		if(iterFind != node->files.end()) {
+			if(found != NULL) {
+				*found = true;
+			}
+			return iterFind->second;
+		}
+	}
+	if(found != NULL) {
+		*found = false;
+	}
+	return 0;
+}
+
+void FileCRCTree::compareFolder(const FileCRCTree &other, const string &folder,
+								vector<string> &differentFiles, int &foldersVisited) const {
+	const Node *node = findNode(folder);
+	if(node == NULL) {
+		return;
+	}
+	foldersVisited++;
+
+	const Node *otherNode = other.findNode(folder);
+	if(otherNode != NULL &&
+		otherNode->sum == node->sum &&
+		otherNode->fileCount == node->fileCount) {
+		return;
+	}
+
+	for(std::map<string,uint32>::const_iterator iterMap = node->files.begin();
+		iterMap != node->files.end(); ++iterMap) {
+		bool found = false;
+		if(otherNode != NULL) {
+			std::map<string,uint32>::const_iterator iterFind = otherNode->files.find(iterMap->first);
+			found = (iterFind != otherNode->files.end() && iterFind->second == iterMap->second);
+		}
+		if(found == false) {
+			differentFiles.push_back(iterMap->first);
+		}
+	}
+
+	for(std::set<string>::const_iterator iterFolder = node->folders.begin();
+		iterFolder != node->folders.end(); ++iterFolder) {
+		compareFolder(other, *iterFolder, differentFiles, foldersVisited);
+	}
+}
+
+int FileCRCTree::getDifferentFiles(const FileCRCTree &other, vector<string> &differentFiles) const {
+	int foldersVisited = 0;
+	compareFolder(other, "", differentFiles, foldersVisited);
+	return foldersVisited;
+}
+
+}}//end namespace
@@ -50,6 +50,7 @@ uint64 GlobalStaticFlags::flags = gsft_none;
 
 // Init statics
 std::map<SystemFlags::DebugType,SystemFlags::SystemFlagsType> *SystemFlags::debugLogFileList = NULL;
+uint32 SystemFlags::debugEnabledMask					= 0;
 int SystemFlags::lockFile								= -1;
 int SystemFlags::lockFileCountIndex						= -1;
 string SystemFlags::lockfilename						= "";
@@ -283,6 +284,19 @@ void SystemFlags::init(bool haveSpecialOutputCommandLineOption) {
 	}
 }
 
+void SystemFlags::setDebugEnabled(DebugType type, bool enabled) {
+	SystemFlags::getSystemSettingType(type).enabled = enabled;
+
+	uint32 mask = SystemFlags::debugEnabledMask;
+	if(enabled == true) {
+		mask |= (1u << type);
+	}
+	else {
+		mask &= ~(1u << type);
+	}
+	SystemFlags::debugEnabledMask = mask;
+}
+
 inline bool acquire_file_lock(int hnd)
 {
 #ifndef WIN32
@@ -368,6 +382,7 @@ void SystemFlags::Close() {
 
 		delete SystemFlags::debugLogFileList;
 		SystemFlags::debugLogFileList = NULL;
+		SystemFlags::debugEnabledMask = 0;
 	}
 	if(SystemFlags::VERBOSE_MODE_ENABLED) printf("In [%s::%s Line: %d]\n",extractFileFromDirectoryPath(__FILE__).c_str(),__FUNCTION__,__LINE__);
 
@@ -0,0 +1,364 @@
+// ==============================================================
+//	This file is part of MegaGlest Shared Library (www.megaglest.org)
+//
+//	Copyright (C) 2026 The MegaGlest Team
+//
+//	You can redistribute this code and/or modify it under
+//	the terms of the GNU General Public License as published
+//	by the Free Software Foundation; either version 2 of the
+//	License, or (at your option) any later version
+// ==============================================================
+
+#ifdef WIN32
+  #include <windows.h>
+#else
+  #include <time.h>
+#endif
+
+#include "zone_profiler.h"
+
+#include <algorithm>
+#include <cstdio>
+#include <SDL_atomic.h>
+#include "conversion.h"
+#include "platform_util.h"
+#include "util.h"
+#include "leak_dumper.h"
+
+#if defined(_MSC_VER)
+  #define ZONE_PROFILER_THREAD_LOCAL __declspec(thread)
+#else
+  #define ZONE_PROFILER_THREAD_LOCAL __thread
+#endif
+
+using namespace std;
+using namespace Shared::Platform;
+using namespace Shared::PlatformCommon;
+
+namespace Shared{ namespace Util{
+
+// =====================================================
+//	class ZoneProfiler::ThreadBuffer
+// =====================================================
+
+class ZoneProfiler::ThreadBuffer {
+public:
+	// guarded by threadBuffersMutex
+	string name;
+	unsigned long threadId;
+	bool inUse;
+
+	// only touched by the thread owning the buffer
+	int generation;
+	uint32 used;
+	uint32 dropped;
+	Event *events;
+	int totalCount;
+	ZoneTotal totals[ZONES_PER_THREAD];
+
+	// what the exporter may read: the capture the events belong to and
+	// how many of them are complete
+	SDL_atomic_t publishedGeneration;
+	SDL_atomic_t published;
+
+	ThreadBuffer() {
+		threadId= 0;
+		inUse= false;
+		generation= -1;
+		used= 0;
+		dropped= 0;
+		events= NULL;
+		totalCount= 0;
+		SDL_AtomicSet(&publishedGeneration, -1);
+		SDL_AtomicSet(&published, 0);
+	}
+	~ThreadBuffer() {
+		delete [] events;
+		events= NULL;
+	}
+};
+
+// CAS is a full barrier where SDL_AtomicSet may only be an acquire one,
+// and the event has to be visible before the count that covers it
+static void publish(SDL_atomic_t *value, int newValue) {
+	SDL_AtomicCAS(value, SDL_AtomicGet(value), newValue);
+}
+
+static ZONE_PROFILER_THREAD_LOCAL ZoneProfiler::ThreadBuffer *currentThreadBuffer = NULL;
+
+bool ZoneProfiler::enabled									= false;
+int ZoneProfiler::captureGeneration							= 0;
+int64 ZoneProfiler::captureStartNanos						= 0;
+int64 ZoneProfiler::captureEndNanos							= 0;
+volatile sig_atomic_t ZoneProfiler::toggleRequested			= 0;
+Mutex ZoneProfiler::threadBuffersMutex;
+vector<ZoneProfiler::ThreadBuffer *> ZoneProfiler::threadBuffers;
+
+int64 ZoneProfiler::getNanos() {
+#ifdef WIN32
+	static LARGE_INTEGER frequency;
+	if(frequency.QuadPart == 0) {
+		QueryPerformanceFrequency(&frequency);
+	}
+	LARGE_INTEGER counter;
+	QueryPerformanceCounter(&counter);
+	return (counter.QuadPart / frequency.QuadPart) * 1000000000LL +
+			(counter.QuadPart % frequency.QuadPart) * 1000000000LL / frequency.QuadPart;
+#else
+	struct timespec now;
+	clock_gettime(CLOCK_MONOTONIC, &now);
+	return (int64)now.tv_sec * 1000000000LL + now.tv_nsec;
+#endif
+}
+
+void ZoneProfiler::start() {
+	static string mutexOwnerId = string(extractFileFromDirectoryPath(__FILE__).c_str()) + string("_") + intToStr(__LINE__);
+	MutexSafeWrapper safeMutex(&threadBuffersMutex,mutexOwnerId);
+
+	// threads notice the new generation on their next event and start over
+	captureGeneration++;
+	captureStartNanos= getNanos();
+	captureEndNanos= 0;
+	enabled= true;
+
+	if(SystemFlags::VERBOSE_MODE_ENABLED) printf("In [%s::%s Line: %d] profiler capture %d started\n",extractFileFromDirectoryPath(__FILE__).c_str(),__FUNCTION__,__LINE__,captureGeneration);
+}
+
+void ZoneProfiler::stop() {
+	if(enabled == true) {
+		enabled= false;
+		captureEndNanos= getNanos();
+	}
+}
+
+ZoneProfiler::ThreadBuffer *ZoneProfiler::getThreadBuffer() {
+	if(currentThreadBuffer != NULL) {
+		return currentThreadBuffer;
+	}
+
+	static string mutexOwnerId = string(extractFileFromDirectoryPath(__FILE__).c_str()) + string("_") + intToStr(__LINE__);
+	MutexSafeWrapper safeMutex(&threadBuffersMutex,mutexOwnerId);
+
+	// reuse the buffer of a thread that has exited, unless it still holds
+	// events of the current capture
+	ThreadBuffer *buffer= NULL;
+	for(unsigned int i = 0; i < threadBuffers.size(); ++i) {
+		if(threadBuffers[i]->inUse == false &&
+			SDL_AtomicGet(&threadBuffers[i]->publishedGeneration) != captureGeneration) {
+			buffer= threadBuffers[i];
+			break;
+		}
+	}
+	if(buffer == NULL) {
+		buffer= new ThreadBuffer();
+		threadBuffers.push_back(buffer);
+	}
+
+	buffer->inUse= true;
+	buffer->threadId= Thread::getCurrentThreadId();
+	buffer->name= "Thread " + uIntToStr((uint32)buffer->threadId);
+	buffer->generation= -1;
+	buffer->used= 0;
+	buffer->dropped= 0;
+	buffer->totalCount= 0;
+	publish(&buffer->publishedGeneration, -1);
+	publish(&buffer->published, 0);
+
+	currentThreadBuffer= buffer;
+	return buffer;
+}
+
+void ZoneProfiler::setThreadName(const string &name) {
+	ThreadBuffer *buffer= getThreadBuffer();
+
+	static string mutexOwnerId = string(extractFileFromDirectoryPath(__FILE__).c_str()) + string("_") + intToStr(__LINE__);
+	MutexSafeWrapper safeMutex(&threadBuffersMutex,mutexOwnerId);
+	buffer->name= name;
+}
+
+void ZoneProfiler::releaseThreadBuffer() {
+	if(currentThreadBuffer == NULL) {
+		return;
+	}
+
+	static string mutexOwnerId = string(extractFileFromDirectoryPath(__FILE__).c_str()) + string("_") + intToStr(__LINE__);
+	MutexSafeWrapper safeMutex(&threadBuffersMutex,mutexOwnerId);
+	currentThreadBuffer->inUse= false;
+	currentThreadBuffer= NULL;
+}
+
+void ZoneProfiler::record(const ProfileZoneInfo *zone, int64 startNanos, int64 endNanos) {
+	ThreadBuffer *buffer= getThreadBuffer();
+
+	int generation= captureGeneration;
+	if(buffer->generation != generation) {
+		buffer->generation= generation;
+		buffer->used= 0;
+		buffer->dropped= 0;
+		buffer->totalCount= 0;
+		publish(&buffer->published, 0);
+		publish(&buffer->publishedGeneration, generation);
+	}
+
+	// a thread only runs a handful of distinct zones, so a short linear
+	// search is cheaper than anything keyed
+	int totalIndex= 0;
+	for(; totalIndex < buffer->totalCount; ++totalIndex) {
+		if(buffer->totals[totalIndex].zone == zone) {
+			break;
+		}
+	}
+	if(totalIndex == buffer->totalCount && totalIndex < ZONES_PER_THREAD) {
+		buffer->totals[totalIndex].zone= zone;
+		buffer->totals[totalIndex].calls= 0;
+		buffer->totals[totalIndex].nanos= 0;
+		buffer->totalCount++;
+	}
+	if(totalIndex < buffer->totalCount) {
+		ZoneTotal &total= buffer->totals[totalIndex];
+		total.calls++;
+		total.nanos+= endNanos - (startNanos < captureStartNanos ? captureStartNanos : startNanos);
+	}
+	if(buffer->events == NULL) {
+		buffer->events= new Event[EVENTS_PER_THREAD];
+	}
+	if(buffer->used >= EVENTS_PER_THREAD) {
+		buffer->dropped++;
+		return;
+	}
+
+	Event &event= buffer->events[buffer->used];
+	event.zone= zone;
+	event.startNanos= startNanos;
+	event.endNanos= endNanos;
+	buffer->used++;
+	publish(&buffer->published, (int)buffer->used);
+}
+
+static string escapeJson(const char *text) {
+	string result;
+	for(const char *c = text; *c != '\0'; ++c) {
+		if(*c == '"' || *c == '\\') {
+			result+= '\\';
+		}
+		result+= *c;
+	}
+	return result;
+}
+
+bool ZoneProfiler::exportChromeTrace(const string &path) {
+#ifdef WIN32
+	FILE *file= _wfopen(utf8_decode(path).c_str(), L"w");
+#else
+	FILE *file= fopen(path.c_str(), "w");
+#endif
+	if(file == NULL) {
+		return false;
+	}
+
+	static string mutexOwnerId = string(extractFileFromDirectoryPath(__FILE__).c_str()) + string("_") + intToStr(__LINE__);
+	MutexSafeWrapper safeMutex(&threadBuffersMutex,mutexOwnerId);
+
+	int64 endNanos= (captureEndNanos > 0 ? captureEndNanos : getNanos());
+	const char *separator= "\n";
+
+	fprintf(file, "{\"traceEvents\":[");
+	for(unsigned int i = 0; i < threadBuffers.size(); ++i) {
+		ThreadBuffer *buffer= threadBuffers[i];
+		if(SDL_AtomicGet(&buffer->publishedGeneration) != captureGeneration) {
+			continue;
+		}
+		uint32 count= (uint32)SDL_AtomicGet(&buffer->published);
+
+		fprintf(file, "%s{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":%lu,\"args\":{\"name\":\"%s\"}}",
+				separator, buffer->threadId, escapeJson(buffer->name.c_str()).c_str());
+		separator= ",\n";
+
+		for(uint32 j = 0; j < count; ++j) {
+			const Event &event= buffer->events[j];
+			if(event.endNanos < captureStartNanos || event.startNanos > endNanos) {
+				continue;
+			}
+			// zones that were open when the capture started are cut at its start
+			int64 startNanos= (event.startNanos < captureStartNanos ? captureStartNanos : event.startNanos);
+			fprintf(file, ",\n{\"name\":\"%s\",\"cat\":\"zone\",\"ph\":\"X\",\"pid\":1,\"tid\":%lu,\"ts\":%.3f,\"dur\":%.3f,\"args\":{\"file\":\"%s\",\"line\":%d}}",
+					escapeJson(event.zone->name).c_str(), buffer->threadId,
+					(startNanos - captureStartNanos) / 1000.0,
+					(event.endNanos - startNanos) / 1000.0,
+					escapeJson(extractFileFromDirectoryPath(event.zone->file).c_str()).c_str(),
+					event.zone->line);
+		}
+	}
+	fprintf(file, "\n],\"displayTimeUnit\":\"ns\"}\n");
+
+	bool result= (ferror(file) == 0);
+	if(fclose(file) != 0) {
+		result= false;
+	}
+	return result;
+}
+
+string ZoneProfiler::getStats() {
+	static string mutexOwnerId = string(extractFileFromDirectoryPath(__FILE__).c_str()) + string("_") + intToStr(__LINE__);
+	MutexSafeWrapper safeMutex(&threadBuffersMutex,mutexOwnerId);
+
+	int threadCount= 0;
+	uint32 eventCount= 0;
+	uint32 droppedCount= 0;
+	for(unsigned int i = 0; i < threadBuffers.size(); ++i) {
+		ThreadBuffer *buffer= threadBuffers[i];
+		if(SDL_AtomicGet(&buffer->publishedGeneration) == captureGeneration) {
+			threadCount++;
+			eventCount+= (uint32)SDL_AtomicGet(&buffer->published);
+			droppedCount+= buffer->dropped;
+		}
+	}
+
+	char szBuf[8096]="";
+	snprintf(szBuf,8096,"recording [%d] threads [%d] events [%u] dropped [%u]",
+			enabled,threadCount,eventCount,droppedCount);
+	return szBuf;
+}
+
+static bool compareZoneTotals(const ZoneProfiler::ZoneTotal &a, const ZoneProfiler::ZoneTotal &b) {
+	return a.nanos > b.nanos;
+}
+
+vector<ZoneProfiler::ZoneTotal> ZoneProfiler::getZoneTotals() {
+	static string mutexOwnerId = string(extractFileFromDirectoryPath(__FILE__).c_str()) + string("_") + intToStr(__LINE__);
+	MutexSafeWrapper safeMutex(&threadBuffersMutex,mutexOwnerId);
+
+	vector<ZoneTotal> result;
+	for(unsigned int i = 0; i < threadBuffers.size(); ++i) {
+		ThreadBuffer *buffer= threadBuffers[i];
+		if(SDL_AtomicGet(&buffer->publishedGeneration) != captureGeneration) {
+			continue;
+		}
+		for(int j = 0; j < buffer->totalCount; ++j) {
+			const ZoneTotal &total= buffer->totals[j];
+			unsigned int k = 0;
+			for(; k < result.size(); ++k) {
+				if(result[k].zone == total.zone) {
+					result[k].calls+= total.calls;
+					result[k].nanos+= total.nanos;
+					break;
+				}
+			}
+			if(k == result.size()) {
+				result.push_back(total);
+			}
+		}
+	}
+	std::sort(result.begin(), result.end(), compareZoneTotals);
+	return result;
+}
+
+bool ZoneProfiler::takeToggleRequest() {
+	if(toggleRequested == 0) {
+		return false;
+	}
+	toggleRequested= 0;
+	return true;
+}
+
+}}//end namespace
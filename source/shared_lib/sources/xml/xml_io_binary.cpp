@@ -0,0 +1,449 @@
+// ==============================================================
+//	This file is part of MegaGlest Shared Library (www.megaglest.org)
+//
+//	Copyright (C) 2026 The MegaGlest Team
+//
+//	You can redistribute this code and/or modify it under
+//	the terms of the GNU General Public License as published
+//	by the Free Software Foundation; either version 2 of the
+//	License, or (at your option) any later version
+// ==============================================================
+
+#include "xml_parser.h"
+
+#include <cstdio>
+#include <cstring>
+#include "compression_utils.h"
+#include "conversion.h"
+#include "properties.h"
+#include "platform_util.h"
+#include "util.h"
+#include "leak_dumper.h"
+
+using namespace std;
+using namespace Shared::Platform;
+using namespace Shared::PlatformCommon;
+using namespace Shared::Util;
+using namespace Shared::CompressionUtil;
+
+namespace Shared { namespace Xml {
+
+// File layout, all integers little endian:
+//
+//	header		"MGXB" uint32 version
+//	chunks		uint32 rawSize, uint32 storedSize, storedSize bytes of zlib data
+//	end			a chunk with rawSize 0 and storedSize 0
+//
+// The inflated chunks form one byte stream (a record may straddle two
+// chunks) holding the root node:
+//
+//	node		name, varint childCount, string text,
+//				varint attributeCount, attributeCount * (name, string value),
+//				childCount * node
+//	name		varint index into the names seen so far, 0 means a new
+//				name follows as a string and gets the next index
+//	string		varint length, bytes
+
+static const char binaryMagic[4]	= { 'M', 'G', 'X', 'B' };
+static const size_t headerSize		= 8;
+static const int maxNodeDepth		= 256;
+
+const uint32 XmlIoBinary::FORMAT_VERSION;
+const uint32 XmlIoBinary::CHUNK_SIZE;
+
+static void writeUInt32(unsigned char *buffer, uint32 value) {
+	buffer[0] = (unsigned char)(value & 0xFF);
+	buffer[1] = (unsigned char)((value >> 8) & 0xFF);
+	buffer[2] = (unsigned char)((value >> 16) & 0xFF);
+	buffer[3] = (unsigned char)((value >> 24) & 0xFF);
+}
+
+static uint32 readUInt32(const unsigned char *buffer) {
+	return (uint32)buffer[0] | ((uint32)buffer[1] << 8) |
+			((uint32)buffer[2] << 16) | ((uint32)buffer[3] << 24);
+}
+
+// =====================================================
+//	class XmlBinaryWriter
+// =====================================================
+
+class XmlBinaryWriter {
+private:
+	// exactly one of file and buffer is set
+	FILE *file;
+	vector<unsigned char> *buffer;
+	string path;
+	int compressionLevel;
+	vector<unsigned char> chunk;
+	std::map<string,uint32> nameIndexes;
+
+	void writeFile(const void *data, size_t size) {
+		if(buffer != NULL) {
+			const unsigned char *bytes = (const unsigned char *)data;
+			buffer->insert(buffer->end(), bytes, bytes + size);
+		}
+		else if(fwrite(data, 1, size, file) != size) {
+			throw megaglest_runtime_error("Error writing to file: [" + path + "]");
+		}
+	}
+
+	void writeBytes(const unsigned char *data, size_t size) {
+		while(size > 0) {
+			size_t count = min(size, (size_t)XmlIoBinary::CHUNK_SIZE - chunk.size());
+			chunk.insert(chunk.end(), data, data + count);
+			data += count;
+			size -= count;
+			if(chunk.size() >= XmlIoBinary::CHUNK_SIZE) {
+				flush();
+			}
+		}
+	}
+
+	void writeVarUInt(uint32 value) {
+		unsigned char buffer[5];
+		size_t size = 0;
+		do {
+			unsigned char byte = (unsigned char)(value & 0x7F);
+			value >>= 7;
+			buffer[size++] = (value != 0 ? (byte | 0x80) : byte);
+		} while(value != 0);
+		writeBytes(buffer, size);
+	}
+
+	void writeString(const string &value) {
+		writeVarUInt((uint32)value.size());
+		writeBytes((const unsigned char *)value.data(), value.size());
+	}
+
+	void writeName(const string &name) {
+		std::map<string,uint32>::iterator iterFind = nameIndexes.find(name);
+		if(iterFind != nameIndexes.end()) {
+			writeVarUInt(iterFind->second);
+		}
+		else {
+			uint32 index = (uint32)nameIndexes.size() + 1;
+			nameIndexes[name] = index;
+			writeVarUInt(0);
+			writeString(name);
+		}
+	}
+
+	void flush() {
+		if(chunk.empty() == true) {
+			return;
+		}
+		std::pair<unsigned char *,unsigned long> compressed =
+				compressMemoryToMemory(&chunk[0], (unsigned long)chunk.size(), compressionLevel);
+
+		unsigned char chunkHeader[8];
+		writeUInt32(&chunkHeader[0], (uint32)chunk.size());
+		writeUInt32(&chunkHeader[4], (uint32)compressed.second);
+		try {
+			writeFile(chunkHeader, sizeof(chunkHeader));
+			writeFile(compressed.first, compressed.second);
+		}
+		catch(...) {
+			delete [] compressed.first;
+			throw;
+		}
+		delete [] compressed.first;
+		chunk.clear();
+	}
+
+public:
+	XmlBinaryWriter(FILE *file, const string &path, int compressionLevel) {
+		this->file = file;
+		this->buffer = NULL;
+		this->path = path;
+		this->compressionLevel = compressionLevel;
+		chunk.reserve(XmlIoBinary::CHUNK_SIZE);
+	}
+	XmlBinaryWriter(vector<unsigned char> &buffer, int compressionLevel) {
+		this->file = NULL;
+		this->buffer = &buffer;
+		this->compressionLevel = compressionLevel;
+		chunk.reserve(XmlIoBinary::CHUNK_SIZE);
+	}
+
+	void writeHeader() {
+		unsigned char header[headerSize];
+		memcpy(header, binaryMagic, sizeof(binaryMagic));
+		writeUInt32(&header[4], XmlIoBinary::FORMAT_VERSION);
+		writeFile(header, sizeof(header));
+	}
+
+	void writeNode(const XmlNode *node) {
+		writeName(node->getName());
+		writeVarUInt((uint32)node->getChildCount());
+		writeString(node->getText());
+		writeVarUInt((uint32)node->getAttributeCount());
+		for(unsigned int i = 0; i < node->getAttributeCount(); ++i) {
+			const XmlAttribute *attribute = node->getAttribute(i);
+			writeName(attribute->getName());
+			writeString(attribute->getValue("",false));
+		}
+		for(unsigned int i = 0; i < node->getChildCount(); ++i) {
+			writeNode(node->getChild(i));
+		}
+	}
+
+	void finish() {
+		flush();
+		unsigned char endChunk[8];
+		writeUInt32(&endChunk[0], 0);
+		writeUInt32(&endChunk[4], 0);
+		writeFile(endChunk, sizeof(endChunk));
+	}
+};
+
+// =====================================================
+//	class XmlBinaryReader
+// =====================================================
+
+class XmlBinaryReader {
+private:
+	const unsigned char *data;
+	size_t size;
+	size_t offset;
+
+	// the chunk being read
+	unsigned char *chunk;
+	size_t chunkSize;
+	size_t chunkOffset;
+	bool reachedEnd;
+
+	vector<string> names;
+	const std::map<string,string> &mapTagReplacementValues;
+	bool skipUpdatePathClimbingParts;
+
+	XmlBinaryReader(const XmlBinaryReader &);
+	XmlBinaryReader &operator=(const XmlBinaryReader &);
+
+	void nextChunk() {
+		delete [] chunk;
+		chunk = NULL;
+		chunkSize = 0;
+		chunkOffset = 0;
+
+		if(reachedEnd == true || size - offset < 8) {
+			throw megaglest_runtime_error("Saved data is truncated");
+		}
+		uint32 rawSize = readUInt32(&data[offset]);
+		uint32 storedSize = readUInt32(&data[offset + 4]);
+		offset += 8;
+		if(rawSize == 0) {
+			reachedEnd = true;
+			throw megaglest_runtime_error("Saved data is truncated");
+		}
+		if(rawSize > XmlIoBinary::CHUNK_SIZE || storedSize > size - offset) {
+			throw megaglest_runtime_error("Saved data has an invalid chunk size: " + uIntToStr(rawSize));
+		}
+
+		std::pair<unsigned char *,unsigned long> inflated =
+				extractMemoryToMemory(const_cast<unsigned char *>(&data[offset]), storedSize, rawSize);
+		offset += storedSize;
+		chunk = inflated.first;
+		chunkSize = inflated.second;
+		if(chunkSize != rawSize) {
+			throw megaglest_runtime_error("Saved data chunk does not match its size: " + uIntToStr(rawSize));
+		}
+	}
+
+	void readBytes(unsigned char *buffer, size_t count) {
+		while(count > 0) {
+			if(chunkOffset >= chunkSize) {
+				nextChunk();
+			}
+			size_t available = min(count, chunkSize - chunkOffset);
+			memcpy(buffer, &chunk[chunkOffset], available);
+			chunkOffset += available;
+			buffer += available;
+			count -= available;
+		}
+	}
+
+	uint32 readVarUInt() {
+		uint32 value = 0;
+		for(int shift = 0; shift < 35; shift += 7) {
+			unsigned char byte = 0;
+			readBytes(&byte, 1);
+			value |= (uint32)(byte & 0x7F) << shift;
+			if((byte & 0x80) == 0) {
+				return value;
+			}
+		}
+		throw megaglest_runtime_error("Saved data has an invalid number");
+	}
+
+	string readString() {
+		uint32 length = readVarUInt();
+		string value;
+		if(length > 0) {
+			value.resize(length);
+			readBytes((unsigned char *)&value[0], length);
+		}
+		return value;
+	}
+
+	string readName() {
+		uint32 index = readVarUInt();
+		if(index == 0) {
+			names.push_back(readString());
+			return names.back();
+		}
+		if(index > names.size()) {
+			throw megaglest_runtime_error("Saved data refers to an unknown name: " + uIntToStr(index));
+		}
+		return names[index - 1];
+	}
+
+public:
+	XmlBinaryReader(const char *data, size_t size, const std::map<string,string> &mapTagReplacementValues,
+					bool skipUpdatePathClimbingParts) : mapTagReplacementValues(mapTagReplacementValues) {
+		this->data = (const unsigned char *)data;
+		this->size = size;
+		this->offset = headerSize;
+		this->chunk = NULL;
+		this->chunkSize = 0;
+		this->chunkOffset = 0;
+		this->reachedEnd = false;
+		this->skipUpdatePathClimbingParts = skipUpdatePathClimbingParts;
+	}
+	~XmlBinaryReader() {
+		delete [] chunk;
+		chunk = NULL;
+	}
+
+	XmlNode *readNode(int depth) {
+		if(depth > maxNodeDepth) {
+			throw megaglest_runtime_error("Saved data is nested too deeply");
+		}
+
+		XmlNode *node = new XmlNode(readName());
+		try {
+			uint32 childCount = readVarUInt();
+			node->text = readString();
+			// the same as loading XML: tags only apply to the text of leaves
+			if(childCount == 0) {
+				Properties::applyTagsToValue(node->text,&mapTagReplacementValues,skipUpdatePathClimbingParts);
+			}
+
+			uint32 attributeCount = readVarUInt();
+			for(uint32 i = 0; i < attributeCount; ++i) {
+				string name = readName();
+				string value = readString();
+				node->attributes.push_back(new XmlAttribute(name, value, mapTagReplacementValues));
+			}
+
+			for(uint32 i = 0; i < childCount; ++i) {
+				node->children.push_back(readNode(depth + 1));
+			}
+		}
+		catch(...) {
+			delete node;
+			throw;
+		}
+		return node;
+	}
+
+	void readEnd() {
+		if(chunkOffset != chunkSize) {
+			throw megaglest_runtime_error("Saved data has trailing bytes after the root node");
+		}
+		if(size - offset < 8 || readUInt32(&data[offset]) != 0 || readUInt32(&data[offset + 4]) != 0) {
+			throw megaglest_runtime_error("Saved data is missing its end marker");
+		}
+	}
+};
+
+// =====================================================
+//	class XmlIoBinary
+// =====================================================
+
+bool XmlIoBinary::isBinary(const char *data, size_t size) {
+	return (data != NULL && size >= headerSize && memcmp(data, binaryMagic, sizeof(binaryMagic)) == 0);
+}
+
+bool XmlIoBinary::isBinaryFile(const string &path) {
+#ifdef WIN32
+	FILE *file = _wfopen(utf8_decode(path).c_str(), L"rb");
+#else
+	FILE *file = fopen(path.c_str(), "rb");
+#endif
+	if(file == NULL) {
+		return false;
+	}
+	char header[headerSize];
+	size_t readSize = fread(header, 1, headerSize, file);
+	fclose(file);
+
+	return isBinary(header, readSize);
+}
+
+void XmlIoBinary::save(const string &path, const XmlNode *node, int compressionLevel) {
+	if(node == NULL) {
+		throw megaglest_runtime_error("node == NULL during save!");
+	}
+
+#ifdef WIN32
+	FILE *file = _wfopen(utf8_decode(path).c_str(), L"wb");
+#else
+	FILE *file = fopen(path.c_str(), "wb");
+#endif
+	if(file == NULL) {
+		throw megaglest_runtime_error("Can not open file: [" + path + "]");
+	}
+
+	try {
+		XmlBinaryWriter writer(file, path, compressionLevel);
+		writer.writeHeader();
+		writer.writeNode(node);
+		writer.finish();
+	}
+	catch(const exception &e) {
+		fclose(file);
+		SystemFlags::OutputDebug(SystemFlags::debugError,"In [%s::%s Line: %d] Exception while saving: [%s], %s\n",extractFileFromDirectoryPath(__FILE__).c_str(),__FUNCTION__,__LINE__,path.c_str(),e.what());
+		throw megaglest_runtime_error("Exception while saving [" + path + "] msg: " + e.what());
+	}
+
+	if(fclose(file) != 0) {
+		throw megaglest_runtime_error("Error writing to file: [" + path + "]");
+	}
+}
+
+void XmlIoBinary::save(vector<unsigned char> &buffer, const XmlNode *node, int compressionLevel) {
+	if(node == NULL) {
+		throw megaglest_runtime_error("node == NULL during save!");
+	}
+
+	buffer.clear();
+	XmlBinaryWriter writer(buffer, compressionLevel);
+	writer.writeHeader();
+	writer.writeNode(node);
+	writer.finish();
+}
+
+XmlNode *XmlIoBinary::load(const char *data, size_t size, const std::map<string,string> &mapTagReplacementValues, bool skipUpdatePathClimbingParts) {
+	if(isBinary(data, size) == false) {
+		throw megaglest_runtime_error("Not a binary saved data file");
+	}
+	uint32 version = readUInt32((const unsigned char *)&data[4]);
+	if(version > FORMAT_VERSION) {
+		char szBuf[8096]="";
+		snprintf(szBuf,8096,"Saved data format version %u is newer than the supported version %u",version,FORMAT_VERSION);
+		throw megaglest_runtime_error(szBuf,true);
+	}
+
+	XmlBinaryReader reader(data, size, mapTagReplacementValues, skipUpdatePathClimbingParts);
+	XmlNode *rootNode = reader.readNode(0);
+	try {
+		reader.readEnd();
+	}
+	catch(...) {
+		delete rootNode;
+		throw;
+	}
+	return rootNode;
+}
+
+}}//end namespace
@@ -395,18 +395,24 @@ XmlNode *XmlIoRapid::load(const string &path, const std::map<string,string> &map
 
         if(showPerfStats) printf("In [%s::%s Line: %d] took msecs: " MG_I64_SPECIFIER "\n",extractFileFromDirectoryPath(__FILE__).c_str(),__FUNCTION__,__LINE__,chrono.getMillis());
 
-        // This is required because rapidxml seems to choke when we load lua
-        // scenarios that have lua + xml style comments
-        replaceAllBetweenTokens(buffer, "<!--","-->", "", true);
+        // Saved games are written by XmlIoBinary
+        if(XmlIoBinary::isBinary(&buffer.front(),(size_t)file_size) == true) {
+        	rootNode= XmlIoBinary::load(&buffer.front(),(size_t)file_size,mapTagReplacementValues, skipUpdatePathClimbingParts);
+        }
+        else {
+			// This is required because rapidxml seems to choke when we load lua
+			// scenarios that have lua + xml style comments
+			replaceAllBetweenTokens(buffer, "<!--","-->", "", true);
 
-        if(showPerfStats) printf("In [%s::%s Line: %d] took msecs: " MG_I64_SPECIFIER "\n",extractFileFromDirectoryPath(__FILE__).c_str(),__FUNCTION__,__LINE__,chrono.getMillis());
+			if(showPerfStats) printf("In [%s::%s Line: %d] took msecs: " MG_I64_SPECIFIER "\n",extractFileFromDirectoryPath(__FILE__).c_str(),__FUNCTION__,__LINE__,chrono.getMillis());
 
-        xml_document<> doc;
-        doc.parse<parse_no_data_nodes|parse_validate_closing_tags>(&buffer.front());
+			xml_document<> doc;
+			doc.parse<parse_no_data_nodes|parse_validate_closing_tags>(&buffer.front());
 
-        if(showPerfStats) printf("In [%s::%s Line: %d] took msecs: " MG_I64_SPECIFIER "\n",extractFileFromDirectoryPath(__FILE__).c_str(),__FUNCTION__,__LINE__,chrono.getMillis());
+			if(showPerfStats) printf("In [%s::%s Line: %d] took msecs: " MG_I64_SPECIFIER "\n",extractFileFromDirectoryPath(__FILE__).c_str(),__FUNCTION__,__LINE__,chrono.getMillis());
 
-		rootNode= new XmlNode(doc.first_node(),mapTagReplacementValues, skipUpdatePathClimbingParts);
+			rootNode= new XmlNode(doc.first_node(),mapTagReplacementValues, skipUpdatePathClimbingParts);
+        }
 
 		if(showPerfStats) printf("In [%s::%s Line: %d] took msecs: " MG_I64_SPECIFIER "\n",extractFileFromDirectoryPath(__FILE__).c_str(),__FUNCTION__,__LINE__,chrono.getMillis());
 
@@ -573,7 +579,8 @@ void XmlTree::load(const string &path, const std::map<string,string> &mapTagRepl
 	loadPath = path;
 
 #if defined(WANT_XERCES)
-	if(this->engine_type == XML_XERCES_ENGINE) {
+	// Xerces only parses text, binary saved games take the path below
+	if(this->engine_type == XML_XERCES_ENGINE && XmlIoBinary::isBinaryFile(path) == false) {
 		this->rootNode= XmlIo::getInstance().load(path, mapTagReplacementValues, noValidation,skipStackTrace);
 	}
 	else
@@ -598,6 +605,19 @@ void XmlTree::save(const string &path) {
 	}
 }
 
+void XmlTree::saveBinary(const string &path) {
+	XmlIoBinary::save(path, rootNode);
+}
+
+void XmlTree::saveBinary(vector<unsigned char> &buffer) {
+	XmlIoBinary::save(buffer, rootNode);
+}
+
+void XmlTree::loadBinary(const char *data, size_t size, const std::map<string,string> &mapTagReplacementValues) {
+	clearRootNode();
+	this->rootNode= XmlIoBinary::load(data, size, mapTagReplacementValues, this->skipUpdatePathClimbingParts);
+}
+
 void XmlTree::clearRootNode() {
 	if(this->skipStackCheck == false) {
 		LoadStack &loadStack = CacheManager::getCachedItem<LoadStack>(loadStackCacheName);
@@ -1022,6 +1042,13 @@ XmlAttribute::XmlAttribute(const string &name, const string &value, const std::m
 	this->name						= name;
 	this->value						= value;
 
+	// Saved games add hundreds of thousands of plain numbers, every
+	// tag applyTagsToValue knows starts with one of these
+	if(this->mapTagReplacementValues.empty() == true &&
+		value.find_first_of("~$%{") == string::npos) {
+		return;
+	}
+
 	usesCommondata = ((value.find("$COMMONDATAPATH") != string::npos) || (value.find("%%COMMONDATAPATH%%") != string::npos));
 	skipRestrictionCheck = Properties::applyTagsToValue(this->value,&this->mapTagReplacementValues);
 }
@@ -0,0 +1,80 @@
+// ==============================================================
+//	This file is part of MegaGlest Unit Tests (www.megaglest.org)
+//
+//	Copyright (C) 2026 The MegaGlest Team
+//
+//	You can redistribute this code and/or modify it under
+//	the terms of the GNU General Public License as published
+//	by the Free Software Foundation; either version 2 of the
+//	License, or (at your option) any later version
+// ==============================================================
+
+#include <cppunit/extensions/HelperMacros.h>
+#include "interpolation.h"
+#include <vector>
+#include <cstring>
+
+using namespace Shared::Graphics;
+
+//
+// Tests for the keyframe interpolation kernels
+//
+class InterpolationTest : public CppUnit::TestFixture {
+	// Register the suite of tests for this fixture
+	CPPUNIT_TEST_SUITE( InterpolationTest );
+
+	CPPUNIT_TEST( test_SimdMatchesScalar );
+	CPPUNIT_TEST( test_SimdMatchesScalarNormalized );
+
+	CPPUNIT_TEST_SUITE_END();
+	// End of Fixture registration
+
+	static void fill(std::vector<Vec3f> &values, unsigned int seed) {
+		for(unsigned int i = 0; i < values.size(); ++i) {
+			float components[3];
+			for(int j = 0; j < 3; ++j) {
+				seed = seed * 1103515245 + 12345;
+				components[j] = ((int)((seed >> 8) & 0xFFFF) - 0x8000) / 1024.0f;
+			}
+			values[i] = Vec3f(components[0], components[1], components[2]);
+		}
+	}
+
+	static void compare(bool normalize) {
+		// counts that leave every possible tail after the groups of four
+		const uint32 counts[] = { 1, 4, 7, 130, 1001 };
+		const float times[] = { 0.0f, 0.1f, 0.5f, 0.77f, 1.0f };
+		for(int i = 0; i < 5; ++i) {
+			uint32 count = counts[i];
+			std::vector<Vec3f> prev(count);
+			std::vector<Vec3f> next(count);
+			fill(prev, count);
+			fill(next, count * 7);
+
+			for(int j = 0; j < 5; ++j) {
+				std::vector<Vec3f> scalar(count);
+				std::vector<Vec3f> simd(count);
+				InterpolationData::lerpFrames(&prev[0], &next[0], &scalar[0], count, times[j], normalize, false);
+				InterpolationData::lerpFrames(&prev[0], &next[0], &simd[0], count, times[j], normalize, true);
+
+				CPPUNIT_ASSERT_EQUAL( 0, memcmp(&scalar[0], &simd[0], sizeof(Vec3f) * count) );
+				if(normalize == false && times[j] == 0.0f) {
+					CPPUNIT_ASSERT_EQUAL( 0, memcmp(&prev[0], &scalar[0], sizeof(Vec3f) * count) );
+				}
+			}
+		}
+	}
+
+public:
+	void test_SimdMatchesScalar() {
+		compare(false);
+	}
+
+	void test_SimdMatchesScalarNormalized() {
+		compare(true);
+	}
+};
+
+// Test Suite Registrations
+CPPUNIT_TEST_SUITE_REGISTRATION( InterpolationTest );
+//
@@ -12,16 +12,31 @@
 #include <cppunit/extensions/HelperMacros.h>
 #include <memory>
 #include "model.h"
+#include "interpolation.h"
+#include "platform_util.h"
 #include <vector>
 #include <algorithm>
+#include <fstream>
+#include <cstring>
 
 #ifdef WIN32
 #include <io.h>
 #else
 #include <unistd.h>
+#include <sys/stat.h>
 #endif
 
 using namespace Shared::Graphics;
+using namespace Shared::Platform;
+
+class TestG3dModel : public Model {
+public:
+	virtual void init() {}
+	virtual void end() {}
+	void loadFile(const string &path) {
+		load(path);
+	}
+};
 
 class TestBaseColorPickEntity : public BaseColorPickEntity {
 public:
@@ -38,10 +53,88 @@ class ModelTest : public CppUnit::TestFixture {
 
 	CPPUNIT_TEST( test_ColorPicking_loop );
 	CPPUNIT_TEST( test_ColorPicking_prime );
+	CPPUNIT_TEST( test_LoadG3dVersion3 );
+	CPPUNIT_TEST( test_LoadG3dJoinedMeshes );
+	CPPUNIT_TEST( test_LoadG3dVersion4 );
+	CPPUNIT_TEST_EXCEPTION( test_LoadG3dTruncated, megaglest_runtime_error );
+	CPPUNIT_TEST( test_AnimationFrameCache );
 
 	CPPUNIT_TEST_SUITE_END();
 	// End of Fixture registration
 
+	static void writeFloats(std::ofstream &file, uint32 count, float first) {
+		for(uint32 i = 0; i < count; ++i) {
+			float value = first + i;
+			file.write((const char *)&value, sizeof(value));
+		}
+	}
+
+	static void writeIndices(std::ofstream &file, uint32 count) {
+		for(uint32 i = 0; i < count; ++i) {
+			file.write((const char *)&i, sizeof(i));
+		}
+	}
+
+	// Untextured mesh data as both formats store it after the mesh header
+	static void writeMeshData(std::ofstream &file, uint32 frames, uint32 vertices, float first) {
+		writeFloats(file, frames * vertices * 3, first);
+		writeFloats(file, frames * vertices * 3, -first);
+	}
+
+	static void writeG3dV3(const string &path, const uint32 *frames, int meshCount) {
+		std::ofstream file(path.c_str(), std::ios_base::out | std::ios_base::binary);
+		FileHeader fileHeader = { {'G','3','D'}, 3 };
+		file.write((const char *)&fileHeader, sizeof(fileHeader));
+		uint32 count = meshCount;
+		file.write((const char *)&count, sizeof(count));
+		for(int i = 0; i < meshCount; ++i) {
+			MeshHeaderV3 meshHeader;
+			memset(&meshHeader, 0, sizeof(meshHeader));
+			meshHeader.vertexFrameCount = frames[i];
+			meshHeader.normalFrameCount = frames[i];
+			meshHeader.colorFrameCount = 1;
+			meshHeader.pointCount = 4;
+			meshHeader.indexCount = 6;
+			meshHeader.properties = mp3NoTexture;
+			file.write((const char *)&meshHeader, sizeof(meshHeader));
+			writeMeshData(file, frames[i], 4, 100.0f * (i + 1));
+			writeFloats(file, 4, 1.0f);
+			writeIndices(file, 6);
+		}
+	}
+
+	static void writeG3dV4(const string &path, uint32 frames) {
+		std::ofstream file(path.c_str(), std::ios_base::out | std::ios_base::binary);
+		FileHeader fileHeader = { {'G','3','D'}, 4 };
+		file.write((const char *)&fileHeader, sizeof(fileHeader));
+		ModelHeader modelHeader = { 1, mtMorphMesh };
+		file.write((const char *)&modelHeader, sizeof(modelHeader));
+		MeshHeader meshHeader;
+		memset(&meshHeader, 0, sizeof(meshHeader));
+		meshHeader.frameCount = frames;
+		meshHeader.vertexCount = 4;
+		meshHeader.indexCount = 6;
+		meshHeader.opacity = 1.0f;
+		file.write((const char *)&meshHeader, sizeof(meshHeader));
+		writeMeshData(file, frames, 4, 100.0f);
+		writeIndices(file, 6);
+	}
+
+	static void checkMesh(const Mesh *mesh, uint32 frames, float first) {
+		CPPUNIT_ASSERT_EQUAL( frames, mesh->getFrameCount() );
+		CPPUNIT_ASSERT_EQUAL( (uint32)4, mesh->getVertexCount() );
+		CPPUNIT_ASSERT_EQUAL( (uint32)6, mesh->getIndexCount() );
+		const float *vertices = mesh->getVertices()[0].ptr();
+		const float *normals = mesh->getNormals()[0].ptr();
+		for(uint32 i = 0; i < frames * 4 * 3; ++i) {
+			CPPUNIT_ASSERT_EQUAL( first + i, vertices[i] );
+			CPPUNIT_ASSERT_EQUAL( -first + i, normals[i] );
+		}
+		for(uint32 i = 0; i < 6; ++i) {
+			CPPUNIT_ASSERT_EQUAL( i, mesh->getIndices()[i] );
+		}
+	}
+
 public:
 
 	void test_ColorPicking_loop() {
@@ -100,6 +193,118 @@ public:
 		BaseColorPickEntity::setTrackColorUse(false);
 	}
 
+	void test_LoadG3dVersion3() {
+		// version 3 data is 4 byte aligned in the file and used in place,
+		// unless we could rewrite the file while it is mapped
+		const string path = "model_test_v3.g3d";
+		const uint32 frames[] = { 2, 3 };
+		writeG3dV3(path, frames, 2);
+		{
+			TestG3dModel model;
+			model.loadFile(path);
+			CPPUNIT_ASSERT_EQUAL( (uint32)2, model.getMeshCount() );
+			checkMesh(model.getMesh(0), 2, 100.0f);
+			checkMesh(model.getMesh(1), 3, 200.0f);
+			CPPUNIT_ASSERT_EQUAL( false, model.getMesh(0)->isMappedFromFile() );
+		}
+#ifndef WIN32
+		chmod(path.c_str(), S_IRUSR | S_IRGRP | S_IROTH);
+		{
+			TestG3dModel model;
+			model.loadFile(path);
+			checkMesh(model.getMesh(0), 2, 100.0f);
+			checkMesh(model.getMesh(1), 3, 200.0f);
+			CPPUNIT_ASSERT_EQUAL( true, model.getMesh(0)->isMappedFromFile() );
+			CPPUNIT_ASSERT_EQUAL( true, model.getMesh(1)->isMappedFromFile() );
+		}
+#endif
+		remove(path.c_str());
+	}
+
+	void test_LoadG3dJoinedMeshes() {
+		// joining copies the mapped meshes and then frees them
+		const string path = "model_test_joined.g3d";
+		const uint32 frames[] = { 2, 2 };
+		writeG3dV3(path, frames, 2);
+		{
+			TestG3dModel model;
+			model.loadFile(path);
+			CPPUNIT_ASSERT_EQUAL( (uint32)1, model.getMeshCount() );
+			CPPUNIT_ASSERT_EQUAL( false, model.getMesh(0)->isMappedFromFile() );
+			CPPUNIT_ASSERT_EQUAL( (uint32)8, model.getMesh(0)->getVertexCount() );
+			CPPUNIT_ASSERT_EQUAL( 200.0f, model.getMesh(0)->getVertices()[4].x );
+			CPPUNIT_ASSERT_EQUAL( (uint32)5, model.getMesh(0)->getIndices()[7] );
+		}
+		remove(path.c_str());
+	}
+
+	void test_LoadG3dVersion4() {
+		// version 4 data is never 4 byte aligned, so it gets copied
+		const string path = "model_test_v4.g3d";
+		writeG3dV4(path, 2);
+		{
+			TestG3dModel model;
+			model.loadFile(path);
+			CPPUNIT_ASSERT_EQUAL( (uint32)1, model.getMeshCount() );
+			CPPUNIT_ASSERT_EQUAL( false, model.getMesh(0)->isMappedFromFile() );
+			checkMesh(model.getMesh(0), 2, 100.0f);
+		}
+		remove(path.c_str());
+	}
+
+	void test_LoadG3dTruncated() {
+		const string path = "model_test_truncated.g3d";
+		writeG3dV4(path, 2);
+		std::ifstream in(path.c_str(), std::ios_base::in | std::ios_base::binary);
+		string contents((std::istreambuf_iterator<char>(in)), std::istreambuf_iterator<char>());
+		in.close();
+		std::ofstream out(path.c_str(), std::ios_base::out | std::ios_base::binary);
+		out.write(contents.data(), contents.size() - 1);
+		out.close();
+
+		TestG3dModel model;
+		try {
+			model.loadFile(path);
+		}
+		catch(...) {
+			remove(path.c_str());
+			throw;
+		}
+	}
+
+	void test_AnimationFrameCache() {
+		const string path = "model_test_frame_cache.g3d";
+		writeG3dV4(path, 2);
+		InterpolationData::setFrameCacheStep(0.25f);
+		{
+			TestG3dModel model;
+			model.loadFile(path);
+			const InterpolationData *data = model.getMesh(0)->getInterpolationData();
+
+			// 0.3 and 0.2 both round to 0.25, the second request reuses the frame
+			model.updateInterpolationData(0.3f, false);
+			const Vec3f *vertices = data->getVertices();
+			CPPUNIT_ASSERT_EQUAL( 103.0f, vertices[0].x );
+			CPPUNIT_ASSERT_EQUAL( -97.0f, data->getNormals()[0].x );
+			model.updateInterpolationData(0.2f, false);
+			CPPUNIT_ASSERT( vertices == data->getVertices() );
+
+			model.updateInterpolationData(0.6f, false);
+			CPPUNIT_ASSERT( vertices != data->getVertices() );
+			CPPUNIT_ASSERT_EQUAL( 106.0f, data->getVertices()[0].x );
+			CPPUNIT_ASSERT( InterpolationData::getFrameCacheStats().find("frames [2]") == 0 );
+
+			// over budget everything but the frame in use goes
+			InterpolationData::setFrameCacheMemoryBudget(0);
+			model.updateInterpolationData(0.9f, false);
+			CPPUNIT_ASSERT_EQUAL( 112.0f, data->getVertices()[0].x );
+			CPPUNIT_ASSERT( InterpolationData::getFrameCacheStats().find("frames [1]") == 0 );
+		}
+		CPPUNIT_ASSERT( InterpolationData::getFrameCacheStats().find("frames [0] memory [0 KB") == 0 );
+		InterpolationData::setFrameCacheStep(0.0f);
+		InterpolationData::setFrameCacheMemoryBudget(32 * 1024 * 1024);
+		remove(path.c_str());
+	}
 };
 
 
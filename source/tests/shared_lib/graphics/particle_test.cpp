@@ -0,0 +1,332 @@
+// ==============================================================
+//	This file is part of MegaGlest Unit Tests (www.megaglest.org)
+//
+//	Copyright (C) 2026 The MegaGlest Team
+//
+//	You can redistribute this code and/or modify it under
+//	the terms of the GNU General Public License as published
+//	by the Free Software Foundation; either version 2 of the
+//	License, or (at your option) any later version
+// ==============================================================
+
+#include <cppunit/extensions/HelperMacros.h>
+#include "particle.h"
+#include "platform_util.h"
+#include "task_pool.h"
+#include <vector>
+#include <cstdio>
+#include <cmath>
+
+using namespace Shared::Graphics;
+using namespace Shared::Platform;
+using namespace Shared::PlatformCommon;
+
+//
+// Tests for the particle pool kernels and the particle manager update
+//
+class ParticleTest : public CppUnit::TestFixture {
+	// Register the suite of tests for this fixture
+	CPPUNIT_TEST_SUITE( ParticleTest );
+
+	CPPUNIT_TEST( test_KillCompaction );
+	CPPUNIT_TEST( test_KernelsMatchParticleUpdates );
+	CPPUNIT_TEST( test_ParallelManagerUpdateMatchesSerial );
+	CPPUNIT_TEST( test_Benchmark_BattleLoad );
+
+	CPPUNIT_TEST_SUITE_END();
+	// End of Fixture registration
+
+	bool savedKernelsEnabled;
+	bool savedParallelUpdateEnabled;
+
+	// Records the observer and owner callbacks in the order they arrive
+	class RecordingOwner : public ParticleOwner {
+	public:
+		vector<string> log;
+
+		virtual void end(ParticleSystem *particleSystem) {}
+		virtual void logParticleInfo(string info) { log.push_back(info); }
+	};
+
+	class RecordingObserver : public ParticleObserver {
+	private:
+		RecordingOwner *owner;
+		string name;
+
+	public:
+		RecordingObserver(RecordingOwner *owner, const string &name) : owner(owner), name(name) {}
+
+		virtual void update(ParticleSystem *particleSystem) {
+			owner->log.push_back("arrived " + name);
+			delete this;
+		}
+		virtual void saveGame(XmlNode *rootNode) {}
+		virtual void loadGame(const XmlNode *rootNode, void *genericData) {}
+	};
+
+	static void makeLinkedBattle(ParticleManager &manager, RecordingOwner &owner, int units) {
+		for(int index = 0; index < units; ++index) {
+			ProjectileParticleSystem *projectile = makeProjectile(index);
+			SplashParticleSystem *splash = makeSplash(index);
+			projectile->link(splash);
+			projectile->setParticleOwner(&owner);
+			splash->setParticleOwner(&owner);
+
+			char name[32] = "";
+			snprintf(name, 31, "%d", index);
+			projectile->setObserver(new RecordingObserver(&owner, name));
+
+			manager.manage(makeUnit(index));
+			manager.manage(projectile);
+			manager.manage(splash);
+		}
+	}
+
+	static UnitParticleSystem *makeUnit(int index) {
+		UnitParticleSystem *ps = new UnitParticleSystem(200);
+		ps->setPos(Vec3f(10.0f + index, 0.5f, 20.0f));
+		ps->setColor(Vec4f(1.0f, 0.5f, 0.25f, 1.0f));
+		ps->setColorNoEnergy(Vec4f(0.1f, 0.2f, 0.3f, 0.0f));
+		ps->setEmissionRate(4.0f + (index % 3));
+		ps->setMaxParticleEnergy(40 + index % 20);
+		ps->setVarParticleEnergy(10);
+		ps->setParticleSize(0.4f);
+		ps->setSizeNoEnergy(0.1f);
+		ps->setSpeed(0.05f);
+		ps->setSpeedUpRelative(0.01f);
+		ps->setSpeedUpConstant(0.002f);
+		ps->setRadius(1.5f);
+		ps->setGravity(0.001f);
+		ps->setDirection(Vec3f(0.0f, 1.0f, 0.0f));
+		ps->setAlternations(index % 2);
+		ps->setFixed(index % 4 == 0);
+		ps->setStaticParticleCount(index % 5 == 0 ? 10 : 0);
+		ps->setIsDaylightAffected(index % 3 == 0);
+		return ps;
+	}
+
+	static ProjectileParticleSystem *makeProjectile(int index) {
+		ProjectileParticleSystem *ps = new ProjectileParticleSystem(300);
+		ps->setColor(Vec4f(1.0f, 0.8f, 0.2f, 1.0f));
+		ps->setColorNoEnergy(Vec4f(0.5f, 0.0f, 0.0f, 0.0f));
+		ps->setEmissionRate(20.0f);
+		ps->setMaxParticleEnergy(15);
+		ps->setVarParticleEnergy(5);
+		ps->setParticleSize(0.3f);
+		ps->setSizeNoEnergy(0.05f);
+		ps->setSpeed(0.02f);
+		ps->setGravity(0.0005f);
+		ps->setTrajectory(index % 2 == 0 ? ProjectileParticleSystem::tLinear : ProjectileParticleSystem::tParabolic);
+		ps->setTrajectorySpeed(0.3f);
+		ps->setTrajectoryScale(2.0f);
+		ps->setPath(Vec3f(index * 1.0f, 1.0f, 0.0f), Vec3f(index * 1.0f + 20.0f, 1.0f, 15.0f));
+		return ps;
+	}
+
+	static SplashParticleSystem *makeSplash(int index) {
+		SplashParticleSystem *ps = new SplashParticleSystem(200);
+		ps->setPos(Vec3f(index * 2.0f, 0.0f, 5.0f));
+		ps->setColor(Vec4f(0.9f, 0.9f, 1.0f, 1.0f));
+		ps->setColorNoEnergy(Vec4f(0.0f, 0.0f, 0.5f, 0.0f));
+		ps->setEmissionRate(30.0f);
+		ps->setEmissionRateFade(1.0f);
+		ps->setMaxParticleEnergy(30);
+		ps->setParticleSize(0.5f);
+		ps->setSizeNoEnergy(0.0f);
+		ps->setSpeed(0.1f);
+		ps->setSpeedUpRelative(-0.02f);
+		ps->setSpeedUpConstant(0.001f);
+		ps->setVerticalSpreadA(1.0f);
+		ps->setVerticalSpreadB(0.5f);
+		ps->setHorizontalSpreadA(1.0f);
+		ps->setHorizontalSpreadB(0.0f);
+		ps->initParticleSystem();
+		return ps;
+	}
+
+	static FireParticleSystem *makeFire(int index) {
+		FireParticleSystem *ps = new FireParticleSystem(400);
+		ps->setPos(Vec3f(index * 3.0f, 0.0f, 3.0f));
+		ps->setRadius(0.5f);
+		ps->setMaxParticleEnergy(50);
+		ps->setVarParticleEnergy(10);
+		ps->setParticleSize(0.6f);
+		ps->setSpeed(0.03f);
+		ps->setEmissionRate(8.0f);
+		return ps;
+	}
+
+	// A battle worth of effects: units with their idle and move
+	// systems, arrows and spells in flight and their splashes
+	static void makeBattle(vector<ParticleSystem *> &systems, int units) {
+		for(int index = 0; index < units; ++index) {
+			systems.push_back(makeUnit(index));
+			systems.push_back(makeProjectile(index));
+			systems.push_back(makeSplash(index));
+			if(index % 8 == 0) {
+				systems.push_back(makeFire(index));
+			}
+		}
+	}
+
+	static void deleteSystems(vector<ParticleSystem *> &systems) {
+		for(unsigned int index = 0; index < systems.size(); ++index) {
+			delete systems[index];
+		}
+		systems.clear();
+	}
+
+	static void assertClose(float expected, float actual) {
+		float tolerance = 0.00001f * (1.0f + std::fabs(expected));
+		CPPUNIT_ASSERT( std::fabs(expected - actual) <= tolerance );
+	}
+
+public:
+	void setUp() {
+		savedKernelsEnabled = ParticleSystem::getParticleKernelsEnabled();
+		savedParallelUpdateEnabled = ParticleManager::getParallelUpdateEnabled();
+	}
+
+	void tearDown() {
+		ParticleSystem::setParticleKernelsEnabled(savedKernelsEnabled);
+		ParticleManager::setParallelUpdateEnabled(savedParallelUpdateEnabled);
+	}
+
+	void test_KillCompaction() {
+		ParticlePool pool;
+		pool.resize(10);
+		for(int index = 0; index < 10; ++index) {
+			Particle particle;
+			particle.pos = Vec3f(0.0f, (float)index, 0.0f);
+			particle.lastPos = particle.pos;
+			particle.speed = Vec3f(0.0f);
+			particle.speedUpRelative = 0;
+			particle.speedUpConstant = Vec3f(0.0f);
+			particle.accel = Vec3f(0.0f);
+			particle.color = Vec4f(1.0f);
+			particle.size = 1.0f;
+			particle.energy = (index % 3 == 0 ? 0 : index);
+			pool.set(index, particle);
+		}
+
+		// 0, 3, 6 and 9 die, the last alive one fills each hole
+		int aliveCount = pool.killNoEnergy(10);
+		CPPUNIT_ASSERT_EQUAL( 6, aliveCount );
+		for(int index = 0; index < aliveCount; ++index) {
+			CPPUNIT_ASSERT( pool.getEnergy(index) > 0 );
+			CPPUNIT_ASSERT_EQUAL( (float)pool.getEnergy(index), pool.getPos(index).y );
+		}
+		CPPUNIT_ASSERT_EQUAL( 8, pool.getEnergy(0) );
+		CPPUNIT_ASSERT_EQUAL( 7, pool.getEnergy(3) );
+	}
+
+	void test_KernelsMatchParticleUpdates() {
+		vector<ParticleSystem *> scalarSystems;
+		vector<ParticleSystem *> kernelSystems;
+		makeBattle(scalarSystems, 12);
+		makeBattle(kernelSystems, 12);
+
+		for(int frame = 0; frame < 120; ++frame) {
+			ParticleSystem::setParticleKernelsEnabled(false);
+			for(unsigned int index = 0; index < scalarSystems.size(); ++index) {
+				scalarSystems[index]->update();
+			}
+			ParticleSystem::setParticleKernelsEnabled(true);
+			for(unsigned int index = 0; index < kernelSystems.size(); ++index) {
+				kernelSystems[index]->update();
+			}
+
+			for(unsigned int index = 0; index < scalarSystems.size(); ++index) {
+				const ParticleSystem *expected = scalarSystems[index];
+				const ParticleSystem *actual = kernelSystems[index];
+				CPPUNIT_ASSERT_EQUAL( expected->getAliveParticleCount(), actual->getAliveParticleCount() );
+
+				for(int particle = 0; particle < expected->getAliveParticleCount(); ++particle) {
+					const ParticlePool &expectedParticles = expected->getParticles();
+					const ParticlePool &actualParticles = actual->getParticles();
+					CPPUNIT_ASSERT_EQUAL( expectedParticles.getEnergy(particle), actualParticles.getEnergy(particle) );
+
+					Vec3f expectedPos = expectedParticles.getPos(particle);
+					Vec3f actualPos = actualParticles.getPos(particle);
+					assertClose(expectedPos.x, actualPos.x);
+					assertClose(expectedPos.y, actualPos.y);
+					assertClose(expectedPos.z, actualPos.z);
+
+					Vec4f expectedColor = expectedParticles.getColor(particle);
+					Vec4f actualColor = actualParticles.getColor(particle);
+					assertClose(expectedColor.x, actualColor.x);
+					assertClose(expectedColor.w, actualColor.w);
+					assertClose(expectedParticles.getSize(particle), actualParticles.getSize(particle));
+				}
+			}
+		}
+
+		deleteSystems(scalarSystems);
+		deleteSystems(kernelSystems);
+	}
+
+	void test_ParallelManagerUpdateMatchesSerial() {
+		RecordingOwner serialOwner;
+		RecordingOwner parallelOwner;
+		{
+			WorkStealingTaskPool taskPool;
+			ParticleManager serialManager;
+			ParticleManager parallelManager;
+			makeLinkedBattle(serialManager, serialOwner, 40);
+			makeLinkedBattle(parallelManager, parallelOwner, 40);
+
+			for(int frame = 0; frame < 150; ++frame) {
+				ParticleManager::setParallelUpdateEnabled(false);
+				serialManager.update();
+				ParticleManager::setParallelUpdateEnabled(true);
+				parallelManager.update(-1, &taskPool);
+
+				CPPUNIT_ASSERT_EQUAL( serialOwner.log.size(), parallelOwner.log.size() );
+			}
+			CPPUNIT_ASSERT_EQUAL( serialManager.hasActiveParticleSystem(ParticleSystem::pst_SplashParticleSystem),
+								parallelManager.hasActiveParticleSystem(ParticleSystem::pst_SplashParticleSystem) );
+		}
+
+		// every projectile arrived and the callbacks came in list order
+		int arrivals = 0;
+		for(unsigned int index = 0; index < serialOwner.log.size(); ++index) {
+			CPPUNIT_ASSERT_EQUAL( serialOwner.log[index], parallelOwner.log[index] );
+			if(serialOwner.log[index].find("arrived ") == 0) {
+				arrivals++;
+			}
+		}
+		CPPUNIT_ASSERT_EQUAL( 40, arrivals );
+	}
+
+	void test_Benchmark_BattleLoad() {
+		const int frames = 400;
+
+		printf("\nParticle benchmark, %d frames%s:",frames,(ParticlePool::isSimdSupported() ? " sse2" : ""));
+		for(int kernels = 0; kernels < 2; ++kernels) {
+			vector<ParticleSystem *> systems;
+			makeBattle(systems, 64);
+			ParticleSystem::setParticleKernelsEnabled(kernels == 1);
+
+			Chrono chrono;
+			chrono.start();
+			int64 particleUpdates = 0;
+			for(int frame = 0; frame < frames; ++frame) {
+				for(unsigned int index = 0; index < systems.size(); ++index) {
+					systems[index]->update();
+					particleUpdates += systems[index]->getAliveParticleCount();
+				}
+			}
+			int64 micros = chrono.getMicros();
+			double rate = (micros > 0 ? particleUpdates / (double)micros : 0);
+			printf(" %s %.1f particles/usec [%lld in %lld usec],",(kernels == 1 ? "kernels" : "per particle"),
+					rate,(long long)particleUpdates,(long long)micros);
+
+			deleteSystems(systems);
+		}
+		printf("\n");
+	}
+};
+
+// Test Suite Registrations
+CPPUNIT_TEST_SUITE_REGISTRATION( ParticleTest );
+//
@@ -0,0 +1,110 @@
+// ==============================================================
+//	This file is part of MegaGlest Unit Tests (www.megaglest.org)
+//
+//	Copyright (C) 2026 The MegaGlest Team
+//
+//	You can redistribute this code and/or modify it under
+//	the terms of the GNU General Public License as published
+//	by the Free Software Foundation; either version 2 of the
+//	License, or (at your option) any later version
+// ==============================================================
+
+#include <cppunit/extensions/HelperMacros.h>
+#include "pixmap.h"
+#include "randomgen.h"
+#include <cmath>
+#include <algorithm>
+
+using namespace Shared::Graphics;
+using namespace Shared::Util;
+
+//
+// Tests for the pixmap splat against the per pixel blend it replaced
+//
+class PixmapTest : public CppUnit::TestFixture {
+	// Register the suite of tests for this fixture
+	CPPUNIT_TEST_SUITE( PixmapTest );
+
+	CPPUNIT_TEST( test_SplatMatchesPixelBlend );
+
+	CPPUNIT_TEST_SUITE_END();
+	// End of Fixture registration
+
+	static void fill(Pixmap2D &pixmap, unsigned int seed) {
+		uint8 *pixels = pixmap.getPixels();
+		for(std::size_t index = 0; index < pixmap.getPixelByteCount(); ++index) {
+			seed = seed * 1103515245 + 12345;
+			pixels[index] = (uint8)(seed >> 16);
+		}
+	}
+
+	static float splatDistance(Vec2i a, Vec2i b) {
+		return (std::max(abs(a.x-b.x),abs(a.y- b.y)) + 3.f*a.dist(b))/4.f;
+	}
+
+	// The splat as it was done pixel by pixel through getPixel4f
+	static void referenceSplat(Pixmap2D &target, const Pixmap2D *leftUp, const Pixmap2D *rightUp,
+								const Pixmap2D *leftDown, const Pixmap2D *rightDown) {
+		RandomGen random;
+		int w = target.getW();
+		int h = target.getH();
+		for(int i = 0; i < w; ++i) {
+			for(int j = 0; j < h; ++j) {
+				float avg = std::pow((w+h)/2.f, 2.0f);
+				float distLu = std::pow(splatDistance(Vec2i(i, j), Vec2i(0, 0)), 2.0f);
+				float distRu = std::pow(splatDistance(Vec2i(i, j), Vec2i(w, 0)), 2.0f);
+				float distLd = std::pow(splatDistance(Vec2i(i, j), Vec2i(0, h)), 2.0f);
+				float distRd = std::pow(splatDistance(Vec2i(i, j), Vec2i(w, h)), 2.0f);
+
+				float lu = distLu>avg? 0: ((avg-distLu))*random.randRange(0.5f, 1.0f);
+				float ru = distRu>avg? 0: ((avg-distRu))*random.randRange(0.5f, 1.0f);
+				float ld = distLd>avg? 0: ((avg-distLd))*random.randRange(0.5f, 1.0f);
+				float rd = distRd>avg? 0: ((avg-distRd))*random.randRange(0.5f, 1.0f);
+				float total = lu+ru+ld+rd;
+
+				Vec4f pix = (leftUp->getPixel4f(i, j)*lu+
+					rightUp->getPixel4f(i, j)*ru+
+					leftDown->getPixel4f(i, j)*ld+
+					rightDown->getPixel4f(i, j)*rd)*(1.0f/total);
+				target.setPixel(i, j, pix);
+			}
+		}
+	}
+
+public:
+	void test_SplatMatchesPixelBlend() {
+		const int sizes[] = { 16, 64, 33 };
+		for(int size = 0; size < 3; ++size) {
+			int w = sizes[size];
+			int h = (size == 2 ? 20 : w);
+
+			Pixmap2D leftUp(w, h, 3);
+			Pixmap2D rightUp(w, h, 4);
+			Pixmap2D leftDown(w, h, 3);
+			Pixmap2D rightDown(w, h, 3);
+			fill(leftUp, 1);
+			fill(rightUp, 2);
+			fill(leftDown, 3);
+			fill(rightDown, 4);
+
+			Pixmap2D expected(w, h, 3);
+			referenceSplat(expected, &leftUp, &rightUp, &leftDown, &rightDown);
+
+			Pixmap2D actual(w, h, 3);
+			actual.splat(&leftUp, &rightUp, &leftDown, &rightDown);
+
+			PixmapSplatWeights weights(w, h);
+			Pixmap2D shared(w, h, 3);
+			shared.splat(&leftUp, &rightUp, &leftDown, &rightDown, weights);
+
+			for(std::size_t index = 0; index < expected.getPixelByteCount(); ++index) {
+				CPPUNIT_ASSERT_EQUAL( (int)expected.getPixels()[index], (int)actual.getPixels()[index] );
+				CPPUNIT_ASSERT_EQUAL( (int)expected.getPixels()[index], (int)shared.getPixels()[index] );
+			}
+		}
+	}
+};
+
+// Test Suite Registrations
+CPPUNIT_TEST_SUITE_REGISTRATION( PixmapTest );
+//
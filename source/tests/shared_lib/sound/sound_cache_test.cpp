@@ -0,0 +1,154 @@
+// ==============================================================
+//	This file is part of MegaGlest Unit Tests (www.megaglest.org)
+//
+//	Copyright (C) 2026 The MegaGlest Team
+//
+//	You can redistribute this code and/or modify it under
+//	the terms of the GNU General Public License as published
+//	by the Free Software Foundation; either version 2 of the
+//	License, or (at your option) any later version
+// ==============================================================
+
+#include <cppunit/extensions/HelperMacros.h>
+#include <fstream>
+#include <cstdio>
+#include <cstring>
+#include "sound.h"
+#include "sound_cache.h"
+#include "platform_common.h"
+
+using namespace Shared::Sound;
+using namespace Shared::PlatformCommon;
+
+//
+// Tests for the shared, lazily decoded static sound samples
+//
+class SoundCacheTest : public CppUnit::TestFixture {
+	// Register the suite of tests for this fixture
+	CPPUNIT_TEST_SUITE( SoundCacheTest );
+
+	CPPUNIT_TEST( test_SameContentsShareSamples );
+	CPPUNIT_TEST( test_LeastRecentlyPlayedAreEvicted );
+	CPPUNIT_TEST( test_MissingFileIsNotPlayed );
+
+	CPPUNIT_TEST_SUITE_END();
+	// End of Fixture registration
+
+	static const int sampleCount = 1000;
+
+	// 8 bit mono wav whose samples all have the given value
+	static void writeWav(const string &path, int8 value) {
+		uint32 size32 = 0;
+		uint16 size16 = 0;
+		std::ofstream file(path.c_str(), std::ios_base::out | std::ios_base::binary);
+		file.write("RIFF", 4);
+		size32 = 36 + sampleCount;	file.write((const char *)&size32, 4);
+		file.write("WAVEfmt ", 8);
+		size32 = 16;				file.write((const char *)&size32, 4);
+		size16 = 1;					file.write((const char *)&size16, 2);
+		size16 = 1;					file.write((const char *)&size16, 2);
+		size32 = 8000;				file.write((const char *)&size32, 4);
+		size32 = 8000;				file.write((const char *)&size32, 4);
+		size16 = 1;					file.write((const char *)&size16, 2);
+		size16 = 8;					file.write((const char *)&size16, 2);
+		file.write("data", 4);
+		size32 = sampleCount;		file.write((const char *)&size32, 4);
+		for(int i = 0; i < sampleCount; ++i) {
+			file.write((const char *)&value, 1);
+		}
+	}
+
+	vector<string> files;
+
+public:
+	void setUp() {
+		// a copy of the first in another folder, as factions copy sounds
+		createDirectoryPaths("sound_cache_test/copy");
+		files.push_back("sound_cache_test/sound.wav");
+		files.push_back("sound_cache_test/copy/sound.wav");
+		files.push_back("sound_cache_test/sound_2.wav");
+		files.push_back("sound_cache_test/sound_3.wav");
+		for(int i = 0; i < (int)files.size(); ++i) {
+			writeWav(files[i], (int8)(i == 0 ? 1 : i));
+		}
+	}
+
+	void tearDown() {
+		StaticSoundCache::getInstance().setMemoryBudget(0);
+		files.clear();
+		removeFolder("sound_cache_test");
+	}
+
+	void test_SameContentsShareSamples() {
+		StaticSoundCache &soundCache = StaticSoundCache::getInstance();
+		int entryCount = soundCache.getEntryCount();
+		int64 decodedBytes = soundCache.getDecodedBytes();
+
+		StaticSound first;
+		StaticSound samePath;
+		StaticSound sameContents;
+		first.load(files[0]);
+		samePath.load(files[0]);
+		sameContents.load(files[1]);
+
+		// nothing is decoded before the first play
+		CPPUNIT_ASSERT_EQUAL( entryCount + 1, soundCache.getEntryCount() );
+		CPPUNIT_ASSERT_EQUAL( decodedBytes, soundCache.getDecodedBytes() );
+		CPPUNIT_ASSERT_EQUAL( (uint32)sampleCount, sameContents.getInfo()->getSize() );
+
+		int8 *samples = first.getSamples();
+		CPPUNIT_ASSERT( samples != NULL );
+		CPPUNIT_ASSERT_EQUAL( (int8)1, samples[sampleCount - 1] );
+		CPPUNIT_ASSERT_EQUAL( decodedBytes + sampleCount, soundCache.getDecodedBytes() );
+		CPPUNIT_ASSERT( samples == samePath.getSamples() );
+		CPPUNIT_ASSERT( samples == sameContents.getSamples() );
+
+		first.close();
+		samePath.close();
+		CPPUNIT_ASSERT_EQUAL( entryCount + 1, soundCache.getEntryCount() );
+		sameContents.close();
+		CPPUNIT_ASSERT_EQUAL( entryCount, soundCache.getEntryCount() );
+		CPPUNIT_ASSERT_EQUAL( decodedBytes, soundCache.getDecodedBytes() );
+	}
+
+	void test_LeastRecentlyPlayedAreEvicted() {
+		StaticSoundCache &soundCache = StaticSoundCache::getInstance();
+		int64 decodedBytes = soundCache.getDecodedBytes();
+		soundCache.setMemoryBudget(decodedBytes + 2 * sampleCount);
+
+		StaticSound sounds[3];
+		for(int i = 0; i < 3; ++i) {
+			sounds[i].load(files[i + 1]);
+		}
+
+		CPPUNIT_ASSERT_EQUAL( (int8)1, sounds[0].getSamples()[0] );
+		CPPUNIT_ASSERT_EQUAL( (int8)2, sounds[1].getSamples()[0] );
+		CPPUNIT_ASSERT_EQUAL( (int8)1, sounds[0].getSamples()[0] );
+		CPPUNIT_ASSERT_EQUAL( (int8)3, sounds[2].getSamples()[0] );
+		CPPUNIT_ASSERT_EQUAL( decodedBytes + 2 * sampleCount, soundCache.getDecodedBytes() );
+
+		// the second was played least recently, so it had to go
+		int8 *samples = sounds[0].getSamples();
+		CPPUNIT_ASSERT_EQUAL( decodedBytes + 2 * sampleCount, soundCache.getDecodedBytes() );
+		CPPUNIT_ASSERT( samples == sounds[0].getSamples() );
+		CPPUNIT_ASSERT_EQUAL( (int8)2, sounds[1].getSamples()[0] );
+		CPPUNIT_ASSERT_EQUAL( decodedBytes + 2 * sampleCount, soundCache.getDecodedBytes() );
+	}
+
+	void test_MissingFileIsNotPlayed() {
+		StaticSoundCache &soundCache = StaticSoundCache::getInstance();
+		int64 decodedBytes = soundCache.getDecodedBytes();
+
+		StaticSound sound;
+		sound.load(files[3]);
+		removeFile(files[3]);
+
+		CPPUNIT_ASSERT( sound.getSamples() == NULL );
+		CPPUNIT_ASSERT( sound.getSamples() == NULL );
+		CPPUNIT_ASSERT_EQUAL( decodedBytes, soundCache.getDecodedBytes() );
+	}
+};
+
+// Test Suite Registrations
+CPPUNIT_TEST_SUITE_REGISTRATION( SoundCacheTest );
+//
@@ -0,0 +1,249 @@
+// ==============================================================
+//	This file is part of MegaGlest Unit Tests (www.megaglest.org)
+//
+//	Copyright (C) 2026 The MegaGlest Team
+//
+//	You can redistribute this code and/or modify it under
+//	the terms of the GNU General Public License as published
+//	by the Free Software Foundation; either version 2 of the
+//	License, or (at your option) any later version
+// ==============================================================
+
+#include <cppunit/extensions/HelperMacros.h>
+#include "astar_containers.h"
+#include "platform_common.h"
+#include <map>
+#include <vector>
+#include <cmath>
+#include <cstdio>
+
+using namespace Shared::Util;
+using namespace Shared::PlatformCommon;
+
+//
+// Tests for the pathfinder open / closed list containers
+//
+class AStarContainersTest : public CppUnit::TestFixture {
+	// Register the suite of tests for this fixture
+	CPPUNIT_TEST_SUITE( AStarContainersTest );
+
+	CPPUNIT_TEST( test_OpenList_PopOrderMatchesMapBuckets );
+	CPPUNIT_TEST( test_GenerationMarkGrid );
+	CPPUNIT_TEST( test_Benchmark_GridSearch );
+
+	CPPUNIT_TEST_SUITE_END();
+	// End of Fixture registration
+
+	static const int gridW = 128;
+	static const int gridH = 128;
+
+	class SearchResult {
+	public:
+		std::vector<int> expanded;
+		int64 micros;
+	};
+
+	static bool isBlocked(int x, int y) {
+		// a few walls with gaps so the search has to go around things
+		return (x % 16 == 8 && y % 32 != 0) || (y % 24 == 12 && x % 40 > 4);
+	}
+
+	static float heuristic(int x, int y, int goalX, int goalY) {
+		float dx = (float)(x - goalX);
+		float dy = (float)(y - goalY);
+		return std::sqrt(dx * dx + dy * dy);
+	}
+
+	// The pathfinder search as it was written against std::map
+	static SearchResult searchLegacy(int startX, int startY, int goalX, int goalY, int maxNodes) {
+		SearchResult result;
+		Chrono chrono;
+		chrono.start();
+
+		std::map<float, std::vector<int> > openNodesList;
+		std::map<int, bool> openPosList;
+		int nodeCount = 1;
+		int start = startY * gridW + startX;
+		openNodesList[heuristic(startX,startY,goalX,goalY)].push_back(start);
+		openPosList[start] = true;
+
+		while(openNodesList.empty() == false) {
+			int node = openNodesList.begin()->second.front();
+			openNodesList.begin()->second.erase(openNodesList.begin()->second.begin());
+			if(openNodesList.begin()->second.empty()) {
+				openNodesList.erase(openNodesList.begin());
+			}
+			result.expanded.push_back(node);
+			int x = node % gridW;
+			int y = node / gridW;
+			if(x == goalX && y == goalY) {
+				break;
+			}
+			openPosList[node] = true;
+
+			bool nodeLimitReached = false;
+			for(int i = -1; i <= 1 && nodeLimitReached == false; ++i) {
+				for(int j = -1; j <= 1 && nodeLimitReached == false; ++j) {
+					int sx = x + i;
+					int sy = y + j;
+					if(sx < 0 || sy < 0 || sx >= gridW || sy >= gridH || isBlocked(sx,sy)) {
+						continue;
+					}
+					int suc = sy * gridW + sx;
+					if(openPosList.find(suc) != openPosList.end()) {
+						continue;
+					}
+					if(nodeCount >= maxNodes) {
+						nodeLimitReached = true;
+						continue;
+					}
+					nodeCount++;
+					openNodesList[heuristic(sx,sy,goalX,goalY)].push_back(suc);
+					openPosList[suc] = true;
+				}
+			}
+			if(nodeLimitReached == true) {
+				break;
+			}
+		}
+		result.micros = chrono.getMicros();
+		return result;
+	}
+
+	// The same search against the flat containers the pathfinder now uses
+	static SearchResult searchFlat(AStarOpenList<int> &openNodesList, GenerationMarkGrid &openPosList,
+			int startX, int startY, int goalX, int goalY, int maxNodes) {
+		SearchResult result;
+		Chrono chrono;
+		chrono.start();
+
+		openNodesList.clear();
+		openPosList.clear();
+		int nodeCount = 1;
+		openNodesList.push(heuristic(startX,startY,goalX,goalY), startY * gridW + startX);
+		openPosList.mark(startX,startY);
+
+		while(openNodesList.empty() == false) {
+			int node = openNodesList.pop();
+			result.expanded.push_back(node);
+			int x = node % gridW;
+			int y = node / gridW;
+			if(x == goalX && y == goalY) {
+				break;
+			}
+			openPosList.mark(x,y);
+
+			bool nodeLimitReached = false;
+			for(int i = -1; i <= 1 && nodeLimitReached == false; ++i) {
+				for(int j = -1; j <= 1 && nodeLimitReached == false; ++j) {
+					int sx = x + i;
+					int sy = y + j;
+					if(sx < 0 || sy < 0 || sx >= gridW || sy >= gridH || isBlocked(sx,sy)) {
+						continue;
+					}
+					if(openPosList.isMarked(sx,sy) == true) {
+						continue;
+					}
+					if(nodeCount >= maxNodes) {
+						nodeLimitReached = true;
+						continue;
+					}
+					nodeCount++;
+					openNodesList.push(heuristic(sx,sy,goalX,goalY), sy * gridW + sx);
+					openPosList.mark(sx,sy);
+				}
+			}
+			if(nodeLimitReached == true) {
+				break;
+			}
+		}
+		result.micros = chrono.getMicros();
+		return result;
+	}
+
+public:
+
+	void test_OpenList_PopOrderMatchesMapBuckets() {
+		std::map<float, std::vector<int> > buckets;
+		AStarOpenList<int> openList;
+
+		// lots of duplicate keys on purpose, insertion order must break ties
+		unsigned int seed = 12345;
+		for(int index = 0; index < 5000; ++index) {
+			seed = seed * 1103515245 + 12345;
+			float key = (float)((seed >> 16) % 64) * 0.5f;
+			buckets[key].push_back(index);
+			openList.push(key,index);
+
+			if(index % 3 == 0) {
+				int expected = buckets.begin()->second.front();
+				buckets.begin()->second.erase(buckets.begin()->second.begin());
+				if(buckets.begin()->second.empty()) {
+					buckets.erase(buckets.begin());
+				}
+				CPPUNIT_ASSERT_EQUAL( expected, openList.pop() );
+			}
+		}
+		while(buckets.empty() == false) {
+			int expected = buckets.begin()->second.front();
+			buckets.begin()->second.erase(buckets.begin()->second.begin());
+			if(buckets.begin()->second.empty()) {
+				buckets.erase(buckets.begin());
+			}
+			CPPUNIT_ASSERT_EQUAL( expected, openList.pop() );
+		}
+		CPPUNIT_ASSERT_EQUAL( true, openList.empty() );
+	}
+
+	void test_GenerationMarkGrid() {
+		GenerationMarkGrid grid;
+		grid.resize(10,5);
+
+		CPPUNIT_ASSERT_EQUAL( false, grid.isMarked(3,2) );
+		grid.mark(3,2);
+		grid.mark(3,2);
+		grid.mark(-1,2);
+		grid.mark(10,0);
+		CPPUNIT_ASSERT_EQUAL( true, grid.isMarked(3,2) );
+		CPPUNIT_ASSERT_EQUAL( false, grid.isMarked(2,3) );
+		CPPUNIT_ASSERT_EQUAL( false, grid.isMarked(-1,2) );
+		CPPUNIT_ASSERT_EQUAL( (uint32)1, grid.getMarkedCount() );
+
+		grid.clear();
+		CPPUNIT_ASSERT_EQUAL( false, grid.isMarked(3,2) );
+		CPPUNIT_ASSERT_EQUAL( (uint32)0, grid.getMarkedCount() );
+	}
+
+	void test_Benchmark_GridSearch() {
+		AStarOpenList<int> openNodesList;
+		GenerationMarkGrid openPosList;
+		openPosList.resize(gridW,gridH);
+
+		int64 legacyMicros = 0;
+		int64 flatMicros = 0;
+		int64 expandedNodes = 0;
+		for(int run = 0; run < 40; ++run) {
+			int startX = 1 + (run * 7) % 20;
+			int startY = 1 + (run * 13) % (gridH - 2);
+			int goalX = gridW - 2 - (run * 5) % 20;
+			int goalY = 1 + (run * 11) % (gridH - 2);
+
+			SearchResult legacy = searchLegacy(startX,startY,goalX,goalY,2000);
+			SearchResult flat = searchFlat(openNodesList,openPosList,startX,startY,goalX,goalY,2000);
+
+			CPPUNIT_ASSERT( legacy.expanded == flat.expanded );
+			legacyMicros += legacy.micros;
+			flatMicros += flat.micros;
+			expandedNodes += (int64)flat.expanded.size();
+		}
+
+		double legacyRate = (legacyMicros > 0 ? expandedNodes * 1000000.0 / legacyMicros : 0);
+		double flatRate = (flatMicros > 0 ? expandedNodes * 1000000.0 / flatMicros : 0);
+		printf("\nA* open list benchmark: %lld nodes, std::map %.0f nodes/sec, flat heap %.0f nodes/sec\n",
+				(long long int)expandedNodes,legacyRate,flatRate);
+	}
+};
+
+// Test Suite Registrations
+CPPUNIT_TEST_SUITE_REGISTRATION( AStarContainersTest );
+//
@@ -0,0 +1,117 @@
+// ==============================================================
+//	This file is part of MegaGlest Unit Tests (www.megaglest.org)
+//
+//	Copyright (C) 2026 The MegaGlest Team
+//
+//	You can redistribute this code and/or modify it under
+//	the terms of the GNU General Public License as published
+//	by the Free Software Foundation; either version 2 of the
+//	License, or (at your option) any later version
+// ==============================================================
+
+#include <cppunit/extensions/HelperMacros.h>
+#include "checksum_index.h"
+#include <algorithm>
+
+using namespace Shared::Util;
+
+//
+// Tests for the file crc index and the directory sums of file lists
+//
+class ChecksumIndexTest : public CppUnit::TestFixture {
+	// Register the suite of tests for this fixture
+	CPPUNIT_TEST_SUITE( ChecksumIndexTest );
+
+	CPPUNIT_TEST( test_FolderSums );
+	CPPUNIT_TEST( test_DifferentFiles );
+	CPPUNIT_TEST( test_IndexValidatesSizeAndTime );
+
+	CPPUNIT_TEST_SUITE_END();
+	// End of Fixture registration
+
+	static FileCRCTree::FileList makeTech() {
+		FileCRCTree::FileList files;
+		files.push_back(std::make_pair(string("techs/megapack/megapack.xml"), (uint32)1000));
+		files.push_back(std::make_pair(string("techs/megapack/factions/magic/magic.xml"), (uint32)200));
+		files.push_back(std::make_pair(string("techs/megapack/factions/magic/units/archmage/archmage.xml"), (uint32)30));
+		files.push_back(std::make_pair(string("techs/megapack/factions/tech/tech.xml"), (uint32)4));
+		files.push_back(std::make_pair(string("techs/megapack/factions/tech/units/swordman/swordman.xml"), (uint32)0xfffffff0u));
+		return files;
+	}
+
+public:
+	void test_FolderSums() {
+		FileCRCTree tree(makeTech());
+
+		// the root sum is the plain sum the crc of a whole tree uses
+		CPPUNIT_ASSERT_EQUAL( (uint32)(1000 + 200 + 30 + 4 + 0xfffffff0u), tree.getFolderSum("") );
+		CPPUNIT_ASSERT_EQUAL( 5, tree.getFolderFileCount("techs/megapack") );
+		CPPUNIT_ASSERT_EQUAL( (uint32)230, tree.getFolderSum("techs/megapack/factions/magic") );
+		CPPUNIT_ASSERT_EQUAL( 2, tree.getFolderFileCount("techs/megapack/factions/magic") );
+
+		vector<string> folders = tree.getChildFolders("techs/megapack/factions");
+		CPPUNIT_ASSERT_EQUAL( 2, (int)folders.size() );
+		CPPUNIT_ASSERT_EQUAL( string("techs/megapack/factions/magic"), folders[0] );
+		CPPUNIT_ASSERT_EQUAL( string("techs/megapack/factions/tech"), folders[1] );
+
+		bool found = false;
+		CPPUNIT_ASSERT_EQUAL( (uint32)4, tree.getFileCRC("techs/megapack/factions/tech/tech.xml", &found) );
+		CPPUNIT_ASSERT_EQUAL( true, found );
+		tree.getFileCRC("techs/megapack/factions/tech/missing.xml", &found);
+		CPPUNIT_ASSERT_EQUAL( false, found );
+	}
+
+	void test_DifferentFiles() {
+		FileCRCTree::FileList localFiles = makeTech();
+		FileCRCTree::FileList remoteFiles = makeTech();
+
+		vector<string> differentFiles;
+		FileCRCTree(localFiles).getDifferentFiles(FileCRCTree(remoteFiles), differentFiles);
+		CPPUNIT_ASSERT_EQUAL( 0, (int)differentFiles.size() );
+
+		// one changed file and one the remote side does not have
+		remoteFiles[2].second = 31;
+		remoteFiles.pop_back();
+
+		FileCRCTree localTree(localFiles);
+		FileCRCTree remoteTree(remoteFiles);
+		int foldersVisited = localTree.getDifferentFiles(remoteTree, differentFiles);
+		std::sort(differentFiles.begin(), differentFiles.end());
+		CPPUNIT_ASSERT_EQUAL( 2, (int)differentFiles.size() );
+		CPPUNIT_ASSERT_EQUAL( localFiles[2].first, differentFiles[0] );
+		CPPUNIT_ASSERT_EQUAL( localFiles[4].first, differentFiles[1] );
+		CPPUNIT_ASSERT( foldersVisited < (int)localTree.getFolderFileCount("") + 10 );
+
+		// files only the local side has are all that is left the other way
+		differentFiles.clear();
+		remoteTree.getDifferentFiles(localTree, differentFiles);
+		CPPUNIT_ASSERT_EQUAL( 1, (int)differentFiles.size() );
+		CPPUNIT_ASSERT_EQUAL( remoteFiles[2].first, differentFiles[0] );
+	}
+
+	void test_IndexValidatesSizeAndTime() {
+		const string path = "techs/megapack/factions/tech/tech.xml";
+		const int64 modified = 1000000;
+
+		FileCRCIndex::setCRC(path, 1234, modified, 0xdeadbeefu);
+
+		uint32 crc = 0;
+		CPPUNIT_ASSERT_EQUAL( true, FileCRCIndex::findCRC(path, 1234, modified, crc) );
+		CPPUNIT_ASSERT_EQUAL( (uint32)0xdeadbeefu, crc );
+		CPPUNIT_ASSERT_EQUAL( false, FileCRCIndex::findCRC(path, 1235, modified, crc) );
+		CPPUNIT_ASSERT_EQUAL( false, FileCRCIndex::findCRC(path, 1234, modified + 1, crc) );
+
+		// a file written this second could still change without its time changing
+		FileCRCIndex::setCRC(path, 1234, (int64)time(NULL), 0xdeadbeefu);
+		CPPUNIT_ASSERT_EQUAL( false, FileCRCIndex::findCRC(path, 1234, (int64)time(NULL), crc) );
+		CPPUNIT_ASSERT_EQUAL( false, FileCRCIndex::findCRC(path, 1234, modified, crc) );
+
+		FileCRCIndex::setCRC(path, 1234, modified, 0xdeadbeefu);
+		FileCRCIndex::removeCRC(path);
+		CPPUNIT_ASSERT_EQUAL( false, FileCRCIndex::findCRC(path, 1234, modified, crc) );
+	}
+};
+
+// Test Suite Registrations
+CPPUNIT_TEST_SUITE_REGISTRATION( ChecksumIndexTest );
+//
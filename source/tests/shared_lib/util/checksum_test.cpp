@@ -0,0 +1,161 @@
+// ==============================================================
+//	This file is part of MegaGlest Unit Tests (www.megaglest.org)
+//
+//	Copyright (C) 2026 The MegaGlest Team
+//
+//	You can redistribute this code and/or modify it under
+//	the terms of the GNU General Public License as published
+//	by the Free Software Foundation; either version 2 of the
+//	License, or (at your option) any later version
+// ==============================================================
+
+#include <cppunit/extensions/HelperMacros.h>
+#include "checksum.h"
+#include "platform_common.h"
+#include <vector>
+#include <algorithm>
+#include <cstdio>
+
+using namespace Shared::Util;
+using namespace Shared::PlatformCommon;
+
+//
+// Tests for the crc backends of Checksum
+//
+class ChecksumTest : public CppUnit::TestFixture {
+	// Register the suite of tests for this fixture
+	CPPUNIT_TEST_SUITE( ChecksumTest );
+
+	CPPUNIT_TEST( test_KnownValues );
+	CPPUNIT_TEST( test_BackendsMatchBytewise );
+	CPPUNIT_TEST( test_AddValuesMatchAddByte );
+	CPPUNIT_TEST( test_Benchmark_Backends );
+
+	CPPUNIT_TEST_SUITE_END();
+	// End of Fixture registration
+
+	Checksum::CrcBackend savedBackend;
+
+	static std::vector<unsigned char> makeData(size_t size) {
+		std::vector<unsigned char> data(size);
+		unsigned int seed = 12345;
+		for(size_t index = 0; index < size; ++index) {
+			seed = seed * 1103515245 + 12345;
+			data[index] = (unsigned char)(seed >> 16);
+		}
+		return data;
+	}
+
+public:
+	void setUp() {
+		savedBackend = Checksum::getCrcBackend();
+	}
+
+	void tearDown() {
+		Checksum::setCrcBackend(savedBackend);
+	}
+
+	void test_KnownValues() {
+		const string text = "123456789";
+		for(int backend = 0; backend < Checksum::cbCount; ++backend) {
+			if(Checksum::setCrcBackend((Checksum::CrcBackend)backend) == false) {
+				continue;
+			}
+			// the check value of crc-32
+			CPPUNIT_ASSERT_EQUAL( (uint32)0xcbf43926, Checksum::updateCrc(0, text.c_str(), text.size()) );
+
+			std::vector<unsigned char> zeros(4096, 0);
+			Checksum checksum;
+			checksum.addBytes(&zeros[0], zeros.size());
+			CPPUNIT_ASSERT_EQUAL( (uint32)0xc71c0011, checksum.getSum() );
+		}
+	}
+
+	void test_BackendsMatchBytewise() {
+		const std::vector<unsigned char> data = makeData(5000);
+
+		for(int backend = 0; backend < Checksum::cbCount; ++backend) {
+			if(Checksum::setCrcBackend((Checksum::CrcBackend)backend) == false) {
+				continue;
+			}
+			// every short size, odd offsets and sizes around the 64 byte folds
+			for(size_t offset = 0; offset < 17; ++offset) {
+				for(size_t size = 0; size + offset <= data.size(); size += (size < 300 ? 1 : 97)) {
+					Checksum expected;
+					for(size_t index = 0; index < size; ++index) {
+						expected.addByte((char)data[offset + index]);
+					}
+
+					Checksum actual;
+					actual.addBytes(&data[offset], size);
+					CPPUNIT_ASSERT_EQUAL( expected.getSum(), actual.getSum() );
+				}
+			}
+
+			// a sum continued over several calls
+			Checksum expected;
+			expected.addBytes(&data[0], data.size());
+			uint32 crc = 0;
+			for(size_t index = 0; index < data.size(); index += 333) {
+				crc = Checksum::updateCrc(crc, &data[index], std::min((size_t)333, data.size() - index));
+			}
+			CPPUNIT_ASSERT_EQUAL( expected.getSum(), crc );
+		}
+	}
+
+	void test_AddValuesMatchAddByte() {
+		const int32 intValue = -123456789;
+		const uint32 uintValue = 0xfedcba98u;
+		const int64 int64Value = -1234567890123456789LL;
+		const string text = "megapack/factions/tech/units/swordman";
+
+		Checksum expected;
+		for(int shift = 0; shift < 32; shift += 8) {
+			expected.addByte((char)((intValue >> shift) & 0xFF));
+		}
+		for(int shift = 0; shift < 32; shift += 8) {
+			expected.addByte((char)((uintValue >> shift) & 0xFF));
+		}
+		for(int shift = 0; shift < 64; shift += 8) {
+			expected.addByte((char)((int64Value >> shift) & 0xFF));
+		}
+		for(unsigned int index = 0; index < text.size(); ++index) {
+			expected.addByte(text[index]);
+		}
+
+		Checksum actual;
+		actual.addInt(intValue);
+		actual.addUInt(uintValue);
+		actual.addInt64(int64Value);
+		actual.addString(text);
+		CPPUNIT_ASSERT_EQUAL( expected.getSum(), actual.getSum() );
+	}
+
+	void test_Benchmark_Backends() {
+		const std::vector<unsigned char> data = makeData(1024 * 1024);
+		const int runs = 32;
+
+		printf("\nChecksum benchmark, %d MB:",runs);
+		for(int backend = 0; backend < Checksum::cbCount; ++backend) {
+			if(Checksum::setCrcBackend((Checksum::CrcBackend)backend) == false) {
+				printf(" %s not supported,",Checksum::getCrcBackendName((Checksum::CrcBackend)backend));
+				continue;
+			}
+
+			Chrono chrono;
+			chrono.start();
+			uint32 crc = 0;
+			for(int run = 0; run < runs; ++run) {
+				crc = Checksum::updateCrc(crc, &data[0], data.size());
+			}
+			int64 micros = chrono.getMicros();
+			double rate = (micros > 0 ? runs * 1000000.0 / micros : 0);
+			printf(" %s %.0f MB/sec [%u],",Checksum::getCrcBackendName((Checksum::CrcBackend)backend),rate,crc);
+		}
+		printf("\n");
+	}
+};
+
+// Test Suite Registrations
+CPPUNIT_TEST_SUITE_REGISTRATION( ChecksumTest );
+//
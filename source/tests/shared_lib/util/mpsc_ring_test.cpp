@@ -0,0 +1,135 @@
+// ==============================================================
+//	This file is part of MegaGlest Unit Tests (www.megaglest.org)
+//
+//	Copyright (C) 2026 The MegaGlest Team
+//
+//	You can redistribute this code and/or modify it under
+//	the terms of the GNU General Public License as published
+//	by the Free Software Foundation; either version 2 of the
+//	License, or (at your option) any later version
+// ==============================================================
+
+#include <cppunit/extensions/HelperMacros.h>
+#include <SDL_thread.h>
+#include <SDL_timer.h>
+#include "mpsc_ring.h"
+#include <string>
+#include <vector>
+
+using namespace Shared::Util;
+
+//
+// Tests for the lock free queue used by the log writer
+//
+class MpscRingTest : public CppUnit::TestFixture {
+	// Register the suite of tests for this fixture
+	CPPUNIT_TEST_SUITE( MpscRingTest );
+
+	CPPUNIT_TEST( test_PushPopInOrder );
+	CPPUNIT_TEST( test_FullRingRefusesPush );
+	CPPUNIT_TEST( test_ConcurrentProducers );
+
+	CPPUNIT_TEST_SUITE_END();
+	// End of Fixture registration
+
+	static const int producerCount = 4;
+	static const int entriesPerProducer = 20000;
+
+	struct Producer {
+		MpscRing<int> *ring;
+		int id;
+	};
+
+	static int produce(void *data) {
+		Producer *producer = (Producer *)data;
+		for(int i = 0; i < entriesPerProducer; ++i) {
+			int value = producer->id * entriesPerProducer + i;
+			while(producer->ring->tryPush(value) == false) {
+				SDL_Delay(0);
+			}
+		}
+		return 0;
+	}
+
+public:
+	void test_PushPopInOrder() {
+		MpscRing<std::string> ring(5);
+		CPPUNIT_ASSERT_EQUAL( (uint32)8, ring.getCapacity() );
+
+		// several laps so the sequence numbers wrap around the slots
+		int next = 0;
+		for(int lap = 0; lap < 10; ++lap) {
+			for(int i = 0; i < 6; ++i) {
+				std::string entry = std::string("entry ") + char('a' + (lap + i) % 26);
+				CPPUNIT_ASSERT_EQUAL( true, ring.tryPush(entry) );
+			}
+			CPPUNIT_ASSERT_EQUAL( (uint32)6, ring.size() );
+			for(int i = 0; i < 6; ++i, ++next) {
+				std::string entry;
+				CPPUNIT_ASSERT_EQUAL( true, ring.tryPop(entry) );
+				CPPUNIT_ASSERT_EQUAL( std::string("entry ") + char('a' + (lap + i) % 26), entry );
+			}
+			std::string entry;
+			CPPUNIT_ASSERT_EQUAL( false, ring.tryPop(entry) );
+		}
+		CPPUNIT_ASSERT_EQUAL( 60, next );
+	}
+
+	void test_FullRingRefusesPush() {
+		MpscRing<int> ring(4);
+		for(int i = 0; i < 4; ++i) {
+			int value = i;
+			CPPUNIT_ASSERT_EQUAL( true, ring.tryPush(value) );
+		}
+		int value = 99;
+		CPPUNIT_ASSERT_EQUAL( false, ring.tryPush(value) );
+		CPPUNIT_ASSERT_EQUAL( 99, value );
+
+		CPPUNIT_ASSERT_EQUAL( true, ring.tryPop(value) );
+		CPPUNIT_ASSERT_EQUAL( 0, value );
+		value = 4;
+		CPPUNIT_ASSERT_EQUAL( true, ring.tryPush(value) );
+		for(int i = 1; i <= 4; ++i) {
+			CPPUNIT_ASSERT_EQUAL( true, ring.tryPop(value) );
+			CPPUNIT_ASSERT_EQUAL( i, value );
+		}
+	}
+
+	void test_ConcurrentProducers() {
+		MpscRing<int> ring(256);
+		Producer producers[producerCount];
+		SDL_Thread *threads[producerCount];
+		for(int i = 0; i < producerCount; ++i) {
+			producers[i].ring = &ring;
+			producers[i].id = i;
+			threads[i] = SDL_CreateThread(produce, "MpscRingTest", &producers[i]);
+			CPPUNIT_ASSERT( threads[i] != NULL );
+		}
+
+		// every entry arrives once and each producer's entries stay in order
+		std::vector<int> nextExpected(producerCount, 0);
+		int received = 0;
+		while(received < producerCount * entriesPerProducer) {
+			int value = -1;
+			if(ring.tryPop(value) == false) {
+				SDL_Delay(0);
+				continue;
+			}
+			int id = value / entriesPerProducer;
+			CPPUNIT_ASSERT( id >= 0 && id < producerCount );
+			CPPUNIT_ASSERT_EQUAL( nextExpected[id], value % entriesPerProducer );
+			nextExpected[id]++;
+			received++;
+		}
+
+		for(int i = 0; i < producerCount; ++i) {
+			SDL_WaitThread(threads[i], NULL);
+		}
+		int value = -1;
+		CPPUNIT_ASSERT_EQUAL( false, ring.tryPop(value) );
+	}
+};
+
+// Test Suite Registrations
+CPPUNIT_TEST_SUITE_REGISTRATION( MpscRingTest );
+//
@@ -0,0 +1,208 @@
+// ==============================================================
+//	This file is part of MegaGlest Unit Tests (www.megaglest.org)
+//
+//	Copyright (C) 2026 The MegaGlest Team
+//
+//	You can redistribute this code and/or modify it under
+//	the terms of the GNU General Public License as published
+//	by the Free Software Foundation; either version 2 of the
+//	License, or (at your option) any later version
+// ==============================================================
+
+#include <cppunit/extensions/HelperMacros.h>
+#include <SDL_thread.h>
+#include "zone_profiler.h"
+#include <cstdio>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+using namespace Shared::Util;
+
+//
+// Tests for the scoped zone profiler and its Chrome trace export
+//
+class ZoneProfilerTest : public CppUnit::TestFixture {
+	// Register the suite of tests for this fixture
+	CPPUNIT_TEST_SUITE( ZoneProfilerTest );
+
+	CPPUNIT_TEST( test_ZonesOnlyRecordedWhileCapturing );
+	CPPUNIT_TEST( test_ExportChromeTrace );
+	CPPUNIT_TEST( test_NewCaptureDropsOldEvents );
+	CPPUNIT_TEST( test_WorkerThreads );
+	CPPUNIT_TEST( test_ZoneTotals );
+
+	CPPUNIT_TEST_SUITE_END();
+	// End of Fixture registration
+
+	static const int workerCount = 3;
+	static const int zonesPerWorker = 500;
+
+	static void outerZone() {
+		PROFILE_ZONE("ZoneProfilerTest::outer");
+		innerZone();
+	}
+	static void innerZone() {
+		PROFILE_ZONE("ZoneProfilerTest::inner");
+	}
+
+	static int work(void *data) {
+		int index = *(int *)data;
+		std::ostringstream name;
+		name << "Test worker " << index;
+		ZoneProfiler::setThreadName(name.str());
+		for(int i = 0; i < zonesPerWorker; ++i) {
+			PROFILE_ZONE("ZoneProfilerTest::work");
+		}
+		ZoneProfiler::releaseThreadBuffer();
+		return 0;
+	}
+
+	static std::string exportTrace() {
+		const std::string path = "zone_profiler_test.json";
+		CPPUNIT_ASSERT_EQUAL( true, ZoneProfiler::exportChromeTrace(path) );
+
+		std::ifstream file(path.c_str());
+		std::ostringstream content;
+		content << file.rdbuf();
+		file.close();
+		remove(path.c_str());
+		return content.str();
+	}
+
+	static int countOf(const std::string &text, const std::string &part) {
+		int count = 0;
+		for(size_t pos = text.find(part); pos != std::string::npos; pos = text.find(part, pos + 1)) {
+			count++;
+		}
+		return count;
+	}
+
+public:
+	void tearDown() {
+		ZoneProfiler::stop();
+	}
+
+	void test_ZonesOnlyRecordedWhileCapturing() {
+		ZoneProfiler::start();
+		ZoneProfiler::stop();
+		outerZone();
+		CPPUNIT_ASSERT( ZoneProfiler::getStats().find("events [0]") != std::string::npos );
+
+		ZoneProfiler::start();
+		outerZone();
+		outerZone();
+		ZoneProfiler::stop();
+		CPPUNIT_ASSERT_EQUAL( false, ZoneProfiler::isEnabled() );
+		CPPUNIT_ASSERT( ZoneProfiler::getStats().find("events [4]") != std::string::npos );
+	}
+
+	void test_ExportChromeTrace() {
+		ZoneProfiler::setThreadName("Test main");
+		ZoneProfiler::start();
+		outerZone();
+		ZoneProfiler::stop();
+
+		std::string trace = exportTrace();
+		CPPUNIT_ASSERT_EQUAL( (size_t)0, trace.find("{\"traceEvents\":[") );
+		CPPUNIT_ASSERT( trace.find("\"displayTimeUnit\":\"ns\"}") != std::string::npos );
+		CPPUNIT_ASSERT_EQUAL( 1, countOf(trace, "\"args\":{\"name\":\"Test main\"}") );
+		CPPUNIT_ASSERT_EQUAL( 1, countOf(trace, "\"name\":\"ZoneProfilerTest::outer\"") );
+		CPPUNIT_ASSERT_EQUAL( 1, countOf(trace, "\"name\":\"ZoneProfilerTest::inner\"") );
+		CPPUNIT_ASSERT_EQUAL( 2, countOf(trace, "\"ph\":\"X\"") );
+		CPPUNIT_ASSERT( trace.find("\"file\":\"zone_profiler_test.cpp\"") != std::string::npos );
+	}
+
+	void test_NewCaptureDropsOldEvents() {
+		ZoneProfiler::start();
+		outerZone();
+		ZoneProfiler::stop();
+
+		ZoneProfiler::start();
+		innerZone();
+		ZoneProfiler::stop();
+
+		std::string trace = exportTrace();
+		CPPUNIT_ASSERT_EQUAL( 0, countOf(trace, "ZoneProfilerTest::outer") );
+		CPPUNIT_ASSERT_EQUAL( 1, countOf(trace, "ZoneProfilerTest::inner") );
+	}
+
+	void test_WorkerThreads() {
+		ZoneProfiler::start();
+
+		int indexes[workerCount];
+		SDL_Thread *threads[workerCount];
+		for(int i = 0; i < workerCount; ++i) {
+			indexes[i] = i;
+			threads[i] = SDL_CreateThread(work, "ZoneProfilerTest", &indexes[i]);
+			CPPUNIT_ASSERT( threads[i] != NULL );
+		}
+		for(int i = 0; i < workerCount; ++i) {
+			SDL_WaitThread(threads[i], NULL);
+		}
+		ZoneProfiler::stop();
+
+		std::string trace = exportTrace();
+		for(int i = 0; i < workerCount; ++i) {
+			std::ostringstream name;
+			name << "\"args\":{\"name\":\"Test worker " << i << "\"}";
+			CPPUNIT_ASSERT_EQUAL( 1, countOf(trace, name.str()) );
+		}
+		CPPUNIT_ASSERT_EQUAL( workerCount * zonesPerWorker, countOf(trace, "\"name\":\"ZoneProfilerTest::work\"") );
+	}
+
+	void test_ZoneTotals() {
+		ZoneProfiler::start();
+		outerZone();
+		ZoneProfiler::stop();
+
+		// only the last capture is summed
+		ZoneProfiler::start();
+		for(int i = 0; i < 3; ++i) {
+			outerZone();
+		}
+
+		int indexes[workerCount];
+		SDL_Thread *threads[workerCount];
+		for(int i = 0; i < workerCount; ++i) {
+			indexes[i] = i;
+			threads[i] = SDL_CreateThread(work, "ZoneProfilerTest", &indexes[i]);
+			CPPUNIT_ASSERT( threads[i] != NULL );
+		}
+		for(int i = 0; i < workerCount; ++i) {
+			SDL_WaitThread(threads[i], NULL);
+		}
+		ZoneProfiler::stop();
+
+		std::vector<ZoneProfiler::ZoneTotal> totals = ZoneProfiler::getZoneTotals();
+		CPPUNIT_ASSERT_EQUAL( (size_t)3, totals.size() );
+		int64 outerNanos = -1;
+		int64 innerNanos = -1;
+		for(unsigned int i = 0; i < totals.size(); ++i) {
+			if(i > 0) {
+				CPPUNIT_ASSERT( totals[i - 1].nanos >= totals[i].nanos );
+			}
+			std::string name = totals[i].zone->name;
+			if(name == "ZoneProfilerTest::outer") {
+				CPPUNIT_ASSERT_EQUAL( (uint32)3, totals[i].calls );
+				outerNanos = totals[i].nanos;
+			}
+			else if(name == "ZoneProfilerTest::inner") {
+				CPPUNIT_ASSERT_EQUAL( (uint32)3, totals[i].calls );
+				innerNanos = totals[i].nanos;
+			}
+			else {
+				CPPUNIT_ASSERT_EQUAL( std::string("ZoneProfilerTest::work"), name );
+				CPPUNIT_ASSERT_EQUAL( (uint32)(workerCount * zonesPerWorker), totals[i].calls );
+			}
+		}
+		// inclusive times, the outer zone contains the inner one
+		CPPUNIT_ASSERT( innerNanos >= 0 );
+		CPPUNIT_ASSERT( outerNanos >= innerNanos );
+	}
+};
+
+// Test Suite Registrations
+CPPUNIT_TEST_SUITE_REGISTRATION( ZoneProfilerTest );
+//
@@ -12,8 +12,12 @@
 #include <cppunit/extensions/HelperMacros.h>
 #include <memory>
 #include <fstream>
+#include <iterator>
+#include <cstring>
+#include <vector>
 #include "xml_parser.h"
 #include "platform_util.h"
+#include "conversion.h"
 
 #if defined(WANT_XERCES)
 
@@ -32,6 +36,7 @@
 
 using namespace Shared::Xml;
 using namespace Shared::Platform;
+using namespace Shared::Util;
 
 //
 // Utility methods for tests
@@ -232,6 +237,183 @@ public:
 	}
 };
 
+//
+// Tests for XmlIoBinary
+//
+class XmlIoBinaryTest : public CppUnit::TestFixture {
+	// Register the suite of tests for this fixture
+	CPPUNIT_TEST_SUITE( XmlIoBinaryTest );
+
+	CPPUNIT_TEST( test_xml_is_not_binary );
+	CPPUNIT_TEST_EXCEPTION( test_save_file_null_node,  megaglest_runtime_error );
+	CPPUNIT_TEST( test_save_load_round_trip );
+	CPPUNIT_TEST( test_load_applies_tags );
+	CPPUNIT_TEST( test_save_load_memory_round_trip );
+#if defined(WANT_XERCES)
+	CPPUNIT_TEST( test_load_with_xerces_engine );
+#endif
+	CPPUNIT_TEST_EXCEPTION( test_load_file_truncated,  megaglest_runtime_error );
+	CPPUNIT_TEST_EXCEPTION( test_load_newer_version,  megaglest_runtime_error );
+
+	CPPUNIT_TEST_SUITE_END();
+	// End of Fixture registration
+
+	// enough units that the encoded tree spans several chunks
+	static const int unitCount = 20000;
+
+	static void createSavedGameTree(XmlTree &xmlTree) {
+		xmlTree.init("megaglest-saved-game");
+		XmlNode *rootNode = xmlTree.getRootNode();
+		rootNode->addAttribute("version", "1.0", std::map<string,string>());
+		XmlNode *worldNode = rootNode->addChild("World");
+		for(int i = 0; i < unitCount; ++i) {
+			XmlNode *unitNode = worldNode->addChild("Unit");
+			unitNode->addAttribute("id", intToStr(i), std::map<string,string>());
+			unitNode->addChild("hp")->addAttribute("value", intToStr(i * 7), std::map<string,string>());
+		}
+		rootNode->addChild("note", "leaf text");
+	}
+
+	static vector<char> readFile(const string &path) {
+		std::ifstream file(path.c_str(), std::ios::binary);
+		return vector<char>((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+	}
+
+	static void writeFile(const string &path, const vector<char> &data) {
+		std::ofstream file(path.c_str(), std::ios::binary);
+		file.write(&data[0], data.size());
+	}
+
+public:
+
+	void test_xml_is_not_binary() {
+		const string test_filename = "xml_test_binary_valid.xml";
+		createValidXMLTestFile(test_filename);
+		SafeRemoveTestFile deleteFile(test_filename);
+
+		vector<char> data = readFile(test_filename);
+		CPPUNIT_ASSERT_EQUAL( false, XmlIoBinary::isBinary(&data[0], data.size()) );
+		CPPUNIT_ASSERT_EQUAL( false, XmlIoBinary::isBinaryFile(test_filename) );
+	}
+
+	void test_save_file_null_node() {
+		XmlNode *rootNode = NULL;
+		XmlIoBinary::save("xml_test_binary_null.xml", rootNode);
+	}
+
+	void test_save_load_round_trip() {
+		const string test_filename = "xml_test_binary_round_trip.xml";
+		XmlTree xmlTreeSave;
+		createSavedGameTree(xmlTreeSave);
+		xmlTreeSave.saveBinary(test_filename);
+		SafeRemoveTestFile deleteFile(test_filename);
+
+		vector<char> data = readFile(test_filename);
+		CPPUNIT_ASSERT_EQUAL( true, XmlIoBinary::isBinary(&data[0], data.size()) );
+		CPPUNIT_ASSERT_EQUAL( true, XmlIoBinary::isBinaryFile(test_filename) );
+
+		XmlTree xmlTree;
+		xmlTree.load(test_filename, std::map<string,string>());
+		const XmlNode *rootNode = xmlTree.getRootNode();
+		CPPUNIT_ASSERT_EQUAL( string("megaglest-saved-game"), rootNode->getName() );
+		CPPUNIT_ASSERT_EQUAL( string("1.0"), rootNode->getAttribute("version")->getValue() );
+		CPPUNIT_ASSERT_EQUAL( (size_t)2, rootNode->getChildCount() );
+		CPPUNIT_ASSERT_EQUAL( string("leaf text"), rootNode->getChild("note")->getText() );
+
+		const XmlNode *worldNode = rootNode->getChild("World");
+		CPPUNIT_ASSERT_EQUAL( (size_t)unitCount, worldNode->getChildCount() );
+		for(int i = 0; i < unitCount; ++i) {
+			const XmlNode *unitNode = worldNode->getChild(i);
+			CPPUNIT_ASSERT_EQUAL( string("Unit"), unitNode->getName() );
+			CPPUNIT_ASSERT_EQUAL( i, unitNode->getAttribute("id")->getIntValue() );
+			CPPUNIT_ASSERT_EQUAL( i * 7, unitNode->getChild("hp")->getAttribute("value")->getIntValue() );
+		}
+	}
+
+	void test_load_applies_tags() {
+		const string test_filename = "xml_test_binary_tags.xml";
+		XmlTree xmlTreeSave;
+		xmlTreeSave.init("root");
+		xmlTreeSave.getRootNode()->addAttribute("path", "{TEST_TAG}/file", std::map<string,string>());
+		xmlTreeSave.saveBinary(test_filename);
+		SafeRemoveTestFile deleteFile(test_filename);
+
+		std::map<string,string> mapTagReplacementValues;
+		mapTagReplacementValues["{TEST_TAG}"] = "data";
+		XmlTree xmlTree;
+		xmlTree.load(test_filename, mapTagReplacementValues);
+		CPPUNIT_ASSERT_EQUAL( string("data/file"), xmlTree.getRootNode()->getAttribute("path")->getValue() );
+	}
+
+	void test_save_load_memory_round_trip() {
+		const string test_filename = "xml_test_binary_memory.xml";
+		XmlTree xmlTreeSave;
+		createSavedGameTree(xmlTreeSave);
+		xmlTreeSave.saveBinary(test_filename);
+		SafeRemoveTestFile deleteFile(test_filename);
+
+		// the in memory encoding is byte for byte what goes to disk
+		vector<unsigned char> buffer;
+		xmlTreeSave.saveBinary(buffer);
+		vector<char> data = readFile(test_filename);
+		CPPUNIT_ASSERT_EQUAL( data.size(), buffer.size() );
+		CPPUNIT_ASSERT( memcmp(&data[0], &buffer[0], buffer.size()) == 0 );
+
+		XmlTree xmlTree;
+		xmlTree.loadBinary((const char *)&buffer[0], buffer.size(), std::map<string,string>());
+		const XmlNode *rootNode = xmlTree.getRootNode();
+		CPPUNIT_ASSERT_EQUAL( string("megaglest-saved-game"), rootNode->getName() );
+		CPPUNIT_ASSERT_EQUAL( (size_t)unitCount, rootNode->getChild("World")->getChildCount() );
+		CPPUNIT_ASSERT_EQUAL( string("leaf text"), rootNode->getChild("note")->getText() );
+	}
+
+#if defined(WANT_XERCES)
+	// ForceXMLLoadGameUsingXerces must still load binary saved games
+	void test_load_with_xerces_engine() {
+		const string test_filename = "xml_test_binary_xerces.xml";
+		XmlTree xmlTreeSave;
+		createSavedGameTree(xmlTreeSave);
+		xmlTreeSave.saveBinary(test_filename);
+		SafeRemoveTestFile deleteFile(test_filename);
+
+		XmlTree xmlTree(XML_XERCES_ENGINE);
+		xmlTree.load(test_filename, std::map<string,string>());
+		CPPUNIT_ASSERT_EQUAL( string("megaglest-saved-game"), xmlTree.getRootNode()->getName() );
+		CPPUNIT_ASSERT_EQUAL( (size_t)unitCount, xmlTree.getRootNode()->getChild("World")->getChildCount() );
+	}
+#endif
+
+	void test_load_file_truncated() {
+		const string test_filename = "xml_test_binary_truncated.xml";
+		XmlTree xmlTreeSave;
+		createSavedGameTree(xmlTreeSave);
+		xmlTreeSave.saveBinary(test_filename);
+		SafeRemoveTestFile deleteFile(test_filename);
+
+		vector<char> data = readFile(test_filename);
+		data.resize(data.size() / 2);
+		writeFile(test_filename, data);
+
+		XmlTree xmlTree;
+		xmlTree.load(test_filename, std::map<string,string>());
+	}
+
+	void test_load_newer_version() {
+		const string test_filename = "xml_test_binary_version.xml";
+		XmlTree xmlTreeSave;
+		xmlTreeSave.init("root");
+		xmlTreeSave.saveBinary(test_filename);
+		SafeRemoveTestFile deleteFile(test_filename);
+
+		vector<char> data = readFile(test_filename);
+		data[4] = (char)(XmlIoBinary::FORMAT_VERSION + 1);
+		writeFile(test_filename, data);
+
+		XmlTree xmlTree;
+		xmlTree.load(test_filename, std::map<string,string>());
+	}
+};
+
 //
 // Tests for XmlTree
 //
@@ -623,6 +805,7 @@ public:
 // Test Suite Registrations
 
 CPPUNIT_TEST_SUITE_REGISTRATION( XmlIoRapidTest );
+CPPUNIT_TEST_SUITE_REGISTRATION( XmlIoBinaryTest );
 CPPUNIT_TEST_SUITE_REGISTRATION( XmlTreeTest );
 CPPUNIT_TEST_SUITE_REGISTRATION( XmlNodeTest );
 